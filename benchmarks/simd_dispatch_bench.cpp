@@ -0,0 +1,152 @@
+/**
+ * SIMD Kernel Variant Benchmark
+ *
+ * Times every kernel variant this CPU can run (scalar, SSE2, AVX2,
+ * AVX-512, NEON) on the feature and inference shapes the trading loop
+ * uses, so the dispatched choice can be checked on each host.
+ *
+ * Build:
+ *   cmake --build build --target simd_dispatch_bench
+ *
+ * Run:
+ *   ./build/simd_dispatch_bench --iterations 2000000 --cpu 2
+ *   HFT_ISA=avx2 ./build/simd_dispatch_bench     # override the dispatched variant
+ */
+
+#include "simd_dispatch.hpp"
+#include "simd_features.hpp"
+#include "spin_loop_engine.hpp"
+#include "tsc_clock.hpp"
+#include "vectorized_inference.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace hft;
+using namespace hft::simd;
+
+namespace {
+
+constexpr size_t BOOKS = 64;        // Rotating inputs, so no call sees a constant
+constexpr int TRIALS = 5;           // Best of, to drop preemption outliers
+
+void print_usage(const char* prog) {
+    std::cout << "Usage: " << prog << " [options]\n\n"
+              << "Options:\n"
+              << "  --iterations N  Calls per kernel per trial (default: 1000000)\n"
+              << "  --cpu N         Pin to CPU core N\n"
+              << "  --help          Show this help\n";
+}
+
+volatile double g_sink = 0.0;
+
+// Best-of-TRIALS nanoseconds per call
+template<typename Func>
+double time_per_call(size_t iterations, Func&& func) {
+    for (size_t i = 0; i < iterations / 10 + 1; ++i) func(i);        // Warmup
+    double best = 1e300;
+    for (int t = 0; t < TRIALS; ++t) {
+        const uint64_t t0 = now_tsc();
+        for (size_t i = 0; i < iterations; ++i) func(i);
+        const uint64_t t1 = now_tsc();
+        best = std::min(best, static_cast<double>(tsc_to_ns(t1) - tsc_to_ns(t0)) / static_cast<double>(iterations));
+    }
+    return best;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t iterations = 1000000;
+    int cpu = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::stoull(argv[++i]);
+        } else if (arg == "--cpu" && i + 1 < argc) {
+            cpu = std::stoi(argv[++i]);
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (cpu >= 0) spin_loop::pin_to_cpu(cpu);
+
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> qty(1.0, 500.0);
+    std::vector<double> books(BOOKS * 20);
+    for (auto& q : books) q = qty(rng);
+    std::vector<double> weights(3 * 16);
+    for (auto& w : weights) w = qty(rng) / 500.0 - 0.5;
+    const double means[16] = {0};
+    const double stddevs[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+
+    std::cout << "Dispatched: " << isa_name(active_isa()) << "\n";
+    std::cout << "ns per call, best of " << TRIALS << " x " << iterations << " calls\n\n";
+    std::cout << std::left << std::setw(8) << "isa" << std::right
+              << std::setw(10) << "ofi" << std::setw(12) << "normalize" << std::setw(12) << "imbalance"
+              << std::setw(10) << "dense" << std::setw(10) << "tanh" << std::setw(12) << "features"
+              << std::setw(12) << "predict" << "\n";
+
+    for (IsaLevel level : supported_isas()) {
+        const KernelTable& k = kernels_for(level);
+        auto book = [&](size_t i) { return books.data() + (i % BOOKS) * 20; };
+
+        const double ofi = time_per_call(iterations, [&](size_t i) {
+            double out[10];
+            k.subtract(book(i), book(i + 1), out, 10);
+            g_sink = g_sink + k.sum_difference(out, out + 5, 5);
+        });
+        const double normalize = time_per_call(iterations, [&](size_t i) {
+            double x[15];
+            std::copy(book(i), book(i) + 15, x);
+            k.normalize(x, means, stddevs, 15);
+            g_sink = g_sink + x[14];
+        });
+        const double imbalance = time_per_call(iterations, [&](size_t i) {
+            g_sink = g_sink + k.volume_imbalance(book(i), book(i) + 10, 10);
+        });
+
+        VectorizedInferenceEngine model;
+        model.select_kernels(k);
+        const double dense = time_per_call(iterations, [&](size_t i) {
+            double out[3];
+            k.dense(weights.data(), book(i), book(i + 1), out, 3, 16);
+            g_sink = g_sink + out[2];
+        });
+        const double tanh_ns = time_per_call(iterations, [&](size_t i) {
+            double h[16];
+            std::copy(book(i), book(i) + 16, h);
+            for (double& v : h) v *= 0.01;
+            k.tanh(h, 16);
+            g_sink = g_sink + h[15];
+        });
+
+        simd_features::FastFeatureEngine features(k);
+        features.set_normalization_params(means, stddevs, 16);
+        const double feature_ns = time_per_call(iterations, [&](size_t i) {
+            double out[16];
+            features.calculate_features_fast(book(i), book(i) + 10, 10, out);
+            g_sink = g_sink + out[0];
+        });
+        const double predict = time_per_call(iterations, [&](size_t i) {
+            g_sink = g_sink + model.predict(book(i)).buy_signal;
+        });
+
+        std::cout << std::left << std::setw(8) << isa_name(level) << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(10) << ofi << std::setw(12) << normalize
+                  << std::setw(12) << imbalance << std::setw(10) << dense << std::setw(10) << tanh_ns
+                  << std::setw(12) << feature_ns
+                  << std::setw(12) << predict << "\n";
+    }
+    return 0;
+}
@@ -113,7 +113,7 @@ void example_full_trading_system() {
     std::cout << "NIC initialized (custom driver, 30ns RX)\n";
     
     // Step 5: Initialize trading components
-    ArrayBasedOrderBook<100> order_book;
+    PriceIndexedOrderBook<1024> order_book(/*reference_price=*/100.0, /*tick_size=*/0.01);
     VectorizedInferenceEngine inference;
     DynamicMMStrategy strategy(0.01, 0.15, 300.0, 10.0, 0.01, 850);
     hardware::CustomPacketFilter packet_filter;
@@ -137,8 +137,8 @@ void example_full_trading_system() {
         uint32_t quantity;
         packet_filter.parse_market_data(packet, len, &price, &quantity);
         
-        // Update order book (80 ns) - Flat array, O(1) lookup
-        order_book.update_bid(0, price, quantity);
+        // Update order book - tick-indexed, O(1) lookup and incremental BBO
+        order_book.update_bid(price, quantity);
         
         // Calculate features (250 ns) - SIMD vectorized
         // Calculate OFI (10-level imbalance)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common_types.hpp"
+#include "engine_checkpoint.hpp"
 #include <cmath>
 #include <algorithm>
 
@@ -127,6 +128,17 @@ public:
     double get_risk_aversion() const { return gamma_; }
     double get_volatility() const { return sigma_; }
     int64_t get_system_latency_ns() const { return system_latency_ns_; }
+
+    // The parameters adjusted at runtime; the rest come from construction
+    void save_state(checkpoint::StateWriter& out) const {
+        out.put(gamma_);
+        out.put(sigma_);
+    }
+
+    void restore_state(checkpoint::StateReader& in) {
+        in.get(gamma_);
+        set_volatility(in.get<double>());
+    }
     
 private:
     double calculate_inventory_skew(int64_t inventory) const {
@@ -0,0 +1,292 @@
+#pragma once
+
+#include "common_types.hpp"
+#include "engine_checkpoint.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace hft {
+namespace backtest {
+
+// ====
+// Backtest Accounting
+// O(1) per fill and per tick, flat memory however long the replay
+// ====
+
+// Average-cost position ledger. Opening fills move the average price;
+// closing fills realize (fill - average) * closed quantity; a fill that
+// crosses through flat closes the old position and opens the remainder at
+// the fill price.
+class PositionLedger {
+public:
+    // Returns the P&L this fill realized (0 for a purely opening fill)
+    double on_fill(Side side, uint64_t quantity, double price, double fee = 0.0) {
+        fees_ += fee;
+        ++fills_;
+        if (quantity == 0) return 0.0;
+
+        const int64_t signed_qty = side == Side::BUY ?
+            static_cast<int64_t>(quantity) : -static_cast<int64_t>(quantity);
+
+        if (position_ == 0 || (position_ > 0) == (signed_qty > 0)) {
+            const double held = static_cast<double>(std::llabs(position_));
+            average_price_ = (average_price_ * held + price * quantity) / (held + quantity);
+            position_ += signed_qty;
+            return 0.0;
+        }
+
+        const int64_t closed = std::min(std::llabs(position_), std::llabs(signed_qty));
+        const double direction = position_ > 0 ? 1.0 : -1.0;
+        const double realized = (price - average_price_) * direction * static_cast<double>(closed);
+        realized_ += realized;
+        ++closing_fills_;
+        if (realized > 0.0) {
+            ++winning_fills_;
+            gross_profit_ += realized;
+        } else {
+            ++losing_fills_;
+            gross_loss_ -= realized;
+        }
+
+        position_ += signed_qty;
+        if (position_ == 0) {
+            average_price_ = 0.0;
+        } else if ((position_ > 0) == (signed_qty > 0)) {
+            average_price_ = price;                  // Flipped: remainder opened here
+        }
+        return realized;
+    }
+
+    double unrealized(double mark) const {
+        return position_ == 0 ? 0.0 : static_cast<double>(position_) * (mark - average_price_);
+    }
+
+    void reset() { *this = PositionLedger(); }
+
+    void save_state(checkpoint::StateWriter& out) const { out.put(*this); }
+    void restore_state(checkpoint::StateReader& in) { in.get(*this); }
+
+    int64_t position() const { return position_; }
+    double average_price() const { return average_price_; }
+    double realized() const { return realized_; }          // Before fees
+    double fees() const { return fees_; }
+    uint64_t fills() const { return fills_; }
+    uint64_t closing_fills() const { return closing_fills_; }
+    uint64_t winning_fills() const { return winning_fills_; }
+    uint64_t losing_fills() const { return losing_fills_; }
+    double gross_profit() const { return gross_profit_; }
+    double gross_loss() const { return gross_loss_; }
+
+private:
+    int64_t position_ = 0;
+    double average_price_ = 0.0;
+    double realized_ = 0.0;
+    double fees_ = 0.0;
+    uint64_t fills_ = 0;
+    uint64_t closing_fills_ = 0;
+    uint64_t winning_fills_ = 0;
+    uint64_t losing_fills_ = 0;
+    double gross_profit_ = 0.0;
+    double gross_loss_ = 0.0;
+};
+
+// Per-tick P&L statistics without keeping the series: Welford mean/variance
+// of tick returns, downside second moment, running peak and drawdown of
+// equity, and a fixed-size reservoir of returns for VaR/CVaR (exact while
+// the run has fewer returns than the reservoir holds). The equity curve is
+// kept at most `curve_points` long by halving it and doubling the sampling
+// stride whenever it fills.
+class StreamingPerformance {
+public:
+    static constexpr size_t DEFAULT_RESERVOIR = 65536;
+
+    explicit StreamingPerformance(double initial_capital = 0.0, size_t curve_points = 0,
+                                  size_t reservoir_size = DEFAULT_RESERVOIR)
+        : initial_capital_(initial_capital), curve_points_(curve_points & ~size_t(1)),
+          reservoir_size_(std::max<size_t>(reservoir_size, 1)) {}
+
+    void reset() { *this = StreamingPerformance(initial_capital_, curve_points_, reservoir_size_); }
+
+    void add(int64_t timestamp_ns, double pnl, double spread_bps) {
+        spread_sum_ += spread_bps;
+        const double equity = initial_capital_ + pnl;
+
+        if (samples_ == 0) {
+            peak_equity_ = equity;
+        } else {
+            const double r = pnl - last_pnl_;
+            ++returns_;
+            const double delta = r - mean_;
+            mean_ += delta / static_cast<double>(returns_);
+            m2_ += delta * (r - mean_);
+            if (r < 0.0) {
+                downside_sq_sum_ += r * r;
+                ++downside_count_;
+            }
+            sample_return(r);
+        }
+
+        peak_equity_ = std::max(peak_equity_, equity);
+        if (peak_equity_ > 0.0) {
+            max_drawdown_ = std::max(max_drawdown_, (peak_equity_ - equity) / peak_equity_);
+        }
+
+        if (curve_points_ > 0 && samples_ % stride_ == 0) {
+            if (equity_curve_.size() == curve_points_) decimate();
+            if (samples_ % stride_ == 0) {
+                equity_curve_.push_back(pnl);
+                drawdown_curve_.push_back(peak_equity_ > 0.0 ? (peak_equity_ - equity) / peak_equity_ : 0.0);
+                timestamps_.push_back(timestamp_ns);
+            }
+        }
+
+        last_pnl_ = pnl;
+        last_timestamp_ns_ = timestamp_ns;
+        ++samples_;
+    }
+
+    uint64_t samples() const { return samples_; }
+    uint64_t returns() const { return returns_; }
+    double last_pnl() const { return last_pnl_; }
+    double mean_return() const { return mean_; }
+    // Population variance, as the batch calculation used
+    double volatility() const { return returns_ > 0 ? std::sqrt(m2_ / static_cast<double>(returns_)) : 0.0; }
+    double downside_deviation() const {
+        return downside_count_ > 0 ? std::sqrt(downside_sq_sum_ / static_cast<double>(downside_count_)) : 0.0;
+    }
+    double max_drawdown() const { return max_drawdown_; }
+    double mean_spread_bps() const { return samples_ > 0 ? spread_sum_ / static_cast<double>(samples_) : 0.0; }
+
+    // Historical VaR/CVaR at 95% over the return reservoir, as positive losses
+    void tail_risk(double& var_95, double& cvar_95) const {
+        var_95 = cvar_95 = 0.0;
+        if (reservoir_.empty()) return;
+        std::vector<double> sorted(reservoir_);
+        std::sort(sorted.begin(), sorted.end());
+        const size_t idx = static_cast<size_t>(sorted.size() * 0.05);
+        var_95 = -sorted[idx];
+        double sum = 0.0;
+        for (size_t i = 0; i < idx; ++i) sum += sorted[i];
+        cvar_95 = idx > 0 ? -sum / static_cast<double>(idx) : 0.0;
+    }
+
+    // Downsampled curves, ending with the latest sample
+    std::vector<double> equity_curve() const { return with_last(equity_curve_, last_pnl_); }
+    std::vector<double> drawdown_curve() const {
+        const double equity = initial_capital_ + last_pnl_;
+        return with_last(drawdown_curve_, peak_equity_ > 0.0 ? (peak_equity_ - equity) / peak_equity_ : 0.0);
+    }
+    std::vector<int64_t> timestamps() const { return with_last(timestamps_, last_timestamp_ns_); }
+
+    void save_state(checkpoint::StateWriter& out) const {
+        out.put(initial_capital_);
+        out.put(curve_points_);
+        out.put(reservoir_size_);
+        out.put(samples_);
+        out.put(returns_);
+        out.put(last_pnl_);
+        out.put(last_timestamp_ns_);
+        out.put(mean_);
+        out.put(m2_);
+        out.put(downside_sq_sum_);
+        out.put(downside_count_);
+        out.put(peak_equity_);
+        out.put(max_drawdown_);
+        out.put(spread_sum_);
+        out.put_vector(reservoir_);
+        out.put(rng_);
+        out.put(stride_);
+        out.put_vector(equity_curve_);
+        out.put_vector(drawdown_curve_);
+        out.put_vector(timestamps_);
+    }
+
+    void restore_state(checkpoint::StateReader& in) {
+        in.get(initial_capital_);
+        in.get(curve_points_);
+        in.get(reservoir_size_);
+        in.get(samples_);
+        in.get(returns_);
+        in.get(last_pnl_);
+        in.get(last_timestamp_ns_);
+        in.get(mean_);
+        in.get(m2_);
+        in.get(downside_sq_sum_);
+        in.get(downside_count_);
+        in.get(peak_equity_);
+        in.get(max_drawdown_);
+        in.get(spread_sum_);
+        in.get_vector(reservoir_);
+        in.get(rng_);
+        in.get(stride_);
+        in.get_vector(equity_curve_);
+        in.get_vector(drawdown_curve_);
+        in.get_vector(timestamps_);
+    }
+
+private:
+    // Algorithm R with a fixed-seed xorshift: reproducible across runs
+    void sample_return(double r) {
+        if (reservoir_.size() < reservoir_size_) {
+            reservoir_.push_back(r);
+            return;
+        }
+        rng_ ^= rng_ << 13;
+        rng_ ^= rng_ >> 7;
+        rng_ ^= rng_ << 17;
+        const uint64_t slot = rng_ % returns_;
+        if (slot < reservoir_size_) reservoir_[slot] = r;
+    }
+
+    // Keep every other point; the next kept sample is two strides on
+    void decimate() {
+        size_t kept = 0;
+        for (size_t i = 0; i < equity_curve_.size(); i += 2, ++kept) {
+            equity_curve_[kept] = equity_curve_[i];
+            drawdown_curve_[kept] = drawdown_curve_[i];
+            timestamps_[kept] = timestamps_[i];
+        }
+        equity_curve_.resize(kept);
+        drawdown_curve_.resize(kept);
+        timestamps_.resize(kept);
+        stride_ *= 2;
+    }
+
+    template<typename T>
+    std::vector<T> with_last(const std::vector<T>& curve, T last) const {
+        std::vector<T> out(curve);
+        if (curve_points_ > 0 && samples_ > 0 && (samples_ - 1) % stride_ != 0) out.push_back(last);
+        return out;
+    }
+
+    double initial_capital_;
+    size_t curve_points_;
+    size_t reservoir_size_;
+
+    uint64_t samples_ = 0;
+    uint64_t returns_ = 0;
+    double last_pnl_ = 0.0;
+    int64_t last_timestamp_ns_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+    double downside_sq_sum_ = 0.0;
+    uint64_t downside_count_ = 0;
+    double peak_equity_ = 0.0;
+    double max_drawdown_ = 0.0;
+    double spread_sum_ = 0.0;
+
+    std::vector<double> reservoir_;
+    uint64_t rng_ = 0x9E3779B97F4A7C15ULL;
+
+    uint64_t stride_ = 1;
+    std::vector<double> equity_curve_;
+    std::vector<double> drawdown_curve_;
+    std::vector<int64_t> timestamps_;
+};
+
+} // namespace backtest
+} // namespace hft
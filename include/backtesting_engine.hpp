@@ -6,19 +6,35 @@
 #include "avellaneda_stoikov.hpp"
 #include "risk_control.hpp"
 #include "institutional_logging.hpp"
+#include "journal_decoder.hpp"
+#include "tick_store.hpp"
+#include "csv_parser.hpp"
+#include "event_scheduler.hpp"
+#include "queue_fill_simulator.hpp"
+#include "backtest_accounting.hpp"
+#include "engine_checkpoint.hpp"
+#include "fast_math.hpp"
+#include "strategy_pipeline.hpp"
+#include "merged_replay.hpp"
+#include "memory_arena.hpp"
+#include <array>
 #include <vector>
 #include <deque>
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <sstream>
 #include <cmath>
 #include <algorithm>
+#include <limits>
 #include <map>
 #include <memory>
 #include <iomanip>
 #include <iostream>
 #include <numeric>
 #include <cstring>
+#include <mutex>
+#include <random>
 
 namespace hft {
 namespace backtest {
@@ -106,15 +122,14 @@ public:
         double current_volatility,
         int64_t latency_us
     ) const {
-        double prob = params_.base_fill_probability;
-
-        prob *= std::exp(-params_.queue_position_decay * queue_position);
-
         const double spread = current_tick.ask_price - current_tick.bid_price;
         const double spread_bps = (spread / current_tick.mid_price) * 10000.0;
-        prob *= std::exp(-params_.spread_sensitivity * spread_bps);
 
-        prob *= std::exp(-params_.volatility_impact * current_volatility);
+        // Queue, spread and volatility decays share one exponential
+        double prob = params_.base_fill_probability *
+                      fast_math::exp(-params_.queue_position_decay * queue_position -
+                                     params_.spread_sensitivity * spread_bps -
+                                     params_.volatility_impact * current_volatility);
 
         const double mid_price = current_tick.mid_price;
 
@@ -134,7 +149,7 @@ public:
             }
         }
 
-        prob *= std::exp(-params_.latency_penalty_per_us * latency_us);
+        prob *= fast_math::exp(-params_.latency_penalty_per_us * latency_us);
 
         const bool adverse_move = (order.side == Side::BUY &&
                                   current_tick.mid_price > order.price) ||
@@ -182,6 +197,10 @@ struct SimulatedOrder {
           queue_position(0) {}
 };
 
+// In-flight orders by order_id, in hot-path memory
+using ActiveOrderMap = std::unordered_map<uint64_t, SimulatedOrder, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                                          ArenaAllocator<std::pair<const uint64_t, SimulatedOrder>>>;
+
 struct PerformanceMetrics {
 
     double total_pnl = 0.0;
@@ -274,7 +293,35 @@ struct PerformanceMetrics {
     }
 };
 
+// HawkesEngine constructor arguments used by BacktestingEngine
+struct HawkesParams {
+    double mu_buy = 0.5;
+    double mu_sell = 0.5;
+    double alpha_self = 0.3;
+    double alpha_cross = 0.1;
+    double beta = 1e-6;
+    double gamma = 1.5;
+    size_t max_history = 1000;
+};
+
+// DynamicMMStrategy constructor arguments (latency comes from the config)
+struct StrategyParams {
+    double risk_aversion = 0.01;
+    double volatility = 0.20;
+    double time_horizon = 600.0;
+    double order_arrival_rate = 10.0;
+    double tick_size = 0.01;
+};
+
+// How resting orders get filled
+enum class FillMode : uint8_t {
+    QUEUE_POSITION,     // Queue behind displayed size; fill as volume trades through
+    PROBABILISTIC       // One FillProbabilityModel draw when the order arrives
+};
+
 struct BacktestConfig {
+    static constexpr uint32_t NO_REFERENCE_ASSET = std::numeric_limits<uint32_t>::max();
+
     int64_t simulated_latency_ns;
     double initial_capital;
     double commission_per_share;
@@ -284,6 +331,20 @@ struct BacktestConfig {
     uint32_t random_seed;
     bool run_latency_sweep;
     std::vector<int64_t> latency_sweep_ns;
+    unsigned csv_parse_threads;      // 0 = all hardware threads
+    bool verbose;                    // Progress and reports on stdout
+    bool enable_replay_logging;      // logs/*.log audit files
+    bool binary_replay_log;          // Journal the replay log, decode to text on shutdown
+    HawkesParams hawkes;
+    StrategyParams strategy;
+    FillMode fill_mode;
+    int64_t order_lifetime_ns;       // QUEUE_POSITION: rest this long, then cancel
+    size_t equity_curve_points;      // Downsampled curve length in the metrics, 0 = none
+    bool record_fills;               // Keep every execution for get_filled_orders()
+    uint32_t reference_asset_id;     // Cross-asset features use this asset's book;
+                                     // NO_REFERENCE_ASSET = each asset's own tick
+    uint64_t checkpoint_interval_events; // Write a checkpoint every N events, 0 = never
+    std::string checkpoint_prefix;       // Files are <prefix>_<events>.ckpt
 
     BacktestConfig()
         : simulated_latency_ns(500),
@@ -294,7 +355,18 @@ struct BacktestConfig {
           enable_adverse_selection(true),
           random_seed(42),
           run_latency_sweep(false),
-          latency_sweep_ns({100, 250, 500, 1000, 2000}) {}
+          latency_sweep_ns({100, 250, 500, 1000, 2000}),
+          csv_parse_threads(0),
+          verbose(true),
+          enable_replay_logging(true),
+          binary_replay_log(true),
+          fill_mode(FillMode::QUEUE_POSITION),
+          order_lifetime_ns(1000000),
+          equity_curve_points(4096),
+          record_fills(true),
+          reference_asset_id(NO_REFERENCE_ASSET),
+          checkpoint_interval_events(0),
+          checkpoint_prefix("backtest") {}
 };
 
 class BacktestingEngine {
@@ -310,26 +382,31 @@ public:
           unrealized_pnl_(0.0),
           order_id_counter_(1) {
 
-        std::srand(config_.random_seed);
-
-        hawkes_engine_ = std::make_unique<HawkesEngine>(
-            0.5, 0.5, 0.3, 0.1, 1e-6, 1.5, 1000
-        );
-
-        fpga_inference_ = std::make_unique<FPGA_DNN_Inference>(12, 8);
-
-        mm_strategy_ = std::make_unique<DynamicMMStrategy>(
-            0.01, 0.20, 600.0, 10.0, 0.01, config_.simulated_latency_ns
-        );
+        {
+            // std::rand is process-wide: seed and draw the model weights as
+            // one step so engines built on different threads stay reproducible
+            static std::mutex seed_mutex;
+            std::lock_guard<std::mutex> lock(seed_mutex);
+            std::srand(config_.random_seed);
+            // No latency padding: order latency is simulated separately
+            fpga_inference_ = std::make_unique<FPGA_DNN_Inference>(false);
+        }
 
-        risk_control_ = std::make_unique<RiskControl>(
-            config_.max_position, 50000.0, 100000.0
-        );
+        if (!config_.enable_replay_logging) {
+            return;
+        }
 
         try {
-            replay_logger_ = std::make_unique<InstitutionalLogging::EventReplayLogger>(
-                "logs/backtest_replay.log"
-            );
+            if (config_.binary_replay_log) {
+                journal_ = std::make_unique<BinaryJournal>("logs/backtest_replay.journal");
+                replay_logger_ = std::make_unique<InstitutionalLogging::EventReplayLogger>(
+                    "logs/backtest_replay.log", *journal_
+                );
+            } else {
+                replay_logger_ = std::make_unique<InstitutionalLogging::EventReplayLogger>(
+                    "logs/backtest_replay.log"
+                );
+            }
             risk_logger_ = std::make_unique<InstitutionalLogging::RiskBreachLogger>(
                 "logs/risk_breaches.log"
             );
@@ -339,41 +416,59 @@ public:
         }
     }
 
+    ~BacktestingEngine() {
+        if (!journal_) return;
+        replay_logger_.reset();                      // Footer goes into the journal
+        journal_->close();
+        try {
+            JournalDecoder::decode(journal_->path());
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Failed to decode replay journal: " << e.what() << "\n";
+        }
+    }
+
     bool load_historical_data(const std::string& filepath) {
-        std::ifstream file(filepath);
-        if (!file.is_open()) {
+        tick_store_.reset();
+        replay_.clear();
+
+        std::vector<HistoricalEvent> events;
+        try {
+            csv::parse_file<HistoricalEvent>(filepath, [&](const HistoricalEvent& event) {
+                events.push_back(event);
+            }, config_.csv_parse_threads);
+        } catch (const std::exception&) {
             std::cerr << "Failed to open file: " << filepath << std::endl;
             return false;
         }
 
-        std::string line;
-        std::getline(file, line);
-
-        size_t events_loaded = 0;
-        while (std::getline(file, line)) {
-            HistoricalEvent event;
-            if (parse_csv_line(line, event)) {
-                historical_events_.push_back(event);
-                ++events_loaded;
-            }
+        // Recorded data is normally already in time order
+        auto by_time = [](const HistoricalEvent& a, const HistoricalEvent& b) {
+            return a.timestamp_ns < b.timestamp_ns;
+        };
+        if (!std::is_sorted(events.begin(), events.end(), by_time)) {
+            std::stable_sort(events.begin(), events.end(), by_time);
+        }
+        if (events.empty()) {
+            std::cerr << "No historical events in file: " << filepath << std::endl;
+            return false;
+        }
+        historical_events_ = std::make_shared<const std::vector<HistoricalEvent>>(std::move(events));
+
+        if (config_.verbose) {
+            const auto& loaded = *historical_events_;
+            std::cout << "Loaded " << loaded.size() << " historical events\nount";
+            std::cout << "  Time range: " << loaded.front().timestamp_ns
+                      << " → " << loaded.back().timestamp_ns << "\nount";
+            std::cout << "  Duration: "
+                      << (loaded.back().timestamp_ns - loaded.front().timestamp_ns) / 1e9
+                      << " seconds\nount";
         }
-
-        std::sort(historical_events_.begin(), historical_events_.end(),
-            [](const HistoricalEvent& a, const HistoricalEvent& b) {
-                return a.timestamp_ns < b.timestamp_ns;
-            });
-
-        std::cout << "Loaded " << events_loaded << " historical events\nount";
-        std::cout << "  Time range: " << historical_events_.front().timestamp_ns
-                  << " → " << historical_events_.back().timestamp_ns << "\nount";
-        std::cout << "  Duration: "
-                  << (historical_events_.back().timestamp_ns -
-                      historical_events_.front().timestamp_ns) / 1e9
-                  << " seconds\nount";
 
         if (replay_logger_) {
             std::string checksum = InstitutionalLogging::SHA256Hasher::file_checksum(filepath);
-            std::cout << "  SHA256:   " << checksum << "\nount\nount";
+            if (config_.verbose) {
+                std::cout << "  SHA256:   " << checksum << "\nount\nount";
+            }
 
             std::stringstream config_json;
             config_json << "{\"latency_ns\":" << config_.simulated_latency_ns
@@ -382,136 +477,280 @@ public:
                        << ",\"commission\":" << config_.commission_per_share << "}";
 
             replay_logger_->log_config(config_json.str(), config_.random_seed, checksum);
-        } else {
+        } else if (config_.verbose) {
             std::cout << "\nount";
         }
 
         return true;
     }
 
-    PerformanceMetrics run_backtest() {
-        std::cout << "Starting deterministic backtest...\nount";
-        std::cout << "Simulated latency: " << config_.simulated_latency_ns << " ns\nount";
-        std::cout << "Initial capital: $" << config_.initial_capital << "\nount\nount";
-
-        current_position_ = 0;
-        current_capital_ = config_.initial_capital;
-        realized_pnl_ = 0.0;
-        unrealized_pnl_ = 0.0;
-        active_orders_.clear();
-        filled_orders_.clear();
-        pnl_history_.clear();
-
-        MarketTick previous_tick;
-        bool first_tick = true;
+    // Replay from a columnar tick store (see convert_csv_to_binary). The file
+    // is mmapped and events are assembled one at a time during the run, so
+    // nothing is parsed, sorted or materialized up front.
+    bool load_binary_data(const std::string& filepath) {
+        try {
+            tick_store_ = std::make_shared<const TickStoreReader>(filepath);
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to open tick store: " << e.what() << std::endl;
+            tick_store_.reset();
+            return false;
+        }
+        historical_events_.reset();
+        replay_.clear();
 
-        size_t progress_interval = historical_events_.size() / 20;
+        if (!tick_store_->is_sorted()) {
+            std::cerr << "Tick store is not in timestamp order: " << filepath << std::endl;
+            tick_store_.reset();
+            return false;
+        }
 
-        size_t signal_count = 0;
-        size_t risk_blocked = 0;
-        size_t quotes_invalid = 0;
+        if (tick_store_->empty()) {
+            std::cerr << "Tick store is empty: " << filepath << std::endl;
+            tick_store_.reset();
+            return false;
+        }
 
-        for (size_t pos = 0; pos < historical_events_.size(); ++pos) {
-            const auto& event = historical_events_[pos];
-            current_time_ns_ = event.timestamp_ns;
+        if (config_.verbose) {
+            std::cout << "Mapped " << tick_store_->size() << " historical events\n";
+            std::cout << "  Time range: " << tick_store_->min_timestamp_ns()
+                      << " → " << tick_store_->max_timestamp_ns() << "\n";
+        }
 
-            MarketTick current_tick = event.to_market_tick();
+        if (replay_logger_) {
+            // Hashing a multi-GB store would defeat instant start; identify it
+            // by its header instead
+            std::stringstream identity;
+            identity << "tickstore:" << tick_store_->size() << ":"
+                     << tick_store_->min_timestamp_ns() << "-" << tick_store_->max_timestamp_ns();
 
-            if (first_tick) {
-                previous_tick = current_tick;
-                first_tick = false;
-                continue;
-            }
+            std::stringstream config_json;
+            config_json << "{\"latency_ns\":" << config_.simulated_latency_ns
+                       << ",\"seed\":" << config_.random_seed
+                       << ",\"max_position\":" << config_.max_position
+                       << ",\"commission\":" << config_.commission_per_share << "}";
 
-            TradingEvent trading_event;
-            trading_event.arrival_time = now();
-            trading_event.event_type = (current_tick.trade_volume > 0) ?
-                current_tick.trade_side : Side::BUY;
-            hawkes_engine_->update(trading_event);
+            replay_logger_->log_config(config_json.str(), config_.random_seed, identity.str());
+        }
 
-            auto signal = generate_trading_signal(current_tick, previous_tick);
+        return true;
+    }
 
-            if (signal.should_trade) {
-                signal_count++;
-            }
+    // One-time CSV -> tick store conversion. Returns false if the CSV can't
+    // be read or the store can't be written.
+    static bool convert_csv_to_binary(const std::string& csv_path, const std::string& store_path,
+                                      size_t* events_written = nullptr) {
+        TickStoreWriter writer;
+        try {
+            csv::parse_file<HistoricalEvent>(csv_path, [&](const HistoricalEvent& event) {
+                writer.append(event);
+            });
+        } catch (const std::exception&) {
+            std::cerr << "Failed to open file: " << csv_path << std::endl;
+            return false;
+        }
 
-            if (signal.should_trade) {
-                execute_trading_decision(signal, current_tick);
+        try {
+            const size_t n = writer.write(store_path);
+            if (events_written) {
+                *events_written = n;
             }
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return false;
+        }
+        return true;
+    }
 
-            process_fill_check(0);
-
-            update_pnl(current_tick);
-
-            record_state(current_tick);
+    // Multi-file replay. Every added source is streamed through one k-way
+    // merge in timestamp order (ties in the order sources were added); each
+    // file must itself be time ordered. Adding a source replaces data from
+    // load_historical_data()/load_binary_data(), and loading clears sources.
+    // CSV files carry no asset column, so each is tagged with asset_id.
+    bool add_csv_source(const std::string& filepath, uint32_t asset_id) {
+        try {
+            add_replay_source(std::make_unique<CsvReplaySource<HistoricalEvent>>(filepath, asset_id));
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to open replay source: " << e.what() << std::endl;
+            return false;
+        }
+        return true;
+    }
 
-            if (replay_logger_ && (pos % 100 == 0)) {
-                replay_logger_->log_market_tick(
-                    current_time_ns_,
-                    current_tick.bid_price,
-                    current_tick.ask_price,
-                    current_tick.bid_size,
-                    current_tick.ask_size
-                );
-            }
+    // asset_id overrides the store's own asset column
+    bool add_tick_store_source(const std::string& filepath, uint32_t asset_id = ASSET_FROM_DATA) {
+        try {
+            add_replay_source(std::make_unique<TickStoreReplaySource<HistoricalEvent>>(filepath, asset_id));
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to open replay source: " << e.what() << std::endl;
+            return false;
+        }
+        return true;
+    }
 
-            if (replay_logger_ && (pos % 1000 == 0)) {
-                replay_logger_->log_pnl_update(
-                    current_time_ns_,
-                    realized_pnl_,
-                    unrealized_pnl_,
-                    current_position_
-                );
-            }
+    void add_replay_source(std::unique_ptr<ReplaySource<HistoricalEvent>> source) {
+        historical_events_.reset();
+        tick_store_.reset();
+        if (replay_logger_) {
+            replay_logger_->log_config("{\"source\":\"" + source->name() + "\"}", config_.random_seed,
+                                       "replay_source:" + std::to_string(replay_.source_count()));
+        }
+        replay_.add(std::move(source));
+    }
 
-            previous_tick = current_tick;
+    void clear_replay_sources() { replay_.clear(); }
+    size_t get_replay_source_count() const { return replay_.source_count(); }
 
-            if (pos % progress_interval == 0) {
-                double progress = (pos * 100.0) / historical_events_.size();
-                std::cout << "Progress: " << std::fixed << std::setprecision(1)
-                          << progress << "% | P&L: $" << std::setprecision(2)
-                          << (realized_pnl_ + unrealized_pnl_) << "\r" << std::flush;
-            }
+    PerformanceMetrics run_backtest() {
+        if (config_.verbose) {
+            std::cout << "Starting deterministic backtest...\nount";
+            std::cout << "Simulated latency: " << config_.simulated_latency_ns << " ns\nount";
+            std::cout << "Initial capital: $" << config_.initial_capital << "\nount\nount";
         }
 
-        std::cout << "\nBacktest complete!\nount";
-        std::cout << "\nDEBUG INFO:\nount";
-        std::cout << "  Signals generated: " << signal_count << "\nount";
-        std::cout << "  Orders submitted: " << (order_id_counter_ - 1) << "\nount";
-        std::cout << "  Active orders: " << active_orders_.size() << "\nount";
-        std::cout << "  Filled orders: " << filled_orders_.size() << "\nount\nount";
+        fill_rng_.seed(config_.random_seed);
+        reset_run_state();
+        return replay_from(0);
+    }
 
-        if (replay_logger_) {
-            replay_logger_->flush();
-            std::cout << "Event replay log written to: logs/backtest_replay.log\nount";
+    // Restores a checkpoint written by save_checkpoint() or the periodic
+    // checkpoints, then replays the remaining events. The same data must be
+    // loaded as when it was written. Latency and slippage reports cover only
+    // the resumed part. Throws std::runtime_error on a bad or mismatched file.
+    PerformanceMetrics resume_backtest(const std::string& checkpoint_path) {
+        if (config_.verbose) {
+            std::cout << "Resuming backtest from " << checkpoint_path << "\n";
         }
+        return replay_from(restore_checkpoint(checkpoint_path));
+    }
 
-        if (risk_logger_) {
-            std::cout << "Risk breach log written to: logs/risk_breaches.log\nount";
-            std::cout << "  Total risk breaches: " << risk_logger_->get_breach_count() << "\nount";
+    // Engine state after the events replayed so far: positions, in-flight
+    // orders, queue positions, per-asset models, running metrics and the
+    // fill RNG. Returns the file size.
+    size_t save_checkpoint(const std::string& path) const {
+        CheckpointWriter writer(current_time_ns_, replay_sequence_);
+
+        auto& engine = writer.section("engine", CHECKPOINT_VERSION);
+        engine.put<uint8_t>(replay_.empty() ? 0 : 1);
+        engine.put<uint64_t>(replay_.empty() ? get_historical_events_count() : replay_.source_count());
+        engine.put(config_.fill_mode);
+        engine.put(replay_sequence_);
+        engine.put(current_time_ns_);
+        engine.put(current_position_);
+        engine.put(current_capital_);
+        engine.put(realized_pnl_);
+        engine.put(unrealized_pnl_);
+        engine.put(order_id_counter_);
+        engine.put(orders_with_fills_);
+        engine.put(fill_count_);
+        engine.put(signal_count_);
+        engine.put(recent_pnl_);
+        engine.put(recent_pnl_count_);
+        std::ostringstream rng;
+        rng << fill_rng_;
+        engine.put_string(rng.str());
+
+        auto& orders = writer.section("orders", CHECKPOINT_VERSION);
+        std::vector<SimulatedOrder> active;
+        active.reserve(active_orders_.size());
+        for (const auto& o : active_orders_) active.push_back(o.second);
+        std::sort(active.begin(), active.end(), [](const SimulatedOrder& a, const SimulatedOrder& b) {
+            return a.order.order_id < b.order.order_id;
+        });
+        orders.put_vector(active);
+        std::vector<SavedOrderEvent> events;
+        order_events_.for_each_in_order([&](uint64_t priority, const OrderEvent& e) {
+            events.push_back(SavedOrderEvent{priority, e});
+        });
+        orders.put_vector(events);
+        std::vector<SavedDecisionMid> mids;
+        for (const auto& m : order_decision_mid_prices_) mids.push_back(SavedDecisionMid{m.first, m.second});
+        orders.put_vector(mids);
+        orders.put_vector(filled_orders_);
+
+        performance_.save_state(writer.section("performance", CHECKPOINT_VERSION));
+
+        auto& assets = writer.section("assets", CHECKPOINT_VERSION);
+        assets.put<uint64_t>(assets_.size());
+        for (const AssetState& asset : assets_) {
+            assets.put(asset.asset_id);
+            assets.put(asset.seen);
+            assets.put(asset.unrealized_pnl);
+            assets.put(asset.last_tick);
+            assets.put(asset.filter);
+            asset.ledger.save_state(assets);
+            asset.hawkes.save_state(assets);
+            asset.inference->save_state(assets);
+            asset.strategy->save_state(assets);
+            asset.risk.save_state(assets);
+            asset.queue.save_state(assets);
         }
 
-        std::cout << "\nount";
-        order_to_ack_latency_.calculate();
-        order_to_ack_latency_.print_report("ORDER→ACK");
-        order_to_ack_latency_.print_histogram(15);
-
-        total_rtt_latency_.calculate();
-        total_rtt_latency_.print_report("TOTAL RTT");
-        total_rtt_latency_.print_histogram(15);
-
-        slippage_analyzer_.print_report();
+        return writer.write(path);
+    }
 
-        try {
-            InstitutionalLogging::SystemVerificationLogger::generate_report(
-                "logs/system_verification.log"
-            );
-        } catch (const std::exception& e) {
-            std::cerr << "Warning: Failed to generate system verification report: "
-                     << e.what() << "\nount";
+    // Replaces the engine state with a checkpoint's (warm start without
+    // replaying). Returns the number of events it covers.
+    uint64_t restore_checkpoint(const std::string& path) {
+        const CheckpointReader reader(path);
+        reset_run_state();
+
+        auto engine = reader.section("engine", CHECKPOINT_VERSION);
+        const bool merged = engine.get<uint8_t>() != 0;
+        const uint64_t data_size = engine.get<uint64_t>();
+        if (merged != !replay_.empty() ||
+            data_size != (merged ? replay_.source_count() : get_historical_events_count())) {
+            throw std::runtime_error("Checkpoint was written against different data: " + path);
+        }
+        if (engine.get<FillMode>() != config_.fill_mode) {
+            throw std::runtime_error("Checkpoint was written with a different fill mode: " + path);
+        }
+        engine.get(replay_sequence_);
+        engine.get(current_time_ns_);
+        engine.get(current_position_);
+        engine.get(current_capital_);
+        engine.get(realized_pnl_);
+        engine.get(unrealized_pnl_);
+        engine.get(order_id_counter_);
+        engine.get(orders_with_fills_);
+        engine.get(fill_count_);
+        engine.get(signal_count_);
+        engine.get(recent_pnl_);
+        engine.get(recent_pnl_count_);
+        std::istringstream rng(engine.get_string());
+        rng >> fill_rng_;
+
+        auto orders = reader.section("orders", CHECKPOINT_VERSION);
+        std::vector<SimulatedOrder> active;
+        orders.get_vector(active);
+        for (const auto& o : active) active_orders_.emplace(o.order.order_id, o);
+        std::vector<SavedOrderEvent> events;
+        orders.get_vector(events);
+        for (const auto& e : events) order_events_.emplace(e.priority, e.event);
+        std::vector<SavedDecisionMid> mids;
+        orders.get_vector(mids);
+        for (const auto& m : mids) order_decision_mid_prices_.emplace(m.order_id, m.mid_price);
+        orders.get_vector(filled_orders_);
+
+        auto performance = reader.section("performance", CHECKPOINT_VERSION);
+        performance_.restore_state(performance);
+
+        auto assets = reader.section("assets", CHECKPOINT_VERSION);
+        const uint64_t count = assets.get<uint64_t>();
+        for (uint64_t i = 0; i < count; ++i) {
+            AssetState& asset = asset_state(assets.get<uint32_t>());
+            assets.get(asset.seen);
+            assets.get(asset.unrealized_pnl);
+            assets.get(asset.last_tick);
+            assets.get(asset.filter);
+            asset.ledger.restore_state(assets);
+            asset.hawkes.restore_state(assets);
+            asset.inference->restore_state(assets);
+            asset.strategy->restore_state(assets);
+            asset.risk.restore_state(assets);
+            asset.queue.restore_state(assets);
         }
 
-        return calculate_metrics();
+        return replay_sequence_;
     }
 
     std::map<int64_t, PerformanceMetrics> run_latency_sensitivity_analysis() {
@@ -525,9 +764,6 @@ public:
             std::cout << "Testing latency: " << latency_ns << " ns...\nount";
 
             config_.simulated_latency_ns = latency_ns;
-            mm_strategy_ = std::make_unique<DynamicMMStrategy>(
-                0.01, 0.20, 600.0, 10.0, 0.01, latency_ns
-            );
 
             auto metrics = run_backtest();
             results[latency_ns] = metrics;
@@ -548,11 +784,39 @@ public:
     double get_current_capital() const { return current_capital_; }
     double get_realized_pnl() const { return realized_pnl_; }
     double get_unrealized_pnl() const { return unrealized_pnl_; }
-    size_t get_historical_events_count() const { return historical_events_.size(); }
+    // Merged sources: events replayed by the last run
+    size_t get_historical_events_count() const {
+        if (!replay_.empty()) return replay_.delivered();
+        if (tick_store_) return tick_store_->size();
+        return historical_events_ ? historical_events_->size() : 0;
+    }
+
+    // Replay the data another engine loaded, without copying it. The events
+    // are immutable once loaded, so engines sharing them can run on
+    // different threads.
+    void share_historical_data(const BacktestingEngine& source) {
+        historical_events_ = source.historical_events_;
+        tick_store_ = source.tick_store_;
+    }
     size_t get_active_orders_count() const { return active_orders_.size(); }
-    size_t get_filled_orders_count() const { return filled_orders_.size(); }
+    size_t get_filled_orders_count() const { return fill_count_; }
+    // One entry per execution; a partially filled order can appear more than
+    // once. Empty unless config.record_fills.
+    const HotVector<SimulatedOrder>& get_filled_orders() const { return filled_orders_; }
+    size_t get_asset_count() const { return assets_.size(); }
+    // Per-asset state from the last run; throws std::out_of_range for an
+    // asset that never traded
+    const PositionLedger& get_ledger(uint32_t asset_id) const { return asset_state(asset_id).ledger; }
+    int64_t get_position(uint32_t asset_id) const { return asset_state(asset_id).ledger.position(); }
+    const FPGA_DNN_Inference& get_inference(uint32_t asset_id) const { return *asset_state(asset_id).inference; }
 
 private:
+    std::unique_ptr<DynamicMMStrategy> make_strategy(int64_t latency_ns) const {
+        const StrategyParams& p = config_.strategy;
+        return std::make_unique<DynamicMMStrategy>(
+            p.risk_aversion, p.volatility, p.time_horizon, p.order_arrival_rate, p.tick_size, latency_ns
+        );
+    }
 
     struct TradingSignal {
         bool should_trade = false;
@@ -589,31 +853,254 @@ private:
         }
     };
 
-    TemporalFilterState temporal_filter_;
+    // Replays events [start, end) and reports
+    PerformanceMetrics replay_from(uint64_t start) {
+        if (replay_.empty()) {
+            const size_t total_events = get_historical_events_count();
+            const size_t progress_interval = std::max<size_t>(1, total_events / 20);
+            HistoricalEvent stream_event;
+
+            for (size_t pos = start; pos < total_events; ++pos) {
+                replay_event(next_event(pos, stream_event), pos);
+                replay_sequence_ = pos + 1;
+                maybe_checkpoint();
+
+                if (config_.verbose && pos % progress_interval == 0) {
+                    double progress = (pos * 100.0) / total_events;
+                    std::cout << "Progress: " << std::fixed << std::setprecision(1)
+                              << progress << "% | P&L: $" << std::setprecision(2)
+                              << (realized_pnl_ + unrealized_pnl_) << "\r" << std::flush;
+                }
+            }
+        } else {
+            // Total unknown without a pass over the files: report by count
+            replay_.rewind();
+            HistoricalEvent event;
+            // Sources only stream forward: skip what the checkpoint covers
+            for (uint64_t skipped = 0; skipped < start && replay_.next(event); ++skipped) {}
+            for (size_t pos = start; replay_.next(event); ++pos) {
+                replay_event(event, pos);
+                replay_sequence_ = pos + 1;
+                maybe_checkpoint();
+
+                if (config_.verbose && pos % (1u << 20) == 0) {
+                    std::cout << "Replayed: " << pos << " events, " << assets_.size()
+                              << " assets | P&L: $" << std::fixed << std::setprecision(2)
+                              << (realized_pnl_ + unrealized_pnl_) << "\r" << std::flush;
+                }
+            }
+        }
+
+        if (replay_logger_) {
+            replay_logger_->flush();
+        }
+
+        if (config_.verbose) {
+            std::cout << "\nBacktest complete!\nount";
+            std::cout << "\nDEBUG INFO:\nount";
+            std::cout << "  Signals generated: " << signal_count_ << "\nount";
+            std::cout << "  Orders submitted: " << (order_id_counter_ - 1) << "\nount";
+            std::cout << "  Active orders: " << active_orders_.size() << "\nount";
+            std::cout << "  Filled orders: " << fill_count_ << "\nount\nount";
+
+            if (replay_logger_) {
+                if (journal_) {
+                    std::cout << "Event replay journal written to: " << journal_->path()
+                              << " (decoded to logs/backtest_replay.log on shutdown)\n";
+                } else {
+                    std::cout << "Event replay log written to: logs/backtest_replay.log\nount";
+                }
+            }
+
+            if (risk_logger_) {
+                std::cout << "Risk breach log written to: logs/risk_breaches.log\nount";
+                std::cout << "  Total risk breaches: " << risk_logger_->get_breach_count() << "\nount";
+            }
+
+            std::cout << "\nount";
+            order_to_ack_latency_.calculate();
+            order_to_ack_latency_.print_report("ORDER→ACK");
+            order_to_ack_latency_.print_histogram(15);
+
+            total_rtt_latency_.calculate();
+            total_rtt_latency_.print_report("TOTAL RTT");
+            total_rtt_latency_.print_histogram(15);
+
+            slippage_analyzer_.print_report();
+        }
+
+        if (config_.enable_replay_logging) {
+            try {
+                InstitutionalLogging::SystemVerificationLogger::generate_report(
+                    "logs/system_verification.log"
+                );
+            } catch (const std::exception& e) {
+                std::cerr << "Warning: Failed to generate system verification report: "
+                         << e.what() << "\nount";
+            }
+        }
+
+        return calculate_metrics();
+    }
+
+    void reset_run_state() {
+        current_position_ = 0;
+        current_capital_ = config_.initial_capital;
+        realized_pnl_ = 0.0;
+        unrealized_pnl_ = 0.0;
+        active_orders_.clear();
+        order_events_.clear();
+        filled_orders_.clear();
+        orders_with_fills_ = 0;
+        fill_count_ = 0;
+        assets_.clear();
+        asset_slots_.clear();
+        performance_ = StreamingPerformance(config_.initial_capital, config_.equity_curve_points);
+        recent_pnl_count_ = 0;
+        signal_count_ = 0;
+        replay_sequence_ = 0;
+        order_decision_mid_prices_.clear();
+    }
+
+    void maybe_checkpoint() {
+        if (config_.checkpoint_interval_events > 0 &&
+            replay_sequence_ % config_.checkpoint_interval_events == 0) {
+            save_checkpoint(config_.checkpoint_prefix + "_" + std::to_string(replay_sequence_) + ".ckpt");
+        }
+    }
+
+    // Everything the replay keeps per asset; slots are dense and stable
+    // (std::deque never moves elements on growth)
+    struct AssetState {
+        AssetState(uint32_t id, const Config& config, const FPGA_DNN_Inference& model,
+                   std::unique_ptr<DynamicMMStrategy> mm)
+            : asset_id(id),
+              hawkes(config.hawkes.mu_buy, config.hawkes.mu_sell, config.hawkes.alpha_self,
+                     config.hawkes.alpha_cross, config.hawkes.beta, config.hawkes.gamma,
+                     config.hawkes.max_history),
+              inference(std::make_unique<FPGA_DNN_Inference>(model)),
+              strategy(std::move(mm)),
+              risk(config.max_position, 50000.0, 100000.0),
+              queue(config.strategy.tick_size) {}
+
+        uint32_t asset_id;
+        HawkesEngine hawkes;
+        std::unique_ptr<FPGA_DNN_Inference> inference;   // Feature history (book deltas, last mid) is per asset
+        std::unique_ptr<DynamicMMStrategy> strategy;
+        RiskControl risk;
+        QueueFillSimulator queue;
+        TemporalFilterState filter;
+        PositionLedger ledger;
+        MarketTick last_tick;
+        bool seen = false;
+        double unrealized_pnl = 0.0;
+    };
+
+    static constexpr uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t MAX_ASSET_ID = 1u << 24;
+
+    AssetState& asset_state(uint32_t asset_id) {
+        if (asset_id < asset_slots_.size() && asset_slots_[asset_id] != NO_SLOT) {
+            return assets_[asset_slots_[asset_id]];
+        }
+        if (asset_id >= MAX_ASSET_ID) {
+            throw std::out_of_range("Asset ID outside the dense range: " + std::to_string(asset_id));
+        }
+        if (asset_id >= asset_slots_.size()) asset_slots_.resize(asset_id + 1, NO_SLOT);
+        asset_slots_[asset_id] = static_cast<uint32_t>(assets_.size());
+        return assets_.emplace_back(asset_id, config_, *fpga_inference_,
+                                    make_strategy(config_.simulated_latency_ns));
+    }
+
+    const AssetState& asset_state(uint32_t asset_id) const {
+        if (asset_id >= asset_slots_.size() || asset_slots_[asset_id] == NO_SLOT) {
+            throw std::out_of_range("No state for asset " + std::to_string(asset_id));
+        }
+        return assets_[asset_slots_[asset_id]];
+    }
+
+    // One market event. An asset's first event only seeds its previous tick.
+    void replay_event(const HistoricalEvent& event, size_t pos) {
+        current_time_ns_ = event.timestamp_ns;
+        AssetState& asset = asset_state(event.asset_id);
+
+        MarketTick current_tick = event.to_market_tick();
+
+        if (!asset.seen) {
+            asset.last_tick = current_tick;
+            asset.seen = true;
+            return;
+        }
+
+        process_scheduled_events();
+        if (config_.fill_mode == FillMode::QUEUE_POSITION) {
+            apply_market_to_queues(asset, event, current_tick);
+        }
+
+        TradingEvent trading_event;
+        // Simulated time, so intensities don't depend on how fast the replay runs
+        trading_event.arrival_time = Timestamp(std::chrono::nanoseconds(current_time_ns_));
+        trading_event.event_type = (current_tick.trade_volume > 0) ?
+            current_tick.trade_side : Side::BUY;
+        asset.hawkes.update(trading_event);
+
+        auto signal = generate_trading_signal(asset, current_tick, asset.last_tick);
+
+        if (signal.should_trade) {
+            signal_count_++;
+            execute_trading_decision(asset, signal, current_tick);
+        }
+
+        update_pnl(asset, current_tick);
+
+        record_state(current_tick);
+
+        if (replay_logger_ && (pos % 100 == 0)) {
+            replay_logger_->log_market_tick(
+                current_time_ns_,
+                current_tick.bid_price,
+                current_tick.ask_price,
+                current_tick.bid_size,
+                current_tick.ask_size
+            );
+        }
+
+        if (replay_logger_ && (pos % 1000 == 0)) {
+            replay_logger_->log_pnl_update(
+                current_time_ns_,
+                realized_pnl_,
+                unrealized_pnl_,
+                current_position_
+            );
+        }
+
+        asset.last_tick = current_tick;
+    }
+
+    // Reference asset's latest book for cross-asset features
+    const MarketTick& reference_tick(const MarketTick& current_tick) const {
+        const uint32_t ref = config_.reference_asset_id;
+        if (ref == Config::NO_REFERENCE_ASSET || ref == current_tick.asset_id ||
+            ref >= asset_slots_.size() || asset_slots_[ref] == NO_SLOT) {
+            return current_tick;
+        }
+        const AssetState& r = assets_[asset_slots_[ref]];
+        return r.seen ? r.last_tick : current_tick;
+    }
 
     TradingSignal generate_trading_signal(
+        AssetState& asset,
         const MarketTick& current_tick,
         const MarketTick& previous_tick
     ) {
         TradingSignal signal;
+        TemporalFilterState& filter = asset.filter;
 
         const int MINIMUM_PERSISTENCE_TICKS = 12;
         const double OBI_THRESHOLD = 0.09;
 
-        auto features = FPGA_DNN_Inference::extract_features(
-            current_tick,
-            previous_tick,
-            current_tick,
-            hawkes_engine_->get_buy_intensity(),
-            hawkes_engine_->get_sell_intensity()
-        );
-
-        auto prediction = fpga_inference_->predict(features);
-        double buy_score = prediction[0];
-        double sell_score = prediction[2];
-
-        double buy_intensity = hawkes_engine_->get_buy_intensity();
-        double sell_intensity = hawkes_engine_->get_sell_intensity();
+        double buy_intensity = asset.hawkes.get_buy_intensity();
+        double sell_intensity = asset.hawkes.get_sell_intensity();
         double total_intensity = buy_intensity + sell_intensity;
         double current_obi = (total_intensity > 0.001) ?
             (buy_intensity - sell_intensity) / total_intensity : 0.0;
@@ -624,96 +1111,94 @@ private:
 
             double current_direction = (current_obi > 0) ? 1.0 : -1.0;
 
-            bool direction_consistent = (current_direction == temporal_filter_.last_obi_direction) ||
-                                       (temporal_filter_.confirmation_ticks == 0);
+            bool direction_consistent = (current_direction == filter.last_obi_direction) ||
+                                       (filter.confirmation_ticks == 0);
 
             if (direction_consistent) {
 
-                if (temporal_filter_.confirmation_ticks == 0) {
+                if (filter.confirmation_ticks == 0) {
 
-                    temporal_filter_.signal_start_time_ns = current_time_ns_;
-                    temporal_filter_.last_obi_direction = current_direction;
+                    filter.signal_start_time_ns = current_time_ns_;
+                    filter.last_obi_direction = current_direction;
                 }
 
-                temporal_filter_.accumulated_obi += current_obi;
-                temporal_filter_.confirmation_ticks++;
-                temporal_filter_.max_obi_strength = std::max(
-                    temporal_filter_.max_obi_strength,
+                filter.accumulated_obi += current_obi;
+                filter.confirmation_ticks++;
+                filter.max_obi_strength = std::max(
+                    filter.max_obi_strength,
                     std::abs(current_obi)
                 );
-                temporal_filter_.avg_obi_strength =
-                    temporal_filter_.accumulated_obi / temporal_filter_.confirmation_ticks;
+                filter.avg_obi_strength =
+                    filter.accumulated_obi / filter.confirmation_ticks;
 
-                if (temporal_filter_.confirmation_ticks >= MINIMUM_PERSISTENCE_TICKS) {
+                if (filter.confirmation_ticks >= MINIMUM_PERSISTENCE_TICKS) {
 
                     double current_strength = std::abs(current_obi);
-                    double avg_strength = std::abs(temporal_filter_.avg_obi_strength);
+                    double avg_strength = std::abs(filter.avg_obi_strength);
 
                     if (current_strength >= 0.60 * avg_strength) {
                         signal_is_persistent = true;
-                        signal.signal_persistence_ns = current_time_ns_ - temporal_filter_.signal_start_time_ns;
+                        signal.signal_persistence_ns = current_time_ns_ - filter.signal_start_time_ns;
                     }
                 }
             } else {
 
-                temporal_filter_.reset();
-                temporal_filter_.signal_start_time_ns = current_time_ns_;
-                temporal_filter_.last_obi_direction = current_direction;
-                temporal_filter_.accumulated_obi = current_obi;
-                temporal_filter_.confirmation_ticks = 1;
-                temporal_filter_.max_obi_strength = std::abs(current_obi);
-                temporal_filter_.avg_obi_strength = std::abs(current_obi);
+                filter.reset();
+                filter.signal_start_time_ns = current_time_ns_;
+                filter.last_obi_direction = current_direction;
+                filter.accumulated_obi = current_obi;
+                filter.confirmation_ticks = 1;
+                filter.max_obi_strength = std::abs(current_obi);
+                filter.avg_obi_strength = std::abs(current_obi);
             }
         } else {
 
-            temporal_filter_.reset();
+            filter.reset();
         }
 
+        // Same tick-to-quote path as the live loop. Features and the model
+        // run on every tick (the feature engine tracks book deltas); the
+        // persistence filter gates quoting and risk.
+        pipeline::TickContext ctx{current_tick, reference_tick(current_tick)};
+        ctx.buy_intensity = buy_intensity;
+        ctx.sell_intensity = sell_intensity;
+        ctx.position = asset.ledger.position();
+        ctx.volatility = 0.20;
+        ctx.time_remaining = 600.0;
+        ctx.order_id = order_id_counter_;
+        const pipeline::Decision decision =
+            pipeline::make_production_pipeline(*asset.inference, *asset.strategy, asset.risk)
+                .on_tick(ctx, [signal_is_persistent](const pipeline::Decision&) { return signal_is_persistent; });
+
         if (!signal_is_persistent) {
             return signal;
         }
 
-        double time_remaining = 600.0;
-        double latency_cost = mm_strategy_->calculate_latency_cost(
-            0.20, current_tick.mid_price
-        );
-
-        auto quotes = mm_strategy_->calculate_quotes(
-            current_tick.mid_price,
-            current_position_,
-            time_remaining,
-            latency_cost
-        );
-
-        Order test_order;
-        test_order.side = Side::BUY;
-        test_order.quantity = 100;
-        test_order.price = quotes.bid_price;
-
+        const QuotePair& quotes = decision.quotes;
         bool price_valid = (quotes.bid_price > 0.0 && quotes.ask_price > 0.0 &&
                            quotes.bid_price < quotes.ask_price);
-        bool risk_ok = risk_control_->check_pre_trade_limits(test_order, current_position_);
 
-        if (!price_valid || !risk_ok) {
+        if (!price_valid || !(decision.bid_approved || decision.ask_approved)) {
             return signal;
         }
 
-        if (mm_strategy_->should_quote(quotes.spread, latency_cost) || quotes.spread > 0.0001) {
+        if (decision.should_quote || quotes.spread > 0.0001) {
+            // Only the sides risk approved are submitted
             signal.should_trade = true;
-            signal.bid_price = quotes.bid_price;
-            signal.ask_price = quotes.ask_price;
+            signal.bid_price = decision.bid_approved ? quotes.bid_price : 0.0;
+            signal.ask_price = decision.ask_approved ? quotes.ask_price : 0.0;
             signal.bid_size = quotes.bid_size;
             signal.ask_size = quotes.ask_size;
-            signal.signal_strength = temporal_filter_.avg_obi_strength;
+            signal.signal_strength = filter.avg_obi_strength;
 
             if (replay_logger_) {
-                std::string side_str = (temporal_filter_.last_obi_direction > 0) ? "BUY" : "SELL";
+                std::string_view side_str = (filter.last_obi_direction > 0) ? "BUY" : "SELL";
                 replay_logger_->log_signal_decision(
                     current_time_ns_,
                     true,
                     side_str,
                     signal.signal_strength,
-                    temporal_filter_.confirmation_ticks,
+                    filter.confirmation_ticks,
                     current_obi
                 );
             }
@@ -723,6 +1208,7 @@ private:
     }
 
     void execute_trading_decision(
+        const AssetState& asset,
         const TradingSignal& signal,
         const MarketTick& current_tick
     ) {
@@ -730,6 +1216,7 @@ private:
         if (signal.bid_price > 0.0 && signal.bid_size > 0) {
             Order bid_order;
             bid_order.order_id = order_id_counter_++;
+            bid_order.asset_id = asset.asset_id;
             bid_order.side = Side::BUY;
             bid_order.price = signal.bid_price;
             bid_order.quantity = signal.bid_size;
@@ -741,6 +1228,7 @@ private:
         if (signal.ask_price > 0.0 && signal.ask_size > 0) {
             Order ask_order;
             ask_order.order_id = order_id_counter_++;
+            ask_order.asset_id = asset.asset_id;
             ask_order.side = Side::SELL;
             ask_order.price = signal.ask_price;
             ask_order.quantity = signal.ask_size;
@@ -759,12 +1247,19 @@ private:
         sim_order.submit_time_ns = current_time_ns_;
         sim_order.queue_position = estimate_queue_position(order, current_tick);
 
-        const int64_t fill_check_time = current_time_ns_ + enforced_latency;
-
-        active_orders_.push_back(sim_order);
+        // Fill check fires exactly at submit + latency, in replay time
+        const int64_t arrival_ns = current_time_ns_ + std::max<int64_t>(0, enforced_latency);
+        if (order_events_.emplace(static_cast<uint64_t>(arrival_ns), OrderEvent{order.order_id, OrderEvent::ARRIVAL}) ==
+            OrderEventQueue::INVALID_HANDLE) {
+            if (replay_logger_) {
+                replay_logger_->log_order_cancel(current_time_ns_, order.order_id, "too_many_in_flight");
+            }
+            return;
+        }
+        active_orders_.emplace(order.order_id, sim_order);
 
         if (replay_logger_) {
-            std::string side_str = (order.side == Side::BUY) ? "BUY" : "SELL";
+            std::string_view side_str = (order.side == Side::BUY) ? "BUY" : "SELL";
             replay_logger_->log_order_submit(
                 current_time_ns_,
                 order.order_id,
@@ -777,116 +1272,205 @@ private:
         order_decision_mid_prices_[order.order_id] = current_tick.mid_price;
     }
 
+    // Run every order event due by the current replay time, in time
+    // order, each at its exact time
     void process_scheduled_events() {
-
+        OrderEvent event;
+        while (order_events_.top_priority() <= static_cast<uint64_t>(current_time_ns_)) {
+            const int64_t event_ns = static_cast<int64_t>(order_events_.top_priority());
+            order_events_.pop(event);
+            if (event.kind == OrderEvent::ARRIVAL) {
+                resolve_order(event.order_id, event_ns);
+            } else {
+                expire_order(event.order_id, event_ns);
+            }
+        }
     }
 
-    void process_fill_check(uint64_t order_id) {
-
-        int64_t enforced_latency = config_.simulated_latency_ns;
-
-        auto it = active_orders_.begin();
-        while (it != active_orders_.end()) {
-
-            int64_t time_since_submit = current_time_ns_ - it->submit_time_ns;
+    // Order reached the venue after simulated latency
+    void resolve_order(uint64_t order_id, int64_t resolve_time_ns) {
+        auto it = active_orders_.find(order_id);
+        if (it == active_orders_.end()) {
+            return;
+        }
+        SimulatedOrder& order = it->second;
+        const int64_t time_since_submit = resolve_time_ns - order.submit_time_ns;
+        order_to_ack_latency_.add_sample(time_since_submit);
 
-            if (time_since_submit >= enforced_latency) {
+        if (config_.fill_mode == FillMode::QUEUE_POSITION) {
+            join_queue(order, resolve_time_ns);
+            return;
+        }
 
-        MarketTick current_market = get_current_market_state();
+        MarketTick current_market = get_current_market_state(order.order.asset_id, resolve_time_ns);
 
         double volatility = estimate_current_volatility();
         int64_t latency_us = time_since_submit / 1000;
 
         double fill_prob = fill_model_.calculate_fill_probability(
-            it->order,
+            order.order,
             current_market,
-            it->queue_position,
+            order.queue_position,
             volatility,
             latency_us
         );
 
-        double random_draw = static_cast<double>(std::rand()) / RAND_MAX;
+        // Top 53 bits -> [0, 1)
+        double random_draw = static_cast<double>(fill_rng_() >> 11) * (1.0 / 9007199254740992.0);
 
         if (random_draw < fill_prob) {
+            record_fill(order, order.order.quantity, resolve_time_ns, current_market, config_.enable_slippage);
+        } else if (replay_logger_) {
+            replay_logger_->log_order_cancel(
+                resolve_time_ns,
+                order.order.order_id,
+                "not_filled"
+            );
+        }
+        finish_order(it);
+    }
 
-            it->is_filled = true;
-            it->fill_time_ns = current_time_ns_;
-            it->fill_price = it->order.price;
-            it->filled_quantity = it->order.quantity;
-
-            if (config_.enable_slippage) {
-                double order_size_frac = static_cast<double>(it->order.quantity) /
-                                        (current_market.bid_size + current_market.ask_size);
-                double slippage = fill_model_.calculate_slippage(
-                    it->order, current_market, order_size_frac
-                );
-
-                if (it->order.side == Side::BUY) {
-                    it->fill_price += slippage;
-                } else {
-                    it->fill_price -= slippage;
-                }
-            }
+    // QUEUE_POSITION arrival: take liquidity if marketable against the book
+    // the simulator last saw, otherwise rest behind the displayed size
+    void join_queue(SimulatedOrder& order, int64_t now_ns) {
+        auto it = active_orders_.find(order.order.order_id);
+        QueueFillSimulator& queue = asset_state(order.order.asset_id).queue;
+        const MarketTick book = queue.has_market() ? queue.last_market()
+                                                   : get_current_market_state(order.order.asset_id, now_ns);
+        const bool marketable = (order.order.side == Side::BUY)
+            ? (book.ask_price > 0.0 && order.order.price >= book.ask_price)
+            : (book.bid_price > 0.0 && order.order.price <= book.bid_price);
+
+        if (marketable) {
+            record_fill(order, order.order.quantity, now_ns, book, config_.enable_slippage);
+            finish_order(it);
+            return;
+        }
 
-            if (it->order.side == Side::BUY) {
-                current_position_ += it->filled_quantity;
-            } else {
-                current_position_ -= it->filled_quantity;
+        if (!queue.add_order(order.order.order_id, order.order.side, order.order.price,
+                                   order.order.quantity, now_ns)) {
+            if (replay_logger_) {
+                replay_logger_->log_order_cancel(now_ns, order.order.order_id, "outside_book_window");
             }
+            finish_order(it);
+            return;
+        }
+        order.queue_position = static_cast<int>(queue.queue_ahead(order.order.order_id));
 
-            double commission = config_.commission_per_share * it->filled_quantity;
-            current_capital_ -= commission;
+        const int64_t expiry_ns = now_ns + std::max<int64_t>(0, config_.order_lifetime_ns);
+        order_events_.emplace(static_cast<uint64_t>(expiry_ns), OrderEvent{order.order.order_id, OrderEvent::EXPIRY});
+    }
 
-            int64_t total_latency = current_time_ns_ - it->submit_time_ns;
-            order_to_ack_latency_.add_sample(time_since_submit);
-            total_rtt_latency_.add_sample(total_latency);
+    // Replay one market event through the queue simulator
+    void apply_market_to_queues(AssetState& asset, const HistoricalEvent& event, const MarketTick& tick) {
+        asset.queue.on_market(tick, event.trade_price, event.timestamp_ns,
+            [this, &tick](const QueueFillSimulator::Fill& fill) {
+                auto it = active_orders_.find(fill.order_id);
+                if (it == active_orders_.end()) {
+                    return;
+                }
+                record_fill(it->second, fill.quantity, current_time_ns_, tick, false);
+                if (fill.remaining == 0) {
+                    finish_order(it);
+                }
+            });
+    }
 
-            if (replay_logger_) {
-                replay_logger_->log_order_fill(
-                    current_time_ns_,
-                    it->order.order_id,
-                    it->fill_price,
-                    it->filled_quantity,
-                    total_latency
-                );
-            }
+    // Resting order reached its lifetime: pull what is left
+    void expire_order(uint64_t order_id, int64_t now_ns) {
+        auto it = active_orders_.find(order_id);
+        if (it == active_orders_.end()) {
+            return;
+        }
+        asset_state(it->second.order.asset_id).queue.cancel_order(order_id);
+        if (replay_logger_) {
+            replay_logger_->log_order_cancel(now_ns, order_id, "expired");
+        }
+        finish_order(it);
+    }
 
-            auto decision_mid_it = order_decision_mid_prices_.find(it->order.order_id);
-            if (decision_mid_it != order_decision_mid_prices_.end()) {
-                double decision_mid = decision_mid_it->second;
-                double fill_time_mid = current_market.mid_price;
-                std::string side_str = (it->order.side == Side::BUY) ? "BUY" : "SELL";
+    // Book one execution of `quantity` at the order's price. Each execution
+    // is its own entry in filled_orders_.
+    void record_fill(SimulatedOrder& order, uint64_t quantity, int64_t fill_time_ns,
+                     const MarketTick& current_market, bool with_slippage) {
+        SimulatedOrder fill = order;
+        fill.is_filled = true;
+        fill.fill_time_ns = fill_time_ns;
+        fill.fill_price = order.order.price;
+        fill.filled_quantity = quantity;
+
+        if (with_slippage) {
+            double order_size_frac = static_cast<double>(quantity) /
+                                    (current_market.bid_size + current_market.ask_size);
+            double slippage = fill_model_.calculate_slippage(
+                order.order, current_market, order_size_frac
+            );
 
-                slippage_analyzer_.add_fill(
-                    current_time_ns_,
-                    it->fill_price,
-                    decision_mid,
-                    fill_time_mid,
-                    it->filled_quantity,
-                    side_str
-                );
+            if (order.order.side == Side::BUY) {
+                fill.fill_price += slippage;
+            } else {
+                fill.fill_price -= slippage;
             }
+        }
 
-            filled_orders_.push_back(*it);
-            it = active_orders_.erase(it);
+        if (order.order.side == Side::BUY) {
+            current_position_ += quantity;
         } else {
+            current_position_ -= quantity;
+        }
 
-            if (replay_logger_) {
-                replay_logger_->log_order_cancel(
-                    current_time_ns_,
-                    it->order.order_id,
-                    "not_filled"
-                );
-            }
+        double commission = config_.commission_per_share * quantity;
+        current_capital_ -= commission;
+        AssetState& asset = asset_state(order.order.asset_id);
+        realized_pnl_ += asset.ledger.on_fill(order.order.side, quantity, fill.fill_price, commission) - commission;
+        revalue(asset, asset.last_tick.mid_price);
+        ++fill_count_;
 
-            it = active_orders_.erase(it);
+        if (order.filled_quantity == 0) {
+            ++orders_with_fills_;
         }
-            } else {
-                ++it;
-            }
+        order.filled_quantity += quantity;
+        order.is_filled = (order.filled_quantity >= order.order.quantity);
+
+        int64_t total_latency = fill_time_ns - order.submit_time_ns;
+        total_rtt_latency_.add_sample(total_latency);
+
+        if (replay_logger_) {
+            replay_logger_->log_order_fill(
+                fill_time_ns,
+                order.order.order_id,
+                fill.fill_price,
+                quantity,
+                total_latency
+            );
+        }
+
+        auto decision_mid_it = order_decision_mid_prices_.find(order.order.order_id);
+        if (decision_mid_it != order_decision_mid_prices_.end()) {
+            double decision_mid = decision_mid_it->second;
+            double fill_time_mid = current_market.mid_price;
+            std::string side_str = (order.order.side == Side::BUY) ? "BUY" : "SELL";
+
+            slippage_analyzer_.add_fill(
+                fill_time_ns,
+                fill.fill_price,
+                decision_mid,
+                fill_time_mid,
+                quantity,
+                side_str
+            );
+        }
+
+        if (config_.record_fills) {
+            filled_orders_.push_back(fill);
         }
     }
 
+    void finish_order(ActiveOrderMap::iterator it) {
+        order_decision_mid_prices_.erase(it->first);
+        active_orders_.erase(it);
+    }
+
     int estimate_queue_position(const Order& order, const MarketTick& tick) const {
 
         if (order.side == Side::BUY) {
@@ -896,138 +1480,119 @@ private:
         }
     }
 
-    MarketTick get_current_market_state() const {
+    // Merged sources are forward-only: the asset's latest book. A single
+    // loaded file is searched by time as before.
+    MarketTick get_current_market_state(uint32_t asset_id, int64_t at_ns) const {
+        if (!replay_.empty()) {
+            return asset_state(asset_id).last_tick;
+        }
 
-        auto it = std::lower_bound(historical_events_.begin(),
-                                   historical_events_.end(),
-                                   current_time_ns_,
+        if (tick_store_) {
+            const size_t pos = std::min(tick_store_->lower_bound(at_ns),
+                                        tick_store_->size() - 1);
+            HistoricalEvent event;
+            tick_store_->read(pos, event);
+            return event.to_market_tick();
+        }
+
+        const auto& events = *historical_events_;
+        auto it = std::lower_bound(events.begin(),
+                                   events.end(),
+                                   at_ns,
             [](const HistoricalEvent& e, int64_t t) {
                 return e.timestamp_ns < t;
             });
 
-        if (it == historical_events_.end()) {
-            return historical_events_.back().to_market_tick();
+        if (it == events.end()) {
+            return events.back().to_market_tick();
         }
         return it->to_market_tick();
     }
 
+    // Over the most recent RECENT_PNL_WINDOW records
     double estimate_current_volatility() const {
 
-        if (pnl_history_.size() < 10) return 0.20;
-
-        std::vector<double> returns;
-        for (size_t pos = 1; pos < std::min(pnl_history_.size(), size_t(100)); ++pos) {
-            double ret = (pnl_history_[pos] - pnl_history_[pos-1]) /
-                        std::abs(pnl_history_[pos-1] + 1e-10);
-            returns.push_back(ret);
+        if (recent_pnl_count_ < 10) return 0.20;
+
+        const size_t n = std::min(recent_pnl_count_, RECENT_PNL_WINDOW);
+        const size_t first = recent_pnl_count_ - n;
+        double mean = 0.0;
+        double m2 = 0.0;
+        for (size_t pos = 1; pos < n; ++pos) {
+            const double prev = recent_pnl_[(first + pos - 1) % RECENT_PNL_WINDOW];
+            const double cur = recent_pnl_[(first + pos) % RECENT_PNL_WINDOW];
+            const double ret = (cur - prev) / std::abs(prev + 1e-10);
+            const double delta = ret - mean;
+            mean += delta / pos;
+            m2 += delta * (ret - mean);
         }
-
-        double mean = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
-        double sq_sum = 0.0;
-        for (double r : returns) {
-            sq_sum += (r - mean) * (r - mean);
-        }
-        double variance = sq_sum / returns.size();
+        double variance = m2 / (n - 1);
 
         return std::sqrt(variance * 252.0 * 6.5 * 3600.0);
     }
 
-    void update_pnl(const MarketTick& current_tick) {
-
-        unrealized_pnl_ = current_position_ * current_tick.mid_price;
+    // Average-cost ledgers: O(1) per tick regardless of how many fills or
+    // assets so far. Realized P&L is booked in record_fill().
+    void update_pnl(AssetState& asset, const MarketTick& current_tick) {
+        revalue(asset, current_tick.mid_price);
+    }
 
-        double new_realized = 0.0;
-        for (const auto& filled : filled_orders_) {
-            double pnl = 0.0;
-            if (filled.order.side == Side::BUY) {
-                pnl = (current_tick.mid_price - filled.fill_price) * filled.filled_quantity;
-            } else {
-                pnl = (filled.fill_price - current_tick.mid_price) * filled.filled_quantity;
-            }
-            new_realized += pnl;
-        }
-        realized_pnl_ = new_realized;
+    void revalue(AssetState& asset, double mark) {
+        const double unrealized = asset.ledger.unrealized(mark);
+        unrealized_pnl_ += unrealized - asset.unrealized_pnl;
+        asset.unrealized_pnl = unrealized;
     }
 
     void record_state(const MarketTick& current_tick) {
-        pnl_history_.push_back(realized_pnl_ + unrealized_pnl_);
-        timestamp_history_.push_back(current_time_ns_);
+        const double pnl = realized_pnl_ + unrealized_pnl_;
+        recent_pnl_[recent_pnl_count_++ % RECENT_PNL_WINDOW] = pnl;
 
         double spread_bps = ((current_tick.ask_price - current_tick.bid_price) /
                             current_tick.mid_price) * 10000.0;
-        quoted_spreads_.push_back(spread_bps);
+        performance_.add(current_time_ns_, pnl, spread_bps);
     }
 
     PerformanceMetrics calculate_metrics() {
         PerformanceMetrics metrics;
+        const StreamingPerformance& perf = performance_;
 
-        if (pnl_history_.empty()) return metrics;
-
-        metrics.total_pnl = pnl_history_.back();
-
-        std::vector<double> returns;
-        for (size_t pos = 1; pos < pnl_history_.size(); ++pos) {
-            double ret = pnl_history_[pos] - pnl_history_[pos-1];
-            returns.push_back(ret);
-        }
+        if (perf.samples() == 0) return metrics;
 
-        double mean_return = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
+        metrics.total_pnl = perf.last_pnl();
 
-        double sq_sum = 0.0;
-        for (double r : returns) {
-            sq_sum += (r - mean_return) * (r - mean_return);
-        }
-        metrics.volatility = std::sqrt(sq_sum / returns.size());
+        const double mean_return = perf.mean_return();
+        metrics.volatility = perf.volatility();
 
         metrics.sharpe_ratio = (metrics.volatility > 1e-10) ?
             (mean_return / metrics.volatility) * std::sqrt(252.0 * 6.5 * 3600.0) : 0.0;
 
-        double downside_sq_sum = 0.0;
-        int downside_count = 0;
-        for (double r : returns) {
-            if (r < 0.0) {
-                downside_sq_sum += r * r;
-                ++downside_count;
-            }
-        }
-        metrics.downside_deviation = (downside_count > 0) ?
-            std::sqrt(downside_sq_sum / downside_count) : 0.0;
+        metrics.downside_deviation = perf.downside_deviation();
 
         metrics.sortino_ratio = (metrics.downside_deviation > 1e-10) ?
             (mean_return / metrics.downside_deviation) * std::sqrt(252.0 * 6.5 * 3600.0) : 0.0;
 
-        double peak = pnl_history_[0];
-        double max_dd = 0.0;
-        for (double pnl : pnl_history_) {
-            peak = std::max(peak, pnl);
-            double dd = (peak - pnl) / (std::abs(peak) + 1e-10);
-            max_dd = std::max(max_dd, dd);
-        }
+        // Fraction of peak equity (initial capital + P&L)
+        const double max_dd = perf.max_drawdown();
         metrics.max_drawdown = max_dd;
 
         metrics.calmar_ratio = (max_dd > 1e-10) ?
             (metrics.total_pnl / config_.initial_capital) / max_dd : 0.0;
 
-        metrics.total_trades = filled_orders_.size();
+        // Every execution is a trade; closing executions decide wins/losses
         double gross_profit = 0.0;
         double gross_loss = 0.0;
-
-        for (const auto& trade : filled_orders_) {
-            double trade_pnl = (trade.order.side == Side::BUY) ?
-                (pnl_history_.back() - trade.fill_price * trade.filled_quantity) :
-                (trade.fill_price * trade.filled_quantity - pnl_history_.back());
-
-            if (trade_pnl > 0) {
-                ++metrics.winning_trades;
-                gross_profit += trade_pnl;
-            } else {
-                ++metrics.losing_trades;
-                gross_loss += std::abs(trade_pnl);
-            }
+        uint64_t closing_fills = 0;
+        for (const AssetState& asset : assets_) {
+            metrics.total_trades += asset.ledger.fills();
+            metrics.winning_trades += asset.ledger.winning_fills();
+            metrics.losing_trades += asset.ledger.losing_fills();
+            closing_fills += asset.ledger.closing_fills();
+            gross_profit += asset.ledger.gross_profit();
+            gross_loss += asset.ledger.gross_loss();
         }
 
-        metrics.win_rate = (metrics.total_trades > 0) ?
-            static_cast<double>(metrics.winning_trades) / metrics.total_trades : 0.0;
+        metrics.win_rate = (closing_fills > 0) ?
+            static_cast<double>(metrics.winning_trades) / closing_fills : 0.0;
 
         metrics.profit_factor = (gross_loss > 1e-10) ? gross_profit / gross_loss : 0.0;
 
@@ -1041,10 +1606,9 @@ private:
             metrics.total_pnl / metrics.total_trades : 0.0;
 
         metrics.fill_rate = (order_id_counter_ > 1) ?
-            static_cast<double>(filled_orders_.size()) / (order_id_counter_ - 1) : 0.0;
+            static_cast<double>(orders_with_fills_) / (order_id_counter_ - 1) : 0.0;
 
-        metrics.quoted_spread_bps = std::accumulate(
-            quoted_spreads_.begin(), quoted_spreads_.end(), 0.0) / quoted_spreads_.size();
+        metrics.quoted_spread_bps = perf.mean_spread_bps();
 
         metrics.realized_spread_bps = metrics.quoted_spread_bps * 0.6;
         metrics.effective_spread_bps = metrics.realized_spread_bps * 0.8;
@@ -1052,71 +1616,34 @@ private:
         metrics.adverse_selection_ratio = (metrics.quoted_spread_bps > 1e-10) ?
             metrics.effective_spread_bps / metrics.quoted_spread_bps : 0.0;
 
-        std::vector<double> sorted_returns = returns;
-        std::sort(sorted_returns.begin(), sorted_returns.end());
-        size_t var_idx = sorted_returns.size() * 0.05;
-        metrics.value_at_risk_95 = -sorted_returns[var_idx];
-
-        double cvar_sum = 0.0;
-        for (size_t pos = 0; pos < var_idx; ++pos) {
-            cvar_sum += sorted_returns[pos];
-        }
-        metrics.conditional_var_95 = (var_idx > 0) ? -cvar_sum / var_idx : 0.0;
+        perf.tail_risk(metrics.value_at_risk_95, metrics.conditional_var_95);
 
-        metrics.equity_curve = pnl_history_;
-        metrics.timestamps = timestamp_history_;
+        metrics.equity_curve = perf.equity_curve();
+        metrics.drawdown_curve = perf.drawdown_curve();
+        metrics.timestamps = perf.timestamps();
 
         return metrics;
     }
 
-    bool parse_csv_line(const std::string& line, HistoricalEvent& event) {
-        std::stringstream ss(line);
-        std::string cell;
-
-        try {
-
-            std::getline(ss, cell, ',');
-
-            if (cell.find("ts_us") != std::string::npos) {
-                return false;
-            }
-
-            int64_t ts_us = std::stoll(cell);
-            event.timestamp_ns = ts_us * 1000;
-
-            std::getline(ss, cell, ',');
-            std::string event_type_str = cell;
-
-            std::getline(ss, cell, ',');
-            char side_char = (!cell.empty()) ? cell[0] : 'B';
-
-            std::getline(ss, cell, ',');
-            double price = (!cell.empty()) ? std::stod(cell) : 100.0;
-
-            std::getline(ss, cell, ',');
-            uint64_t size = (!cell.empty()) ? std::stoull(cell) : 100;
-
-            double spread = price * 0.0002;
-            event.bid_price = price - spread / 2.0;
-            event.ask_price = price + spread / 2.0;
-            event.bid_size = size;
-            event.ask_size = size;
-
-            event.asset_id = 1;
-            event.event_type = 0;
-            event.trade_side = (side_char == 'S') ? Side::SELL : Side::BUY;
-            event.depth_levels = 1;
-
-            if (event_type_str == "trade") {
-                event.trade_volume = size;
-            } else {
-                event.trade_volume = 0;
-            }
-
-            return true;
-        } catch (...) {
-            return false;
+    // Event pos from whichever source is loaded (scratch is used for the store)
+    const HistoricalEvent& next_event(size_t pos, HistoricalEvent& scratch) const {
+        if (tick_store_) {
+            tick_store_->read(pos, scratch);
+            return scratch;
         }
+        return (*historical_events_)[pos];
+    }
+
+    static bool parse_csv_line(const std::string& line, HistoricalEvent& event) {
+        bool parsed = false;
+        csv::parse_range<HistoricalEvent>(line.data(), line.data() + line.size(),
+            [&](const HistoricalEvent& e) {
+                if (!parsed) {
+                    event = e;
+                    parsed = true;
+                }
+            });
+        return parsed;
     }
 
     void print_latency_sensitivity_results(
@@ -1162,12 +1689,13 @@ private:
     Config config_;
     FillProbabilityModel fill_model_;
 
-    std::unique_ptr<HawkesEngine> hawkes_engine_;
-    std::unique_ptr<FPGA_DNN_Inference> fpga_inference_;
-    std::unique_ptr<DynamicMMStrategy> mm_strategy_;
-    std::unique_ptr<RiskControl> risk_control_;
+    std::unique_ptr<FPGA_DNN_Inference> fpga_inference_;    // Weights from random_seed; each asset runs a copy
 
-    std::vector<HistoricalEvent> historical_events_;
+    // Shared read-only across engines (see share_historical_data)
+    std::shared_ptr<const std::vector<HistoricalEvent>> historical_events_;
+    std::shared_ptr<const TickStoreReader> tick_store_;
+    MergedReplay<HistoricalEvent> replay_;
+    std::mt19937_64 fill_rng_;
 
     int64_t current_time_ns_;
     int64_t current_position_;
@@ -1176,13 +1704,43 @@ private:
     double unrealized_pnl_;
     uint64_t order_id_counter_;
 
-    std::vector<SimulatedOrder> active_orders_;
-    std::vector<SimulatedOrder> filled_orders_;
+    ActiveOrderMap active_orders_;                  // In flight, by order_id
+    // Venue arrivals and expiries, keyed by replay time (ns)
+    struct OrderEvent {
+        enum Kind : uint8_t { ARRIVAL, EXPIRY };
+        uint64_t order_id = 0;
+        Kind kind = ARRIVAL;
+    };
+    static constexpr size_t MAX_IN_FLIGHT_ORDERS = 16384;
+    static constexpr uint32_t CHECKPOINT_VERSION = 2;
 
-    std::vector<double> pnl_history_;
-    std::vector<int64_t> timestamp_history_;
-    std::vector<double> quoted_spreads_;
+    // Checkpoint records
+    struct SavedOrderEvent {
+        uint64_t priority;
+        OrderEvent event;
+    };
+
+    struct SavedDecisionMid {
+        uint64_t order_id;
+        double mid_price;
+    };
 
+    using OrderEventQueue = scheduler::PriorityEventQueue<OrderEvent, MAX_IN_FLIGHT_ORDERS>;
+    OrderEventQueue order_events_;
+    uint64_t orders_with_fills_ = 0;
+    uint64_t fill_count_ = 0;
+    uint64_t signal_count_ = 0;
+    uint64_t replay_sequence_ = 0;                  // Events replayed so far
+    HotVector<SimulatedOrder> filled_orders_;       // Only with config_.record_fills
+
+    std::deque<AssetState> assets_;
+    std::vector<uint32_t> asset_slots_;             // asset_id -> assets_ index
+    StreamingPerformance performance_;
+    static constexpr size_t RECENT_PNL_WINDOW = 100;
+    std::array<double, RECENT_PNL_WINDOW> recent_pnl_{};
+    size_t recent_pnl_count_ = 0;
+
+    std::unique_ptr<BinaryJournal> journal_;         // Outlives replay_logger_
     std::unique_ptr<InstitutionalLogging::EventReplayLogger> replay_logger_;
     std::unique_ptr<InstitutionalLogging::RiskBreachLogger> risk_logger_;
     InstitutionalLogging::LatencyDistribution tick_to_decision_latency_;
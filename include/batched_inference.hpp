@@ -0,0 +1,217 @@
+#pragma once
+
+#include "fast_math.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Batched MLP Inference
+ *
+ * Throughput path for the two-layer networks in VectorizedInferenceEngine
+ * and FPGA_DNN_Inference: many feature rows per call instead of one.
+ *
+ * Rows are processed TILE at a time as a small GEMM. Each tile is packed
+ * transposed (feature-major, rows contiguous), so the inner loop
+ * broadcasts one weight and updates TILE row accumulators with
+ * unit-stride loads; fixed trip counts let the compiler keep the tile in
+ * vector registers (two AVX-512 / four AVX2 float registers per row of
+ * accumulators).
+ *
+ * Precision:
+ * - FP32: weights and activations in float
+ * - INT8: weights quantized per output neuron, activations per row
+ *         (symmetric, scale = max|x| / 127), int32 accumulation
+ */
+
+namespace hft {
+
+enum class InferencePrecision : uint8_t {
+    FP32,
+    INT8
+};
+
+enum class InferenceActivation : uint8_t {
+    RELU,
+    TANH      // fast_math::tanh, as in VectorizedInferenceEngine
+};
+
+template<size_t In, size_t Hidden, size_t Out>
+class BatchedMLP {
+public:
+    static constexpr size_t TILE = 16;
+
+    BatchedMLP() = default;
+
+    BatchedMLP(const double* w1, const double* b1, const double* w2, const double* b2,
+               InferenceActivation activation) {
+        load(w1, b1, w2, b2, activation);
+    }
+
+    /**
+     * Weights row-major by output neuron (w1[j * In + i], w2[k * Hidden + j])
+     */
+    void load(const double* w1, const double* b1, const double* w2, const double* b2,
+              InferenceActivation activation) {
+        activation_ = activation;
+        for (size_t i = 0; i < Hidden * In; ++i) w1_[i] = static_cast<float>(w1[i]);
+        for (size_t i = 0; i < Out * Hidden; ++i) w2_[i] = static_cast<float>(w2[i]);
+        for (size_t j = 0; j < Hidden; ++j) b1_[j] = static_cast<float>(b1[j]);
+        for (size_t k = 0; k < Out; ++k) b2_[k] = static_cast<float>(b2[k]);
+
+        quantize_rows<Hidden, In>(w1, q1_, s1_);
+        quantize_rows<Out, Hidden>(w2, q2_, s2_);
+    }
+
+    /**
+     * Softmax outputs for `count` contiguous rows of In features;
+     * `out` receives count * Out probabilities
+     */
+    void forward(const double* rows, size_t count, double* out,
+                 InferencePrecision precision = InferencePrecision::FP32) const {
+        for (size_t base = 0; base < count; base += TILE) {
+            const size_t n = std::min(TILE, count - base);
+            alignas(64) float logits[Out][TILE];
+
+            if (precision == InferencePrecision::INT8) {
+                forward_int8(rows + base * In, n, logits);
+            } else {
+                forward_fp32(rows + base * In, n, logits);
+            }
+            softmax(logits, n, out + base * Out);
+        }
+    }
+
+private:
+    template<size_t Rows, size_t Cols>
+    static void quantize_rows(const double* w, std::array<int8_t, Rows * Cols>& q, std::array<float, Rows>& scale) {
+        for (size_t r = 0; r < Rows; ++r) {
+            double max_abs = 0.0;
+            for (size_t c = 0; c < Cols; ++c) max_abs = std::max(max_abs, std::abs(w[r * Cols + c]));
+            const double s = max_abs > 0.0 ? max_abs / 127.0 : 1.0;
+            for (size_t c = 0; c < Cols; ++c) {
+                q[r * Cols + c] = static_cast<int8_t>(std::lround(w[r * Cols + c] / s));
+            }
+            scale[r] = static_cast<float>(s);
+        }
+    }
+
+    // Per-row symmetric quantization of a transposed [Cols][TILE] tile
+    template<size_t Cols>
+    static void quantize_tile(const float (&x)[Cols][TILE], int8_t (&q)[Cols][TILE], float (&scale)[TILE]) {
+        float max_abs[TILE] = {};
+        for (size_t c = 0; c < Cols; ++c) {
+            for (size_t r = 0; r < TILE; ++r) max_abs[r] = std::max(max_abs[r], std::abs(x[c][r]));
+        }
+        float inv[TILE];
+        for (size_t r = 0; r < TILE; ++r) {
+            scale[r] = max_abs[r] > 0.0f ? max_abs[r] / 127.0f : 1.0f;
+            inv[r] = 1.0f / scale[r];
+        }
+        for (size_t c = 0; c < Cols; ++c) {
+            for (size_t r = 0; r < TILE; ++r) q[c][r] = static_cast<int8_t>(std::lrint(x[c][r] * inv[r]));
+        }
+    }
+
+    static void pack(const double* rows, size_t n, float (&x)[In][TILE]) {
+        for (size_t c = 0; c < In; ++c) {
+            for (size_t r = 0; r < TILE; ++r) {
+                x[c][r] = r < n ? static_cast<float>(rows[r * In + c]) : 0.0f;
+            }
+        }
+    }
+
+    float activate(float v) const {
+        if (activation_ == InferenceActivation::RELU) return v > 0.0f ? v : 0.0f;
+        return static_cast<float>(fast_math::tanh(v));
+    }
+
+    void forward_fp32(const double* rows, size_t n, float (&logits)[Out][TILE]) const {
+        alignas(64) float x[In][TILE];
+        alignas(64) float h[Hidden][TILE];
+        pack(rows, n, x);
+
+        for (size_t j = 0; j < Hidden; ++j) {
+            alignas(64) float acc[TILE];
+            for (size_t r = 0; r < TILE; ++r) acc[r] = b1_[j];
+            for (size_t c = 0; c < In; ++c) {
+                const float w = w1_[j * In + c];
+                for (size_t r = 0; r < TILE; ++r) acc[r] += w * x[c][r];
+            }
+            for (size_t r = 0; r < TILE; ++r) h[j][r] = activate(acc[r]);
+        }
+
+        for (size_t k = 0; k < Out; ++k) {
+            for (size_t r = 0; r < TILE; ++r) logits[k][r] = b2_[k];
+            for (size_t j = 0; j < Hidden; ++j) {
+                const float w = w2_[k * Hidden + j];
+                for (size_t r = 0; r < TILE; ++r) logits[k][r] += w * h[j][r];
+            }
+        }
+    }
+
+    void forward_int8(const double* rows, size_t n, float (&logits)[Out][TILE]) const {
+        alignas(64) float x[In][TILE];
+        alignas(64) int8_t xq[In][TILE];
+        alignas(64) float h[Hidden][TILE];
+        alignas(64) int8_t hq[Hidden][TILE];
+        float xs[TILE], hs[TILE];
+        pack(rows, n, x);
+        quantize_tile<In>(x, xq, xs);
+
+        for (size_t j = 0; j < Hidden; ++j) {
+            alignas(64) int32_t acc[TILE] = {};
+            for (size_t c = 0; c < In; ++c) {
+                const int32_t w = q1_[j * In + c];
+                for (size_t r = 0; r < TILE; ++r) acc[r] += w * xq[c][r];
+            }
+            for (size_t r = 0; r < TILE; ++r) {
+                h[j][r] = activate(static_cast<float>(acc[r]) * s1_[j] * xs[r] + b1_[j]);
+            }
+        }
+        quantize_tile<Hidden>(h, hq, hs);
+
+        for (size_t k = 0; k < Out; ++k) {
+            alignas(64) int32_t acc[TILE] = {};
+            for (size_t j = 0; j < Hidden; ++j) {
+                const int32_t w = q2_[k * Hidden + j];
+                for (size_t r = 0; r < TILE; ++r) acc[r] += w * hq[j][r];
+            }
+            for (size_t r = 0; r < TILE; ++r) {
+                logits[k][r] = static_cast<float>(acc[r]) * s2_[k] * hs[r] + b2_[k];
+            }
+        }
+    }
+
+    static void softmax(const float (&logits)[Out][TILE], size_t n, double* out) {
+        for (size_t r = 0; r < n; ++r) {
+            float max_val = logits[0][r];
+            for (size_t k = 1; k < Out; ++k) max_val = std::max(max_val, logits[k][r]);
+            float e[Out];
+            float sum = 0.0f;
+            for (size_t k = 0; k < Out; ++k) {
+                e[k] = std::exp(logits[k][r] - max_val);
+                sum += e[k];
+            }
+            const float inv = 1.0f / sum;
+            for (size_t k = 0; k < Out; ++k) out[r * Out + k] = e[k] * inv;
+        }
+    }
+
+    InferenceActivation activation_ = InferenceActivation::RELU;
+
+    alignas(64) std::array<float, Hidden * In> w1_{};
+    alignas(64) std::array<float, Out * Hidden> w2_{};
+    std::array<float, Hidden> b1_{};
+    std::array<float, Out> b2_{};
+
+    alignas(64) std::array<int8_t, Hidden * In> q1_{};
+    alignas(64) std::array<int8_t, Out * Hidden> q2_{};
+    std::array<float, Hidden> s1_{};
+    std::array<float, Out> s2_{};
+};
+
+}
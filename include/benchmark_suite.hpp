@@ -1,6 +1,8 @@
 #pragma once
 
 #include "common_types.hpp"
+#include "latency_histogram.hpp"
+#include <array>
 #include <vector>
 #include <algorithm>
 #include <numeric>
@@ -9,6 +11,7 @@
 #include <iomanip>
 #include <fstream>
 #include <chrono>
+#include <thread>
 #include <x86intrin.h>  // For __rdtsc()
 
 namespace hft {
@@ -66,8 +69,10 @@ inline double calibrate_tsc_to_ns() {
     return static_cast<double>(ns_diff) / tsc_diff;
 }
 
-// Global TSC calibration (initialize once)
-static const double g_tsc_to_ns = calibrate_tsc_to_ns();
+// Global TSC calibration: the clock service's rate when it has one
+static const double g_tsc_to_ns = tsc::ClockService::instance().ns_per_cycle() > 0.0
+                                      ? tsc::ClockService::instance().ns_per_cycle()
+                                      : calibrate_tsc_to_ns();
 
 /**
  * Convert TSC cycles to nanoseconds
@@ -160,6 +165,31 @@ struct LatencyStats {
         
         return stats;
     }
+
+    /**
+     * Statistics from a streaming histogram (percentiles within its precision)
+     *
+     * @param ns_per_unit Scale of the recorded values, e.g. g_tsc_to_ns for cycles
+     */
+    static LatencyStats from_histogram(const LatencyHistogram& histogram, double ns_per_unit = 1.0) {
+        if (histogram.empty()) {
+            return {};
+        }
+
+        LatencyStats stats;
+        stats.sample_count = histogram.count();
+        stats.min_ns = histogram.min() * ns_per_unit;
+        stats.max_ns = histogram.max() * ns_per_unit;
+        stats.jitter_ns = stats.max_ns - stats.min_ns;
+        stats.mean_ns = histogram.mean() * ns_per_unit;
+        stats.median_ns = histogram.value_at_percentile(50.0) * ns_per_unit;
+        stats.p90_ns = histogram.value_at_percentile(90.0) * ns_per_unit;
+        stats.p99_ns = histogram.value_at_percentile(99.0) * ns_per_unit;
+        stats.p999_ns = histogram.value_at_percentile(99.9) * ns_per_unit;
+        stats.p9999_ns = histogram.value_at_percentile(99.99) * ns_per_unit;
+        stats.stddev_ns = histogram.stddev() * ns_per_unit;
+        return stats;
+    }
     
     /**
      * Print statistics in industry-standard format
@@ -329,8 +359,7 @@ public:
         Func&& func,
         size_t iterations = 1000000
     ) {
-        std::vector<double> latencies_ns;
-        latencies_ns.reserve(iterations);
+        LatencyHistogram latency_cycles;
         
         std::cout << "Benchmarking " << component_name 
                   << " (" << iterations << " iterations)...\n";
@@ -346,10 +375,10 @@ public:
             func();
             const uint64_t t1 = rdtscp();
             
-            latencies_ns.push_back(tsc_to_ns(t1 - t0));
+            latency_cycles.record(static_cast<int64_t>(t1 - t0));
         }
         
-        auto stats = LatencyStats::calculate(latencies_ns);
+        auto stats = LatencyStats::from_histogram(latency_cycles, g_tsc_to_ns);
         stats.print(component_name);
         
         return stats;
@@ -419,8 +448,8 @@ public:
         std::cout << "Samples: " << num_samples << "\n";
         std::cout << "TSC Calibration: " << (1.0 / g_tsc_to_ns) << " GHz\n\n";
         
-        std::vector<Sample> samples;
-        samples.reserve(num_samples);
+        // Streaming histograms (cycles): memory stays fixed however many samples run
+        LatencyHistograms histograms;
         
         // Generate synthetic market data
         std::cout << "Generating " << num_samples << " synthetic ticks...\n";
@@ -461,7 +490,7 @@ public:
             sample.tsc_order_sent = sample.tsc_encode_done + 
                 static_cast<uint64_t>(40.0 / g_tsc_to_ns);
             
-            samples.push_back(sample);
+            histograms.record(sample);
             
             // Progress report
             if (i % progress_interval == 0) {
@@ -473,53 +502,48 @@ public:
         std::cout << "\rProgress: 100%   \n\n";
         
         // Calculate statistics
-        generate_report(samples, output_prefix);
+        generate_report(histograms, output_prefix);
     }
     
 private:
-    static void generate_report(const std::vector<Sample>& samples,
-                                const std::string& output_prefix) {
-        // Extract total latencies
-        std::vector<double> total_latencies;
-        total_latencies.reserve(samples.size());
-        for (const auto& s : samples) {
-            total_latencies.push_back(s.total_latency_ns());
+    static constexpr size_t COMPONENT_COUNT = 9;
+
+    struct LatencyHistograms {
+        LatencyHistogram total;
+        std::array<LatencyHistogram, COMPONENT_COUNT> components;
+
+        void record(const Sample& sample) {
+            const ComponentTiming ct = sample.breakdown();
+            const uint64_t cycles[COMPONENT_COUNT] = {
+                ct.rx_dma_to_app, ct.parse_packet, ct.lob_update,
+                ct.feature_extraction, ct.inference, ct.strategy,
+                ct.risk_checks, ct.order_encode, ct.tx_app_to_dma
+            };
+            total.record(static_cast<int64_t>(sample.tsc_order_sent - sample.tsc_feed_sent));
+            for (size_t c = 0; c < COMPONENT_COUNT; ++c) {
+                components[c].record(static_cast<int64_t>(cycles[c]));
+            }
         }
-        
+    };
+
+    static void generate_report(const LatencyHistograms& histograms,
+                                const std::string& output_prefix) {
         // Overall stats
-        auto total_stats = LatencyStats::calculate(total_latencies);
+        auto total_stats = LatencyStats::from_histogram(histograms.total, g_tsc_to_ns);
         total_stats.print("╔═══ TICK-TO-TRADE LATENCY ═══╗");
         
         // Component breakdown
         std::cout << "\n╔═══ COMPONENT BREAKDOWN ═══╗\n\n";
         
-        struct ComponentStats {
-            std::string name;
-            std::vector<double> latencies;
+        static const char* const component_names[COMPONENT_COUNT] = {
+            "RX DMA → App", "Parse Packet", "LOB Update",
+            "Feature Extract", "DNN Inference", "Strategy (A-S)",
+            "Risk Checks", "Order Encode", "TX App → DMA"
         };
-        
-        std::vector<ComponentStats> component_stats(9);
-        component_stats[0].name = "RX DMA → App";
-        component_stats[1].name = "Parse Packet";
-        component_stats[2].name = "LOB Update";
-        component_stats[3].name = "Feature Extract";
-        component_stats[4].name = "DNN Inference";
-        component_stats[5].name = "Strategy (A-S)";
-        component_stats[6].name = "Risk Checks";
-        component_stats[7].name = "Order Encode";
-        component_stats[8].name = "TX App → DMA";
-        
-        for (const auto& sample : samples) {
-            auto breakdown = sample.breakdown();
-            component_stats[0].latencies.push_back(tsc_to_ns(breakdown.rx_dma_to_app));
-            component_stats[1].latencies.push_back(tsc_to_ns(breakdown.parse_packet));
-            component_stats[2].latencies.push_back(tsc_to_ns(breakdown.lob_update));
-            component_stats[3].latencies.push_back(tsc_to_ns(breakdown.feature_extraction));
-            component_stats[4].latencies.push_back(tsc_to_ns(breakdown.inference));
-            component_stats[5].latencies.push_back(tsc_to_ns(breakdown.strategy));
-            component_stats[6].latencies.push_back(tsc_to_ns(breakdown.risk_checks));
-            component_stats[7].latencies.push_back(tsc_to_ns(breakdown.order_encode));
-            component_stats[8].latencies.push_back(tsc_to_ns(breakdown.tx_app_to_dma));
+
+        std::array<LatencyStats, COMPONENT_COUNT> component_stats;
+        for (size_t c = 0; c < COMPONENT_COUNT; ++c) {
+            component_stats[c] = LatencyStats::from_histogram(histograms.components[c], g_tsc_to_ns);
         }
         
         // Print component table
@@ -531,12 +555,12 @@ private:
                   << std::setw(12) << "% Total" << "\n";
         std::cout << "────────────────────────────────────────────────────────────────\n";
         
-        for (auto& cs : component_stats) {
-            auto stats = LatencyStats::calculate(cs.latencies);
+        for (size_t c = 0; c < COMPONENT_COUNT; ++c) {
+            const auto& stats = component_stats[c];
             double pct = (stats.mean_ns / total_stats.mean_ns) * 100.0;
             
             std::cout << std::fixed << std::setprecision(2)
-                      << std::setw(20) << std::left << cs.name
+                      << std::setw(20) << std::left << component_names[c]
                       << std::right
                       << std::setw(12) << stats.mean_ns
                       << std::setw(12) << stats.p99_ns
@@ -550,10 +574,10 @@ private:
         // Export component breakdown
         std::ofstream f(output_prefix + "_components.csv");
         f << "component,mean_ns,p99_ns,max_ns,percent\n";
-        for (auto& cs : component_stats) {
-            auto stats = LatencyStats::calculate(cs.latencies);
+        for (size_t c = 0; c < COMPONENT_COUNT; ++c) {
+            const auto& stats = component_stats[c];
             double pct = (stats.mean_ns / total_stats.mean_ns) * 100.0;
-            f << cs.name << "," << stats.mean_ns << "," << stats.p99_ns 
+            f << component_names[c] << "," << stats.mean_ns << "," << stats.p99_ns 
               << "," << stats.max_ns << "," << pct << "\n";
         }
         
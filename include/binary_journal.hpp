@@ -0,0 +1,365 @@
+#pragma once
+
+#include "lockfree_queue.hpp"
+#include "mapped_file.hpp"
+#include "spin_loop_engine.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace hft {
+
+// ====
+// Asynchronous Binary Journal
+// Log sinks write fixed-size binary records (timestamp, event id, raw
+// fields) into their own SPSC ring; a background thread drains every ring
+// into an mmapped journal file. Nothing is formatted on the logging
+// thread: JournalDecoder (journal_decoder.hpp) turns the journal back into
+// the sinks' text logs offline, with the same formatters the text mode
+// uses, so the output is byte-identical.
+//
+// File layout: one 64-byte header, then 64-byte records. Records of one
+// source appear in the order they were logged; sources interleave.
+// ====
+
+enum class JournalSourceKind : uint16_t {
+    EVENT_REPLAY = 1,
+    NIC_HARDWARE,
+    STRATEGY_TRACE,
+    EXCHANGE_ACK,
+    PTP_SYNC,
+    ORDER_GATEWAY
+};
+
+struct alignas(64) JournalRecord {
+    static constexpr size_t SLOTS = 6;
+    static constexpr uint16_t TEXT = 0xFFFF;          // verbatim text chunk (aux = length)
+    static constexpr uint16_t SOURCE_OPEN = 0xFFFE;   // aux = kind, slot 0 = name length; name follows as TEXT
+
+    int64_t timestamp = 0;
+    uint16_t source = 0;                              // set by JournalWriter (1-based)
+    uint16_t event = 0;                               // sink-defined, 0 = padding
+    uint32_t aux = 0;
+    unsigned char payload[SLOTS * 8] = {};
+
+    JournalRecord() = default;
+    JournalRecord(uint16_t ev, int64_t ts) : timestamp(ts), event(ev) {}
+
+    template<typename T>
+    void set(size_t slot, T value) {
+        static_assert(sizeof(T) <= 8 && std::is_trivially_copyable_v<T>, "8-byte slots");
+        std::memcpy(payload + slot * 8, &value, sizeof(T));
+    }
+
+    template<typename T>
+    T get(size_t slot) const {
+        T value{};
+        std::memcpy(&value, payload + slot * 8, sizeof(T));
+        return value;
+    }
+
+    // Short string in `slots` consecutive slots, truncated to slots * 8 chars
+    void set_text(size_t slot, size_t slots, std::string_view text) {
+        std::memcpy(payload + slot * 8, text.data(), std::min(text.size(), slots * 8));
+    }
+
+    std::string_view text(size_t slot, size_t slots) const {
+        const char* p = reinterpret_cast<const char*>(payload + slot * 8);
+        const size_t max = slots * 8;
+        size_t n = 0;
+        while (n < max && p[n] != '\0') ++n;
+        return {p, n};
+    }
+};
+static_assert(sizeof(JournalRecord) == 64, "JournalRecord is one cache line");
+
+namespace journal_format {
+
+constexpr char MAGIC[8] = {'H', 'F', 'T', 'J', 'R', 'N', 'L', '1'};
+constexpr uint32_t VERSION = 1;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t record_count;                            // 0 until closed; readers skip padding
+    unsigned char reserved[40];
+};
+static_assert(sizeof(FileHeader) == sizeof(JournalRecord), "Header occupies record slot 0");
+
+} // namespace journal_format
+
+class BinaryJournal;
+
+// One source's ring; single producer (the thread that owns the sink)
+class JournalWriter {
+public:
+    static constexpr size_t RING_CAPACITY = 1 << 14;
+
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    // Hot path: one 64-byte copy into the ring; yields if the drain fell a
+    // full ring behind (counted in stalls())
+    void write(JournalRecord record) {
+        record.source = id_;
+        while (!ring_.push(record)) {
+            stalls_.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::yield();
+        }
+    }
+
+    // Verbatim text (headers, rare events) as 48-byte TEXT chunks
+    void write_text(std::string_view text, int64_t timestamp = 0) {
+        constexpr size_t CHUNK = JournalRecord::SLOTS * 8;
+        for (size_t off = 0; off < text.size(); off += CHUNK) {
+            JournalRecord r(JournalRecord::TEXT, timestamp);
+            const size_t n = std::min(CHUNK, text.size() - off);
+            r.aux = static_cast<uint32_t>(n);
+            std::memcpy(r.payload, text.data() + off, n);
+            write(r);
+        }
+    }
+
+    uint16_t id() const { return id_; }
+    uint64_t stalls() const { return stalls_.load(std::memory_order_relaxed); }
+
+private:
+    friend class BinaryJournal;
+
+    explicit JournalWriter(uint16_t id) : id_(id) {}
+
+    const uint16_t id_;
+    LockFreeQueue<JournalRecord, RING_CAPACITY> ring_;
+    alignas(64) std::atomic<uint64_t> stalls_{0};
+};
+
+class BinaryJournal {
+public:
+    static constexpr size_t MAX_SOURCES = 64;
+
+    /**
+     * @param window_bytes File region mapped at a time; the file grows by
+     *                     one window whenever the current one fills
+     */
+    explicit BinaryJournal(const std::string& path, int cpu_core = -1, size_t window_bytes = 4 << 20)
+        : path_(path), cpu_core_(cpu_core) {
+        const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        window_bytes_ = std::max(page, (window_bytes + page - 1) / page * page);
+
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) {
+            throw std::runtime_error("Failed to create journal: " + path);
+        }
+        map_window(0);
+
+        journal_format::FileHeader header{};
+        std::memcpy(header.magic, journal_format::MAGIC, sizeof(header.magic));
+        header.version = journal_format::VERSION;
+        header.record_size = sizeof(JournalRecord);
+        std::memcpy(window_, &header, sizeof(header));
+        cursor_ = sizeof(header);
+
+        running_.store(true, std::memory_order_release);
+        worker_ = std::thread([this] { run(); });
+    }
+
+    ~BinaryJournal() { close(); }
+
+    BinaryJournal(const BinaryJournal&) = delete;
+    BinaryJournal& operator=(const BinaryJournal&) = delete;
+
+    // Startup: one writer per sink. The name is what the decoder writes.
+    JournalWriter& open_source(JournalSourceKind kind, const std::string& name) {
+        std::lock_guard<std::mutex> lock(sources_mutex_);
+        const size_t n = source_count_.load(std::memory_order_relaxed);
+        if (n == MAX_SOURCES) {
+            throw std::length_error("Journal source table full: " + path_);
+        }
+        sources_[n].reset(new JournalWriter(static_cast<uint16_t>(n + 1)));
+        JournalWriter& writer = *sources_[n];
+
+        JournalRecord open(JournalRecord::SOURCE_OPEN, 0);
+        open.aux = static_cast<uint32_t>(kind);
+        open.set(0, static_cast<uint64_t>(name.size()));
+        writer.write(open);
+        writer.write_text(name);
+
+        source_count_.store(n + 1, std::memory_order_release);
+        return writer;
+    }
+
+    // Blocks until everything logged so far is in the file
+    void flush() {
+        const uint64_t target = drain_passes_.load(std::memory_order_acquire) + 2;
+        while (running_.load(std::memory_order_acquire) &&
+               drain_passes_.load(std::memory_order_acquire) < target) {
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+    }
+
+    // Drains, trims the file to its records and writes the final header
+    void close() {
+        if (!running_.exchange(false, std::memory_order_acq_rel)) return;
+        if (worker_.joinable()) worker_.join();
+
+        const uint64_t records = (cursor_ - sizeof(journal_format::FileHeader)) / sizeof(JournalRecord);
+        ::munmap(window_, window_bytes_);
+        window_ = nullptr;
+        if (::ftruncate(fd_, static_cast<off_t>(cursor_)) == 0) {
+            const auto offset = static_cast<off_t>(offsetof(journal_format::FileHeader, record_count));
+            (void)::pwrite(fd_, &records, sizeof(records), offset);
+        }
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    const std::string& path() const { return path_; }
+    uint64_t records_written() const { return records_written_.load(std::memory_order_acquire); }
+
+private:
+    void map_window(size_t base) {
+        if (::ftruncate(fd_, static_cast<off_t>(base + window_bytes_)) != 0) {
+            throw std::runtime_error("Failed to grow journal: " + path_);
+        }
+        void* addr = ::mmap(nullptr, window_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, static_cast<off_t>(base));
+        if (addr == MAP_FAILED) {
+            throw std::runtime_error("Failed to map journal: " + path_);
+        }
+        window_ = static_cast<unsigned char*>(addr);
+        window_base_ = base;
+    }
+
+    void append(const JournalRecord& record) {
+        if (cursor_ == window_base_ + window_bytes_) {
+            ::munmap(window_, window_bytes_);
+            map_window(cursor_);
+        }
+        std::memcpy(window_ + (cursor_ - window_base_), &record, sizeof(record));
+        cursor_ += sizeof(record);
+    }
+
+    void run() {
+        if (cpu_core_ >= 0) spin_loop::pin_to_cpu(cpu_core_);
+
+        for (;;) {
+            const bool stopping = !running_.load(std::memory_order_acquire);
+            size_t drained = 0;
+            const size_t n = source_count_.load(std::memory_order_acquire);
+            for (size_t i = 0; i < n; ++i) {
+                drained += sources_[i]->ring_.consume_all([this](const JournalRecord& r) { append(r); });
+            }
+            if (drained > 0) records_written_.fetch_add(drained, std::memory_order_acq_rel);
+            drain_passes_.fetch_add(1, std::memory_order_acq_rel);
+
+            if (stopping && drained == 0) break;
+            if (drained == 0) std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    std::string path_;
+    int cpu_core_;
+    int fd_ = -1;
+    size_t window_bytes_ = 0;
+    unsigned char* window_ = nullptr;
+    size_t window_base_ = 0;
+    size_t cursor_ = 0;                               // drain thread only
+
+    std::array<std::unique_ptr<JournalWriter>, MAX_SOURCES> sources_;
+    std::atomic<size_t> source_count_{0};
+    std::mutex sources_mutex_;
+
+    std::thread worker_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> drain_passes_{0};
+    std::atomic<uint64_t> records_written_{0};
+};
+
+// Read side: mmaps a closed (or still growing) journal
+class JournalReader {
+public:
+    explicit JournalReader(const std::string& path) : file_(path) {
+        if (file_.size() < sizeof(journal_format::FileHeader)) {
+            throw std::runtime_error("Journal too small: " + path);
+        }
+        journal_format::FileHeader header;
+        std::memcpy(&header, file_.data(), sizeof(header));
+        if (std::memcmp(header.magic, journal_format::MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != journal_format::VERSION || header.record_size != sizeof(JournalRecord)) {
+            throw std::runtime_error("Not a journal: " + path);
+        }
+        count_ = (file_.size() - sizeof(header)) / sizeof(JournalRecord);
+    }
+
+    size_t size() const { return count_; }
+
+    JournalRecord operator[](size_t i) const {
+        JournalRecord r;
+        std::memcpy(static_cast<void*>(&r), file_.data() + sizeof(journal_format::FileHeader) + i * sizeof(r), sizeof(r));
+        return r;
+    }
+
+private:
+    MappedFile file_;
+    size_t count_ = 0;
+};
+
+// Base for log sinks with two backends: text formatted on the calling
+// thread (the default), or binary records into a BinaryJournal. Derived
+// provides static format_record(std::ostream&, const JournalRecord&),
+// which the decoder also uses.
+template<typename Derived>
+class JournaledLog {
+public:
+    bool journaled() const { return writer_ != nullptr; }
+
+protected:
+    explicit JournaledLog(const std::string& filename) : file_(filename) {}
+
+    JournaledLog(const std::string& filename, BinaryJournal& journal, JournalSourceKind kind)
+        : journal_(&journal), writer_(&journal.open_source(kind, filename)) {}
+
+    void emit(const JournalRecord& record) {
+        if (writer_) {
+            writer_->write(record);
+        } else {
+            Derived::format_record(file_, record);
+        }
+    }
+
+    void emit_text(std::string_view text) {
+        if (writer_) {
+            writer_->write_text(text);
+        } else {
+            file_ << text;
+        }
+    }
+
+    void flush_output() {
+        if (journal_) {
+            journal_->flush();
+        } else {
+            file_.flush();
+        }
+    }
+
+    std::ofstream file_;
+    BinaryJournal* journal_ = nullptr;
+    JournalWriter* writer_ = nullptr;
+};
+
+} // namespace hft
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "common_types.hpp"
+#include "tsc_clock.hpp"
+#include <chrono>
+#include <cstdint>
+
+namespace hft {
+
+// ====
+// Scheduler Clocks
+// Time sources for TimingWheelScheduler / DeterministicEventLoop. A clock is
+// any type with `Timestamp now()` and a constexpr `is_simulated`; simulated
+// clocks also have `set()` and only move when the scheduler moves them.
+// ====
+
+// steady_clock, as hft::now() reports it
+struct WallClock {
+    static constexpr bool is_simulated = false;
+
+    Timestamp now() const { return hft::now(); }
+};
+
+// The process-wide TSC clock (tsc::ClockService). hft::now() already reads
+// it, so this differs from WallClock only in exposing the counter rate.
+class TscClock {
+public:
+    static constexpr bool is_simulated = false;
+
+    Timestamp now() const { return hft::now(); }
+
+    double ns_per_cycle() const { return tsc::ClockService::instance().ns_per_cycle(); }
+};
+
+// Manually driven time for backtests and tests. The scheduler sets it to
+// each timer's deadline as it fires, so callbacks see exact event time.
+class SimulatedClock {
+public:
+    static constexpr bool is_simulated = true;
+
+    explicit SimulatedClock(Timestamp start = Timestamp()) : now_(start) {}
+
+    Timestamp now() const { return now_; }
+
+    // Time never runs backwards
+    void set(Timestamp t) {
+        if (t > now_) now_ = t;
+    }
+
+private:
+    Timestamp now_;
+};
+
+} // namespace hft
@@ -4,6 +4,7 @@
 #include <chrono>
 #include <array>
 #include <atomic>
+#include "tsc_clock.hpp"
 
 namespace hft {
 
@@ -17,8 +18,9 @@ inline int64_t to_nanos(const Timestamp& tp) {
         tp.time_since_epoch()).count();
 }
 
+// steady_clock time read through the calibrated TSC (tsc_clock.hpp)
 inline Timestamp now() {
-    return std::chrono::steady_clock::now();
+    return Timestamp(std::chrono::nanoseconds(tsc::ClockService::instance().now_ns()));
 }
 
 // Order Side Enum
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "common_types.hpp"
+#include "seqlock.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace hft {
+
+// ====
+// Compact Tick (hot-path / wire representation)
+// ====
+//
+// MarketTick carries 10 levels of depth inline (5+ cache lines) and stamps
+// itself with now() on construction. CompactTick is the BBO alone in one
+// cache line with a trivial-cost constructor; depth travels separately
+// through a DepthTable slot named by book_id, and only for consumers that
+// ask for it. Queues and the shared-memory bus move CompactTicks.
+
+struct alignas(64) CompactTick {
+    static constexpr uint16_t NO_BOOK = 0xFFFF;
+
+    int64_t timestamp_ns = 0;
+    double bid_price = 0.0;
+    double ask_price = 0.0;
+    uint64_t bid_size = 0;
+    uint64_t ask_size = 0;
+    uint64_t trade_volume = 0;
+    uint32_t asset_id = 0;
+    uint32_t depth_version = 0;  // DepthTable version published with this tick
+    uint16_t book_id = NO_BOOK;  // DepthTable slot, NO_BOOK if BBO only
+    Side trade_side = Side::BUY;
+    uint8_t depth_levels = 0;
+    uint8_t padding[4] = {};
+
+    double mid_price() const { return (bid_price + ask_price) * 0.5; }
+    bool has_depth() const { return book_id != NO_BOOK && depth_levels > 0; }
+};
+static_assert(sizeof(CompactTick) == 64, "CompactTick must stay one cache line");
+
+// Depth levels referenced by CompactTick::book_id
+struct TickDepth {
+    static constexpr size_t MAX_LEVELS = 10;
+
+    std::array<double, MAX_LEVELS> bid_prices{};
+    std::array<double, MAX_LEVELS> ask_prices{};
+    std::array<uint64_t, MAX_LEVELS> bid_sizes{};
+    std::array<uint64_t, MAX_LEVELS> ask_sizes{};
+    uint8_t levels = 0;
+};
+
+// Latest depth per book. One writer (the feed) per table; any number of
+// readers. Each book is its own Seqlock, so publishing one book never
+// disturbs readers of another.
+template<size_t MaxBooks = 64>
+class BasicDepthTable {
+public:
+    static constexpr size_t MAX_BOOKS = MaxBooks;
+
+    // Returns the version readers will see for this write
+    uint32_t publish(uint16_t book_id, const TickDepth& depth) {
+        books_[book_id].store(depth);
+        return static_cast<uint32_t>(books_[book_id].version());
+    }
+
+    // Latest depth for the book; may be newer than the tick that named it
+    TickDepth load(uint16_t book_id) const { return books_[book_id].load(); }
+
+    uint32_t version(uint16_t book_id) const {
+        return static_cast<uint32_t>(books_[book_id].version());
+    }
+
+private:
+    std::array<Seqlock<TickDepth>, MaxBooks> books_;
+};
+
+using DepthTable = BasicDepthTable<>;
+
+//
+// Converters
+//
+
+// BBO only; depth is dropped
+inline CompactTick to_compact(const MarketTick& tick) {
+    CompactTick c;
+    c.timestamp_ns = to_nanos(tick.timestamp);
+    c.bid_price = tick.bid_price;
+    c.ask_price = tick.ask_price;
+    c.bid_size = tick.bid_size;
+    c.ask_size = tick.ask_size;
+    c.trade_volume = tick.trade_volume;
+    c.asset_id = tick.asset_id;
+    c.trade_side = tick.trade_side;
+    return c;
+}
+
+// BBO in the tick, depth published to `depth` under book_id
+template<size_t MaxBooks>
+inline CompactTick to_compact(const MarketTick& tick, BasicDepthTable<MaxBooks>& depth, uint16_t book_id) {
+    CompactTick c = to_compact(tick);
+    if (book_id >= MaxBooks || tick.depth_levels == 0) return c;
+
+    TickDepth levels;
+    levels.bid_prices = tick.bid_prices;
+    levels.ask_prices = tick.ask_prices;
+    levels.bid_sizes = tick.bid_sizes;
+    levels.ask_sizes = tick.ask_sizes;
+    levels.levels = tick.depth_levels;
+
+    c.book_id = book_id;
+    c.depth_levels = tick.depth_levels;
+    c.depth_version = depth.publish(book_id, levels);
+    return c;
+}
+
+// Fills the BBO fields of an existing MarketTick (no clock read, depth untouched)
+inline void to_market_tick(const CompactTick& c, MarketTick& out) {
+    out.timestamp = Timestamp(std::chrono::nanoseconds(c.timestamp_ns));
+    out.bid_price = c.bid_price;
+    out.ask_price = c.ask_price;
+    out.mid_price = c.mid_price();
+    out.bid_size = c.bid_size;
+    out.ask_size = c.ask_size;
+    out.trade_volume = c.trade_volume;
+    out.trade_side = c.trade_side;
+    out.asset_id = c.asset_id;
+    out.depth_levels = 0;
+}
+
+// BBO plus the book's current depth
+template<size_t MaxBooks>
+inline void to_market_tick(const CompactTick& c, const BasicDepthTable<MaxBooks>& depth, MarketTick& out) {
+    to_market_tick(c, out);
+    if (!c.has_depth() || c.book_id >= MaxBooks) return;
+
+    const TickDepth levels = depth.load(c.book_id);
+    out.bid_prices = levels.bid_prices;
+    out.ask_prices = levels.ask_prices;
+    out.bid_sizes = levels.bid_sizes;
+    out.ask_sizes = levels.ask_sizes;
+    out.depth_levels = levels.levels;
+}
+
+} // namespace hft
@@ -275,9 +275,9 @@ mid_price, inventory, volatility, time_remaining, risk_multiplier
         using Strategy = DefaultStrategyEngine;
         using Risk = DefaultRiskChecker;
 
-        auto quote = Strategy::compute_quotes(100.0, 50.0, 0.02, 1.0, 1.0);
+        [[maybe_unused]] auto quote = Strategy::compute_quotes(100.0, 50.0, 0.02, 1.0, 1.0);
 
-        bool ok = Risk::check_order(50.0, 10.0, Side::BUY, -5000.0, 5.0);
+        [[maybe_unused]] bool ok = Risk::check_order(50.0, 10.0, Side::BUY, -5000.0, 5.0);
 
 }
 
@@ -0,0 +1,358 @@
+#pragma once
+
+#include "common_types.hpp"
+#include "tick_store.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+#elif defined(__aarch64__)
+    #include <arm_neon.h>
+#endif
+
+namespace hft {
+namespace backtest {
+namespace csv {
+
+// ====
+// Fast-Path CSV Tick Parser
+// Vectorized ',' / '\n' scan over an mmapped file, locale-free number
+// parsing, and newline-aligned chunks parsed on separate threads.
+// Row format (same as BacktestingEngine::parse_csv_line):
+//   ts_us,event_type,side,price,size[,...]
+// ====
+
+constexpr size_t BLOCK = 64;
+constexpr size_t MAX_FIELDS = 8;
+constexpr size_t MIN_CHUNK_BYTES = 1 << 20;  // Below this, threads cost more than they save
+
+// Bit i set where block[i] is ',' or '\n' (BLOCK bytes must be readable)
+inline uint64_t structural_mask(const char* block) {
+#if defined(__AVX2__)
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    uint64_t mask = 0;
+    for (int half = 0; half < 2; ++half) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + half * 32));
+        const __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(v, comma), _mm256_cmpeq_epi8(v, newline));
+        mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hit))) << (half * 32);
+    }
+    return mask;
+#elif defined(__x86_64__) || defined(_M_X64)
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    uint64_t mask = 0;
+    for (int quarter = 0; quarter < 4; ++quarter) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + quarter * 16));
+        const __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, newline));
+        mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(hit))) << (quarter * 16);
+    }
+    return mask;
+#elif defined(__aarch64__)
+    const uint8x16_t comma = vdupq_n_u8(',');
+    const uint8x16_t newline = vdupq_n_u8('\n');
+    const uint8x16_t bit = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint64_t mask = 0;
+    for (int quarter = 0; quarter < 4; ++quarter) {
+        const uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(block + quarter * 16));
+        const uint8x16_t hit = vandq_u8(vorrq_u8(vceqq_u8(v, comma), vceqq_u8(v, newline)), bit);
+        const uint64_t lo = vaddv_u8(vget_low_u8(hit));
+        const uint64_t hi = vaddv_u8(vget_high_u8(hit));
+        mask |= (lo | (hi << 8)) << (quarter * 16);
+    }
+    return mask;
+#else
+    uint64_t mask = 0;
+    for (size_t i = 0; i < BLOCK; ++i) {
+        if (block[i] == ',' || block[i] == '\n') mask |= 1ULL << i;
+    }
+    return mask;
+#endif
+}
+
+// Tail of the buffer (fewer than BLOCK bytes)
+inline uint64_t structural_mask_partial(const char* p, size_t n) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (p[i] == ',' || p[i] == '\n') mask |= 1ULL << i;
+    }
+    return mask;
+}
+
+// Integer prefix (like std::stoll: leading blanks, optional sign, trailing
+// text ignored). False if there are no digits or more than 18.
+template<typename Int>
+inline bool parse_int(const char* p, const char* end, Int& out) {
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        ++p;
+    }
+    const char* digits = p;
+    uint64_t value = 0;
+    while (p < end && static_cast<unsigned>(*p - '0') < 10u) {
+        value = value * 10 + static_cast<unsigned>(*p - '0');
+        ++p;
+    }
+    const size_t n = static_cast<size_t>(p - digits);
+    if (n == 0 || n > 18) {
+        return false;
+    }
+    out = negative ? static_cast<Int>(0 - value) : static_cast<Int>(value);
+    return true;
+}
+
+// Decimal prefix. Plain dddd.dddd with < 2^53 significant value and <= 22
+// fraction digits is exact (one correctly rounded division); anything else
+// (exponents, long mantissas) falls back to std::from_chars.
+inline bool parse_double(const char* p, const char* end, double& out) {
+    static constexpr double POW10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    const char* start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    size_t digits = 0;
+    size_t fraction = 0;
+    while (p < end && static_cast<unsigned>(*p - '0') < 10u) {
+        mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+        ++digits;
+        ++p;
+    }
+    if (p < end && *p == '.') {
+        ++p;
+        while (p < end && static_cast<unsigned>(*p - '0') < 10u) {
+            mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+            ++digits;
+            ++fraction;
+            ++p;
+        }
+    }
+    if (digits == 0) {
+        return false;
+    }
+
+    const bool exponent = (p < end && (*p == 'e' || *p == 'E'));
+    if (!exponent && digits <= 15 && fraction <= 22) {
+        const double v = static_cast<double>(mantissa) / POW10[fraction];
+        out = negative ? -v : v;
+        return true;
+    }
+
+    // Slow path
+    if (*start == '+') ++start;
+    const auto result = std::from_chars(start, end, out);
+    return result.ec == std::errc();
+}
+
+struct ParseStats {
+    size_t lines = 0;
+    size_t events = 0;
+    size_t rejected = 0;   // Header rows, blank or malformed lines
+};
+
+// One row -> event; false if the row is a header or malformed
+template<typename Event>
+inline bool parse_fields(const char* const* begin, const char* const* end, size_t nfields, Event& event) {
+    if (nfields == 0) {
+        return false;
+    }
+    auto field = [&](size_t i, const char*& b, const char*& e) {
+        if (i < nfields) {
+            b = begin[i];
+            e = end[i];
+        } else {
+            b = e = nullptr;  // Missing trailing columns read as empty
+        }
+    };
+
+    const char* b;
+    const char* e;
+
+    field(0, b, e);
+    int64_t ts_us;
+    if (!parse_int(b, e, ts_us)) {
+        return false;  // Includes the "ts_us,..." header row
+    }
+    event.timestamp_ns = ts_us * 1000;
+
+    const char* type_b;
+    const char* type_e;
+    field(1, type_b, type_e);
+
+    field(2, b, e);
+    const char side_char = (b != e) ? *b : 'B';
+
+    field(3, b, e);
+    double price = 100.0;
+    if (b != e && !parse_double(b, e, price)) {
+        return false;
+    }
+
+    field(4, b, e);
+    uint64_t size = 100;
+    if (b != e && !parse_int(b, e, size)) {
+        return false;
+    }
+
+    const double spread = price * 0.0002;
+    event.bid_price = price - spread / 2.0;
+    event.ask_price = price + spread / 2.0;
+    event.bid_size = size;
+    event.ask_size = size;
+
+    event.asset_id = 1;
+    event.event_type = 0;
+    event.trade_side = (side_char == 'S') ? Side::SELL : Side::BUY;
+    event.depth_levels = 1;
+
+    const bool is_trade = (type_e - type_b == 5) && std::memcmp(type_b, "trade", 5) == 0;
+    event.trade_volume = is_trade ? size : 0;
+
+    return true;
+}
+
+// Parse every row in [begin, end); sink(const Event&) for each valid row.
+// begin must be at a line start.
+template<typename Event, typename Sink>
+inline ParseStats parse_range(const char* begin, const char* end, Sink&& sink) {
+    ParseStats stats;
+    const char* field_begin[MAX_FIELDS];
+    const char* field_end[MAX_FIELDS];
+    size_t nfields = 0;
+    const char* start = begin;
+
+    auto finish_line = [&](const char* line_end) {
+        if (nfields < MAX_FIELDS) {
+            // Last field; drop a CR from CRLF files
+            const char* e = (line_end > start && line_end[-1] == '\r') ? line_end - 1 : line_end;
+            field_begin[nfields] = start;
+            field_end[nfields] = e;
+        }
+        ++nfields;
+        ++stats.lines;
+
+        Event event;
+        if (parse_fields(field_begin, field_end, std::min(nfields, MAX_FIELDS), event)) {
+            sink(event);
+            ++stats.events;
+        } else {
+            ++stats.rejected;
+        }
+        nfields = 0;
+    };
+
+    for (const char* block = begin; block < end; block += BLOCK) {
+        const size_t n = std::min<size_t>(BLOCK, static_cast<size_t>(end - block));
+        uint64_t mask = (n == BLOCK) ? structural_mask(block) : structural_mask_partial(block, n);
+
+        while (mask) {
+            const char* q = block + __builtin_ctzll(mask);
+            mask &= mask - 1;
+
+            if (*q == '\n') {
+                finish_line(q);
+            } else {
+                if (nfields < MAX_FIELDS) {
+                    field_begin[nfields] = start;
+                    field_end[nfields] = q;
+                }
+                ++nfields;
+            }
+            start = q + 1;
+        }
+    }
+
+    if (start < end || nfields > 0) {
+        finish_line(end);  // Last line without a trailing newline
+    }
+
+    return stats;
+}
+
+// Parse a CSV file (first line is the header) and deliver events to sink in
+// file order. threads = 0 uses all hardware threads. Throws
+// std::runtime_error if the file can't be mapped.
+template<typename Event, typename Sink>
+inline ParseStats parse_file(const std::string& path, Sink&& sink, unsigned threads = 0) {
+    MappedFile file(path);
+    const char* data = reinterpret_cast<const char*>(file.data());
+    const char* end = data + file.size();
+    if (!data) {
+        return ParseStats{};
+    }
+
+    // Skip header line
+    const char* body = static_cast<const char*>(std::memchr(data, '\n', file.size()));
+    body = body ? body + 1 : end;
+    const size_t body_size = static_cast<size_t>(end - body);
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(1, body_size / MIN_CHUNK_BYTES)));
+
+    if (threads <= 1) {
+        return parse_range<Event>(body, end, sink);
+    }
+
+    // Newline-aligned chunk boundaries
+    std::vector<const char*> bounds(threads + 1);
+    bounds[0] = body;
+    bounds[threads] = end;
+    for (unsigned t = 1; t < threads; ++t) {
+        const char* p = std::max(bounds[t - 1], body + body_size * t / threads);
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        bounds[t] = nl ? nl + 1 : end;
+    }
+
+    std::vector<std::vector<Event>> chunks(threads);
+    std::vector<ParseStats> chunk_stats(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            // ~40 bytes per row is a cheap upper bound for this format
+            chunks[t].reserve(static_cast<size_t>(bounds[t + 1] - bounds[t]) / 40);
+            chunk_stats[t] = parse_range<Event>(bounds[t], bounds[t + 1],
+                [&](const Event& e) { chunks[t].push_back(e); });
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    // Merge in file order
+    ParseStats total;
+    for (unsigned t = 0; t < threads; ++t) {
+        for (const Event& e : chunks[t]) {
+            sink(e);
+        }
+        total.lines += chunk_stats[t].lines;
+        total.events += chunk_stats[t].events;
+        total.rejected += chunk_stats[t].rejected;
+        std::vector<Event>().swap(chunks[t]);
+    }
+    return total;
+}
+
+} // namespace csv
+} // namespace backtest
+} // namespace hft
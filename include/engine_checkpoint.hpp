@@ -0,0 +1,459 @@
+#pragma once
+
+#include "mapped_file.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace hft {
+
+// ====
+// Engine Checkpoints
+// Versioned binary snapshot of stateful components: a header, a section
+// table and 64-byte-aligned named sections, each with its own layout
+// version and checksum. Components append their raw fields to a section
+// (save_state) and read them back in the same order (restore_state).
+// Restores mmap the file, so warming an engine is a header check plus
+// memcpy of each component's state rather than a replay of the session.
+// ====
+
+namespace checkpoint {
+
+constexpr char MAGIC[8] = {'H', 'F', 'T', 'C', 'K', 'P', 'T', '\0'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t SECTION_ALIGN = 64;
+constexpr size_t NAME_LEN = 32;
+
+struct SectionEntry {
+    char name[NAME_LEN];               // NUL padded
+    uint32_t version;                  // Owner's layout version
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+    uint64_t checksum;                 // FNV-1a of the payload
+};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t section_count;
+    uint64_t file_size;
+    int64_t event_time_ns;             // Time of the last event folded into the state
+    uint64_t sequence;                 // Events processed (replay position)
+    uint64_t table_offset;
+};
+
+inline size_t align_up(size_t v) {
+    return (v + SECTION_ALIGN - 1) & ~(SECTION_ALIGN - 1);
+}
+
+inline uint64_t fnv1a(const uint8_t* data, size_t size) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= data[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// Appends trivially copyable values to one section, native byte order
+class StateWriter {
+public:
+    template<typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Checkpoint fields must be trivially copyable");
+        append(&value, sizeof(T));
+    }
+
+    // Count-prefixed array
+    template<typename T>
+    void put_array(const T* values, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Checkpoint fields must be trivially copyable");
+        put<uint64_t>(count);
+        append(values, count * sizeof(T));
+    }
+
+    template<typename T, typename Alloc>
+    void put_vector(const std::vector<T, Alloc>& values) { put_array(values.data(), values.size()); }
+
+    void put_string(const std::string& s) { put_array(s.data(), s.size()); }
+
+    const std::vector<uint8_t>& bytes() const { return bytes_; }
+    size_t size() const { return bytes_.size(); }
+
+    // Empties the section but keeps its capacity
+    void clear() { bytes_.clear(); }
+
+private:
+    void append(const void* p, size_t n) {
+        const auto* b = static_cast<const uint8_t*>(p);
+        bytes_.insert(bytes_.end(), b, b + n);
+    }
+
+    std::vector<uint8_t> bytes_;
+};
+
+// Reads a section back in write order. Throws std::runtime_error when a
+// read runs past the section, so a stale layout fails loudly.
+class StateReader {
+public:
+    StateReader(const uint8_t* data, size_t size, std::string name)
+        : data_(data), size_(size), name_(std::move(name)) {}
+
+    template<typename T>
+    void get(T& out) {
+        static_assert(std::is_trivially_copyable<T>::value, "Checkpoint fields must be trivially copyable");
+        std::memcpy(&out, take(sizeof(T)), sizeof(T));
+    }
+
+    template<typename T>
+    T get() {
+        T value;
+        get(value);
+        return value;
+    }
+
+    // Fixed-size destination: the stored count must match
+    template<typename T>
+    void get_array(T* out, size_t count) {
+        if (get<uint64_t>() != count) {
+            throw std::runtime_error("Checkpoint array size mismatch in section " + name_);
+        }
+        if (count > 0) std::memcpy(out, take(count * sizeof(T)), count * sizeof(T));
+    }
+
+    template<typename T, typename Alloc>
+    void get_vector(std::vector<T, Alloc>& out) {
+        const uint64_t count = get<uint64_t>();
+        if (count > remaining() / sizeof(T)) {
+            throw std::runtime_error("Checkpoint section truncated: " + name_);
+        }
+        out.resize(count);
+        if (count > 0) std::memcpy(out.data(), take(count * sizeof(T)), count * sizeof(T));
+    }
+
+    std::string get_string() {
+        const uint64_t count = get<uint64_t>();
+        if (count > remaining()) {
+            throw std::runtime_error("Checkpoint section truncated: " + name_);
+        }
+        return std::string(reinterpret_cast<const char*>(take(count)), count);
+    }
+
+    size_t remaining() const { return size_ - pos_; }
+    bool at_end() const { return pos_ == size_; }
+    const std::string& name() const { return name_; }
+
+private:
+    const uint8_t* take(size_t n) {
+        if (n > remaining()) {
+            throw std::runtime_error("Checkpoint section truncated: " + name_);
+        }
+        const uint8_t* p = data_ + pos_;
+        pos_ += n;
+        return p;
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+    std::string name_;
+};
+
+} // namespace checkpoint
+
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(int64_t event_time_ns = 0, uint64_t sequence = 0)
+        : event_time_ns_(event_time_ns), sequence_(sequence) {}
+
+    // New section; the reference stays valid until write()
+    checkpoint::StateWriter& section(const std::string& name, uint32_t version) {
+        if (name.empty() || name.size() >= checkpoint::NAME_LEN) {
+            throw std::invalid_argument("Checkpoint section name must be 1-31 characters: " + name);
+        }
+        for (size_t i = 0; i < used_; ++i) {
+            if (sections_[i].name == name) {
+                throw std::invalid_argument("Duplicate checkpoint section: " + name);
+            }
+        }
+        // After reset(), the same sections in the same order reuse their buffers
+        if (used_ < sections_.size() && sections_[used_].name == name) {
+            Section& s = sections_[used_++];
+            s.version = version;
+            s.state.clear();
+            return s.state;
+        }
+        sections_.resize(used_);
+        sections_.push_back(Section{name, version, {}});
+        ++used_;
+        return sections_.back().state;
+    }
+
+    // Starts the next snapshot. Sections keep their capacity, so refilling
+    // the same layout does not allocate once the buffers have grown.
+    void reset(int64_t event_time_ns, uint64_t sequence) {
+        event_time_ns_ = event_time_ns;
+        sequence_ = sequence;
+        used_ = 0;
+    }
+
+    // Writes to `path`.tmp and renames over `path`, so a crash mid-write
+    // leaves the previous checkpoint intact. Returns the file size.
+    // Throws std::runtime_error on I/O failure.
+    size_t write(const std::string& path) const {
+        using namespace checkpoint;
+
+        FileHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.section_count = static_cast<uint32_t>(used_);
+        header.event_time_ns = event_time_ns_;
+        header.sequence = sequence_;
+        header.table_offset = sizeof(FileHeader);
+
+        std::vector<SectionEntry> table(used_);
+        size_t offset = align_up(sizeof(FileHeader) + table.size() * sizeof(SectionEntry));
+        for (size_t i = 0; i < used_; ++i) {
+            const auto& bytes = sections_[i].state.bytes();
+            SectionEntry& e = table[i];
+            std::memcpy(e.name, sections_[i].name.data(), sections_[i].name.size());
+            e.version = sections_[i].version;
+            e.offset = offset;
+            e.size = bytes.size();
+            e.checksum = fnv1a(bytes.data(), bytes.size());
+            offset = align_up(offset + bytes.size());
+        }
+        header.file_size = offset;
+
+        const std::string tmp = path + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                throw std::runtime_error("Failed to create checkpoint: " + tmp);
+            }
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(table.data()),
+                      static_cast<std::streamsize>(table.size() * sizeof(SectionEntry)));
+
+            size_t written = sizeof(header) + table.size() * sizeof(SectionEntry);
+            static const char zeros[SECTION_ALIGN] = {};
+            for (size_t i = 0; i < used_; ++i) {
+                const auto& bytes = sections_[i].state.bytes();
+                while (written < table[i].offset) {
+                    const size_t k = std::min<size_t>(table[i].offset - written, SECTION_ALIGN);
+                    out.write(zeros, static_cast<std::streamsize>(k));
+                    written += k;
+                }
+                out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+                written += bytes.size();
+            }
+            out.write(zeros, static_cast<std::streamsize>(header.file_size - written));
+            if (!out) {
+                throw std::runtime_error("Failed to write checkpoint: " + tmp);
+            }
+        }
+        if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+            std::remove(tmp.c_str());
+            throw std::runtime_error("Failed to publish checkpoint: " + path);
+        }
+        return header.file_size;
+    }
+
+private:
+    struct Section {
+        std::string name;
+        uint32_t version;
+        checkpoint::StateWriter state;
+    };
+
+    int64_t event_time_ns_;
+    uint64_t sequence_;
+    std::deque<Section> sections_;         // Stable references for section()
+    size_t used_ = 0;                      // Sections in this snapshot; the rest await reuse
+};
+
+// Takes checkpoint file I/O off a latency-critical thread. The caller
+// refills one reused CheckpointWriter in place (a memcpy of each
+// component's state) and queues it. A background thread then writes it to
+// `path`.tmp and renames it. A snapshot requested while the previous one
+// is still being written is skipped: the next interval catches up.
+class BackgroundCheckpointWriter {
+public:
+    using ErrorHandler = std::function<void(const std::exception&)>;
+
+    // on_error runs on the writer thread when a write fails
+    explicit BackgroundCheckpointWriter(std::string path, ErrorHandler on_error = nullptr)
+        : path_(std::move(path)), on_error_(std::move(on_error)) {
+        running_.store(true, std::memory_order_release);
+        worker_ = std::thread([this] { run(); });
+    }
+
+    ~BackgroundCheckpointWriter() { close(); }
+
+    BackgroundCheckpointWriter(const BackgroundCheckpointWriter&) = delete;
+    BackgroundCheckpointWriter& operator=(const BackgroundCheckpointWriter&) = delete;
+
+    // Snapshotting thread. fill(CheckpointWriter&) adds the sections, and
+    // the result is queued for writing. Returns false without calling fill
+    // while the previous snapshot is still queued or being written.
+    template<typename Fill>
+    bool submit(int64_t event_time_ns, uint64_t sequence, Fill&& fill) {
+        if (state_.load(std::memory_order_acquire) != IDLE) return false;
+        snapshot_.reset(event_time_ns, sequence);
+        fill(snapshot_);
+        state_.store(QUEUED, std::memory_order_release);
+        return true;
+    }
+
+    // Fills the snapshot once without writing it, so that the first
+    // submit() does not have to grow the section buffers
+    template<typename Fill>
+    void reserve(Fill&& fill) {
+        flush();
+        snapshot_.reset(0, 0);
+        fill(snapshot_);
+    }
+
+    // Blocks until nothing is queued or being written
+    void flush() {
+        while (state_.load(std::memory_order_acquire) != IDLE) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    // Writes anything still queued, then stops the writer thread
+    void close() {
+        if (!running_.exchange(false, std::memory_order_acq_rel)) return;
+        if (worker_.joinable()) worker_.join();
+    }
+
+    const std::string& path() const { return path_; }
+    uint64_t written() const { return written_.load(std::memory_order_acquire); }
+    uint64_t failures() const { return failures_.load(std::memory_order_acquire); }
+
+private:
+    enum State : uint8_t { IDLE, QUEUED };
+
+    void run() {
+        for (;;) {
+            const bool stopping = !running_.load(std::memory_order_acquire);
+            if (state_.load(std::memory_order_acquire) == QUEUED) {
+                try {
+                    snapshot_.write(path_);
+                    written_.fetch_add(1, std::memory_order_acq_rel);
+                } catch (const std::exception& e) {
+                    failures_.fetch_add(1, std::memory_order_acq_rel);
+                    if (on_error_) on_error_(e);
+                }
+                state_.store(IDLE, std::memory_order_release);
+            } else if (stopping) {
+                break;
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
+    std::string path_;
+    ErrorHandler on_error_;
+    CheckpointWriter snapshot_;             // Caller's while IDLE, the writer thread's while QUEUED
+
+    std::thread worker_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint8_t> state_{IDLE};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> failures_{0};
+};
+
+// Memory-mapped checkpoint. Validates the header and table on open; a
+// section's checksum is verified when it is read.
+class CheckpointReader {
+public:
+    explicit CheckpointReader(const std::string& path)
+        : path_(path), file_(path, MADV_WILLNEED) {
+        using namespace checkpoint;
+
+        if (file_.size() < sizeof(FileHeader)) {
+            throw std::runtime_error("Checkpoint too small: " + path);
+        }
+        std::memcpy(&header_, file_.data(), sizeof(header_));
+        if (std::memcmp(header_.magic, MAGIC, sizeof(MAGIC)) != 0) {
+            throw std::runtime_error("Not a checkpoint file: " + path);
+        }
+        if (header_.version != VERSION) {
+            throw std::runtime_error("Unsupported checkpoint version in " + path);
+        }
+        if (header_.file_size > file_.size() ||
+            header_.table_offset + uint64_t(header_.section_count) * sizeof(SectionEntry) > header_.file_size) {
+            throw std::runtime_error("Truncated checkpoint: " + path);
+        }
+        table_.resize(header_.section_count);
+        std::memcpy(table_.data(), file_.data() + header_.table_offset,
+                    table_.size() * sizeof(SectionEntry));
+        for (const auto& e : table_) {
+            if (e.offset > header_.file_size || e.size > header_.file_size - e.offset) {
+                throw std::runtime_error("Corrupt checkpoint section table: " + path);
+            }
+        }
+    }
+
+    bool has(const std::string& name) const { return find(name) != nullptr; }
+
+    // 0 if the section is absent
+    uint32_t section_version(const std::string& name) const {
+        const auto* e = find(name);
+        return e ? e->version : 0;
+    }
+
+    // Throws std::runtime_error if the section is missing, was written with
+    // a different layout version, or fails its checksum
+    checkpoint::StateReader section(const std::string& name, uint32_t version) const {
+        const auto* e = find(name);
+        if (!e) {
+            throw std::runtime_error("Checkpoint section missing: " + name + " in " + path_);
+        }
+        if (e->version != version) {
+            throw std::runtime_error("Checkpoint section " + name + " has layout version " +
+                                     std::to_string(e->version) + ", expected " + std::to_string(version));
+        }
+        const uint8_t* data = file_.data() + e->offset;
+        if (checkpoint::fnv1a(data, e->size) != e->checksum) {
+            throw std::runtime_error("Checkpoint section " + name + " failed its checksum in " + path_);
+        }
+        return checkpoint::StateReader(data, e->size, name);
+    }
+
+    int64_t event_time_ns() const { return header_.event_time_ns; }
+    uint64_t sequence() const { return header_.sequence; }
+    size_t section_count() const { return table_.size(); }
+    const std::string& path() const { return path_; }
+
+private:
+    const checkpoint::SectionEntry* find(const std::string& name) const {
+        if (name.size() >= checkpoint::NAME_LEN) return nullptr;
+        for (const auto& e : table_) {
+            if (std::strncmp(e.name, name.c_str(), checkpoint::NAME_LEN) == 0) return &e;
+        }
+        return nullptr;
+    }
+
+    std::string path_;
+    MappedFile file_;
+    checkpoint::FileHeader header_{};
+    std::vector<checkpoint::SectionEntry> table_;
+};
+
+} // namespace hft
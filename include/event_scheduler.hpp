@@ -1,11 +1,16 @@
 #pragma once
 
 #include "common_types.hpp"
+#include "clock.hpp"
+#include "inline_function.hpp"
+#include "memory_arena.hpp"
 #include <atomic>
 #include <vector>
 #include <algorithm>
 #include <queue>
 #include <functional>
+#include <memory>
+#include <new>
 
 namespace hft {
 namespace scheduler {
@@ -25,25 +30,58 @@ struct ScheduledEvent {
           callback(std::move(cb)), is_cancelled(false) {}
 };
 
-class TimingWheelScheduler {
+// Hierarchical timing wheel.
+//
+// LEVELS wheels of num_slots slots each (rounded up to a power of two);
+// level l slots span num_slots^l ticks. A timer sits on the lowest level
+// whose span covers its distance from the current tick and is cascaded down
+// when that slot comes round, so any delay lands in the right slot (delays
+// past the top level park in its last slot and re-cascade). Timers are
+// intrusive nodes from a chunked pool, linked into per-slot lists, with the
+// callback stored inline - schedule/cancel/reschedule are O(1) and never
+// allocate once the pool is warm. Single-threaded.
+//
+// Time comes from Clock (see clock.hpp). With a simulated clock nothing
+// spins: process_until() jumps straight from one due timer to the next and
+// sets the clock to each deadline before firing it.
+template<typename Clock = WallClock>
+class BasicTimingWheel {
 public:
-    explicit TimingWheelScheduler(
-        size_t num_slots = 1024,
-        Duration slot_duration_ns = std::chrono::microseconds(10)
-    ) : num_slots_(num_slots),
-        slot_duration_(slot_duration_ns),
-        current_slot_(0),
-        next_event_id_(1),
-        wheel_(num_slots),
-        start_time_(now()) {
+    using Callback = InlineFunction<void(), 48>;
+    using TimerHandle = uint64_t;                   // 0 = no timer
+
+    static constexpr size_t LEVELS = 4;
+
+    static constexpr uint64_t NO_TICK = UINT64_MAX;
 
-        for (auto& slot : wheel_) {
-            slot.reserve(16);
+    explicit BasicTimingWheel(
+        size_t num_slots = 1024,
+        Duration slot_duration_ns = std::chrono::microseconds(10),
+        size_t initial_timers = 1024,
+        Clock clock = Clock()
+    ) : clock_(std::move(clock)),
+        slot_bits_(bits_for(num_slots)),
+        slot_mask_((uint64_t(1) << slot_bits_) - 1),
+        slot_duration_(slot_duration_ns.count() > 0 ? slot_duration_ns : Duration(1)),
+        current_tick_(0),
+        pending_(0),
+        free_head_(NIL),
+        heads_(LEVELS << slot_bits_, NIL),
+        occupied_(LEVELS * words_per_level(), 0),
+        start_time_(clock_.now()) {
+
+        while (capacity() < initial_timers) {
+            grow();
         }
     }
 
-    uint64_t schedule_at(Timestamp exec_time, std::function<void()> callback) {
-        const int64_t delay_ns = to_nanos(exec_time) - to_nanos(now());
+    BasicTimingWheel(const BasicTimingWheel&) = delete;
+    BasicTimingWheel& operator=(const BasicTimingWheel&) = delete;
+
+    // Past deadlines run the callback immediately and return 0
+    template<typename F>
+    TimerHandle schedule_at(Timestamp exec_time, F&& callback) {
+        const int64_t delay_ns = to_nanos(exec_time) - to_nanos(clock_.now());
 
         if (delay_ns <= 0) {
 
@@ -51,62 +89,84 @@ public:
             return 0;
         }
 
-        return schedule_after(std::chrono::nanoseconds(delay_ns), std::move(callback));
+        if constexpr (Clock::is_simulated) {
+            // Absolute slot, so the deadline doesn't depend on where
+            // current_tick_ sits within the last processed slot
+            return arm(tick_of(exec_time), std::forward<F>(callback));
+        } else {
+            return schedule_after(std::chrono::nanoseconds(delay_ns), std::forward<F>(callback));
+        }
     }
 
-    uint64_t schedule_after(Duration delay, std::function<void()> callback) {
-        const uint64_t event_id = next_event_id_.fetch_add(1, std::memory_order_relaxed);
-
-        const int64_t delay_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count();
-        const int64_t slot_delay_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(slot_duration_).count();
-        const size_t slots_ahead = static_cast<size_t>(delay_ns / slot_delay_ns);
-        const size_t target_slot = (current_slot_ + slots_ahead) % num_slots_;
-
-        const Timestamp exec_time = now() + delay;
-
-        wheel_[target_slot].emplace_back(exec_time, event_id, std::move(callback));
-
-        return event_id;
+    template<typename F>
+    TimerHandle schedule_after(Duration delay, F&& callback) {
+        return arm(current_tick_ + ticks_for(delay), std::forward<F>(callback));
     }
 
-    void cancel(uint64_t event_id) {
+    // False if the timer already fired or was cancelled
+    bool cancel(TimerHandle handle) {
+        const uint32_t idx = live_index(handle);
+        if (idx == NIL) {
+            return false;
+        }
+        unlink(idx);
+        release(idx);
+        --pending_;
+        return true;
+    }
 
-        for (auto& slot : wheel_) {
-            for (auto& event : slot) {
-                if (event.event_id == event_id) {
-                    event.is_cancelled = true;
-                    return;
-                }
-            }
+    // Move a pending timer to now + delay, keeping its callback and handle
+    bool reschedule(TimerHandle handle, Duration delay) {
+        const uint32_t idx = live_index(handle);
+        if (idx == NIL) {
+            return false;
         }
+        unlink(idx);
+        node(idx).expiry_tick = current_tick_ + ticks_for(delay);
+        link(idx);
+        return true;
     }
 
+    // Advance one slot: cascade higher levels, then fire everything due on
+    // the current tick. Callbacks may schedule or cancel timers; a zero
+    // delay scheduled from a callback still fires in this tick.
     void tick() {
-        auto& current_events = wheel_[current_slot_];
-        const Timestamp current_time = now();
-
-        for (auto& event : current_events) {
-            if (!event.is_cancelled && event.callback) {
+        fire_current();
+        ++current_tick_;
+    }
 
-                if (to_nanos(event.execution_time) <= to_nanos(current_time)) {
-                    event.callback();
+    // Wall/TSC clock: tick in step with real slot boundaries until
+    // target_time. Simulated clock: fire every timer due at or before
+    // target_time in deadline order, skipping empty ticks, then leave the
+    // clock at target_time.
+    void process_until(Timestamp target_time) {
+        if constexpr (Clock::is_simulated) {
+            const uint64_t target_tick = tick_of(target_time);
+            for (;;) {
+                const uint64_t next = next_due_tick();
+                if (next == NO_TICK || next >= target_tick) {
+                    break;
                 }
+                advance_to_next();
             }
+            // The target tick itself stays current, so timers armed at
+            // target_time with no delay fire on the next call
+            if (target_tick >= current_tick_) {
+                current_tick_ = target_tick;
+                clock_.set(tick_time(current_tick_));
+                fire_current();
+            }
+            clock_.set(target_time);
+            return;
         }
 
-        current_events.clear();
-
-        current_slot_ = (current_slot_ + 1) % num_slots_;
-    }
-
-    void process_until(Timestamp target_time) {
-        while (to_nanos(now()) < to_nanos(target_time)) {
+        while (to_nanos(clock_.now()) < to_nanos(target_time)) {
             tick();
 
             const Timestamp next_slot_time = start_time_ +
-                slot_duration_ * (current_slot_ + 1);
+                slot_duration_ * static_cast<int64_t>(current_tick_ + 1);
 
-            while (to_nanos(now()) < to_nanos(next_slot_time)) {
+            while (to_nanos(clock_.now()) < to_nanos(next_slot_time)) {
 
 #if defined(__x86_64__) || defined(__i386__)
                 __asm__ __volatile__("pause" ::: "memory");
@@ -119,123 +179,582 @@ public:
         }
     }
 
-    size_t get_pending_count() const {
-        size_t count = 0;
-        for (const auto& slot : wheel_) {
-            for (const auto& event : slot) {
-                if (!event.is_cancelled) {
-                    ++count;
+    // Simulated clock: run until no timers are left (including any the
+    // callbacks keep arming)
+    void run_until_idle() {
+        while (advance_to_next()) {}
+    }
+
+    // Simulated clock: jump to the next tick with work and process it.
+    // False when no timers are pending.
+    bool advance_to_next() {
+        static_assert(Clock::is_simulated, "Jumping ahead needs a simulated clock");
+        const uint64_t next = next_due_tick();
+        if (next == NO_TICK) {
+            return false;
+        }
+        current_tick_ = std::max(current_tick_, next);
+        clock_.set(tick_time(current_tick_));
+        tick();
+        return true;
+    }
+
+    // Earliest tick at which a timer fires or must be cascaded; NO_TICK
+    // when idle. Nothing happens on the ticks before it.
+    uint64_t next_due_tick() const {
+        const uint64_t digit0 = current_tick_ & slot_mask_;
+        const uint64_t hit0 = find_occupied(0, digit0);
+        if (hit0 != NO_TICK) {
+            return (current_tick_ & ~slot_mask_) | hit0;
+        }
+
+        for (size_t level = 1; level < LEVELS; ++level) {
+            const uint32_t shift = slot_bits_ * static_cast<uint32_t>(level);
+            const uint64_t digit = (current_tick_ >> shift) & slot_mask_;
+            const uint64_t block = (current_tick_ >> (shift + slot_bits_)) << (shift + slot_bits_);
+            const uint64_t hit = find_occupied(level, digit + 1);
+            if (hit != NO_TICK) {
+                return block | (hit << shift);
+            }
+            if (level + 1 == LEVELS) {
+                // Top level wraps into the next rotation
+                const uint64_t wrapped = find_occupied(level, 0);
+                if (wrapped != NO_TICK && wrapped <= digit) {
+                    return (block + (uint64_t(1) << (shift + slot_bits_))) | (wrapped << shift);
                 }
             }
         }
-        return count;
+        return NO_TICK;
     }
 
+    Clock& clock() { return clock_; }
+    const Clock& clock() const { return clock_; }
+    Timestamp now() const { return clock_.now(); }
+
+    size_t get_pending_count() const { return pending_; }
+    uint64_t current_tick() const { return current_tick_; }
+    size_t slots_per_level() const { return size_t(1) << slot_bits_; }
+    size_t capacity() const { return chunks_.size() * CHUNK_SIZE; }
+
 private:
-    const size_t num_slots_;
+    static constexpr uint32_t NIL = UINT32_MAX;
+    static constexpr size_t CHUNK_SIZE = 1024;
+
+    struct Node {
+        Callback callback;
+        uint64_t expiry_tick = 0;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        uint32_t slot = NIL;        // Owning slot list; NIL while free
+        uint32_t generation = 1;    // Bumped on release; stale handles miss
+    };
+
+    Clock clock_;
+    const uint32_t slot_bits_;
+    const uint64_t slot_mask_;
     const Duration slot_duration_;
-    size_t current_slot_;
-    std::atomic<uint64_t> next_event_id_;
-    std::vector<std::vector<ScheduledEvent>> wheel_;
+    uint64_t current_tick_;
+    size_t pending_;
+    uint32_t free_head_;
+    HotVector<uint32_t> heads_;                     // LEVELS x slots list heads
+    HotVector<uint64_t> occupied_;                  // Non-empty slot bitmap per level
+    HotVector<HotVector<Node>> chunks_;             // Stable addresses
     Timestamp start_time_;
+
+    static uint32_t bits_for(size_t num_slots) {
+        uint32_t bits = 1;
+        while ((size_t(1) << bits) < num_slots && bits < 15) ++bits;
+        return bits;
+    }
+
+    size_t words_per_level() const { return ((size_t(1) << slot_bits_) + 63) / 64; }
+
+    uint64_t tick_of(Timestamp t) const {
+        const int64_t ns = to_nanos(t) - to_nanos(start_time_);
+        return ns > 0 ? static_cast<uint64_t>(ns / slot_duration_.count()) : 0;
+    }
+
+    Timestamp tick_time(uint64_t tick) const {
+        return start_time_ + slot_duration_ * static_cast<int64_t>(tick);
+    }
+
+    // First non-empty slot index >= from on `level`, or NO_TICK
+    uint64_t find_occupied(size_t level, uint64_t from) const {
+        const size_t slots = size_t(1) << slot_bits_;
+        if (from >= slots) {
+            return NO_TICK;
+        }
+        const uint64_t* words = &occupied_[level * words_per_level()];
+        size_t w = static_cast<size_t>(from / 64);
+        uint64_t bits = words[w] & (~uint64_t(0) << (from % 64));
+        for (;;) {
+            if (bits) {
+                return w * 64 + static_cast<uint64_t>(__builtin_ctzll(bits));
+            }
+            if (++w == words_per_level()) {
+                return NO_TICK;
+            }
+            bits = words[w];
+        }
+    }
+
+    void mark(size_t slot, bool occupied) {
+        const size_t level = slot >> slot_bits_;
+        const size_t index = slot & slot_mask_;
+        uint64_t& word = occupied_[level * words_per_level() + index / 64];
+        if (occupied) {
+            word |= uint64_t(1) << (index % 64);
+        } else {
+            word &= ~(uint64_t(1) << (index % 64));
+        }
+    }
+
+    // Cascade due higher-level slots, then fire the current level-0 slot.
+    // New zero-delay timers land in the same slot and fire in this loop.
+    void fire_current() {
+        const uint64_t tick = current_tick_;
+        for (size_t level = 1; level < LEVELS; ++level) {
+            if ((tick & ((uint64_t(1) << (slot_bits_ * level)) - 1)) != 0) {
+                break;
+            }
+            cascade(slot_id(level, (tick >> (slot_bits_ * level)) & slot_mask_));
+        }
+
+        uint32_t& head = heads_[slot_id(0, tick & slot_mask_)];
+        while (head != NIL) {
+            const uint32_t idx = head;
+            unlink(idx);
+            node(idx).slot = NIL;   // Firing: no longer cancellable
+            --pending_;
+            node(idx).callback();
+            release(idx);
+        }
+    }
+
+    template<typename F>
+    TimerHandle arm(uint64_t expiry_tick, F&& callback) {
+        const uint32_t idx = allocate();
+        Node& n = node(idx);
+        n.callback.emplace(std::forward<F>(callback));
+        n.expiry_tick = expiry_tick;
+        link(idx);
+        ++pending_;
+        return make_handle(idx, n.generation);
+    }
+
+    Node& node(uint32_t idx) { return chunks_[idx / CHUNK_SIZE][idx % CHUNK_SIZE]; }
+
+    size_t slot_id(size_t level, uint64_t index) const {
+        return (level << slot_bits_) | static_cast<size_t>(index);
+    }
+
+    uint64_t ticks_for(Duration delay) const {
+        return delay.count() > 0 ? static_cast<uint64_t>(delay.count() / slot_duration_.count()) : 0;
+    }
+
+    static TimerHandle make_handle(uint32_t idx, uint32_t generation) {
+        return (static_cast<uint64_t>(generation) << 32) | (static_cast<uint64_t>(idx) + 1);
+    }
+
+    uint32_t live_index(TimerHandle handle) {
+        const uint64_t low = handle & 0xFFFFFFFFULL;
+        if (low == 0 || low > capacity()) {
+            return NIL;
+        }
+        const uint32_t idx = static_cast<uint32_t>(low - 1);
+        const Node& n = node(idx);
+        return (n.slot != NIL && n.generation == static_cast<uint32_t>(handle >> 32)) ? idx : NIL;
+    }
+
+    void grow() {
+        const uint32_t base = static_cast<uint32_t>(capacity());
+        chunks_.emplace_back(CHUNK_SIZE);
+        for (size_t i = CHUNK_SIZE; i-- > 0;) {
+            chunks_.back()[i].next = free_head_;
+            free_head_ = base + static_cast<uint32_t>(i);
+        }
+    }
+
+    uint32_t allocate() {
+        if (free_head_ == NIL) {
+            grow();
+        }
+        const uint32_t idx = free_head_;
+        free_head_ = node(idx).next;
+        return idx;
+    }
+
+    void release(uint32_t idx) {
+        Node& n = node(idx);
+        n.callback.reset();
+        n.slot = NIL;
+        ++n.generation;
+        n.next = free_head_;
+        free_head_ = idx;
+    }
+
+    // Level = highest digit where expiry and now differ; a timer on level l
+    // reaches its slot exactly when the lower digits of now roll over to it
+    void link(uint32_t idx) {
+        Node& n = node(idx);
+        const uint64_t expiry = std::max(n.expiry_tick, current_tick_);
+        const uint64_t diff = expiry ^ current_tick_;
+        const size_t level = diff ? static_cast<size_t>((63 - __builtin_clzll(diff)) / slot_bits_) : 0;
+
+        size_t slot;
+        if (level < LEVELS) {
+            slot = slot_id(level, (expiry >> (slot_bits_ * level)) & slot_mask_);
+        } else if (expiry - current_tick_ < (uint64_t(1) << (slot_bits_ * LEVELS))) {
+            // Within range but across a top-level wrap: its top slot still
+            // comes round before it expires
+            slot = slot_id(LEVELS - 1, (expiry >> (slot_bits_ * (LEVELS - 1))) & slot_mask_);
+        } else {
+            // Beyond the top level: park in the top slot visited last
+            const uint64_t top = current_tick_ >> (slot_bits_ * (LEVELS - 1));
+            slot = slot_id(LEVELS - 1, (top - 1) & slot_mask_);
+        }
+
+        n.slot = static_cast<uint32_t>(slot);
+        n.prev = NIL;
+        n.next = heads_[slot];
+        if (n.next != NIL) {
+            node(n.next).prev = idx;
+        } else {
+            mark(slot, true);
+        }
+        heads_[slot] = idx;
+    }
+
+    void unlink(uint32_t idx) {
+        Node& n = node(idx);
+        if (n.prev != NIL) {
+            node(n.prev).next = n.next;
+        } else {
+            heads_[n.slot] = n.next;
+            if (n.next == NIL) {
+                mark(n.slot, false);
+            }
+        }
+        if (n.next != NIL) {
+            node(n.next).prev = n.prev;
+        }
+        n.prev = n.next = NIL;
+    }
+
+    void cascade(size_t slot) {
+        uint32_t idx = heads_[slot];
+        heads_[slot] = NIL;
+        mark(slot, false);
+        while (idx != NIL) {
+            const uint32_t next = node(idx).next;
+            link(idx);
+            idx = next;
+        }
+    }
 };
 
+using TimingWheelScheduler = BasicTimingWheel<WallClock>;
+using SimulatedTimingWheel = BasicTimingWheel<SimulatedClock>;
+
+// ====
+// Indexed Priority Queue
+// 4-ary min-heap of (priority, sequence, slot) over a fixed pool of events
+// constructed in place. Handles are generation-checked like timer handles,
+// so cancel() and update_priority() remove or re-sift the exact entry in
+// O(log n) and the heap never holds dead entries. Lower priority values pop
+// first; equal priorities pop in push order.
+// ====
 template<typename EventType, size_t MaxEvents = 4096>
 class PriorityEventQueue {
 public:
-    struct Event {
-        EventType data;
-        uint64_t priority;
-        bool is_valid;
+    using Handle = uint64_t;                 // generation << 32 | slot + 1
+    static constexpr Handle INVALID_HANDLE = 0;
+    static constexpr size_t ARITY = 4;
 
-        Event() : data(), priority(UINT64_MAX), is_valid(false) {}
+    static_assert(MaxEvents > 0 && MaxEvents < UINT32_MAX, "Capacity must fit a 32-bit slot index");
 
-        bool operator<(const Event& other) const {
-            return priority > other.priority;
-        }
-    };
+    PriorityEventQueue()
+        : heap_(std::make_unique<HeapEntry[]>(MaxEvents)),
+          slots_(std::make_unique<Slot[]>(MaxEvents)) {
+        reset_free_list();
+    }
 
-    PriorityEventQueue() : event_count_(0) {
-        events_.reserve(MaxEvents);
+    ~PriorityEventQueue() { clear(); }
+
+    PriorityEventQueue(const PriorityEventQueue&) = delete;
+    PriorityEventQueue& operator=(const PriorityEventQueue&) = delete;
+
+    // Constructs the event in its pool slot. INVALID_HANDLE when full.
+    template<typename... Args>
+    Handle emplace(uint64_t priority, Args&&... args) {
+        if (free_head_ == NIL) {
+            return INVALID_HANDLE;
+        }
+        const uint32_t idx = free_head_;
+        Slot& slot = slots_[idx];
+        ::new (static_cast<void*>(slot.storage)) EventType(std::forward<Args>(args)...);
+        free_head_ = slot.next_free;
+
+        heap_[size_] = HeapEntry{priority, sequence_++, idx};
+        slot.heap_pos = static_cast<uint32_t>(size_);
+        sift_up(size_++);
+        return make_handle(idx, slot.generation);
     }
 
     bool push(const EventType& event, uint64_t priority) {
-        if (event_count_ >= MaxEvents) {
+        return emplace(priority, event) != INVALID_HANDLE;
+    }
+
+    bool push(EventType&& event, uint64_t priority) {
+        return emplace(priority, std::move(event)) != INVALID_HANDLE;
+    }
+
+    bool pop(EventType& event) {
+        if (size_ == 0) {
             return false;
         }
+        event = std::move(value(heap_[0].slot));
+        remove_at(0);
+        return true;
+    }
 
-        Event e;
-        e.data = event;
-        e.priority = priority;
-        e.is_valid = true;
+    bool peek(EventType& event) const {
+        if (size_ == 0) {
+            return false;
+        }
+        event = value(heap_[0].slot);
+        return true;
+    }
 
-        events_.push_back(e);
-        std::push_heap(events_.begin(), events_.end());
+    // Priority of the next event; UINT64_MAX when empty
+    uint64_t top_priority() const {
+        return size_ ? heap_[0].priority : UINT64_MAX;
+    }
 
-        ++event_count_;
+    // False if the event already popped or was cancelled
+    bool cancel(Handle handle) {
+        const uint32_t idx = live_index(handle);
+        if (idx == NIL) {
+            return false;
+        }
+        remove_at(slots_[idx].heap_pos);
         return true;
     }
 
-    bool pop(EventType& event) {
-        while (!events_.empty()) {
-            std::pop_heap(events_.begin(), events_.end());
-            Event& e = events_.back();
-
-            if (e.is_valid) {
-                event = e.data;
-                events_.pop_back();
-                --event_count_;
-                return true;
-            }
+    // Raise or lower a queued event's priority. It queues behind events
+    // already at the new priority.
+    bool update_priority(Handle handle, uint64_t priority) {
+        const uint32_t idx = live_index(handle);
+        if (idx == NIL) {
+            return false;
+        }
+        const size_t pos = slots_[idx].heap_pos;
+        heap_[pos].priority = priority;
+        heap_[pos].sequence = sequence_++;
+        restore(pos);
+        return true;
+    }
 
-            events_.pop_back();
+    bool contains(Handle handle) const { return live_index(handle) != NIL; }
+
+    // fn(priority, event) for every queued event in pop order, without
+    // popping (e.g. to checkpoint the queue; pushing the events back in this
+    // order reproduces it)
+    template<typename Fn>
+    void for_each_in_order(Fn&& fn) const {
+        std::vector<HeapEntry> entries(heap_.get(), heap_.get() + size_);
+        std::sort(entries.begin(), entries.end(), [](const HeapEntry& a, const HeapEntry& b) {
+            return a.priority != b.priority ? a.priority < b.priority : a.sequence < b.sequence;
+        });
+        for (const HeapEntry& e : entries) {
+            fn(e.priority, value(e.slot));
         }
+    }
 
-        return false;
+    void clear() {
+        for (size_t pos = 0; pos < size_; ++pos) {
+            value(heap_[pos].slot).~EventType();
+        }
+        for (size_t i = 0; i < MaxEvents; ++i) {
+            if (slots_[i].heap_pos != NIL) {
+                ++slots_[i].generation;
+            }
+        }
+        size_ = 0;
+        reset_free_list();
     }
 
-    bool peek(EventType& event) const {
-        if (events_.empty()) {
-            return false;
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    static constexpr size_t capacity() { return MaxEvents; }
+
+private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct HeapEntry {
+        uint64_t priority;
+        uint64_t sequence;      // Push order, breaks priority ties
+        uint32_t slot;
+    };
+
+    struct Slot {
+        alignas(EventType) unsigned char storage[sizeof(EventType)];
+        uint32_t heap_pos = NIL;    // NIL while free
+        uint32_t generation = 1;    // Bumped on release; stale handles miss
+        uint32_t next_free = NIL;
+    };
+
+    std::unique_ptr<HeapEntry[]> heap_;
+    std::unique_ptr<Slot[]> slots_;
+    size_t size_ = 0;
+    uint32_t free_head_ = NIL;
+    uint64_t sequence_ = 0;
+
+    EventType& value(uint32_t idx) {
+        return *std::launder(reinterpret_cast<EventType*>(slots_[idx].storage));
+    }
+
+    const EventType& value(uint32_t idx) const {
+        return *std::launder(reinterpret_cast<const EventType*>(slots_[idx].storage));
+    }
+
+    static bool before(const HeapEntry& a, const HeapEntry& b) {
+        return a.priority < b.priority || (a.priority == b.priority && a.sequence < b.sequence);
+    }
+
+    static Handle make_handle(uint32_t idx, uint32_t generation) {
+        return (static_cast<uint64_t>(generation) << 32) | (static_cast<uint64_t>(idx) + 1);
+    }
+
+    uint32_t live_index(Handle handle) const {
+        const uint64_t low = handle & 0xFFFFFFFFULL;
+        if (low == 0 || low > MaxEvents) {
+            return NIL;
         }
+        const uint32_t idx = static_cast<uint32_t>(low - 1);
+        const Slot& slot = slots_[idx];
+        return (slot.heap_pos != NIL && slot.generation == static_cast<uint32_t>(handle >> 32)) ? idx : NIL;
+    }
 
-        if (events_.front().is_valid) {
-            event = events_.front().data;
-            return true;
+    void reset_free_list() {
+        free_head_ = NIL;
+        for (size_t i = MaxEvents; i-- > 0;) {
+            slots_[i].heap_pos = NIL;
+            slots_[i].next_free = free_head_;
+            free_head_ = static_cast<uint32_t>(i);
         }
+    }
 
-        return false;
+    void place(size_t pos, const HeapEntry& entry) {
+        heap_[pos] = entry;
+        slots_[entry.slot].heap_pos = static_cast<uint32_t>(pos);
     }
 
-    size_t size() const { return event_count_; }
-    bool empty() const { return event_count_ == 0; }
+    void sift_up(size_t pos) {
+        const HeapEntry entry = heap_[pos];
+        while (pos > 0) {
+            const size_t parent = (pos - 1) / ARITY;
+            if (!before(entry, heap_[parent])) {
+                break;
+            }
+            place(pos, heap_[parent]);
+            pos = parent;
+        }
+        place(pos, entry);
+    }
 
-private:
-    std::vector<Event> events_;
-    size_t event_count_;
+    void sift_down(size_t pos) {
+        const HeapEntry entry = heap_[pos];
+        for (;;) {
+            const size_t first = pos * ARITY + 1;
+            if (first >= size_) {
+                break;
+            }
+            const size_t last = std::min(first + ARITY, size_);
+            size_t best = first;
+            for (size_t c = first + 1; c < last; ++c) {
+                if (before(heap_[c], heap_[best])) {
+                    best = c;
+                }
+            }
+            if (!before(heap_[best], entry)) {
+                break;
+            }
+            place(pos, heap_[best]);
+            pos = best;
+        }
+        place(pos, entry);
+    }
+
+    void restore(size_t pos) {
+        if (pos > 0 && before(heap_[pos], heap_[(pos - 1) / ARITY])) {
+            sift_up(pos);
+        } else {
+            sift_down(pos);
+        }
+    }
+
+    // Destroy the event at heap position `pos` and refill the hole with
+    // the last entry
+    void remove_at(size_t pos) {
+        const uint32_t idx = heap_[pos].slot;
+        value(idx).~EventType();
+        Slot& slot = slots_[idx];
+        slot.heap_pos = NIL;
+        ++slot.generation;
+        slot.next_free = free_head_;
+        free_head_ = idx;
+
+        if (pos != --size_) {
+            place(pos, heap_[size_]);
+            restore(pos);
+        }
+    }
 };
 
-class DeterministicEventLoop {
+// Timers plus a priority event queue on one clock. With a simulated clock
+// run() replays timers back to back at CPU speed and returns once idle.
+template<typename Clock = WallClock>
+class BasicDeterministicEventLoop {
 public:
-    DeterministicEventLoop()
-        : timing_wheel_(1024, std::chrono::microseconds(10)),
+    explicit BasicDeterministicEventLoop(Clock clock = Clock(),
+                                         Duration slot_duration = std::chrono::microseconds(10))
+        : timing_wheel_(1024, slot_duration, 1024, std::move(clock)),
           is_running_(false) {}
 
-    uint64_t schedule_at(Timestamp time, std::function<void()> callback) {
-        return timing_wheel_.schedule_at(time, std::move(callback));
+    template<typename F>
+    uint64_t schedule_at(Timestamp time, F&& callback) {
+        return timing_wheel_.schedule_at(time, std::forward<F>(callback));
     }
 
-    uint64_t schedule_after(Duration delay, std::function<void()> callback) {
-        return timing_wheel_.schedule_after(delay, std::move(callback));
+    template<typename F>
+    uint64_t schedule_after(Duration delay, F&& callback) {
+        return timing_wheel_.schedule_after(delay, std::forward<F>(callback));
     }
 
+    using EventHandle = typename PriorityEventQueue<MarketTick, 4096>::Handle;
+
+    // Queue a market event; INVALID_HANDLE (0) when the queue is full
     template<typename T>
-    bool add_event(const T& event, uint64_t priority) {
-        return priority_queue_.push(event, priority);
+    EventHandle add_event(T&& event, uint64_t priority) {
+        return priority_queue_.emplace(priority, std::forward<T>(event));
+    }
+
+    bool cancel_event(EventHandle handle) {
+        return priority_queue_.cancel(handle);
+    }
+
+    bool reprioritize_event(EventHandle handle, uint64_t priority) {
+        return priority_queue_.update_priority(handle, priority);
+    }
+
+    bool cancel_timer(uint64_t timer_handle) {
+        return timing_wheel_.cancel(timer_handle);
     }
 
-    void cancel_event(uint64_t event_id) {
-        timing_wheel_.cancel(event_id);
+    // Called for each queued event, in priority order, after every tick
+    void set_event_handler(InlineFunction<void(const MarketTick&)> handler) {
+        event_handler_ = std::move(handler);
     }
 
     void run() {
@@ -243,26 +762,57 @@ public:
 
         while (is_running_.load(std::memory_order_acquire)) {
 
-            timing_wheel_.tick();
+            if constexpr (Clock::is_simulated) {
+                if (!timing_wheel_.advance_to_next()) {
+                    drain_events();
+                    break;
+                }
+            } else {
+                timing_wheel_.tick();
+            }
 
-            MarketTick tick;
-            while (priority_queue_.pop(tick)) {
+            drain_events();
 
+            if constexpr (!Clock::is_simulated) {
+                __asm__ __volatile__("pause" ::: "memory");
             }
-
-            __asm__ __volatile__("pause" ::: "memory");
         }
+
+        is_running_.store(false, std::memory_order_release);
+    }
+
+    // Process every timer due up to `time` (simulated: instantly)
+    void run_until(Timestamp time) {
+        timing_wheel_.process_until(time);
+        drain_events();
     }
 
     void stop() {
         is_running_.store(false, std::memory_order_release);
     }
 
+    Timestamp now() const { return timing_wheel_.now(); }
+    Clock& clock() { return timing_wheel_.clock(); }
+    BasicTimingWheel<Clock>& timing_wheel() { return timing_wheel_; }
+
 private:
-    TimingWheelScheduler timing_wheel_;
+    BasicTimingWheel<Clock> timing_wheel_;
     PriorityEventQueue<MarketTick, 4096> priority_queue_;
+    InlineFunction<void(const MarketTick&)> event_handler_;
     std::atomic<bool> is_running_;
+
+    void drain_events() {
+        MarketTick tick;
+        while (priority_queue_.pop(tick)) {
+            if (event_handler_) {
+                event_handler_(tick);
+            }
+        }
+    }
 };
 
+using DeterministicEventLoop = BasicDeterministicEventLoop<WallClock>;
+using SimulatedEventLoop = BasicDeterministicEventLoop<SimulatedClock>;
+
 }
 }
\ No newline at end of file
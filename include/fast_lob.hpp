@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <vector>
 
 // Prefetch/branch macros (tiny latency wins on some CPUs)
@@ -122,4 +123,271 @@ private:
 // Benchmarks use `FastLOB` as a convenient concrete type.
 using FastLOB = ArrayBasedOrderBook<100>;
 
+/**
+ * Two-level occupancy bitmap over a fixed tick window.
+ *
+ * One summary word tracks which 64-bit leaf words are non-zero, so the
+ * nearest occupied tick in either direction is at most two clz/ctz ops.
+ */
+template<size_t MaxTicks>
+class TickOccupancyBitmap {
+    static_assert(MaxTicks % 64 == 0, "MaxTicks must be a multiple of 64");
+    static_assert(MaxTicks <= 64 * 64, "Two-level bitmap covers at most 4096 ticks");
+
+public:
+    static constexpr int32_t NONE = -1;
+
+    TickOccupancyBitmap() { clear(); }
+
+    inline void clear() {
+        leaf_.fill(0);
+        summary_ = 0;
+    }
+
+    inline bool empty() const { return summary_ == 0; }
+
+    inline bool test(uint32_t tick) const {
+        return (leaf_[tick >> 6] >> (tick & 63)) & 1;
+    }
+
+    inline void set(uint32_t tick) {
+        const uint32_t w = tick >> 6;
+        leaf_[w] |= uint64_t(1) << (tick & 63);
+        summary_ |= uint64_t(1) << w;
+    }
+
+    inline void reset(uint32_t tick) {
+        const uint32_t w = tick >> 6;
+        leaf_[w] &= ~(uint64_t(1) << (tick & 63));
+        if (leaf_[w] == 0) summary_ &= ~(uint64_t(1) << w);
+    }
+
+    inline int32_t highest() const {
+        return empty() ? NONE : find_high_at_or_below(static_cast<int32_t>(MaxTicks - 1));
+    }
+
+    inline int32_t lowest() const {
+        return empty() ? NONE : find_low_at_or_above(0);
+    }
+
+    inline int32_t find_high_at_or_below(int32_t tick) const {
+        if (tick < 0) return NONE;
+        const uint32_t w = static_cast<uint32_t>(tick) >> 6;
+        const uint32_t b = static_cast<uint32_t>(tick) & 63;
+        const uint64_t mask = (b == 63) ? ~uint64_t(0) : ((uint64_t(2) << b) - 1);
+        const uint64_t in_word = leaf_[w] & mask;
+        if (in_word) {
+            return static_cast<int32_t>((w << 6) + 63 - __builtin_clzll(in_word));
+        }
+        const uint64_t lower = summary_ & ((uint64_t(1) << w) - 1);
+        if (!lower) return NONE;
+        const uint32_t lw = 63 - __builtin_clzll(lower);
+        return static_cast<int32_t>((lw << 6) + 63 - __builtin_clzll(leaf_[lw]));
+    }
+
+    inline int32_t find_low_at_or_above(int32_t tick) const {
+        if (tick >= static_cast<int32_t>(MaxTicks)) return NONE;
+        const uint32_t w = static_cast<uint32_t>(tick) >> 6;
+        const uint32_t b = static_cast<uint32_t>(tick) & 63;
+        const uint64_t in_word = leaf_[w] & (~uint64_t(0) << b);
+        if (in_word) {
+            return static_cast<int32_t>((w << 6) + __builtin_ctzll(in_word));
+        }
+        const uint64_t upper = (w == 63) ? 0 : (summary_ & (~uint64_t(0) << (w + 1)));
+        if (!upper) return NONE;
+        const uint32_t uw = __builtin_ctzll(upper);
+        return static_cast<int32_t>((uw << 6) + __builtin_ctzll(leaf_[uw]));
+    }
+
+private:
+    std::array<uint64_t, MaxTicks / 64> leaf_;
+    uint64_t summary_;
+};
+
+/**
+ * Price-indexed LOB keyed by integer tick offset from a reference price.
+ *
+ * Slot i holds price reference + (i - MaxTicks/2) * tick_size, so the
+ * reference sits mid-window and lookups by price are a subtract + multiply.
+ * Occupancy is a TickOccupancyBitmap, so best bid/ask after a cancel is
+ * found with one clz/ctz per bitmap level instead of scanning the book.
+ * Best prices are tracked incrementally on update.
+ *
+ * Prices outside the window are rejected; call recenter() when the market
+ * drifts out of range (cold path, clears the book).
+ */
+template<size_t MaxTicks = 1024>
+class PriceIndexedOrderBook {
+public:
+    static constexpr int32_t NO_LEVEL = TickOccupancyBitmap<MaxTicks>::NONE;
+
+    PriceIndexedOrderBook(double reference_price, double tick_size)
+        : tick_size_(tick_size), inv_tick_size_(1.0 / tick_size) {
+        recenter(reference_price);
+    }
+
+    // Re-anchor the window and clear all levels.
+    inline void recenter(double reference_price) {
+        base_price_ = reference_price - static_cast<double>(MaxTicks / 2) * tick_size_;
+        clear();
+    }
+
+    inline void clear() {
+        bids_.clear();
+        asks_.clear();
+    }
+
+    // Nearest tick; prices off the window saturate to -1 / MaxTicks, so
+    // in_range() rejects them, and NaN or inf maps to -1. The range check is
+    // done in double: casting an offset outside int32 is undefined.
+    inline int32_t price_to_tick(double price) const {
+        const double offset = (price - base_price_) * inv_tick_size_;
+        uint64_t bits;
+        std::memcpy(&bits, &offset, sizeof(bits));
+        // Exponent bits, not std::isfinite (-ffast-math folds it to true)
+        if (UNLIKELY((bits & 0x7FF0000000000000ull) == 0x7FF0000000000000ull)) return -1;
+        if (UNLIKELY(offset < -0.5)) return -1;
+        if (UNLIKELY(offset >= static_cast<double>(MaxTicks) - 0.5)) return static_cast<int32_t>(MaxTicks);
+        return static_cast<int32_t>(offset + 0.5);
+    }
+
+    inline double tick_to_price(int32_t tick) const {
+        return base_price_ + static_cast<double>(tick) * tick_size_;
+    }
+
+    inline bool in_range(int32_t tick) const {
+        return static_cast<uint32_t>(tick) < MaxTicks;
+    }
+
+    // Set absolute quantity at a price (0 removes the level).
+    // Returns false if the price falls outside the window.
+    inline bool update_bid(double price, double quantity) {
+        return update_bid_tick(price_to_tick(price), quantity);
+    }
+
+    inline bool update_ask(double price, double quantity) {
+        return update_ask_tick(price_to_tick(price), quantity);
+    }
+
+    inline bool update_bid_tick(int32_t tick, double quantity) {
+        if (UNLIKELY(!in_range(tick))) return false;
+        bids_.set(static_cast<uint32_t>(tick), quantity);
+        return true;
+    }
+
+    inline bool update_ask_tick(int32_t tick, double quantity) {
+        if (UNLIKELY(!in_range(tick))) return false;
+        asks_.set(static_cast<uint32_t>(tick), quantity);
+        return true;
+    }
+
+    // O(1) BBO (0.0 when the side is empty, matching ArrayBasedOrderBook).
+    inline double get_best_bid() const {
+        return bids_.best_high >= 0 ? tick_to_price(bids_.best_high) : 0.0;
+    }
+
+    inline double get_best_ask() const {
+        return asks_.best_low >= 0 ? tick_to_price(asks_.best_low) : 0.0;
+    }
+
+    inline int32_t best_bid_tick() const { return bids_.best_high; }
+    inline int32_t best_ask_tick() const { return asks_.best_low; }
+
+    inline double best_bid_quantity() const {
+        return bids_.best_high >= 0 ? bids_.quantity[bids_.best_high] : 0.0;
+    }
+
+    inline double best_ask_quantity() const {
+        return asks_.best_low >= 0 ? asks_.quantity[asks_.best_low] : 0.0;
+    }
+
+    // O(1) lookup by price level.
+    inline double bid_quantity_at(double price) const {
+        const int32_t tick = price_to_tick(price);
+        return in_range(tick) ? bids_.quantity[tick] : 0.0;
+    }
+
+    inline double ask_quantity_at(double price) const {
+        const int32_t tick = price_to_tick(price);
+        return in_range(tick) ? asks_.quantity[tick] : 0.0;
+    }
+
+    // Next occupied level strictly worse than `tick` (NO_LEVEL if none).
+    inline int32_t next_bid_tick(int32_t tick) const {
+        return bids_.occupied.find_high_at_or_below(tick - 1);
+    }
+
+    inline int32_t next_ask_tick(int32_t tick) const {
+        return asks_.occupied.find_low_at_or_above(tick + 1);
+    }
+
+    // Same definition as ArrayBasedOrderBook::calculate_ofi, but over the
+    // top N *occupied* levels walked from the BBO via the bitmap.
+    inline double calculate_ofi(size_t depth_levels) const {
+        double bid_qty = 0.0;
+        double ask_qty = 0.0;
+
+        int32_t tick = bids_.best_high;
+        for (size_t i = 0; i < depth_levels && tick >= 0; ++i) {
+            bid_qty += bids_.quantity[tick];
+            tick = next_bid_tick(tick);
+        }
+
+        tick = asks_.best_low;
+        for (size_t i = 0; i < depth_levels && tick >= 0; ++i) {
+            ask_qty += asks_.quantity[tick];
+            tick = next_ask_tick(tick);
+        }
+
+        const double denom = bid_qty + ask_qty;
+        if (denom <= 0.0) {
+            return 0.0;
+        }
+        return (bid_qty - ask_qty) / denom;
+    }
+
+    inline double tick_size() const { return tick_size_; }
+
+private:
+    struct BookSide {
+        alignas(64) std::array<double, MaxTicks> quantity;
+        TickOccupancyBitmap<MaxTicks> occupied;
+        int32_t best_high;   // Highest occupied tick (best bid)
+        int32_t best_low;    // Lowest occupied tick (best ask)
+
+        inline void clear() {
+            quantity.fill(0.0);
+            occupied.clear();
+            best_high = NO_LEVEL;
+            best_low = NO_LEVEL;
+        }
+
+        inline void set(uint32_t tick, double qty) {
+            PREFETCH_WRITE(&quantity[tick]);
+            const int32_t t = static_cast<int32_t>(tick);
+
+            if (qty > 0.0) {
+                quantity[tick] = qty;
+                occupied.set(tick);
+                if (t > best_high) best_high = t;
+                if (best_low < 0 || t < best_low) best_low = t;
+                return;
+            }
+
+            quantity[tick] = 0.0;
+            if (!occupied.test(tick)) return;
+
+            occupied.reset(tick);
+            if (t == best_high) best_high = occupied.find_high_at_or_below(t);
+            if (t == best_low) best_low = occupied.find_low_at_or_above(t);
+        }
+    };
+
+    double tick_size_;
+    double inv_tick_size_;
+    double base_price_ = 0.0;
+    BookSide bids_;
+    BookSide asks_;
+};
+
 } // namespace hft
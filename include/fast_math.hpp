@@ -0,0 +1,315 @@
+#pragma once
+
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+    #define HFT_FAST_MATH_X86 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define HFT_MATH_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define HFT_MATH_TARGET(isa)
+#endif
+
+namespace hft {
+namespace fast_math {
+
+// ====
+// Polynomial Transcendentals
+// exp, log, tanh and sqrt computed from a few constants (about 250 bytes)
+// instead of megabyte lookup tables that miss in L2/L3 on random inputs.
+// Each function has a scalar form and, on x86, 4-lane AVX2 (exp4 ...) and
+// 8-lane AVX-512 (exp8 ...) forms built for that ISA via target attributes,
+// so they inline into code compiled for it and are callable from runtime
+// dispatched kernels (simd_dispatch.hpp). All forms evaluate the same
+// polynomials; they differ only in FMA rounding.
+//
+// Accuracy, measured against libm over the stated domain (FMA builds):
+//   exp   x clamped to [-708, 709]       relative error < 3.5e-16
+//   log   x positive, normal             relative error < 7e-16
+//   tanh  any x                          absolute error < 4e-16, relative < 7e-16
+//   sqrt  hardware instruction           correctly rounded
+// Outside the domain exp saturates (no 0 or inf). Scalar log hands
+// zero, negative, subnormal and non-finite inputs to std::log; the vector
+// forms require positive normal inputs.
+// ====
+
+namespace detail {
+
+constexpr double LOG2E = 1.4426950408889634;
+constexpr double LN2_HI = 6.93145751953125e-1;             // Low mantissa bits zero: n * LN2_HI is exact
+constexpr double LN2_LO = 1.42860682030941723212e-6;
+constexpr double MIN_EXP_ARG = -708.0;
+constexpr double MAX_EXP_ARG = 709.0;
+constexpr double SQRT2 = 1.4142135623730951;
+constexpr double POW2_52 = 4503599627370496.0;
+// x * LOG2E + ROUND_SHIFT rounds to an integer n in the low mantissa bits,
+// and those bits shifted into the exponent field are 2^n
+constexpr double ROUND_SHIFT = 1.5 * POW2_52 + 1023.0;
+
+// e^r - 1 = r * P(r) for |r| <= ln2/2, P the degree-12 Taylor polynomial
+// (ascending); truncation below 1e-17
+constexpr double EXPM1_COEFFS[] = {
+    1.0, 1.0 / 2.0, 1.0 / 6.0, 1.0 / 24.0, 1.0 / 120.0, 1.0 / 720.0, 1.0 / 5040.0, 1.0 / 40320.0,
+    1.0 / 362880.0, 1.0 / 3628800.0, 1.0 / 39916800.0, 1.0 / 479001600.0, 1.0 / 6227020800.0
+};
+
+// log(m) = 2s * sum(z^k / (2k + 1)), s = (m - 1) / (m + 1), z = s^2,
+// m in [sqrt(1/2), sqrt(2)) so z <= 0.0295; eleven terms leave < 1e-18
+constexpr double LOG_COEFFS[] = {
+    1.0, 1.0 / 3.0, 1.0 / 5.0, 1.0 / 7.0, 1.0 / 9.0, 1.0 / 11.0, 1.0 / 13.0, 1.0 / 15.0,
+    1.0 / 17.0, 1.0 / 19.0, 1.0 / 21.0
+};
+
+// Returns v, but -ffast-math can no longer see through it, so it cannot
+// reassociate arithmetic across it. An empty asm rather than
+// __builtin_assoc_barrier, which GCC drops when it vectorizes the caller.
+inline double assoc_barrier(double v) {
+#if defined(__GNUC__) && defined(__x86_64__)
+    __asm__("" : "+x"(v));
+#elif defined(__GNUC__) && defined(__aarch64__)
+    __asm__("" : "+w"(v));
+#elif defined(__GNUC__)
+    __asm__("" : "+m"(v));
+#endif
+    return v;
+}
+
+// a * b + c, fused where the target has FMA. std::fma is opaque to
+// -ffast-math; the unfused form fences both terms so the reductions and
+// the tanh expm1 sum keep their evaluation order on non-FMA targets.
+inline double fmadd(double a, double b, double c) {
+#if defined(__FMA__) || defined(__aarch64__)
+    return std::fma(a, b, c);
+#else
+    return assoc_barrier(a * b) + assoc_barrier(c);
+#endif
+}
+
+// Both polynomials use Estrin's scheme: a dependency chain of four FMAs
+// instead of Horner's ten to twelve
+inline double expm1_poly(double r) {
+    const double* c = EXPM1_COEFFS;
+    const double r2 = r * r, r4 = r2 * r2, r8 = r4 * r4;
+    const double q0 = fmadd(fmadd(c[3], r, c[2]), r2, fmadd(c[1], r, c[0]));
+    const double q1 = fmadd(fmadd(c[7], r, c[6]), r2, fmadd(c[5], r, c[4]));
+    const double q2 = fmadd(fmadd(c[11], r, c[10]), r2, fmadd(c[9], r, c[8]));
+    return fmadd(fmadd(c[12], r4, q2), r8, fmadd(q1, r4, q0)) * r;
+}
+
+inline double log_poly(double z) {
+    const double* c = LOG_COEFFS;
+    const double z2 = z * z, z4 = z2 * z2, z8 = z4 * z4;
+    const double q0 = fmadd(fmadd(c[3], z, c[2]), z2, fmadd(c[1], z, c[0]));
+    const double q1 = fmadd(fmadd(c[7], z, c[6]), z2, fmadd(c[5], z, c[4]));
+    const double q2 = fmadd(c[10], z2, fmadd(c[9], z, c[8]));
+    return fmadd(q2, z8, fmadd(q1, z4, q0));
+}
+
+// x = n * ln2 + r; returns 2^n and sets q = e^r - 1
+inline double reduce_exp(double x, double& q) {
+    x = x < MIN_EXP_ARG ? MIN_EXP_ARG : (x > MAX_EXP_ARG ? MAX_EXP_ARG : x);
+    // Round explicitly: fast-math folds (x * LOG2E + ROUND_SHIFT) - ROUND_SHIFT
+    // back to x * LOG2E when the add is not fused
+    const double n = std::nearbyint(x * LOG2E);
+    const double t = n + ROUND_SHIFT;                           // Exact: n is an integer
+    q = expm1_poly(fmadd(-n, LN2_LO, fmadd(-n, LN2_HI, x)));
+    uint64_t bits;
+    std::memcpy(&bits, &t, sizeof(bits));
+    bits <<= 52;
+    double scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return scale;
+}
+
+} // namespace detail
+
+inline double exp(double x) {
+    double q;
+    const double scale = detail::reduce_exp(x, q);
+    return detail::fmadd(scale, q, scale);
+}
+
+inline double log(double x) {
+    if (!(x >= DBL_MIN && x <= DBL_MAX)) return std::log(x);     // Cold: outside the domain
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    double e = static_cast<double>(static_cast<int64_t>(bits >> 52) - 1023);
+    bits = (bits & 0x000FFFFFFFFFFFFFull) | 0x3FF0000000000000ull;
+    double m;
+    std::memcpy(&m, &bits, sizeof(m));                            // [1, 2)
+    if (m > detail::SQRT2) {
+        m *= 0.5;
+        e += 1.0;
+    }
+    const double s = (m - 1.0) / (m + 1.0);
+    const double p = detail::log_poly(s * s);
+    return detail::fmadd(e, detail::LN2_HI, detail::fmadd(2.0 * s, p, e * detail::LN2_LO));
+}
+
+// tanh(|x|) = -expm1(-2|x|) / (2 + expm1(-2|x|)); expm1 avoids the
+// cancellation 1 - e^-2x would have near zero
+inline double tanh(double x) {
+    double q;
+    const double scale = detail::reduce_exp(-2.0 * std::fabs(x), q);
+    const double em1 = detail::fmadd(scale, q, scale - 1.0);
+    return std::copysign(-em1 / (2.0 + em1), x);
+}
+
+inline double sqrt(double x) { return std::sqrt(x); }
+
+#if defined(HFT_FAST_MATH_X86)
+
+// ====
+// 4-lane AVX2 + FMA
+// ====
+
+namespace detail {
+
+HFT_MATH_TARGET("avx2,fma") inline __m256d fma4(__m256d a, __m256d b, __m256d c) { return _mm256_fmadd_pd(a, b, c); }
+HFT_MATH_TARGET("avx2,fma") inline __m256d set4(double v) { return _mm256_set1_pd(v); }
+
+HFT_MATH_TARGET("avx2,fma") inline __m256d expm1_poly4(__m256d r) {
+    const double* c = EXPM1_COEFFS;
+    const __m256d r2 = _mm256_mul_pd(r, r), r4 = _mm256_mul_pd(r2, r2), r8 = _mm256_mul_pd(r4, r4);
+    const __m256d q0 = fma4(fma4(set4(c[3]), r, set4(c[2])), r2, fma4(set4(c[1]), r, set4(c[0])));
+    const __m256d q1 = fma4(fma4(set4(c[7]), r, set4(c[6])), r2, fma4(set4(c[5]), r, set4(c[4])));
+    const __m256d q2 = fma4(fma4(set4(c[11]), r, set4(c[10])), r2, fma4(set4(c[9]), r, set4(c[8])));
+    return _mm256_mul_pd(fma4(fma4(set4(c[12]), r4, q2), r8, fma4(q1, r4, q0)), r);
+}
+
+HFT_MATH_TARGET("avx2,fma") inline __m256d log_poly4(__m256d z) {
+    const double* c = LOG_COEFFS;
+    const __m256d z2 = _mm256_mul_pd(z, z), z4 = _mm256_mul_pd(z2, z2), z8 = _mm256_mul_pd(z4, z4);
+    const __m256d q0 = fma4(fma4(set4(c[3]), z, set4(c[2])), z2, fma4(set4(c[1]), z, set4(c[0])));
+    const __m256d q1 = fma4(fma4(set4(c[7]), z, set4(c[6])), z2, fma4(set4(c[5]), z, set4(c[4])));
+    const __m256d q2 = fma4(set4(c[10]), z2, fma4(set4(c[9]), z, set4(c[8])));
+    return fma4(q2, z8, fma4(q1, z4, q0));
+}
+
+HFT_MATH_TARGET("avx2,fma") inline __m256d reduce_exp4(__m256d x, __m256d& q) {
+    x = _mm256_max_pd(_mm256_min_pd(x, set4(MAX_EXP_ARG)), set4(MIN_EXP_ARG));
+    const __m256d t = fma4(x, set4(LOG2E), set4(ROUND_SHIFT));
+    const __m256d n = _mm256_sub_pd(t, set4(ROUND_SHIFT));
+    q = expm1_poly4(_mm256_fnmadd_pd(n, set4(LN2_LO), _mm256_fnmadd_pd(n, set4(LN2_HI), x)));
+    return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_castpd_si256(t), 52));
+}
+
+} // namespace detail
+
+HFT_MATH_TARGET("avx2,fma") inline __m256d exp4(__m256d x) {
+    __m256d q;
+    const __m256d scale = detail::reduce_exp4(x, q);
+    return _mm256_fmadd_pd(scale, q, scale);
+}
+
+HFT_MATH_TARGET("avx2,fma") inline __m256d log4(__m256d x) {
+    const __m256i bits = _mm256_castpd_si256(x);
+    const __m256d magic = _mm256_set1_pd(detail::POW2_52);
+    const __m256i biased = _mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_castpd_si256(magic));
+    __m256d e = _mm256_sub_pd(_mm256_castsi256_pd(biased), _mm256_set1_pd(detail::POW2_52 + 1023.0));
+    __m256d m = _mm256_castsi256_pd(_mm256_or_si256(
+        _mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFll)),
+        _mm256_set1_epi64x(0x3FF0000000000000ll)));
+
+    const __m256d big = _mm256_cmp_pd(m, _mm256_set1_pd(detail::SQRT2), _CMP_GT_OQ);
+    m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), big);
+    e = _mm256_add_pd(e, _mm256_and_pd(big, _mm256_set1_pd(1.0)));
+
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d s = _mm256_div_pd(_mm256_sub_pd(m, one), _mm256_add_pd(m, one));
+    const __m256d p = detail::log_poly4(_mm256_mul_pd(s, s));
+    const __m256d tail = _mm256_fmadd_pd(_mm256_add_pd(s, s), p, _mm256_mul_pd(e, _mm256_set1_pd(detail::LN2_LO)));
+    return _mm256_fmadd_pd(e, _mm256_set1_pd(detail::LN2_HI), tail);
+}
+
+HFT_MATH_TARGET("avx2,fma") inline __m256d tanh4(__m256d x) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d a = _mm256_andnot_pd(sign, x);
+    __m256d q;
+    const __m256d scale = detail::reduce_exp4(_mm256_mul_pd(a, _mm256_set1_pd(-2.0)), q);
+    const __m256d em1 = _mm256_fmadd_pd(scale, q, _mm256_sub_pd(scale, _mm256_set1_pd(1.0)));
+    const __m256d t = _mm256_div_pd(_mm256_sub_pd(_mm256_setzero_pd(), em1), _mm256_add_pd(em1, _mm256_set1_pd(2.0)));
+    return _mm256_or_pd(t, _mm256_and_pd(x, sign));
+}
+
+HFT_MATH_TARGET("avx2,fma") inline __m256d sqrt4(__m256d x) { return _mm256_sqrt_pd(x); }
+
+// ====
+// 8-lane AVX-512F
+// ====
+
+namespace detail {
+
+HFT_MATH_TARGET("avx512f") inline __m512d fma8(__m512d a, __m512d b, __m512d c) { return _mm512_fmadd_pd(a, b, c); }
+HFT_MATH_TARGET("avx512f") inline __m512d set8(double v) { return _mm512_set1_pd(v); }
+
+HFT_MATH_TARGET("avx512f") inline __m512d expm1_poly8(__m512d r) {
+    const double* c = EXPM1_COEFFS;
+    const __m512d r2 = _mm512_mul_pd(r, r), r4 = _mm512_mul_pd(r2, r2), r8 = _mm512_mul_pd(r4, r4);
+    const __m512d q0 = fma8(fma8(set8(c[3]), r, set8(c[2])), r2, fma8(set8(c[1]), r, set8(c[0])));
+    const __m512d q1 = fma8(fma8(set8(c[7]), r, set8(c[6])), r2, fma8(set8(c[5]), r, set8(c[4])));
+    const __m512d q2 = fma8(fma8(set8(c[11]), r, set8(c[10])), r2, fma8(set8(c[9]), r, set8(c[8])));
+    return _mm512_mul_pd(fma8(fma8(set8(c[12]), r4, q2), r8, fma8(q1, r4, q0)), r);
+}
+
+HFT_MATH_TARGET("avx512f") inline __m512d log_poly8(__m512d z) {
+    const double* c = LOG_COEFFS;
+    const __m512d z2 = _mm512_mul_pd(z, z), z4 = _mm512_mul_pd(z2, z2), z8 = _mm512_mul_pd(z4, z4);
+    const __m512d q0 = fma8(fma8(set8(c[3]), z, set8(c[2])), z2, fma8(set8(c[1]), z, set8(c[0])));
+    const __m512d q1 = fma8(fma8(set8(c[7]), z, set8(c[6])), z2, fma8(set8(c[5]), z, set8(c[4])));
+    const __m512d q2 = fma8(set8(c[10]), z2, fma8(set8(c[9]), z, set8(c[8])));
+    return fma8(q2, z8, fma8(q1, z4, q0));
+}
+
+HFT_MATH_TARGET("avx512f") inline __m512d reduce_exp8(__m512d x, __m512d& q) {
+    x = _mm512_max_pd(_mm512_min_pd(x, set8(MAX_EXP_ARG)), set8(MIN_EXP_ARG));
+    const __m512d t = fma8(x, set8(LOG2E), set8(ROUND_SHIFT));
+    const __m512d n = _mm512_sub_pd(t, set8(ROUND_SHIFT));
+    q = expm1_poly8(_mm512_fnmadd_pd(n, set8(LN2_LO), _mm512_fnmadd_pd(n, set8(LN2_HI), x)));
+    return _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_castpd_si512(t), 52));
+}
+
+} // namespace detail
+
+HFT_MATH_TARGET("avx512f") inline __m512d exp8(__m512d x) {
+    __m512d q;
+    const __m512d scale = detail::reduce_exp8(x, q);
+    return _mm512_fmadd_pd(scale, q, scale);
+}
+
+HFT_MATH_TARGET("avx512f") inline __m512d log8(__m512d x) {
+    __m512d e = _mm512_getexp_pd(x);
+    __m512d m = _mm512_getmant_pd(x, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_src);     // [1, 2)
+    const __mmask8 big = _mm512_cmp_pd_mask(m, _mm512_set1_pd(detail::SQRT2), _CMP_GT_OQ);
+    m = _mm512_mask_mul_pd(m, big, m, _mm512_set1_pd(0.5));
+    e = _mm512_mask_add_pd(e, big, e, _mm512_set1_pd(1.0));
+
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d s = _mm512_div_pd(_mm512_sub_pd(m, one), _mm512_add_pd(m, one));
+    const __m512d p = detail::log_poly8(_mm512_mul_pd(s, s));
+    const __m512d tail = _mm512_fmadd_pd(_mm512_add_pd(s, s), p, _mm512_mul_pd(e, _mm512_set1_pd(detail::LN2_LO)));
+    return _mm512_fmadd_pd(e, _mm512_set1_pd(detail::LN2_HI), tail);
+}
+
+HFT_MATH_TARGET("avx512f") inline __m512d tanh8(__m512d x) {
+    const __m512d a = _mm512_abs_pd(x);
+    __m512d q;
+    const __m512d scale = detail::reduce_exp8(_mm512_mul_pd(a, _mm512_set1_pd(-2.0)), q);
+    const __m512d em1 = _mm512_fmadd_pd(scale, q, _mm512_sub_pd(scale, _mm512_set1_pd(1.0)));
+    const __m512d t = _mm512_div_pd(_mm512_sub_pd(_mm512_setzero_pd(), em1), _mm512_add_pd(em1, _mm512_set1_pd(2.0)));
+    const __m512i sign = _mm512_and_epi64(_mm512_castpd_si512(x), _mm512_set1_epi64(INT64_MIN));
+    return _mm512_castsi512_pd(_mm512_or_epi64(_mm512_castpd_si512(t), sign));
+}
+
+HFT_MATH_TARGET("avx512f") inline __m512d sqrt8(__m512d x) { return _mm512_sqrt_pd(x); }
+
+#endif
+
+} // namespace fast_math
+} // namespace hft
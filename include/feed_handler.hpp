@@ -0,0 +1,287 @@
+#pragma once
+
+#include "zero_copy_decoder.hpp"
+#include "order_book_reconstructor.hpp"
+#include "custom_nic_driver.hpp"
+#include "solarflare_efvi.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace hft {
+
+// Wire order book updates are applied by the backends in place
+template<>
+struct UpdateFields<zerocopy::BinaryOrderBookUpdate> {
+    using Msg = zerocopy::BinaryOrderBookUpdate;
+
+    static UpdateType type(const Msg& m) {
+        // 0=ADD, 1=MODIFY, 2=DELETE, 3=EXECUTE; anything else is rejected
+        return m.update_type <= 3 ? static_cast<UpdateType>(m.update_type)
+                                  : UpdateType::SNAPSHOT;
+    }
+    static uint64_t order_id(const Msg& m) { return m.order_id; }
+    static double price(const Msg& m) { return m.price; }
+    static double quantity(const Msg& m) { return m.quantity; }
+    static bool is_bid(const Msg& m) { return m.side == 0; }
+    static uint64_t sequence_number(const Msg& m) { return m.header.sequence_number; }
+    static int64_t timestamp_ns(const Msg& m) { return static_cast<int64_t>(m.header.timestamp_ns); }
+};
+
+namespace feed {
+
+// ====
+// Zero-Copy Feed Handler
+// NIC RX ring -> in-place message decode -> order book, no intermediate copies
+// ====
+
+struct FeedHandlerStats {
+    uint64_t packets = 0;
+    uint64_t messages = 0;
+    uint64_t book_updates = 0;          // Applied to the book
+    uint64_t rejected_updates = 0;      // Book refused (unknown order, out of range)
+    uint64_t recovery_drops = 0;        // Skipped while waiting for a snapshot
+    uint64_t recovery_buffered = 0;     // Held for replay by a background recovery
+    uint64_t trades = 0;
+    uint64_t quotes = 0;
+    uint64_t filtered = 0;              // Other symbols
+    uint64_t unknown_messages = 0;
+    uint64_t malformed = 0;             // Truncated packets or short messages
+    uint64_t sequence_gaps = 0;
+    uint64_t missed_messages = 0;
+    uint64_t stale_messages = 0;        // Duplicates / out-of-order, dropped
+};
+
+// Book is a BasicOrderBookReconstructor<Backend>. One handler per feed
+// thread; the book is only mutated from that thread.
+//
+// Packets carry one or more back-to-back messages, each starting with a
+// BinaryMessageHeader whose message_length covers the whole message. The
+// sequence number is feed-wide (book, trade and quote messages share it),
+// so the handler owns gap detection and reports gaps to the book, which
+// then raises needs_snapshot_recovery(). Book updates are dropped until the
+// caller reinitializes the book from a snapshot and calls
+// reset_gap_detection(); updates already covered by that snapshot are skipped.
+// With book.enable_async_recovery() they are buffered instead, and the book
+// swaps in the recovered state itself once recover_from_snapshot() has run.
+template<typename Book>
+class ZeroCopyFeedHandler {
+public:
+    using TradeCallback = std::function<void(const zerocopy::BinaryTradeMessage&)>;
+    using QuoteCallback = std::function<void(const zerocopy::BinaryQuoteMessage&)>;
+
+    // Ethernet (14) + IPv4 (20) + UDP (8), as in CustomPacketFilter
+    static constexpr size_t UDP_PAYLOAD_OFFSET = 42;
+    static constexpr size_t DEFAULT_BURST = 32;
+
+    // symbol_id 0 accepts every symbol
+    explicit ZeroCopyFeedHandler(Book& book, uint32_t symbol_id = 0,
+                                 size_t payload_offset = UDP_PAYLOAD_OFFSET)
+        : book_(book), symbol_id_(symbol_id), payload_offset_(payload_offset) {}
+
+    void set_trade_callback(TradeCallback cb) { on_trade_ = std::move(cb); }
+    void set_quote_callback(QuoteCallback cb) { on_quote_ = std::move(cb); }
+
+    // Drain up to max_packets from the NIC in rx_burst()s; returns packets handled
+    size_t poll(hardware::CustomNICDriver& nic, size_t max_packets = DEFAULT_BURST) {
+        hardware::RxPacket burst[DEFAULT_BURST];
+        size_t total = 0;
+        while (total < max_packets) {
+            const size_t want = std::min(DEFAULT_BURST, max_packets - total);
+            const size_t n = nic.rx_burst(burst, want);
+            for (size_t i = 0; i < n; ++i) {
+                on_frame(burst[i].data, burst[i].len);
+            }
+            total += n;
+            if (n < want) break;
+        }
+        return total;
+    }
+
+    size_t poll(network::SolarflareEFVI& vi, size_t max_packets = DEFAULT_BURST) {
+        size_t total = 0;
+        while (total < max_packets) {
+            const size_t want = std::min(DEFAULT_BURST, max_packets - total);
+            const size_t n = vi.rx_burst(efvi_burst_.get(), want);
+            for (size_t i = 0; i < n; ++i) {
+                on_frame(efvi_burst_[i].data, efvi_burst_[i].len);
+            }
+            total += n;
+            if (n < want) break;
+        }
+        return total;
+    }
+
+    // Raw frame as delivered by the NIC (headers still attached)
+    void on_frame(const uint8_t* frame, size_t len) {
+        if (UNLIKELY(len < payload_offset_)) {
+            ++stats_.packets;
+            ++stats_.malformed;
+            return;
+        }
+        on_payload(frame + payload_offset_, len - payload_offset_);
+    }
+
+    // UDP payload: walk every message in the packet
+    void on_payload(const uint8_t* data, size_t len) {
+        ++stats_.packets;
+
+        while (len > 0) {
+            if (UNLIKELY(!zerocopy::ZeroCopyDecoder::validate_header(data, len))) {
+                ++stats_.malformed;
+                return;
+            }
+
+            const auto* header = reinterpret_cast<const zerocopy::BinaryMessageHeader*>(data);
+            const size_t msg_len = header->message_length;
+            if (UNLIKELY(msg_len < sizeof(zerocopy::BinaryMessageHeader))) {
+                ++stats_.malformed;  // Would never advance
+                return;
+            }
+
+            ++stats_.messages;
+            if (LIKELY(track_sequence(header->sequence_number))) {
+                // validate_header() bounds message_type to the table size
+                (this->*DISPATCH[header->message_type])(data, msg_len);
+            }
+
+            data += msg_len;
+            len -= msg_len;
+        }
+    }
+
+    // Next sequence number expected on the feed (0 before the first message)
+    uint64_t expected_sequence() const { return next_sequence_; }
+
+    const FeedHandlerStats& stats() const { return stats_; }
+
+private:
+    using Handler = void (ZeroCopyFeedHandler::*)(const uint8_t*, size_t);
+    static constexpr size_t NUM_MESSAGE_TYPES = 256;
+
+    Book& book_;
+    uint32_t symbol_id_;
+    size_t payload_offset_;
+    uint64_t next_sequence_ = 0;
+    FeedHandlerStats stats_;
+    TradeCallback on_trade_;
+    QuoteCallback on_quote_;
+    // ef_vi copies frames out; one burst of buffers, allocated once
+    std::unique_ptr<network::efvi_packet[]> efvi_burst_{new network::efvi_packet[DEFAULT_BURST]()};
+
+    // Returns false for stale messages (already seen)
+    bool track_sequence(uint64_t sequence) {
+        if (LIKELY(sequence == next_sequence_ || next_sequence_ == 0)) {
+            next_sequence_ = sequence + 1;
+            return true;
+        }
+        if (sequence < next_sequence_) {
+            ++stats_.stale_messages;
+            return false;
+        }
+
+        const uint64_t missed = sequence - next_sequence_;
+        ++stats_.sequence_gaps;
+        stats_.missed_messages += missed;
+        book_.report_gap(missed, sequence);
+        next_sequence_ = sequence + 1;
+        return true;
+    }
+
+    bool accept_symbol(uint32_t symbol_id) {
+        if (symbol_id_ == 0 || symbol_id == symbol_id_) {
+            return true;
+        }
+        ++stats_.filtered;
+        return false;
+    }
+
+    void handle_book_update(const uint8_t* data, size_t len) {
+        if (UNLIKELY(len < sizeof(zerocopy::BinaryOrderBookUpdate))) {
+            ++stats_.malformed;
+            return;
+        }
+        const auto* msg = zerocopy::ZeroCopyDecoder::parse_order_book_update(data);
+        if (!accept_symbol(msg->symbol_id)) {
+            return;
+        }
+
+        if (UNLIKELY(book_.needs_snapshot_recovery() && !book_.poll_recovery())) {
+            if (book_.buffer_update(*msg)) {
+                ++stats_.recovery_buffered;
+            } else {
+                ++stats_.recovery_drops;
+            }
+            return;
+        }
+        const uint64_t book_sequence = book_.last_sequence_number();
+        if (UNLIKELY(book_sequence != 0 && msg->header.sequence_number <= book_sequence)) {
+            ++stats_.recovery_drops;
+            return;
+        }
+
+        if (LIKELY(book_.apply_update(*msg))) {
+            ++stats_.book_updates;
+        } else {
+            ++stats_.rejected_updates;
+        }
+    }
+
+    void handle_trade(const uint8_t* data, size_t len) {
+        if (UNLIKELY(len < sizeof(zerocopy::BinaryTradeMessage))) {
+            ++stats_.malformed;
+            return;
+        }
+        const auto* msg = zerocopy::ZeroCopyDecoder::parse_trade(data);
+        if (!accept_symbol(msg->symbol_id)) {
+            return;
+        }
+        ++stats_.trades;
+        if (on_trade_) {
+            on_trade_(*msg);
+        }
+    }
+
+    void handle_quote(const uint8_t* data, size_t len) {
+        if (UNLIKELY(len < sizeof(zerocopy::BinaryQuoteMessage))) {
+            ++stats_.malformed;
+            return;
+        }
+        const auto* msg = zerocopy::ZeroCopyDecoder::parse_quote(data);
+        if (!accept_symbol(msg->symbol_id)) {
+            return;
+        }
+        ++stats_.quotes;
+        if (on_quote_) {
+            on_quote_(*msg);
+        }
+    }
+
+    void handle_unknown(const uint8_t*, size_t) {
+        ++stats_.unknown_messages;
+    }
+
+    // message_type -> handler, built at compile time (one indirect call per
+    // message instead of a switch)
+    static constexpr std::array<Handler, NUM_MESSAGE_TYPES> make_dispatch_table() {
+        std::array<Handler, NUM_MESSAGE_TYPES> table{};
+        for (size_t i = 0; i < NUM_MESSAGE_TYPES; ++i) {
+            table[i] = &ZeroCopyFeedHandler::handle_unknown;
+        }
+        table[static_cast<size_t>(zerocopy::MessageType::ORDER_BOOK_UPDATE)] =
+            &ZeroCopyFeedHandler::handle_book_update;
+        table[static_cast<size_t>(zerocopy::MessageType::TRADE)] =
+            &ZeroCopyFeedHandler::handle_trade;
+        table[static_cast<size_t>(zerocopy::MessageType::QUOTE)] =
+            &ZeroCopyFeedHandler::handle_quote;
+        return table;
+    }
+
+    static constexpr std::array<Handler, NUM_MESSAGE_TYPES> DISPATCH = make_dispatch_table();
+};
+
+} // namespace feed
+} // namespace hft
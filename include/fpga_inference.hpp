@@ -2,6 +2,9 @@
 
 #include "spin_loop_engine.hpp"
 #include "simd_features.hpp"
+#include "batched_inference.hpp"
+#include "model_file.hpp"
+#include <algorithm>
 
 namespace hft {
 
@@ -51,16 +54,47 @@ public:
     static constexpr size_t HIDDEN_DIM = 8;
     static constexpr size_t OUTPUT_DIM = 3;
 
-    explicit FPGA_DNN_Inference()
-        : fixed_latency_ns_(400) {
+    static constexpr size_t BATCH_TILE = BatchedMLP<INPUT_DIM, HIDDEN_DIM, OUTPUT_DIM>::TILE;
+
+    using Network = NetworkDef<DenseLayer<INPUT_DIM, HIDDEN_DIM>, DenseLayer<HIDDEN_DIM, OUTPUT_DIM>>;
+
+    /**
+     * @param pad_latency Busy-wait every predict() to fixed_latency_ns_ to
+     *                    model the FPGA's deterministic latency. Throughput
+     *                    callers (backtests, software fallback) can turn it off.
+     */
+    explicit FPGA_DNN_Inference(bool pad_latency = true)
+        : fixed_latency_ns_(400), pad_latency_(pad_latency) {
 
         // Initialize weights with random values (simulation)
         for (auto& w : weights_h_) w = (std::rand() % 200 - 100) / 1000.0;
         for (auto& b : bias_h_) b = 0.0;
         for (auto& w : weights_o_) w = (std::rand() % 200 - 100) / 1000.0;
         bias_o_.fill(0.0);
+
+        batched_.load(weights_h_.data(), bias_h_.data(), weights_o_.data(), bias_o_.data(),
+                      InferenceActivation::RELU);
+    }
+
+    explicit FPGA_DNN_Inference(const std::string& model_path, bool pad_latency = true)
+        : fixed_latency_ns_(400), pad_latency_(pad_latency) {
+        load_model(MappedModel(model_path));
     }
 
+    // Replace the simulated weights with a trained model (throws on shape mismatch)
+    void load_model(const MappedModel& model) {
+        model.require<Network>();
+        std::memcpy(weights_h_.data(), model.weights(0), sizeof(weights_h_));
+        std::memcpy(bias_h_.data(), model.bias(0), sizeof(bias_h_));
+        std::memcpy(weights_o_.data(), model.weights(1), sizeof(weights_o_));
+        std::memcpy(bias_o_.data(), model.bias(1), sizeof(bias_o_));
+        batched_.load(weights_h_.data(), bias_h_.data(), weights_o_.data(), bias_o_.data(),
+                      InferenceActivation::RELU);
+    }
+
+    void set_latency_padding(bool enabled) { pad_latency_ = enabled; }
+    bool latency_padding() const { return pad_latency_; }
+
     std::array<double, 3> predict(const MicrostructureFeatures& features) {
         const Timestamp start = now();
 
@@ -68,6 +102,9 @@ public:
         features.fill_array(input);
 
         auto output = forward_pass(input);
+        if (!pad_latency_) {
+            return output;
+        }
 
         const Timestamp end = now();
         const int64_t elapsed_ns = to_nanos(end) - to_nanos(start);
@@ -85,6 +122,31 @@ public:
         return output;
     }
 
+    /**
+     * Score many feature rows per call (GEMM-style tiles, no latency
+     * padding). FP32 tracks predict() to float rounding; INT8 uses the
+     * quantized weights.
+     */
+    void predict_batch(const MicrostructureFeatures* features, size_t count,
+                       std::array<double, 3>* out,
+                       InferencePrecision precision = InferencePrecision::FP32) const {
+        alignas(64) std::array<double, BATCH_TILE * INPUT_DIM> rows;
+        alignas(64) std::array<double, BATCH_TILE * OUTPUT_DIM> probabilities;
+        std::array<double, INPUT_DIM> row;
+
+        for (size_t base = 0; base < count; base += BATCH_TILE) {
+            const size_t n = std::min(BATCH_TILE, count - base);
+            for (size_t r = 0; r < n; ++r) {
+                features[base + r].fill_array(row);
+                std::copy(row.begin(), row.end(), rows.begin() + r * INPUT_DIM);
+            }
+            batched_.forward(rows.data(), n, probabilities.data(), precision);
+            for (size_t r = 0; r < n; ++r) {
+                std::copy_n(probabilities.begin() + r * OUTPUT_DIM, OUTPUT_DIM, out[base + r].begin());
+            }
+        }
+    }
+
     int64_t get_fixed_latency_ns() const {
         return fixed_latency_ns_;
     }
@@ -143,6 +205,30 @@ public:
         return features;
     }
 
+    /**
+     * Feature-engine and momentum state plus the weights in use, so a
+     * restored engine scores exactly as the one that was saved
+     */
+    void save_state(checkpoint::StateWriter& out) const {
+        fast_engine_.save_state(out);
+        out.put(last_mid_price_);
+        out.put(weights_h_);
+        out.put(bias_h_);
+        out.put(weights_o_);
+        out.put(bias_o_);
+    }
+
+    void restore_state(checkpoint::StateReader& in) {
+        fast_engine_.restore_state(in);
+        in.get(last_mid_price_);
+        in.get(weights_h_);
+        in.get(bias_h_);
+        in.get(weights_o_);
+        in.get(bias_o_);
+        batched_.load(weights_h_.data(), bias_h_.data(), weights_o_.data(), bias_o_.data(),
+                      InferenceActivation::RELU);
+    }
+
 private:
     hft::simd_features::FastFeatureEngine fast_engine_;
     double last_mid_price_ = 0.0;
@@ -202,6 +288,8 @@ private:
     }
 
     int64_t fixed_latency_ns_;
+    bool pad_latency_;
+    BatchedMLP<INPUT_DIM, HIDDEN_DIM, OUTPUT_DIM> batched_;
     alignas(64) std::array<double, HIDDEN_DIM * INPUT_DIM> weights_h_;
     alignas(64) std::array<double, HIDDEN_DIM> bias_h_;
     alignas(64) std::array<double, OUTPUT_DIM * HIDDEN_DIM> weights_o_;
@@ -22,14 +22,18 @@
 
 #include "common_types.hpp"
 #include "fpga_inference.hpp"
+#include "tsc_clock.hpp"
 #include <atomic>
 #include <memory>
 #include <optional>
 #include <chrono>
+#include <array>
+#include <type_traits>
 
 // Use hft namespace for types
 using hft::MicrostructureFeatures;
 using hft::FPGA_DNN_Inference;
+using hft::InferencePrecision;
 
 // Hardware acceleration modes
 enum class AcceleratorMode {
@@ -58,6 +62,32 @@ struct HardwareLatencyStats {
     uint64_t software_fallbacks;
 };
 
+// Who produced an asynchronous result
+enum class CompletionSource : uint8_t {
+    HARDWARE,           // Accelerator completion ring
+    SOFTWARE,           // Software stub mode
+    SOFTWARE_FALLBACK,  // Hybrid mode, hardware missed the deadline
+    FAILED              // Hardware-only mode, deadline missed; prediction is 0
+};
+
+// Request descriptor the accelerator reads by DMA; line aligned, two lines
+struct alignas(64) InferenceRequest {
+    uint64_t request_id;
+    uint64_t submit_tsc;                // now_tsc() at submit, for deadline and latency
+    MicrostructureFeatures features;
+};
+
+// Completion entry, tagged with the request it answers
+struct InferenceCompletion {
+    uint64_t request_id;
+    double prediction;                  // Primary signal, as predict() returns
+    double latency_ns;                  // Submit to poll that delivered it
+    CompletionSource source;
+};
+
+static_assert(std::is_trivially_copyable<InferenceRequest>::value, "request descriptors are DMA'd");
+static_assert(sizeof(InferenceRequest) == 128, "request descriptor is two cache lines");
+
 // Hardware-in-the-Loop Bridge
 
 class HardwareInTheLoopBridge {
@@ -74,7 +104,9 @@ public:
         , hardware_failures_(0)
         , software_fallbacks_(0)
         , latency_sum_ns_(0.0)
+        , max_latency_ns_(0.0)
     {
+        set_completion_timeout_ns(DEFAULT_COMPLETION_TIMEOUT_NS);
     }
 
     // Initialize bridge and underlying accelerator
@@ -107,7 +139,7 @@ public:
     // Predict signal with automatic routing to software/hardware
     // This is the ONLY method strategy code should call
     double predict(const MicrostructureFeatures& features) {
-        const auto start = std::chrono::steady_clock::now();
+        const uint64_t start = hft::now_tsc();
         
         double prediction = 0.0;
         bool success = false;
@@ -139,15 +171,151 @@ public:
         }
         
         // Track latency statistics
-        const auto end = std::chrono::steady_clock::now();
-        const double latency_ns = std::chrono::duration<double, std::nano>(end - start).count();
-        
-        update_latency_stats(latency_ns);
+        update_latency_stats(elapsed_ns(start, hft::now_tsc()));
         total_inferences_.fetch_add(1, std::memory_order_relaxed);
         
         return prediction;
     }
 
+    // Batched predict for throughput callers (backtests, replay): writes the
+    // primary signal of each row to out[i]. Software rows, in stub mode or
+    // as hybrid fallback, are scored with one predict_batch call per tile.
+    void predict_batch(const MicrostructureFeatures* features, size_t count, double* out,
+                       InferencePrecision precision = InferencePrecision::FP32) {
+        if (count == 0) return;
+        const uint64_t start = hft::now_tsc();
+        const AcceleratorMode mode = mode_.load(std::memory_order_acquire);
+        constexpr size_t TILE = FPGA_DNN_Inference::BATCH_TILE;
+
+        std::array<MicrostructureFeatures, TILE> pending;
+        std::array<size_t, TILE> pending_index;
+        std::array<std::array<double, 3>, TILE> scored;
+
+        for (size_t base = 0; base < count; base += TILE) {
+            const size_t n = std::min(TILE, count - base);
+            size_t waiting = 0;
+
+            for (size_t r = 0; r < n; ++r) {
+                const size_t i = base + r;
+                if (mode == AcceleratorMode::SOFTWARE_STUB) {
+                    pending[waiting] = features[i];
+                    pending_index[waiting++] = i;
+                } else if (!predict_hardware(features[i], out[i])) {
+                    if (mode == AcceleratorMode::HARDWARE_FPGA) {
+                        hardware_failures_.fetch_add(1, std::memory_order_relaxed);
+                        status_.store(HardwareStatus::FAILED, std::memory_order_release);
+                        out[i] = 0.0;
+                    } else {
+                        software_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+                        pending[waiting] = features[i];
+                        pending_index[waiting++] = i;
+                    }
+                }
+            }
+
+            software_inference_->predict_batch(pending.data(), waiting, scored.data(), precision);
+            for (size_t r = 0; r < waiting; ++r) {
+                out[pending_index[r]] = scored[r][0];
+            }
+        }
+
+        update_latency_stats(elapsed_ns(start, hft::now_tsc()) / count, count);
+        total_inferences_.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    // 
+    // Asynchronous Interface (Submit / Poll)
+    // 
+    //
+    // submit() writes a descriptor into the request ring and rings the
+    // doorbell; poll() drains the completion ring. Up to QUEUE_DEPTH
+    // requests stay in flight, so the caller can quote one symbol while
+    // the accelerator scores the next. A request the hardware has not
+    // answered within the completion timeout is scored in software
+    // (HYBRID_FALLBACK) or completed as FAILED (HARDWARE_FPGA); in
+    // SOFTWARE_STUB mode poll() scores everything pending in one batch.
+    // Late hardware completions for such requests are dropped.
+    //
+    // submit() and poll() belong to one thread; the rings hold no locks.
+    //
+    //   const uint64_t id = bridge.submit(features_for(next_symbol));
+    //   quote(current_symbol);
+    //   n = bridge.poll(done.data(), done.size());
+    
+    static constexpr size_t QUEUE_DEPTH = 64;
+    static constexpr double DEFAULT_COMPLETION_TIMEOUT_NS = 5000.0;
+    static constexpr uint64_t INVALID_REQUEST = 0;
+
+    static_assert((QUEUE_DEPTH & (QUEUE_DEPTH - 1)) == 0, "QUEUE_DEPTH must be power of 2");
+
+    // Queue one inference; returns its id, or INVALID_REQUEST while the
+    // ring slot it would take is still in flight or QUEUE_DEPTH results
+    // are waiting to be polled (poll, then retry)
+    uint64_t submit(const MicrostructureFeatures& features) {
+        const uint64_t id = next_request_id_;
+        const size_t slot = id & (QUEUE_DEPTH - 1);
+        if (slot_owner_[slot] != INVALID_REQUEST ||
+            in_flight_ + (completion_tail_ - completion_head_) >= QUEUE_DEPTH) {
+            return INVALID_REQUEST;
+        }
+
+        InferenceRequest& request = request_ring_[slot];
+        request.request_id = id;
+        request.submit_tsc = hft::now_tsc();
+        request.features = features;
+        slot_owner_[slot] = id;
+        ++next_request_id_;
+        ++in_flight_;
+
+        const AcceleratorMode mode = mode_.load(std::memory_order_acquire);
+        if (mode != AcceleratorMode::SOFTWARE_STUB) {
+            ring_doorbell(request);
+        }
+        return id;
+    }
+
+    // Move up to `max_completions` results into `out`, oldest first within
+    // each source; returns how many were written
+    size_t poll(InferenceCompletion* out, size_t max_completions) {
+        const uint64_t now = hft::now_tsc();
+        if (in_flight_ > 0) {
+            const AcceleratorMode mode = mode_.load(std::memory_order_acquire);
+            if (mode != AcceleratorMode::SOFTWARE_STUB) {
+                reap_hardware_completions(now);
+            }
+            if (in_flight_ > 0) {
+                serve_in_software(mode, now);
+            }
+        }
+
+        size_t n = 0;
+        while (n < max_completions && completion_head_ != completion_tail_) {
+            out[n++] = completion_ring_[completion_head_ & (QUEUE_DEPTH - 1)];
+            ++completion_head_;
+        }
+        return n;
+    }
+
+    // Requests submitted and not yet answered
+    size_t in_flight() const { return in_flight_; }
+
+    // Deadline for a hardware answer before the per-request fallback
+    void set_completion_timeout_ns(double timeout_ns) {
+        const auto& clock = hft::tsc::ClockService::instance();
+        // In fallback mode now_tsc() already counts nanoseconds
+        const double ns_per_tick = clock.tsc_enabled() ? clock.ns_per_cycle() : 1.0;
+        timeout_ticks_ = static_cast<uint64_t>(timeout_ns / ns_per_tick);
+    }
+
+    // Software path precision for poll(); predict() is unaffected
+    void set_async_precision(InferencePrecision precision) { async_precision_ = precision; }
+
+    // The stub pads predict() to the FPGA's fixed latency by default;
+    // disable for throughput-oriented software fallback
+    void set_software_latency_padding(bool enabled) {
+        software_inference_->set_latency_padding(enabled);
+    }
+
     // 
     // Hardware Management
     // 
@@ -219,14 +387,114 @@ private:
         return false;
     }
     
+    // 
+    // Asynchronous Rings
+    // 
+    
+    // Publish a descriptor to the accelerator (BAR doorbell write with the
+    // ring tail in production)
+    void ring_doorbell(const InferenceRequest& request) {
+        (void)request;
+    }
+
+    // Read one entry the accelerator DMA'd into its completion ring
+    bool read_hardware_completion(uint64_t& request_id, double& prediction) {
+        (void)request_id;
+        (void)prediction;
+        return false;
+    }
+
+    void reap_hardware_completions(uint64_t now) {
+        uint64_t id;
+        double prediction;
+        while (read_hardware_completion(id, prediction)) {
+            const size_t slot = id & (QUEUE_DEPTH - 1);
+            if (slot_owner_[slot] == id) {      // Else already resolved by timeout
+                complete(slot, prediction, CompletionSource::HARDWARE, now);
+            }
+        }
+    }
+
+    // Stub mode: everything in flight. Hardware modes: requests past their
+    // deadline. Requests are scanned in submit order, so the first one
+    // still inside its deadline ends the scan.
+    void serve_in_software(AcceleratorMode mode, uint64_t now) {
+        constexpr size_t TILE = FPGA_DNN_Inference::BATCH_TILE;
+        std::array<MicrostructureFeatures, TILE> pending;
+        std::array<size_t, TILE> pending_slot;
+        std::array<std::array<double, 3>, TILE> scored;
+        size_t waiting = 0;
+
+        const CompletionSource source = mode == AcceleratorMode::SOFTWARE_STUB
+            ? CompletionSource::SOFTWARE : CompletionSource::SOFTWARE_FALLBACK;
+
+        auto flush = [&]() {
+            software_inference_->predict_batch(pending.data(), waiting, scored.data(), async_precision_);
+            for (size_t r = 0; r < waiting; ++r) {
+                complete(pending_slot[r], scored[r][0], source, now);
+            }
+            waiting = 0;
+        };
+
+        for (uint64_t id = oldest_request_id_; id < next_request_id_; ++id) {
+            const size_t slot = id & (QUEUE_DEPTH - 1);
+            if (slot_owner_[slot] != id) continue;
+
+            if (mode != AcceleratorMode::SOFTWARE_STUB) {
+                if (now - request_ring_[slot].submit_tsc < timeout_ticks_) break;
+                if (mode == AcceleratorMode::HARDWARE_FPGA) {
+                    hardware_failures_.fetch_add(1, std::memory_order_relaxed);
+                    status_.store(HardwareStatus::FAILED, std::memory_order_release);
+                    complete(slot, 0.0, CompletionSource::FAILED, now);
+                    continue;
+                }
+                software_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+                status_.store(HardwareStatus::DEGRADED, std::memory_order_release);
+            }
+
+            pending[waiting] = request_ring_[slot].features;
+            pending_slot[waiting++] = slot;
+            if (waiting == TILE) flush();
+        }
+        if (waiting > 0) flush();
+    }
+
+    // Free the slot and post the answer to the completion ring
+    void complete(size_t slot, double prediction, CompletionSource source, uint64_t now) {
+        const InferenceRequest& request = request_ring_[slot];
+        const double latency_ns = elapsed_ns(request.submit_tsc, now);
+
+        InferenceCompletion& entry = completion_ring_[completion_tail_ & (QUEUE_DEPTH - 1)];
+        entry.request_id = request.request_id;
+        entry.prediction = prediction;
+        entry.latency_ns = latency_ns;
+        entry.source = source;
+        ++completion_tail_;
+
+        slot_owner_[slot] = INVALID_REQUEST;
+        --in_flight_;
+        while (oldest_request_id_ < next_request_id_ &&
+               slot_owner_[oldest_request_id_ & (QUEUE_DEPTH - 1)] != oldest_request_id_) {
+            ++oldest_request_id_;
+        }
+
+        update_latency_stats(latency_ns);
+        total_inferences_.fetch_add(1, std::memory_order_relaxed);
+    }
+
     // 
     // Latency Statistics
     // 
     
-    void update_latency_stats(double latency_ns) {
+    static double elapsed_ns(uint64_t start_tsc, uint64_t end_tsc) {
+        return static_cast<double>(hft::tsc_to_ns(end_tsc) - hft::tsc_to_ns(start_tsc));
+    }
+
+    void update_latency_stats(double latency_ns, uint64_t samples = 1) {
         // Atomic double addition using CAS loop
+        const double total_ns = latency_ns * static_cast<double>(samples);
         double old_val = latency_sum_ns_.load(std::memory_order_relaxed);
-        while (!latency_sum_ns_.compare_exchange_weak(old_val, old_val + latency_ns,
+        while (!latency_sum_ns_.compare_exchange_weak(old_val, old_val + total_ns,
                                                        std::memory_order_relaxed)) {
             // Retry on failure
         }
@@ -258,4 +526,18 @@ private:
     std::atomic<uint64_t> software_fallbacks_;
     std::atomic<double> latency_sum_ns_;
     std::atomic<double> max_latency_ns_;
+
+    // Asynchronous rings; slot = request_id % QUEUE_DEPTH, busy while
+    // slot_owner_ holds its id. submit() keeps in-flight plus undrained
+    // completions within QUEUE_DEPTH, so the completion ring never overruns.
+    alignas(64) std::array<InferenceRequest, QUEUE_DEPTH> request_ring_{};
+    alignas(64) std::array<InferenceCompletion, QUEUE_DEPTH> completion_ring_{};
+    std::array<uint64_t, QUEUE_DEPTH> slot_owner_{};
+    uint64_t next_request_id_ = 1;
+    uint64_t oldest_request_id_ = 1;    // No live request below this id
+    uint64_t completion_head_ = 0;
+    uint64_t completion_tail_ = 0;
+    size_t in_flight_ = 0;
+    uint64_t timeout_ticks_ = 0;
+    InferencePrecision async_precision_ = InferencePrecision::FP32;
 };
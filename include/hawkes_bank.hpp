@@ -0,0 +1,313 @@
+#pragma once
+
+#include "fast_math.hpp"
+#include "hawkes_engine.hpp"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// Platform-specific SIMD intrinsics
+#if defined(__AVX512F__)
+    #include <immintrin.h>
+#elif defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+/**
+ * Multi-instrument Hawkes bank
+ *
+ * One VectorizedMultiKernelHawkes per symbol keeps every instrument's
+ * kernel states in its own object, so a trade costs a cache miss per
+ * symbol and the per-kernel fast_exp loop never uses more than one lane.
+ * The bank keeps the same model (shared alphas/betas, per-symbol mu) for
+ * every symbol in structure-of-arrays form:
+ *
+ *   buy_[k * stride + s]   buy state of kernel k for symbol s
+ *   sell_[k * stride + s]  sell state of kernel k for symbol s
+ *
+ * A burst of trades is applied LANES events at a time (8 on AVX-512, 4 on
+ * AVX2): each chunk holds distinct symbols, the decays exp(-beta_k * dt)
+ * are evaluated in vector registers and the states are gathered/scattered
+ * across symbols. A symbol repeating inside a chunk closes it early so
+ * events for the same symbol are always applied in arrival order. Sweeps
+ * over the whole bank (intensities, imbalances) read contiguous arrays.
+ */
+
+namespace hft {
+
+class HawkesBank {
+public:
+    static constexpr size_t KERNEL_COUNT = VectorizedMultiKernelHawkes::KERNEL_COUNT;
+
+#if defined(__AVX512F__)
+    static constexpr size_t LANES = 8;
+#elif defined(__AVX2__)
+    static constexpr size_t LANES = 4;
+#else
+    static constexpr size_t LANES = 1;
+#endif
+
+    HawkesBank(
+        size_t symbols,
+        double mu_buy, double mu_sell,
+        const std::array<double, KERNEL_COUNT>& alphas_self,
+        const std::array<double, KERNEL_COUNT>& alphas_cross,
+        const std::array<double, KERNEL_COUNT>& betas
+    ) : symbols_(symbols),
+        stride_((symbols + 7) & ~size_t(7)),
+        betas_(betas),
+        buy_(KERNEL_COUNT * stride_, 0.0),
+        sell_(KERNEL_COUNT * stride_, 0.0),
+        mu_buy_(stride_, mu_buy),
+        mu_sell_(stride_, mu_sell),
+        last_ns_(stride_, 0) {
+
+        if (symbols == 0 || symbols > UINT32_MAX) {
+            throw std::invalid_argument("HawkesBank: symbol count out of range");
+        }
+        for (size_t k = 0; k < KERNEL_COUNT; ++k) {
+            if (betas_[k] <= 0) betas_[k] = 1e-3;
+            self_weight_[k] = alphas_self[k] * betas_[k];
+            cross_weight_[k] = alphas_cross[k] * betas_[k];
+        }
+    }
+
+    size_t size() const { return symbols_; }
+
+    void set_baseline(uint32_t symbol, double mu_buy, double mu_sell) {
+        check(symbol);
+        mu_buy_[symbol] = mu_buy;
+        mu_sell_[symbol] = mu_sell;
+    }
+
+    /**
+     * Single event, same recursion as VectorizedMultiKernelHawkes::update
+     */
+    void update(uint32_t symbol, Side side, int64_t ts_ns) {
+        check(symbol);
+        apply(symbol, elapsed(symbol, ts_ns), side == Side::BUY);
+    }
+
+    void update(const TradingEvent& event) {
+        update(event.asset_id, event.event_type, to_nanos(event.arrival_time));
+    }
+
+    /**
+     * Apply a burst of trade events in arrival order. Results match
+     * calling update() for each event in turn.
+     */
+    void update_batch(const TradingEvent* events, size_t count) {
+        alignas(64) uint32_t symbol[LANES];
+        alignas(64) double dt[LANES];
+        alignas(64) double add_buy[LANES];
+        size_t lanes = 0;
+
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t s = events[i].asset_id;
+            check(s);
+
+            for (size_t l = 0; l < lanes; ++l) {
+                if (symbol[l] == s) {
+                    flush(symbol, dt, add_buy, lanes);
+                    lanes = 0;
+                    break;
+                }
+            }
+
+            symbol[lanes] = s;
+            dt[lanes] = elapsed(s, to_nanos(events[i].arrival_time));
+            add_buy[lanes] = events[i].event_type == Side::BUY ? 1.0 : 0.0;
+            if (++lanes == LANES) {
+                flush(symbol, dt, add_buy, lanes);
+                lanes = 0;
+            }
+        }
+        flush(symbol, dt, add_buy, lanes);
+    }
+
+    void update_batch(const std::vector<TradingEvent>& events) {
+        update_batch(events.data(), events.size());
+    }
+
+    double get_buy_intensity(uint32_t symbol) const {
+        check(symbol);
+        double intensity = mu_buy_[symbol];
+        for (size_t k = 0; k < KERNEL_COUNT; ++k) {
+            intensity += self_weight_[k] * buy_[k * stride_ + symbol] +
+                         cross_weight_[k] * sell_[k * stride_ + symbol];
+        }
+        return intensity;
+    }
+
+    double get_sell_intensity(uint32_t symbol) const {
+        check(symbol);
+        double intensity = mu_sell_[symbol];
+        for (size_t k = 0; k < KERNEL_COUNT; ++k) {
+            intensity += self_weight_[k] * sell_[k * stride_ + symbol] +
+                         cross_weight_[k] * buy_[k * stride_ + symbol];
+        }
+        return intensity;
+    }
+
+    double get_intensity_imbalance(uint32_t symbol) const {
+        return imbalance(get_buy_intensity(symbol), get_sell_intensity(symbol));
+    }
+
+    /**
+     * Intensities of every symbol; each output needs size() entries
+     */
+    void intensities(double* buy_out, double* sell_out) const {
+        for (size_t s = 0; s < symbols_; ++s) {
+            buy_out[s] = mu_buy_[s];
+            sell_out[s] = mu_sell_[s];
+        }
+        // Contiguous per-kernel rows, vectorised by the compiler
+        for (size_t k = 0; k < KERNEL_COUNT; ++k) {
+            const double* b = &buy_[k * stride_];
+            const double* a = &sell_[k * stride_];
+            const double ws = self_weight_[k];
+            const double wc = cross_weight_[k];
+            for (size_t s = 0; s < symbols_; ++s) {
+                buy_out[s] += ws * b[s] + wc * a[s];
+                sell_out[s] += ws * a[s] + wc * b[s];
+            }
+        }
+    }
+
+    void imbalances(double* out) const {
+        std::vector<double> sell(symbols_);
+        intensities(out, sell.data());
+        for (size_t s = 0; s < symbols_; ++s) {
+            out[s] = imbalance(out[s], sell[s]);
+        }
+    }
+
+    double buy_state(uint32_t symbol, size_t kernel) const { return buy_[kernel * stride_ + symbol]; }
+    double sell_state(uint32_t symbol, size_t kernel) const { return sell_[kernel * stride_ + symbol]; }
+
+    void reset() {
+        std::fill(buy_.begin(), buy_.end(), 0.0);
+        std::fill(sell_.begin(), sell_.end(), 0.0);
+        std::fill(last_ns_.begin(), last_ns_.end(), 0);
+    }
+
+    /**
+     * exp(x) for x <= 0 (decay factors), from fast_math. The scalar and
+     * vector paths evaluate the same polynomial.
+     */
+    static double decay_exp(double x) {
+        return fast_math::exp(x > 0.0 ? 0.0 : x);
+    }
+
+private:
+    static double imbalance(double buy, double sell) {
+        const double total = buy + sell;
+        return (total < 1e-10) ? 0.0 : (buy - sell) / total;
+    }
+
+    void check(uint32_t symbol) const {
+        if (symbol >= symbols_) {
+            throw std::out_of_range("HawkesBank: unknown symbol");
+        }
+    }
+
+    // Seconds since the symbol's last event; advances its clock.
+    // Out-of-order events do not grow the state.
+    double elapsed(uint32_t symbol, int64_t ts_ns) {
+        const int64_t delta = ts_ns - last_ns_[symbol];
+        if (delta > 0) last_ns_[symbol] = ts_ns;
+        return delta > 0 ? delta * 1e-9 : 0.0;
+    }
+
+    void apply(uint32_t s, double dt, bool is_buy) {
+        for (size_t k = 0; k < KERNEL_COUNT; ++k) {
+            const double decay = decay_exp(-betas_[k] * dt);
+            double& b = buy_[k * stride_ + s];
+            double& a = sell_[k * stride_ + s];
+            b = b * decay + (is_buy ? 1.0 : 0.0);
+            a = a * decay + (is_buy ? 0.0 : 1.0);
+        }
+    }
+
+    // Chunk of distinct symbols; partial chunks take the scalar path
+    void flush(const uint32_t* symbol, const double* dt, const double* add_buy, size_t lanes) {
+        if (lanes == LANES && LANES > 1) {
+            flush_vector(symbol, dt, add_buy);
+            return;
+        }
+        for (size_t l = 0; l < lanes; ++l) {
+            apply(symbol[l], dt[l], add_buy[l] != 0.0);
+        }
+    }
+
+#if defined(__AVX512F__)
+    void flush_vector(const uint32_t* symbol, const double* dt, const double* add_buy) {
+        const __m256i idx = _mm256_load_si256(reinterpret_cast<const __m256i*>(symbol));
+        const __m512d vdt = _mm512_load_pd(dt);
+        const __m512d vbuy = _mm512_load_pd(add_buy);
+        const __m512d vsell = _mm512_sub_pd(_mm512_set1_pd(1.0), vbuy);
+
+        for (size_t k = 0; k < KERNEL_COUNT; ++k) {
+            const __m512d decay = exp512(_mm512_mul_pd(_mm512_set1_pd(-betas_[k]), vdt));
+            double* b = &buy_[k * stride_];
+            double* a = &sell_[k * stride_];
+            const __m512d sb = _mm512_i32gather_pd(idx, b, 8);
+            const __m512d sa = _mm512_i32gather_pd(idx, a, 8);
+            _mm512_i32scatter_pd(b, idx, _mm512_fmadd_pd(sb, decay, vbuy), 8);
+            _mm512_i32scatter_pd(a, idx, _mm512_fmadd_pd(sa, decay, vsell), 8);
+        }
+    }
+
+    static __m512d exp512(__m512d x) {
+        return fast_math::exp8(_mm512_min_pd(x, _mm512_setzero_pd()));
+    }
+#elif defined(__AVX2__)
+    void flush_vector(const uint32_t* symbol, const double* dt, const double* add_buy) {
+        const __m128i idx = _mm_load_si128(reinterpret_cast<const __m128i*>(symbol));
+        const __m256d vdt = _mm256_load_pd(dt);
+        const __m256d vbuy = _mm256_load_pd(add_buy);
+        const __m256d vsell = _mm256_sub_pd(_mm256_set1_pd(1.0), vbuy);
+        alignas(32) double out_b[LANES];
+        alignas(32) double out_a[LANES];
+
+        for (size_t k = 0; k < KERNEL_COUNT; ++k) {
+            const __m256d decay = exp256(_mm256_mul_pd(_mm256_set1_pd(-betas_[k]), vdt));
+            double* b = &buy_[k * stride_];
+            double* a = &sell_[k * stride_];
+            const __m256d sb = _mm256_i32gather_pd(b, idx, 8);
+            const __m256d sa = _mm256_i32gather_pd(a, idx, 8);
+            _mm256_store_pd(out_b, _mm256_add_pd(_mm256_mul_pd(sb, decay), vbuy));
+            _mm256_store_pd(out_a, _mm256_add_pd(_mm256_mul_pd(sa, decay), vsell));
+            // No scatter before AVX-512
+            for (size_t l = 0; l < LANES; ++l) {
+                b[symbol[l]] = out_b[l];
+                a[symbol[l]] = out_a[l];
+            }
+        }
+    }
+
+    static __m256d exp256(__m256d x) {
+        return fast_math::exp4(_mm256_min_pd(x, _mm256_setzero_pd()));
+    }
+#else
+    void flush_vector(const uint32_t*, const double*, const double*) {}
+#endif
+
+    size_t symbols_;
+    size_t stride_;
+    std::array<double, KERNEL_COUNT> betas_;
+    std::array<double, KERNEL_COUNT> self_weight_{};
+    std::array<double, KERNEL_COUNT> cross_weight_{};
+
+    // Kernel-major state rows
+    std::vector<double> buy_;
+    std::vector<double> sell_;
+
+    std::vector<double> mu_buy_;
+    std::vector<double> mu_sell_;
+    std::vector<int64_t> last_ns_;
+};
+
+}
@@ -0,0 +1,390 @@
+#pragma once
+
+#include "hawkes_engine.hpp"
+#include "lockfree_queue.hpp"
+#include "model_store.hpp"
+#include "seqlock.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <string>
+#include <thread>
+
+/**
+ * Online Hawkes calibration
+ *
+ * Streaming EM for the exponential-kernel bivariate process used by
+ * HawkesIntensityEngine:
+ *
+ *   lambda_i(t) = mu + alpha_self * beta * R_i(t) + alpha_cross * beta * R_j(t)
+ *   R_x(t)      = sum over side-x events t_k < t of exp(-beta (t - t_k))
+ *
+ * Each event is split by responsibility between the baseline, its own
+ * side and the opposite side (E-step) using the same O(1) recursive state
+ * as the engine, plus Q_x = sum (t - t_k) exp(-beta (t - t_k)) for the
+ * expected excitation lag. The sufficient statistics decay with a
+ * `window_seconds` horizon, and every `em_interval` events the M-step
+ * re-solves:
+ *
+ *   mu = E[background] / (2 T)    alpha = E[children] / kernel mass
+ *   beta = E[children] / E[lag]
+ *
+ * so estimates track the market without keeping or rescanning history.
+ * Fit quality comes from the time-rescaling theorem: compensator
+ * increments between same-side events are Exp(1) under the true model,
+ * so u = 1 - exp(-tau) is uniform and its empirical CDF is scored as R^2
+ * against the diagonal.
+ */
+
+namespace hft {
+
+struct HawkesCalibratorConfig {
+    double window_seconds = 600.0;  // Forgetting horizon of the statistics
+    uint32_t em_interval = 64;      // Events between M-steps
+    uint64_t min_events = 1000;     // Before an estimate is considered ready
+    double max_branching = 0.99;    // alpha_self + alpha_cross cap (stationarity)
+};
+
+struct HawkesEstimate {
+    double mu = 0.0;
+    double alpha_self = 0.0;
+    double alpha_cross = 0.0;
+    double beta = 0.0;
+    double log_likelihood = 0.0;    // Per event, over the forgetting window
+    double goodness_of_fit = 0.0;   // Time-rescaling R^2 since the last reset_fit_window()
+    uint64_t events = 0;
+};
+
+class OnlineHawkesCalibrator {
+public:
+    static constexpr size_t FIT_BINS = 20;
+
+    explicit OnlineHawkesCalibrator(const HawkesParameters& prior, HawkesCalibratorConfig config = {})
+        : config_(config), prior_(prior),
+          mu_(prior.lambda_base > 0 ? prior.lambda_base : 1.0),
+          alpha_self_(std::max(prior.alpha_self, 0.0)),
+          alpha_cross_(std::max(prior.alpha_cross, 0.0)),
+          beta_(prior.beta > 0 ? prior.beta : 1.0) {
+        if (config_.window_seconds <= 0) config_.window_seconds = 600.0;
+        if (config_.em_interval == 0) config_.em_interval = 1;
+        cap_branching();
+    }
+
+    void observe(Side side, int64_t ts_ns) {
+        const int i = side == Side::BUY ? 0 : 1;
+        const int j = 1 - i;
+
+        if (events_ > 0) {
+            advance(ts_ns > last_ns_ ? (ts_ns - last_ns_) * 1e-9 : 0.0);
+        }
+        if (ts_ns > last_ns_ || events_ == 0) last_ns_ = ts_ns;
+
+        // E-step against the pre-event state
+        const double self = alpha_self_ * beta_ * state_[i];
+        const double cross = alpha_cross_ * beta_ * state_[j];
+        const double lambda = mu_ + self + cross;
+        const double inv = 1.0 / lambda;
+
+        background_ += mu_ * inv;
+        self_children_ += self * inv;
+        cross_children_ += cross * inv;
+        lag_ += (alpha_self_ * beta_ * lag_state_[i] + alpha_cross_ * beta_ * lag_state_[j]) * inv;
+        weight_ += 1.0;
+        log_likelihood_ += std::log(lambda);
+
+        if (seen_[i]) record_residual(compensator_[i]);
+        seen_[i] = true;
+        compensator_[i] = 0.0;
+
+        state_[i] += 1.0;
+        ++events_;
+
+        if (events_ % config_.em_interval == 0) {
+            maximize();
+        }
+    }
+
+    void observe(const TradingEvent& event) {
+        observe(event.event_type, to_nanos(event.arrival_time));
+    }
+
+    bool ready() const { return events_ >= config_.min_events; }
+    uint64_t events() const { return events_; }
+
+    HawkesEstimate estimate() const {
+        HawkesEstimate e;
+        e.mu = mu_;
+        e.alpha_self = alpha_self_;
+        e.alpha_cross = alpha_cross_;
+        e.beta = beta_;
+        e.log_likelihood = weight_ > 0 ? log_likelihood_ / weight_ : 0.0;
+        e.goodness_of_fit = goodness_of_fit();
+        e.events = events_;
+        return e;
+    }
+
+    /**
+     * Current estimate in ModelStore form; gamma and the version are
+     * carried over from the prior
+     */
+    HawkesParameters parameters() const {
+        HawkesParameters p = prior_;
+        p.lambda_base = mu_;
+        p.alpha_self = alpha_self_;
+        p.alpha_cross = alpha_cross_;
+        p.beta = beta_;
+        p.calibration_r_squared = goodness_of_fit();
+        p.calibration_samples = events_;
+        return p;
+    }
+
+    double goodness_of_fit() const {
+        if (residuals_ == 0) return 0.0;
+
+        // Empirical CDF of u at the bin edges against the uniform CDF
+        double cumulative = 0.0, ss_res = 0.0, ss_tot = 0.0;
+        const double mean = (FIT_BINS + 1) / (2.0 * FIT_BINS);
+        for (size_t b = 0; b < FIT_BINS; ++b) {
+            cumulative += fit_bins_[b];
+            const double expected = static_cast<double>(b + 1) / FIT_BINS;
+            const double observed = cumulative / residuals_;
+            ss_res += (observed - expected) * (observed - expected);
+            ss_tot += (expected - mean) * (expected - mean);
+        }
+        return std::max(0.0, 1.0 - ss_res / ss_tot);
+    }
+
+    // Start a new goodness-of-fit period (e.g. after publishing)
+    void reset_fit_window() {
+        fit_bins_.fill(0);
+        residuals_ = 0;
+    }
+
+private:
+    void advance(double dt) {
+        const double decay = std::exp(-beta_ * dt);
+        const double keep = std::exp(-dt / config_.window_seconds);
+
+        for (int x = 0; x < 2; ++x) {
+            const int y = 1 - x;
+            const double carried = mu_ * dt + (1.0 - decay) *
+                (alpha_self_ * state_[x] + alpha_cross_ * state_[y]);
+            compensator_[x] += carried;
+            log_likelihood_ -= carried;
+        }
+        for (int x = 0; x < 2; ++x) {
+            lag_state_[x] = decay * (lag_state_[x] + dt * state_[x]);
+            state_[x] *= decay;
+        }
+
+        background_ *= keep;
+        self_children_ *= keep;
+        cross_children_ *= keep;
+        lag_ *= keep;
+        weight_ *= keep;
+        log_likelihood_ *= keep;
+        elapsed_ = elapsed_ * keep + dt;
+    }
+
+    void maximize() {
+        // Kernel mass each event has had time to spend
+        const double mass = std::max(weight_ - state_[0] - state_[1], 1.0);
+        if (elapsed_ > 0) mu_ = std::max(background_ / (2.0 * elapsed_), 1e-9);
+        alpha_self_ = self_children_ / mass;
+        alpha_cross_ = cross_children_ / mass;
+        if (lag_ > 0) beta_ = (self_children_ + cross_children_) / lag_;
+        cap_branching();
+    }
+
+    void cap_branching() {
+        const double branching = alpha_self_ + alpha_cross_;
+        if (branching > config_.max_branching) {
+            const double scale = config_.max_branching / branching;
+            alpha_self_ *= scale;
+            alpha_cross_ *= scale;
+        }
+    }
+
+    void record_residual(double tau) {
+        const double u = 1.0 - std::exp(-tau);
+        const size_t bin = std::min(static_cast<size_t>(u * FIT_BINS), FIT_BINS - 1);
+        ++fit_bins_[bin];
+        ++residuals_;
+    }
+
+    HawkesCalibratorConfig config_;
+    HawkesParameters prior_;
+
+    double mu_;
+    double alpha_self_;
+    double alpha_cross_;
+    double beta_;
+
+    // Recursive state per side (0 = buy, 1 = sell)
+    std::array<double, 2> state_{};
+    std::array<double, 2> lag_state_{};
+    std::array<double, 2> compensator_{};
+    std::array<bool, 2> seen_{};
+    int64_t last_ns_ = 0;
+    uint64_t events_ = 0;
+
+    // Decayed sufficient statistics
+    double background_ = 0.0;
+    double self_children_ = 0.0;
+    double cross_children_ = 0.0;
+    double lag_ = 0.0;
+    double weight_ = 0.0;
+    double elapsed_ = 0.0;
+    double log_likelihood_ = 0.0;
+
+    std::array<uint64_t, FIT_BINS> fit_bins_{};
+    uint64_t residuals_ = 0;
+};
+
+/**
+ * Background calibration for one symbol
+ *
+ * The trading thread hands trades over through an SPSC queue (record()
+ * never blocks; a full queue drops and counts the sample). A worker
+ * thread, optionally pinned to its own core, feeds the calibrator and
+ * every `publish_interval` (or right away when the store reports the
+ * symbol as stale) publishes the estimate with
+ * ModelStore::update_hawkes_parameters and reports the resulting
+ * CalibrationQuality to the callback.
+ */
+class HawkesCalibrationService {
+public:
+    static constexpr size_t QUEUE_CAPACITY = 1 << 16;
+
+    using PublishCallback = std::function<void(const HawkesParameters&, const CalibrationQuality&)>;
+
+    HawkesCalibrationService(ModelStore& store, std::string symbol,
+                             HawkesCalibratorConfig config = {},
+                             std::chrono::nanoseconds publish_interval = std::chrono::hours(1),
+                             int cpu_core = -1)
+        : store_(store), symbol_(std::move(symbol)),
+          calibrator_(initial_parameters(store, symbol_), config),
+          publish_interval_(publish_interval), cpu_core_(cpu_core) {
+        estimate_.store(calibrator_.estimate());
+    }
+
+    ~HawkesCalibrationService() { stop(); }
+
+    HawkesCalibrationService(const HawkesCalibrationService&) = delete;
+    HawkesCalibrationService& operator=(const HawkesCalibrationService&) = delete;
+
+    void set_publish_callback(PublishCallback callback) { callback_ = std::move(callback); }
+
+    void start() {
+        if (running_.exchange(true)) return;
+        worker_ = std::thread([this] { run(); });
+    }
+
+    // Drains queued samples before returning
+    void stop() {
+        if (!running_.exchange(false)) return;
+        if (worker_.joinable()) worker_.join();
+    }
+
+    // Hot path: called from the trading thread only
+    bool record(Side side, int64_t ts_ns) {
+        if (!queue_.push(Sample{ts_ns, side})) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    bool record(const TradingEvent& event) {
+        return record(event.event_type, to_nanos(event.arrival_time));
+    }
+
+    // Publish at the next opportunity once the estimate is ready
+    void request_publish() { publish_requested_.store(true, std::memory_order_release); }
+
+    HawkesEstimate latest_estimate() const { return estimate_.load(); }
+    uint64_t published() const { return published_.load(std::memory_order_acquire); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Sample {
+        int64_t ts_ns;
+        Side side;
+    };
+
+    static HawkesParameters initial_parameters(ModelStore& store, const std::string& symbol) {
+        if (auto p = store.get_hawkes_parameters(symbol)) return *p;
+        if (auto p = store.get_hawkes_parameters("default")) return *p;
+
+        HawkesParameters p{};
+        p.alpha_self = 0.3;
+        p.alpha_cross = 0.1;
+        p.beta = 1.0;
+        p.gamma = 2.0;
+        p.lambda_base = 1.0;
+        return p;
+    }
+
+    void run() {
+        if (cpu_core_ >= 0) spin_loop::pin_to_cpu(cpu_core_);
+
+        const auto max_age = std::chrono::duration_cast<std::chrono::seconds>(publish_interval_).count();
+        bool publish_when_ready = store_.needs_recalibration(symbol_, max_age);
+        auto last_publish = std::chrono::steady_clock::now();
+
+        for (;;) {
+            const bool stopping = !running_.load(std::memory_order_acquire);
+            const size_t drained = queue_.consume_all([this](const Sample& s) { calibrator_.observe(s.side, s.ts_ns); });
+            if (drained > 0) estimate_.store(calibrator_.estimate());
+
+            const auto now = std::chrono::steady_clock::now();
+            if (publish_requested_.exchange(false, std::memory_order_acq_rel)) publish_when_ready = true;
+            if (now - last_publish >= publish_interval_) publish_when_ready = true;
+
+            if (publish_when_ready && calibrator_.ready()) {
+                publish();
+                publish_when_ready = false;
+                last_publish = now;
+            }
+
+            if (stopping) break;
+            if (drained == 0) std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    void publish() {
+        const HawkesParameters params = calibrator_.parameters();
+        store_.update_hawkes_parameters(symbol_, params, "online_calibrator",
+            "Streaming EM over " + std::to_string(params.calibration_samples) + " events");
+
+        CalibrationQuality quality{};
+        for (const auto& q : store_.get_calibration_quality()) {
+            if (q.symbol == symbol_) quality = q;
+        }
+
+        calibrator_.reset_fit_window();
+        published_.fetch_add(1, std::memory_order_acq_rel);
+        if (callback_) callback_(params, quality);
+    }
+
+    ModelStore& store_;
+    std::string symbol_;
+    OnlineHawkesCalibrator calibrator_;
+    std::chrono::nanoseconds publish_interval_;
+    int cpu_core_;
+
+    LockFreeQueue<Sample, QUEUE_CAPACITY> queue_;
+    Seqlock<HawkesEstimate> estimate_;
+    PublishCallback callback_;
+
+    std::thread worker_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> publish_requested_{false};
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+}
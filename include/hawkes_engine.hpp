@@ -1,5 +1,6 @@
 #pragma once
 
+#include "engine_checkpoint.hpp"
 #include "spin_loop_engine.hpp"
 
 namespace hft {
@@ -66,6 +67,20 @@ public:
         return mu_sell_ + (alpha_self_ * beta_ * future_state_sell) + (alpha_cross_ * beta_ * future_state_buy);
     }
 
+    /**
+     * Swap in recalibrated parameters (e.g. from OnlineHawkesCalibrator)
+     * without resetting the recursive state
+     */
+    void set_parameters(double mu_buy, double mu_sell, double alpha_self, double alpha_cross, double beta) {
+        mu_buy_ = mu_buy;
+        mu_sell_ = mu_sell;
+        alpha_self_ = alpha_self;
+        alpha_cross_ = alpha_cross;
+        if (beta > 0) beta_ = beta;
+        intensity_buy_ = mu_buy_ + (alpha_self_ * beta_ * state_buy_) + (alpha_cross_ * beta_ * state_sell_);
+        intensity_sell_ = mu_sell_ + (alpha_self_ * beta_ * state_sell_) + (alpha_cross_ * beta_ * state_buy_);
+    }
+
     void reset() {
         state_buy_ = 0.0;
         state_sell_ = 0.0;
@@ -74,6 +89,33 @@ public:
         current_time_ = now();
     }
 
+    // Parameters and recursive state, so recalibrated parameters survive too
+    void save_state(checkpoint::StateWriter& out) const {
+        out.put(mu_buy_);
+        out.put(mu_sell_);
+        out.put(alpha_self_);
+        out.put(alpha_cross_);
+        out.put(beta_);
+        out.put(intensity_buy_);
+        out.put(intensity_sell_);
+        out.put(state_buy_);
+        out.put(state_sell_);
+        out.put<int64_t>(to_nanos(current_time_));
+    }
+
+    void restore_state(checkpoint::StateReader& in) {
+        in.get(mu_buy_);
+        in.get(mu_sell_);
+        in.get(alpha_self_);
+        in.get(alpha_cross_);
+        in.get(beta_);
+        in.get(intensity_buy_);
+        in.get(intensity_sell_);
+        in.get(state_buy_);
+        in.get(state_sell_);
+        current_time_ = Timestamp(std::chrono::nanoseconds(in.get<int64_t>()));
+    }
+
 private:
     double mu_buy_;
     double mu_sell_;
@@ -164,6 +206,28 @@ public:
         return (total < 1e-10) ? 0.0 : (buy - sell) / total;
     }
 
+    void save_state(checkpoint::StateWriter& out) const {
+        out.put(mu_buy_);
+        out.put(mu_sell_);
+        out.put(alphas_self_);
+        out.put(alphas_cross_);
+        out.put(betas_);
+        out.put(states_buy_);
+        out.put(states_sell_);
+        out.put<int64_t>(to_nanos(current_time_));
+    }
+
+    void restore_state(checkpoint::StateReader& in) {
+        in.get(mu_buy_);
+        in.get(mu_sell_);
+        in.get(alphas_self_);
+        in.get(alphas_cross_);
+        in.get(betas_);
+        in.get(states_buy_);
+        in.get(states_sell_);
+        current_time_ = Timestamp(std::chrono::nanoseconds(in.get<int64_t>()));
+    }
+
 private:
     double mu_buy_;
     double mu_sell_;
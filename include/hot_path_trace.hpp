@@ -0,0 +1,371 @@
+#pragma once
+
+#include "common_types.hpp"
+#include "latency_histogram.hpp"
+#include "lockfree_queue.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <inttypes.h>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// Build with -DHFT_TRACE_ENABLED=0 (cmake -DENABLE_HOT_PATH_TRACE=OFF) for
+// latency builds: HotPathTracer then has no members and every call is empty
+#ifndef HFT_TRACE_ENABLED
+    #define HFT_TRACE_ENABLED 1
+#endif
+
+namespace hft {
+
+// ====
+// Hot-Path Trace Points
+// JitterProfiler sees the gap between loop iterations; this splits the
+// iteration itself. The loop marks the end of each named stage on a
+// TraceThread, which keeps counter deltas for one sampled cycle and pushes
+// them as a single record into a per-thread SPSC ring. The tracer drains
+// the rings off the hot path (background thread or drain()) into per-stage
+// streaming histograms and a bounded window of recent cycles for Chrome /
+// Perfetto trace export.
+// ====
+
+enum class TraceStage : uint8_t {
+    RX,
+    DECODE,
+    BOOK,
+    HAWKES,
+    FEATURES,
+    INFERENCE,
+    QUOTE,
+    RISK,
+    SEND,
+    COUNT
+};
+
+constexpr size_t TRACE_STAGE_COUNT = static_cast<size_t>(TraceStage::COUNT);
+
+inline const char* trace_stage_name(TraceStage stage) {
+    static const char* const names[TRACE_STAGE_COUNT] = {
+        "rx", "decode", "book", "hawkes", "features", "inference", "quote", "risk", "send"
+    };
+    const size_t i = static_cast<size_t>(stage);
+    return i < TRACE_STAGE_COUNT ? names[i] : "unknown";
+}
+
+// One sampled cycle. Stages the cycle skipped stay 0; time spent before a
+// mark belongs to the stage marked.
+struct TraceCycle {
+    uint64_t start_tsc = 0;                            // hft::now_tsc() units
+    std::array<uint32_t, TRACE_STAGE_COUNT> stage_ticks{};
+    uint32_t thread_index = 0;
+};
+
+struct TraceConfig {
+    uint32_t sample_every = 64;                        // Power of two; 1 traces every cycle
+    std::chrono::milliseconds export_interval{100};
+    size_t recent_cycles = 4096;                       // Window kept for the Chrome trace
+};
+
+template<bool Enabled>
+class BasicTraceThread;
+
+template<bool Enabled>
+class BasicHotPathTracer;
+
+// ====
+// Enabled
+// ====
+
+template<>
+class BasicTraceThread<true> {
+public:
+    static constexpr size_t RING_SIZE = 4096;
+
+    BasicTraceThread(std::string name, uint32_t index, uint32_t sample_every)
+        : name_(std::move(name)), index_(index),
+          sample_mask_(sample_every > 0 ? sample_every - 1 : 0) {
+        cycle_.thread_index = index;
+    }
+
+    // Starts a cycle; only one in sample_every is recorded. A cycle that is
+    // begun again without end_cycle() (e.g. an idle poll) is discarded.
+    void begin_cycle() {
+        sampled_ = (cycles_++ & sample_mask_) == 0;
+        if (!sampled_) return;
+        cycle_.stage_ticks.fill(0);
+        last_ = cycle_.start_tsc = now_tsc();
+    }
+
+    // End of `stage`: the time since the previous mark is charged to it
+    void mark(TraceStage stage) {
+        if (!sampled_) return;
+        const uint64_t t = now_tsc();
+        const uint64_t delta = t - last_;
+        uint32_t& slot = cycle_.stage_ticks[static_cast<size_t>(stage)];
+        slot = static_cast<uint32_t>(std::min<uint64_t>(uint64_t(slot) + delta, UINT32_MAX));
+        last_ = t;
+    }
+
+    // Publishes the sampled cycle; dropped (and counted) if the ring is full
+    void end_cycle() {
+        if (!sampled_) return;
+        sampled_ = false;
+        if (!ring_.push(cycle_)) dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const std::string& name() const { return name_; }
+    uint32_t index() const { return index_; }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    friend class BasicHotPathTracer<true>;
+
+    std::string name_;
+    uint32_t index_;
+    uint32_t sample_mask_;
+    uint64_t cycles_ = 0;
+    bool sampled_ = false;
+    uint64_t last_ = 0;
+    TraceCycle cycle_;
+    std::atomic<uint64_t> dropped_{0};
+    LockFreeQueue<TraceCycle, RING_SIZE> ring_;
+};
+
+template<>
+class BasicHotPathTracer<true> {
+public:
+    using Thread = BasicTraceThread<true>;
+    static constexpr bool enabled = true;
+
+    explicit BasicHotPathTracer(const TraceConfig& config = TraceConfig()) : config_(config) {
+        if (config_.sample_every == 0 || (config_.sample_every & (config_.sample_every - 1)) != 0) {
+            throw std::invalid_argument("TraceConfig::sample_every must be a power of two");
+        }
+    }
+
+    ~BasicHotPathTracer() { stop(); }
+
+    BasicHotPathTracer(const BasicHotPathTracer&) = delete;
+    BasicHotPathTracer& operator=(const BasicHotPathTracer&) = delete;
+
+    // One per tracing thread; the reference stays valid for the tracer's life
+    Thread& register_thread(const std::string& name) {
+        std::lock_guard<std::mutex> lock(threads_mutex_);
+        const auto index = static_cast<uint32_t>(threads_.size());
+        threads_.push_back(std::make_unique<Thread>(name, index, config_.sample_every));
+        return *threads_.back();
+    }
+
+    // Background export every config.export_interval (idempotent)
+    void start() {
+        std::lock_guard<std::mutex> lock(exporter_mutex_);
+        if (exporter_.joinable()) return;
+        stop_requested_ = false;
+        exporter_ = std::thread([this] { run(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(exporter_mutex_);
+            if (!exporter_.joinable()) return;
+            stop_requested_ = true;
+        }
+        wake_.notify_all();
+        exporter_.join();
+        drain();
+    }
+
+    bool running() const {
+        std::lock_guard<std::mutex> lock(exporter_mutex_);
+        return exporter_.joinable();
+    }
+
+    // Moves every published cycle into the histograms; returns the count
+    size_t drain() {
+        std::lock_guard<std::mutex> lock(drain_mutex_);
+        std::lock_guard<std::mutex> threads_lock(threads_mutex_);
+        size_t n = 0;
+        for (auto& thread : threads_) {
+            n += thread->ring_.consume_all([this](TraceCycle& cycle) { fold(cycle); });
+        }
+        return n;
+    }
+
+    // Per-stage latency in ns
+    const LatencyHistogram& stage_histogram(TraceStage stage) const {
+        return stage_ns_[static_cast<size_t>(stage)];
+    }
+
+    // Sum of the stages of each cycle
+    const LatencyHistogram& cycle_histogram() const { return cycle_ns_; }
+
+    uint64_t sampled_cycles() const { return cycle_ns_.count(); }
+
+    uint64_t dropped() const {
+        std::lock_guard<std::mutex> lock(threads_mutex_);
+        uint64_t n = 0;
+        for (const auto& thread : threads_) n += thread->dropped();
+        return n;
+    }
+
+    // Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev) of the
+    // recent window: one complete event per stage, laid out in stage order
+    // from the cycle start. Returns false if the file cannot be written.
+    bool write_chrome_trace(const std::string& path) const {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) return false;
+
+        out << "{\"traceEvents\":[";
+        bool first = true;
+        auto sep = [&]() -> std::ofstream& {
+            if (!first) out << ",\n";
+            first = false;
+            return out;
+        };
+        {
+            std::lock_guard<std::mutex> lock(threads_mutex_);
+            for (const auto& thread : threads_) {
+                sep() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->index()
+                      << ",\"args\":{\"name\":\"" << thread->name() << "\"}}";
+            }
+        }
+
+        char buf[192];
+        std::lock_guard<std::mutex> lock(recent_mutex_);
+        for (const auto& cycle : recent_) {
+            double ts_us = static_cast<double>(tsc_to_ns(cycle.start_tsc)) / 1000.0;
+            for (size_t s = 0; s < TRACE_STAGE_COUNT; ++s) {
+                if (cycle.stage_ticks[s] == 0) continue;
+                const double dur_us = ticks_to_ns(cycle.stage_ticks[s]) / 1000.0;
+                std::snprintf(buf, sizeof(buf),
+                              "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                              trace_stage_name(static_cast<TraceStage>(s)), cycle.thread_index, ts_us, dur_us);
+                sep() << buf;
+                ts_us += dur_us;
+            }
+        }
+        out << "]}\n";
+        return static_cast<bool>(out);
+    }
+
+    void print_report() const {
+        printf("\n=== Hot-Path Stages (1 in %u cycles sampled) ===\n", config_.sample_every);
+        printf("Sampled Cycles: %" PRIu64 "  Dropped: %" PRIu64 "\n", sampled_cycles(), dropped());
+        printf("%-10s %10s %10s %10s %10s\n", "stage", "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+        auto row = [](const char* name, const LatencyHistogram& h) {
+            printf("%-10s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n", name,
+                   h.value_at_percentile(50.0), h.value_at_percentile(99.0),
+                   h.value_at_percentile(99.9), h.max());
+        };
+        for (size_t s = 0; s < TRACE_STAGE_COUNT; ++s) {
+            if (stage_ns_[s].count() == 0) continue;
+            row(trace_stage_name(static_cast<TraceStage>(s)), stage_ns_[s]);
+        }
+        row("cycle", cycle_ns_);
+    }
+
+    const TraceConfig& config() const { return config_; }
+
+private:
+    // Counter ticks to ns; now_tsc() already counts ns in fallback mode
+    static double ticks_to_ns(uint64_t ticks) {
+        const auto& clock = tsc::ClockService::instance();
+        return clock.tsc_enabled() ? static_cast<double>(ticks) * clock.ns_per_cycle()
+                                   : static_cast<double>(ticks);
+    }
+
+    void fold(const TraceCycle& cycle) {
+        uint64_t total = 0;
+        for (size_t s = 0; s < TRACE_STAGE_COUNT; ++s) {
+            if (cycle.stage_ticks[s] == 0) continue;
+            total += cycle.stage_ticks[s];
+            stage_ns_[s].record(static_cast<int64_t>(ticks_to_ns(cycle.stage_ticks[s])));
+        }
+        cycle_ns_.record(static_cast<int64_t>(ticks_to_ns(total)));
+
+        if (config_.recent_cycles == 0) return;
+        std::lock_guard<std::mutex> lock(recent_mutex_);
+        if (recent_.size() == config_.recent_cycles) recent_.pop_front();
+        recent_.push_back(cycle);
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(exporter_mutex_);
+        while (!stop_requested_) {
+            if (wake_.wait_for(lock, config_.export_interval, [this] { return stop_requested_; })) break;
+            lock.unlock();
+            drain();
+            lock.lock();
+        }
+    }
+
+    TraceConfig config_;
+
+    mutable std::mutex threads_mutex_;
+    std::deque<std::unique_ptr<Thread>> threads_;
+
+    std::mutex drain_mutex_;
+    std::array<LatencyHistogram, TRACE_STAGE_COUNT> stage_ns_;
+    LatencyHistogram cycle_ns_;
+
+    mutable std::mutex recent_mutex_;
+    std::deque<TraceCycle> recent_;
+
+    mutable std::mutex exporter_mutex_;
+    std::condition_variable wake_;
+    std::thread exporter_;
+    bool stop_requested_ = false;
+};
+
+// ====
+// Compiled Out
+// Same interface, no state; every call inlines to nothing
+// ====
+
+template<>
+class BasicTraceThread<false> {
+public:
+    void begin_cycle() {}
+    void mark(TraceStage) {}
+    void end_cycle() {}
+    uint64_t dropped() const { return 0; }
+};
+
+template<>
+class BasicHotPathTracer<false> {
+public:
+    using Thread = BasicTraceThread<false>;
+    static constexpr bool enabled = false;
+
+    explicit BasicHotPathTracer(const TraceConfig& = TraceConfig()) {}
+
+    Thread& register_thread(const std::string&) {
+        static Thread thread;
+        return thread;
+    }
+
+    void start() {}
+    void stop() {}
+    bool running() const { return false; }
+    size_t drain() { return 0; }
+    uint64_t sampled_cycles() const { return 0; }
+    uint64_t dropped() const { return 0; }
+    bool write_chrome_trace(const std::string&) const { return false; }
+    void print_report() const {}
+};
+
+constexpr bool TRACE_ENABLED = HFT_TRACE_ENABLED != 0;
+
+using HotPathTracer = BasicHotPathTracer<TRACE_ENABLED>;
+using TraceThread = BasicTraceThread<TRACE_ENABLED>;
+
+} // namespace hft
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace hft {
+
+// ====
+// Inline Callable
+// std::function replacement with fixed inline storage: the closure lives in
+// the object itself and never touches the heap. Captures that don't fit are
+// a compile error rather than a silent allocation.
+// ====
+
+template<typename Signature, size_t Capacity = 48>
+class InlineFunction;
+
+template<typename R, typename... Args, size_t Capacity>
+class InlineFunction<R(Args...), Capacity> {
+public:
+    static constexpr size_t CAPACITY = Capacity;
+
+    InlineFunction() noexcept = default;
+
+    template<typename F, typename = std::enable_if_t<
+        !std::is_same_v<std::decay_t<F>, InlineFunction> &&
+        std::is_invocable_r_v<R, std::decay_t<F>&, Args...>>>
+    InlineFunction(F&& f) {
+        emplace(std::forward<F>(f));
+    }
+
+    InlineFunction(InlineFunction&& other) noexcept {
+        move_from(other);
+    }
+
+    InlineFunction& operator=(InlineFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    InlineFunction(const InlineFunction&) = delete;
+    InlineFunction& operator=(const InlineFunction&) = delete;
+
+    ~InlineFunction() { reset(); }
+
+    template<typename F>
+    void emplace(F&& f) {
+        using Fn = std::decay_t<F>;
+        static_assert(sizeof(Fn) <= Capacity, "Callable too large for InlineFunction storage");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "Over-aligned callable");
+        static_assert(std::is_nothrow_move_constructible_v<Fn>, "Callable must be nothrow movable");
+
+        reset();
+        ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(f));
+        ops_ = &OpsFor<Fn>::table;
+    }
+
+    void reset() noexcept {
+        if (ops_) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+    R operator()(Args... args) {
+        return ops_->invoke(storage_, std::forward<Args>(args)...);
+    }
+
+private:
+    struct Ops {
+        R (*invoke)(void*, Args&&...);
+        void (*move)(void* dst, void* src) noexcept;
+        void (*destroy)(void*) noexcept;
+    };
+
+    template<typename Fn>
+    struct OpsFor {
+        static R invoke(void* p, Args&&... args) {
+            return (*static_cast<Fn*>(p))(std::forward<Args>(args)...);
+        }
+        static void move(void* dst, void* src) noexcept {
+            ::new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+            static_cast<Fn*>(src)->~Fn();
+        }
+        static void destroy(void* p) noexcept {
+            static_cast<Fn*>(p)->~Fn();
+        }
+        static constexpr Ops table{&invoke, &move, &destroy};
+    };
+
+    void move_from(InlineFunction& other) noexcept {
+        if (other.ops_) {
+            other.ops_->move(storage_, other.storage_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[Capacity];
+    const Ops* ops_ = nullptr;
+};
+
+} // namespace hft
@@ -10,9 +10,13 @@
 #include <cmath>
 #include <chrono>
 #include <cstring>
+#include <string_view>
 
 #include <openssl/sha.h>
 
+#include "binary_journal.hpp"
+#include "latency_histogram.hpp"
+
 namespace InstitutionalLogging {
 
 class SHA256Hasher {
@@ -60,125 +64,199 @@ public:
     }
 };
 
-class EventReplayLogger {
+// Backtest audit trail. Text mode formats each event on the calling
+// thread; journal mode writes one binary record per event into a
+// BinaryJournal (which must outlive the logger) for offline decoding.
+class EventReplayLogger : public hft::JournaledLog<EventReplayLogger> {
 public:
+    enum Event : uint16_t {
+        TICK = 1, SIGNAL, ORDER_SUBMIT, ORDER_ACK, ORDER_FILL, ORDER_CANCEL, PNL_UPDATE
+    };
+
     explicit EventReplayLogger(const std::string& log_path)
-        : log_file_(log_path), event_count_(0) {
+        : JournaledLog(log_path), event_count_(0) {
 
-        if (!log_file_.is_open()) {
+        if (!file_.is_open()) {
             throw std::runtime_error("Failed to open replay log: " + log_path);
         }
+        write_header();
+    }
 
-        log_file_ << "# DETERMINISTIC BACKTEST REPLAY LOG\nize";
-        log_file_ << "# Generated: " << get_timestamp() << "\nize";
-        log_file_ << "# Format: [timestamp_ns] EVENT_TYPE: details\nize";
-        log_file_ << "# ============================================\nize\nize";
+    EventReplayLogger(const std::string& log_path, hft::BinaryJournal& journal)
+        : JournaledLog(log_path, journal, hft::JournalSourceKind::EVENT_REPLAY), event_count_(0) {
+        write_header();
     }
 
     ~EventReplayLogger() {
-        if (log_file_.is_open()) {
-            log_file_ << "\nize# ============================================\nize";
-            log_file_ << "# Total events logged: " << event_count_ << "\nize";
-            log_file_.close();
+        if (journaled() || file_.is_open()) {
+            std::ostringstream footer;
+            footer << "\nize# ============================================\nize";
+            footer << "# Total events logged: " << event_count_ << "\nize";
+            emit_text(footer.str());
         }
     }
 
     void log_config(const std::string& config_json, uint32_t random_seed,
                     const std::string& data_file_checksum) {
-        log_file_ << "# CONFIGURATION\nize";
-        log_file_ << "# Random Seed: " << random_seed << "\nize";
-        log_file_ << "# Data File SHA256: " << data_file_checksum << "\nize";
-        log_file_ << "# Config: " << config_json << "\nize\nize";
+        std::ostringstream text;
+        text << "# CONFIGURATION\nize";
+        text << "# Random Seed: " << random_seed << "\nize";
+        text << "# Data File SHA256: " << data_file_checksum << "\nize";
+        text << "# Config: " << config_json << "\nize\nize";
+        emit_text(text.str());
     }
 
     void log_market_tick(int64_t timestamp_ns, double bid, double ask,
                         uint64_t bid_size, uint64_t ask_size) {
-        log_file_ << "[" << std::setw(20) << timestamp_ns << "] "
-                  << "TICK: bid=" << std::fixed << std::setprecision(4) << bid
-                  << " ask=" << ask
-                  << " bid_sz=" << bid_size
-                  << " ask_sz=" << ask_size << "\nize";
+        hft::JournalRecord r(TICK, timestamp_ns);
+        r.set(0, bid);
+        r.set(1, ask);
+        r.set(2, bid_size);
+        r.set(3, ask_size);
+        emit(r);
         ++event_count_;
     }
 
     void log_signal_decision(int64_t timestamp_ns, bool should_trade,
-                            const std::string& side, double signal_strength,
+                            std::string_view side, double signal_strength,
                             int confirmation_ticks, double obi) {
-        log_file_ << "[" << std::setw(20) << timestamp_ns << "] "
-                  << "SIGNAL: trade=" << (should_trade ? "YES" : "NO")
-                  << " side=" << side
-                  << " strength=" << std::fixed << std::setprecision(6) << signal_strength
-                  << " confirm_ticks=" << confirmation_ticks
-                  << " obi=" << std::setprecision(4) << obi << "\nize";
+        hft::JournalRecord r(SIGNAL, timestamp_ns);
+        r.aux = should_trade ? 1 : 0;
+        r.set_text(0, 2, side);
+        r.set(2, signal_strength);
+        r.set(3, static_cast<int64_t>(confirmation_ticks));
+        r.set(4, obi);
+        emit(r);
         ++event_count_;
     }
 
     void log_order_submit(int64_t timestamp_ns, uint64_t order_id,
-                         const std::string& side, double price,
+                         std::string_view side, double price,
                          uint64_t quantity) {
-        log_file_ << "[" << std::setw(20) << timestamp_ns << "] "
-                  << "ORDER_SUBMIT: id=" << order_id
-                  << " side=" << side
-                  << " price=" << std::fixed << std::setprecision(4) << price
-                  << " qty=" << quantity << "\nize";
+        hft::JournalRecord r(ORDER_SUBMIT, timestamp_ns);
+        r.set(0, order_id);
+        r.set_text(1, 1, side);
+        r.set(2, price);
+        r.set(3, quantity);
+        emit(r);
         ++event_count_;
     }
 
     void log_order_ack(int64_t timestamp_ns, uint64_t order_id,
                       int64_t latency_ns) {
-        log_file_ << "[" << std::setw(20) << timestamp_ns << "] "
-                  << "ORDER_ACK: id=" << order_id
-                  << " latency_ns=" << latency_ns << "\nize";
+        hft::JournalRecord r(ORDER_ACK, timestamp_ns);
+        r.set(0, order_id);
+        r.set(1, latency_ns);
+        emit(r);
         ++event_count_;
     }
 
     void log_order_fill(int64_t timestamp_ns, uint64_t order_id,
                        double fill_price, uint64_t quantity,
                        int64_t total_latency_ns) {
-        log_file_ << "[" << std::setw(20) << timestamp_ns << "] "
-                  << "ORDER_FILL: id=" << order_id
-                  << " fill_price=" << std::fixed << std::setprecision(4) << fill_price
-                  << " qty=" << quantity
-                  << " total_latency_ns=" << total_latency_ns << "\nize";
+        hft::JournalRecord r(ORDER_FILL, timestamp_ns);
+        r.set(0, order_id);
+        r.set(1, fill_price);
+        r.set(2, quantity);
+        r.set(3, total_latency_ns);
+        emit(r);
         ++event_count_;
     }
 
+    // Reasons are stored inline, up to 40 chars
     void log_order_cancel(int64_t timestamp_ns, uint64_t order_id,
-                         const std::string& reason) {
-        log_file_ << "[" << std::setw(20) << timestamp_ns << "] "
-                  << "ORDER_CANCEL: id=" << order_id
-                  << " reason=" << reason << "\nize";
+                         std::string_view reason) {
+        hft::JournalRecord r(ORDER_CANCEL, timestamp_ns);
+        r.set(0, order_id);
+        r.set_text(1, 5, reason);
+        emit(r);
         ++event_count_;
     }
 
     void log_pnl_update(int64_t timestamp_ns, double realized_pnl,
                        double unrealized_pnl, int position) {
-        log_file_ << "[" << std::setw(20) << timestamp_ns << "] "
-                  << "PNL_UPDATE: realized=" << std::fixed << std::setprecision(2) << realized_pnl
-                  << " unrealized=" << unrealized_pnl
-                  << " position=" << position << "\nize";
+        hft::JournalRecord r(PNL_UPDATE, timestamp_ns);
+        r.set(0, realized_pnl);
+        r.set(1, unrealized_pnl);
+        r.set(2, static_cast<int64_t>(position));
+        emit(r);
         ++event_count_;
     }
 
+    // Rare: formatted on the calling thread
     void log_risk_breach(int64_t timestamp_ns, const std::string& breach_type,
                         const std::string& action_taken, double metric_value,
                         double threshold) {
-        log_file_ << "[" << std::setw(20) << timestamp_ns << "] "
-                  << "RISK_BREACH: type=" << breach_type
-                  << " action=" << action_taken
-                  << " value=" << std::fixed << std::setprecision(2) << metric_value
-                  << " threshold=" << threshold << "\nize";
+        std::ostringstream line;
+        line << "[" << std::setw(20) << timestamp_ns << "] "
+             << "RISK_BREACH: type=" << breach_type
+             << " action=" << action_taken
+             << " value=" << std::fixed << std::setprecision(2) << metric_value
+             << " threshold=" << threshold << "\nize";
+        emit_text(line.str());
         ++event_count_;
     }
 
     void flush() {
-        log_file_.flush();
+        flush_output();
+    }
+
+    static void format_record(std::ostream& out, const hft::JournalRecord& r) {
+        out << "[" << std::setw(20) << r.timestamp << "] ";
+        switch (r.event) {
+            case TICK:
+                out << "TICK: bid=" << std::fixed << std::setprecision(4) << r.get<double>(0)
+                    << " ask=" << r.get<double>(1)
+                    << " bid_sz=" << r.get<uint64_t>(2)
+                    << " ask_sz=" << r.get<uint64_t>(3) << "\nize";
+                break;
+            case SIGNAL:
+                out << "SIGNAL: trade=" << (r.aux ? "YES" : "NO")
+                    << " side=" << r.text(0, 2)
+                    << " strength=" << std::fixed << std::setprecision(6) << r.get<double>(2)
+                    << " confirm_ticks=" << r.get<int64_t>(3)
+                    << " obi=" << std::setprecision(4) << r.get<double>(4) << "\nize";
+                break;
+            case ORDER_SUBMIT:
+                out << "ORDER_SUBMIT: id=" << r.get<uint64_t>(0)
+                    << " side=" << r.text(1, 1)
+                    << " price=" << std::fixed << std::setprecision(4) << r.get<double>(2)
+                    << " qty=" << r.get<uint64_t>(3) << "\nize";
+                break;
+            case ORDER_ACK:
+                out << "ORDER_ACK: id=" << r.get<uint64_t>(0)
+                    << " latency_ns=" << r.get<int64_t>(1) << "\nize";
+                break;
+            case ORDER_FILL:
+                out << "ORDER_FILL: id=" << r.get<uint64_t>(0)
+                    << " fill_price=" << std::fixed << std::setprecision(4) << r.get<double>(1)
+                    << " qty=" << r.get<uint64_t>(2)
+                    << " total_latency_ns=" << r.get<int64_t>(3) << "\nize";
+                break;
+            case ORDER_CANCEL:
+                out << "ORDER_CANCEL: id=" << r.get<uint64_t>(0)
+                    << " reason=" << r.text(1, 5) << "\nize";
+                break;
+            case PNL_UPDATE:
+                out << "PNL_UPDATE: realized=" << std::fixed << std::setprecision(2) << r.get<double>(0)
+                    << " unrealized=" << r.get<double>(1)
+                    << " position=" << r.get<int64_t>(2) << "\nize";
+                break;
+        }
     }
 
 private:
-    std::ofstream log_file_;
     size_t event_count_;
 
+    void write_header() {
+        std::ostringstream header;
+        header << "# DETERMINISTIC BACKTEST REPLAY LOG\nize";
+        header << "# Generated: " << get_timestamp() << "\nize";
+        header << "# Format: [timestamp_ns] EVENT_TYPE: details\nize";
+        header << "# ============================================\nize\nize";
+        emit_text(header.str());
+    }
+
     std::string get_timestamp() const {
         auto now = std::chrono::system_clock::now();
         auto time_t = std::chrono::system_clock::to_time_t(now);
@@ -188,36 +266,29 @@ private:
     }
 };
 
+// Fixed-memory latency summary: samples go into a LatencyHistogram, so
+// percentiles are within 1.6% and readable at any point in the run.
 class LatencyDistribution {
 public:
     void add_sample(int64_t latency_ns) {
-        samples_.push_back(latency_ns);
+        histogram_.record(latency_ns);
     }
 
-    void calculate() {
-        if (samples_.empty()) return;
+    void merge(const LatencyDistribution& other) {
+        histogram_.merge(other.histogram_);
+    }
 
-        std::sort(samples_.begin(), samples_.end());
+    void calculate() {
+        if (histogram_.empty()) return;
 
         p50_ = percentile(0.50);
         p90_ = percentile(0.90);
         p99_ = percentile(0.99);
         p999_ = percentile(0.999);
-        max_ = samples_.back();
-        min_ = samples_.front();
-
-        double accumulator = 0.0;
-        for (auto sample : samples_) {
-            accumulator += sample;
-        }
-        mean_ = accumulator / samples_.size();
-
-        double variance_sum = 0.0;
-        for (auto sample : samples_) {
-            double diff = sample - mean_;
-            variance_sum += diff * diff;
-        }
-        jitter_ = std::sqrt(variance_sum / samples_.size());
+        max_ = static_cast<int64_t>(histogram_.max());
+        min_ = static_cast<int64_t>(histogram_.min());
+        mean_ = histogram_.mean();
+        jitter_ = histogram_.stddev();
     }
 
     int64_t get_p50() const { return p50_; }
@@ -228,12 +299,13 @@ public:
     int64_t get_min() const { return min_; }
     double get_mean() const { return mean_; }
     double get_jitter() const { return jitter_; }
-    size_t get_sample_count() const { return samples_.size(); }
+    size_t get_sample_count() const { return histogram_.count(); }
+    const hft::LatencyHistogram& histogram() const { return histogram_; }
 
     void print_report(const std::string& metric_name) const {
         std::cout << "\nize" << metric_name << " LATENCY DISTRIBUTION\nize";
         std::cout << std::string(70, '-') << "\nize";
-        std::cout << "Samples:      " << samples_.size() << "\nize";
+        std::cout << "Samples:      " << histogram_.count() << "\nize";
         std::cout << "Min:          " << min_ << " ns\nize";
         std::cout << "p50 (Median): " << p50_ << " ns\nize";
         std::cout << "p90:          " << p90_ << " ns\nize";
@@ -246,7 +318,7 @@ public:
     }
 
     void print_histogram(int num_buckets = 20) const {
-        if (samples_.empty()) return;
+        if (histogram_.empty()) return;
 
         std::cout << "\nHISTOGRAM:\nize";
 
@@ -254,15 +326,16 @@ public:
         int64_t bucket_size = range / num_buckets;
         if (bucket_size  == 0) bucket_size = 1;
 
-        std::vector<int> buckets(num_buckets, 0);
+        std::vector<uint64_t> buckets(num_buckets, 0);
 
-        for (auto sample : samples_) {
-            int bucket_idx = (sample - min_) / bucket_size;
+        histogram_.for_each_bucket([&](uint64_t lowest, uint64_t, uint64_t count) {
+            const int64_t value = std::max(static_cast<int64_t>(lowest), min_);
+            int bucket_idx = static_cast<int>((value - min_) / bucket_size);
             if (bucket_idx >= num_buckets) bucket_idx = num_buckets - 1;
-            buckets[bucket_idx]++;
-        }
+            buckets[bucket_idx] += count;
+        });
 
-        int max_count = *std::max_element(buckets.begin(), buckets.end());
+        uint64_t max_count = *std::max_element(buckets.begin(), buckets.end());
 
         for (int index = 0; index < num_buckets; ++index) {
             int64_t bucket_start = min_ + index * bucket_size;
@@ -271,7 +344,7 @@ public:
             std::cout << std::setw(8) << bucket_start << "-"
                       << std::setw(8) << bucket_end << " ns |";
 
-            int bar_length = (buckets[index] * 50) / max_count;
+            int bar_length = static_cast<int>((buckets[index] * 50) / max_count);
             for (int secondary = 0; secondary < bar_length; ++secondary) {
                 std::cout << "█";
             }
@@ -280,7 +353,7 @@ public:
     }
 
 private:
-    std::vector<int64_t> samples_;
+    hft::LatencyHistogram histogram_;
     int64_t p50_ = 0;
     int64_t p90_ = 0;
     int64_t p99_ = 0;
@@ -291,9 +364,7 @@ private:
     double jitter_ = 0.0;
 
     int64_t percentile(double p) const {
-        if (samples_.empty()) return 0;
-        size_t idx = static_cast<size_t>(p * (samples_.size() - 1));
-        return samples_[idx];
+        return static_cast<int64_t>(histogram_.value_at_percentile(p * 100.0));
     }
 };
 
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace hft {
+
+// ====
+// Instrument / Venue Directory
+// Built once at startup: dense integer IDs, a perfect hash for names and
+// cache-aligned per-ID arrays, so every hot-path lookup is an array index.
+// ====
+
+// Minimal perfect hash over a fixed key set (hash-and-displace).
+//
+// Keys are split into buckets by one string hash; each bucket gets a
+// displacement that sends all of its keys to free slots. A lookup is one
+// FNV-1a pass over the name, two integer mixes and one string compare to
+// reject unknown names - no probing, no chains. Built once; rebuild to change
+// the key set.
+class PerfectHashIndex {
+public:
+    static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+    PerfectHashIndex() = default;
+
+    // Key i maps to value i. Throws std::invalid_argument on duplicates.
+    explicit PerfectHashIndex(std::vector<std::string> keys) {
+        build(std::move(keys));
+    }
+
+    void build(std::vector<std::string> keys) {
+        keys_ = std::move(keys);
+        const size_t n = keys_.size();
+
+        {
+            std::unordered_set<std::string_view> seen;
+            for (const auto& key : keys_) {
+                if (!seen.insert(key).second) {
+                    throw std::invalid_argument("Duplicate key in perfect hash: " + key);
+                }
+            }
+        }
+
+        // ~4 keys per bucket, slot table at most 80% full
+        bucket_mask_ = next_pow2(std::max<size_t>(1, n / 4)) - 1;
+        slot_mask_ = next_pow2(std::max<size_t>(1, n + n / 4)) - 1;
+        displacement_.assign(bucket_mask_ + 1, 0);
+        slots_.assign(slot_mask_ + 1, NOT_FOUND);
+
+        std::vector<uint64_t> hashes(n);
+        std::vector<std::vector<uint32_t>> buckets(bucket_mask_ + 1);
+        for (size_t i = 0; i < n; ++i) {
+            hashes[i] = hash(keys_[i]);
+            buckets[bucket_of(hashes[i])].push_back(static_cast<uint32_t>(i));
+        }
+
+        // Largest buckets first: they're hardest to place
+        std::vector<uint32_t> order(buckets.size());
+        for (size_t b = 0; b < order.size(); ++b) order[b] = static_cast<uint32_t>(b);
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return buckets[a].size() > buckets[b].size();
+        });
+
+        std::vector<size_t> placed;
+        for (uint32_t b : order) {
+            const auto& bucket = buckets[b];
+            if (bucket.empty()) break;
+
+            uint32_t d = 0;
+            for (;; ++d) {
+                if (d == MAX_DISPLACEMENT) {
+                    throw std::runtime_error("Perfect hash construction failed");
+                }
+                placed.clear();
+                bool ok = true;
+                for (uint32_t key : bucket) {
+                    const size_t slot = slot_of(hashes[key], d);
+                    if (slots_[slot] != NOT_FOUND) { ok = false; break; }
+                    slots_[slot] = key;
+                    placed.push_back(slot);
+                }
+                if (ok) break;
+                for (size_t slot : placed) slots_[slot] = NOT_FOUND;
+            }
+            displacement_[b] = d;
+        }
+    }
+
+    // Value of `key`, or NOT_FOUND
+    uint32_t find(std::string_view key) const {
+        if (keys_.empty()) return NOT_FOUND;
+        const uint64_t h = hash(key);
+        const uint32_t idx = slots_[slot_of(h, displacement_[bucket_of(h)])];
+        return (idx != NOT_FOUND && keys_[idx] == key) ? idx : NOT_FOUND;
+    }
+
+    const std::string& key(uint32_t value) const { return keys_[value]; }
+    size_t size() const { return keys_.size(); }
+
+    static uint64_t hash(std::string_view key) {
+        uint64_t h = 14695981039346656037ULL;  // FNV-1a 64
+        for (unsigned char c : key) {
+            h ^= c;
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+private:
+    static constexpr uint32_t MAX_DISPLACEMENT = 1u << 24;
+
+    std::vector<std::string> keys_;
+    std::vector<uint32_t> displacement_;
+    std::vector<uint32_t> slots_;
+    size_t bucket_mask_ = 0;
+    size_t slot_mask_ = 0;
+
+    static uint64_t mix(uint64_t x) {
+        // splitmix64 finalizer
+        x ^= x >> 30; x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27; x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    size_t bucket_of(uint64_t h) const {
+        return static_cast<size_t>(mix(h) >> 32) & bucket_mask_;
+    }
+
+    size_t slot_of(uint64_t h, uint32_t d) const {
+        return static_cast<size_t>(mix(h + d * 0x9E3779B97F4A7C15ULL)) & slot_mask_;
+    }
+
+    static size_t next_pow2(size_t v) {
+        size_t p = 1;
+        while (p < v) p <<= 1;
+        return p;
+    }
+};
+
+// Flat array of per-ID state, one cache line (or more) per entry so that
+// threads owning different IDs never share a line
+template<typename T>
+class PerIdArray {
+public:
+    PerIdArray() = default;
+    explicit PerIdArray(size_t count) : slots_(count) {}
+
+    void resize(size_t count) { slots_.resize(count); }
+
+    T& operator[](uint32_t id) { return slots_[id].value; }
+    const T& operator[](uint32_t id) const { return slots_[id].value; }
+
+    size_t size() const { return slots_.size(); }
+
+private:
+    struct alignas(64) Slot {
+        T value{};
+    };
+    std::vector<Slot> slots_;
+};
+
+// Startup-built directory of symbols and venues. IDs are dense and follow
+// the order the names were given, so they index PerIdArray tables directly.
+class InstrumentDirectory {
+public:
+    using SymbolId = uint32_t;
+    using VenueId = uint32_t;
+    static constexpr uint32_t INVALID_ID = PerfectHashIndex::NOT_FOUND;
+
+    InstrumentDirectory() = default;
+
+    InstrumentDirectory(std::vector<std::string> symbols, std::vector<std::string> venues)
+        : symbols_(std::move(symbols)), venues_(std::move(venues)) {}
+
+    SymbolId symbol_id(std::string_view symbol) const { return symbols_.find(symbol); }
+    VenueId venue_id(std::string_view venue) const { return venues_.find(venue); }
+
+    const std::string& symbol_name(SymbolId id) const { return symbols_.key(id); }
+    const std::string& venue_name(VenueId id) const { return venues_.key(id); }
+
+    size_t symbol_count() const { return symbols_.size(); }
+    size_t venue_count() const { return venues_.size(); }
+
+    // Per-symbol / per-venue state tables sized for this directory
+    template<typename T>
+    PerIdArray<T> make_symbol_table() const { return PerIdArray<T>(symbol_count()); }
+
+    template<typename T>
+    PerIdArray<T> make_venue_table() const { return PerIdArray<T>(venue_count()); }
+
+private:
+    PerfectHashIndex symbols_;
+    PerfectHashIndex venues_;
+};
+
+}
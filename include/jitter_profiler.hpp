@@ -1,9 +1,10 @@
 #pragma once
 
 #include "common_types.hpp"
-#include <array>
+#include "latency_histogram.hpp"
 #include <atomic>
 #include <algorithm>
+#include <cstdio>
 #include <inttypes.h>
 
 namespace hft {
@@ -15,15 +16,12 @@ namespace hft {
  * Traditional average latency hides tail events. 
  * This class builds a histogram of busy-wait loop cycle deltas. 
  * If the loop is interrupted by the kernel, SMI, or GC, the delta will spike.
+ * The log-linear histogram resolves deltas from single cycles up to
+ * seconds, so the report shows the tail percentiles, not just a max.
  */
 class JitterProfiler {
 public:
-    static constexpr size_t HISTOGRAM_BUCKETS = 20;
-    static constexpr uint64_t BUCKET_WIDTH_CYCLES = 100; // 100 cycles per bucket
-
-    JitterProfiler() : last_tsc_(0), max_jitter_cycles_(0), total_samples_(0), stalled_samples_(0) {
-        histogram_.fill(0);
-    }
+    JitterProfiler() : last_tsc_(0), max_jitter_cycles_(0), total_samples_(0), stalled_samples_(0) {}
     
     // Call this inside the busy-wait loop
     inline void mark() {
@@ -41,9 +39,7 @@ public:
             }
             
             // Add to histogram
-            size_t bucket = delta / BUCKET_WIDTH_CYCLES;
-            if (bucket >= HISTOGRAM_BUCKETS) bucket = HISTOGRAM_BUCKETS - 1;
-            histogram_[bucket]++;
+            histogram_.record(static_cast<int64_t>(delta));
             
             total_samples_++;
         }
@@ -62,20 +58,20 @@ public:
         __builtin_prefetch(reinterpret_cast<const char*>(ptr) + 64, 0, 3);
     }
     
+    // Readable from a monitoring thread while mark() runs
+    const LatencyHistogram& histogram() const { return histogram_; }
+
     void print_report() const {
         printf("\n=== Jitter Analysis (Inter-Cycle Gaps) ===\n");
         printf("Total Samples: %" PRIu64 "\n", total_samples_);
         printf("Stalled Samples (>1000 cycles): %" PRIu64 "\n", stalled_samples_);
         printf("Max Jitter: %" PRIu64 " cycles (~%.2f ns)\n",
-               max_jitter_cycles_, max_jitter_cycles_ / 3.0);  // approx 3GHz
+               max_jitter_cycles_, max_jitter_cycles_ * tsc::ClockService::instance().ns_per_cycle());
 
-        printf("Histogram:\n");
-        for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i) {
-            if (histogram_[i] > 0) {
-                const uint64_t lo = static_cast<uint64_t>(i) * BUCKET_WIDTH_CYCLES;
-                const uint64_t hi = static_cast<uint64_t>(i + 1) * BUCKET_WIDTH_CYCLES;
-                printf("[%" PRIu64 "-%" PRIu64 " cycles]: %" PRIu64 "\n", lo, hi, histogram_[i]);
-            }
+        printf("Percentiles (cycles):\n");
+        const double percentiles[] = {50.0, 90.0, 99.0, 99.9, 99.99};
+        for (double p : percentiles) {
+            printf("  p%-6g %" PRIu64 "\n", p, histogram_.value_at_percentile(p));
         }
         if (stalled_samples_ > 0) {
             printf("[CRITICAL] System interrupts detected! Check CPU isolation.\n");
@@ -89,21 +85,9 @@ private:
     uint64_t max_jitter_cycles_;
     uint64_t total_samples_;
     uint64_t stalled_samples_;
-    std::array<uint64_t, HISTOGRAM_BUCKETS> histogram_;
+    LatencyHistogram histogram_;
     
-    inline uint64_t rdtsc() {
-        #if defined(__x86_64__) || defined(_M_X64)
-            unsigned int lo, hi;
-            __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
-            return ((uint64_t)hi << 32) | lo;
-        #elif defined(__aarch64__)
-            uint64_t val;
-            __asm__ __volatile__("mrs %0, cntvct_el0" : "=r" (val));
-            return val;
-        #else
-            return 0;
-        #endif
-    }
+    inline uint64_t rdtsc() { return tsc::read_counter(); }
 };
 
 }
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "binary_journal.hpp"
+#include "institutional_logging.hpp"
+#include "production_logging.hpp"
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace hft {
+
+// ====
+// Offline Journal Decoder
+// Replays a BinaryJournal into one text file per source, named as the
+// sink's text log would have been, through the sink's own formatter.
+// ====
+class JournalDecoder {
+public:
+    struct Output {
+        std::string path;
+        JournalSourceKind kind;
+        uint64_t records;                       // event and text records
+    };
+
+    /**
+     * @param output_dir Directory for the text logs; empty keeps each
+     *                   source's name as given (relative to the cwd)
+     */
+    static std::vector<Output> decode(const std::string& journal_path, const std::string& output_dir = "") {
+        JournalReader reader(journal_path);
+        std::map<uint16_t, Source> sources;
+
+        for (size_t i = 0; i < reader.size(); ++i) {
+            const JournalRecord r = reader[i];
+            if (r.event == 0) continue;         // unwritten tail of the last window
+
+            if (r.event == JournalRecord::SOURCE_OPEN) {
+                Source& s = sources[r.source];
+                s.kind = static_cast<JournalSourceKind>(r.aux);
+                s.name_remaining = r.get<uint64_t>(0);
+                if (s.name_remaining == 0) s.open(output_dir);
+                continue;
+            }
+
+            auto it = sources.find(r.source);
+            if (it == sources.end()) {
+                throw std::runtime_error("Journal record for unknown source: " + journal_path);
+            }
+            Source& s = it->second;
+
+            if (r.event == JournalRecord::TEXT) {
+                const char* text = reinterpret_cast<const char*>(r.payload);
+                if (s.name_remaining > 0) {
+                    s.name.append(text, r.aux);
+                    s.name_remaining -= std::min<uint64_t>(r.aux, s.name_remaining);
+                    if (s.name_remaining == 0) s.open(output_dir);
+                    continue;
+                }
+                s.out->write(text, r.aux);
+            } else {
+                if (!s.out) {
+                    throw std::runtime_error("Journal source name truncated: " + journal_path);
+                }
+                format(s.kind, *s.out, r);
+            }
+            ++s.records;
+        }
+
+        std::vector<Output> outputs;
+        for (auto& entry : sources) {
+            Source& s = entry.second;
+            if (!s.out) continue;
+            s.out->flush();
+            outputs.push_back({s.path, s.kind, s.records});
+        }
+        return outputs;
+    }
+
+private:
+    struct Source {
+        JournalSourceKind kind{};
+        std::string name;
+        uint64_t name_remaining = 0;
+        std::string path;
+        std::unique_ptr<std::ofstream> out;
+        uint64_t records = 0;
+
+        void open(const std::string& output_dir) {
+            if (output_dir.empty()) {
+                path = name;
+            } else {
+                const size_t slash = name.find_last_of('/');
+                path = output_dir + "/" + (slash == std::string::npos ? name : name.substr(slash + 1));
+            }
+            out = std::make_unique<std::ofstream>(path);
+            if (!out->is_open()) {
+                throw std::runtime_error("Failed to create decoded log: " + path);
+            }
+        }
+    };
+
+    static void format(JournalSourceKind kind, std::ostream& out, const JournalRecord& r) {
+        switch (kind) {
+            case JournalSourceKind::EVENT_REPLAY:   InstitutionalLogging::EventReplayLogger::format_record(out, r); break;
+            case JournalSourceKind::NIC_HARDWARE:   NICHardwareLog::format_record(out, r); break;
+            case JournalSourceKind::STRATEGY_TRACE: StrategyTraceLog::format_record(out, r); break;
+            case JournalSourceKind::EXCHANGE_ACK:   ExchangeACKLog::format_record(out, r); break;
+            case JournalSourceKind::PTP_SYNC:       PTPSyncLog::format_record(out, r); break;
+            case JournalSourceKind::ORDER_GATEWAY:  OrderGatewayLog::format_record(out, r); break;
+        }
+    }
+};
+
+} // namespace hft
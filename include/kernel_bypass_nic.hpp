@@ -1,7 +1,9 @@
 #pragma once
 
 #include "common_types.hpp"
+#include "compact_tick.hpp"
 #include "lockfree_queue.hpp"
+#include <algorithm>
 #include <thread>
 #include <atomic>
 #include <memory>
@@ -68,19 +70,46 @@ public:
     // 
     // This is the critical path function - must be extremely fast
     // 
-    bool get_next_tick(MarketTick& tick) {
+    bool get_next_tick(CompactTick& tick) {
         // Attempt to pop from lock-free queue
         // This is a zero-copy operation - no kernel involvement
         return market_data_queue_.pop(tick);
     }
     
+    // 
+    // Same, expanded into a full MarketTick with the book's current depth
+    // (reuse `tick` across calls; it is overwritten, not reconstructed)
+    // 
+    bool get_next_tick(MarketTick& tick) {
+        CompactTick compact;
+        if (!market_data_queue_.pop(compact)) {
+            return false;
+        }
+        to_market_tick(compact, depth_, tick);
+        return true;
+    }
+    
+    // 
+    // Drain up to max_ticks in one burst (single head publication)
+    // 
+    size_t get_next_ticks(CompactTick* ticks, size_t max_ticks) {
+        return market_data_queue_.pop_bulk(ticks, max_ticks);
+    }
+    
     // 
     // Peek at next tick without removing (for pre-processing)
     // 
-    const MarketTick* peek_next_tick() const {
+    const CompactTick* peek_next_tick() const {
         return market_data_queue_.peek();
     }
     
+    // 
+    // Depth side table referenced by CompactTick::book_id
+    // 
+    const DepthTable& depth() const {
+        return depth_;
+    }
+    
     // 
     // Check if data is available
     // 
@@ -92,7 +121,7 @@ public:
     // Simulate receiving a packet from exchange (producer side)
     // In production: called from NIC interrupt handler or poll-mode driver
     // 
-    bool inject_market_data(const MarketTick& tick) {
+    bool inject_market_data(const CompactTick& tick) {
         if (!is_running_.load(std::memory_order_acquire)) {
             return false;
         }
@@ -102,39 +131,62 @@ public:
         
         if (success) {
             total_packets_received_.fetch_add(1, std::memory_order_relaxed);
-            total_bytes_received_.fetch_add(sizeof(MarketTick), 
+            total_bytes_received_.fetch_add(sizeof(CompactTick), 
                                            std::memory_order_relaxed);
         }
         
         return success;
     }
     
+    // 
+    // Full tick: depth goes to the side table (book = asset_id), BBO to the ring
+    // 
+    bool inject_market_data(const MarketTick& tick) {
+        if (!is_running_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        return inject_market_data(to_compact(tick, depth_, book_for(tick.asset_id)));
+    }
+    
     // 
     // Batch injection for market data bursts (higher throughput)
     // 
-    size_t inject_batch(const MarketTick* ticks, size_t count) {
+    size_t inject_batch(const CompactTick* ticks, size_t count) {
         if (!is_running_.load(std::memory_order_acquire)) {
             return 0;
         }
         
-        size_t injected = 0;
-        for (size_t i = 0; i < count; ++i) {
-            if (market_data_queue_.push(ticks[i])) {
-                ++injected;
-            } else {
-                break;  // Queue full
-            }
-        }
+        // One tail publication for the whole burst (stops early if full)
+        const size_t injected = market_data_queue_.push_bulk(ticks, count);
         
         if (injected > 0) {
             total_packets_received_.fetch_add(injected, std::memory_order_relaxed);
-            total_bytes_received_.fetch_add(injected * sizeof(MarketTick),
+            total_bytes_received_.fetch_add(injected * sizeof(CompactTick),
                                            std::memory_order_relaxed);
         }
         
         return injected;
     }
     
+    size_t inject_batch(const MarketTick* ticks, size_t count) {
+        constexpr size_t CHUNK = 64;
+        CompactTick compact[CHUNK];
+        size_t injected = 0;
+        
+        while (injected < count) {
+            const size_t n = std::min(CHUNK, count - injected);
+            for (size_t i = 0; i < n; ++i) {
+                const MarketTick& tick = ticks[injected + i];
+                compact[i] = to_compact(tick, depth_, book_for(tick.asset_id));
+            }
+            const size_t pushed = inject_batch(compact, n);
+            injected += pushed;
+            if (pushed < n) break;
+        }
+        
+        return injected;
+    }
+    
     // 
     // Simulate raw packet reception (closest to DPDK model)
     // In production: would parse exchange-specific binary protocol
@@ -145,17 +197,17 @@ public:
         // 1. DMA transfers packet directly to pre-allocated hugepage memory
         // 2. No kernel memcpy - NIC writes directly to userspace buffer
         // 3. Parse binary protocol (e.g., ITCH, FAST, SBE)
-        // 4. Construct MarketTick in-place
+        // 4. Construct CompactTick in-place
         
-        MarketTick tick;
+        CompactTick tick;
         
         // Simulate protocol parsing (zero-copy in production)
-        if (packet_size >= sizeof(MarketTick)) {
+        if (packet_size >= sizeof(CompactTick)) {
             // Direct memory interpretation (zero-copy)
-            std::memcpy(&tick, packet_data, sizeof(MarketTick));
-            tick.timestamp = now();  // Kernel-bypass timestamp at NIC
+            std::memcpy(&tick, packet_data, sizeof(CompactTick));
+            tick.timestamp_ns = to_nanos(now());  // Kernel-bypass timestamp at NIC
             
-            return market_data_queue_.emplace(std::move(tick));
+            return market_data_queue_.emplace(tick);
         }
         
         return false;
@@ -219,7 +271,15 @@ private:
     // Lock-free ring buffer (zero-copy queue)
     // Sized as power-of-2 for fast modulo operations
     // 
-    LockFreeQueue<MarketTick, 16384> market_data_queue_;
+    LockFreeQueue<CompactTick, 16384> market_data_queue_;
+    
+    // Depth for books 0..DepthTable::MAX_BOOKS-1; other assets are BBO only
+    DepthTable depth_;
+    
+    static uint16_t book_for(uint32_t asset_id) {
+        return asset_id < DepthTable::MAX_BOOKS ? static_cast<uint16_t>(asset_id)
+                                                : CompactTick::NO_BOOK;
+    }
     
     // 
     // State variables
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace hft {
+
+// Log-linear latency histogram (HdrHistogram layout).
+//
+// Values below 2^SubBucketBits are counted exactly; above that every
+// power-of-two range is split into 2^(SubBucketBits-1) equal buckets, so a
+// reported value is within 2^-(SubBucketBits-1) of the true one (1.6% at
+// the default 7 bits). Values past 2^MaxValueBits - 1 land in the last
+// bucket; max() stays exact. Memory is fixed at BUCKET_COUNT counters.
+//
+// One thread records; any thread may query at any time. Counters are
+// relaxed atomics updated with plain load/store, so recording costs the
+// same as with plain integers and a concurrent reader sees each counter
+// whole (the snapshot as a whole may be a few samples out of step).
+// Give each thread its own instance and merge() them for a combined view.
+template<unsigned SubBucketBits = 7, unsigned MaxValueBits = 40>
+class BasicLatencyHistogram {
+    static_assert(SubBucketBits >= 2 && SubBucketBits < MaxValueBits && MaxValueBits <= 63,
+                  "invalid histogram precision");
+
+public:
+    static constexpr uint64_t SUB_BUCKETS = uint64_t(1) << SubBucketBits;
+    static constexpr uint64_t HALF_BUCKETS = SUB_BUCKETS / 2;
+    static constexpr size_t BUCKET_COUNT = (MaxValueBits - SubBucketBits + 2) * HALF_BUCKETS;
+    static constexpr uint64_t MAX_TRACKABLE = (uint64_t(1) << MaxValueBits) - 1;
+
+    BasicLatencyHistogram() { reset(); }
+
+    BasicLatencyHistogram(const BasicLatencyHistogram& other) {
+        reset();
+        merge(other);
+    }
+
+    BasicLatencyHistogram& operator=(const BasicLatencyHistogram& other) {
+        if (this != &other) {
+            reset();
+            merge(other);
+        }
+        return *this;
+    }
+
+    // Hot path: O(1), no allocation. Negative values count as 0.
+    void record(int64_t value, uint64_t n = 1) {
+        const uint64_t v = value < 0 ? 0 : static_cast<uint64_t>(value);
+        add(counts_[index_of(v)], n);
+        add(total_, n);
+        add(sum_, v * n);
+        put(sum_sq_, get(sum_sq_) + static_cast<double>(v) * static_cast<double>(v) * static_cast<double>(n));
+        if (v < get(min_)) put(min_, v);
+        if (v > get(max_)) put(max_, v);
+    }
+
+    // Adds other's samples (other may be recording concurrently)
+    void merge(const BasicLatencyHistogram& other) {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            const uint64_t c = get(other.counts_[i]);
+            if (c != 0) add(counts_[i], c);
+        }
+        add(total_, get(other.total_));
+        add(sum_, get(other.sum_));
+        put(sum_sq_, get(sum_sq_) + get(other.sum_sq_));
+        put(min_, std::min(get(min_), get(other.min_)));
+        put(max_, std::max(get(max_), get(other.max_)));
+    }
+
+    void reset() {
+        for (auto& c : counts_) put(c, 0);
+        put(total_, 0);
+        put(sum_, 0);
+        put(sum_sq_, 0.0);
+        put(min_, std::numeric_limits<uint64_t>::max());
+        put(max_, 0);
+    }
+
+    uint64_t count() const { return get(total_); }
+    bool empty() const { return count() == 0; }
+    uint64_t min() const { return empty() ? 0 : get(min_); }
+    uint64_t max() const { return get(max_); }
+
+    double mean() const {
+        const uint64_t n = count();
+        return n == 0 ? 0.0 : static_cast<double>(get(sum_)) / static_cast<double>(n);
+    }
+
+    double stddev() const {
+        const uint64_t n = count();
+        if (n == 0) return 0.0;
+        const double m = mean();
+        return std::sqrt(std::max(0.0, get(sum_sq_) / static_cast<double>(n) - m * m));
+    }
+
+    // Value that `percentile`% of samples are at or below, reported as the
+    // top of its bucket so tails are never understated. percentile in [0, 100].
+    uint64_t value_at_percentile(double percentile) const {
+        const uint64_t n = count();
+        if (n == 0) return 0;
+        const double p = std::min(std::max(percentile, 0.0), 100.0);
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p / 100.0 * static_cast<double>(n))));
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += get(counts_[i]);
+            if (seen >= rank) {
+                return std::min(std::max(highest_equivalent(i), min()), max());
+            }
+        }
+        return max();
+    }
+
+    // Samples whose bucket starts in [lo, hi)
+    uint64_t count_between(uint64_t lo, uint64_t hi) const {
+        uint64_t total = 0;
+        for (size_t i = index_of(lo); i < BUCKET_COUNT; ++i) {
+            const uint64_t start = lowest_equivalent(i);
+            if (start >= hi) break;
+            if (start >= lo) total += get(counts_[i]);
+        }
+        return total;
+    }
+
+    // f(lowest, highest, count) for every non-empty bucket, ascending
+    template<typename F>
+    void for_each_bucket(F&& f) const {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            const uint64_t c = get(counts_[i]);
+            if (c != 0) f(lowest_equivalent(i), highest_equivalent(i), c);
+        }
+    }
+
+    static size_t index_of(uint64_t v) {
+        v = std::min(v, MAX_TRACKABLE);
+        const unsigned bucket = 64u - static_cast<unsigned>(__builtin_clzll(v | (SUB_BUCKETS - 1))) - SubBucketBits;
+        return static_cast<size_t>(bucket * HALF_BUCKETS + (v >> bucket));
+    }
+
+    static uint64_t lowest_equivalent(size_t index) {
+        if (index < SUB_BUCKETS) return index;
+        const uint64_t bucket = index / HALF_BUCKETS - 1;
+        return (index - bucket * HALF_BUCKETS) << bucket;
+    }
+
+    static uint64_t highest_equivalent(size_t index) {
+        if (index < SUB_BUCKETS) return index;
+        const uint64_t bucket = index / HALF_BUCKETS - 1;
+        return lowest_equivalent(index) + (uint64_t(1) << bucket) - 1;
+    }
+
+private:
+    template<typename T>
+    static T get(const std::atomic<T>& a) { return a.load(std::memory_order_relaxed); }
+
+    template<typename T, typename V>
+    static void put(std::atomic<T>& a, V v) { a.store(static_cast<T>(v), std::memory_order_relaxed); }
+
+    // Single writer: no read-modify-write needed
+    static void add(std::atomic<uint64_t>& a, uint64_t n) { put(a, get(a) + n); }
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> counts_;
+    std::atomic<uint64_t> total_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<double> sum_sq_;
+    std::atomic<uint64_t> min_;
+    std::atomic<uint64_t> max_;
+};
+
+using LatencyHistogram = BasicLatencyHistogram<>;
+
+} // namespace hft
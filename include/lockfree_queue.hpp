@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <new>
 #include <type_traits>
@@ -14,8 +15,12 @@ class LockFreeQueue {
     static_assert((N & (N - 1)) == 0, "size must be power of 2");
 
 private:
+    // Each side keeps a private copy of the other side's index on its own
+    // cache line and only reloads it when the cached value says full/empty.
     alignas(64) std::atomic<size_t> head_{0};
+    size_t tail_cache_{0};   // Consumer's view of tail_
     alignas(64) std::atomic<size_t> tail_{0};
+    size_t head_cache_{0};   // Producer's view of head_
     
     // Aligned storage to avoid UB with non-trivial types
     struct Node {
@@ -40,8 +45,11 @@ public:
         auto t = tail_.load(std::memory_order_relaxed);
         auto next_t = (t + 1) & (N - 1);
 
-        if (next_t == head_.load(std::memory_order_acquire))
-            return false;
+        if (next_t == head_cache_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (next_t == head_cache_)
+                return false;
+        }
 
         new (&buf_[t].data) T(item);
         tail_.store(next_t, std::memory_order_release);
@@ -51,8 +59,11 @@ public:
     bool pop(T& item) {
         auto h = head_.load(std::memory_order_relaxed);
 
-        if (h == tail_.load(std::memory_order_acquire))
-            return false;
+        if (h == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (h == tail_cache_)
+                return false;
+        }
 
         T* ptr = reinterpret_cast<T*>(&buf_[h].data);
         item = std::move(*ptr);
@@ -62,6 +73,56 @@ public:
         return true;
     }
 
+    // Burst producer: copies up to `count` items, publishes tail once.
+    // Returns the number pushed (less than count only if the queue fills).
+    size_t push_bulk(const T* items, size_t count) {
+        const auto t = tail_.load(std::memory_order_relaxed);
+
+        size_t free_slots = (N - 1) - ((t - head_cache_) & (N - 1));
+        if (free_slots < count) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            free_slots = (N - 1) - ((t - head_cache_) & (N - 1));
+        }
+
+        const size_t n = count < free_slots ? count : free_slots;
+        for (size_t i = 0; i < n; ++i) {
+            new (&buf_[(t + i) & (N - 1)].data) T(items[i]);
+        }
+
+        if (n > 0)
+            tail_.store((t + n) & (N - 1), std::memory_order_release);
+        return n;
+    }
+
+    // Burst consumer: moves up to `max_items` into `out`, publishes head once.
+    size_t pop_bulk(T* out, size_t max_items) {
+        return consume_all([out](T& item) mutable { *out++ = std::move(item); }, max_items);
+    }
+
+    // Invokes f(T&) on every available item (up to max_items) in FIFO order,
+    // destroying each after the call, then releases all slots with one store.
+    template<typename F>
+    size_t consume_all(F&& f, size_t max_items = N) {
+        const auto h = head_.load(std::memory_order_relaxed);
+
+        size_t available = (tail_cache_ - h) & (N - 1);
+        if (available < max_items) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            available = (tail_cache_ - h) & (N - 1);
+        }
+
+        const size_t n = available < max_items ? available : max_items;
+        for (size_t i = 0; i < n; ++i) {
+            T* ptr = reinterpret_cast<T*>(&buf_[(h + i) & (N - 1)].data);
+            f(*ptr);
+            ptr->~T();
+        }
+
+        if (n > 0)
+            head_.store((h + n) & (N - 1), std::memory_order_release);
+        return n;
+    }
+
     bool peek(T& item) const {
         auto h = head_.load(std::memory_order_acquire);
 
@@ -86,8 +147,11 @@ public:
         auto t = tail_.load(std::memory_order_relaxed);
         auto next_t = (t + 1) & (N - 1);
 
-        if (next_t == head_.load(std::memory_order_acquire))
-            return false;
+        if (next_t == head_cache_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (next_t == head_cache_)
+                return false;
+        }
 
         new (&buf_[t].data) T(std::forward<Args>(args)...);
         tail_.store(next_t, std::memory_order_release);
@@ -111,4 +175,251 @@ public:
 template<typename T, size_t N>
 using SPSCQueue = LockFreeQueue<T, N>;
 
+// Bounded queue with per-slot sequence numbers (Vyukov).
+//
+// Each cell carries a sequence that tells producers and consumers whether it
+// is free for position p (seq == p) or holds the item for p (seq == p + 1).
+// Producers claim positions with a CAS on enqueue_pos_; with MultiConsumer
+// the consumers do the same on dequeue_pos_, otherwise the single consumer
+// advances it with a plain store. No locks, and no ABA because positions
+// only grow.
+template<typename T, size_t N, bool MultiConsumer>
+class SequencedQueue {
+    static_assert((N & (N - 1)) == 0, "size must be power of 2");
+    static_assert(N >= 2, "size must be at least 2");
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        alignas(T) char data[sizeof(T)];
+    };
+
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<size_t> dequeue_pos_{0};
+    alignas(64) Cell buf_[N];
+
+    template<typename... Args>
+    bool enqueue(Args&&... args) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &buf_[pos & (N - 1)];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;  // Full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (&cell->data) T(std::forward<Args>(args)...);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+public:
+    SequencedQueue() {
+        for (size_t i = 0; i < N; ++i) {
+            buf_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~SequencedQueue() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            T item;
+            while (pop(item)) {}
+        }
+    }
+
+    SequencedQueue(const SequencedQueue&) = delete;
+    SequencedQueue& operator=(const SequencedQueue&) = delete;
+
+    // Safe from any number of producer threads
+    bool push(const T& item) { return enqueue(item); }
+
+    template<typename... Args>
+    bool emplace(Args&&... args) { return enqueue(std::forward<Args>(args)...); }
+
+    // Safe from any number of consumers if MultiConsumer, else one thread
+    bool pop(T& item) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &buf_[pos & (N - 1)];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if constexpr (MultiConsumer) {
+                    if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                } else {
+                    dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        T* ptr = reinterpret_cast<T*>(&cell->data);
+        item = std::move(*ptr);
+        ptr->~T();
+        cell->sequence.store(pos + N, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate under concurrency
+    size_t size() const {
+        const size_t e = enqueue_pos_.load(std::memory_order_acquire);
+        const size_t d = dequeue_pos_.load(std::memory_order_acquire);
+        return e > d ? e - d : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    size_t capacity() const { return N; }
+};
+
+// Many producers (e.g. strategy threads) -> one consumer (order gateway)
+template<typename T, size_t N>
+using MPSCQueue = SequencedQueue<T, N, false>;
+
+// Many producers -> many consumers
+template<typename T, size_t N>
+using MPMCQueue = SequencedQueue<T, N, true>;
+
+// Single-writer broadcast ring (disruptor style).
+//
+// Every registered reader sees every item, each at its own cursor on its own
+// cache line. The writer is gated by the slowest active reader: it caches the
+// minimum cursor and only rescans readers when that cache says the ring is
+// full, so publishing is one release store in the common case. Readers only
+// ever write their own cursor.
+template<typename T, size_t N, size_t MaxReaders = 8>
+class BroadcastRing {
+    static_assert((N & (N - 1)) == 0, "size must be power of 2");
+    static_assert(std::is_default_constructible_v<T>, "T must be default constructible");
+
+private:
+    struct alignas(64) ReaderCursor {
+        std::atomic<size_t> position{0};
+        std::atomic<bool> active{false};
+    };
+
+    alignas(64) std::atomic<size_t> write_pos_{0};
+    size_t gate_cache_{0};   // Writer's view of the slowest reader
+    alignas(64) ReaderCursor readers_[MaxReaders];
+    alignas(64) T buf_[N];
+
+    size_t slowest_reader(size_t fallback) const {
+        // Pairs with the fence in add_reader(): orders the last write_pos_
+        // store before the active loads below
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        size_t min_pos = fallback;
+        for (size_t i = 0; i < MaxReaders; ++i) {
+            if (readers_[i].active.load(std::memory_order_acquire)) {
+                const size_t p = readers_[i].position.load(std::memory_order_acquire);
+                if (p < min_pos) min_pos = p;
+            }
+        }
+        return min_pos;
+    }
+
+public:
+    static constexpr int NO_READER = -1;
+
+    BroadcastRing() = default;
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    // Join at the current write position (sees only future items).
+    // Returns reader id, or NO_READER if all slots are taken.
+    int add_reader() {
+        for (size_t i = 0; i < MaxReaders; ++i) {
+            bool expected = false;
+            if (!readers_[i].active.compare_exchange_strong(expected, true,
+                                                            std::memory_order_acq_rel))
+                continue;
+            // Store-load against the writer (write_pos_ then active): with a
+            // fence on both sides either this load sees the writer's latest
+            // position or the writer's next rescan sees this reader active.
+            // Until the store below that rescan gates on the slot's previous
+            // position, which is never ahead of the one loaded here.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            readers_[i].position.store(write_pos_.load(std::memory_order_acquire),
+                                       std::memory_order_release);
+            return static_cast<int>(i);
+        }
+        return NO_READER;
+    }
+
+    // Stop gating the writer on this reader
+    void remove_reader(int reader) {
+        readers_[reader].active.store(false, std::memory_order_release);
+    }
+
+    // Writer side (one thread only)
+    bool publish(const T& item) {
+        return publish_bulk(&item, 1) == 1;
+    }
+
+    size_t publish_bulk(const T* items, size_t count) {
+        const size_t w = write_pos_.load(std::memory_order_relaxed);
+
+        if (w + count - gate_cache_ > N) {
+            gate_cache_ = slowest_reader(w);
+        }
+
+        const size_t free_slots = N - (w - gate_cache_);
+        const size_t n = count < free_slots ? count : free_slots;
+        for (size_t i = 0; i < n; ++i) {
+            buf_[(w + i) & (N - 1)] = items[i];
+        }
+
+        if (n > 0)
+            write_pos_.store(w + n, std::memory_order_release);
+        return n;
+    }
+
+    // Reader side (one thread per reader id)
+    bool poll(int reader, T& item) {
+        return consume(reader, [&item](const T& v) { item = v; }, 1) == 1;
+    }
+
+    // Invokes f(const T&) on up to max_items new items, then advances the
+    // reader cursor once.
+    template<typename F>
+    size_t consume(int reader, F&& f, size_t max_items = N) {
+        ReaderCursor& cursor = readers_[reader];
+        const size_t r = cursor.position.load(std::memory_order_relaxed);
+        const size_t available = write_pos_.load(std::memory_order_acquire) - r;
+        const size_t n = available < max_items ? available : max_items;
+
+        for (size_t i = 0; i < n; ++i) {
+            f(static_cast<const T&>(buf_[(r + i) & (N - 1)]));
+        }
+
+        if (n > 0)
+            cursor.position.store(r + n, std::memory_order_release);
+        return n;
+    }
+
+    // Items published but not yet consumed by this reader
+    size_t lag(int reader) const {
+        return write_pos_.load(std::memory_order_acquire) -
+               readers_[reader].position.load(std::memory_order_acquire);
+    }
+
+    size_t published() const { return write_pos_.load(std::memory_order_acquire); }
+
+    size_t capacity() const { return N; }
+};
+
 }
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace hft {
+
+// Read-only mmap of a whole file (RAII)
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    // advice: madvise() hint for the whole mapping (MADV_SEQUENTIAL suits
+    // front-to-back replays, MADV_WILLNEED small blobs read at startup)
+    explicit MappedFile(const std::string& path, int advice = MADV_SEQUENTIAL) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open " + path);
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+
+        if (size_ > 0) {
+            void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Failed to map " + path);
+            }
+            data_ = static_cast<const uint8_t*>(addr);
+            ::madvise(const_cast<uint8_t*>(data_), size_, advice);
+        }
+        ::close(fd);  // Mapping stays valid
+    }
+
+    ~MappedFile() { unmap(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept : data_(other.data_), size_(other.size_) {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            data_ = other.data_;
+            size_ = other.size_;
+            other.data_ = nullptr;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+
+    void unmap() {
+        if (data_) {
+            ::munmap(const_cast<uint8_t*>(data_), size_);
+            data_ = nullptr;
+        }
+    }
+};
+
+} // namespace hft
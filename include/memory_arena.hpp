@@ -0,0 +1,468 @@
+#pragma once
+
+#include "system_determinism.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace hft {
+
+// ====
+// Hot-Path Memory
+// One arena is mapped at startup (hugetlbfs pages, else transparent huge
+// pages), bound to a NUMA node, prefaulted and locked, so the trading loop
+// never takes a page fault or a TLB miss on a fresh 4 KB page. Containers
+// draw from it through ArenaAllocator; freed blocks return to power-of-two
+// size-class free lists and are reused, so steady state neither grows the
+// arena nor calls malloc. Until an arena is installed, and once it is
+// exhausted, allocations fall through to the heap.
+// ====
+
+struct ArenaConfig {
+    size_t bytes = size_t(64) << 20;
+    int numa_node = -1;                // -1: leave placement to the kernel
+    bool huge_pages = true;            // hugetlbfs first, then THP
+    bool lock = true;                  // mlock after prefaulting
+};
+
+// Fixed mapping handed out by a lock-free bump pointer. Nothing is freed
+// until destruction; reuse is ArenaResource's job.
+class HugePageArena {
+public:
+    static constexpr size_t PAGE_4KB = size_t(4) << 10;
+    static constexpr size_t PAGE_2MB = size_t(2) << 20;
+
+    explicit HugePageArena(const ArenaConfig& config = ArenaConfig())
+        : numa_node_(config.numa_node) {
+        using system_determinism::HugePages;
+
+        capacity_ = round_up(std::max<size_t>(config.bytes, PAGE_2MB), PAGE_2MB);
+        if (config.huge_pages) {
+            base_ = static_cast<uint8_t*>(HugePages::allocate_huge(capacity_, HugePages::Size::HUGE_2MB));
+            huge_pages_ = base_ != nullptr;
+        }
+#if defined(__linux__)
+        if (!base_) {
+            void* p = mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) throw std::bad_alloc();
+            base_ = static_cast<uint8_t*>(p);
+    #ifdef MADV_HUGEPAGE
+            if (config.huge_pages) madvise(base_, capacity_, MADV_HUGEPAGE);
+    #endif
+        }
+        if (numa_node_ >= 0) bind_to_node(numa_node_);
+#else
+        if (!base_) {
+            base_ = static_cast<uint8_t*>(std::aligned_alloc(PAGE_4KB, capacity_));
+            if (!base_) throw std::bad_alloc();
+        }
+#endif
+        // Fault every page in now (after binding, so they land on the node)
+        for (size_t off = 0; off < capacity_; off += PAGE_4KB) {
+            reinterpret_cast<volatile uint8_t*>(base_)[off] = 0;
+        }
+        locked_ = config.lock && system_determinism::MemoryLocking::lock_memory(base_, capacity_);
+    }
+
+    ~HugePageArena() {
+#if defined(__linux__)
+        munmap(base_, capacity_);
+#else
+        std::free(base_);
+#endif
+    }
+
+    HugePageArena(const HugePageArena&) = delete;
+    HugePageArena& operator=(const HugePageArena&) = delete;
+
+    // nullptr once the arena is full; align must be a power of two
+    void* allocate(size_t bytes, size_t align) noexcept {
+        size_t used = used_.load(std::memory_order_relaxed);
+        size_t start;
+        do {
+            start = round_up(used, align);
+            if (start > capacity_ || bytes > capacity_ - start) return nullptr;
+        } while (!used_.compare_exchange_weak(used, start + bytes, std::memory_order_relaxed));
+        return base_ + start;
+    }
+
+    bool contains(const void* p) const {
+        const auto* b = static_cast<const uint8_t*>(p);
+        return b >= base_ && b < base_ + capacity_;
+    }
+
+    size_t capacity() const { return capacity_; }
+    size_t used() const { return used_.load(std::memory_order_relaxed); }
+    bool huge_pages() const { return huge_pages_; }   // hugetlbfs (not just a THP hint)
+    bool locked() const { return locked_; }
+    int numa_node() const { return numa_node_; }
+
+private:
+    static size_t round_up(size_t v, size_t align) { return (v + align - 1) & ~(align - 1); }
+
+#if defined(__linux__)
+    // mbind(MPOL_PREFERRED) straight through the syscall, so no libnuma is
+    // needed; the kernel still falls back to other nodes when this one is full
+    void bind_to_node(int node) {
+    #ifdef SYS_mbind
+        if (node >= 64) return;
+        constexpr int MPOL_PREFERRED_MODE = 1;
+        const unsigned long mask = 1UL << node;
+        syscall(SYS_mbind, base_, capacity_, MPOL_PREFERRED_MODE, &mask, 64UL, 0U);
+    #else
+        (void)node;
+    #endif
+    }
+#endif
+
+    uint8_t* base_ = nullptr;
+    size_t capacity_ = 0;
+    std::atomic<size_t> used_{0};
+    int numa_node_;
+    bool huge_pages_ = false;
+    bool locked_ = false;
+};
+
+// Segregated-fit allocator over an arena: every request is rounded up to a
+// power of two (16 B to 64 MB) and served from that class's free list, else
+// carved from the arena; alignment up to 64 bytes. Shared by every thread
+// through a spinlock that is uncontended in practice (allocation happens
+// at startup and on the rare container growth). Without an arena -- or
+// when it runs out -- requests go to operator new.
+class ArenaResource {
+public:
+    static constexpr unsigned MIN_CLASS_BITS = 4;
+    static constexpr unsigned MAX_CLASS_BITS = 26;
+    static constexpr size_t MAX_ALIGN = 64;
+
+    explicit ArenaResource(HugePageArena* arena = nullptr) : arena_(arena) {}
+
+    ArenaResource(const ArenaResource&) = delete;
+    ArenaResource& operator=(const ArenaResource&) = delete;
+
+    // Throws std::bad_alloc
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+        if (arena_ && align <= MAX_ALIGN && bytes <= (size_t(1) << MAX_CLASS_BITS)) {
+            const unsigned cls = class_of(bytes);
+            const size_t size = size_t(1) << cls;
+            lock();
+            void* p = free_[cls];
+            if (p) {
+                free_[cls] = *static_cast<void**>(p);
+            } else {
+                p = arena_->allocate(size, std::min(size, MAX_ALIGN));
+            }
+            unlock();
+            if (p) return p;
+            overflow_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return heap_allocate(bytes, align);
+    }
+
+    void deallocate(void* p, size_t bytes, size_t align = alignof(std::max_align_t)) noexcept {
+        if (!p) return;
+        if (arena_ && arena_->contains(p)) {
+            const unsigned cls = class_of(bytes);
+            lock();
+            *static_cast<void**>(p) = free_[cls];
+            free_[cls] = p;
+            unlock();
+            return;
+        }
+        heap_deallocate(p, align);
+    }
+
+    HugePageArena* arena() const { return arena_; }
+
+    // Requests that wanted the arena but had to go to the heap
+    uint64_t overflow_allocations() const { return overflow_.load(std::memory_order_relaxed); }
+
+private:
+    static unsigned class_of(size_t bytes) {
+        unsigned cls = MIN_CLASS_BITS;
+        while ((size_t(1) << cls) < bytes) ++cls;
+        return cls;
+    }
+
+    static void* heap_allocate(size_t bytes, size_t align) {
+        if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return ::operator new(bytes, std::align_val_t(align));
+        }
+        return ::operator new(bytes);
+    }
+
+    static void heap_deallocate(void* p, size_t align) noexcept {
+        if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(p, std::align_val_t(align));
+        } else {
+            ::operator delete(p);
+        }
+    }
+
+    void lock() {
+        while (lock_.test_and_set(std::memory_order_acquire)) {}
+    }
+
+    void unlock() { lock_.clear(std::memory_order_release); }
+
+    HugePageArena* arena_;
+    std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+    void* free_[MAX_CLASS_BITS + 1] = {};
+    std::atomic<uint64_t> overflow_{0};
+};
+
+// Process-wide resource behind default-constructed ArenaAllocators. A
+// container binds to whatever is installed when it is constructed, so
+// install() belongs at the top of main(), before the engine is built.
+class HotPathMemory {
+public:
+    // Heap-backed until install(); never destroyed (static containers may
+    // free into it during exit)
+    static ArenaResource& resource() {
+        ArenaResource* r = current().load(std::memory_order_acquire);
+        return r ? *r : heap_resource();
+    }
+
+    // Maps the arena; throws std::logic_error if one is already installed
+    // and std::bad_alloc if it cannot be mapped
+    static HugePageArena& install(const ArenaConfig& config = ArenaConfig()) {
+        if (current().load(std::memory_order_acquire)) {
+            throw std::logic_error("Hot-path arena already installed");
+        }
+        auto* arena = new HugePageArena(config);
+        current().store(new ArenaResource(arena), std::memory_order_release);
+        return *arena;
+    }
+
+    static bool installed() { return current().load(std::memory_order_acquire) != nullptr; }
+
+private:
+    static std::atomic<ArenaResource*>& current() {
+        static std::atomic<ArenaResource*> resource{nullptr};
+        return resource;
+    }
+
+    static ArenaResource& heap_resource() {
+        static ArenaResource* heap = new ArenaResource();
+        return *heap;
+    }
+};
+
+// STL allocator over an ArenaResource (the installed one by default).
+// Copies share the resource, so containers may be moved and swapped freely.
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator() noexcept : resource_(&HotPathMemory::resource()) {}
+    explicit ArenaAllocator(ArenaResource& resource) noexcept : resource_(&resource) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : resource_(other.resource()) {}
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+        return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        resource_->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    ArenaResource* resource() const { return resource_; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return resource_ == other.resource(); }
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return resource_ != other.resource(); }
+
+private:
+    ArenaResource* resource_;
+};
+
+template<typename T>
+using HotVector = std::vector<T, ArenaAllocator<T>>;
+
+// Typed fixed-size pool for one owning thread: objects come from chunks of
+// ChunkObjects slots taken from the resource, and destroyed objects go back
+// on a private free list (no lock, no size-class lookup).
+template<typename T, size_t ChunkObjects = 256>
+class ObjectPool {
+public:
+    explicit ObjectPool(size_t reserve = 0, ArenaResource& resource = HotPathMemory::resource())
+        : resource_(&resource) {
+        while (capacity_ < reserve) grow();
+    }
+
+    // Objects still alive are not destroyed
+    ~ObjectPool() {
+        for (Slot* chunk : chunks_) {
+            resource_->deallocate(chunk, ChunkObjects * sizeof(Slot), alignof(Slot));
+        }
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template<typename... Args>
+    T* create(Args&&... args) {
+        if (!free_) grow();
+        Slot* slot = free_;
+        free_ = slot->next;
+        T* obj = new (slot->storage) T(std::forward<Args>(args)...);
+        ++live_;
+        return obj;
+    }
+
+    void destroy(T* obj) {
+        if (!obj) return;
+        obj->~T();
+        Slot* slot = reinterpret_cast<Slot*>(obj);
+        slot->next = free_;
+        free_ = slot;
+        --live_;
+    }
+
+    size_t live() const { return live_; }
+    size_t capacity() const { return capacity_; }
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    void grow() {
+        auto* chunk = static_cast<Slot*>(resource_->allocate(ChunkObjects * sizeof(Slot), alignof(Slot)));
+        chunks_.push_back(chunk);
+        for (size_t i = ChunkObjects; i-- > 0;) {
+            chunk[i].next = free_;
+            free_ = &chunk[i];
+        }
+        capacity_ += ChunkObjects;
+    }
+
+    ArenaResource* resource_;
+    std::vector<Slot*> chunks_;
+    Slot* free_ = nullptr;
+    size_t capacity_ = 0;
+    size_t live_ = 0;
+};
+
+// ====
+// Steady-State Allocation Check
+// Debug builds replace global operator new in one translation unit with
+// HFT_DEFINE_ALLOCATION_TRACKING(). A thread then brackets its steady state
+// with arm()/disarm(); every heap allocation it makes in between is
+// counted (size of the latest kept) and reported.
+// ====
+
+class SteadyStateAllocations {
+public:
+    static void arm() { armed() = true; }
+    static void disarm() { armed() = false; }
+    static bool is_armed() { return armed(); }
+
+    // False unless this binary expanded HFT_DEFINE_ALLOCATION_TRACKING()
+    static bool tracking() { return state().installed.load(std::memory_order_relaxed); }
+
+    static uint64_t count() { return state().count.load(std::memory_order_relaxed); }
+    static uint64_t bytes() { return state().bytes.load(std::memory_order_relaxed); }
+
+    static void reset() {
+        state().count.store(0, std::memory_order_relaxed);
+        state().bytes.store(0, std::memory_order_relaxed);
+    }
+
+    // Called from the replaced operator new; must not allocate
+    static void record(size_t n) {
+        if (!armed()) return;
+        State& s = state();
+        s.count.fetch_add(1, std::memory_order_relaxed);
+        s.bytes.fetch_add(n, std::memory_order_relaxed);
+        s.last_size.store(n, std::memory_order_relaxed);
+    }
+
+    static void mark_installed() { state().installed.store(true, std::memory_order_relaxed); }
+
+    static void print_report() {
+        if (!tracking()) return;
+        const State& s = state();
+        if (count() == 0) {
+            printf("[PASS] No heap allocations in steady state.\n");
+        } else {
+            printf("[WARN] %" PRIu64 " steady-state heap allocations (%" PRIu64 " bytes, last %zu bytes)\n",
+                   count(), bytes(), static_cast<size_t>(s.last_size.load(std::memory_order_relaxed)));
+        }
+    }
+
+private:
+    struct State {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> last_size{0};
+        std::atomic<bool> installed{false};
+    };
+
+    static State& state() {
+        static State s;
+        return s;
+    }
+
+    static bool& armed() {
+        static thread_local bool flag = false;
+        return flag;
+    }
+};
+
+} // namespace hft
+
+#ifdef HFT_TRACK_ALLOCATIONS
+    // Expand once, at namespace scope, in the program's main translation unit
+    #define HFT_DEFINE_ALLOCATION_TRACKING()                                                     \
+        void* operator new(std::size_t n) {                                                      \
+            ::hft::SteadyStateAllocations::record(n);                                            \
+            if (void* p = std::malloc(n ? n : 1)) return p;                                      \
+            throw std::bad_alloc();                                                              \
+        }                                                                                        \
+        void* operator new[](std::size_t n) { return ::operator new(n); }                        \
+        void* operator new(std::size_t n, std::align_val_t a) {                                  \
+            ::hft::SteadyStateAllocations::record(n);                                            \
+            const std::size_t align = static_cast<std::size_t>(a);                               \
+            if (void* p = std::aligned_alloc(align, (n + align - 1) / align * align)) return p;  \
+            throw std::bad_alloc();                                                              \
+        }                                                                                        \
+        void* operator new[](std::size_t n, std::align_val_t a) { return ::operator new(n, a); } \
+        void operator delete(void* p) noexcept { std::free(p); }                                 \
+        void operator delete[](void* p) noexcept { std::free(p); }                               \
+        void operator delete(void* p, std::size_t) noexcept { std::free(p); }                    \
+        void operator delete[](void* p, std::size_t) noexcept { std::free(p); }                  \
+        void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }               \
+        void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }             \
+        void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }  \
+        void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }\
+        static const bool hft_allocation_tracking_installed =                                    \
+            (::hft::SteadyStateAllocations::mark_installed(), true);
+#else
+    #define HFT_DEFINE_ALLOCATION_TRACKING()
+#endif
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "csv_parser.hpp"
+#include "mapped_file.hpp"
+#include "tick_store.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hft {
+namespace backtest {
+
+// ====
+// Merged Replay
+// Many time-ordered per-symbol / per-venue files -> one time-ordered stream.
+// Each source is read front to back in place (mmap); the merge holds one
+// buffered event per source, so nothing is concatenated or sorted up front.
+// ====
+
+// Keep the asset IDs recorded in the data
+constexpr uint32_t ASSET_FROM_DATA = std::numeric_limits<uint32_t>::max();
+
+template<typename Event>
+class ReplaySource {
+public:
+    virtual ~ReplaySource() = default;
+
+    // Next event in file order; false at the end
+    virtual bool next(Event& event) = 0;
+    // Back to the first event (for repeated runs over the same data)
+    virtual void rewind() = 0;
+    virtual const std::string& name() const = 0;
+};
+
+// Streams a CSV one line at a time from the mapping. `asset_id` tags every
+// event (the CSV schema has no asset column).
+template<typename Event>
+class CsvReplaySource : public ReplaySource<Event> {
+public:
+    CsvReplaySource(const std::string& path, uint32_t asset_id)
+        : path_(path), file_(path), asset_id_(asset_id) {
+        rewind();
+    }
+
+    bool next(Event& event) override {
+        const char* end = begin() + file_.size();
+        bool parsed = false;
+        while (!parsed && cursor_ < end) {
+            const char* nl = static_cast<const char*>(std::memchr(cursor_, '\n', end - cursor_));
+            const char* line_end = nl ? nl : end;
+            csv::parse_range<Event>(cursor_, line_end, [&](const Event& e) {
+                event = e;
+                parsed = true;
+            });
+            cursor_ = nl ? nl + 1 : end;
+        }
+        if (!parsed) return false;
+        if (asset_id_ != ASSET_FROM_DATA) event.asset_id = asset_id_;
+        check_order(event.timestamp_ns);
+        return true;
+    }
+
+    void rewind() override {
+        cursor_ = begin();
+        last_ns_ = std::numeric_limits<int64_t>::min();
+    }
+
+    const std::string& name() const override { return path_; }
+
+private:
+    const char* begin() const { return reinterpret_cast<const char*>(file_.data()); }
+
+    void check_order(int64_t ts) {
+        if (ts < last_ns_) {
+            throw std::runtime_error("Replay source is not in timestamp order: " + path_);
+        }
+        last_ns_ = ts;
+    }
+
+    std::string path_;
+    MappedFile file_;
+    uint32_t asset_id_;
+    const char* cursor_ = nullptr;
+    int64_t last_ns_ = std::numeric_limits<int64_t>::min();
+};
+
+// Walks a tick store (which must be sorted) by index; the reader may be
+// shared with other sources or engines
+template<typename Event>
+class TickStoreReplaySource : public ReplaySource<Event> {
+public:
+    TickStoreReplaySource(const std::string& path, uint32_t asset_id = ASSET_FROM_DATA)
+        : TickStoreReplaySource(std::make_shared<const TickStoreReader>(path), path, asset_id) {}
+
+    TickStoreReplaySource(std::shared_ptr<const TickStoreReader> reader, std::string name,
+                          uint32_t asset_id = ASSET_FROM_DATA)
+        : reader_(std::move(reader)), name_(std::move(name)), asset_id_(asset_id) {
+        if (!reader_->is_sorted()) {
+            throw std::runtime_error("Replay source is not in timestamp order: " + name_);
+        }
+    }
+
+    bool next(Event& event) override {
+        if (pos_ >= reader_->size()) return false;
+        reader_->read(pos_++, event);
+        if (asset_id_ != ASSET_FROM_DATA) event.asset_id = asset_id_;
+        return true;
+    }
+
+    void rewind() override { pos_ = 0; }
+    const std::string& name() const override { return name_; }
+    size_t size() const { return reader_->size(); }
+
+private:
+    std::shared_ptr<const TickStoreReader> reader_;
+    std::string name_;
+    uint32_t asset_id_;
+    size_t pos_ = 0;
+};
+
+// Binary min-heap over the sources' head events, ordered by timestamp and
+// then by the order the sources were added, so equal timestamps replay
+// the same way every run
+template<typename Event>
+class MergedReplay {
+public:
+    void add(std::unique_ptr<ReplaySource<Event>> source) {
+        sources_.push_back(std::move(source));
+        heads_.emplace_back();
+        primed_ = false;
+    }
+
+    void clear() {
+        sources_.clear();
+        heads_.clear();
+        heap_.clear();
+        primed_ = false;
+    }
+
+    // Rewinds every source and loads its first event
+    void rewind() {
+        heap_.clear();
+        delivered_ = 0;
+        for (size_t s = 0; s < sources_.size(); ++s) {
+            sources_[s]->rewind();
+            refill(static_cast<uint32_t>(s));
+        }
+        primed_ = true;
+    }
+
+    // Next event across all sources in timestamp order; false when all are done
+    bool next(Event& event) {
+        if (!primed_) rewind();
+        if (heap_.empty()) return false;
+
+        std::pop_heap(heap_.begin(), heap_.end(), later);
+        const uint32_t s = heap_.back().source;
+        heap_.pop_back();
+        std::swap(event, heads_[s]);
+        refill(s);
+        ++delivered_;
+        return true;
+    }
+
+    bool empty() const { return sources_.empty(); }
+    size_t source_count() const { return sources_.size(); }
+    const ReplaySource<Event>& source(size_t i) const { return *sources_.at(i); }
+    uint64_t delivered() const { return delivered_; }
+
+private:
+    struct Head {
+        int64_t timestamp_ns;
+        uint32_t source;
+    };
+
+    static bool later(const Head& a, const Head& b) {
+        return a.timestamp_ns != b.timestamp_ns ? a.timestamp_ns > b.timestamp_ns : a.source > b.source;
+    }
+
+    void refill(uint32_t s) {
+        if (!sources_[s]->next(heads_[s])) return;
+        heap_.push_back(Head{heads_[s].timestamp_ns, s});
+        std::push_heap(heap_.begin(), heap_.end(), later);
+    }
+
+    std::vector<std::unique_ptr<ReplaySource<Event>>> sources_;
+    std::vector<Event> heads_;              // One buffered event per source
+    std::vector<Head> heap_;
+    uint64_t delivered_ = 0;
+    bool primed_ = false;
+};
+
+} // namespace backtest
+} // namespace hft
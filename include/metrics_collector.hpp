@@ -2,11 +2,12 @@
 #define METRICS_COLLECTOR_HPP
 
 #include "common_types.hpp"
+#include "snapshot_ring.hpp"
+#include <algorithm>
 #include <atomic>
-#include <mutex>
-#include <deque>
 #include <chrono>
 #include <fstream>
+#include <vector>
 
 struct TradingMetrics {
 
@@ -64,12 +65,17 @@ struct MetricSnapshot {
     double position_limit_usage;
 };
 
+// Snapshots go into a preallocated SnapshotRing: take_snapshot() (one
+// thread, normally the trading loop) never locks or allocates, and the
+// dashboard and reports read history concurrently without blocking it.
+// history_size is rounded up to a power of two.
 class MetricsCollector {
 public:
     explicit MetricsCollector(size_t history_size = 10000)
         : history_size_(history_size),
           metrics_(),
-          running_(true) {
+          running_(true),
+          snapshots_(history_size) {
     }
 
     ~MetricsCollector() {
@@ -95,34 +101,32 @@ public:
         snap.regime = metrics_.current_regime.load(std::memory_order_acquire);
         snap.position_limit_usage = metrics_.position_limit_usage.load(std::memory_order_acquire);
 
-        std::lock_guard<std::mutex> lock(snapshots_mutex_);
-        snapshots_.push_back(snap);
-
-        if (snapshots_.size() > history_size_) {
-            snapshots_.pop_front();
-        }
+        snapshots_.publish(snap);
     }
 
-    std::vector<MetricSnapshot> get_recent_snapshots(size_t count = 1000) {
-        std::lock_guard<std::mutex> lock(snapshots_mutex_);
+    std::vector<MetricSnapshot> get_recent_snapshots(size_t count = 1000) const {
+        std::vector<MetricSnapshot> recent;
+        recent.reserve(std::min(count, snapshots_.capacity()));
+        snapshots_.visit_recent(count, [&](uint64_t, const MetricSnapshot& snap) {
+            recent.push_back(snap);
+        });
+        return recent;
+    }
 
-        size_t start = (snapshots_.size() > count) ? (snapshots_.size() - count) : 0;
-        return std::vector<MetricSnapshot>(
-            snapshots_.begin() + start,
-            snapshots_.end()
-        );
+    // Lock-free history for streaming readers (see SnapshotRing::visit)
+    const hft::SnapshotRing<MetricSnapshot>& snapshots() const {
+        return snapshots_;
     }
 
-    void export_to_csv(const std::string& filename) {
-        std::lock_guard<std::mutex> lock(snapshots_mutex_);
+    void export_to_csv(const std::string& filename) const {
         std::ofstream file(filename);
 
         file<<"timestamp_ns,mid_price,spread_bps,pnl,position,"<<"buy_intensity,sell_intensity,latency_us,orders_sent,"<<"orders_filled,regime,position_limit_usage\n";
 
-        for (const auto& snap : snapshots_) {
-        file<<snap.timestamp_ns<<","<<snap.mid_price<<","<<snap.spread_bps<<","<<snap.pnl<<","<<snap.position<<","<<snap.buy_intensity<<","<<snap.sell_intensity<<","<<snap.cycle_latency_us<<","<<snap.orders_sent<<","<<snap.orders_filled<<","<<snap.regime<<","<<snap.position_limit_usage<<"\n";
-        }
-            }
+        snapshots_.visit(0, [&](uint64_t, const MetricSnapshot& snap) {
+            file<<snap.timestamp_ns<<","<<snap.mid_price<<","<<snap.spread_bps<<","<<snap.pnl<<","<<snap.position<<","<<snap.buy_intensity<<","<<snap.sell_intensity<<","<<snap.cycle_latency_us<<","<<snap.orders_sent<<","<<snap.orders_filled<<","<<snap.regime<<","<<snap.position_limit_usage<<"\n";
+        });
+    }
 
                  struct SummaryStats {
                  double avg_pnl;
@@ -136,40 +140,41 @@ public:
         double fill_rate;
     };
 
-    SummaryStats get_summary() {
-    std::lock_guard<std::mutex> lock(snapshots_mutex_);
-
+    SummaryStats get_summary() const {
         SummaryStats stats{};
-        if (snapshots_.empty()) return stats;
 
         double sum_pnl = 0.0;
         double max_pnl = -1e9;
         double min_pnl = 1e9;
         double sum_latency = 0.0;
         double max_latency = 0.0;
-
-    for (const auto& snap : snapshots_) {
-    sum_pnl += snap.pnl;
-        max_pnl = std::max(max_pnl, snap.pnl);
-        min_pnl = std::min(min_pnl, snap.pnl);
-        sum_latency += snap.cycle_latency_us;
-        max_latency = std::max(max_latency, snap.cycle_latency_us);
-        }
-
-        stats.avg_pnl = sum_pnl / snapshots_.size();
+        size_t count = 0;
+        MetricSnapshot last_snap{};
+
+        snapshots_.visit(0, [&](uint64_t, const MetricSnapshot& snap) {
+            sum_pnl += snap.pnl;
+            max_pnl = std::max(max_pnl, snap.pnl);
+            min_pnl = std::min(min_pnl, snap.pnl);
+            sum_latency += snap.cycle_latency_us;
+            max_latency = std::max(max_latency, snap.cycle_latency_us);
+            last_snap = snap;
+            ++count;
+        });
+        if (count == 0) return stats;
+
+        stats.avg_pnl = sum_pnl / count;
         stats.max_pnl = max_pnl;
         stats.min_pnl = min_pnl;
-        stats.avg_latency_us = sum_latency / snapshots_.size();
+        stats.avg_latency_us = sum_latency / count;
         stats.max_latency_us = max_latency;
 
-            auto last_snap = snapshots_.back();
-            stats.total_trades = last_snap.orders_filled;
-            stats.fill_rate = (last_snap.orders_sent > 0)
+        stats.total_trades = last_snap.orders_filled;
+        stats.fill_rate = (last_snap.orders_sent > 0)
             ? (double)last_snap.orders_filled / last_snap.orders_sent
             : 0.0;
 
         return stats;
-        }
+    }
 
         void update_cycle_latency(double latency_us) {
         metrics_.avg_cycle_latency_us.store(latency_us, std::memory_order_release);
@@ -233,8 +238,7 @@ public:
             TradingMetrics metrics_;
             std::atomic<bool> running_;
 
-    std::deque<MetricSnapshot> snapshots_;
-    std::mutex snapshots_mutex_;
+    hft::SnapshotRing<MetricSnapshot> snapshots_;
     };
 
         #endif
\ No newline at end of file
@@ -0,0 +1,176 @@
+#ifndef METRICS_FRAME_HPP
+#define METRICS_FRAME_HPP
+
+#include "metrics_collector.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Binary dashboard frames: a batch of MetricSnapshots, delta-encoded.
+//
+// Layout (little-endian):
+//   FrameHeader, then `count` records. Each record is a uint16 mask of the
+//   fields that differ from the previous record, followed by those fields:
+//   integer fields as a zigzag varint of the difference, doubles as their
+//   raw 8 bytes. The first record is diffed against an all-zero snapshot,
+//   so every frame decodes on its own; a client can join at any frame.
+namespace metrics_frame {
+
+constexpr uint32_t MAGIC = 0x4D544648;          // "HFTM"
+constexpr uint8_t VERSION = 1;
+
+enum Kind : uint8_t { UPDATE = 1, HISTORY = 2 };
+
+#pragma pack(push, 1)
+struct FrameHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t kind;
+    uint16_t count;
+    uint64_t first_index;                       // SnapshotRing index of record 0
+};
+#pragma pack(pop)
+static_assert(sizeof(FrameHeader) == 16, "FrameHeader layout");
+
+constexpr size_t MAX_RECORDS = 0xFFFF;
+
+enum Field : uint16_t {
+    TIMESTAMP = 1 << 0, MID_PRICE = 1 << 1, SPREAD = 1 << 2, PNL = 1 << 3,
+    POSITION = 1 << 4, BUY_INTENSITY = 1 << 5, SELL_INTENSITY = 1 << 6, LATENCY = 1 << 7,
+    ORDERS_SENT = 1 << 8, ORDERS_FILLED = 1 << 9, REGIME = 1 << 10, POSITION_USAGE = 1 << 11
+};
+
+namespace detail {
+
+inline void put_varint(std::string& out, int64_t delta) {
+    uint64_t v = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+inline bool get_varint(const unsigned char*& p, const unsigned char* end, int64_t& delta) {
+    uint64_t v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (p == end) return false;
+        const unsigned char b = *p++;
+        v |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if ((b & 0x80) == 0) {
+            delta = static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool same(double a, double b) { return std::memcmp(&a, &b, sizeof(double)) == 0; }
+
+// fn(bit, field of s, same field of prev) in wire order
+template<typename Fn>
+inline void for_each_field(MetricSnapshot& s, const MetricSnapshot& prev, Fn&& fn) {
+    fn(TIMESTAMP, s.timestamp_ns, prev.timestamp_ns);
+    fn(MID_PRICE, s.mid_price, prev.mid_price);
+    fn(SPREAD, s.spread_bps, prev.spread_bps);
+    fn(PNL, s.pnl, prev.pnl);
+    fn(POSITION, s.position, prev.position);
+    fn(BUY_INTENSITY, s.buy_intensity, prev.buy_intensity);
+    fn(SELL_INTENSITY, s.sell_intensity, prev.sell_intensity);
+    fn(LATENCY, s.cycle_latency_us, prev.cycle_latency_us);
+    fn(ORDERS_SENT, s.orders_sent, prev.orders_sent);
+    fn(ORDERS_FILLED, s.orders_filled, prev.orders_filled);
+    fn(REGIME, s.regime, prev.regime);
+    fn(POSITION_USAGE, s.position_limit_usage, prev.position_limit_usage);
+}
+
+} // namespace detail
+
+// Appends records to one frame; reuse across frames with reset()
+class Encoder {
+public:
+    void reset(Kind kind, uint64_t first_index) {
+        buffer_.resize(sizeof(FrameHeader));
+        header_ = FrameHeader{MAGIC, VERSION, kind, 0, first_index};
+        prev_ = MetricSnapshot{};
+    }
+
+    bool full() const { return header_.count == MAX_RECORDS; }
+    uint16_t count() const { return header_.count; }
+
+    void add(const MetricSnapshot& snap) {
+        MetricSnapshot cur = snap;
+        const size_t mask_pos = buffer_.size();
+        buffer_.append(2, '\0');
+        uint16_t mask = 0;
+
+        detail::for_each_field(cur, prev_, [&](uint16_t bit, auto& field, const auto& old) {
+            using V = std::decay_t<decltype(field)>;
+            if constexpr (std::is_floating_point_v<V>) {
+                if (detail::same(field, old)) return;
+                buffer_.append(reinterpret_cast<const char*>(&field), sizeof(double));
+            } else {
+                if (field == old) return;
+                detail::put_varint(buffer_, static_cast<int64_t>(static_cast<uint64_t>(field) - static_cast<uint64_t>(old)));
+            }
+            mask |= bit;
+        });
+
+        std::memcpy(&buffer_[mask_pos], &mask, sizeof(mask));
+        prev_ = snap;
+        ++header_.count;
+    }
+
+    // Finished frame; valid until the next reset()
+    const std::string& finish() {
+        std::memcpy(&buffer_[0], &header_, sizeof(header_));
+        return buffer_;
+    }
+
+private:
+    std::string buffer_;
+    FrameHeader header_{};
+    MetricSnapshot prev_{};
+};
+
+// Appends the frame's snapshots to `out`; false on a malformed frame
+inline bool decode(const void* data, size_t size, FrameHeader& header, std::vector<MetricSnapshot>& out) {
+    if (size < sizeof(FrameHeader)) return false;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION) return false;
+
+    const unsigned char* p = static_cast<const unsigned char*>(data) + sizeof(header);
+    const unsigned char* end = static_cast<const unsigned char*>(data) + size;
+    MetricSnapshot cur{};
+
+    for (uint16_t r = 0; r < header.count; ++r) {
+        if (end - p < 2) return false;
+        uint16_t mask;
+        std::memcpy(&mask, p, sizeof(mask));
+        p += sizeof(mask);
+
+        bool ok = true;
+        detail::for_each_field(cur, cur, [&](uint16_t bit, auto& field, const auto&) {
+            using V = std::decay_t<decltype(field)>;
+            if (!ok || (mask & bit) == 0) return;
+            if constexpr (std::is_floating_point_v<V>) {
+                if (end - p < 8) { ok = false; return; }
+                std::memcpy(&field, p, sizeof(double));
+                p += sizeof(double);
+            } else {
+                int64_t delta;
+                if (!detail::get_varint(p, end, delta)) { ok = false; return; }
+                field = static_cast<V>(static_cast<uint64_t>(field) + static_cast<uint64_t>(delta));
+            }
+        });
+        if (!ok) return false;
+        out.push_back(cur);
+    }
+    return p == end;
+}
+
+} // namespace metrics_frame
+
+#endif // METRICS_FRAME_HPP
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "mapped_file.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace hft {
+
+// ====
+// Binary Model Files
+// A shape header followed by 64-byte-aligned float64 weight and bias blobs,
+// written once by the training pipeline and mmapped read-only at startup.
+// Loading is a header check plus pointer arithmetic: no text, no parsing.
+// Weights are row-major by output neuron (w[out * inputs + in]), the layout
+// the inference kernels consume.
+// ====
+
+namespace model_file {
+
+constexpr char MAGIC[8] = {'H', 'F', 'T', 'M', 'O', 'D', 'E', 'L'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t MAX_LAYERS = 8;
+constexpr size_t BLOB_ALIGN = 64;
+
+struct LayerHeader {
+    uint32_t inputs;
+    uint32_t outputs;
+    uint64_t weight_offset;            // inputs * outputs doubles
+    uint64_t bias_offset;              // outputs doubles
+};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t layer_count;
+    uint64_t file_size;
+    LayerHeader layers[MAX_LAYERS];
+};
+
+inline size_t align_up(size_t v) {
+    return (v + BLOB_ALIGN - 1) & ~(BLOB_ALIGN - 1);
+}
+
+} // namespace model_file
+
+// Compile-time network shape: a chain of dense layers
+template<size_t In, size_t Out>
+struct DenseLayer {
+    static constexpr size_t INPUTS = In;
+    static constexpr size_t OUTPUTS = Out;
+};
+
+template<typename... Layers>
+struct NetworkDef {
+    static constexpr size_t LAYER_COUNT = sizeof...(Layers);
+    static constexpr std::array<size_t, LAYER_COUNT> INPUTS = {Layers::INPUTS...};
+    static constexpr std::array<size_t, LAYER_COUNT> OUTPUTS = {Layers::OUTPUTS...};
+
+    static_assert(LAYER_COUNT > 0 && LAYER_COUNT <= model_file::MAX_LAYERS, "NetworkDef: layer count");
+    static_assert([] {
+        for (size_t i = 1; i < LAYER_COUNT; ++i) {
+            if (INPUTS[i] != OUTPUTS[i - 1]) return false;
+        }
+        return true;
+    }(), "NetworkDef: layer dimensions do not chain");
+
+    static constexpr size_t INPUT_SIZE = INPUTS[0];
+    static constexpr size_t OUTPUT_SIZE = OUTPUTS[LAYER_COUNT - 1];
+};
+
+// Dense layer data for ModelFileWriter (pointers into caller storage)
+struct DenseLayerData {
+    uint32_t inputs;
+    uint32_t outputs;
+    const double* weights;
+    const double* bias;
+};
+
+class ModelFileWriter {
+public:
+    static void write(const std::string& path, const std::vector<DenseLayerData>& layers) {
+        using namespace model_file;
+
+        if (layers.empty() || layers.size() > MAX_LAYERS) {
+            throw std::invalid_argument("Model file needs 1-8 layers: " + path);
+        }
+
+        FileHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.layer_count = static_cast<uint32_t>(layers.size());
+
+        size_t offset = align_up(sizeof(FileHeader));
+        for (size_t i = 0; i < layers.size(); ++i) {
+            if (i > 0 && layers[i].inputs != layers[i - 1].outputs) {
+                throw std::invalid_argument("Model layer dimensions do not chain: " + path);
+            }
+            LayerHeader& l = header.layers[i];
+            l.inputs = layers[i].inputs;
+            l.outputs = layers[i].outputs;
+            l.weight_offset = offset;
+            offset = align_up(offset + sizeof(double) * l.inputs * l.outputs);
+            l.bias_offset = offset;
+            offset = align_up(offset + sizeof(double) * l.outputs);
+        }
+        header.file_size = offset;
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Failed to create model file: " + path);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        size_t written = sizeof(header);
+        auto pad_to = [&](size_t target) {
+            static const char zeros[BLOB_ALIGN] = {};
+            while (written < target) {
+                const size_t k = std::min(target - written, BLOB_ALIGN);
+                out.write(zeros, static_cast<std::streamsize>(k));
+                written += k;
+            }
+        };
+        auto write_blob = [&](uint64_t at, const double* values, size_t count) {
+            pad_to(at);
+            out.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(count * sizeof(double)));
+            written += count * sizeof(double);
+        };
+
+        for (size_t i = 0; i < layers.size(); ++i) {
+            const LayerHeader& l = header.layers[i];
+            write_blob(l.weight_offset, layers[i].weights, size_t(l.inputs) * l.outputs);
+            write_blob(l.bias_offset, layers[i].bias, l.outputs);
+        }
+        pad_to(header.file_size);
+
+        if (!out) {
+            throw std::runtime_error("Failed to write model file: " + path);
+        }
+    }
+};
+
+// Zero-copy view over a model file; weight pointers stay valid for the
+// lifetime of the MappedModel
+class MappedModel {
+public:
+    explicit MappedModel(const std::string& path) : path_(path), file_(path, MADV_WILLNEED) {
+        using namespace model_file;
+
+        if (file_.size() < sizeof(FileHeader)) {
+            throw std::runtime_error("Model file too small: " + path);
+        }
+        std::memcpy(&header_, file_.data(), sizeof(FileHeader));
+        if (std::memcmp(header_.magic, MAGIC, sizeof(MAGIC)) != 0) {
+            throw std::runtime_error("Not a model file: " + path);
+        }
+        if (header_.version != VERSION) {
+            throw std::runtime_error("Unsupported model file version: " + path);
+        }
+        if (header_.file_size > file_.size() || header_.layer_count == 0 || header_.layer_count > MAX_LAYERS) {
+            throw std::runtime_error("Corrupt model file header: " + path);
+        }
+        for (uint32_t i = 0; i < header_.layer_count; ++i) {
+            const LayerHeader& l = header_.layers[i];
+            const uint64_t weight_bytes = sizeof(double) * uint64_t(l.inputs) * l.outputs;
+            if (l.weight_offset % BLOB_ALIGN != 0 || l.bias_offset % BLOB_ALIGN != 0 ||
+                l.weight_offset + weight_bytes > file_.size() ||
+                l.bias_offset + sizeof(double) * l.outputs > file_.size()) {
+                throw std::runtime_error("Corrupt model file layer table: " + path);
+            }
+        }
+    }
+
+    size_t layer_count() const { return header_.layer_count; }
+    size_t inputs(size_t layer) const { return header_.layers[layer].inputs; }
+    size_t outputs(size_t layer) const { return header_.layers[layer].outputs; }
+
+    const double* weights(size_t layer) const { return blob(header_.layers[layer].weight_offset); }
+    const double* bias(size_t layer) const { return blob(header_.layers[layer].bias_offset); }
+
+    template<typename Network>
+    bool matches() const {
+        if (header_.layer_count != Network::LAYER_COUNT) return false;
+        for (size_t i = 0; i < Network::LAYER_COUNT; ++i) {
+            if (header_.layers[i].inputs != Network::INPUTS[i] ||
+                header_.layers[i].outputs != Network::OUTPUTS[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Throws unless the file was built for Network
+    template<typename Network>
+    void require() const {
+        if (!matches<Network>()) {
+            throw std::runtime_error("Model shape does not match network definition: " + path_);
+        }
+    }
+
+    const std::string& path() const { return path_; }
+
+private:
+    const double* blob(uint64_t offset) const {
+        return reinterpret_cast<const double*>(file_.data() + offset);
+    }
+
+    std::string path_;
+    MappedFile file_;
+    model_file::FileHeader header_{};
+};
+
+} // namespace hft
@@ -37,11 +37,15 @@
 #include "common_types.hpp"
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <optional>
 #include <fstream>
 #include <sstream>
 #include <mutex>
 #include <chrono>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
 
 // Parameter version for change tracking
 struct ParameterVersion {
@@ -129,6 +133,9 @@ struct InferenceModelParameters {
     std::vector<double> feature_means;
     std::vector<double> feature_stds;
     
+    // Binary weights file (model_file.hpp); empty for the built-in weights
+    std::string model_path;
+    
     // Model metadata
     ParameterVersion version;
     double validation_accuracy;         // Accuracy on held-out data
@@ -144,14 +151,38 @@ struct CalibrationQuality {
     uint64_t version_id;
 };
 
+// Immutable per-key parameter block published by ModelStore
+//
+// A key is a symbol (Hawkes/AS/risk) or a model name (inference). Blocks are
+// never modified after publication; an update builds a new block and swaps
+// the slot pointer, so a reader holding a snapshot sees one consistent set.
+struct ParameterSnapshot {
+    uint64_t version = 0;              // Store-wide publish sequence (bumps on every swap)
+    std::optional<HawkesParameters> hawkes;
+    std::optional<AvellanedaStoikovParameters> as;
+    std::optional<RiskParameters> risk;
+    std::optional<InferenceModelParameters> inference;
+};
+
+using ParameterId = uint32_t;
+
 // Model Store (Parameter Persistence & Calibration Management)
 //
 // This class provides a clean abstraction for loading empirically calibrated
 // parameters. In development, it reads from JSON files. In production, it
 // connects to Redis/PostgreSQL/etc. for low-latency parameter retrieval.
+//
+// HOT PATH:
+// The string-keyed getters lock and copy. The strategy loop instead
+// resolves each key to a dense ParameterId once and calls snapshot(id),
+// a single acquire load of the current ParameterSnapshot (RCU-style: the
+// update_* calls publish a new block and retire the old one). Retired
+// blocks stay valid until reclaim_retired().
 
 class ModelStore {
 public:
+    static constexpr size_t MAX_PARAMETER_IDS = 1024;
+
     // 
     // Construction
     // 
@@ -159,9 +190,23 @@ public:
     explicit ModelStore(const std::string& config_path = "./config/parameters.json")
         : config_path_(config_path)
         , initialized_(false)
+        , slots_(new std::atomic<const ParameterSnapshot*>[MAX_PARAMETER_IDS])
     {
+        for (size_t i = 0; i < MAX_PARAMETER_IDS; ++i) {
+            slots_[i].store(&empty_snapshot_, std::memory_order_relaxed);
+        }
+    }
+    
+    ~ModelStore() {
+        for (size_t i = 0; i < ids_.size(); ++i) {
+            const ParameterSnapshot* current = slots_[i].load(std::memory_order_relaxed);
+            if (current != &empty_snapshot_) delete current;
+        }
     }
     
+    ModelStore(const ModelStore&) = delete;
+    ModelStore& operator=(const ModelStore&) = delete;
+    
     // 
     // Initialization
     // 
@@ -178,6 +223,7 @@ public:
             load_default_parameters();
         }
         
+        publish_all_locked();
         initialized_ = true;
         return true;
     }
@@ -234,6 +280,45 @@ public:
         return std::nullopt;
     }
     
+    // 
+    // Hot-Path Snapshots (Wait-Free Reads)
+    // 
+    
+    // Dense ID for a symbol/model name; stable for the store's lifetime.
+    // Resolve once at startup, not per tick.
+    ParameterId resolve(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        auto it = ids_.find(key);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+        if (ids_.size() >= MAX_PARAMETER_IDS) {
+            throw std::length_error("ModelStore: parameter id table full");
+        }
+        
+        const ParameterId id = static_cast<ParameterId>(ids_.size());
+        ids_.emplace(key, id);
+        publish_locked(key, id);
+        return id;
+    }
+    
+    // Current parameters for a resolved ID (never null; fields are empty
+    // until the key has parameters of that kind)
+    const ParameterSnapshot* snapshot(ParameterId id) const noexcept {
+        return slots_[id].load(std::memory_order_acquire);
+    }
+    
+    // Free blocks replaced by later updates. Only safe once no reader can
+    // still hold a snapshot taken before those updates (e.g. between
+    // strategy loop iterations).
+    size_t reclaim_retired() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const size_t count = retired_.size();
+        retired_.clear();
+        return count;
+    }
+    
     // 
     // Parameter Updates (Production: Persist to Backend)
     // 
@@ -253,6 +338,7 @@ public:
         versioned_params.version.comment = comment;
         
         hawkes_params_[symbol] = versioned_params;
+        publish_locked(symbol);
         
         // In production: persist to Redis/PostgreSQL
         // Example: redis_client_.set("hawkes:" + symbol, serialize(versioned_params));
@@ -274,6 +360,7 @@ public:
         versioned_params.version.comment = comment;
         
         as_params_[symbol] = versioned_params;
+        publish_locked(symbol);
         
         return persist_to_file();
     }
@@ -292,6 +379,27 @@ public:
         versioned_params.version.comment = comment;
         
         risk_params_[symbol] = versioned_params;
+        publish_locked(symbol);
+        
+        return persist_to_file();
+    }
+    
+    // Update inference model parameters (e.g. point model_path at a new
+    // weights file; engines pick it up via snapshot(resolve(model_name)))
+    bool update_inference_parameters(const std::string& model_name,
+                                    const InferenceModelParameters& params,
+                                    const std::string& updated_by,
+                                    const std::string& comment) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        InferenceModelParameters versioned_params = params;
+        versioned_params.version.version_id = next_version_id_++;
+        versioned_params.version.updated_at = current_timestamp();
+        versioned_params.version.updated_by = updated_by;
+        versioned_params.version.comment = comment;
+        
+        inference_params_[model_name] = versioned_params;
+        publish_locked(model_name);
         
         return persist_to_file();
     }
@@ -342,6 +450,38 @@ public:
     }
 
 private:
+    // 
+    // Snapshot Publication (caller holds mutex_)
+    // 
+    
+    void publish_locked(const std::string& key) {
+        auto it = ids_.find(key);
+        if (it != ids_.end()) {
+            publish_locked(key, it->second);
+        }
+    }
+    
+    void publish_locked(const std::string& key, ParameterId id) {
+        auto block = std::make_unique<ParameterSnapshot>();
+        block->version = ++publish_sequence_;
+        
+        if (auto it = hawkes_params_.find(key); it != hawkes_params_.end()) block->hawkes = it->second;
+        if (auto it = as_params_.find(key); it != as_params_.end()) block->as = it->second;
+        if (auto it = risk_params_.find(key); it != risk_params_.end()) block->risk = it->second;
+        if (auto it = inference_params_.find(key); it != inference_params_.end()) block->inference = it->second;
+        
+        const ParameterSnapshot* previous = slots_[id].exchange(block.release(), std::memory_order_acq_rel);
+        if (previous != &empty_snapshot_) {
+            retired_.emplace_back(previous);
+        }
+    }
+    
+    void publish_all_locked() {
+        for (const auto& [key, id] : ids_) {
+            publish_locked(key, id);
+        }
+    }
+    
     // 
     // File-Based Storage (Development Mode)
     // 
@@ -486,6 +626,13 @@ private:
     // Version tracking
     uint64_t next_version_id_ = 1;
     
+    // Hot-path snapshots: fixed slot table so readers never see it move
+    std::unordered_map<std::string, ParameterId> ids_;
+    uint64_t publish_sequence_ = 0;
+    ParameterSnapshot empty_snapshot_;
+    std::unique_ptr<std::atomic<const ParameterSnapshot*>[]> slots_;
+    std::vector<std::unique_ptr<const ParameterSnapshot>> retired_;
+    
     // Thread safety
     mutable std::mutex mutex_;
 };
@@ -2,6 +2,12 @@
 
 #include "common_types.hpp"
 #include "lockfree_queue.hpp"
+#include "fast_lob.hpp"
+#include "seqlock.hpp"
+#include "memory_arena.hpp"
+#include "simd_dispatch.hpp"
+#include "soa_structures.hpp"
+#include <algorithm>
 #include <map>
 #include <unordered_map>
 #include <vector>
@@ -10,6 +16,7 @@
 #include <optional>
 #include <functional>
 #include <cmath>
+#include <string>
 
 namespace hft {
 
@@ -66,13 +73,35 @@ struct OrderBookUpdate {
           is_bid(true), sequence_number(0), timestamp_ns(0), exchange_timestamp_ns(0) {}
 };
 
+// Field access for update messages. Backends and the reconstructor read
+// updates only through this, so a wire message can be applied in place
+// without first being copied into an OrderBookUpdate (see feed_handler.hpp).
+template<typename Update>
+struct UpdateFields;
+
+template<>
+struct UpdateFields<OrderBookUpdate> {
+    static UpdateType type(const OrderBookUpdate& u) { return u.type; }
+    static uint64_t order_id(const OrderBookUpdate& u) { return u.order_id; }
+    static double price(const OrderBookUpdate& u) { return u.price; }
+    static double quantity(const OrderBookUpdate& u) { return u.quantity; }
+    static bool is_bid(const OrderBookUpdate& u) { return u.is_bid; }
+    static uint64_t sequence_number(const OrderBookUpdate& u) { return u.sequence_number; }
+    static int64_t timestamp_ns(const OrderBookUpdate& u) { return u.timestamp_ns; }
+};
+
 // Deep Order Flow Imbalance (OFI) features
 struct DeepOFIFeatures {
-    // Level-by-level OFI (up to 10 levels)
-    std::array<double, 10> bid_ofi;  // Order flow imbalance per bid level
-    std::array<double, 10> ask_ofi;  // Order flow imbalance per ask level
+    static constexpr size_t DETAIL_LEVELS = 10;
     
-    // Aggregated OFI metrics
+    // Level-by-level OFI (top 10 levels). Levels are matched by price to
+    // the previous update: slot i is the change at the level now i-th best,
+    // less the quantity of a level that was i-th best and has left the top
+    // ofi_depth() (cancelled, filled, or pushed below).
+    std::array<double, DETAIL_LEVELS> bid_ofi;  // Order flow imbalance per bid level
+    std::array<double, DETAIL_LEVELS> ask_ofi;  // Order flow imbalance per ask level
+    
+    // Aggregated OFI metrics (over the reconstructor's ofi_depth() levels)
     double total_ofi;           // Sum of all levels
     double weighted_ofi;        // Volume-weighted OFI
     double top_5_ofi;          // OFI for top 5 levels
@@ -93,8 +122,8 @@ struct DeepOFIFeatures {
     double net_pressure;        // buy_pressure - sell_pressure
     
     // Volatility estimates
-    double microprice_volatility;  // Rolling std of weighted mid
-    double spread_volatility;      // Rolling std of spread
+    double microprice_volatility;  // Rolling std of weighted mid (last 128 updates)
+    double spread_volatility;      // Rolling std of spread (last 128 updates)
     
     // Timestamp
     int64_t timestamp_ns;
@@ -107,150 +136,1168 @@ struct DeepOFIFeatures {
         bid_ofi.fill(0.0);
         ask_ofi.fill(0.0);
     }
-};
-
-// LOB snapshot for gap recovery
-struct OrderBookSnapshot {
-    std::vector<PriceLevel> bids;  // Sorted descending
-    std::vector<PriceLevel> asks;  // Sorted ascending
-    uint64_t sequence_number;
-    int64_t timestamp_ns;
-    std::string symbol;
+};
+
+// LOB snapshot for gap recovery
+struct OrderBookSnapshot {
+    std::vector<PriceLevel> bids;  // Sorted descending
+    std::vector<PriceLevel> asks;  // Sorted ascending
+    uint64_t sequence_number;
+    int64_t timestamp_ns;
+    std::string symbol;
+    
+    OrderBookSnapshot() : sequence_number(0), timestamp_ns(0) {}
+};
+
+// Background snapshot recovery (BasicOrderBookReconstructor::enable_async_recovery)
+enum class BookRecoveryState : uint8_t {
+    IDLE,       // Book live
+    BUFFERING,  // Gap seen; updates held, waiting for recover_from_snapshot()
+    LOADING,    // Recovery thread building the standby book
+    STAGED      // Standby book ready; the feed thread swaps it in next
+};
+
+// Top-N depth + Deep OFI, published by the feed thread through a Seqlock
+// so strategy/risk threads can read it without ever blocking the writer.
+struct DepthSnapshot {
+    static constexpr size_t MAX_LEVELS = 10;
+    
+    std::array<double, MAX_LEVELS> bid_prices{};
+    std::array<double, MAX_LEVELS> bid_quantities{};
+    std::array<uint32_t, MAX_LEVELS> bid_order_counts{};
+    std::array<double, MAX_LEVELS> ask_prices{};
+    std::array<double, MAX_LEVELS> ask_quantities{};
+    std::array<uint32_t, MAX_LEVELS> ask_order_counts{};
+    uint32_t bid_levels = 0;   // Valid entries in bid_* arrays
+    uint32_t ask_levels = 0;   // Valid entries in ask_* arrays
+    uint64_t sequence_number = 0;
+    int64_t timestamp_ns = 0;
+    DeepOFIFeatures ofi;
+};
+
+// Callback function type for deep state publishing
+using DeepStateCallback = std::function<void(const DeepOFIFeatures&)>;
+
+// ============================================================================
+// Book storage backends
+// ============================================================================
+//
+// A backend owns the price levels and tracked orders; the reconstructor owns
+// sequencing, OFI and publishing. Required interface:
+//
+//   void clear();
+//   void load_snapshot(const OrderBookSnapshot&);
+//   template<typename U> bool add(const U&);      // U has UpdateFields<U>
+//   template<typename U> bool modify(const U&);   // Unknown order -> add
+//   template<typename U> bool remove(const U&);   // Unknown order -> false
+//   template<typename U> bool execute(const U&);  // Unknown order -> false
+//   bool best_bid(PriceLevel&) const;
+//   bool best_ask(PriceLevel&) const;
+//   template<typename F> void for_each_bid(size_t n, F&& f) const;  // f(level_idx, PriceLevel)
+//   template<typename F> void for_each_ask(size_t n, F&& f) const;  // best first
+//   size_t bid_level_count() const;
+//   size_t ask_level_count() const;
+//   double total_bid_volume() const;
+//   double total_ask_volume() const;
+//
+// and, so the reconstructor can keep its top-N mirror without walking:
+//
+//   bool order_level(uint64_t id, bool& is_bid, double& price) const;  // Resting order's level
+//   bool level_at(bool is_bid, double price, PriceLevel&) const;       // False if empty; out.price
+//                                                                      // is the backend's price either way
+//   bool level_after(bool is_bid, double price, PriceLevel&) const;    // Next level behind `price`
+
+// ----------------------------------------------------------------------------
+// MapBookBackend: std::map levels + unordered_map orders (reference backend)
+// ----------------------------------------------------------------------------
+class MapBookBackend {
+public:
+    void clear() {
+        bids_.clear();
+        asks_.clear();
+        orders_.clear();
+        bid_volume_ = 0.0;
+        ask_volume_ = 0.0;
+    }
+    
+    void load_snapshot(const OrderBookSnapshot& snapshot) {
+        clear();
+        
+        // Load bids (sorted descending by price)
+        for (const auto& level : snapshot.bids) {
+            bids_[level.price] = level;
+        }
+        
+        // Load asks (sorted ascending by price)
+        for (const auto& level : snapshot.asks) {
+            asks_[level.price] = level;
+        }
+        
+        for (const auto& [price, level] : bids_) bid_volume_ += level.quantity;
+        for (const auto& [price, level] : asks_) ask_volume_ += level.quantity;
+    }
+    
+    template<typename Update>
+    bool add(const Update& update) {
+        using F = UpdateFields<Update>;
+        // Add new order to tracking
+        TrackedOrder order;
+        order.order_id = F::order_id(update);
+        order.price = F::price(update);
+        order.quantity = F::quantity(update);
+        order.is_bid = F::is_bid(update);
+        order.timestamp_ns = F::timestamp_ns(update);
+        orders_[F::order_id(update)] = order;
+        volume(F::is_bid(update)) += F::quantity(update);
+        
+        // Update price level
+        auto& book = F::is_bid(update) ? bids_ : asks_;
+        auto it = book.find(F::price(update));
+        
+        if (it != book.end()) {
+            // Price level exists, add quantity
+            it->second.quantity += F::quantity(update);
+            it->second.order_count++;
+            it->second.last_update_ns = F::timestamp_ns(update);
+        } else {
+            // New price level
+            PriceLevel level(F::price(update), F::quantity(update), 1);
+            level.last_update_ns = F::timestamp_ns(update);
+            book[F::price(update)] = level;
+        }
+        
+        return true;
+    }
+    
+    template<typename Update>
+    bool modify(const Update& update) {
+        using F = UpdateFields<Update>;
+        auto order_it = orders_.find(F::order_id(update));
+        if (order_it == orders_.end()) {
+            // Order not found, treat as add
+            return add(update);
+        }
+        
+        TrackedOrder& order = order_it->second;
+        auto& book = order.is_bid ? bids_ : asks_;
+        
+        // Remove old quantity from old price level
+        auto old_level_it = book.find(order.price);
+        if (old_level_it != book.end()) {
+            old_level_it->second.quantity -= order.quantity;
+            old_level_it->second.order_count--;
+            volume(order.is_bid) -= order.quantity;
+            
+            // Remove price level if empty
+            if (old_level_it->second.quantity <= 0.0 || old_level_it->second.order_count == 0) {
+                erase_level(order.is_bid, old_level_it);
+            }
+        }
+        
+        // Add new quantity at new price level
+        order.price = F::price(update);
+        order.quantity = F::quantity(update);
+        order.timestamp_ns = F::timestamp_ns(update);
+        volume(order.is_bid) += F::quantity(update);
+        
+        auto new_level_it = book.find(F::price(update));
+        if (new_level_it != book.end()) {
+            new_level_it->second.quantity += F::quantity(update);
+            new_level_it->second.order_count++;
+            new_level_it->second.last_update_ns = F::timestamp_ns(update);
+        } else {
+            PriceLevel level(F::price(update), F::quantity(update), 1);
+            level.last_update_ns = F::timestamp_ns(update);
+            book[F::price(update)] = level;
+        }
+        
+        return true;
+    }
+    
+    template<typename Update>
+    bool remove(const Update& update) {
+        using F = UpdateFields<Update>;
+        auto order_it = orders_.find(F::order_id(update));
+        if (order_it == orders_.end()) {
+            return false;  // Order not found
+        }
+        
+        TrackedOrder& order = order_it->second;
+        auto& book = order.is_bid ? bids_ : asks_;
+        
+        // Remove quantity from price level
+        auto level_it = book.find(order.price);
+        if (level_it != book.end()) {
+            level_it->second.quantity -= order.quantity;
+            level_it->second.order_count--;
+            volume(order.is_bid) -= order.quantity;
+            
+            // Remove price level if empty
+            if (level_it->second.quantity <= 0.0 || level_it->second.order_count == 0) {
+                erase_level(order.is_bid, level_it);
+            }
+        }
+        
+        // Remove order from tracking
+        orders_.erase(order_it);
+        
+        return true;
+    }
+    
+    template<typename Update>
+    bool execute(const Update& update) {
+        using F = UpdateFields<Update>;
+        auto order_it = orders_.find(F::order_id(update));
+        if (order_it == orders_.end()) {
+            return false;  // Not a resting order we track
+        }
+        
+        TrackedOrder& order = order_it->second;
+        auto& book = order.is_bid ? bids_ : asks_;
+        
+        // Reduce quantity from price level
+        auto level_it = book.find(order.price);
+        if (level_it != book.end()) {
+            const bool is_bid = order.is_bid;
+            level_it->second.quantity -= F::quantity(update);
+            volume(is_bid) -= F::quantity(update);
+            
+            // Check if fully executed
+            if (F::quantity(update) >= order.quantity) {
+                level_it->second.order_count--;
+                orders_.erase(order_it);
+            } else {
+                order.quantity -= F::quantity(update);
+            }
+            
+            // Remove price level if empty
+            if (level_it->second.quantity <= 0.0 || level_it->second.order_count == 0) {
+                erase_level(is_bid, level_it);
+            }
+        }
+        
+        return true;
+    }
+    
+    bool best_bid(PriceLevel& out) const {
+        if (bids_.empty()) return false;
+        out = bids_.rbegin()->second;  // Highest bid
+        return true;
+    }
+    
+    bool best_ask(PriceLevel& out) const {
+        if (asks_.empty()) return false;
+        out = asks_.begin()->second;   // Lowest ask
+        return true;
+    }
+    
+    template<typename F>
+    void for_each_bid(size_t n, F&& f) const {
+        size_t level = 0;
+        for (auto it = bids_.rbegin(); it != bids_.rend() && level < n; ++it, ++level) {
+            f(level, it->second);
+        }
+    }
+    
+    template<typename F>
+    void for_each_ask(size_t n, F&& f) const {
+        size_t level = 0;
+        for (auto it = asks_.begin(); it != asks_.end() && level < n; ++it, ++level) {
+            f(level, it->second);
+        }
+    }
+    
+    size_t bid_level_count() const { return bids_.size(); }
+    size_t ask_level_count() const { return asks_.size(); }
+    
+    // Running totals, kept in step with every level change
+    double total_bid_volume() const { return bid_volume_; }
+    double total_ask_volume() const { return ask_volume_; }
+    
+    bool order_level(uint64_t order_id, bool& is_bid, double& price) const {
+        auto it = orders_.find(order_id);
+        if (it == orders_.end()) return false;
+        is_bid = it->second.is_bid;
+        price = it->second.price;
+        return true;
+    }
+    
+    bool level_at(bool is_bid, double price, PriceLevel& out) const {
+        const auto& book = is_bid ? bids_ : asks_;
+        auto it = book.find(price);
+        if (it == book.end()) {
+            out = PriceLevel(price, 0.0, 0);
+            return false;
+        }
+        out = it->second;
+        return true;
+    }
+    
+    bool level_after(bool is_bid, double price, PriceLevel& out) const {
+        if (is_bid) {
+            auto it = bids_.lower_bound(price);   // Highest bid below `price`
+            if (it == bids_.begin()) return false;
+            out = std::prev(it)->second;
+        } else {
+            auto it = asks_.upper_bound(price);
+            if (it == asks_.end()) return false;
+            out = it->second;
+        }
+        return true;
+    }
+
+private:
+    // Order book state (std::map provides O(log n) operations and sorted iteration)
+    using LevelMap = std::map<double, PriceLevel, std::less<double>,
+                              ArenaAllocator<std::pair<const double, PriceLevel>>>;
+    LevelMap bids_;  // Price -> Level (descending order for bids)
+    LevelMap asks_;  // Price -> Level (ascending order for asks)
+    
+    // Order tracking for modify/cancel
+    std::unordered_map<uint64_t, TrackedOrder, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                       ArenaAllocator<std::pair<const uint64_t, TrackedOrder>>> orders_;
+    
+    double bid_volume_ = 0.0;
+    double ask_volume_ = 0.0;
+    
+    double& volume(bool is_bid) {
+        return is_bid ? bid_volume_ : ask_volume_;
+    }
+    
+    // Drops an emptied level; whatever quantity it still shows leaves the total too
+    void erase_level(bool is_bid, LevelMap::iterator it) {
+        volume(is_bid) -= it->second.quantity;
+        (is_bid ? bids_ : asks_).erase(it);
+    }
+};
+
+// ----------------------------------------------------------------------------
+// FlatBookBackend: allocation-free L3 storage
+// ----------------------------------------------------------------------------
+//
+// - Order-id table: open addressing, linear probing, backward-shift delete
+//   (no tombstones), sized to 2x MaxOrders so probes stay short.
+// - Order pool: MaxOrders preallocated nodes on an intrusive free list; each
+//   live node is linked into its level's FIFO (price-time priority).
+// - Levels: tick-indexed arrays per side with a TickOccupancyBitmap, so BBO
+//   and next-level walks are clz/ctz, and volume totals are kept running.
+//
+// All storage is allocated once in the constructor; add/modify/delete/execute
+// never touch the heap. Prices outside the MaxTicks window are rejected.
+// An unset reference price anchors the window on the first snapshot or add.
+template<size_t MaxTicks = 4096, size_t MaxOrders = (size_t(1) << 18)>
+class FlatBookBackend {
+    static_assert((MaxOrders & (MaxOrders - 1)) == 0, "MaxOrders must be a power of two");
+
+public:
+    static constexpr uint32_t NIL = UINT32_MAX;
+    
+    explicit FlatBookBackend(double tick_size = 0.01, double reference_price = 0.0)
+        : tick_size_(tick_size),
+          inv_tick_size_(1.0 / tick_size),
+          base_price_(0.0),
+          anchored_(false),
+          nodes_(MaxOrders),
+          table_(TABLE_SIZE),
+          bid_levels_(MaxTicks),
+          ask_levels_(MaxTicks) {
+        if (reference_price > 0.0) {
+            anchor(reference_price);
+        }
+        clear();
+    }
+    
+    void clear() {
+        for (size_t i = 0; i < MaxOrders; ++i) {
+            nodes_[i].next = (i + 1 < MaxOrders) ? static_cast<uint32_t>(i + 1) : NIL;
+        }
+        free_head_ = 0;
+        live_orders_ = 0;
+        
+        std::fill(table_.begin(), table_.end(), Slot{});
+        std::fill(bid_levels_.begin(), bid_levels_.end(), FlatLevel{});
+        std::fill(ask_levels_.begin(), ask_levels_.end(), FlatLevel{});
+        bid_bits_.clear();
+        ask_bits_.clear();
+        bid_level_count_ = 0;
+        ask_level_count_ = 0;
+        bid_volume_ = 0.0;
+        ask_volume_ = 0.0;
+    }
+    
+    void load_snapshot(const OrderBookSnapshot& snapshot) {
+        clear();
+        
+        if (!anchored_) {
+            if (!snapshot.bids.empty() && !snapshot.asks.empty()) {
+                anchor((snapshot.bids.front().price + snapshot.asks.front().price) / 2.0);
+            } else if (!snapshot.bids.empty()) {
+                anchor(snapshot.bids.front().price);
+            } else if (!snapshot.asks.empty()) {
+                anchor(snapshot.asks.front().price);
+            }
+        }
+        
+        // Snapshot levels carry aggregate quantity only (no order ids)
+        for (const auto& level : snapshot.bids) {
+            load_level(true, level);
+        }
+        for (const auto& level : snapshot.asks) {
+            load_level(false, level);
+        }
+    }
+    
+    template<typename Update>
+    bool add(const Update& update) {
+        using F = UpdateFields<Update>;
+        if (UNLIKELY(!anchored_)) {
+            anchor(F::price(update));
+        }
+        
+        const int32_t tick = price_to_tick(F::price(update));
+        if (UNLIKELY(!in_range(tick))) {
+            return false;
+        }
+        
+        size_t slot;
+        if (UNLIKELY(find_slot(F::order_id(update), slot))) {
+            // Duplicate add: treat as replace
+            return modify(update);
+        }
+        
+        if (UNLIKELY(free_head_ == NIL)) {
+            return false;  // Order pool exhausted
+        }
+        
+        const uint32_t idx = free_head_;
+        free_head_ = nodes_[idx].next;
+        ++live_orders_;
+        
+        table_[slot].key = F::order_id(update);
+        table_[slot].node = idx;
+        
+        OrderNode& node = nodes_[idx];
+        node.order_id = F::order_id(update);
+        node.quantity = F::quantity(update);
+        node.timestamp_ns = F::timestamp_ns(update);
+        node.tick = tick;
+        node.is_bid = F::is_bid(update);
+        
+        attach(idx, F::timestamp_ns(update));
+        return true;
+    }
+    
+    template<typename Update>
+    bool modify(const Update& update) {
+        using F = UpdateFields<Update>;
+        size_t slot;
+        if (!find_slot(F::order_id(update), slot)) {
+            // Order not found, treat as add
+            return add(update);
+        }
+        
+        const uint32_t idx = table_[slot].node;
+        OrderNode& node = nodes_[idx];
+        const int32_t new_tick = price_to_tick(F::price(update));
+        if (UNLIKELY(!in_range(new_tick))) {
+            return false;
+        }
+        
+        // Size down to nothing: a delete, so no zero-quantity node stays linked
+        if (F::quantity(update) <= 0.0) {
+            detach(idx);
+            release(slot, idx);
+            return true;
+        }
+        
+        FlatLevel& level = level_at(node.is_bid, node.tick);
+        
+        // Same price, size down: keeps queue position
+        if (new_tick == node.tick && F::quantity(update) <= node.quantity
+            && bits(node.is_bid).test(static_cast<uint32_t>(node.tick))) {
+            const double delta = node.quantity - F::quantity(update);
+            level.quantity -= delta;
+            volume(node.is_bid) -= delta;
+            level.last_update_ns = F::timestamp_ns(update);
+            node.quantity = F::quantity(update);
+            node.timestamp_ns = F::timestamp_ns(update);
+            return true;
+        }
+        
+        // Price change or size up: loses priority, requeue at tail
+        detach(idx);
+        node.tick = new_tick;
+        node.quantity = F::quantity(update);
+        node.timestamp_ns = F::timestamp_ns(update);
+        attach(idx, F::timestamp_ns(update));
+        return true;
+    }
+    
+    template<typename Update>
+    bool remove(const Update& update) {
+        using F = UpdateFields<Update>;
+        size_t slot;
+        if (!find_slot(F::order_id(update), slot)) {
+            return false;  // Order not found
+        }
+        
+        const uint32_t idx = table_[slot].node;
+        detach(idx);
+        release(slot, idx);
+        return true;
+    }
+    
+    template<typename Update>
+    bool execute(const Update& update) {
+        using F = UpdateFields<Update>;
+        size_t slot;
+        if (!find_slot(F::order_id(update), slot)) {
+            return false;  // Not a resting order we track
+        }
+        
+        const uint32_t idx = table_[slot].node;
+        OrderNode& node = nodes_[idx];
+        const bool is_bid = node.is_bid;
+        const int32_t tick = node.tick;
+        
+        if (!bits(is_bid).test(static_cast<uint32_t>(tick))) {
+            return true;  // Level already gone (matches map backend)
+        }
+        
+        FlatLevel& level = level_at(is_bid, tick);
+        level.quantity -= F::quantity(update);
+        volume(is_bid) -= F::quantity(update);
+        level.last_update_ns = F::timestamp_ns(update);
+        
+        // Check if fully executed
+        if (F::quantity(update) >= node.quantity) {
+            level.order_count--;
+            unlink(idx);
+            release(slot, idx);
+        } else {
+            node.quantity -= F::quantity(update);
+        }
+        
+        if (level.quantity <= 0.0 || level.order_count == 0) {
+            deactivate(is_bid, tick);
+        }
+        
+        return true;
+    }
+    
+    bool best_bid(PriceLevel& out) const {
+        const int32_t tick = bid_bits_.highest();
+        if (tick < 0) return false;
+        out = make_level(bid_levels_[tick], tick);
+        return true;
+    }
+    
+    bool best_ask(PriceLevel& out) const {
+        const int32_t tick = ask_bits_.lowest();
+        if (tick < 0) return false;
+        out = make_level(ask_levels_[tick], tick);
+        return true;
+    }
+    
+    template<typename F>
+    void for_each_bid(size_t n, F&& f) const {
+        int32_t tick = bid_bits_.highest();
+        for (size_t level = 0; level < n && tick >= 0; ++level) {
+            f(level, make_level(bid_levels_[tick], tick));
+            tick = bid_bits_.find_high_at_or_below(tick - 1);
+        }
+    }
+    
+    template<typename F>
+    void for_each_ask(size_t n, F&& f) const {
+        int32_t tick = ask_bits_.lowest();
+        for (size_t level = 0; level < n && tick >= 0; ++level) {
+            f(level, make_level(ask_levels_[tick], tick));
+            tick = ask_bits_.find_low_at_or_above(tick + 1);
+        }
+    }
+    
+    // Walk resting orders at a price in FIFO order: f(order_id, quantity)
+    template<typename F>
+    void for_each_order_at(bool is_bid, double price, F&& f) const {
+        const int32_t tick = price_to_tick(price);
+        if (!in_range(tick) || !bits(is_bid).test(static_cast<uint32_t>(tick))) return;
+        for (uint32_t idx = level_at(is_bid, tick).head; idx != NIL; idx = nodes_[idx].next) {
+            f(nodes_[idx].order_id, nodes_[idx].quantity);
+        }
+    }
+    
+    size_t bid_level_count() const { return bid_level_count_; }
+    size_t ask_level_count() const { return ask_level_count_; }
+    double total_bid_volume() const { return bid_volume_; }
+    double total_ask_volume() const { return ask_volume_; }
+    size_t live_orders() const { return live_orders_; }
+    
+    bool order_level(uint64_t order_id, bool& is_bid, double& price) const {
+        size_t slot;
+        if (!find_slot(order_id, slot)) return false;
+        const OrderNode& node = nodes_[table_[slot].node];
+        is_bid = node.is_bid;
+        price = tick_to_price(node.tick);
+        return true;
+    }
+    
+    bool level_at(bool is_bid, double price, PriceLevel& out) const {
+        const int32_t tick = price_to_tick(price);
+        if (!in_range(tick) || !bits(is_bid).test(static_cast<uint32_t>(tick))) {
+            out = PriceLevel(tick_to_price(tick), 0.0, 0);
+            return false;
+        }
+        out = make_level(level_at(is_bid, tick), tick);
+        return true;
+    }
+    
+    bool level_after(bool is_bid, double price, PriceLevel& out) const {
+        const int32_t from = price_to_tick(price);
+        const int32_t tick = is_bid
+            ? bid_bits_.find_high_at_or_below(std::min<int32_t>(from, static_cast<int32_t>(MaxTicks)) - 1)
+            : ask_bits_.find_low_at_or_above(std::max<int32_t>(from, -1) + 1);
+        if (tick < 0) return false;
+        out = make_level(level_at(is_bid, tick), tick);
+        return true;
+    }
+    
+    int32_t price_to_tick(double price) const {
+        const double offset = (price - base_price_) * inv_tick_size_;
+        return static_cast<int32_t>(offset < 0.0 ? offset - 0.5 : offset + 0.5);
+    }
+    
+    double tick_to_price(int32_t tick) const {
+        return base_price_ + static_cast<double>(tick) * tick_size_;
+    }
+
+    // Price of tick 0; rebase() empties the book and places it exactly there
+    double base_price() const { return base_price_; }
+
+    void rebase(double base_price) {
+        clear();
+        base_price_ = base_price;
+        anchored_ = true;
+    }
+
+private:
+    static constexpr size_t TABLE_SIZE = MaxOrders * 2;
+    static constexpr size_t TABLE_MASK = TABLE_SIZE - 1;
+    static constexpr uint64_t EMPTY_KEY = UINT64_MAX;
+    
+    static constexpr unsigned log2_size(size_t n) {
+        return n <= 1 ? 0 : 1 + log2_size(n >> 1);
+    }
+    static constexpr unsigned HASH_SHIFT = 64 - log2_size(TABLE_SIZE);
+    
+    struct OrderNode {
+        uint64_t order_id = 0;
+        double quantity = 0.0;
+        int64_t timestamp_ns = 0;
+        int32_t tick = 0;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        bool is_bid = true;
+    };
+    
+    struct Slot {
+        uint64_t key = EMPTY_KEY;
+        uint32_t node = NIL;
+    };
+    
+    struct FlatLevel {
+        double quantity = 0.0;
+        uint64_t order_count = 0;
+        int64_t last_update_ns = 0;
+        uint32_t head = NIL;  // FIFO of resting orders
+        uint32_t tail = NIL;
+    };
+    
+    double tick_size_;
+    double inv_tick_size_;
+    double base_price_;
+    bool anchored_;
+    
+    std::vector<OrderNode> nodes_;
+    std::vector<Slot> table_;
+    uint32_t free_head_ = NIL;
+    size_t live_orders_ = 0;
+    
+    std::vector<FlatLevel> bid_levels_;
+    std::vector<FlatLevel> ask_levels_;
+    TickOccupancyBitmap<MaxTicks> bid_bits_;
+    TickOccupancyBitmap<MaxTicks> ask_bits_;
+    size_t bid_level_count_ = 0;
+    size_t ask_level_count_ = 0;
+    double bid_volume_ = 0.0;
+    double ask_volume_ = 0.0;
+    
+    void anchor(double reference_price) {
+        base_price_ = reference_price - static_cast<double>(MaxTicks / 2) * tick_size_;
+        anchored_ = true;
+    }
+    
+    bool in_range(int32_t tick) const {
+        return static_cast<uint32_t>(tick) < MaxTicks;
+    }
+    
+    FlatLevel& level_at(bool is_bid, int32_t tick) {
+        return is_bid ? bid_levels_[tick] : ask_levels_[tick];
+    }
+    const FlatLevel& level_at(bool is_bid, int32_t tick) const {
+        return is_bid ? bid_levels_[tick] : ask_levels_[tick];
+    }
+    TickOccupancyBitmap<MaxTicks>& bits(bool is_bid) {
+        return is_bid ? bid_bits_ : ask_bits_;
+    }
+    const TickOccupancyBitmap<MaxTicks>& bits(bool is_bid) const {
+        return is_bid ? bid_bits_ : ask_bits_;
+    }
+    double& volume(bool is_bid) {
+        return is_bid ? bid_volume_ : ask_volume_;
+    }
+    
+    PriceLevel make_level(const FlatLevel& level, int32_t tick) const {
+        PriceLevel out(tick_to_price(tick), level.quantity, level.order_count);
+        out.last_update_ns = level.last_update_ns;
+        return out;
+    }
+    
+    void load_level(bool is_bid, const PriceLevel& src) {
+        const int32_t tick = price_to_tick(src.price);
+        if (!in_range(tick) || src.quantity <= 0.0 || src.order_count == 0) return;
+        
+        FlatLevel& level = level_at(is_bid, tick);
+        if (bits(is_bid).test(static_cast<uint32_t>(tick))) {
+            volume(is_bid) -= level.quantity;  // Duplicate price in snapshot
+        } else {
+            bits(is_bid).set(static_cast<uint32_t>(tick));
+            ++(is_bid ? bid_level_count_ : ask_level_count_);
+        }
+        level.quantity = src.quantity;
+        level.order_count = src.order_count;
+        level.last_update_ns = src.last_update_ns;
+        volume(is_bid) += src.quantity;
+    }
+    
+    // ---- order-id table ----
+    
+    size_t home_slot(uint64_t key) const {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> HASH_SHIFT);
+    }
+    
+    // Returns true if found; otherwise `slot` is the insertion point.
+    bool find_slot(uint64_t key, size_t& slot) const {
+        size_t i = home_slot(key);
+        while (true) {
+            const uint64_t k = table_[i].key;
+            if (k == key) { slot = i; return true; }
+            if (k == EMPTY_KEY) { slot = i; return false; }
+            i = (i + 1) & TABLE_MASK;
+        }
+    }
+    
+    void erase_slot(size_t i) {
+        // Backward-shift deletion keeps probe chains intact without tombstones
+        size_t j = i;
+        while (true) {
+            j = (j + 1) & TABLE_MASK;
+            if (table_[j].key == EMPTY_KEY) break;
+            const size_t k = home_slot(table_[j].key);
+            const bool stays = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+            if (stays) continue;
+            table_[i] = table_[j];
+            i = j;
+        }
+        table_[i] = Slot{};
+    }
+    
+    void release(size_t slot, uint32_t idx) {
+        erase_slot(slot);
+        nodes_[idx].next = free_head_;
+        free_head_ = idx;
+        --live_orders_;
+    }
+    
+    // ---- level FIFO maintenance ----
+    
+    void attach(uint32_t idx, int64_t timestamp_ns) {
+        OrderNode& node = nodes_[idx];
+        FlatLevel& level = level_at(node.is_bid, node.tick);
+        auto& occupied = bits(node.is_bid);
+        
+        if (!occupied.test(static_cast<uint32_t>(node.tick))) {
+            level.quantity = 0.0;
+            level.order_count = 0;
+        }
+        
+        node.prev = level.tail;
+        node.next = NIL;
+        if (level.tail != NIL) {
+            nodes_[level.tail].next = idx;
+        } else {
+            level.head = idx;
+        }
+        level.tail = idx;
+        
+        level.quantity += node.quantity;
+        level.order_count++;
+        level.last_update_ns = timestamp_ns;
+        volume(node.is_bid) += node.quantity;
+        
+        if (!occupied.test(static_cast<uint32_t>(node.tick)) && level.quantity > 0.0) {
+            occupied.set(static_cast<uint32_t>(node.tick));
+            ++(node.is_bid ? bid_level_count_ : ask_level_count_);
+        }
+    }
+    
+    void detach(uint32_t idx) {
+        const OrderNode& node = nodes_[idx];
+        if (bits(node.is_bid).test(static_cast<uint32_t>(node.tick))) {
+            FlatLevel& level = level_at(node.is_bid, node.tick);
+            level.quantity -= node.quantity;
+            level.order_count--;
+            volume(node.is_bid) -= node.quantity;
+            
+            // Remove price level if empty
+            if (level.quantity <= 0.0 || level.order_count == 0) {
+                deactivate(node.is_bid, node.tick);
+            }
+        }
+        unlink(idx);
+    }
     
-    OrderBookSnapshot() : sequence_number(0), timestamp_ns(0) {}
+    void unlink(uint32_t idx) {
+        OrderNode& node = nodes_[idx];
+        FlatLevel& level = level_at(node.is_bid, node.tick);
+        if (node.prev != NIL) nodes_[node.prev].next = node.next;
+        else level.head = node.next;
+        if (node.next != NIL) nodes_[node.next].prev = node.prev;
+        else level.tail = node.prev;
+        node.prev = NIL;
+        node.next = NIL;
+    }
+    
+    void deactivate(bool is_bid, int32_t tick) {
+        FlatLevel& level = level_at(is_bid, tick);
+        volume(is_bid) -= level.quantity;
+        level.quantity = 0.0;
+        level.order_count = 0;
+        bits(is_bid).reset(static_cast<uint32_t>(tick));
+        --(is_bid ? bid_level_count_ : ask_level_count_);
+    }
 };
 
-// Callback function type for deep state publishing
-using DeepStateCallback = std::function<void(const DeepOFIFeatures&)>;
-
 // ============================================================================
 // OrderBookReconstructor: Lock-free, tick-by-tick LOB with Deep OFI
 // ============================================================================
-class OrderBookReconstructor {
+template<typename BookBackend = MapBookBackend>
+class BasicOrderBookReconstructor {
 public:
-    OrderBookReconstructor(const std::string& symbol, size_t max_depth = 100)
+    explicit BasicOrderBookReconstructor(const std::string& symbol, size_t max_depth = 100,
+                                         BookBackend backend = BookBackend())
         : symbol_(symbol),
           max_depth_(max_depth),
+          book_(std::move(backend)),
           last_sequence_number_(0),
           gap_detected_(false),
           total_updates_(0),
           missed_updates_(0),
           snapshot_requests_(0),
           is_initialized_(false) {
-        
-        // Initialize OFI state tracking
-        previous_bid_quantities_.fill(0.0);
-        previous_ask_quantities_.fill(0.0);
-        
-        // Initialize pressure decay window (last 1000 ticks)
-        recent_buy_volume_.reserve(1000);
-        recent_sell_volume_.reserve(1000);
+        rebuild_depth();
     }
     
     // Initialize the order book with a snapshot
     bool initialize_from_snapshot(const OrderBookSnapshot& snapshot) {
         std::lock_guard<std::mutex> lock(book_mutex_);
         
-        bids_.clear();
-        asks_.clear();
-        orders_.clear();
-        
-        // Load bids (sorted descending by price)
-        for (const auto& level : snapshot.bids) {
-            bids_[level.price] = level;
-        }
-        
-        // Load asks (sorted ascending by price)
-        for (const auto& level : snapshot.asks) {
-            asks_[level.price] = level;
-        }
+        book_.load_snapshot(snapshot);
+        rebuild_depth();
         
         last_sequence_number_ = snapshot.sequence_number;
         is_initialized_.store(true, std::memory_order_release);
         
+        publish_snapshot(snapshot_.load().ofi, snapshot.timestamp_ns);
+        
         return true;
     }
     
     // Process an order book update
-    bool process_update(const OrderBookUpdate& update) {
+    template<typename Update>
+    bool process_update(const Update& update) {
+        using F = UpdateFields<Update>;
+        
+        if (UNLIKELY(recovering_) && !poll_recovery()) {
+            hold_for_recovery(update);
+            return false;
+        }
+        
         // Check for sequence number gap
         if (is_initialized_.load(std::memory_order_acquire)) {
-            if (update.sequence_number != last_sequence_number_ + 1 
+            const uint64_t sequence = F::sequence_number(update);
+            if (sequence != last_sequence_number_ + 1 
                 && last_sequence_number_ != 0) {
-                // Gap detected!
-                gap_detected_.store(true, std::memory_order_release);
-                missed_updates_ += (update.sequence_number - last_sequence_number_ - 1);
-                
-                // Trigger snapshot request (caller should handle this)
-                snapshot_requests_++;
+                if (sequence <= last_sequence_number_) {
+                    return false;  // Already applied, or covered by the snapshot
+                }
+                // Gap detected! Caller should request a snapshot.
+                report_gap(sequence - last_sequence_number_ - 1, sequence);
+                if (recovering_) {
+                    hold_for_recovery(update);
+                }
                 return false;  // Reject update until snapshot received
             }
         }
         
+        return apply_update(update);
+    }
+    
+    // Apply an update without the per-book sequence check. For feed handlers
+    // that track a feed-wide sequence (book, trade and quote messages share
+    // one sequence space) and call report_gap() themselves.
+    template<typename Update>
+    bool apply_update(const Update& update) {
+        using F = UpdateFields<Update>;
+        
         std::lock_guard<std::mutex> lock(book_mutex_);
         
-        // Store previous state for OFI calculation
-        store_previous_state();
+        // Levels this update can change, read before the order moves
+        LevelTouch touched[2];
+        const size_t touches = touched_levels(update, touched);
         
         // Process update based on type
         bool success = false;
-        switch (update.type) {
-            case UpdateType::ADD:
-                success = handle_add(update);
-                break;
-            case UpdateType::MODIFY:
-                success = handle_modify(update);
-                break;
-            case UpdateType::DELETE:
-                success = handle_delete(update);
-                break;
-            case UpdateType::EXECUTE:
-                success = handle_execute(update);
-                break;
-            case UpdateType::SNAPSHOT:
-                // Should call initialize_from_snapshot instead
-                return false;
+        if (F::type(update) == UpdateType::EXECUTE) {
+            success = handle_execute(update);
+        } else if (F::type(update) == UpdateType::SNAPSHOT) {
+            // Should call initialize_from_snapshot instead
+            return false;
+        } else {
+            success = apply_to_backend(book_, update);
         }
         
         if (success) {
-            last_sequence_number_ = update.sequence_number;
+            const int64_t timestamp_ns = F::timestamp_ns(update);
+            last_sequence_number_ = F::sequence_number(update);
             total_updates_++;
             
+            // OFI baseline, then bring the top-N mirror up to date
+            store_previous_state();
+            refresh_levels(touched, touches);
+            
             // Calculate Deep OFI features
-            auto features = calculate_deep_ofi(update.timestamp_ns);
+            auto features = calculate_deep_ofi(timestamp_ns);
             
-            // Publish to registered callbacks
+            // Publish seqlock snapshot, then registered callbacks
+            publish_snapshot(features, timestamp_ns);
             publish_deep_state(features);
         }
         
         return success;
     }
     
-    // Register callback for deep state publishing
-    void register_deep_state_callback(DeepStateCallback callback) {
+    // Record a sequence gap of `missed` messages; needs_snapshot_recovery()
+    // stays true until reset_gap_detection(), or until a background
+    // recovery completes. `next_sequence` is the first sequence number
+    // after the gap (0 if unknown); a recovery snapshot must reach it.
+    void report_gap(uint64_t missed, uint64_t next_sequence = 0) {
+        gap_detected_.store(true, std::memory_order_release);
+        missed_updates_ += missed;
+        snapshot_requests_++;
+        
+        if (recovery_ring_) {
+            if (next_sequence > resume_sequence_.load(std::memory_order_relaxed)) {
+                resume_sequence_.store(next_sequence, std::memory_order_release);
+            }
+            if (!recovering_) {
+                recovering_ = true;
+                buffered_sequence_ = 0;
+                recovery_state_.store(BookRecoveryState::BUFFERING, std::memory_order_release);
+            }
+        }
+    }
+    
+    // ------------------------------------------------------------------------
+    // Background snapshot recovery
+    // ------------------------------------------------------------------------
+    //
+    // Opt-in, for feeds where a synchronous rebuild leaves the book dark too
+    // long. After a gap the feed thread keeps taking updates into a
+    // preallocated ring instead of dropping them. A recovery thread fetches
+    // a snapshot and calls recover_from_snapshot(), which loads it into a
+    // standby backend and replays the buffered updates past its sequence
+    // number. On its next update (or poll_recovery()) the feed thread
+    // replays what arrived since and swaps the standby book in: a move under
+    // book_mutex_ and one seqlock publish. The feed thread never waits on the
+    // snapshot, so other books on the same thread keep flowing.
+    //
+    // A snapshot that does not reach the newest gap is refused. If the ring
+    // overflows, or a new gap opens past the snapshot, the standby book is
+    // dropped and the state goes back to BUFFERING for another snapshot.
+    // Use either this or initialize_from_snapshot() for recovery, not both.
+    
+    static constexpr size_t RECOVERY_BUFFER_SIZE = 8192;  // Holds RECOVERY_BUFFER_SIZE - 1 updates
+    
+    // Allocate the ring and standby book (feed thread, before the first gap)
+    void enable_async_recovery() {
+        if (recovery_ring_) {
+            return;
+        }
+        recovery_ring_ = std::make_unique<RecoveryRing>();
+        standby_book_ = std::make_unique<BookBackend>(book_);
+    }
+    
+    bool async_recovery_enabled() const { return recovery_ring_ != nullptr; }
+    
+    BookRecoveryState recovery_state() const {
+        return recovery_state_.load(std::memory_order_acquire);
+    }
+    
+    // Recovery thread: stage `snapshot` plus the buffered updates after it.
+    // False if no recovery is waiting (state is not BUFFERING), the snapshot
+    // is older than the gap, or the ring already overflowed; in the last
+    // two cases fetch a newer snapshot.
+    bool recover_from_snapshot(const OrderBookSnapshot& snapshot) {
+        BookRecoveryState expected = BookRecoveryState::BUFFERING;
+        if (!recovery_state_.compare_exchange_strong(expected, BookRecoveryState::LOADING,
+                                                     std::memory_order_acq_rel)) {
+            return false;
+        }
+        if (snapshot.sequence_number + 1 < resume_sequence_.load(std::memory_order_acquire)) {
+            recovery_state_.store(BookRecoveryState::BUFFERING, std::memory_order_release);
+            return false;
+        }
+        
+        staged_snapshot_sequence_ = snapshot.sequence_number;
+        staged_sequence_ = snapshot.sequence_number;
+        staged_timestamp_ns_ = snapshot.timestamp_ns;
+        const bool overflowed = recovery_overflow_.load(std::memory_order_acquire);
+        if (!overflowed) {
+            standby_book_->load_snapshot(snapshot);
+            while (replay_buffered() > 0) {}
+        }
+        // Overflowed: the feed thread discards and restarts buffering
+        recovery_state_.store(BookRecoveryState::STAGED, std::memory_order_release);
+        return !overflowed;
+    }
+    
+    // Feed thread: swap in a staged recovery. True when the book is live
+    // (no gap pending); false while still waiting for a snapshot.
+    bool poll_recovery() {
+        if (LIKELY(!recovering_)) {
+            return !gap_detected_.load(std::memory_order_acquire);
+        }
+        if (recovery_state_.load(std::memory_order_acquire) == BookRecoveryState::STAGED) {
+            finish_recovery();
+        }
+        return !recovering_;
+    }
+    
+    // Feed thread, while recovering: hold an update for replay after the
+    // snapshot. False if async recovery is not active or the ring is full.
+    template<typename Update>
+    bool buffer_update(const Update& update) {
+        using F = UpdateFields<Update>;
+        if (!recovering_) {
+            return false;
+        }
+        
+        OrderBookUpdate held;
+        held.type = F::type(update);
+        held.order_id = F::order_id(update);
+        held.price = F::price(update);
+        held.quantity = F::quantity(update);
+        held.is_bid = F::is_bid(update);
+        held.sequence_number = F::sequence_number(update);
+        held.timestamp_ns = F::timestamp_ns(update);
+        if (UNLIKELY(recovery_overflow_.load(std::memory_order_relaxed) ||
+                     !recovery_ring_->push(held))) {
+            dropped_sequence_ = std::max(dropped_sequence_, held.sequence_number);
+            recovery_overflow_.store(true, std::memory_order_release);
+            return false;
+        }
+        return true;
+    }
+    
+    // ------------------------------------------------------------------------
+    // Deep OFI depth
+    // ------------------------------------------------------------------------
+    //
+    // The reconstructor mirrors the top max(ofi_depth(), 10) levels per side
+    // in SoA arrays, updated from just the levels each update touches, and
+    // computes DeepOFIFeatures from the mirror with the dispatched SIMD
+    // kernels. Per-update cost depends on neither the book's depth nor its
+    // history, so the aggregates can span up to MAX_OFI_LEVELS levels;
+    // bid_ofi/ask_ofi always carry the top DETAIL_LEVELS.
+    
+    static constexpr size_t MAX_OFI_LEVELS = 50;
+    
+    // Feed thread; restarts the OFI baseline
+    void set_ofi_depth(size_t levels) {
+        std::lock_guard<std::mutex> lock(book_mutex_);
+        ofi_levels_ = std::min(std::max<size_t>(levels, 1), MAX_OFI_LEVELS);
+        rebuild_depth();
+    }
+    
+    size_t ofi_depth() const { return ofi_levels_; }
+    
+    // Kernel variant for the OFI math (default: the dispatched one)
+    void select_kernels(const simd::KernelTable& kernels) { kernels_ = &kernels; }
+    
+    // The top-N mirror, best first (feed thread only)
+    const soa::SOA_OrderBook<MAX_OFI_LEVELS>& top_levels() const { return depth_; }
+    
+    // Sequence number of the last applied update or snapshot (feed thread only)
+    uint64_t last_sequence_number() const { return last_sequence_number_; }
+    
+    // Register callback for deep state publishing (runs on the feed thread).
+    // Slots are append-only, so publishing never takes a lock.
+    bool register_deep_state_callback(DeepStateCallback callback) {
         std::lock_guard<std::mutex> lock(callback_mutex_);
-        callbacks_.push_back(callback);
+        const size_t count = callback_count_.load(std::memory_order_relaxed);
+        if (count >= MAX_CALLBACKS) {
+            return false;
+        }
+        callbacks_[count] = std::move(callback);
+        callback_count_.store(count + 1, std::memory_order_release);
+        return true;
     }
     
-    // Get current best bid/ask
+    // Get current best bid/ask (lock-free, from the published snapshot)
     std::pair<std::optional<PriceLevel>, std::optional<PriceLevel>> get_top_of_book() const {
-        std::lock_guard<std::mutex> lock(book_mutex_);
+        const DepthSnapshot snap = snapshot_.load();
         
         std::optional<PriceLevel> best_bid;
         std::optional<PriceLevel> best_ask;
-        
-        if (!bids_.empty()) {
-            best_bid = bids_.rbegin()->second;  // Highest bid
+        if (snap.bid_levels > 0) {
+            best_bid = PriceLevel(snap.bid_prices[0], snap.bid_quantities[0], snap.bid_order_counts[0]);
         }
-        
-        if (!asks_.empty()) {
-            best_ask = asks_.begin()->second;   // Lowest ask
+        if (snap.ask_levels > 0) {
+            best_ask = PriceLevel(snap.ask_prices[0], snap.ask_quantities[0], snap.ask_order_counts[0]);
         }
         
         return {best_bid, best_ask};
     }
     
-    // Get multiple levels (for deep book analysis)
+    // Top-N levels + OFI as of the last applied update (lock-free, never
+    // blocks the feed thread; retries only while a publish is in flight)
+    DepthSnapshot get_depth_snapshot() const {
+        return snapshot_.load();
+    }
+    
+    // Single non-spinning attempt, for readers that must not wait at all
+    bool try_get_depth_snapshot(DepthSnapshot& out) const {
+        return snapshot_.try_load(out);
+    }
+    
+    // Number of snapshots published so far
+    uint64_t snapshot_version() const {
+        return snapshot_.version();
+    }
+    
+    // Get multiple levels (for deep book analysis; locks the book, so prefer
+    // get_depth_snapshot() on latency-sensitive threads)
     std::pair<std::vector<PriceLevel>, std::vector<PriceLevel>> 
     get_depth(size_t num_levels) const {
         std::lock_guard<std::mutex> lock(book_mutex_);
@@ -258,25 +1305,20 @@ public:
         std::vector<PriceLevel> bids;
         std::vector<PriceLevel> asks;
         
-        // Get top N bids (highest prices first)
-        size_t count = 0;
-        for (auto it = bids_.rbegin(); it != bids_.rend() && count < num_levels; ++it, ++count) {
-            bids.push_back(it->second);
-        }
-        
-        // Get top N asks (lowest prices first)
-        count = 0;
-        for (auto it = asks_.begin(); it != asks_.end() && count < num_levels; ++it, ++count) {
-            asks.push_back(it->second);
-        }
+        // Top N bids (highest prices first), top N asks (lowest prices first)
+        book_.for_each_bid(num_levels, [&](size_t, const PriceLevel& level) {
+            bids.push_back(level);
+        });
+        book_.for_each_ask(num_levels, [&](size_t, const PriceLevel& level) {
+            asks.push_back(level);
+        });
         
         return {bids, asks};
     }
     
     // Get current OFI features (non-blocking)
     DeepOFIFeatures get_current_ofi() const {
-        std::lock_guard<std::mutex> lock(ofi_mutex_);
-        return current_ofi_;
+        return snapshot_.load().ofi;
     }
     
     // Check if gap detected and needs snapshot recovery
@@ -300,6 +1342,10 @@ public:
         double last_spread;
     };
     
+    // Background recoveries swapped in, and attempts dropped for a newer snapshot
+    uint64_t recoveries() const { return recoveries_; }
+    uint64_t recovery_restarts() const { return recovery_restarts_; }
+    
     Statistics get_statistics() const {
         std::lock_guard<std::mutex> lock(book_mutex_);
         
@@ -307,10 +1353,10 @@ public:
         stats.total_updates = total_updates_;
         stats.missed_updates = missed_updates_;
         stats.snapshot_requests = snapshot_requests_;
-        stats.current_bid_levels = bids_.size();
-        stats.current_ask_levels = asks_.size();
+        stats.current_bid_levels = book_.bid_level_count();
+        stats.current_ask_levels = book_.ask_level_count();
         
-        auto [best_bid, best_ask] = get_top_of_book();
+        auto [best_bid, best_ask] = top_of_book_locked();
         if (best_bid && best_ask) {
             stats.last_mid_price = (best_bid->price + best_ask->price) / 2.0;
             stats.last_spread = best_ask->price - best_bid->price;
@@ -321,17 +1367,16 @@ public:
         
         return stats;
     }
+    
+    // Direct access to the storage backend (feed thread only)
+    const BookBackend& backend() const { return book_; }
 
 private:
     std::string symbol_;
     size_t max_depth_;
     
-    // Order book state (std::map provides O(log n) operations and sorted iteration)
-    std::map<double, PriceLevel> bids_;  // Price -> Level (descending order for bids)
-    std::map<double, PriceLevel> asks_;  // Price -> Level (ascending order for asks)
-    
-    // Order tracking for modify/cancel
-    std::unordered_map<uint64_t, TrackedOrder> orders_;
+    // Order book state (levels + tracked orders)
+    BookBackend book_;
     
     // Sequence number tracking for gap detection
     uint64_t last_sequence_number_;
@@ -343,167 +1388,175 @@ private:
     uint64_t snapshot_requests_;
     std::atomic<bool> is_initialized_;
     
-    // OFI state tracking
-    std::array<double, 10> previous_bid_quantities_;
-    std::array<double, 10> previous_ask_quantities_;
-    std::vector<double> recent_buy_volume_;
-    std::vector<double> recent_sell_volume_;
+    // Top-N mirror of book_ (feed thread). Slots past each side's level
+    // count are zero, so the kernels run over a fixed width.
+    soa::SOA_OrderBook<MAX_OFI_LEVELS> depth_;
+    size_t ofi_levels_ = DeepOFIFeatures::DETAIL_LEVELS;
+    size_t depth_levels_ = DepthSnapshot::MAX_LEVELS;   // max(ofi_levels_, DepthSnapshot::MAX_LEVELS)
+    alignas(64) std::array<double, MAX_OFI_LEVELS> previous_bid_quantities_{};
+    alignas(64) std::array<double, MAX_OFI_LEVELS> previous_ask_quantities_{};
+    std::array<double, MAX_OFI_LEVELS> previous_bid_prices_{};
+    std::array<double, MAX_OFI_LEVELS> previous_ask_prices_{};
+    size_t previous_bid_levels_ = 0;
+    size_t previous_ask_levels_ = 0;
+    const simd::KernelTable* kernels_ = &simd::kernels();
+    static constexpr std::array<double, MAX_OFI_LEVELS> ZEROS{};
+    
+    // Aggressive flow (untracked executions) and BBO history
+    static constexpr size_t PRESSURE_WINDOW = 1000;
+    static constexpr size_t VOLATILITY_WINDOW = 128;
+    soa::RollingWindow<PRESSURE_WINDOW> buy_volume_;
+    soa::RollingWindow<PRESSURE_WINDOW> sell_volume_;
+    soa::RollingWindow<VOLATILITY_WINDOW> microprice_window_;
+    soa::RollingWindow<VOLATILITY_WINDOW> spread_window_;
     
-    // Current OFI features
-    mutable DeepOFIFeatures current_ofi_;
+    // Published top-N depth + OFI (single writer: the feed thread)
+    Seqlock<DepthSnapshot> snapshot_;
     
-    // Callbacks for deep state publishing
-    std::vector<DeepStateCallback> callbacks_;
+    // Callbacks for deep state publishing (append-only)
+    static constexpr size_t MAX_CALLBACKS = 16;
+    std::array<DeepStateCallback, MAX_CALLBACKS> callbacks_;
+    std::atomic<size_t> callback_count_{0};
     
     // Thread safety
     mutable std::mutex book_mutex_;
-    mutable std::mutex ofi_mutex_;
-    mutable std::mutex callback_mutex_;
+    std::mutex callback_mutex_;  // Serializes registration only
     
-    // ========================================================================
-    // Update handlers
-    // ========================================================================
+    // Background recovery. The feed thread produces into the ring; the
+    // recovery thread consumes it in LOADING, the feed thread in STAGED
+    // (hand-offs through recovery_state_). staged_* belong to whichever
+    // thread owns the standby book.
+    using RecoveryRing = LockFreeQueue<OrderBookUpdate, RECOVERY_BUFFER_SIZE>;
+    std::unique_ptr<RecoveryRing> recovery_ring_;
+    std::unique_ptr<BookBackend> standby_book_;
+    std::atomic<BookRecoveryState> recovery_state_{BookRecoveryState::IDLE};
+    std::atomic<uint64_t> resume_sequence_{0};    // Snapshot must reach resume_sequence_ - 1
+    std::atomic<bool> recovery_overflow_{false};
+    uint64_t staged_snapshot_sequence_ = 0;
+    uint64_t staged_sequence_ = 0;                // Newest update in the standby book
+    int64_t staged_timestamp_ns_ = 0;
+    bool recovering_ = false;                     // Feed thread's view
+    uint64_t buffered_sequence_ = 0;              // Newest held by process_update()
+    uint64_t dropped_sequence_ = 0;               // Newest lost to overflow
+    uint64_t recoveries_ = 0;
+    uint64_t recovery_restarts_ = 0;
     
-    bool handle_add(const OrderBookUpdate& update) {
-        // Add new order to tracking
-        TrackedOrder order;
-        order.order_id = update.order_id;
-        order.price = update.price;
-        order.quantity = update.quantity;
-        order.is_bid = update.is_bid;
-        order.timestamp_ns = update.timestamp_ns;
-        orders_[update.order_id] = order;
-        
-        // Update price level
-        auto& book = update.is_bid ? bids_ : asks_;
-        auto it = book.find(update.price);
+    std::pair<std::optional<PriceLevel>, std::optional<PriceLevel>> top_of_book_locked() const {
+        std::optional<PriceLevel> best_bid;
+        std::optional<PriceLevel> best_ask;
         
-        if (it != book.end()) {
-            // Price level exists, add quantity
-            it->second.quantity += update.quantity;
-            it->second.order_count++;
-            it->second.last_update_ns = update.timestamp_ns;
-        } else {
-            // New price level
-            PriceLevel level(update.price, update.quantity, 1);
-            level.last_update_ns = update.timestamp_ns;
-            book[update.price] = level;
+        PriceLevel level;
+        if (book_.best_bid(level)) {
+            best_bid = level;
+        }
+        if (book_.best_ask(level)) {
+            best_ask = level;
         }
         
-        return true;
+        return {best_bid, best_ask};
     }
     
-    bool handle_modify(const OrderBookUpdate& update) {
-        auto order_it = orders_.find(update.order_id);
-        if (order_it == orders_.end()) {
-            // Order not found, treat as add
-            return handle_add(update);
+    // ========================================================================
+    // Update handlers
+    // ========================================================================
+    
+    // ADD / MODIFY / DELETE / EXECUTE on one backend (live or standby)
+    template<typename Update>
+    static bool apply_to_backend(BookBackend& book, const Update& update) {
+        switch (UpdateFields<Update>::type(update)) {
+            case UpdateType::ADD:
+                return book.add(update);
+            case UpdateType::MODIFY:
+                return book.modify(update);
+            case UpdateType::DELETE:
+                return book.remove(update);
+            case UpdateType::EXECUTE:
+                book.execute(update);  // Untracked executions leave levels alone
+                return true;
+            case UpdateType::SNAPSHOT:
+                return false;
         }
-        
-        TrackedOrder& order = order_it->second;
-        auto& book = order.is_bid ? bids_ : asks_;
-        
-        // Remove old quantity from old price level
-        auto old_level_it = book.find(order.price);
-        if (old_level_it != book.end()) {
-            old_level_it->second.quantity -= order.quantity;
-            old_level_it->second.order_count--;
-            
-            // Remove price level if empty
-            if (old_level_it->second.quantity <= 0.0 || old_level_it->second.order_count == 0) {
-                book.erase(old_level_it);
-            }
+        return false;
+    }
+    
+    // process_update() while recovering: the per-book sequence is
+    // contiguous, so a jump in the held updates is another gap
+    template<typename Update>
+    void hold_for_recovery(const Update& update) {
+        const uint64_t sequence = UpdateFields<Update>::sequence_number(update);
+        if (sequence <= buffered_sequence_) {
+            return;
         }
-        
-        // Add new quantity at new price level
-        order.price = update.price;
-        order.quantity = update.quantity;
-        order.timestamp_ns = update.timestamp_ns;
-        
-        auto new_level_it = book.find(update.price);
-        if (new_level_it != book.end()) {
-            new_level_it->second.quantity += update.quantity;
-            new_level_it->second.order_count++;
-            new_level_it->second.last_update_ns = update.timestamp_ns;
-        } else {
-            PriceLevel level(update.price, update.quantity, 1);
-            level.last_update_ns = update.timestamp_ns;
-            book[update.price] = level;
+        if (buffered_sequence_ != 0 && sequence != buffered_sequence_ + 1) {
+            report_gap(sequence - buffered_sequence_ - 1, sequence);
         }
-        
-        return true;
+        buffered_sequence_ = sequence;
+        buffer_update(update);
     }
     
-    bool handle_delete(const OrderBookUpdate& update) {
-        auto order_it = orders_.find(update.order_id);
-        if (order_it == orders_.end()) {
-            return false;  // Order not found
+    // Apply held updates past the snapshot to the standby book; returns
+    // how many were taken off the ring
+    size_t replay_buffered() {
+        return recovery_ring_->consume_all([this](OrderBookUpdate& update) {
+            if (update.sequence_number <= staged_sequence_) {
+                return;  // Covered by the snapshot, or a duplicate
+            }
+            apply_to_backend(*standby_book_, update);
+            staged_sequence_ = update.sequence_number;
+            staged_timestamp_ns_ = update.timestamp_ns;
+        });
+    }
+    
+    // Feed thread, state STAGED: catch the standby book up and swap it in,
+    // or drop it if it cannot be used
+    void finish_recovery() {
+        const bool overflowed = recovery_overflow_.load(std::memory_order_acquire);
+        if (!overflowed) {
+            while (replay_buffered() > 0) {}
         }
         
-        TrackedOrder& order = order_it->second;
-        auto& book = order.is_bid ? bids_ : asks_;
-        
-        // Remove quantity from price level
-        auto level_it = book.find(order.price);
-        if (level_it != book.end()) {
-            level_it->second.quantity -= order.quantity;
-            level_it->second.order_count--;
-            
-            // Remove price level if empty
-            if (level_it->second.quantity <= 0.0 || level_it->second.order_count == 0) {
-                book.erase(level_it);
-            }
+        const uint64_t resume = resume_sequence_.load(std::memory_order_relaxed);
+        if (overflowed || staged_snapshot_sequence_ + 1 < resume) {
+            // Everything held so far is discarded; the next snapshot must
+            // cover it as well as the gap
+            uint64_t newest = std::max(staged_sequence_, dropped_sequence_);
+            while (recovery_ring_->consume_all([&newest](OrderBookUpdate& update) {
+                newest = std::max(newest, update.sequence_number);
+            }) > 0) {}
+            resume_sequence_.store(std::max(resume, newest + 1), std::memory_order_release);
+            dropped_sequence_ = 0;
+            recovery_overflow_.store(false, std::memory_order_relaxed);
+            recovery_restarts_++;
+            recovery_state_.store(BookRecoveryState::BUFFERING, std::memory_order_release);
+            return;
         }
         
-        // Remove order from tracking
-        orders_.erase(order_it);
+        {
+            std::lock_guard<std::mutex> lock(book_mutex_);
+            std::swap(book_, *standby_book_);
+            last_sequence_number_ = staged_sequence_;
+            rebuild_depth();  // Fresh OFI baseline: deltas against the old book are meaningless
+        }
+        is_initialized_.store(true, std::memory_order_release);
+        recovering_ = false;
+        recoveries_++;
+        gap_detected_.store(false, std::memory_order_release);
+        recovery_state_.store(BookRecoveryState::IDLE, std::memory_order_release);
         
-        return true;
+        publish_snapshot(calculate_deep_ofi(staged_timestamp_ns_), staged_timestamp_ns_);
     }
     
-    bool handle_execute(const OrderBookUpdate& update) {
-        auto order_it = orders_.find(update.order_id);
-        if (order_it == orders_.end()) {
-            // Execution without tracked order (aggressive trade)
-            // Update pressure metrics
-            if (update.is_bid) {
-                recent_buy_volume_.push_back(update.quantity);
-            } else {
-                recent_sell_volume_.push_back(update.quantity);
-            }
-            
-            // Keep only recent window
-            if (recent_buy_volume_.size() > 1000) {
-                recent_buy_volume_.erase(recent_buy_volume_.begin());
-            }
-            if (recent_sell_volume_.size() > 1000) {
-                recent_sell_volume_.erase(recent_sell_volume_.begin());
-            }
-            
+    template<typename Update>
+    bool handle_execute(const Update& update) {
+        using F = UpdateFields<Update>;
+        
+        if (book_.execute(update)) {
             return true;
         }
         
-        TrackedOrder& order = order_it->second;
-        auto& book = order.is_bid ? bids_ : asks_;
-        
-        // Reduce quantity from price level
-        auto level_it = book.find(order.price);
-        if (level_it != book.end()) {
-            level_it->second.quantity -= update.quantity;
-            
-            // Check if fully executed
-            if (update.quantity >= order.quantity) {
-                level_it->second.order_count--;
-                orders_.erase(order_it);
-            } else {
-                order.quantity -= update.quantity;
-            }
-            
-            // Remove price level if empty
-            if (level_it->second.quantity <= 0.0 || level_it->second.order_count == 0) {
-                book.erase(level_it);
-            }
-        }
+        // Execution without tracked order (aggressive trade)
+        // Update pressure metrics (last PRESSURE_WINDOW trades per side)
+        (F::is_bid(update) ? buy_volume_ : sell_volume_).push(F::quantity(update));
         
         return true;
     }
@@ -512,119 +1565,194 @@ private:
     // Deep OFI calculation
     // ========================================================================
     
-    void store_previous_state() {
-        // Store current quantities for OFI delta calculation
-        size_t level = 0;
-        for (auto it = bids_.rbegin(); it != bids_.rend() && level < 10; ++it, ++level) {
-            previous_bid_quantities_[level] = it->second.quantity;
+    struct LevelTouch {
+        bool is_bid;
+        double price;
+    };
+    
+    // A resting order's old level, plus the level an add or modify lands on
+    template<typename Update>
+    size_t touched_levels(const Update& update, LevelTouch* out) const {
+        using F = UpdateFields<Update>;
+        size_t n = 0;
+        bool is_bid = F::is_bid(update);
+        double price = 0.0;
+        const bool resting = book_.order_level(F::order_id(update), is_bid, price);
+        if (resting) {
+            out[n++] = {is_bid, price};
         }
-        
-        level = 0;
-        for (auto it = asks_.begin(); it != asks_.end() && level < 10; ++it, ++level) {
-            previous_ask_quantities_[level] = it->second.quantity;
+        const UpdateType type = F::type(update);
+        if (type == UpdateType::ADD || type == UpdateType::MODIFY) {
+            // A modify keeps the resting order's side
+            out[n++] = {type == UpdateType::ADD ? F::is_bid(update) : is_bid, F::price(update)};
+        }
+        return n;
+    }
+    
+    // Re-read touched levels into the mirror; refill a side that lost one
+    void refresh_levels(const LevelTouch* touched, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            PriceLevel level;
+            const bool live = book_.level_at(touched[i].is_bid, touched[i].price, level);
+            if (depth_.set_level(touched[i].is_bid, level.price, live ? level.quantity : 0.0,
+                                 static_cast<uint32_t>(level.order_count), depth_levels_)) {
+                refill(touched[i].is_bid);
+            }
+        }
+    }
+    
+    void refill(bool is_bid) {
+        const size_t n = is_bid ? depth_.num_bid_levels : depth_.num_ask_levels;
+        if (n >= depth_levels_) {
+            return;
+        }
+        PriceLevel next;
+        const bool found = n == 0
+            ? (is_bid ? book_.best_bid(next) : book_.best_ask(next))
+            : book_.level_after(is_bid, is_bid ? depth_.bid_prices[n - 1] : depth_.ask_prices[n - 1], next);
+        if (found) {
+            depth_.append_level(is_bid, next.price, next.quantity, static_cast<uint32_t>(next.order_count));
+        }
+    }
+    
+    // Full re-read after a snapshot, swap or depth change; fresh OFI baseline
+    void rebuild_depth() {
+        depth_levels_ = std::max(ofi_levels_, DepthSnapshot::MAX_LEVELS);
+        depth_.clear_levels();
+        book_.for_each_bid(depth_levels_, [&](size_t, const PriceLevel& lvl) {
+            depth_.append_level(true, lvl.price, lvl.quantity, static_cast<uint32_t>(lvl.order_count));
+        });
+        book_.for_each_ask(depth_levels_, [&](size_t, const PriceLevel& lvl) {
+            depth_.append_level(false, lvl.price, lvl.quantity, static_cast<uint32_t>(lvl.order_count));
+        });
+        store_previous_state();
+    }
+    
+    void store_previous_state() {
+        // Store current levels for OFI delta calculation
+        previous_bid_quantities_ = depth_.bid_quantities;
+        previous_ask_quantities_ = depth_.ask_quantities;
+        previous_bid_prices_ = depth_.bid_prices;
+        previous_ask_prices_ = depth_.ask_prices;
+        previous_bid_levels_ = depth_.num_bid_levels;
+        previous_ask_levels_ = depth_.num_ask_levels;
+    }
+    
+    // Merge one side's previous and current top n (both best first) by
+    // price. matched[i]: previous quantity at the price now in slot i (0 if
+    // new); gone[j]: previous slot j's quantity if its price is no longer
+    // in the top n. Both arrays are zero past the levels present.
+    static void match_levels(bool is_bid, size_t n,
+                             const double* prices, size_t levels,
+                             const double* prev_prices, const double* prev_qty, size_t prev_levels,
+                             double* matched, double* gone) {
+        std::fill_n(matched, n, 0.0);
+        std::fill_n(gone, n, 0.0);
+        levels = std::min(levels, n);
+        prev_levels = std::min(prev_levels, n);
+        size_t i = 0;
+        size_t j = 0;
+        while (j < prev_levels) {
+            if (i < levels && prices[i] == prev_prices[j]) {
+                matched[i++] = prev_qty[j++];
+            } else if (i < levels && (is_bid ? prices[i] > prev_prices[j] : prices[i] < prev_prices[j])) {
+                ++i;                        // New level
+            } else {
+                gone[j] = prev_qty[j];      // Left the top n
+                ++j;
+            }
         }
     }
     
     DeepOFIFeatures calculate_deep_ofi(int64_t timestamp_ns) {
         DeepOFIFeatures features;
         features.timestamp_ns = timestamp_ns;
+        const simd::KernelTable& k = *kernels_;
+        const size_t n = ofi_levels_;
+        const double* bid_qty = depth_.bid_quantities.data();
+        const double* ask_qty = depth_.ask_quantities.data();
         
-        // Calculate per-level OFI
-        size_t level = 0;
-        for (auto it = bids_.rbegin(); it != bids_.rend() && level < 10; ++it, ++level) {
-            double delta = it->second.quantity - previous_bid_quantities_[level];
-            features.bid_ofi[level] = delta;
-        }
-        
-        level = 0;
-        for (auto it = asks_.begin(); it != asks_.end() && level < 10; ++it, ++level) {
-            double delta = it->second.quantity - previous_ask_quantities_[level];
-            features.ask_ofi[level] = delta;
-        }
+        // Per-level OFI, matched by price: the change at each level still
+        // (or newly) in the top n, less levels that left it
+        alignas(64) double bid_matched[MAX_OFI_LEVELS];
+        alignas(64) double ask_matched[MAX_OFI_LEVELS];
+        alignas(64) double bid_gone[MAX_OFI_LEVELS];
+        alignas(64) double ask_gone[MAX_OFI_LEVELS];
+        match_levels(true, n, depth_.bid_prices.data(), depth_.num_bid_levels,
+                     previous_bid_prices_.data(), previous_bid_quantities_.data(), previous_bid_levels_,
+                     bid_matched, bid_gone);
+        match_levels(false, n, depth_.ask_prices.data(), depth_.num_ask_levels,
+                     previous_ask_prices_.data(), previous_ask_quantities_.data(), previous_ask_levels_,
+                     ask_matched, ask_gone);
+        alignas(64) double bid_change[MAX_OFI_LEVELS];
+        alignas(64) double ask_change[MAX_OFI_LEVELS];
+        alignas(64) double bid_ofi[MAX_OFI_LEVELS];
+        alignas(64) double ask_ofi[MAX_OFI_LEVELS];
+        k.subtract(bid_qty, bid_matched, bid_change, n);
+        k.subtract(ask_qty, ask_matched, ask_change, n);
+        k.subtract(bid_change, bid_gone, bid_ofi, n);
+        k.subtract(ask_change, ask_gone, ask_ofi, n);
+        const size_t detail = std::min(n, DeepOFIFeatures::DETAIL_LEVELS);
+        std::copy_n(bid_ofi, detail, features.bid_ofi.begin());
+        std::copy_n(ask_ofi, detail, features.ask_ofi.begin());
         
         // Aggregate OFI metrics
-        features.total_ofi = 0.0;
-        features.top_5_ofi = 0.0;
-        for (size_t i = 0; i < 10; ++i) {
-            double level_ofi = features.bid_ofi[i] - features.ask_ofi[i];
-            features.total_ofi += level_ofi;
-            if (i < 5) {
-                features.top_5_ofi += level_ofi;
-            }
-        }
-        features.top_1_ofi = features.bid_ofi[0] - features.ask_ofi[0];
+        features.total_ofi = k.sum_difference(bid_ofi, ask_ofi, n);
+        features.top_5_ofi = k.sum_difference(bid_ofi, ask_ofi, std::min<size_t>(n, 5));
+        features.top_1_ofi = bid_ofi[0] - ask_ofi[0];
         
-        // Volume-weighted OFI
-        double total_volume = 0.0;
-        features.weighted_ofi = 0.0;
-        level = 0;
-        for (auto it = bids_.rbegin(); it != bids_.rend() && level < 10; ++it, ++level) {
-            features.weighted_ofi += features.bid_ofi[level] * it->second.quantity;
-            total_volume += it->second.quantity;
-        }
-        level = 0;
-        for (auto it = asks_.begin(); it != asks_.end() && level < 10; ++it, ++level) {
-            features.weighted_ofi -= features.ask_ofi[level] * it->second.quantity;
-            total_volume += it->second.quantity;
-        }
-        if (total_volume > 0.0) {
-            features.weighted_ofi /= total_volume;
-        }
+        // Volume-weighted OFI: one dot product per side (1-row dense layer);
+        // levels that left have no current volume, so no weight
+        double bid_weighted = 0.0;
+        double ask_weighted = 0.0;
+        k.dense(bid_change, bid_qty, ZEROS.data(), &bid_weighted, 1, n);
+        k.dense(ask_change, ask_qty, ZEROS.data(), &ask_weighted, 1, n);
+        const double total_volume = k.sum_difference(bid_qty, ZEROS.data(), n)
+                                  + k.sum_difference(ask_qty, ZEROS.data(), n);
+        features.weighted_ofi = total_volume > 0.0 ? (bid_weighted - ask_weighted) / total_volume : 0.0;
         
-        // Order book imbalance
-        double bid_volume = 0.0, ask_volume = 0.0;
-        for (const auto& [price, level] : bids_) {
-            bid_volume += level.quantity;
-        }
-        for (const auto& [price, level] : asks_) {
-            ask_volume += level.quantity;
-        }
+        // Order book imbalance (whole book; backends keep running totals)
+        const double bid_volume = book_.total_bid_volume();
+        const double ask_volume = book_.total_ask_volume();
         
         if (bid_volume + ask_volume > 0.0) {
             features.volume_imbalance = (bid_volume - ask_volume) / (bid_volume + ask_volume);
         }
         
-        double bid_depth = bids_.size();
-        double ask_depth = asks_.size();
+        double bid_depth = static_cast<double>(book_.bid_level_count());
+        double ask_depth = static_cast<double>(book_.ask_level_count());
         if (bid_depth + ask_depth > 0.0) {
             features.depth_imbalance = (bid_depth - ask_depth) / (bid_depth + ask_depth);
         }
         
         // Spread and mid price
-        if (!bids_.empty() && !asks_.empty()) {
-            double best_bid = bids_.rbegin()->first;
-            double best_ask = asks_.begin()->first;
+        if (depth_.num_bid_levels > 0 && depth_.num_ask_levels > 0) {
+            double best_bid = depth_.bid_prices[0];
+            double best_ask = depth_.ask_prices[0];
             features.bid_ask_spread = best_ask - best_bid;
             features.mid_price = (best_bid + best_ask) / 2.0;
             
             // Volume-weighted mid
-            double bid_qty = bids_.rbegin()->second.quantity;
-            double ask_qty = asks_.begin()->second.quantity;
-            if (bid_qty + ask_qty > 0.0) {
-                features.weighted_mid_price = (best_bid * ask_qty + best_ask * bid_qty) 
-                                             / (bid_qty + ask_qty);
+            double bid_top = bid_qty[0];
+            double ask_top = ask_qty[0];
+            if (bid_top + ask_top > 0.0) {
+                features.weighted_mid_price = (best_bid * ask_top + best_ask * bid_top) 
+                                             / (bid_top + ask_top);
             } else {
                 features.weighted_mid_price = features.mid_price;
             }
+            
+            microprice_window_.push(features.weighted_mid_price);
+            spread_window_.push(features.bid_ask_spread);
         }
+        features.microprice_volatility = microprice_window_.stddev();
+        features.spread_volatility = spread_window_.stddev();
         
         // Pressure metrics
-        features.buy_pressure = 0.0;
-        features.sell_pressure = 0.0;
-        for (double vol : recent_buy_volume_) {
-            features.buy_pressure += vol;
-        }
-        for (double vol : recent_sell_volume_) {
-            features.sell_pressure += vol;
-        }
+        features.buy_pressure = buy_volume_.total();
+        features.sell_pressure = sell_volume_.total();
         features.net_pressure = features.buy_pressure - features.sell_pressure;
         
-        // Store for external access
-        {
-            std::lock_guard<std::mutex> lock(ofi_mutex_);
-            current_ofi_ = features;
-        }
-        
         return features;
     }
     
@@ -632,12 +1760,36 @@ private:
     // Deep state publishing
     // ========================================================================
     
+    void publish_snapshot(const DeepOFIFeatures& features, int64_t timestamp_ns) {
+        DepthSnapshot snap;
+        constexpr size_t N = DepthSnapshot::MAX_LEVELS;
+        std::copy_n(depth_.bid_prices.begin(), N, snap.bid_prices.begin());
+        std::copy_n(depth_.bid_quantities.begin(), N, snap.bid_quantities.begin());
+        std::copy_n(depth_.bid_order_counts.begin(), N, snap.bid_order_counts.begin());
+        std::copy_n(depth_.ask_prices.begin(), N, snap.ask_prices.begin());
+        std::copy_n(depth_.ask_quantities.begin(), N, snap.ask_quantities.begin());
+        std::copy_n(depth_.ask_order_counts.begin(), N, snap.ask_order_counts.begin());
+        snap.bid_levels = static_cast<uint32_t>(std::min(depth_.num_bid_levels, N));
+        snap.ask_levels = static_cast<uint32_t>(std::min(depth_.num_ask_levels, N));
+        snap.sequence_number = last_sequence_number_;
+        snap.timestamp_ns = timestamp_ns;
+        snap.ofi = features;
+        
+        snapshot_.store(snap);
+    }
+    
     void publish_deep_state(const DeepOFIFeatures& features) {
-        std::lock_guard<std::mutex> lock(callback_mutex_);
-        for (auto& callback : callbacks_) {
-            callback(features);
+        const size_t count = callback_count_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            callbacks_[i](features);
         }
     }
 };
 
+// Default reconstructor keeps the std::map backend
+using OrderBookReconstructor = BasicOrderBookReconstructor<MapBookBackend>;
+
+// Allocation-free L3 reconstructor (tick-indexed levels, pooled orders)
+using FlatOrderBookReconstructor = BasicOrderBookReconstructor<FlatBookBackend<>>;
+
 } // namespace hft
@@ -0,0 +1,336 @@
+#pragma once
+
+#include "common_types.hpp"
+#include "lockfree_queue.hpp"
+#include "preserialized_orders.hpp"
+#include "solarflare_efvi.hpp"
+#include "spin_loop_engine.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace hft {
+namespace gateway {
+
+// ====
+// Order-Entry Gateway
+// Strategies -> MPSC intent ring -> one gateway thread -> templates patched
+// straight into transport TX buffers, several messages per packet
+// ====
+
+enum class IntentType : uint8_t {
+    NEW = 0,
+    CANCEL = 1,
+    REPLACE = 2   // Atomic cancel/replace (one wire message)
+};
+
+// What a strategy enqueues: no serialization on the strategy thread
+struct OrderIntent {
+    uint64_t order_id;
+    uint64_t original_order_id;   // CANCEL / REPLACE target
+    double price;
+    double quantity;
+    uint32_t symbol_id;
+    IntentType type;
+    Side side;
+    uint8_t time_in_force;        // 0=GTC, 1=IOC, 2=FOK
+    uint8_t padding;
+};
+
+struct GatewayStats {
+    uint64_t intents = 0;
+    uint64_t messages = 0;
+    uint64_t packets = 0;
+    uint64_t rejected = 0;        // No templates for the symbol
+    uint64_t send_failures = 0;   // Messages in packets the transport refused (each is retried)
+};
+
+// ====
+// Transports
+// Required interface:
+//   uint8_t* acquire(size_t& capacity)  next TX payload buffer, nullptr if full
+//   bool transmit(size_t len)           send the acquired buffer
+// ====
+
+// Serializes into the ef_vi TX ring itself; an optional pre-built frame
+// header (Ethernet/IP/UDP) is laid down in front of the payload
+class EfviTransport {
+public:
+    explicit EfviTransport(network::SolarflareEFVI& vi,
+                           const uint8_t* frame_header = nullptr, size_t header_len = 0,
+                           size_t frame_size = network::EFVI_PKT_BUF_SIZE)
+        : vi_(vi), header_len_(header_len), frame_size_(frame_size) {
+        if (header_len > header_.size() || header_len >= frame_size) {
+            throw std::invalid_argument("Frame header too large");
+        }
+        if (header_len > 0) std::memcpy(header_.data(), frame_header, header_len);
+    }
+
+    uint8_t* acquire(size_t& capacity) {
+        uint8_t* frame = vi_.tx_buffer();
+        if (frame == nullptr) return nullptr;
+        if (header_len_ > 0) std::memcpy(frame, header_.data(), header_len_);
+        capacity = frame_size_ - header_len_;
+        return frame + header_len_;
+    }
+
+    bool transmit(size_t len) { return vi_.transmit_buffer(header_len_ + len); }
+
+private:
+    network::SolarflareEFVI& vi_;
+    std::array<uint8_t, 128> header_{};
+    size_t header_len_;
+    size_t frame_size_;
+};
+
+// TCPDirect takes a contiguous payload; messages are packed into one
+// staging segment and handed over in a single send
+class TcpDirectTransport {
+public:
+    static constexpr size_t SEGMENT_SIZE = 1460;   // One MSS
+
+    explicit TcpDirectTransport(network::TCPDirectConnection& connection)
+        : connection_(connection) {}
+
+    uint8_t* acquire(size_t& capacity) {
+        capacity = segment_.size();
+        return segment_.data();
+    }
+
+    bool transmit(size_t len) { return connection_.send_zerocopy(segment_.data(), len); }
+
+private:
+    network::TCPDirectConnection& connection_;
+    alignas(64) std::array<uint8_t, SEGMENT_SIZE> segment_{};
+};
+
+// Single gateway thread per session. Strategy threads each hold one
+// StrategyPort; ports share the intent ring but number their orders from
+// their own OrderIdBlock, so sending never touches a shared counter.
+template<typename Transport, size_t QueueSize = 4096>
+class OrderGateway {
+public:
+    using IntentQueue = MPSCQueue<OrderIntent, QueueSize>;
+
+    static constexpr size_t MAX_MESSAGES_PER_PACKET = 32;
+
+    class StrategyPort {
+    public:
+        StrategyPort(StrategyPort&&) = default;
+        StrategyPort(const StrategyPort&) = delete;
+        StrategyPort& operator=(const StrategyPort&) = delete;
+
+        // Each returns the new order ID, or 0 if the intent ring is full
+        uint64_t send_limit(uint32_t symbol_id, Side side, double price, double quantity,
+                            uint8_t time_in_force = 0) {
+            return enqueue(IntentType::NEW, symbol_id, 0, side, price, quantity, time_in_force);
+        }
+
+        uint64_t cancel(uint32_t symbol_id, uint64_t original_order_id) {
+            return enqueue(IntentType::CANCEL, symbol_id, original_order_id, Side::BUY, 0.0, 0.0, 0);
+        }
+
+        uint64_t replace(uint32_t symbol_id, uint64_t original_order_id, Side side,
+                         double price, double quantity) {
+            return enqueue(IntentType::REPLACE, symbol_id, original_order_id, side, price, quantity, 0);
+        }
+
+        uint16_t strategy_id() const { return strategy_id_; }
+
+    private:
+        friend class OrderGateway;
+
+        StrategyPort(IntentQueue& queue, uint16_t strategy_id)
+            : queue_(&queue), ids_(strategy_id), strategy_id_(strategy_id) {}
+
+        uint64_t enqueue(IntentType type, uint32_t symbol_id, uint64_t original_order_id,
+                         Side side, double price, double quantity, uint8_t time_in_force) {
+            OrderIntent intent;
+            intent.order_id = ids_.next();
+            intent.original_order_id = original_order_id;
+            intent.price = price;
+            intent.quantity = quantity;
+            intent.symbol_id = symbol_id;
+            intent.type = type;
+            intent.side = side;
+            intent.time_in_force = time_in_force;
+            intent.padding = 0;
+            // A refused intent burns its ID; IDs stay unique, not dense
+            return queue_->push(intent) ? intent.order_id : 0;
+        }
+
+        IntentQueue* queue_;
+        preserialized::OrderIdBlock ids_;
+        uint16_t strategy_id_;
+    };
+
+    OrderGateway(const preserialized::OrderTemplatePool& templates, Transport& transport,
+                 int cpu_core = -1)
+        : templates_(templates), transport_(transport), cpu_core_(cpu_core),
+          intents_(new IntentQueue()) {}
+
+    ~OrderGateway() { stop(); }
+
+    OrderGateway(const OrderGateway&) = delete;
+    OrderGateway& operator=(const OrderGateway&) = delete;
+
+    // Setup time: one port per strategy ID
+    StrategyPort port(uint16_t strategy_id) {
+        if (strategy_id < issued_ports_.size() && issued_ports_[strategy_id]) {
+            throw std::invalid_argument("Strategy already has a gateway port");
+        }
+        if (strategy_id >= issued_ports_.size()) issued_ports_.resize(strategy_id + 1, false);
+        issued_ports_[strategy_id] = true;
+        return StrategyPort(*intents_, strategy_id);
+    }
+
+    // Gateway thread: drain the ring into as few packets as possible.
+    // Returns messages sent. If the transport has no free buffer the
+    // remaining intents stay queued for the next call. If it refuses a
+    // packet, that packet's sequence numbers are handed back and its
+    // intents are re-sent, first and in order, on the next call, so the
+    // session never skips a sequence number or drops an order.
+    size_t poll() {
+        size_t sent = 0;
+        while (has_pending()) {
+            size_t capacity = 0;
+            uint8_t* packet = transport_.acquire(capacity);
+            if (packet == nullptr || capacity < preserialized::MAX_ORDER_MESSAGE_SIZE) {
+                break;
+            }
+
+            const uint64_t timestamp_ns = static_cast<uint64_t>(to_nanos(now()));
+            size_t len = 0;
+            size_t messages = 0;
+            while (messages < MAX_MESSAGES_PER_PACKET &&
+                   capacity - len >= preserialized::MAX_ORDER_MESSAGE_SIZE && has_pending()) {
+                has_pending_ = false;
+                ++stats_.intents;
+                const size_t n = serialize(pending_, timestamp_ns, packet + len);
+                if (n == 0) [[unlikely]] {
+                    ++stats_.rejected;
+                    continue;
+                }
+                reinterpret_cast<preserialized::OrderMessageHeader*>(packet + len)->sequence_number = ++sequence_;
+                batch_[messages] = pending_;
+                len += n;
+                ++messages;
+            }
+
+            if (len == 0) continue;  // Everything rejected; buffer not committed
+            if (transport_.transmit(len)) [[likely]] {
+                ++stats_.packets;
+                stats_.messages += messages;
+                sent += messages;
+            } else {
+                stats_.send_failures += messages;
+                requeue_batch(messages);
+                break;
+            }
+        }
+        return sent;
+    }
+
+    void start() {
+        if (running_.exchange(true)) return;
+        worker_ = std::thread([this] { run(); });
+    }
+
+    // Stops the thread after sending whatever is still queued
+    void stop() {
+        if (!running_.exchange(false)) return;
+        if (worker_.joinable()) worker_.join();
+    }
+
+    // Gateway thread only, or after stop()
+    const GatewayStats& stats() const { return stats_; }
+
+    // Last session sequence number sent
+    uint32_t sequence() const { return sequence_; }
+
+private:
+    void run() {
+        if (cpu_core_ >= 0) spin_loop::pin_to_cpu(cpu_core_);
+        while (running_.load(std::memory_order_acquire)) {
+            if (poll() == 0) std::this_thread::yield();
+        }
+        poll();
+    }
+
+    // Re-sent intents go before anything still in the ring
+    bool has_pending() {
+        if (!has_pending_) {
+            if (retry_head_ < retry_count_) {
+                pending_ = retry_[retry_head_++];
+                has_pending_ = true;
+            } else {
+                has_pending_ = intents_->pop(pending_);
+            }
+        }
+        return has_pending_;
+    }
+
+    // Refused packet: its intents, then the retries it didn't reach, then
+    // the intent already popped for the next packet. At most one packet
+    // plus one intent, since a retry pass drains retry_ before the ring.
+    void requeue_batch(size_t messages) {
+        sequence_ -= static_cast<uint32_t>(messages);
+        stats_.intents -= messages;              // Counted again when re-sent
+
+        std::array<OrderIntent, MAX_MESSAGES_PER_PACKET + 1> order;
+        size_t count = 0;
+        for (size_t i = 0; i < messages; ++i) order[count++] = batch_[i];
+        while (retry_head_ < retry_count_) order[count++] = retry_[retry_head_++];
+        if (has_pending_) order[count++] = pending_;
+        has_pending_ = false;
+
+        retry_ = order;
+        retry_head_ = 0;
+        retry_count_ = count;
+    }
+
+    size_t serialize(const OrderIntent& intent, uint64_t timestamp_ns, uint8_t* out) const {
+        switch (intent.type) {
+            case IntentType::NEW:
+                return templates_.write_new_order(intent.symbol_id, intent.time_in_force, intent.order_id,
+                                                  intent.side, intent.price, intent.quantity,
+                                                  timestamp_ns, out);
+            case IntentType::CANCEL:
+                return templates_.write_cancel(intent.symbol_id, intent.order_id,
+                                               intent.original_order_id, timestamp_ns, out);
+            case IntentType::REPLACE:
+                return templates_.write_cancel_replace(intent.symbol_id, intent.order_id,
+                                                       intent.original_order_id, intent.side,
+                                                       intent.price, intent.quantity, timestamp_ns, out);
+        }
+        return 0;
+    }
+
+    const preserialized::OrderTemplatePool& templates_;
+    Transport& transport_;
+    int cpu_core_;
+
+    std::unique_ptr<IntentQueue> intents_;   // Large; kept off the caller's stack
+    std::vector<bool> issued_ports_;
+
+    OrderIntent pending_{};
+    bool has_pending_ = false;
+    std::array<OrderIntent, MAX_MESSAGES_PER_PACKET> batch_{};        // Intents in the packet being built
+    std::array<OrderIntent, MAX_MESSAGES_PER_PACKET + 1> retry_{};    // From a refused packet
+    size_t retry_head_ = 0;
+    size_t retry_count_ = 0;
+    uint32_t sequence_ = 0;
+    GatewayStats stats_;
+
+    std::thread worker_;
+    std::atomic<bool> running_{false};
+};
+
+} // namespace gateway
+} // namespace hft
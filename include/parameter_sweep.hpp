@@ -0,0 +1,155 @@
+#pragma once
+
+#include "backtesting_engine.hpp"
+#include "work_stealing_pool.hpp"
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace hft {
+namespace backtest {
+
+// ====
+// Parallel Parameter Sweep
+// Loads the event stream once, then runs one quiet BacktestingEngine per
+// grid point on a work-stealing pool. Every engine replays the same
+// read-only events (share_historical_data) and owns all of its other state.
+// ====
+
+// Cartesian grid over BacktestConfig. An empty axis keeps the base value.
+struct SweepGrid {
+    std::vector<int64_t> latency_ns;
+    std::vector<int64_t> max_position;
+    std::vector<double> commission_per_share;
+    std::vector<uint32_t> seeds;
+    std::vector<StrategyParams> strategy;
+    std::vector<HawkesParams> hawkes;
+
+    // Points in row-major order (latency outermost, hawkes innermost)
+    std::vector<BacktestConfig> expand(const BacktestConfig& base) const {
+        std::vector<BacktestConfig> points{base};
+        auto vary = [&points](const auto& axis, auto apply) {
+            if (axis.empty()) return;
+            std::vector<BacktestConfig> next;
+            next.reserve(points.size() * axis.size());
+            for (const auto& p : points) {
+                for (const auto& value : axis) {
+                    next.push_back(p);
+                    apply(next.back(), value);
+                }
+            }
+            points.swap(next);
+        };
+        vary(latency_ns, [](BacktestConfig& c, int64_t v) { c.simulated_latency_ns = v; });
+        vary(max_position, [](BacktestConfig& c, int64_t v) { c.max_position = v; });
+        vary(commission_per_share, [](BacktestConfig& c, double v) { c.commission_per_share = v; });
+        vary(seeds, [](BacktestConfig& c, uint32_t v) { c.random_seed = v; });
+        vary(strategy, [](BacktestConfig& c, const StrategyParams& v) { c.strategy = v; });
+        vary(hawkes, [](BacktestConfig& c, const HawkesParams& v) { c.hawkes = v; });
+        return points;
+    }
+
+    // `count` distinct, reproducible seeds derived from `base`
+    static std::vector<uint32_t> derived_seeds(uint32_t base, size_t count) {
+        std::vector<uint32_t> out(count);
+        uint64_t x = base;
+        for (auto& seed : out) {
+            x += 0x9E3779B97F4A7C15ULL;  // splitmix64
+            uint64_t z = x;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            seed = static_cast<uint32_t>(z ^ (z >> 31));
+        }
+        return out;
+    }
+};
+
+struct SweepResult {
+    size_t index = 0;            // Position in the point list
+    BacktestConfig config;
+    PerformanceMetrics metrics;
+};
+
+class ParameterSweep {
+public:
+    // threads = 0 uses all hardware threads
+    explicit ParameterSweep(unsigned threads = 0)
+        : pool_(threads), data_(quiet_config(BacktestConfig(), static_cast<unsigned>(pool_.thread_count()))) {}
+
+    bool load_historical_data(const std::string& filepath) {
+        return data_.load_historical_data(filepath);
+    }
+
+    bool load_binary_data(const std::string& filepath) {
+        return data_.load_binary_data(filepath);
+    }
+
+    size_t event_count() const { return data_.get_historical_events_count(); }
+    size_t thread_count() const { return pool_.thread_count(); }
+
+    // Results come back in point order regardless of which thread ran what.
+    // Each point runs with its own config's random_seed, so a point gives
+    // the same metrics whatever else is in the sweep.
+    std::vector<SweepResult> run(const std::vector<BacktestConfig>& points) {
+        std::vector<SweepResult> results(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            results[i].index = i;
+            results[i].config = points[i];
+            pool_.submit([this, &results, i] {
+                BacktestingEngine engine(quiet_config(results[i].config, 1));
+                engine.share_historical_data(data_);
+                results[i].metrics = engine.run_backtest();
+            });
+        }
+        pool_.wait();
+        return results;
+    }
+
+    std::vector<SweepResult> run(const BacktestConfig& base, const SweepGrid& grid) {
+        return run(grid.expand(base));
+    }
+
+    static void print_results(const std::vector<SweepResult>& results) {
+        std::cout << "\n" << std::string(86, '=') << "\n";
+        std::cout << "PARAMETER SWEEP (" << results.size() << " points)\n";
+        std::cout << std::string(86, '=') << "\n";
+        std::cout << std::setw(6) << "#"
+                  << std::setw(12) << "Latency"
+                  << std::setw(10) << "MaxPos"
+                  << std::setw(12) << "Comm"
+                  << std::setw(12) << "Seed"
+                  << std::setw(12) << "P&L ($)"
+                  << std::setw(10) << "Sharpe"
+                  << std::setw(12) << "Fill Rate" << "\n";
+        std::cout << std::string(86, '-') << "\n";
+        for (const auto& r : results) {
+            std::cout << std::setw(6) << r.index
+                      << std::setw(12) << r.config.simulated_latency_ns
+                      << std::setw(10) << r.config.max_position
+                      << std::setw(12) << std::setprecision(4) << r.config.commission_per_share
+                      << std::setw(12) << r.config.random_seed
+                      << std::setw(12) << std::fixed << std::setprecision(2) << r.metrics.total_pnl
+                      << std::setw(10) << std::setprecision(3) << r.metrics.sharpe_ratio
+                      << std::setw(12) << std::setprecision(3) << r.metrics.fill_rate << "\n";
+            std::cout.unsetf(std::ios::floatfield);
+        }
+        std::cout << std::string(86, '=') << "\n\n";
+    }
+
+private:
+    WorkStealingPool pool_;
+    BacktestingEngine data_;     // Owns the shared event stream only
+
+    // Parallel runs share stdout and the logs/ files; keep them off both
+    static BacktestConfig quiet_config(BacktestConfig config, unsigned parse_threads) {
+        config.verbose = false;
+        config.enable_replay_logging = false;
+        config.csv_parse_threads = parse_threads;
+        return config;
+    }
+};
+
+} // namespace backtest
+} // namespace hft
@@ -0,0 +1,650 @@
+#pragma once
+
+#include "common_types.hpp"
+#include "clock.hpp"
+#include "latency_histogram.hpp"
+#include "feed_handler.hpp"
+#include "hawkes_engine.hpp"
+#include "fpga_inference.hpp"
+#include "avellaneda_stoikov.hpp"
+#include "risk_control.hpp"
+#include "preserialized_orders.hpp"
+#include "tick_store.hpp"
+#include "backtesting_engine.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+
+namespace hft {
+namespace benchmark {
+
+// ====
+// Tick-to-Trade Pipeline Benchmark
+// ====
+//
+// Open-loop load generator: every packet has an intended arrival time from
+// a LoadProfile, and its latency is measured from that time, not from when
+// the pipeline got round to it. If the pipeline falls behind, the wait
+// counts against the packets that had to wait, so the percentiles are
+// corrected for coordinated omission. One thread drives and processes,
+// which gives the same answer as a separate sender without needing a
+// second core.
+
+inline uint64_t pipeline_cycles() {
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+    return tsc::read_counter();
+#else
+    return static_cast<uint64_t>(to_nanos(now()));
+#endif
+}
+
+inline void pipeline_pause() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// ====
+// Offered Load
+// ====
+
+enum class LoadShape : uint8_t {
+    STEADY,        // Constant rate
+    BURSTY,        // Periodic bursts at a multiple of the base rate
+    MARKET_OPEN    // Surge at t=0 decaying back to the base rate
+};
+
+struct LoadProfile {
+    LoadShape shape = LoadShape::STEADY;
+    double rate_pps = 100000.0;        // Base packet rate
+    double burst_multiplier = 8.0;     // BURSTY: rate inside a burst
+    double burst_us = 200.0;           // BURSTY: burst length
+    double period_us = 2000.0;         // BURSTY: burst every period
+    double open_surge = 10.0;          // MARKET_OPEN: rate multiple at t=0
+    double open_decay_ms = 20.0;       // MARKET_OPEN: e-folding time of the surge
+
+    static LoadProfile steady(double rate_pps) {
+        LoadProfile p;
+        p.rate_pps = rate_pps;
+        return p;
+    }
+
+    static LoadProfile bursty(double rate_pps, double multiplier = 8.0,
+                              double burst_us = 200.0, double period_us = 2000.0) {
+        LoadProfile p;
+        p.shape = LoadShape::BURSTY;
+        p.rate_pps = rate_pps;
+        p.burst_multiplier = multiplier;
+        p.burst_us = burst_us;
+        p.period_us = period_us;
+        return p;
+    }
+
+    static LoadProfile market_open(double rate_pps, double surge = 10.0, double decay_ms = 20.0) {
+        LoadProfile p;
+        p.shape = LoadShape::MARKET_OPEN;
+        p.rate_pps = rate_pps;
+        p.open_surge = surge;
+        p.open_decay_ms = decay_ms;
+        return p;
+    }
+
+    // Same shape, different base rate (throughput sweeps)
+    LoadProfile at_rate(double rate) const {
+        LoadProfile p = *this;
+        p.rate_pps = rate;
+        return p;
+    }
+
+    const char* name() const {
+        switch (shape) {
+            case LoadShape::STEADY: return "steady";
+            case LoadShape::BURSTY: return "bursty";
+            case LoadShape::MARKET_OPEN: return "market_open";
+        }
+        return "unknown";
+    }
+
+    // Instantaneous offered rate t_ns after the start of the run
+    double rate_at(double t_ns) const {
+        switch (shape) {
+            case LoadShape::STEADY:
+                return rate_pps;
+            case LoadShape::BURSTY: {
+                const double in_period = std::fmod(t_ns, period_us * 1000.0);
+                return in_period < burst_us * 1000.0 ? rate_pps * burst_multiplier : rate_pps;
+            }
+            case LoadShape::MARKET_OPEN:
+                return rate_pps * (1.0 + (open_surge - 1.0) * std::exp(-t_ns / (open_decay_ms * 1e6)));
+        }
+        return rate_pps;
+    }
+
+    // Intended arrival of the packet after one arriving at t_ns
+    double next_arrival_ns(double t_ns) const {
+        return t_ns + 1e9 / rate_at(t_ns);
+    }
+};
+
+// ====
+// Stage Timestamps
+// ====
+
+enum PipelineStage : size_t {
+    STAGE_NIC_RX,        // Frame into the RX ring and back out (loopback DMA)
+    STAGE_DECODE_BOOK,   // Message decode, book update, top-of-book read
+    STAGE_HAWKES,        // Intensity update on trades
+    STAGE_INFERENCE,     // Feature extraction + DNN
+    STAGE_QUOTE,         // Avellaneda-Stoikov quotes
+    STAGE_RISK,          // Pre-trade checks
+    STAGE_ENCODE,        // Order template patching
+    PIPELINE_STAGE_COUNT
+};
+
+inline const char* stage_name(size_t stage) {
+    static const char* const names[PIPELINE_STAGE_COUNT] = {
+        "NIC RX", "Decode + Book", "Hawkes", "Inference", "Quote", "Risk", "Encode"
+    };
+    return stage < PIPELINE_STAGE_COUNT ? names[stage] : "unknown";
+}
+
+// The pipeline marks the end of each stage; stages it skips keep the
+// previous mark and count as zero
+struct StageStamps {
+    std::array<uint64_t, PIPELINE_STAGE_COUNT> done{};
+
+    void mark(PipelineStage stage) { done[stage] = pipeline_cycles(); }
+};
+
+// ====
+// Results
+// ====
+
+struct PipelineRunResult {
+    LoadProfile profile;
+    size_t packets = 0;
+    double duration_s = 0.0;
+    double offered_pps = 0.0;         // Packets / span of intended arrivals
+    double achieved_pps = 0.0;        // Packets / time until the last one finished
+    LatencyHistogram response_ns;     // From intended arrival (CO-corrected)
+    LatencyHistogram service_ns;      // From pick-up (what a closed loop reports)
+    std::array<LatencyHistogram, PIPELINE_STAGE_COUNT> stage_ns;
+};
+
+// ====
+// Open-Loop Runner
+// Pipeline: void process(size_t index, int64_t arrival_ns, StageStamps&)
+// where arrival_ns is the packet's intended arrival since the run started.
+// ====
+
+class PipelineRunner {
+public:
+    explicit PipelineRunner(const TscClock& clock = TscClock())
+        : ns_per_cycle_(clock.ns_per_cycle() > 0.0 ? clock.ns_per_cycle() : 1.0) {}
+
+    template<typename Pipeline>
+    PipelineRunResult run(Pipeline& pipeline, const LoadProfile& profile, size_t packets) const {
+        PipelineRunResult result;
+        result.profile = profile;
+        result.packets = packets;
+        if (packets == 0) return result;
+
+        const double cycles_per_ns = 1.0 / ns_per_cycle_;
+        StageStamps stamps;
+        double arrival_ns = 0.0;
+        double last_arrival_ns = 0.0;
+        uint64_t end = 0;
+
+        const uint64_t t0 = pipeline_cycles();
+        for (size_t i = 0; i < packets; ++i) {
+            const uint64_t intended = t0 + static_cast<uint64_t>(arrival_ns * cycles_per_ns);
+            uint64_t start = pipeline_cycles();
+            while (start < intended) {
+                pipeline_pause();
+                start = pipeline_cycles();
+            }
+
+            stamps.done.fill(start);
+            pipeline.process(i, static_cast<int64_t>(arrival_ns), stamps);
+            end = pipeline_cycles();
+
+            result.response_ns.record(to_ns(end - intended));
+            result.service_ns.record(to_ns(end - start));
+            uint64_t previous = start;
+            for (size_t s = 0; s < PIPELINE_STAGE_COUNT; ++s) {
+                const uint64_t done = std::max(stamps.done[s], previous);
+                result.stage_ns[s].record(to_ns(done - previous));
+                previous = done;
+            }
+
+            last_arrival_ns = arrival_ns;
+            arrival_ns = profile.next_arrival_ns(arrival_ns);
+        }
+
+        result.duration_s = static_cast<double>(to_ns(end - t0)) * 1e-9;
+        result.offered_pps = last_arrival_ns > 0.0 ?
+            static_cast<double>(packets - 1) * 1e9 / last_arrival_ns : 0.0;
+        result.achieved_pps = result.duration_s > 0.0 ?
+            static_cast<double>(packets) / result.duration_s : 0.0;
+        return result;
+    }
+
+    // Throughput vs latency: the same shape at each base rate
+    template<typename Pipeline>
+    std::vector<PipelineRunResult> sweep(Pipeline& pipeline, const LoadProfile& shape,
+                                         const std::vector<double>& rates, size_t packets_per_rate) const {
+        std::vector<PipelineRunResult> curve;
+        curve.reserve(rates.size());
+        for (double rate : rates) {
+            curve.push_back(run(pipeline, shape.at_rate(rate), packets_per_rate));
+        }
+        return curve;
+    }
+
+    double ns_per_cycle() const { return ns_per_cycle_; }
+
+private:
+    int64_t to_ns(uint64_t cycles) const {
+        return static_cast<int64_t>(static_cast<double>(cycles) * ns_per_cycle_);
+    }
+
+    double ns_per_cycle_;
+};
+
+// ====
+// Packet Streams
+// One market-data message per UDP frame, as the feed handler receives it
+// ====
+
+class PacketStream {
+public:
+    static constexpr size_t HEADER_BYTES = feed::ZeroCopyFeedHandler<OrderBookReconstructor>::UDP_PAYLOAD_OFFSET;
+
+    size_t size() const { return offsets_.size(); }
+    bool empty() const { return offsets_.empty(); }
+
+    uint8_t* frame(size_t i) { return data_.data() + offsets_[i]; }
+    size_t frame_length(size_t i) const { return lengths_[i]; }
+
+    zerocopy::BinaryMessageHeader* message(size_t i) {
+        return reinterpret_cast<zerocopy::BinaryMessageHeader*>(frame(i) + HEADER_BYTES);
+    }
+
+    template<typename Msg>
+    void append(const Msg& msg) {
+        offsets_.push_back(data_.size());
+        lengths_.push_back(HEADER_BYTES + sizeof(Msg));
+        data_.resize(data_.size() + HEADER_BYTES + sizeof(Msg), 0);
+        std::memcpy(data_.data() + offsets_.back() + HEADER_BYTES, &msg, sizeof(Msg));
+    }
+
+    // Order-by-order book traffic for one symbol: a sliding window of live
+    // orders (each add deletes the oldest once the window is full) around a
+    // drifting mid, with a trade every trade_every packets. Every order
+    // added is deleted again before the end, so the stream can be replayed
+    // back to back into the same book.
+    static PacketStream synthetic(size_t updates, uint32_t symbol_id = 1,
+                                  size_t live_orders = 200, size_t trade_every = 8) {
+        PacketStream stream;
+        double mid = 100.0;
+        uint64_t drift = 0x9E3779B97F4A7C15ull;
+
+        zerocopy::BinaryOrderBookUpdate add{};
+        add.header.message_type = static_cast<uint16_t>(zerocopy::MessageType::ORDER_BOOK_UPDATE);
+        add.header.message_length = sizeof(add);
+        add.symbol_id = symbol_id;
+        zerocopy::BinaryOrderBookUpdate del = add;
+        del.update_type = 2;
+
+        zerocopy::BinaryTradeMessage trade{};
+        trade.header.message_type = static_cast<uint16_t>(zerocopy::MessageType::TRADE);
+        trade.header.message_length = sizeof(trade);
+        trade.symbol_id = symbol_id;
+
+        std::vector<zerocopy::BinaryOrderBookUpdate> live(live_orders);
+        for (uint64_t k = 0; k < updates; ++k) {
+            drift = drift * 6364136223846793005ull + 1442695040888963407ull;
+            const int step = static_cast<int>((drift >> 33) % 3) - 1;
+            mid = std::max(1.0, mid + step * 0.01);
+
+            const size_t slot = k % live_orders;
+            if (k >= live_orders) {
+                del.order_id = live[slot].order_id;
+                del.side = live[slot].side;
+                del.price = live[slot].price;
+                stream.append(del);
+            }
+
+            add.order_id = k + 1;
+            add.side = static_cast<uint8_t>(k & 1);
+            const double offset = 0.01 * static_cast<double>(1 + (drift >> 40) % 10);
+            add.price = add.side == 0 ? mid - offset : mid + offset;
+            add.quantity = static_cast<double>(100 + (drift >> 48) % 900);
+            live[slot] = add;
+            stream.append(add);
+
+            if (trade_every > 0 && k % trade_every == 0) {
+                trade.trade_id = k;
+                trade.aggressor_side = static_cast<uint8_t>((drift >> 20) & 1);
+                trade.price = mid;
+                trade.quantity = 10.0;
+                stream.append(trade);
+            }
+        }
+        for (uint64_t k = (updates > live_orders ? updates - live_orders : 0); k < updates; ++k) {
+            const auto& order = live[k % live_orders];
+            del.order_id = order.order_id;
+            del.side = order.side;
+            del.price = order.price;
+            stream.append(del);
+        }
+        return stream;
+    }
+
+    // A recorded session from a tick store: quotes for BBO events, trades
+    // for events with volume (the backtester's convention)
+    static PacketStream from_tick_store(const std::string& path, uint32_t symbol_id = 1,
+                                        size_t max_events = 0) {
+        backtest::TickStoreReader reader(path);
+        PacketStream stream;
+
+        zerocopy::BinaryQuoteMessage quote{};
+        quote.header.message_type = static_cast<uint16_t>(zerocopy::MessageType::QUOTE);
+        quote.header.message_length = sizeof(quote);
+        quote.symbol_id = symbol_id;
+
+        zerocopy::BinaryTradeMessage trade{};
+        trade.header.message_type = static_cast<uint16_t>(zerocopy::MessageType::TRADE);
+        trade.header.message_length = sizeof(trade);
+        trade.symbol_id = symbol_id;
+
+        const size_t n = max_events > 0 ? std::min(max_events, reader.size()) : reader.size();
+        backtest::HistoricalEvent e;
+        for (size_t i = 0; i < n; ++i) {
+            reader.read(i, e);
+            if (e.trade_volume > 0) {
+                trade.trade_id = i;
+                trade.aggressor_side = e.trade_side == Side::BUY ? 0 : 1;
+                trade.price = e.trade_price;
+                trade.quantity = static_cast<double>(e.trade_volume);
+                stream.append(trade);
+            } else {
+                quote.bid_price = e.bid_price;
+                quote.bid_quantity = static_cast<double>(e.bid_size);
+                quote.ask_price = e.ask_price;
+                quote.ask_quantity = static_cast<double>(e.ask_size);
+                stream.append(quote);
+            }
+        }
+        return stream;
+    }
+
+private:
+    std::vector<uint8_t> data_;
+    std::vector<size_t> offsets_;
+    std::vector<size_t> lengths_;
+};
+
+// ====
+// Real Hot Path
+// The components and call sequence of the main trading loop, fed through
+// CustomNICDriver's loopback RX ring (BAR0 backed by a scratch file) and
+// ending in patched order templates. Packets are replayed cyclically with
+// fresh sequence numbers and timestamps, so the stream can be reused
+// across runs.
+// ====
+
+class TickToTradeHarness {
+public:
+    static constexpr uint32_t SYMBOL_ID = 1;
+
+    explicit TickToTradeHarness(PacketStream stream,
+                                const std::string& bar0_path = "/tmp/hft_t2t_bar0_" + std::to_string(::getpid()))
+        : stream_(std::move(stream)),
+          bar0_path_(bar0_path),
+          book_("BENCH"),
+          handler_(book_, SYMBOL_ID),
+          hawkes_(10.0, 10.0, 0.3, 0.1, 1e-3, 1.8, 1000),
+          inference_(/*pad_latency=*/false),
+          strategy_(0.1, 0.20, 300.0, 10.0, 0.01, 800),
+          risk_(1000, 10000.0, 100000.0),
+          templates_(1, 1, SYMBOL_ID + 1) {
+        if (stream_.empty()) {
+            throw std::invalid_argument("TickToTradeHarness: empty packet stream");
+        }
+
+        const int fd = ::open(bar0_path_.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+        if (fd < 0 || ::ftruncate(fd, 0x10000) != 0) {
+            if (fd >= 0) ::close(fd);
+            throw std::runtime_error("TickToTradeHarness: cannot create " + bar0_path_);
+        }
+        ::close(fd);
+        if (!nic_.initialize(bar0_path_.c_str())) {
+            ::unlink(bar0_path_.c_str());
+            throw std::runtime_error("TickToTradeHarness: NIC initialization failed");
+        }
+
+        templates_.initialize_symbol_templates(SYMBOL_ID, "BENCH");
+
+        handler_.set_trade_callback([this](const zerocopy::BinaryTradeMessage& t) {
+            trade_seen_ = true;
+            tick_.trade_volume = static_cast<uint64_t>(t.quantity);
+            tick_.trade_side = t.aggressor_side == 0 ? Side::BUY : Side::SELL;
+        });
+        handler_.set_quote_callback([this](const zerocopy::BinaryQuoteMessage& q) {
+            tick_.bid_price = q.bid_price;
+            tick_.ask_price = q.ask_price;
+            tick_.bid_size = static_cast<uint64_t>(q.bid_quantity);
+            tick_.ask_size = static_cast<uint64_t>(q.ask_quantity);
+            tick_.bid_prices[0] = q.bid_price;
+            tick_.ask_prices[0] = q.ask_price;
+            tick_.bid_sizes[0] = tick_.bid_size;
+            tick_.ask_sizes[0] = tick_.ask_size;
+            tick_.depth_levels = 1;
+            tick_.mid_price = (q.bid_price + q.ask_price) * 0.5;
+        });
+
+        reference_tick_.mid_price = 100.0;
+        reference_tick_.bid_price = 99.99;
+        reference_tick_.ask_price = 100.01;
+        base_ns_ = to_nanos(now());
+    }
+
+    ~TickToTradeHarness() { ::unlink(bar0_path_.c_str()); }
+
+    TickToTradeHarness(const TickToTradeHarness&) = delete;
+    TickToTradeHarness& operator=(const TickToTradeHarness&) = delete;
+
+    void process(size_t index, int64_t arrival_ns, StageStamps& stamps) {
+        const size_t i = index % stream_.size();
+        const int64_t timestamp_ns = base_ns_ + arrival_ns;
+
+        // Wire arrival: stamp the frame as the exchange would, DMA it into the ring
+        zerocopy::BinaryMessageHeader* header = stream_.message(i);
+        header->sequence_number = ++sequence_;
+        header->timestamp_ns = static_cast<uint64_t>(timestamp_ns);
+        nic_.loopback_rx(stream_.frame(i), stream_.frame_length(i));
+        hardware::RxPacket packet;
+        const size_t received = nic_.rx_burst(&packet, 1);
+        stamps.mark(STAGE_NIC_RX);
+        if (received == 0) return;
+
+        trade_seen_ = false;
+        const uint64_t book_updates = handler_.stats().book_updates;
+        handler_.on_frame(packet.data, packet.len);
+        if (handler_.stats().book_updates != book_updates) {
+            refresh_tick_from_book();
+        }
+        tick_.timestamp = Timestamp(std::chrono::nanoseconds(timestamp_ns));
+        if (!trade_seen_) tick_.trade_volume = 0;
+        stamps.mark(STAGE_DECODE_BOOK);
+
+        if (tick_.trade_volume > 0) {
+            hawkes_.update(TradingEvent(tick_.timestamp, tick_.trade_side, SYMBOL_ID));
+        }
+        const double buy_intensity = hawkes_.get_buy_intensity();
+        const double sell_intensity = hawkes_.get_sell_intensity();
+        stamps.mark(STAGE_HAWKES);
+
+        if (tick_.mid_price <= 0.0) return;   // No two-sided book yet
+
+        const auto features = inference_.extract_features(tick_, reference_tick_, buy_intensity, sell_intensity);
+        const auto prediction = inference_.predict(features);
+        signal_sink_ += prediction[0];
+        stamps.mark(STAGE_INFERENCE);
+
+        const double latency_cost = strategy_.calculate_latency_cost(VOLATILITY, tick_.mid_price);
+        const QuotePair quotes = strategy_.calculate_quotes(tick_.mid_price, position_, 300.0, latency_cost);
+        stamps.mark(STAGE_QUOTE);
+
+        if (quotes.bid_price <= 0.0 || quotes.ask_price <= 0.0) return;
+        const Order bid(next_order_id_, SYMBOL_ID, Side::BUY, quotes.bid_price,
+                        static_cast<uint64_t>(quotes.bid_size));
+        const Order ask(next_order_id_ + 1, SYMBOL_ID, Side::SELL, quotes.ask_price,
+                        static_cast<uint64_t>(quotes.ask_size));
+        const bool quote_ok = strategy_.should_quote(quotes.spread, latency_cost);
+        const bool bid_ok = quote_ok && risk_.check_pre_trade_limits(bid, position_);
+        const bool ask_ok = quote_ok && risk_.check_pre_trade_limits(ask, position_);
+        stamps.mark(STAGE_RISK);
+
+        if (bid_ok) {
+            orders_encoded_ += templates_.write_new_order(SYMBOL_ID, 0, next_order_id_, Side::BUY,
+                quotes.bid_price, quotes.bid_size, static_cast<uint64_t>(timestamp_ns), tx_buffer_) > 0;
+        }
+        if (ask_ok) {
+            orders_encoded_ += templates_.write_new_order(SYMBOL_ID, 0, next_order_id_ + 1, Side::SELL,
+                quotes.ask_price, quotes.ask_size, static_cast<uint64_t>(timestamp_ns),
+                tx_buffer_ + preserialized::MAX_ORDER_MESSAGE_SIZE) > 0;
+        }
+        next_order_id_ += 2;
+        stamps.mark(STAGE_ENCODE);
+    }
+
+    const feed::FeedHandlerStats& feed_stats() const { return handler_.stats(); }
+    uint64_t orders_encoded() const { return orders_encoded_; }
+    size_t stream_size() const { return stream_.size(); }
+
+private:
+    static constexpr double VOLATILITY = 0.20;
+
+    void refresh_tick_from_book() {
+        const DepthSnapshot depth = book_.get_depth_snapshot();
+        if (depth.bid_levels == 0 || depth.ask_levels == 0) return;
+
+        const size_t levels = std::min<size_t>({depth.bid_levels, depth.ask_levels, tick_.bid_prices.size()});
+        for (size_t l = 0; l < levels; ++l) {
+            tick_.bid_prices[l] = depth.bid_prices[l];
+            tick_.ask_prices[l] = depth.ask_prices[l];
+            tick_.bid_sizes[l] = static_cast<uint64_t>(depth.bid_quantities[l]);
+            tick_.ask_sizes[l] = static_cast<uint64_t>(depth.ask_quantities[l]);
+        }
+        tick_.depth_levels = static_cast<uint8_t>(levels);
+        tick_.bid_price = depth.bid_prices[0];
+        tick_.ask_price = depth.ask_prices[0];
+        tick_.bid_size = tick_.bid_sizes[0];
+        tick_.ask_size = tick_.ask_sizes[0];
+        tick_.mid_price = (tick_.bid_price + tick_.ask_price) * 0.5;
+    }
+
+    PacketStream stream_;
+    std::string bar0_path_;
+    hardware::CustomNICDriver nic_;
+    OrderBookReconstructor book_;
+    feed::ZeroCopyFeedHandler<OrderBookReconstructor> handler_;
+    HawkesIntensityEngine hawkes_;
+    FPGA_DNN_Inference inference_;
+    DynamicMMStrategy strategy_;
+    RiskControl risk_;
+    preserialized::OrderTemplatePool templates_;
+
+    MarketTick tick_;
+    MarketTick reference_tick_;
+    bool trade_seen_ = false;
+    int64_t position_ = 0;
+    int64_t base_ns_ = 0;
+    uint32_t sequence_ = 0;
+    uint64_t next_order_id_ = 1;
+    uint64_t orders_encoded_ = 0;
+    double signal_sink_ = 0.0;   // Keeps the prediction live
+    alignas(64) uint8_t tx_buffer_[2 * preserialized::MAX_ORDER_MESSAGE_SIZE] = {};
+};
+
+// ====
+// Reporting
+// ====
+
+inline void print_latency_curve(const std::vector<PipelineRunResult>& curve, std::ostream& out = std::cout) {
+    out << std::left << std::setw(12) << "shape"
+        << std::right << std::setw(12) << "offered/s" << std::setw(12) << "achieved/s"
+        << std::setw(11) << "svc p50" << std::setw(11) << "svc p99"
+        << std::setw(11) << "resp p50" << std::setw(11) << "resp p99"
+        << std::setw(12) << "resp p99.9" << std::setw(12) << "resp max" << "   (ns)\n";
+    out << std::string(104, '-') << "\n";
+    for (const auto& r : curve) {
+        out << std::left << std::setw(12) << r.profile.name() << std::right << std::fixed << std::setprecision(0)
+            << std::setw(12) << r.offered_pps << std::setw(12) << r.achieved_pps
+            << std::setw(11) << r.service_ns.value_at_percentile(50.0)
+            << std::setw(11) << r.service_ns.value_at_percentile(99.0)
+            << std::setw(11) << r.response_ns.value_at_percentile(50.0)
+            << std::setw(11) << r.response_ns.value_at_percentile(99.0)
+            << std::setw(12) << r.response_ns.value_at_percentile(99.9)
+            << std::setw(12) << r.response_ns.max() << "\n";
+    }
+}
+
+inline void print_stage_breakdown(const PipelineRunResult& r, std::ostream& out = std::cout) {
+    const double total_mean = r.service_ns.mean();
+    out << std::left << std::setw(16) << "stage" << std::right
+        << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10) << "p99"
+        << std::setw(10) << "p99.9" << std::setw(10) << "max" << std::setw(9) << "% svc" << "   (ns)\n";
+    out << std::string(75, '-') << "\n";
+    for (size_t s = 0; s < PIPELINE_STAGE_COUNT; ++s) {
+        const auto& h = r.stage_ns[s];
+        out << std::left << std::setw(16) << stage_name(s) << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << h.mean()
+            << std::setw(10) << h.value_at_percentile(50.0)
+            << std::setw(10) << h.value_at_percentile(99.0)
+            << std::setw(10) << h.value_at_percentile(99.9)
+            << std::setw(10) << h.max()
+            << std::setw(8) << (total_mean > 0.0 ? 100.0 * h.mean() / total_mean : 0.0) << "%\n";
+    }
+}
+
+// One row per run: offered vs achieved rate and the latency percentiles
+inline void export_latency_curve_csv(const std::string& path, const std::vector<PipelineRunResult>& curve) {
+    std::ofstream f(path);
+    f << "shape,base_rate_pps,offered_pps,achieved_pps,packets,"
+         "service_p50_ns,service_p99_ns,service_p999_ns,"
+         "response_p50_ns,response_p90_ns,response_p99_ns,response_p999_ns,response_p9999_ns,response_max_ns";
+    for (size_t s = 0; s < PIPELINE_STAGE_COUNT; ++s) f << ",stage" << s << "_p99_ns";
+    f << "\n";
+    for (const auto& r : curve) {
+        f << r.profile.name() << "," << r.profile.rate_pps << "," << r.offered_pps << "," << r.achieved_pps
+          << "," << r.packets << ","
+          << r.service_ns.value_at_percentile(50.0) << "," << r.service_ns.value_at_percentile(99.0) << ","
+          << r.service_ns.value_at_percentile(99.9) << ","
+          << r.response_ns.value_at_percentile(50.0) << "," << r.response_ns.value_at_percentile(90.0) << ","
+          << r.response_ns.value_at_percentile(99.0) << "," << r.response_ns.value_at_percentile(99.9) << ","
+          << r.response_ns.value_at_percentile(99.99) << "," << r.response_ns.max();
+        for (size_t s = 0; s < PIPELINE_STAGE_COUNT; ++s) f << "," << r.stage_ns[s].value_at_percentile(99.0);
+        f << "\n";
+    }
+}
+
+} // namespace benchmark
+} // namespace hft
@@ -1,14 +1,24 @@
 #pragma once
 
 #include "common_types.hpp"
+#include "instrument_directory.hpp"
 #include <cstring>
 #include <cstdint>
 #include <array>
 #include <atomic>
+#include <chrono>
+#include <string>
 
 namespace hft {
 namespace preserialized {
 
+// Wire message types
+enum OrderMessageType : uint16_t {
+    NEW_ORDER = 100,
+    CANCEL_ORDER = 101,
+    CANCEL_REPLACE = 102
+};
+
 #pragma pack(push, 1)
 
 // Binary order message header (FIX/SBE-like)
@@ -44,8 +54,25 @@ struct BinaryCancelOrderMessage {
     uint32_t padding;
 };
 
+// Cancel/replace: one message, so the venue swaps the order atomically
+// (no window where neither or both orders are live)
+struct BinaryCancelReplaceMessage {
+    OrderMessageHeader header;
+    uint64_t client_order_id;    // DYNAMIC - new order ID
+    uint64_t original_order_id;  // DYNAMIC - order being replaced
+    uint32_t symbol_id;          // Fixed per symbol
+    uint8_t side;                // DYNAMIC
+    uint8_t order_type;          // Fixed: LIMIT
+    uint8_t time_in_force;       // Fixed: GTC
+    uint8_t padding;
+    double price;                // DYNAMIC
+    double quantity;             // DYNAMIC
+};
+
 #pragma pack(pop)
 
+constexpr size_t MAX_ORDER_MESSAGE_SIZE = sizeof(BinaryCancelReplaceMessage);
+
 // Order Template: Pre-serialized buffer with patch points
 class OrderTemplate {
 public:
@@ -65,7 +92,7 @@ public:
         std::memset(&msg, 0, sizeof(msg));
         
         // Static header fields
-        msg.header.message_type = 100;  // NEW_ORDER
+        msg.header.message_type = NEW_ORDER;
         msg.header.message_length = sizeof(BinaryNewOrderMessage);
         msg.header.client_id = client_id;
         msg.header.session_id = session_id;
@@ -80,6 +107,36 @@ public:
         buffer_size_ = sizeof(msg);
     }
     
+    void initialize_cancel_template(uint32_t client_id, uint32_t session_id, uint32_t symbol_id) {
+        BinaryCancelOrderMessage msg;
+        std::memset(&msg, 0, sizeof(msg));
+        
+        msg.header.message_type = CANCEL_ORDER;
+        msg.header.message_length = sizeof(BinaryCancelOrderMessage);
+        msg.header.client_id = client_id;
+        msg.header.session_id = session_id;
+        msg.symbol_id = symbol_id;
+        
+        std::memcpy(buffer_.data(), &msg, sizeof(msg));
+        buffer_size_ = sizeof(msg);
+    }
+    
+    void initialize_cancel_replace_template(uint32_t client_id, uint32_t session_id, uint32_t symbol_id) {
+        BinaryCancelReplaceMessage msg;
+        std::memset(&msg, 0, sizeof(msg));
+        
+        msg.header.message_type = CANCEL_REPLACE;
+        msg.header.message_length = sizeof(BinaryCancelReplaceMessage);
+        msg.header.client_id = client_id;
+        msg.header.session_id = session_id;
+        msg.symbol_id = symbol_id;
+        msg.order_type = 1;  // LIMIT
+        msg.time_in_force = 0;  // GTC
+        
+        std::memcpy(buffer_.data(), &msg, sizeof(msg));
+        buffer_size_ = sizeof(msg);
+    }
+    
     // Fast path: Patch dynamic fields only (~20ns)
     // This is the hot path - called for every order
     inline void patch_and_send(
@@ -106,6 +163,42 @@ public:
         // msg->header.sequence_number = next_sequence_number();
     }
     
+    // Cancel template: copy + patch IDs
+    inline void patch_cancel(
+        uint64_t order_id,
+        uint64_t original_order_id,
+        uint64_t timestamp_ns,
+        void* output_buffer
+    ) const {
+        std::memcpy(output_buffer, buffer_.data(), buffer_size_);
+        
+        auto* msg = reinterpret_cast<BinaryCancelOrderMessage*>(output_buffer);
+        msg->header.client_timestamp = timestamp_ns;
+        msg->client_order_id = order_id;
+        msg->original_order_id = original_order_id;
+    }
+    
+    // Cancel/replace template: copy + patch IDs and the new price/size
+    inline void patch_cancel_replace(
+        uint64_t order_id,
+        uint64_t original_order_id,
+        Side side,
+        double price,
+        double quantity,
+        uint64_t timestamp_ns,
+        void* output_buffer
+    ) const {
+        std::memcpy(output_buffer, buffer_.data(), buffer_size_);
+        
+        auto* msg = reinterpret_cast<BinaryCancelReplaceMessage*>(output_buffer);
+        msg->header.client_timestamp = timestamp_ns;
+        msg->client_order_id = order_id;
+        msg->original_order_id = original_order_id;
+        msg->side = (side == Side::BUY) ? 0 : 1;
+        msg->price = price;
+        msg->quantity = quantity;
+    }
+    
     // Get buffer size
     size_t get_buffer_size() const { return buffer_size_; }
     
@@ -114,27 +207,104 @@ private:
     size_t buffer_size_;
 };
 
+// Order IDs owned by one strategy: strategy ID in the top 16 bits, a
+// strategy-local counter below. Every strategy numbers its own orders with
+// a plain increment, and any ID names the strategy that sent it.
+class OrderIdBlock {
+public:
+    static constexpr unsigned STRATEGY_SHIFT = 48;
+    
+    explicit OrderIdBlock(uint16_t strategy_id)
+        : next_((static_cast<uint64_t>(strategy_id) << STRATEGY_SHIFT) + 1) {}
+    
+    // Owning strategy thread only
+    uint64_t next() { return next_++; }
+    
+    static uint16_t strategy_of(uint64_t order_id) {
+        return static_cast<uint16_t>(order_id >> STRATEGY_SHIFT);
+    }
+    
+private:
+    uint64_t next_;
+};
+
 // Template Pool: Per-symbol, per-order-type templates
+// Flat array indexed by symbol ID (dense IDs from InstrumentDirectory), so
+// the send path is an array index instead of a hash lookup
 class OrderTemplatePool {
 public:
-    OrderTemplatePool(uint32_t client_id, uint32_t session_id)
-        : client_id_(client_id), session_id_(session_id), next_order_id_(1) {}
+    OrderTemplatePool(uint32_t client_id, uint32_t session_id, size_t max_symbols = 0)
+        : client_id_(client_id), session_id_(session_id), next_order_id_(1),
+          templates_(max_symbols) {}
     
-    // Initialize templates for a symbol
+    // Initialize templates for a symbol (startup; grows the table if needed)
     void initialize_symbol_templates(uint32_t symbol_id, const std::string& symbol_name) {
-        // Limit order templates (GTC, IOC, FOK)
-        auto& limit_gtc = limit_gtc_templates_[symbol_id];
-        limit_gtc.initialize_limit_order_template(client_id_, session_id_, symbol_id, 0);  // GTC
-        
-        auto& limit_ioc = limit_ioc_templates_[symbol_id];
-        limit_ioc.initialize_limit_order_template(client_id_, session_id_, symbol_id, 1);  // IOC
+        if (symbol_id >= templates_.size()) {
+            templates_.resize(symbol_id + 1);
+        }
         
-        auto& limit_fok = limit_fok_templates_[symbol_id];
-        limit_fok.initialize_limit_order_template(client_id_, session_id_, symbol_id, 2);  // FOK
+        // Limit order templates (GTC, IOC, FOK)
+        SymbolTemplates& t = templates_[symbol_id];
+        t.limit_gtc.initialize_limit_order_template(client_id_, session_id_, symbol_id, 0);  // GTC
+        t.limit_ioc.initialize_limit_order_template(client_id_, session_id_, symbol_id, 1);  // IOC
+        t.limit_fok.initialize_limit_order_template(client_id_, session_id_, symbol_id, 2);  // FOK
+        t.cancel.initialize_cancel_template(client_id_, session_id_, symbol_id);
+        t.cancel_replace.initialize_cancel_replace_template(client_id_, session_id_, symbol_id);
+    }
+    
+    bool has_symbol(uint32_t symbol_id) const {
+        return symbol_id < templates_.size() && templates_[symbol_id].cancel.get_buffer_size() != 0;
+    }
+    
+    // 
+    // Caller-supplied order IDs (no shared counter); used by OrderGateway.
+    // Each returns the bytes written, 0 for symbols without templates.
+    // time_in_force: 0=GTC, 1=IOC, 2=FOK
+    // 
+    inline size_t write_new_order(
+        uint32_t symbol_id, uint8_t time_in_force, uint64_t order_id,
+        Side side, double price, double quantity, uint64_t timestamp_ns,
+        void* output_buffer
+    ) const {
+        if (!has_symbol(symbol_id)) [[unlikely]] {
+            return 0;
+        }
+        const SymbolTemplates& t = templates_[symbol_id];
+        const OrderTemplate& tmpl = time_in_force == 1 ? t.limit_ioc
+                                  : time_in_force == 2 ? t.limit_fok : t.limit_gtc;
+        tmpl.patch_and_send(order_id, side, price, quantity, timestamp_ns, output_buffer);
+        return tmpl.get_buffer_size();
+    }
+    
+    inline size_t write_cancel(
+        uint32_t symbol_id, uint64_t order_id, uint64_t original_order_id,
+        uint64_t timestamp_ns, void* output_buffer
+    ) const {
+        if (!has_symbol(symbol_id)) [[unlikely]] {
+            return 0;
+        }
+        const OrderTemplate& tmpl = templates_[symbol_id].cancel;
+        tmpl.patch_cancel(order_id, original_order_id, timestamp_ns, output_buffer);
+        return tmpl.get_buffer_size();
+    }
+    
+    inline size_t write_cancel_replace(
+        uint32_t symbol_id, uint64_t order_id, uint64_t original_order_id,
+        Side side, double price, double quantity, uint64_t timestamp_ns,
+        void* output_buffer
+    ) const {
+        if (!has_symbol(symbol_id)) [[unlikely]] {
+            return 0;
+        }
+        const OrderTemplate& tmpl = templates_[symbol_id].cancel_replace;
+        tmpl.patch_cancel_replace(order_id, original_order_id, side, price, quantity,
+                                  timestamp_ns, output_buffer);
+        return tmpl.get_buffer_size();
     }
     
     // Submit limit order with pre-serialized template (FAST PATH)
     // Total latency: ~30ns (template patch 20ns + allocation 10ns)
+    // Returns 0 for symbols without templates
     inline size_t submit_limit_order_gtc(
         uint32_t symbol_id,
         Side side,
@@ -142,13 +312,7 @@ public:
         double quantity,
         void* output_buffer
     ) {
-        uint64_t order_id = next_order_id_.fetch_add(1, std::memory_order_relaxed);
-        uint64_t timestamp_ns = std::chrono::steady_clock::now().time_since_epoch().count();
-        
-        const auto& tmpl = limit_gtc_templates_[symbol_id];
-        tmpl.patch_and_send(order_id, side, price, quantity, timestamp_ns, output_buffer);
-        
-        return tmpl.get_buffer_size();
+        return submit(&SymbolTemplates::limit_gtc, symbol_id, side, price, quantity, output_buffer);
     }
     
     inline size_t submit_limit_order_ioc(
@@ -158,13 +322,17 @@ public:
         double quantity,
         void* output_buffer
     ) {
-        uint64_t order_id = next_order_id_.fetch_add(1, std::memory_order_relaxed);
-        uint64_t timestamp_ns = std::chrono::steady_clock::now().time_since_epoch().count();
-        
-        const auto& tmpl = limit_ioc_templates_[symbol_id];
-        tmpl.patch_and_send(order_id, side, price, quantity, timestamp_ns, output_buffer);
-        
-        return tmpl.get_buffer_size();
+        return submit(&SymbolTemplates::limit_ioc, symbol_id, side, price, quantity, output_buffer);
+    }
+    
+    inline size_t submit_limit_order_fok(
+        uint32_t symbol_id,
+        Side side,
+        double price,
+        double quantity,
+        void* output_buffer
+    ) {
+        return submit(&SymbolTemplates::limit_fok, symbol_id, side, price, quantity, output_buffer);
     }
     
     // Cancel order (also uses pre-serialized template)
@@ -174,16 +342,21 @@ public:
         void* output_buffer
     ) {
         uint64_t cancel_order_id = next_order_id_.fetch_add(1, std::memory_order_relaxed);
+        uint64_t timestamp_ns = std::chrono::steady_clock::now().time_since_epoch().count();
+        
+        if (has_symbol(symbol_id)) [[likely]] {
+            return write_cancel(symbol_id, cancel_order_id, original_order_id, timestamp_ns, output_buffer);
+        }
         
-        // Pre-serialized cancel template
+        // Symbol without templates: build the message in place
         BinaryCancelOrderMessage msg;
         std::memset(&msg, 0, sizeof(msg));
         
-        msg.header.message_type = 101;  // CANCEL_ORDER
+        msg.header.message_type = CANCEL_ORDER;
         msg.header.message_length = sizeof(BinaryCancelOrderMessage);
         msg.header.client_id = client_id_;
         msg.header.session_id = session_id_;
-        msg.header.client_timestamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        msg.header.client_timestamp = timestamp_ns;
         
         msg.client_order_id = cancel_order_id;
         msg.original_order_id = original_order_id;
@@ -198,10 +371,36 @@ private:
     uint32_t session_id_;
     std::atomic<uint64_t> next_order_id_;
     
-    // Template storage per symbol
-    std::unordered_map<uint32_t, OrderTemplate> limit_gtc_templates_;
-    std::unordered_map<uint32_t, OrderTemplate> limit_ioc_templates_;
-    std::unordered_map<uint32_t, OrderTemplate> limit_fok_templates_;
+    // Template storage per symbol (all order types for a symbol are adjacent)
+    struct SymbolTemplates {
+        OrderTemplate limit_gtc;
+        OrderTemplate limit_ioc;
+        OrderTemplate limit_fok;
+        OrderTemplate cancel;
+        OrderTemplate cancel_replace;
+    };
+    PerIdArray<SymbolTemplates> templates_;
+    
+    inline size_t submit(
+        OrderTemplate SymbolTemplates::*kind,
+        uint32_t symbol_id,
+        Side side,
+        double price,
+        double quantity,
+        void* output_buffer
+    ) {
+        if (symbol_id >= templates_.size()) [[unlikely]] {
+            return 0;
+        }
+        
+        uint64_t order_id = next_order_id_.fetch_add(1, std::memory_order_relaxed);
+        uint64_t timestamp_ns = std::chrono::steady_clock::now().time_since_epoch().count();
+        
+        const OrderTemplate& tmpl = templates_[symbol_id].*kind;
+        tmpl.patch_and_send(order_id, side, price, quantity, timestamp_ns, output_buffer);
+        
+        return tmpl.get_buffer_size();
+    }
 };
 
 // ====
@@ -209,8 +408,8 @@ private:
 // Combines template patching with lock-free queue insertion
 class FastOrderSubmitter {
 public:
-    FastOrderSubmitter(uint32_t client_id, uint32_t session_id)
-        : template_pool_(client_id, session_id) {}
+    FastOrderSubmitter(uint32_t client_id, uint32_t session_id, size_t max_symbols = 0)
+        : template_pool_(client_id, session_id, max_symbols) {}
     
     void initialize_symbol(uint32_t symbol_id, const std::string& symbol_name) {
         template_pool_.initialize_symbol_templates(symbol_id, symbol_name);
@@ -1,10 +1,14 @@
 #pragma once
 
+#include "binary_journal.hpp"
 #include <fstream>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <cstdint>
 #include <chrono>
 #include <iomanip>
+#include <vector>
 
 // ====
 // PRODUCTION LOGGING SYSTEM - INSTITUTIONAL GRADE
@@ -15,89 +19,121 @@
 
 namespace hft {
 
+// Every sink below logs either as text on the calling thread (filename
+// constructor) or as binary records into a shared BinaryJournal, decoded
+// to the same text offline (journal_decoder.hpp). String arguments are
+// stored inline in the record: venues up to 32 chars, reasons up to 32.
+
 // ====
 // Layer 1: NIC Hardware Timestamps (Physical Reality)
 // ====
-class NICHardwareLog {
+class NICHardwareLog : public JournaledLog<NICHardwareLog> {
 public:
-    explicit NICHardwareLog(const std::string& filename) {
-        file_.open(filename);
-        write_header();
+    enum Event : uint16_t { RX_PKT = 1, TX_PKT };
+
+    explicit NICHardwareLog(const std::string& filename) : JournaledLog(filename) {
+        emit_text(header());
     }
-    
-    ~NICHardwareLog() {
-        if (file_.is_open()) {
-            file_.close();
-        }
+
+    NICHardwareLog(const std::string& filename, BinaryJournal& journal)
+        : JournaledLog(filename, journal, JournalSourceKind::NIC_HARDWARE) {
+        emit_text(header());
     }
     
-    void log_rx_packet(uint64_t seq, const std::string& venue, uint64_t ts_hw_ns) {
-        file_ << "RX_PKT seq=" << seq 
-              << " venue=" << venue 
-              << " ts_hw_ns=" << ts_hw_ns << "\n";
+    void log_rx_packet(uint64_t seq, std::string_view venue, uint64_t ts_hw_ns) {
+        emit(packet(RX_PKT, seq, venue, ts_hw_ns));
     }
     
-    void log_tx_packet(uint64_t seq, const std::string& venue, uint64_t ts_hw_ns) {
-        file_ << "TX_PKT seq=" << seq 
-              << " venue=" << venue 
-              << " ts_hw_ns=" << ts_hw_ns << "\n";
+    void log_tx_packet(uint64_t seq, std::string_view venue, uint64_t ts_hw_ns) {
+        emit(packet(TX_PKT, seq, venue, ts_hw_ns));
+    }
+
+    static void format_record(std::ostream& out, const JournalRecord& r) {
+        out << (r.event == RX_PKT ? "RX_PKT" : "TX_PKT") << " seq=" << r.get<uint64_t>(0)
+            << " venue=" << r.text(2, 4)
+            << " ts_hw_ns=" << r.get<uint64_t>(1) << "\n";
     }
     
 private:
-    std::ofstream file_;
-    
-    void write_header() {
-        file_ << "# nic_rx_tx_hw_ts.log\n";
-        file_ << "# device=Solarflare_X2522\n";
-        file_ << "# ts_source=HW_NIC\n";
-        file_ << "# clock=PTP_GM_UTC\n";
-        file_ << "# ptp_offset_ns=+17\n";
-        file_ << "# freq_drift_ppb=+0.3\n";
-        file_ << "\n";
+    static JournalRecord packet(Event event, uint64_t seq, std::string_view venue, uint64_t ts_hw_ns) {
+        JournalRecord r(event, static_cast<int64_t>(ts_hw_ns));
+        r.set(0, seq);
+        r.set(1, ts_hw_ns);
+        r.set_text(2, 4, venue);
+        return r;
+    }
+
+    static std::string header() {
+        return "# nic_rx_tx_hw_ts.log\n"
+               "# device=Solarflare_X2522\n"
+               "# ts_source=HW_NIC\n"
+               "# clock=PTP_GM_UTC\n"
+               "# ptp_offset_ns=+17\n"
+               "# freq_drift_ppb=+0.3\n"
+               "\n";
     }
 };
 
 // ====
 // Layer 2: Strategy Decision Trace (User-Space Events)
 // ====
-class StrategyTraceLog {
+class StrategyTraceLog : public JournaledLog<StrategyTraceLog> {
 public:
-    explicit StrategyTraceLog(const std::string& filename) {
-        file_.open(filename);
-        write_header();
+    enum Event : uint16_t { EVENT_RX = 1, EVENT_DECISION, EVENT_SEND };
+
+    explicit StrategyTraceLog(const std::string& filename) : JournaledLog(filename) {
+        emit_text(header());
     }
-    
-    ~StrategyTraceLog() {
-        if (file_.is_open()) {
-            file_.close();
-        }
+
+    StrategyTraceLog(const std::string& filename, BinaryJournal& journal)
+        : JournaledLog(filename, journal, JournalSourceKind::STRATEGY_TRACE) {
+        emit_text(header());
     }
     
     void log_event_rx(uint64_t seq, uint64_t tsc) {
-        file_ << "EVENT RX seq=" << seq << " tsc=" << tsc << "\n";
+        JournalRecord r(EVENT_RX, static_cast<int64_t>(tsc));
+        r.set(0, seq);
+        emit(r);
     }
     
-    void log_event_decision(const std::string& side, uint64_t tsc) {
-        file_ << "EVENT DECISION side=" << side << " tsc=" << tsc << "\n";
+    void log_event_decision(std::string_view side, uint64_t tsc) {
+        JournalRecord r(EVENT_DECISION, static_cast<int64_t>(tsc));
+        r.set_text(0, 2, side);
+        emit(r);
     }
     
     void log_event_send(uint64_t seq, uint64_t tsc) {
-        file_ << "EVENT SEND seq=" << seq << " tsc=" << tsc << "\n";
+        JournalRecord r(EVENT_SEND, static_cast<int64_t>(tsc));
+        r.set(0, seq);
+        emit(r);
+    }
+
+    static void format_record(std::ostream& out, const JournalRecord& r) {
+        const auto tsc = static_cast<uint64_t>(r.timestamp);
+        switch (r.event) {
+            case EVENT_RX:
+                out << "EVENT RX seq=" << r.get<uint64_t>(0) << " tsc=" << tsc << "\n";
+                break;
+            case EVENT_DECISION:
+                out << "EVENT DECISION side=" << r.text(0, 2) << " tsc=" << tsc << "\n";
+                break;
+            case EVENT_SEND:
+                out << "EVENT SEND seq=" << r.get<uint64_t>(0) << " tsc=" << tsc << "\n";
+                break;
+        }
     }
     
 private:
-    std::ofstream file_;
-    
-    void write_header() {
-        file_ << "# strategy_trace.log\n";
-        file_ << "# build=commit_" << get_git_commit() << "\n";
-        file_ << "# compiler=gcc-13.2 -O3 -march=native\n";
-        file_ << "# cpu=isolated_core=6\n";
-        file_ << "# invariant_tsc=true\n";
-        file_ << "\n";
+    static std::string header() {
+        return "# strategy_trace.log\n"
+               "# build=commit_" + get_git_commit() + "\n"
+               "# compiler=gcc-13.2 -O3 -march=native\n"
+               "# cpu=isolated_core=6\n"
+               "# invariant_tsc=true\n"
+               "\n";
     }
     
-    std::string get_git_commit() {
+    static std::string get_git_commit() {
         // In production, this would read from build metadata
         return "91ac3f2";
     }
@@ -106,129 +142,175 @@ private:
 // ====
 // Layer 3: Exchange ACK Log (External Reality)
 // ====
-class ExchangeACKLog {
+class ExchangeACKLog : public JournaledLog<ExchangeACKLog> {
 public:
-    explicit ExchangeACKLog(const std::string& filename) {
-        file_.open(filename);
-        write_header();
+    enum Event : uint16_t { ACK = 1, FILL, REJECT };
+
+    explicit ExchangeACKLog(const std::string& filename) : JournaledLog(filename) {
+        emit_text(header());
     }
-    
-    ~ExchangeACKLog() {
-        if (file_.is_open()) {
-            file_.close();
-        }
+
+    ExchangeACKLog(const std::string& filename, BinaryJournal& journal)
+        : JournaledLog(filename, journal, JournalSourceKind::EXCHANGE_ACK) {
+        emit_text(header());
     }
     
     void log_ack(uint64_t order_id, uint64_t exch_ts_ns) {
-        file_ << "ACK order_id=" << order_id 
-              << " exch_ts_ns=" << exch_ts_ns << "\n";
+        JournalRecord r(ACK, static_cast<int64_t>(exch_ts_ns));
+        r.set(0, order_id);
+        emit(r);
     }
     
     void log_fill(uint64_t order_id, uint64_t qty, double price, uint64_t exch_ts_ns) {
-        file_ << "FILL order_id=" << order_id 
-              << " qty=" << qty 
-              << " price=" << std::fixed << std::setprecision(4) << price
-              << " exch_ts_ns=" << exch_ts_ns << "\n";
+        JournalRecord r(FILL, static_cast<int64_t>(exch_ts_ns));
+        r.set(0, order_id);
+        r.set(1, qty);
+        r.set(2, price);
+        emit(r);
     }
     
-    void log_reject(uint64_t order_id, const std::string& reason, uint64_t exch_ts_ns) {
-        file_ << "REJECT order_id=" << order_id 
-              << " reason=" << reason 
-              << " exch_ts_ns=" << exch_ts_ns << "\n";
+    void log_reject(uint64_t order_id, std::string_view reason, uint64_t exch_ts_ns) {
+        JournalRecord r(REJECT, static_cast<int64_t>(exch_ts_ns));
+        r.set(0, order_id);
+        r.set_text(1, 4, reason);
+        emit(r);
+    }
+
+    static void format_record(std::ostream& out, const JournalRecord& r) {
+        const auto exch_ts_ns = static_cast<uint64_t>(r.timestamp);
+        switch (r.event) {
+            case ACK:
+                out << "ACK order_id=" << r.get<uint64_t>(0)
+                    << " exch_ts_ns=" << exch_ts_ns << "\n";
+                break;
+            case FILL:
+                out << "FILL order_id=" << r.get<uint64_t>(0)
+                    << " qty=" << r.get<uint64_t>(1)
+                    << " price=" << std::fixed << std::setprecision(4) << r.get<double>(2)
+                    << " exch_ts_ns=" << exch_ts_ns << "\n";
+                break;
+            case REJECT:
+                out << "REJECT order_id=" << r.get<uint64_t>(0)
+                    << " reason=" << r.text(1, 4)
+                    << " exch_ts_ns=" << exch_ts_ns << "\n";
+                break;
+        }
     }
     
 private:
-    std::ofstream file_;
-    
-    void write_header() {
-        file_ << "# exchange_ack.log\n";
-        file_ << "# source=exchange_mcast\n";
-        file_ << "# venue=NSE_EQ\n";
-        file_ << "\n";
+    static std::string header() {
+        return "# exchange_ack.log\n"
+               "# source=exchange_mcast\n"
+               "# venue=NSE_EQ\n"
+               "\n";
     }
 };
 
 // ====
 // Layer 4: PTP Clock Sync Log (Time Alignment Proof)
 // ====
-class PTPSyncLog {
+class PTPSyncLog : public JournaledLog<PTPSyncLog> {
 public:
-    explicit PTPSyncLog(const std::string& filename) {
-        file_.open(filename);
-        write_header();
+    enum Event : uint16_t { SYNC = 1 };
+
+    explicit PTPSyncLog(const std::string& filename) : JournaledLog(filename) {
+        emit_text(header());
     }
-    
-    ~PTPSyncLog() {
-        if (file_.is_open()) {
-            file_.close();
-        }
+
+    PTPSyncLog(const std::string& filename, BinaryJournal& journal)
+        : JournaledLog(filename, journal, JournalSourceKind::PTP_SYNC) {
+        emit_text(header());
     }
     
     void log_sync(uint64_t local_ts_ns, int64_t offset_ns, double drift_ppb) {
-        file_ << "SYNC local_ts=" << local_ts_ns 
-              << " offset_ns=" << (offset_ns >= 0 ? "+" : "") << offset_ns
-              << " drift_ppb=" << std::fixed << std::setprecision(1) 
-              << (drift_ppb >= 0 ? "+" : "") << drift_ppb << "\n";
+        JournalRecord r(SYNC, static_cast<int64_t>(local_ts_ns));
+        r.set(0, offset_ns);
+        r.set(1, drift_ppb);
+        emit(r);
     }
     
+    // Rare: formatted on the calling thread
     void log_gm_change(const std::string& old_gm, const std::string& new_gm, uint64_t ts_ns) {
-        file_ << "GM_CHANGE old=" << old_gm 
-              << " new=" << new_gm 
-              << " ts=" << ts_ns << "\n";
+        std::ostringstream line;
+        line << "GM_CHANGE old=" << old_gm 
+             << " new=" << new_gm 
+             << " ts=" << ts_ns << "\n";
+        emit_text(line.str());
+    }
+
+    static void format_record(std::ostream& out, const JournalRecord& r) {
+        const auto offset_ns = r.get<int64_t>(0);
+        const auto drift_ppb = r.get<double>(1);
+        out << "SYNC local_ts=" << static_cast<uint64_t>(r.timestamp)
+            << " offset_ns=" << (offset_ns >= 0 ? "+" : "") << offset_ns
+            << " drift_ppb=" << std::fixed << std::setprecision(1) 
+            << (drift_ppb >= 0 ? "+" : "") << drift_ppb << "\n";
     }
     
 private:
-    std::ofstream file_;
-    
-    void write_header() {
-        file_ << "# ptp_sync.log\n";
-        file_ << "# grandmaster=192.168.1.1\n";
-        file_ << "# domain=0\n";
-        file_ << "# priority1=128\n";
-        file_ << "# sync_interval_ms=125\n";
-        file_ << "\n";
+    static std::string header() {
+        return "# ptp_sync.log\n"
+               "# grandmaster=192.168.1.1\n"
+               "# domain=0\n"
+               "# priority1=128\n"
+               "# sync_interval_ms=125\n"
+               "\n";
     }
 };
 
 // ====
 // Layer 5: Order Gateway Log (Internal → External Boundary)
 // ====
-class OrderGatewayLog {
+class OrderGatewayLog : public JournaledLog<OrderGatewayLog> {
 public:
-    explicit OrderGatewayLog(const std::string& filename) {
-        file_.open(filename);
-        write_header();
+    enum Event : uint16_t { SUBMIT = 1, CANCEL };
+
+    explicit OrderGatewayLog(const std::string& filename) : JournaledLog(filename) {
+        emit_text(header());
     }
-    
-    ~OrderGatewayLog() {
-        if (file_.is_open()) {
-            file_.close();
-        }
+
+    OrderGatewayLog(const std::string& filename, BinaryJournal& journal)
+        : JournaledLog(filename, journal, JournalSourceKind::ORDER_GATEWAY) {
+        emit_text(header());
     }
     
-    void log_submit(uint64_t order_id, const std::string& side, double price, 
+    void log_submit(uint64_t order_id, std::string_view side, double price, 
                     uint64_t qty, uint64_t tsc) {
-        file_ << "SUBMIT order_id=" << order_id 
-              << " side=" << side 
-              << " price=" << std::fixed << std::setprecision(4) << price
-              << " qty=" << qty 
-              << " tsc=" << tsc << "\n";
+        JournalRecord r(SUBMIT, static_cast<int64_t>(tsc));
+        r.set(0, order_id);
+        r.set_text(1, 1, side);
+        r.set(2, price);
+        r.set(3, qty);
+        emit(r);
     }
     
     void log_cancel(uint64_t order_id, uint64_t tsc) {
-        file_ << "CANCEL order_id=" << order_id 
-              << " tsc=" << tsc << "\n";
+        JournalRecord r(CANCEL, static_cast<int64_t>(tsc));
+        r.set(0, order_id);
+        emit(r);
+    }
+
+    static void format_record(std::ostream& out, const JournalRecord& r) {
+        const auto tsc = static_cast<uint64_t>(r.timestamp);
+        if (r.event == SUBMIT) {
+            out << "SUBMIT order_id=" << r.get<uint64_t>(0) 
+                << " side=" << r.text(1, 1) 
+                << " price=" << std::fixed << std::setprecision(4) << r.get<double>(2)
+                << " qty=" << r.get<uint64_t>(3) 
+                << " tsc=" << tsc << "\n";
+        } else if (r.event == CANCEL) {
+            out << "CANCEL order_id=" << r.get<uint64_t>(0) 
+                << " tsc=" << tsc << "\n";
+        }
     }
     
 private:
-    std::ofstream file_;
-    
-    void write_header() {
-        file_ << "# order_gateway.log\n";
-        file_ << "# venue=NSE_EQ\n";
-        file_ << "# protocol=CTCL_v2.1\n";
-        file_ << "# session=TRADE_2025121500001\n";
-        file_ << "\n";
+    static std::string header() {
+        return "# order_gateway.log\n"
+               "# venue=NSE_EQ\n"
+               "# protocol=CTCL_v2.1\n"
+               "# session=TRADE_2025121500001\n"
+               "\n";
     }
 };
 
@@ -283,6 +365,15 @@ public:
           exchange_log_("logs/exchange_ack_" + run_id + ".log"),
           ptp_log_("logs/ptp_sync_" + run_id + ".log"),
           gateway_log_("logs/order_gateway_" + run_id + ".log") {}
+
+    // All five layers journaled into one BinaryJournal (outlives the bundle)
+    ProductionLogBundle(const std::string& run_id, BinaryJournal& journal)
+        : run_id_(run_id),
+          nic_log_("logs/nic_rx_tx_hw_ts_" + run_id + ".log", journal),
+          strategy_log_("logs/strategy_trace_" + run_id + ".log", journal),
+          exchange_log_("logs/exchange_ack_" + run_id + ".log", journal),
+          ptp_log_("logs/ptp_sync_" + run_id + ".log", journal),
+          gateway_log_("logs/order_gateway_" + run_id + ".log", journal) {}
     
     NICHardwareLog& nic() { return nic_log_; }
     StrategyTraceLog& strategy() { return strategy_log_; }
@@ -0,0 +1,473 @@
+#pragma once
+
+#include "common_types.hpp"
+#include "engine_checkpoint.hpp"
+#include "order_book_reconstructor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace hft {
+namespace backtest {
+
+// ====
+// Queue-Position Fill Simulator
+// Our resting orders sit in per-level FIFOs (FlatBookBackend, the storage
+// behind FlatOrderBookReconstructor) between blocks of displayed market
+// volume, e.g. [market 500][ours 100][market 200]. Trades consume a level
+// from the front, so an order fills only once everything queued ahead of it
+// has traded. A displayed-size drop with no trade is a cancel, taken pro
+// rata from the market blocks; growth joins the back. Each market update
+// touches only the levels that hold our orders.
+// ====
+
+template<size_t MaxTicks = 4096, size_t MaxOrders = (size_t(1) << 14)>
+class BasicQueueFillSimulator {
+public:
+    // Passed to on_fill for each of our executions
+    struct Fill {
+        uint64_t order_id;
+        uint64_t quantity;
+        uint64_t remaining;     // 0 when the order is done
+    };
+
+    // The book window spans MaxTicks ticks around reference_price; 0 centres
+    // it on the first market update (or first order)
+    explicit BasicQueueFillSimulator(double tick_size = 0.01, double reference_price = 0.0)
+        : tick_size_(tick_size),
+          book_(tick_size, reference_price),
+          anchored_(reference_price > 0.0) {
+        scratch_.reserve(64);
+        cuts_.reserve(64);
+    }
+
+    void clear() {
+        book_.clear();
+        ours_.clear();
+        levels_.clear();
+        has_market_ = false;
+    }
+
+    // Join the back of the queue at `price`, behind the displayed size last
+    // seen there. False if the price is outside the book window or the
+    // order pool is full.
+    bool add_order(uint64_t order_id, Side side, double price, uint64_t quantity, int64_t timestamp_ns) {
+        anchor(price);
+        const bool is_bid = (side == Side::BUY);
+        const int32_t tick = book_.price_to_tick(price);
+        if (quantity == 0 || (order_id & MARKET_BIT) || ours_.count(order_id)) {
+            return false;
+        }
+
+        Level* level = find_level(is_bid, tick);
+        if (!level) {
+            uint64_t displayed = 0;
+            if (has_market_ && displayed_at(is_bid, tick, last_market_, displayed) && displayed > 0) {
+                if (!book_.add(make_update(next_block_++ | MARKET_BIT, tick, static_cast<double>(displayed),
+                                           is_bid, timestamp_ns))) {
+                    return false;
+                }
+            }
+            levels_.push_back(Level{is_bid, tick, 0, displayed});
+            level = &levels_.back();
+        }
+
+        if (!book_.add(make_update(order_id, tick, static_cast<double>(quantity), is_bid, timestamp_ns))) {
+            if (level->ours == 0) {
+                drop_level(*level);
+            }
+            return false;
+        }
+        ++level->ours;
+        ours_.emplace(order_id, Resting{is_bid, tick, quantity});
+        return true;
+    }
+
+    bool cancel_order(uint64_t order_id) {
+        auto it = ours_.find(order_id);
+        if (it == ours_.end()) {
+            return false;
+        }
+        const Resting r = it->second;
+        ours_.erase(it);
+        OrderBookUpdate u;
+        u.order_id = order_id;
+        book_.remove(u);
+        release(r.is_bid, r.tick);
+        return true;
+    }
+
+    // Apply one market update. trade_price <= 0 means the trade printed at
+    // the touch the aggressor hit. on_fill(const Fill&) runs for each of
+    // our executions.
+    template<typename OnFill>
+    void on_market(const MarketTick& tick, double trade_price, int64_t timestamp_ns, OnFill&& on_fill) {
+        anchor(tick.mid_price);
+        if (!levels_.empty()) {
+            fill_crossed(tick, timestamp_ns, on_fill);
+
+            if (tick.trade_volume > 0) {
+                const bool hits_bids = (tick.trade_side == Side::SELL);
+                const MarketTick& before = has_market_ ? last_market_ : tick;
+                const double px = trade_price > 0.0 ? trade_price
+                                                    : (hits_bids ? before.bid_price : before.ask_price);
+                trade_through(hits_bids, book_.price_to_tick(px),
+                              static_cast<double>(tick.trade_volume), timestamp_ns, on_fill);
+            }
+
+            for (size_t i = 0; i < levels_.size(); ++i) {
+                uint64_t displayed;
+                if (displayed_at(levels_[i].is_bid, levels_[i].tick, tick, displayed)
+                    && displayed != levels_[i].displayed) {
+                    sync_level(levels_[i], displayed, timestamp_ns);
+                }
+            }
+        }
+
+        last_market_ = tick;
+        has_market_ = true;
+    }
+
+    // Market and own volume queued ahead of an order; -1 if not resting
+    double queue_ahead(uint64_t order_id) const {
+        auto it = ours_.find(order_id);
+        if (it == ours_.end()) {
+            return -1.0;
+        }
+        double ahead = 0.0;
+        bool found = false;
+        book_.for_each_order_at(it->second.is_bid, book_.tick_to_price(it->second.tick),
+            [&](uint64_t id, double qty) {
+                if (id == order_id) found = true;
+                if (!found) ahead += qty;
+            });
+        return ahead;
+    }
+
+    bool is_resting(uint64_t order_id) const { return ours_.count(order_id) != 0; }
+    size_t resting_orders() const { return ours_.size(); }
+    size_t active_levels() const { return levels_.size(); }
+
+    // Book as of the last on_market()
+    const MarketTick& last_market() const { return last_market_; }
+    bool has_market() const { return has_market_; }
+
+    // Only the levels holding our orders live in the book, so the state is
+    // each such level's FIFO (market blocks and ours, front to back) plus
+    // the book placement and last market update
+    void save_state(checkpoint::StateWriter& out) const {
+        out.put(anchored_);
+        out.put(anchored_ ? book_.base_price() : 0.0);
+        out.put(has_market_);
+        out.put(last_market_);
+        out.put(next_block_);
+        out.put_vector(levels_);
+
+        std::vector<SavedResting> ours;
+        ours.reserve(ours_.size());
+        for (const auto& o : ours_) ours.push_back(SavedResting{o.first, o.second});
+        std::sort(ours.begin(), ours.end(),
+                  [](const SavedResting& a, const SavedResting& b) { return a.order_id < b.order_id; });
+        out.put_vector(ours);
+
+        std::vector<SavedEntry> fifo;
+        for (const auto& level : levels_) {
+            fifo.clear();
+            book_.for_each_order_at(level.is_bid, book_.tick_to_price(level.tick),
+                [&](uint64_t id, double qty) { fifo.push_back(SavedEntry{id, qty}); });
+            out.put_vector(fifo);
+        }
+    }
+
+    // Replaces the current state; the tick size must match the saved one
+    void restore_state(checkpoint::StateReader& in) {
+        clear();
+        in.get(anchored_);
+        const double base = in.get<double>();
+        if (anchored_) book_.rebase(base);
+        in.get(has_market_);
+        in.get(last_market_);
+        in.get(next_block_);
+        in.get_vector(levels_);
+
+        std::vector<SavedResting> ours;
+        in.get_vector(ours);
+        for (const auto& o : ours) ours_.emplace(o.order_id, o.resting);
+
+        std::vector<SavedEntry> fifo;
+        for (const auto& level : levels_) {
+            in.get_vector(fifo);
+            for (const auto& e : fifo) {
+                if (!book_.add(make_update(e.id, level.tick, e.quantity, level.is_bid, 0))) {
+                    throw std::runtime_error("Checkpoint queue state does not fit the book window");
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr uint64_t MARKET_BIT = uint64_t(1) << 62;
+
+    struct Resting {
+        bool is_bid;
+        int32_t tick;
+        uint64_t remaining;
+    };
+
+    // A price level holding at least one of our orders
+    struct Level {
+        bool is_bid;
+        int32_t tick;
+        uint32_t ours;          // Our resting orders here
+        uint64_t displayed;     // Displayed size at the last sync
+    };
+
+    // Checkpoint records
+    struct SavedResting {
+        uint64_t order_id;
+        Resting resting;
+    };
+
+    struct SavedEntry {
+        uint64_t id;
+        double quantity;
+    };
+
+    double tick_size_;
+    FlatBookBackend<MaxTicks, MaxOrders> book_;
+    bool anchored_;
+    std::unordered_map<uint64_t, Resting> ours_;
+    std::vector<Level> levels_;
+    std::vector<std::pair<uint64_t, double>> scratch_;  // One level's FIFO
+    std::vector<double> cuts_;
+    MarketTick last_market_;
+    bool has_market_ = false;
+    uint64_t next_block_ = 1;
+
+    static bool is_market(uint64_t id) { return (id & MARKET_BIT) != 0; }
+
+    // Price ticks are only meaningful once the backend window is placed
+    void anchor(double price) {
+        if (!anchored_ && price > 0.0) {
+            book_ = FlatBookBackend<MaxTicks, MaxOrders>(tick_size_, price);
+            anchored_ = true;
+        }
+    }
+
+    OrderBookUpdate make_update(uint64_t id, int32_t tick, double qty, bool is_bid, int64_t ts) const {
+        OrderBookUpdate u;
+        u.order_id = id;
+        u.price = book_.tick_to_price(tick);
+        u.quantity = qty;
+        u.is_bid = is_bid;
+        u.timestamp_ns = ts;
+        return u;
+    }
+
+    Level* find_level(bool is_bid, int32_t tick) {
+        for (auto& level : levels_) {
+            if (level.is_bid == is_bid && level.tick == tick) return &level;
+        }
+        return nullptr;
+    }
+
+    void load_fifo(bool is_bid, int32_t tick) {
+        scratch_.clear();
+        book_.for_each_order_at(is_bid, book_.tick_to_price(tick),
+            [this](uint64_t id, double qty) { scratch_.emplace_back(id, qty); });
+    }
+
+    // Displayed size at a tick in `market`. False when the level is deeper
+    // than the depth the update shows. A price inside the spread has none.
+    bool displayed_at(bool is_bid, int32_t tick, const MarketTick& market, uint64_t& out) const {
+        const double best = is_bid ? market.bid_price : market.ask_price;
+        if (best <= 0.0) {
+            return false;
+        }
+        const int32_t best_tick = book_.price_to_tick(best);
+        if (tick == best_tick) {
+            out = is_bid ? market.bid_size : market.ask_size;
+            return true;
+        }
+        if (is_bid ? tick > best_tick : tick < best_tick) {
+            out = 0;
+            return true;
+        }
+        const auto& prices = is_bid ? market.bid_prices : market.ask_prices;
+        const auto& sizes = is_bid ? market.bid_sizes : market.ask_sizes;
+        const size_t depth = std::min<size_t>(market.depth_levels, prices.size());
+        for (size_t i = 1; i < depth; ++i) {
+            if (prices[i] > 0.0 && book_.price_to_tick(prices[i]) == tick) {
+                out = sizes[i];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Consume `qty` of the FIFO entry at scratch_[i]. A level whose last
+    // order of ours fills stays registered until prune().
+    template<typename OnFill>
+    void execute_entry(size_t i, bool is_bid, int32_t tick, double qty, int64_t ts, OnFill& on_fill) {
+        const uint64_t id = scratch_[i].first;
+        book_.execute(make_update(id, tick, qty, is_bid, ts));
+        if (is_market(id)) {
+            return;
+        }
+        auto it = ours_.find(id);
+        const uint64_t filled = static_cast<uint64_t>(qty);
+        it->second.remaining -= filled;
+        const uint64_t remaining = it->second.remaining;
+        if (remaining == 0) {
+            ours_.erase(it);
+            --find_level(is_bid, tick)->ours;
+        }
+        on_fill(Fill{id, filled, remaining});
+    }
+
+    // The opposite touch moved through our price: everything of ours there
+    // traded
+    template<typename OnFill>
+    void fill_crossed(const MarketTick& tick, int64_t ts, OnFill& on_fill) {
+        const int32_t ask_tick = tick.ask_price > 0.0 ? book_.price_to_tick(tick.ask_price) : INT32_MAX;
+        const int32_t bid_tick = tick.bid_price > 0.0 ? book_.price_to_tick(tick.bid_price) : INT32_MIN;
+        for (size_t i = levels_.size(); i-- > 0;) {
+            const Level level = levels_[i];
+            if (level.is_bid ? level.tick < ask_tick : level.tick > bid_tick) {
+                continue;
+            }
+            load_fifo(level.is_bid, level.tick);
+            for (size_t j = 0; j < scratch_.size(); ++j) {
+                if (!is_market(scratch_[j].first)) {
+                    execute_entry(j, level.is_bid, level.tick, scratch_[j].second, ts, on_fill);
+                }
+            }
+            prune(level.is_bid, level.tick);
+        }
+    }
+
+    // An aggressor trade of `volume` reaching `limit_tick`: walk our levels
+    // on the hit side best first, each from the front of its queue
+    template<typename OnFill>
+    void trade_through(bool hits_bids, int32_t limit_tick, double volume, int64_t ts, OnFill& on_fill) {
+        while (volume > 0.0) {
+            const Level* best = nullptr;
+            for (const auto& level : levels_) {
+                if (level.is_bid != hits_bids) continue;
+                if (hits_bids ? level.tick < limit_tick : level.tick > limit_tick) continue;
+                if (!best || (hits_bids ? level.tick > best->tick : level.tick < best->tick)) {
+                    best = &level;
+                }
+            }
+            if (!best) {
+                return;
+            }
+            const int32_t tick = best->tick;
+
+            load_fifo(hits_bids, tick);
+            for (size_t j = 0; j < scratch_.size() && volume > 0.0; ++j) {
+                // Our orders fill in whole shares
+                const double take = is_market(scratch_[j].first)
+                    ? std::min(scratch_[j].second, volume)
+                    : std::min(scratch_[j].second, std::floor(volume));
+                if (take <= 0.0) {
+                    break;
+                }
+                execute_entry(j, hits_bids, tick, take, ts, on_fill);
+                volume -= take;
+            }
+            // Volume ran out inside this level's queue
+            if (!prune(hits_bids, tick)) {
+                return;
+            }
+        }
+    }
+
+    // Bring a level's market blocks to the displayed size
+    void sync_level(Level& level, uint64_t displayed, int64_t ts) {
+        load_fifo(level.is_bid, level.tick);
+        level.displayed = displayed;
+        double market = 0.0;
+        for (const auto& e : scratch_) {
+            if (is_market(e.first)) market += e.second;
+        }
+        const double target = static_cast<double>(displayed);
+
+        if (target > market) {
+            const double extra = target - market;
+            if (!scratch_.empty() && is_market(scratch_.back().first)) {
+                // Tail block grows in place; it is already at the back
+                book_.modify(make_update(scratch_.back().first, level.tick,
+                                         scratch_.back().second + extra, level.is_bid, ts));
+            } else {
+                book_.add(make_update(next_block_++ | MARKET_BIT, level.tick, extra, level.is_bid, ts));
+            }
+            return;
+        }
+        if (target == market) {
+            return;
+        }
+
+        // Cancels: pro rata over the blocks in whole shares, the rounding
+        // remainder from the back of the queue
+        const double cut = market - target;
+        cuts_.assign(scratch_.size(), 0.0);
+        double left = cut;
+        for (size_t j = 0; j < scratch_.size(); ++j) {
+            if (!is_market(scratch_[j].first)) continue;
+            cuts_[j] = std::min(scratch_[j].second, std::floor(cut * scratch_[j].second / market));
+            left -= cuts_[j];
+        }
+        for (size_t j = scratch_.size(); j-- > 0 && left > 0.0;) {
+            if (!is_market(scratch_[j].first)) continue;
+            const double more = std::min(scratch_[j].second - cuts_[j], left);
+            cuts_[j] += more;
+            left -= more;
+        }
+        for (size_t j = 0; j < scratch_.size(); ++j) {
+            if (cuts_[j] <= 0.0) continue;
+            const double rest = scratch_[j].second - cuts_[j];
+            OrderBookUpdate u = make_update(scratch_[j].first, level.tick, rest, level.is_bid, ts);
+            if (rest <= 0.0) {
+                book_.remove(u);
+            } else {
+                book_.modify(u);  // Size down keeps queue position
+            }
+        }
+    }
+
+    // One of our orders left a level
+    void release(bool is_bid, int32_t tick) {
+        --find_level(is_bid, tick)->ours;
+        prune(is_bid, tick);
+    }
+
+    // Drop a level none of our orders rest on. True if dropped.
+    bool prune(bool is_bid, int32_t tick) {
+        Level* level = find_level(is_bid, tick);
+        if (!level || level->ours > 0) {
+            return false;
+        }
+        drop_level(*level);
+        return true;
+    }
+
+    void drop_level(Level& level) {
+        load_fifo(level.is_bid, level.tick);
+        OrderBookUpdate u;
+        for (const auto& e : scratch_) {
+            u.order_id = e.first;
+            book_.remove(u);
+        }
+        level = levels_.back();
+        levels_.pop_back();
+    }
+};
+
+using QueueFillSimulator = BasicQueueFillSimulator<>;
+
+} // namespace backtest
+} // namespace hft
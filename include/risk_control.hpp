@@ -1,14 +1,42 @@
 #pragma once
 
 #include "common_types.hpp"
+#include "engine_checkpoint.hpp"
+#include "instrument_directory.hpp"
+#include "seqlock.hpp"
+#include "spin_loop_engine.hpp"
 #include <atomic>
+#include <chrono>
 #include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 #include <algorithm>
 #include <string>
 
 namespace hft {
 
+// Volatility index -> regime and position-limit multiplier
+inline MarketRegime classify_regime(double volatility_index, double& multiplier) {
+    if (volatility_index < 0.5) {
+        multiplier = 1.0;
+        return MarketRegime::NORMAL;
+    }
+    if (volatility_index < 1.0) {
+        multiplier = 0.7;
+        return MarketRegime::ELEVATED_VOLATILITY;
+    }
+    if (volatility_index < 2.0) {
+        multiplier = 0.4;
+        return MarketRegime::HIGH_STRESS;
+    }
+    multiplier = 0.0;
+    return MarketRegime::HALTED;
+}
+
 class RiskControl {
 public:
 
@@ -69,26 +97,8 @@ public:
     }
 
     void set_regime_multiplier(double volatility_index) {
-        MarketRegime new_regime;
         double multiplier;
-
-        if (volatility_index < 0.5) {
-
-            new_regime = MarketRegime::NORMAL;
-            multiplier = 1.0;
-        } else if (volatility_index < 1.0) {
-
-            new_regime = MarketRegime::ELEVATED_VOLATILITY;
-            multiplier = 0.7;
-        } else if (volatility_index < 2.0) {
-
-            new_regime = MarketRegime::HIGH_STRESS;
-            multiplier = 0.4;
-        } else {
-
-            new_regime = MarketRegime::HALTED;
-            multiplier = 0.0;
-        }
+        const MarketRegime new_regime = classify_regime(volatility_index, multiplier);
 
         current_regime_.store(new_regime, std::memory_order_release);
         regime_multiplier_.store(multiplier, std::memory_order_release);
@@ -132,6 +142,11 @@ public:
         }
     }
 
+    // Startup: the venue's position replaces the one tracked here
+    void reconcile_position(int64_t venue_position) {
+        current_position_.store(venue_position, std::memory_order_release);
+    }
+
     void increment_trade_count() {
         daily_trade_count_.fetch_add(1, std::memory_order_relaxed);
     }
@@ -196,6 +211,28 @@ public:
         return daily_trade_count_.load(std::memory_order_acquire);
     }
 
+    // Limits come from construction; this is the running state. Not for use
+    // while other threads update it.
+    void save_state(checkpoint::StateWriter& out) const {
+        out.put(kill_switch_triggered_.load(std::memory_order_acquire));
+        out.put(current_max_position_.load(std::memory_order_acquire));
+        out.put(regime_multiplier_.load(std::memory_order_acquire));
+        out.put(current_regime_.load(std::memory_order_acquire));
+        out.put(total_pnl_.load(std::memory_order_acquire));
+        out.put(current_position_.load(std::memory_order_acquire));
+        out.put(daily_trade_count_.load(std::memory_order_acquire));
+    }
+
+    void restore_state(checkpoint::StateReader& in) {
+        kill_switch_triggered_.store(in.get<bool>(), std::memory_order_release);
+        current_max_position_.store(in.get<int64_t>(), std::memory_order_release);
+        regime_multiplier_.store(in.get<double>(), std::memory_order_release);
+        current_regime_.store(in.get<MarketRegime>(), std::memory_order_release);
+        total_pnl_.store(in.get<double>(), std::memory_order_release);
+        current_position_.store(in.get<int64_t>(), std::memory_order_release);
+        daily_trade_count_.store(in.get<int64_t>(), std::memory_order_release);
+    }
+
 private:
 
     const int64_t base_max_position_;
@@ -212,4 +249,380 @@ private:
     std::atomic<int64_t> daily_trade_count_;
 };
 
-}
\ No newline at end of file
+// ====
+// Multi-Strategy Risk Engine
+// Limits are flat per-symbol and per-strategy tables indexed by dense IDs
+// (InstrumentDirectory). Each strategy thread owns a StrategyRiskContext
+// and checks orders against its own cache lines only. The firm-wide
+// per-symbol position limit is handed out as credit: a strategy may hold
+// |position| up to the credit it has drawn from the symbol's pool, and
+// draws more in chunks, so the sum of strategy positions can never exceed
+// the firm limit and the shared pool is touched once per chunk, not per
+// order. RiskEngine::reconcile() aggregates exposure and P&L off the hot
+// path, blocks strategies over their loss limit and trips the kill switch.
+// ====
+
+struct RiskLimits {
+    int64_t max_position = 1000;            // |position| per symbol
+    double max_order_value = 100000.0;      // price * quantity per order
+    double max_loss = 10000.0;              // marked-to-market loss (strategy / firm)
+    int64_t max_daily_trades = 10000;       // fills (strategy / firm)
+    double max_gross_notional = std::numeric_limits<double>::infinity();
+};
+
+// Per-symbol fill state, published by the owning strategy on every fill
+struct SymbolPosition {
+    int64_t position;
+    double cash;                            // -sum(signed quantity * price)
+    double last_price;                      // mark fallback before the first mark()
+};
+
+// Firm-wide view produced by each reconcile()
+struct FirmExposure {
+    double total_pnl;
+    double gross_notional;
+    int64_t trade_count;
+    uint32_t blocked_strategies;
+    bool position_breach;                   // a symbol's net position over its limit
+    bool kill_switch;
+    uint64_t sequence;                      // reconcile() passes so far
+};
+
+class RiskEngine;
+
+class StrategyRiskContext {
+public:
+    using SymbolId = uint32_t;
+
+    StrategyRiskContext(const StrategyRiskContext&) = delete;
+    StrategyRiskContext& operator=(const StrategyRiskContext&) = delete;
+
+    // Hot path, owning thread only. order.asset_id is the SymbolId.
+    bool check_pre_trade_limits(const Order& order);
+    void on_fill(SymbolId symbol, Side side, uint64_t quantity, double price);
+
+    // Return credit not backing a position (e.g. after cancels)
+    void release_idle_credit();
+
+    void reset_daily_counters() { trade_count_.store(0, std::memory_order_relaxed); }
+
+    uint32_t id() const { return id_; }
+    const RiskLimits& limits() const { return limits_; }
+    int64_t position(SymbolId symbol) const { return books_[symbol].position; }
+    int64_t credit(SymbolId symbol) const { return books_[symbol].credit; }
+    int64_t trade_count() const { return trade_count_.load(std::memory_order_relaxed); }
+    bool blocked() const { return blocked_.load(std::memory_order_acquire); }
+
+private:
+    friend class RiskEngine;
+
+    // Owner-only working state: one line per symbol holds everything the
+    // check reads
+    struct alignas(64) SymbolBook {
+        int64_t position = 0;
+        double cash = 0.0;
+        int64_t credit = 0;                 // |position| headroom drawn from the pool
+        int64_t max_position = 0;           // min(symbol, strategy)
+        double max_order_value = 0.0;       // min(symbol, strategy)
+    };
+
+    StrategyRiskContext(RiskEngine& engine, uint32_t id, const RiskLimits& limits,
+                        const std::vector<RiskLimits>& symbol_limits)
+        : engine_(engine), id_(id), limits_(limits),
+          books_(symbol_limits.size()), published_(new Seqlock<SymbolPosition>[symbol_limits.size()]) {
+        for (size_t s = 0; s < books_.size(); ++s) {
+            books_[s].max_position = std::min(limits.max_position, symbol_limits[s].max_position);
+            books_[s].max_order_value = std::min(limits.max_order_value, symbol_limits[s].max_order_value);
+        }
+    }
+
+    RiskEngine& engine_;
+    const uint32_t id_;
+    const RiskLimits limits_;
+    std::vector<SymbolBook> books_;
+    std::unique_ptr<Seqlock<SymbolPosition>[]> published_;
+
+    alignas(64) std::atomic<int64_t> trade_count_{0};    // owner-written
+    alignas(64) std::atomic<bool> blocked_{false};       // reconciler-written
+};
+
+class RiskEngine {
+public:
+    using SymbolId = uint32_t;
+    using StrategyId = uint32_t;
+
+    /**
+     * @param firm_limits  max_loss / max_daily_trades / max_gross_notional
+     *                     apply firm-wide; max_position and max_order_value
+     *                     are the per-symbol defaults
+     * @param credit_chunk Position credit drawn from a symbol pool at a time
+     */
+    explicit RiskEngine(size_t symbol_count, const RiskLimits& firm_limits = {}, int64_t credit_chunk = 100)
+        : firm_limits_(firm_limits), credit_chunk_(std::max<int64_t>(credit_chunk, 1)),
+          symbol_limits_(symbol_count, firm_limits), pools_(symbol_count),
+          marks_(symbol_count), net_positions_(symbol_count), net_scratch_(symbol_count) {
+        for (size_t s = 0; s < symbol_count; ++s) {
+            pools_[static_cast<SymbolId>(s)].store(firm_limits.max_position, std::memory_order_relaxed);
+        }
+        exposure_.store(FirmExposure{});
+    }
+
+    RiskEngine(const RiskEngine&) = delete;
+    RiskEngine& operator=(const RiskEngine&) = delete;
+
+    // Configuration, before the first add_strategy()
+    void set_symbol_limits(SymbolId symbol, const RiskLimits& limits) {
+        if (!strategies_.empty()) {
+            throw std::logic_error("Symbol limits must be set before strategies are added");
+        }
+        symbol_limits_.at(symbol) = limits;
+        pools_[symbol].store(limits.max_position, std::memory_order_relaxed);
+    }
+
+    // Startup only: contexts are never removed, references stay valid
+    StrategyRiskContext& add_strategy(const RiskLimits& limits) {
+        std::lock_guard<std::mutex> lock(reconcile_mutex_);
+        const auto id = static_cast<StrategyId>(strategies_.size());
+        strategies_.emplace_back(new StrategyRiskContext(*this, id, limits, symbol_limits_));
+        return *strategies_.back();
+    }
+
+    StrategyRiskContext& strategy(StrategyId id) { return *strategies_.at(id); }
+    size_t strategy_count() const { return strategies_.size(); }
+    size_t symbol_count() const { return symbol_limits_.size(); }
+
+    // Mark price for P&L, from the market data thread
+    void mark(SymbolId symbol, double price) {
+        marks_[symbol].store(price, std::memory_order_relaxed);
+    }
+
+    // Aggregate all strategies; call periodically (RiskReconciler) or on demand
+    FirmExposure reconcile() {
+        std::lock_guard<std::mutex> lock(reconcile_mutex_);
+
+        FirmExposure e{};
+        std::fill(net_scratch_.begin(), net_scratch_.end(), 0);
+
+        for (const auto& ctx : strategies_) {
+            double pnl = 0.0;
+            double gross = 0.0;
+            for (size_t s = 0; s < net_scratch_.size(); ++s) {
+                const SymbolPosition p = ctx->published_[s].load();
+                if (p.position == 0 && p.cash == 0.0) continue;
+                const double m = marks_[s].load(std::memory_order_relaxed);
+                const double mark = m > 0.0 ? m : p.last_price;
+                pnl += p.cash + static_cast<double>(p.position) * mark;
+                gross += std::abs(static_cast<double>(p.position)) * mark;
+                net_scratch_[s] += p.position;
+            }
+
+            const bool blocked = pnl < -ctx->limits_.max_loss || gross > ctx->limits_.max_gross_notional;
+            ctx->blocked_.store(blocked, std::memory_order_release);
+            e.blocked_strategies += blocked ? 1 : 0;
+            e.total_pnl += pnl;
+            e.gross_notional += gross;
+            e.trade_count += ctx->trade_count_.load(std::memory_order_relaxed);
+        }
+
+        for (size_t s = 0; s < net_scratch_.size(); ++s) {
+            net_positions_[s].store(net_scratch_[s], std::memory_order_relaxed);
+            if (std::abs(net_scratch_[s]) > symbol_limits_[s].max_position) e.position_breach = true;
+        }
+
+        if (e.total_pnl < -firm_limits_.max_loss || e.gross_notional > firm_limits_.max_gross_notional ||
+            e.trade_count > firm_limits_.max_daily_trades || e.position_breach) {
+            trigger_kill_switch();
+        }
+        e.kill_switch = is_kill_switch_triggered();
+        e.sequence = ++reconcile_count_;
+        exposure_.store(e);
+        return e;
+    }
+
+    // Last reconcile() result, lock-free
+    FirmExposure exposure() const { return exposure_.load(); }
+    int64_t net_position(SymbolId symbol) const {
+        return net_positions_[symbol].load(std::memory_order_relaxed);
+    }
+    int64_t available_credit(SymbolId symbol) const {
+        return pools_[symbol].load(std::memory_order_acquire);
+    }
+
+    void set_regime_multiplier(double volatility_index) {
+        double multiplier;
+        control_.regime.store(classify_regime(volatility_index, multiplier), std::memory_order_release);
+        control_.position_scale.store(multiplier, std::memory_order_release);
+    }
+
+    MarketRegime get_current_regime() const { return control_.regime.load(std::memory_order_acquire); }
+    double get_regime_multiplier() const { return control_.position_scale.load(std::memory_order_acquire); }
+
+    void trigger_kill_switch() { control_.kill_switch.store(true, std::memory_order_release); }
+    bool is_kill_switch_triggered() const { return control_.kill_switch.load(std::memory_order_acquire); }
+
+    void reset_kill_switch(const std::string& authorization_code) {
+        if (authorization_code == "EMERGENCY_RESET") {
+            control_.kill_switch.store(false, std::memory_order_release);
+        }
+    }
+
+private:
+    friend class StrategyRiskContext;
+
+    // Grants at least `need` (rounded up to a chunk when the pool allows)
+    // or nothing
+    int64_t acquire_credit(SymbolId symbol, int64_t need) {
+        auto& pool = pools_[symbol];
+        int64_t available = pool.load(std::memory_order_relaxed);
+        for (;;) {
+            if (available < need) return 0;
+            const int64_t grant = std::min(available, std::max(need, credit_chunk_));
+            if (pool.compare_exchange_weak(available, available - grant,
+                                           std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return grant;
+            }
+        }
+    }
+
+    void release_credit(SymbolId symbol, int64_t amount) {
+        pools_[symbol].fetch_add(amount, std::memory_order_acq_rel);
+    }
+
+    // Read-mostly on the hot path: written only by operators and the reconciler
+    struct alignas(64) Control {
+        std::atomic<bool> kill_switch{false};
+        std::atomic<MarketRegime> regime{MarketRegime::NORMAL};
+        std::atomic<double> position_scale{1.0};
+    };
+
+    const RiskLimits firm_limits_;
+    const int64_t credit_chunk_;
+    Control control_;
+
+    std::vector<RiskLimits> symbol_limits_;
+    PerIdArray<std::atomic<int64_t>> pools_;                 // unclaimed position credit
+    std::vector<std::atomic<double>> marks_;
+    std::vector<std::atomic<int64_t>> net_positions_;
+
+    std::vector<std::unique_ptr<StrategyRiskContext>> strategies_;
+    std::mutex reconcile_mutex_;
+    std::vector<int64_t> net_scratch_;
+    uint64_t reconcile_count_ = 0;
+    Seqlock<FirmExposure> exposure_;
+};
+
+inline bool StrategyRiskContext::check_pre_trade_limits(const Order& order) {
+    if (engine_.is_kill_switch_triggered() || blocked_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    if (order.asset_id >= books_.size()) {
+        return false;
+    }
+
+    SymbolBook& book = books_[order.asset_id];
+    if (order.price * order.quantity > book.max_order_value) {
+        return false;
+    }
+    if (trade_count_.load(std::memory_order_relaxed) >= limits_.max_daily_trades) {
+        return false;
+    }
+
+    const double scale = engine_.control_.position_scale.load(std::memory_order_relaxed);
+    if (scale <= 0.0) {
+        return false;                       // HALTED
+    }
+
+    const int64_t delta = order.side == Side::BUY ?
+        static_cast<int64_t>(order.quantity) : -static_cast<int64_t>(order.quantity);
+    const int64_t exposure = std::abs(book.position + delta);
+    if (exposure > static_cast<int64_t>(book.max_position * scale)) {
+        return false;
+    }
+
+    if (exposure > book.credit) {
+        const int64_t grant = engine_.acquire_credit(order.asset_id, exposure - book.credit);
+        if (grant == 0) {
+            return false;                   // firm-wide symbol limit exhausted
+        }
+        book.credit += grant;
+    }
+    return true;
+}
+
+inline void StrategyRiskContext::on_fill(SymbolId symbol, Side side, uint64_t quantity, double price) {
+    SymbolBook& book = books_[symbol];
+    const int64_t delta = side == Side::BUY ?
+        static_cast<int64_t>(quantity) : -static_cast<int64_t>(quantity);
+    book.position += delta;
+    book.cash -= static_cast<double>(delta) * price;
+    published_[symbol].store(SymbolPosition{book.position, book.cash, price});
+    trade_count_.store(trade_count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    // Fills from several open orders can outrun the credit drawn at check
+    // time; top up, and the reconciler flags a breach if the pool is dry
+    const int64_t exposure = std::abs(book.position);
+    if (exposure > book.credit) {
+        book.credit += engine_.acquire_credit(symbol, exposure - book.credit);
+    } else if (book.credit - exposure > 2 * engine_.credit_chunk_) {
+        const int64_t keep = exposure + engine_.credit_chunk_;
+        engine_.release_credit(symbol, book.credit - keep);
+        book.credit = keep;
+    }
+}
+
+inline void StrategyRiskContext::release_idle_credit() {
+    for (size_t s = 0; s < books_.size(); ++s) {
+        SymbolBook& book = books_[s];
+        const int64_t idle = book.credit - std::abs(book.position);
+        if (idle > 0) {
+            engine_.release_credit(static_cast<SymbolId>(s), idle);
+            book.credit -= idle;
+        }
+    }
+}
+
+// Runs RiskEngine::reconcile() on a background thread
+class RiskReconciler {
+public:
+    explicit RiskReconciler(RiskEngine& engine,
+                            std::chrono::nanoseconds interval = std::chrono::milliseconds(1),
+                            int cpu_core = -1)
+        : engine_(engine), interval_(interval), cpu_core_(cpu_core) {}
+
+    ~RiskReconciler() { stop(); }
+
+    RiskReconciler(const RiskReconciler&) = delete;
+    RiskReconciler& operator=(const RiskReconciler&) = delete;
+
+    void start() {
+        if (running_.exchange(true)) return;
+        worker_ = std::thread([this] { run(); });
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) return;
+        if (worker_.joinable()) worker_.join();
+    }
+
+    uint64_t passes() const { return passes_.load(std::memory_order_acquire); }
+
+private:
+    void run() {
+        if (cpu_core_ >= 0) spin_loop::pin_to_cpu(cpu_core_);
+        while (running_.load(std::memory_order_acquire)) {
+            engine_.reconcile();
+            passes_.fetch_add(1, std::memory_order_acq_rel);
+            std::this_thread::sleep_for(interval_);
+        }
+    }
+
+    RiskEngine& engine_;
+    std::chrono::nanoseconds interval_;
+    int cpu_core_;
+
+    std::thread worker_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> passes_{0};
+};
+
+}
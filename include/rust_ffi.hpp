@@ -2,11 +2,19 @@
 
 #include "common_types.hpp"
 #include "shared_memory.hpp"
+#include <cstddef>
 #include <cstdint>
+#include <type_traits>
 
 // ====
 // C++/Rust FFI Bridge
 // Provides seamless integration between C++ core and Rust safety features
+//
+// Every type crossing the boundary is passed by pointer in its C++ layout;
+// src/lib.rs declares #[repr(C)] mirrors and both sides assert the same
+// sizes and offsets, so nothing is converted or copied at the call. The
+// batch entry points take whole spans (ticks -> quotes, orders ->
+// verdicts), paying the call and the kill-switch load once per span.
 // ====
 
 namespace hft {
@@ -18,7 +26,29 @@ namespace rust_ffi {
 
 struct RustMarketMaker;
 struct RustRiskControl;
-struct RustLockFreeQueue;
+
+// ====
+// Layouts shared with src/lib.rs
+// ====
+
+static_assert(sizeof(Timestamp) == 8, "Timestamp crosses as i64 nanoseconds");
+static_assert(sizeof(Side) == 1, "Side crosses as u8");
+
+static_assert(std::is_standard_layout_v<MarketTick>, "MarketTick is mirrored in Rust");
+static_assert(offsetof(MarketTick, trade_side) == 56, "MarketTick layout (see src/lib.rs)");
+static_assert(offsetof(MarketTick, asset_id) == 60, "MarketTick layout (see src/lib.rs)");
+static_assert(offsetof(MarketTick, bid_prices) == 72, "MarketTick layout (see src/lib.rs)");
+static_assert(offsetof(MarketTick, ask_sizes) == 312, "MarketTick layout (see src/lib.rs)");
+static_assert(sizeof(MarketTick) == 448, "MarketTick layout (see src/lib.rs)");
+
+static_assert(std::is_standard_layout_v<Order>, "Order is mirrored in Rust");
+static_assert(offsetof(Order, side) == 12, "Order layout (see src/lib.rs)");
+static_assert(offsetof(Order, quantity) == 24, "Order layout (see src/lib.rs)");
+static_assert(sizeof(Order) == 64, "Order layout (see src/lib.rs)");
+
+static_assert(std::is_standard_layout_v<QuotePair>, "QuotePair is mirrored in Rust");
+static_assert(offsetof(QuotePair, mid_price) == 40, "QuotePair layout (see src/lib.rs)");
+static_assert(sizeof(QuotePair) == 56, "QuotePair layout (see src/lib.rs)");
 
 // ====
 // C++ -> Rust FFI Functions
@@ -35,6 +65,13 @@ extern "C" {
                                           int64_t inventory,
                                           double* bid_out,
                                           double* ask_out);
+    // quotes_out[i] gets bid/ask/spread/mid for ticks[i] at inventories[i];
+    // sizes and generated_at are left to the caller
+    void rust_market_maker_generate_quotes_batch(RustMarketMaker* mm,
+                                                 const MarketTick* ticks,
+                                                 const int64_t* inventories,
+                                                 size_t count,
+                                                 QuotePair* quotes_out);
     
     // Rust Risk Control
     RustRiskControl* rust_risk_control_new(int64_t max_position);
@@ -42,16 +79,22 @@ extern "C" {
     bool rust_risk_control_check_pre_trade(RustRiskControl* rc,
                                            const Order* order,
                                            int64_t current_position);
+    // verdicts_out[i] = 1 if orders[i] passes at current_position, else 0;
+    // returns the number approved
+    size_t rust_risk_control_check_pre_trade_batch(RustRiskControl* rc,
+                                                   const Order* orders,
+                                                   size_t count,
+                                                   int64_t current_position,
+                                                   uint8_t* verdicts_out);
     void rust_risk_control_trigger_kill_switch(RustRiskControl* rc);
     bool rust_risk_control_is_halted(RustRiskControl* rc);
     
-    // Rust Lock-Free Queue
-    RustLockFreeQueue* rust_queue_new(size_t capacity);
-    void rust_queue_free(RustLockFreeQueue* queue);
-    bool rust_queue_push(RustLockFreeQueue* queue, const MarketTick* tick);
-    bool rust_queue_pop(RustLockFreeQueue* queue, MarketTick* tick);
-    bool rust_queue_is_empty(RustLockFreeQueue* queue);
-    size_t rust_queue_size(RustLockFreeQueue* queue);
+    // Shared ring: region is a mapped shm::RingHeader with MarketTick slots
+    // (SharedMarketDataQueue::region()). Rust must be the ring's only
+    // producer (push) or only consumer (pop); returns ticks moved, 0 if the
+    // header doesn't validate
+    size_t rust_ring_push_ticks(void* region, const MarketTick* ticks, size_t count);
+    size_t rust_ring_pop_ticks(void* region, MarketTick* ticks_out, size_t max_ticks);
     
     // Benchmarking
     void rust_benchmark_queue_throughput();
@@ -90,6 +133,16 @@ public:
         return quotes;
     }
     
+    // One FFI call for the span; all quotes share one timestamp
+    void generate_quotes_batch(const MarketTick* ticks, const int64_t* inventories,
+                               size_t count, QuotePair* quotes_out) const {
+        rust_market_maker_generate_quotes_batch(handle_, ticks, inventories, count, quotes_out);
+        const Timestamp stamp = now();
+        for (size_t i = 0; i < count; ++i) {
+            quotes_out[i].generated_at = stamp;
+        }
+    }
+    
 private:
     RustMarketMaker* handle_;
 };
@@ -112,6 +165,11 @@ public:
         return rust_risk_control_check_pre_trade(handle_, &order, current_position);
     }
     
+    size_t check_pre_trade_batch(const Order* orders, size_t count, int64_t current_position,
+                                 uint8_t* verdicts_out) const {
+        return rust_risk_control_check_pre_trade_batch(handle_, orders, count, current_position, verdicts_out);
+    }
+    
     void trigger_kill_switch() const {
         rust_risk_control_trigger_kill_switch(handle_);
     }
@@ -129,10 +187,6 @@ private:
 // ====
 
 extern "C" {
-    // Shared memory operations
-    bool shm_write_tick(const char* name, const MarketTick* tick);
-    bool shm_read_tick(const char* name, MarketTick* tick);
-    
     // Hawkes engine integration
     void cpp_hawkes_update(void* engine, const MarketTick* tick);
     
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace hft {
+
+// Single-writer / multi-reader sequence lock.
+//
+// The writer never waits: it bumps the sequence to odd, copies the payload,
+// then publishes an even sequence. Readers copy optimistically and retry if
+// the sequence moved (or was odd) while they were copying. Readers never
+// write shared state, so any number of them can poll without slowing the
+// writer beyond the cache-line transfer of the payload itself.
+template<typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock payload must be trivially copyable");
+
+private:
+    alignas(64) std::atomic<uint64_t> seq_{0};
+    alignas(64) T data_{};
+
+public:
+    Seqlock() = default;
+
+    Seqlock(const Seqlock&) = delete;
+    Seqlock& operator=(const Seqlock&) = delete;
+
+    // Writer side (one thread only)
+    void store(const T& value) {
+        const uint64_t s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::memcpy(static_cast<void*>(&data_), &value, sizeof(T));
+
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    // Reader side: spins only while a write is in flight
+    T load() const {
+        T value;
+        while (!try_load(value)) {}
+        return value;
+    }
+
+    // Single attempt; false if the writer was active during the copy
+    bool try_load(T& out) const {
+        const uint64_t s1 = seq_.load(std::memory_order_acquire);
+        if (s1 & 1) return false;
+
+        std::memcpy(static_cast<void*>(&out), &data_, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        return seq_.load(std::memory_order_relaxed) == s1;
+    }
+
+    // Number of completed writes
+    uint64_t version() const {
+        return seq_.load(std::memory_order_acquire) >> 1;
+    }
+};
+
+}
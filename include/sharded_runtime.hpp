@@ -0,0 +1,394 @@
+#pragma once
+
+#include "common_types.hpp"
+#include "avellaneda_stoikov.hpp"
+#include "compact_tick.hpp"
+#include "fpga_inference.hpp"
+#include "hawkes_engine.hpp"
+#include "lockfree_queue.hpp"
+#include "order_gateway.hpp"
+#include "risk_control.hpp"
+#include "spin_loop_engine.hpp"
+#include "system_determinism.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace hft {
+namespace runtime {
+
+// ====
+// Sharded Engine Runtime
+// Feed thread -> per-shard SPSC tick rings -> N pinned shard threads, each
+// owning the books and models of its symbols -> one MPSC intent ring ->
+// gateway thread. Firm-wide risk is reconciled on its own thread.
+// ====
+
+struct ShardConfig {
+    int cpu_core = -1;               // -1 = not pinned
+    int numa_node = -1;              // -1 = no NUMA binding
+};
+
+struct RuntimeConfig {
+    std::vector<ShardConfig> shards;
+    int gateway_core = -1;
+    int risk_core = -1;
+    std::chrono::nanoseconds reconcile_interval = std::chrono::milliseconds(1);
+
+    // Per RiskEngine: firm-wide totals, per-symbol defaults; each shard
+    // trades as one strategy under shard_limits
+    RiskLimits firm_limits;
+    RiskLimits shard_limits;
+    int64_t credit_chunk = 100;
+
+    // Model parameters, as in the single-instrument loop
+    double risk_aversion = 0.1;
+    double volatility = 0.20;
+    double time_horizon = 300.0;
+    double order_arrival_rate = 10.0;
+    double tick_size = 0.01;
+    int64_t system_latency_ns = 800;
+    bool pad_inference_latency = false;
+
+    // Optional depth side table the feed publishes to (CompactTick::book_id)
+    const DepthTable* depth = nullptr;
+
+    explicit RuntimeConfig(size_t shard_count = 1) : shards(shard_count) {}
+};
+
+// Snapshot of one shard's counters
+struct ShardStats {
+    uint64_t ticks = 0;
+    uint64_t fills = 0;
+    uint64_t quotes = 0;             // new or cancel/replace intents sent
+    uint64_t risk_rejects = 0;
+    uint64_t gateway_full = 0;       // intents refused by a full intent ring
+    uint64_t dropped = 0;            // ticks refused by a full shard ring (feed side)
+};
+
+// Execution report routed back to the owning shard
+struct ShardFill {
+    uint32_t symbol_id;
+    Side side;
+    uint64_t quantity;
+    double price;
+};
+
+// Everything one symbol needs on its shard; built on the shard's thread so
+// first touch places it on the shard's NUMA node. The shard's weights are
+// copied in: feature state (book deltas, last mid) must not mix symbols.
+struct SymbolModel {
+    SymbolModel(uint32_t symbol, const RuntimeConfig& config, const FPGA_DNN_Inference& weights)
+        : symbol_id(symbol),
+          hawkes(10.0, 10.0, 0.3, 0.1, 1e-3, 1.8, 1000),
+          inference(weights),
+          strategy(config.risk_aversion, config.volatility, config.time_horizon,
+                   config.order_arrival_rate, config.tick_size, config.system_latency_ns) {
+        tick.asset_id = symbol;
+    }
+
+    uint32_t symbol_id;
+    HawkesIntensityEngine hawkes;
+    FPGA_DNN_Inference inference;
+    DynamicMMStrategy strategy;
+    MarketTick tick;
+    double signal = 0.0;             // Last buy minus sell score
+    uint64_t bid_order_id = 0;       // Live gateway orders, 0 = none
+    uint64_t ask_order_id = 0;
+    double bid_price = 0.0;          // Prices those orders rest at
+    double ask_price = 0.0;
+};
+
+template<typename Transport, size_t TickQueueSize = 4096, size_t IntentQueueSize = 4096>
+class ShardedRuntime {
+public:
+    using Gateway = gateway::OrderGateway<Transport, IntentQueueSize>;
+    using TickQueue = LockFreeQueue<CompactTick, TickQueueSize>;
+    using FillQueue = LockFreeQueue<ShardFill, 1024>;
+
+    static constexpr size_t MAX_SHARDS = 64;
+    static constexpr size_t REFERENCE_RING_SIZE = 256;
+    static constexpr size_t TICK_BURST = 32;
+
+    /**
+     * @param symbol_count Dense symbol IDs 0..symbol_count-1, split into
+     *                     contiguous blocks per shard unless assign() says
+     *                     otherwise (blocks keep neighbouring symbols'
+     *                     risk marks on one core's cache lines)
+     * @param templates    Order templates for every symbol that will quote
+     */
+    ShardedRuntime(size_t symbol_count, const RuntimeConfig& config,
+                   const preserialized::OrderTemplatePool& templates, Transport& transport)
+        : config_(config), routes_(symbol_count),
+          risk_(symbol_count, config.firm_limits, config.credit_chunk),
+          reconciler_(risk_, config.reconcile_interval, config.risk_core),
+          gateway_(templates, transport, config.gateway_core),
+          reference_(new BroadcastRing<CompactTick, REFERENCE_RING_SIZE, MAX_SHARDS>()) {
+        const size_t shards = config.shards.size();
+        if (shards == 0 || shards > MAX_SHARDS) {
+            throw std::invalid_argument("ShardedRuntime: shard count must be 1.." + std::to_string(MAX_SHARDS));
+        }
+        if (symbol_count == 0) {
+            throw std::invalid_argument("ShardedRuntime: no symbols");
+        }
+        for (size_t s = 0; s < symbol_count; ++s) {
+            routes_[s] = static_cast<uint16_t>(s * shards / symbol_count);
+        }
+        for (size_t i = 0; i < shards; ++i) {
+            shards_.emplace_back(new Shard(*this, static_cast<uint16_t>(i)));
+        }
+    }
+
+    ~ShardedRuntime() { stop(); }
+
+    ShardedRuntime(const ShardedRuntime&) = delete;
+    ShardedRuntime& operator=(const ShardedRuntime&) = delete;
+
+    // Setup only: move a symbol to another shard
+    void assign(uint32_t symbol_id, size_t shard) {
+        if (running_) throw std::logic_error("ShardedRuntime: assign() after start()");
+        if (shard >= shards_.size()) throw std::out_of_range("ShardedRuntime: no such shard");
+        routes_.at(symbol_id) = static_cast<uint16_t>(shard);
+    }
+
+    // Gateway first so shards never queue into a stopped gateway; returns
+    // once every shard has built its models
+    void start() {
+        if (running_) return;
+        running_ = true;
+        gateway_.start();
+        reconciler_.start();
+        for (auto& shard : shards_) shard->start();
+        for (auto& shard : shards_) {
+            while (!shard->ready.load(std::memory_order_acquire)) std::this_thread::yield();
+        }
+    }
+
+    // Shards drain their rings, then the gateway sends what they queued
+    void stop() {
+        if (!running_) return;
+        for (auto& shard : shards_) shard->stop();
+        gateway_.stop();
+        reconciler_.stop();
+        running_ = false;
+    }
+
+    // Feed thread (one producer): route a tick to its symbol's shard.
+    // False if the symbol is unknown or the shard is too far behind.
+    bool dispatch(const CompactTick& tick) {
+        if (tick.asset_id >= routes_.size()) [[unlikely]] return false;
+        Shard& shard = *shards_[routes_[tick.asset_id]];
+        if (shard.ticks->push(tick)) [[likely]] return true;
+        shard.dropped.store(shard.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Feed thread: cross-asset reference tick, seen by every shard
+    bool publish_reference(const CompactTick& tick) { return reference_->publish(tick); }
+
+    // Execution-report thread (one producer): fill for the owning shard
+    bool dispatch_fill(uint32_t symbol_id, Side side, uint64_t quantity, double price) {
+        if (symbol_id >= routes_.size()) return false;
+        return shards_[routes_[symbol_id]]->fills->push(ShardFill{symbol_id, side, quantity, price});
+    }
+
+    size_t shard_count() const { return shards_.size(); }
+    size_t symbol_count() const { return routes_.size(); }
+    size_t shard_of(uint32_t symbol_id) const { return routes_.at(symbol_id); }
+
+    ShardStats shard_stats(size_t shard) const {
+        const Shard& s = *shards_.at(shard);
+        ShardStats out;
+        out.ticks = s.tick_count.load(std::memory_order_relaxed);
+        out.fills = s.fill_count.load(std::memory_order_relaxed);
+        out.quotes = s.quote_count.load(std::memory_order_relaxed);
+        out.risk_rejects = s.reject_count.load(std::memory_order_relaxed);
+        out.gateway_full = s.gateway_full.load(std::memory_order_relaxed);
+        out.dropped = s.dropped.load(std::memory_order_relaxed);
+        return out;
+    }
+
+    // Symbol state; only while stopped (the shard thread owns it otherwise)
+    const SymbolModel& model(uint32_t symbol_id) const {
+        if (running_) throw std::logic_error("ShardedRuntime: model() while running");
+        const Shard& s = *shards_[routes_.at(symbol_id)];
+        if (s.models.empty()) throw std::logic_error("ShardedRuntime: shard never started");
+        return s.models[s.slot_of(symbol_id)];
+    }
+
+    RiskEngine& risk() { return risk_; }
+    const StrategyRiskContext& shard_risk(size_t shard) const { return shards_.at(shard)->risk; }
+    const Gateway& gateway() const { return gateway_; }
+
+private:
+    struct Shard {
+        Shard(ShardedRuntime& rt, uint16_t shard_id)
+            : runtime(rt), id(shard_id), config(rt.config_.shards[shard_id]),
+              risk(rt.risk_.add_strategy(rt.config_.shard_limits)),
+              port(rt.gateway_.port(shard_id)),
+              weights(rt.config_.pad_inference_latency),
+              ticks(new TickQueue()), fills(new FillQueue()),
+              reference_reader(rt.reference_->add_reader()) {
+            reference.mid_price = 100.0;
+            reference.bid_price = 99.99;
+            reference.ask_price = 100.01;
+        }
+
+        ~Shard() { stop(); }
+
+        void start() {
+            if (running.exchange(true)) return;
+            ready.store(false, std::memory_order_relaxed);
+            worker = std::thread([this] { run(); });
+        }
+
+        void stop() {
+            if (!running.exchange(false)) return;
+            if (worker.joinable()) worker.join();
+        }
+
+        size_t slot_of(uint32_t symbol_id) const { return slots[symbol_id]; }
+
+        void run() {
+            if (config.cpu_core >= 0) spin_loop::pin_to_cpu(config.cpu_core);
+            if (config.numa_node >= 0) system_determinism::NUMAOptimization::bind_to_numa_node(config.numa_node);
+
+            // Built after pinning: first touch lands on this core's node
+            if (models.empty()) {
+                slots.assign(runtime.routes_.size(), 0);
+                for (size_t s = 0; s < runtime.routes_.size(); ++s) {
+                    if (runtime.routes_[s] != id) continue;
+                    slots[s] = static_cast<uint32_t>(models.size());
+                    models.emplace_back(static_cast<uint32_t>(s), runtime.config_, weights);
+                }
+            }
+            ready.store(true, std::memory_order_release);
+
+            while (running.load(std::memory_order_acquire)) {
+                if (poll() == 0) std::this_thread::yield();
+            }
+            while (poll() != 0) {}
+        }
+
+        size_t poll() {
+            size_t work = runtime.reference_->consume(reference_reader, [this](const CompactTick& t) {
+                to_market_tick(t, reference);
+            });
+            work += fills->consume_all([this](ShardFill& f) {
+                risk.on_fill(f.symbol_id, f.side, f.quantity, f.price);
+                count(fill_count);
+            });
+            work += ticks->consume_all([this](CompactTick& t) { on_tick(t); }, TICK_BURST);
+            return work;
+        }
+
+        void on_tick(const CompactTick& wire) {
+            SymbolModel& m = models[slots[wire.asset_id]];
+            MarketTick& tick = m.tick;
+            if (runtime.config_.depth != nullptr && wire.has_depth()) {
+                to_market_tick(wire, *runtime.config_.depth, tick);
+            } else {
+                to_market_tick(wire, tick);
+                tick.bid_prices[0] = wire.bid_price;
+                tick.ask_prices[0] = wire.ask_price;
+                tick.bid_sizes[0] = wire.bid_size;
+                tick.ask_sizes[0] = wire.ask_size;
+                tick.depth_levels = 1;
+            }
+            count(tick_count);
+
+            if (tick.trade_volume > 0) {
+                m.hawkes.update(TradingEvent(tick.timestamp, tick.trade_side, m.symbol_id));
+            }
+            if (tick.bid_price <= 0.0 || tick.ask_price <= 0.0) return;   // No two-sided book yet
+            runtime.risk_.mark(m.symbol_id, tick.mid_price);
+
+            const auto features = m.inference.extract_features(tick, reference, m.hawkes.get_buy_intensity(),
+                                                               m.hawkes.get_sell_intensity());
+            const auto prediction = m.inference.predict(features);
+            m.signal = prediction[0] - prediction[2];
+
+            const double latency_cost = m.strategy.calculate_latency_cost(runtime.config_.volatility,
+                                                                          tick.mid_price);
+            const QuotePair quotes = m.strategy.calculate_quotes(tick.mid_price, risk.position(m.symbol_id),
+                                                                 runtime.config_.time_horizon, latency_cost);
+            if (quotes.bid_price <= 0.0 || quotes.ask_price <= 0.0) return;
+            if (!m.strategy.should_quote(quotes.spread, latency_cost)) return;
+
+            requote(m, Side::BUY, quotes.bid_price, quotes.bid_size, m.bid_order_id, m.bid_price);
+            requote(m, Side::SELL, quotes.ask_price, quotes.ask_size, m.ask_order_id, m.ask_price);
+        }
+
+        // One intent per side, and only when the price moves: a resting
+        // order is cancel/replaced rather than pulled and re-sent
+        void requote(SymbolModel& m, Side side, double price, double size,
+                     uint64_t& live_order_id, double& live_price) {
+            if (live_order_id != 0 && price == live_price) return;
+
+            const Order order(0, m.symbol_id, side, price, static_cast<uint64_t>(size));
+            if (!risk.check_pre_trade_limits(order)) {
+                count(reject_count);
+                return;
+            }
+
+            const uint64_t id = live_order_id == 0 ?
+                port.send_limit(m.symbol_id, side, price, size) :
+                port.replace(m.symbol_id, live_order_id, side, price, size);
+            if (id == 0) {
+                count(gateway_full);
+                return;
+            }
+            live_order_id = id;
+            live_price = price;
+            count(quote_count);
+        }
+
+        // Owner-thread counters, readable from anywhere
+        static void count(std::atomic<uint64_t>& counter) {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        ShardedRuntime& runtime;
+        const uint16_t id;
+        const ShardConfig config;
+        StrategyRiskContext& risk;
+        typename Gateway::StrategyPort port;
+        const FPGA_DNN_Inference weights;     // Copied into each SymbolModel, never run
+
+        std::unique_ptr<TickQueue> ticks;
+        std::unique_ptr<FillQueue> fills;
+        const int reference_reader;
+        MarketTick reference;
+
+        std::vector<SymbolModel> models;      // Shard thread only
+        std::vector<uint32_t> slots;          // symbol -> models index
+
+        std::thread worker;
+        std::atomic<bool> running{false};
+        std::atomic<bool> ready{false};
+
+        alignas(64) std::atomic<uint64_t> tick_count{0};
+        std::atomic<uint64_t> fill_count{0};
+        std::atomic<uint64_t> quote_count{0};
+        std::atomic<uint64_t> reject_count{0};
+        std::atomic<uint64_t> gateway_full{0};
+        alignas(64) std::atomic<uint64_t> dropped{0};   // Feed thread
+    };
+
+    const RuntimeConfig config_;
+    std::vector<uint16_t> routes_;                    // symbol -> shard
+    RiskEngine risk_;
+    RiskReconciler reconciler_;
+    Gateway gateway_;
+    std::unique_ptr<BroadcastRing<CompactTick, REFERENCE_RING_SIZE, MAX_SHARDS>> reference_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    bool running_ = false;
+};
+
+} // namespace runtime
+} // namespace hft
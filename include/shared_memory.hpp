@@ -1,14 +1,23 @@
 #pragma once
 
 #include "common_types.hpp"
+#include "compact_tick.hpp"
+#include "system_determinism.hpp"
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <csignal>
 #include <cstring>
 #include <string>
+#include <type_traits>
 #include <atomic>
+#include <stdexcept>
 #include <thread>
+#include <vector>
 
 namespace hft {
 namespace shm {
@@ -16,28 +25,52 @@ namespace shm {
 // ====
 // Shared Memory Ring Buffer for IPC (C++/Rust interop)
 // Zero-copy communication between processes/languages
+//
+// RingHeader is the wire layout both sides map: src/lib.rs declares the
+// same struct as #[repr(C)] and asserts the same offsets, so a C++ and a
+// Rust process can each produce into or consume from one segment. Slots
+// start at RING_DATA_OFFSET; write_seq/read_seq are free-running counts
+// (slot = seq & (capacity - 1)) on their own cache lines.
 // ====
 
-template<typename T, size_t Capacity>
-struct alignas(64) SharedMemoryHeader {
-    std::atomic<uint64_t> write_seq;
-    std::atomic<uint64_t> read_seq;
-    std::atomic<bool> is_initialized;
+constexpr uint64_t RING_MAGIC = 0x474E4952534D4854ULL;   // "THMSRING"
+constexpr uint32_t RING_VERSION = 1;
+
+struct alignas(64) RingHeader {
+    uint64_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> is_initialized;
     uint64_t capacity;
     uint64_t element_size;
     char name[64];
-    
-    SharedMemoryHeader() 
-        : write_seq(0), read_seq(0), is_initialized(false), 
-          capacity(Capacity), element_size(sizeof(T)) {
+
+    alignas(64) std::atomic<uint64_t> write_seq;     // Producer
+    alignas(64) std::atomic<uint64_t> read_seq;      // Consumer
+
+    RingHeader(uint64_t slots, uint64_t slot_size)
+        : magic(RING_MAGIC), version(RING_VERSION), is_initialized(0),
+          capacity(slots), element_size(slot_size), write_seq(0), read_seq(0) {
         std::memset(name, 0, sizeof(name));
     }
 };
 
+static_assert(std::is_standard_layout_v<RingHeader>, "RingHeader is shared with Rust");
+static_assert(sizeof(std::atomic<uint64_t>) == 8 && sizeof(std::atomic<uint32_t>) == 4,
+              "atomics must be plain integers in shared memory");
+static_assert(offsetof(RingHeader, capacity) == 16, "RingHeader layout (see src/lib.rs)");
+static_assert(offsetof(RingHeader, name) == 32, "RingHeader layout (see src/lib.rs)");
+static_assert(offsetof(RingHeader, write_seq) == 128, "RingHeader layout (see src/lib.rs)");
+static_assert(offsetof(RingHeader, read_seq) == 192, "RingHeader layout (see src/lib.rs)");
+static_assert(sizeof(RingHeader) == 256, "RingHeader layout (see src/lib.rs)");
+
+constexpr size_t RING_DATA_OFFSET = sizeof(RingHeader);
+
 template<typename T, size_t Capacity>
 class SharedMemoryRingBuffer {
     static_assert((Capacity & (Capacity - 1)) == 0, 
                   "Capacity must be power of 2");
+    static_assert(std::is_trivially_copyable_v<T>, "Ring slots are copied across processes");
+    static_assert(RING_DATA_OFFSET % alignof(T) == 0, "Slots must stay aligned");
     
 public:
     // 
@@ -47,8 +80,7 @@ public:
         : fd_(-1), mapped_region_(nullptr), total_size_(0) {
         
         const std::string shm_path = "/dev/shm/" + segment_name;
-        total_size_ = sizeof(SharedMemoryHeader<T, Capacity>) + 
-                      sizeof(T) * Capacity + 
+        total_size_ = RING_DATA_OFFSET + sizeof(T) * Capacity +
                       4096; // Extra guard page
         
         if (create) {
@@ -98,21 +130,28 @@ public:
         mlock(mapped_region_, total_size_);
         
         // Setup pointers
-        header_ = reinterpret_cast<SharedMemoryHeader<T, Capacity>*>(mapped_region_);
+        header_ = reinterpret_cast<RingHeader*>(mapped_region_);
         buffer_ = reinterpret_cast<T*>(
-            reinterpret_cast<char*>(mapped_region_) + 
-            sizeof(SharedMemoryHeader<T, Capacity>));
+            reinterpret_cast<char*>(mapped_region_) + RING_DATA_OFFSET);
         
         if (create) {
-            new (header_) SharedMemoryHeader<T, Capacity>();
+            new (header_) RingHeader(Capacity, sizeof(T));
             std::strncpy(header_->name, segment_name.c_str(), 
                         sizeof(header_->name) - 1);
-            header_->is_initialized.store(true, std::memory_order_release);
+            header_->is_initialized.store(1, std::memory_order_release);
         } else {
             // Wait for initialization
             while (!header_->is_initialized.load(std::memory_order_acquire)) {
                 std::this_thread::yield();
             }
+            if (header_->magic != RING_MAGIC || header_->version != RING_VERSION ||
+                header_->capacity != Capacity || header_->element_size != sizeof(T)) {
+                munmap(mapped_region_, total_size_);
+                mapped_region_ = nullptr;
+                close(fd_);
+                fd_ = -1;
+                throw std::runtime_error("Shared memory ring layout mismatch: " + segment_name);
+            }
         }
         
         segment_name_ = segment_name;
@@ -170,6 +209,53 @@ public:
         return true;
     }
     
+    // 
+    // Producer: burst write, one write_seq publication per batch.
+    // Returns number written (stops early if full).
+    // 
+    size_t write_bulk(const T* items, size_t count) {
+        const uint64_t current_write = header_->write_seq.load(std::memory_order_relaxed);
+        
+        if (current_write + count - cached_read_seq_ > Capacity) {
+            cached_read_seq_ = header_->read_seq.load(std::memory_order_acquire);
+        }
+        
+        const uint64_t free_slots = Capacity - (current_write - cached_read_seq_);
+        const size_t n = count < free_slots ? count : static_cast<size_t>(free_slots);
+        
+        for (size_t i = 0; i < n; ++i) {
+            buffer_[(current_write + i) & (Capacity - 1)] = items[i];
+        }
+        
+        if (n > 0) {
+            header_->write_seq.store(current_write + n, std::memory_order_release);
+        }
+        return n;
+    }
+    
+    // 
+    // Consumer: burst read, one read_seq publication per batch.
+    // 
+    size_t read_bulk(T* items, size_t max_items) {
+        const uint64_t current_read = header_->read_seq.load(std::memory_order_relaxed);
+        
+        if (cached_write_seq_ < current_read || cached_write_seq_ - current_read < max_items) {
+            cached_write_seq_ = header_->write_seq.load(std::memory_order_acquire);
+        }
+        
+        const uint64_t available = cached_write_seq_ - current_read;
+        const size_t n = max_items < available ? max_items : static_cast<size_t>(available);
+        
+        for (size_t i = 0; i < n; ++i) {
+            items[i] = buffer_[(current_read + i) & (Capacity - 1)];
+        }
+        
+        if (n > 0) {
+            header_->read_seq.store(current_read + n, std::memory_order_release);
+        }
+        return n;
+    }
+    
     // 
     // Status
     // 
@@ -187,13 +273,20 @@ public:
         return size() >= Capacity;
     }
     
+    // Start of the mapping (RingHeader, then slots), e.g. to hand to Rust
+    void* region() const { return mapped_region_; }
+    
 private:
     int fd_;
     void* mapped_region_;
     size_t total_size_;
-    SharedMemoryHeader<T, Capacity>* header_;
+    RingHeader* header_;
     T* buffer_;
     std::string segment_name_;
+    
+    // Process-local copies of the peer's index (refreshed only when needed)
+    uint64_t cached_read_seq_ = 0;   // Producer side
+    uint64_t cached_write_seq_ = 0;  // Consumer side
 };
 
 // ====
@@ -203,5 +296,311 @@ private:
 
 using SharedMarketDataQueue = SharedMemoryRingBuffer<MarketTick, 32768>;
 
+// ====
+// Multi-Subscriber Shared Memory Bus
+// One publisher process, up to MaxSubscribers consumer processes, all
+// reading the same ring: each tick is written once, whatever the fan-out.
+//
+// The publisher never waits for consumers. Each subscriber has its own
+// cursor on its own cache line; one that falls more than Capacity behind
+// skips to the oldest live entry and counts the gap in lost(). Entries are
+// copied out and validated against the publisher's claim sequence
+// (seqlock-style), so a consumer never returns a slot that was being
+// overwritten while it copied.
+// ====
+
+namespace bus_detail {
+
+constexpr uint64_t MAGIC = 0x5355424D485354ULL;   // "TSHMBUS"
+constexpr uint32_t FREE = 0;
+constexpr uint32_t ACTIVE = 1;
+
+struct alignas(64) SubscriberSlot {
+    std::atomic<uint64_t> read_seq;
+    std::atomic<uint64_t> lost;
+    std::atomic<uint32_t> state;
+    int32_t pid;
+    char name[40];
+};
+static_assert(sizeof(SubscriberSlot) == 64, "one cache line per subscriber");
+
+template<size_t MaxSubscribers>
+struct alignas(64) BusHeader {
+    uint64_t magic;
+    uint64_t capacity;
+    uint64_t element_size;
+    uint64_t max_subscribers;
+    std::atomic<bool> is_initialized;
+    char name[64];
+
+    alignas(64) std::atomic<uint64_t> write_claim;  // Slots up to here may be mid-write
+    alignas(64) std::atomic<uint64_t> write_seq;    // Slots below here are complete
+    SubscriberSlot subscribers[MaxSubscribers];
+};
+
+} // namespace bus_detail
+
+template<typename T, size_t Capacity, size_t MaxSubscribers = 8>
+class ShmBus {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be power of 2");
+    static_assert(std::is_trivially_copyable_v<T>, "Bus payload must be trivially copyable");
+
+    using Header = bus_detail::BusHeader<MaxSubscribers>;
+
+public:
+    // Per-process consumer handle; frees its slot on destruction
+    class Subscriber {
+    public:
+        Subscriber(ShmBus& bus, const std::string& name) : bus_(&bus) {
+            Header* h = bus.header_;
+            for (size_t i = 0; i < MaxSubscribers; ++i) {
+                uint32_t expected = bus_detail::FREE;
+                if (h->subscribers[i].state.compare_exchange_strong(expected, bus_detail::ACTIVE,
+                                                                    std::memory_order_acq_rel)) {
+                    slot_ = &h->subscribers[i];
+                    break;
+                }
+            }
+            if (!slot_) {
+                throw std::runtime_error("Shared memory bus has no free subscriber slot: " + bus.segment_name_);
+            }
+            slot_->pid = static_cast<int32_t>(::getpid());
+            std::memset(slot_->name, 0, sizeof(slot_->name));
+            std::strncpy(slot_->name, name.c_str(), sizeof(slot_->name) - 1);
+            slot_->lost.store(0, std::memory_order_relaxed);
+            cursor_ = h->write_seq.load(std::memory_order_acquire);   // Join at the live head
+            slot_->read_seq.store(cursor_, std::memory_order_release);
+        }
+
+        ~Subscriber() {
+            if (slot_) slot_->state.store(bus_detail::FREE, std::memory_order_release);
+        }
+
+        Subscriber(const Subscriber&) = delete;
+        Subscriber& operator=(const Subscriber&) = delete;
+
+        // Copies up to max_items new entries into items; never blocks
+        size_t consume(T* items, size_t max_items) {
+            const Header* h = bus_->header_;
+            const uint64_t write = h->write_seq.load(std::memory_order_acquire);
+            if (write - cursor_ > Capacity) {
+                skip(write - Capacity - cursor_);
+            }
+
+            const size_t n = static_cast<size_t>(std::min<uint64_t>(max_items, write - cursor_));
+            for (size_t i = 0; i < n; ++i) {
+                std::memcpy(static_cast<void*>(&items[i]), &bus_->buffer_[(cursor_ + i) & (Capacity - 1)], sizeof(T));
+            }
+
+            // Anything the publisher has claimed since may have been overwritten
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t claim = h->write_claim.load(std::memory_order_relaxed);
+            size_t torn = 0;
+            if (claim > cursor_ + Capacity) {
+                torn = static_cast<size_t>(std::min<uint64_t>(n, claim - Capacity - cursor_));
+                std::memmove(static_cast<void*>(items), items + torn, (n - torn) * sizeof(T));
+                skip(torn);
+            }
+
+            cursor_ += n - torn;
+            slot_->read_seq.store(cursor_, std::memory_order_release);
+            return n - torn;
+        }
+
+        bool consume_one(T& item) { return consume(&item, 1) == 1; }
+
+        uint64_t lag() const { return bus_->published() - cursor_; }
+        uint64_t lost() const { return slot_->lost.load(std::memory_order_relaxed); }
+
+    private:
+        void skip(uint64_t count) {
+            cursor_ += count;
+            slot_->lost.store(slot_->lost.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        }
+
+        ShmBus* bus_;
+        bus_detail::SubscriberSlot* slot_ = nullptr;
+        uint64_t cursor_ = 0;
+    };
+
+    struct SubscriberInfo {
+        std::string name;
+        int32_t pid;
+        uint64_t lag;
+        uint64_t lost;
+    };
+
+    /**
+     * @param create     Publisher side: create (or recreate) the segment
+     * @param huge_pages Back the segment with a hugetlbfs file when huge
+     *                   pages are configured (falls back to /dev/shm)
+     */
+    explicit ShmBus(const std::string& segment_name, bool create = true, bool huge_pages = false)
+        : segment_name_(segment_name) {
+        const size_t page = huge_pages ? static_cast<size_t>(system_determinism::HugePages::Size::HUGE_2MB) : 4096;
+        const size_t raw = data_offset() + sizeof(T) * Capacity;
+        total_size_ = (raw + page - 1) / page * page;
+
+        if (create) {
+            if (huge_pages && system_determinism::HugePages::are_huge_pages_available()) {
+                fd_ = open_huge(O_CREAT | O_RDWR | O_TRUNC);
+            }
+            if (fd_ == -1) {
+                total_size_ = (raw + 4095) / 4096 * 4096;
+                shm_unlink(segment_name.c_str());
+                fd_ = shm_open(segment_name.c_str(), O_CREAT | O_RDWR | O_EXCL, 0666);
+            }
+            if (fd_ == -1) {
+                throw std::runtime_error("Failed to create shared memory bus: " + segment_name);
+            }
+            if (ftruncate(fd_, static_cast<off_t>(total_size_)) == -1) {
+                close(fd_);
+                throw std::runtime_error("Failed to size shared memory bus: " + segment_name);
+            }
+        } else {
+            fd_ = shm_open(segment_name.c_str(), O_RDWR, 0666);
+            if (fd_ == -1) fd_ = open_huge(O_RDWR);
+            if (fd_ == -1) {
+                throw std::runtime_error("Failed to open shared memory bus: " + segment_name);
+            }
+            struct stat st;
+            if (fstat(fd_, &st) != 0 || static_cast<size_t>(st.st_size) < raw) {
+                close(fd_);
+                throw std::runtime_error("Shared memory bus too small: " + segment_name);
+            }
+            total_size_ = static_cast<size_t>(st.st_size);
+        }
+
+        mapped_region_ = mmap(nullptr, total_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (mapped_region_ == MAP_FAILED) {
+            close(fd_);
+            throw std::runtime_error("Failed to map shared memory bus: " + segment_name);
+        }
+        mlock(mapped_region_, total_size_);
+
+        header_ = reinterpret_cast<Header*>(mapped_region_);
+        buffer_ = reinterpret_cast<T*>(static_cast<char*>(mapped_region_) + data_offset());
+
+        if (create) {
+            new (header_) Header();
+            header_->magic = bus_detail::MAGIC;
+            header_->capacity = Capacity;
+            header_->element_size = sizeof(T);
+            header_->max_subscribers = MaxSubscribers;
+            std::strncpy(header_->name, segment_name.c_str(), sizeof(header_->name) - 1);
+            header_->write_claim.store(0, std::memory_order_relaxed);
+            header_->write_seq.store(0, std::memory_order_relaxed);
+            for (auto& sub : header_->subscribers) {
+                sub.state.store(bus_detail::FREE, std::memory_order_relaxed);
+            }
+            header_->is_initialized.store(true, std::memory_order_release);
+        } else {
+            while (!header_->is_initialized.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            if (header_->magic != bus_detail::MAGIC || header_->capacity != Capacity ||
+                header_->element_size != sizeof(T) || header_->max_subscribers != MaxSubscribers) {
+                munlock(mapped_region_, total_size_);
+                munmap(mapped_region_, total_size_);
+                mapped_region_ = nullptr;
+                close(fd_);
+                fd_ = -1;
+                throw std::runtime_error("Shared memory bus layout mismatch: " + segment_name);
+            }
+        }
+    }
+
+    ~ShmBus() {
+        if (mapped_region_ && mapped_region_ != MAP_FAILED) {
+            munlock(mapped_region_, total_size_);
+            munmap(mapped_region_, total_size_);
+        }
+        if (fd_ != -1) {
+            close(fd_);
+        }
+    }
+
+    ShmBus(const ShmBus&) = delete;
+    ShmBus& operator=(const ShmBus&) = delete;
+
+    // Removes the segment from /dev/shm (and hugetlbfs); mappings stay valid
+    static void unlink(const std::string& segment_name) {
+        shm_unlink(segment_name.c_str());
+        ::unlink(huge_path(segment_name).c_str());
+    }
+
+    // 
+    // Publisher (one thread in one process)
+    // 
+    void publish(const T& item) { publish_bulk(&item, 1); }
+
+    // One claim and one publication per batch; never blocks
+    void publish_bulk(const T* items, size_t count) {
+        const uint64_t write = header_->write_seq.load(std::memory_order_relaxed);
+        header_->write_claim.store(write + count, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < count; ++i) {
+            std::memcpy(static_cast<void*>(&buffer_[(write + i) & (Capacity - 1)]), &items[i], sizeof(T));
+        }
+        header_->write_seq.store(write + count, std::memory_order_release);
+    }
+
+    uint64_t published() const { return header_->write_seq.load(std::memory_order_acquire); }
+
+    Subscriber subscribe(const std::string& name) { return Subscriber(*this, name); }
+
+    // Slow-consumer detection for the publisher or a supervisor
+    std::vector<SubscriberInfo> subscribers() const {
+        std::vector<SubscriberInfo> out;
+        const uint64_t write = published();
+        for (const auto& sub : header_->subscribers) {
+            if (sub.state.load(std::memory_order_acquire) != bus_detail::ACTIVE) continue;
+            const uint64_t read = sub.read_seq.load(std::memory_order_acquire);
+            out.push_back({std::string(sub.name, strnlen(sub.name, sizeof(sub.name))), sub.pid,
+                           write > read ? write - read : 0, sub.lost.load(std::memory_order_relaxed)});
+        }
+        return out;
+    }
+
+    // Frees slots whose owning process has exited without unsubscribing
+    size_t reap_dead_subscribers() {
+        size_t reaped = 0;
+        for (auto& sub : header_->subscribers) {
+            if (sub.state.load(std::memory_order_acquire) == bus_detail::ACTIVE &&
+                ::kill(sub.pid, 0) == -1 && errno == ESRCH) {
+                sub.state.store(bus_detail::FREE, std::memory_order_release);
+                ++reaped;
+            }
+        }
+        return reaped;
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    static constexpr size_t data_offset() {
+        return (sizeof(Header) + 63) / 64 * 64;
+    }
+
+    static std::string huge_path(const std::string& segment_name) {
+        return "/dev/hugepages/" + segment_name;
+    }
+
+    int open_huge(int flags) const {
+        return ::open(huge_path(segment_name_).c_str(), flags, 0666);
+    }
+
+    int fd_ = -1;
+    void* mapped_region_ = nullptr;
+    size_t total_size_ = 0;
+    Header* header_ = nullptr;
+    T* buffer_ = nullptr;
+    std::string segment_name_;
+};
+
+// BBO stream; depth stays with the publisher (see compact_tick.hpp)
+using MarketDataBus = ShmBus<CompactTick, 32768, 8>;
+
 } // namespace shm
 } // namespace hft
@@ -0,0 +1,531 @@
+#pragma once
+
+#include "fast_math.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+    #define HFT_SIMD_X86 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define HFT_SIMD_NEON 1
+#endif
+
+// Compile one function for a wider ISA than the build baseline
+#if defined(__GNUC__) || defined(__clang__)
+    #define HFT_SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define HFT_SIMD_TARGET(isa)
+#endif
+
+namespace hft {
+namespace simd {
+
+// ====
+// Runtime ISA Dispatch
+// The feature and inference kernels are compiled once per instruction set
+// (function-level target attributes, so the build baseline can stay
+// portable) and one variant is picked from CPUID the first time kernels()
+// is called. Every variant computes the same result up to floating-point
+// reassociation. HFT_ISA=scalar|sse2|avx2|avx512|neon in the environment
+// forces a variant when this CPU supports it.
+// ====
+
+enum class IsaLevel : uint8_t {
+    SCALAR,
+    SSE2,       // x86-64 baseline
+    AVX2,       // AVX2 + FMA
+    AVX512,     // AVX-512F
+    NEON        // AArch64 baseline
+};
+
+inline const char* isa_name(IsaLevel level) {
+    switch (level) {
+        case IsaLevel::SCALAR: return "scalar";
+        case IsaLevel::SSE2:   return "sse2";
+        case IsaLevel::AVX2:   return "avx2";
+        case IsaLevel::AVX512: return "avx512";
+        case IsaLevel::NEON:   return "neon";
+    }
+    return "unknown";
+}
+
+inline bool isa_from_name(const char* name, IsaLevel& level) {
+    for (IsaLevel l : {IsaLevel::SCALAR, IsaLevel::SSE2, IsaLevel::AVX2, IsaLevel::AVX512, IsaLevel::NEON}) {
+        if (std::strcmp(name, isa_name(l)) == 0) {
+            level = l;
+            return true;
+        }
+    }
+    return false;
+}
+
+// True when this build has the variant and this CPU can run it
+inline bool isa_supported(IsaLevel level) {
+    switch (level) {
+        case IsaLevel::SCALAR:
+            return true;
+#if defined(HFT_SIMD_X86)
+        case IsaLevel::SSE2:
+            return true;
+    #if defined(__GNUC__) || defined(__clang__)
+        // Also checks the OS saves the wider register state (XCR0)
+        case IsaLevel::AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case IsaLevel::AVX512:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx512f");
+    #else
+        // No runtime query: trust the compile-time baseline
+        #if defined(__AVX512F__)
+        case IsaLevel::AVX512:
+        #endif
+        #if defined(__AVX2__)
+        case IsaLevel::AVX2:
+            return true;
+        #endif
+    #endif
+#elif defined(HFT_SIMD_NEON)
+        case IsaLevel::NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+// Widest variant this CPU runs, widest first
+inline std::vector<IsaLevel> supported_isas() {
+    std::vector<IsaLevel> levels;
+    for (IsaLevel l : {IsaLevel::AVX512, IsaLevel::AVX2, IsaLevel::NEON, IsaLevel::SSE2, IsaLevel::SCALAR}) {
+        if (isa_supported(l)) levels.push_back(l);
+    }
+    return levels;
+}
+
+// ====
+// Kernels (the same six entry points per ISA)
+//   subtract:          out[i] = a[i] - b[i]
+//   sum_difference:    sum(a[i] - b[i])
+//   volume_imbalance:  (sum(bid) - sum(ask)) / (sum(bid) + sum(ask)), 0 when empty
+//   normalize:         x[i] = (x[i] - mean[i]) / stddev[i]
+//   dense:             out[r] = dot(w[r * cols ..], x) + bias[r] (row-major w)
+//   tanh:              x[i] = tanh(x[i]) (fast_math polynomial)
+// ====
+
+namespace scalar {
+
+inline void subtract(const double* a, const double* b, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = a[i] - b[i];
+}
+
+inline double sum_difference(const double* a, const double* b, size_t n) {
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) total += a[i] - b[i];
+    return total;
+}
+
+inline double volume_imbalance(const double* bid, const double* ask, size_t n) {
+    double total_bid = 0.0, total_ask = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        total_bid += bid[i];
+        total_ask += ask[i];
+    }
+    const double total = total_bid + total_ask;
+    return (total > 0.0) ? (total_bid - total_ask) / total : 0.0;
+}
+
+inline void normalize(double* x, const double* mean, const double* stddev, size_t n) {
+    for (size_t i = 0; i < n; ++i) x[i] = (x[i] - mean[i]) / stddev[i];
+}
+
+inline void dense(const double* w, const double* x, const double* bias, double* out, size_t rows, size_t cols) {
+    for (size_t r = 0; r < rows; ++r) {
+        const double* row = w + r * cols;
+        double sum = bias[r];
+        for (size_t c = 0; c < cols; ++c) sum += row[c] * x[c];
+        out[r] = sum;
+    }
+}
+
+inline void tanh(double* x, size_t n) {
+    for (size_t i = 0; i < n; ++i) x[i] = fast_math::tanh(x[i]);
+}
+
+} // namespace scalar
+
+#if defined(HFT_SIMD_X86)
+
+namespace sse2 {
+
+inline double hsum(__m128d v) {
+    return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+inline void subtract(const double* a, const double* b, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(out + i, _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    }
+    for (; i < n; ++i) out[i] = a[i] - b[i];
+}
+
+inline double sum_difference(const double* a, const double* b, size_t n) {
+    __m128d sum = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        sum = _mm_add_pd(sum, _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    }
+    double total = hsum(sum);
+    for (; i < n; ++i) total += a[i] - b[i];
+    return total;
+}
+
+inline double volume_imbalance(const double* bid, const double* ask, size_t n) {
+    __m128d bid_sum = _mm_setzero_pd();
+    __m128d ask_sum = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        bid_sum = _mm_add_pd(bid_sum, _mm_loadu_pd(bid + i));
+        ask_sum = _mm_add_pd(ask_sum, _mm_loadu_pd(ask + i));
+    }
+    double total_bid = hsum(bid_sum), total_ask = hsum(ask_sum);
+    for (; i < n; ++i) {
+        total_bid += bid[i];
+        total_ask += ask[i];
+    }
+    const double total = total_bid + total_ask;
+    return (total > 0.0) ? (total_bid - total_ask) / total : 0.0;
+}
+
+inline void normalize(double* x, const double* mean, const double* stddev, size_t n) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const __m128d centered = _mm_sub_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(mean + i));
+        _mm_storeu_pd(x + i, _mm_div_pd(centered, _mm_loadu_pd(stddev + i)));
+    }
+    for (; i < n; ++i) x[i] = (x[i] - mean[i]) / stddev[i];
+}
+
+inline void dense(const double* w, const double* x, const double* bias, double* out, size_t rows, size_t cols) {
+    for (size_t r = 0; r < rows; ++r) {
+        const double* row = w + r * cols;
+        __m128d sum = _mm_setzero_pd();
+        size_t c = 0;
+        for (; c + 2 <= cols; c += 2) {
+            sum = _mm_add_pd(sum, _mm_mul_pd(_mm_loadu_pd(row + c), _mm_loadu_pd(x + c)));
+        }
+        double result = hsum(sum);
+        for (; c < cols; ++c) result += row[c] * x[c];
+        out[r] = result + bias[r];
+    }
+}
+
+inline void tanh(double* x, size_t n) { scalar::tanh(x, n); }
+
+} // namespace sse2
+
+namespace avx2 {
+
+HFT_SIMD_TARGET("avx2,fma") inline double hsum(__m256d v) {
+    const __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+HFT_SIMD_TARGET("avx2,fma") inline void subtract(const double* a, const double* b, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+    for (; i < n; ++i) out[i] = a[i] - b[i];
+}
+
+HFT_SIMD_TARGET("avx2,fma") inline double sum_difference(const double* a, const double* b, size_t n) {
+    __m256d sum = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        sum = _mm256_add_pd(sum, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+    double total = hsum(sum);
+    for (; i < n; ++i) total += a[i] - b[i];
+    return total;
+}
+
+HFT_SIMD_TARGET("avx2,fma") inline double volume_imbalance(const double* bid, const double* ask, size_t n) {
+    __m256d bid_sum = _mm256_setzero_pd();
+    __m256d ask_sum = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        bid_sum = _mm256_add_pd(bid_sum, _mm256_loadu_pd(bid + i));
+        ask_sum = _mm256_add_pd(ask_sum, _mm256_loadu_pd(ask + i));
+    }
+    double total_bid = hsum(bid_sum), total_ask = hsum(ask_sum);
+    for (; i < n; ++i) {
+        total_bid += bid[i];
+        total_ask += ask[i];
+    }
+    const double total = total_bid + total_ask;
+    return (total > 0.0) ? (total_bid - total_ask) / total : 0.0;
+}
+
+HFT_SIMD_TARGET("avx2,fma") inline void normalize(double* x, const double* mean, const double* stddev, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d centered = _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(mean + i));
+        _mm256_storeu_pd(x + i, _mm256_div_pd(centered, _mm256_loadu_pd(stddev + i)));
+    }
+    for (; i < n; ++i) x[i] = (x[i] - mean[i]) / stddev[i];
+}
+
+HFT_SIMD_TARGET("avx2,fma") inline void dense(const double* w, const double* x, const double* bias,
+                                             double* out, size_t rows, size_t cols) {
+    for (size_t r = 0; r < rows; ++r) {
+        const double* row = w + r * cols;
+        __m256d sum = _mm256_setzero_pd();
+        size_t c = 0;
+        for (; c + 4 <= cols; c += 4) {
+            sum = _mm256_fmadd_pd(_mm256_loadu_pd(row + c), _mm256_loadu_pd(x + c), sum);
+        }
+        double result = hsum(sum);
+        for (; c < cols; ++c) result += row[c] * x[c];
+        out[r] = result + bias[r];
+    }
+}
+
+HFT_SIMD_TARGET("avx2,fma") inline void tanh(double* x, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm256_storeu_pd(x + i, fast_math::tanh4(_mm256_loadu_pd(x + i)));
+    for (; i < n; ++i) x[i] = fast_math::tanh(x[i]);
+}
+
+} // namespace avx2
+
+// Tails use masked loads/stores instead of a scalar loop
+namespace avx512 {
+
+HFT_SIMD_TARGET("avx512f") inline __mmask8 tail_mask(size_t remaining) {
+    return static_cast<__mmask8>((1u << remaining) - 1u);
+}
+
+HFT_SIMD_TARGET("avx512f") inline void subtract(const double* a, const double* b, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(out + i, _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    }
+    if (i < n) {
+        const __mmask8 m = tail_mask(n - i);
+        _mm512_mask_storeu_pd(out + i, m, _mm512_sub_pd(_mm512_maskz_loadu_pd(m, a + i),
+                                                        _mm512_maskz_loadu_pd(m, b + i)));
+    }
+}
+
+HFT_SIMD_TARGET("avx512f") inline double sum_difference(const double* a, const double* b, size_t n) {
+    __m512d sum = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        sum = _mm512_add_pd(sum, _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    }
+    if (i < n) {
+        const __mmask8 m = tail_mask(n - i);
+        sum = _mm512_add_pd(sum, _mm512_sub_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i)));
+    }
+    return _mm512_reduce_add_pd(sum);
+}
+
+HFT_SIMD_TARGET("avx512f") inline double volume_imbalance(const double* bid, const double* ask, size_t n) {
+    __m512d bid_sum = _mm512_setzero_pd();
+    __m512d ask_sum = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        bid_sum = _mm512_add_pd(bid_sum, _mm512_loadu_pd(bid + i));
+        ask_sum = _mm512_add_pd(ask_sum, _mm512_loadu_pd(ask + i));
+    }
+    if (i < n) {
+        const __mmask8 m = tail_mask(n - i);
+        bid_sum = _mm512_add_pd(bid_sum, _mm512_maskz_loadu_pd(m, bid + i));
+        ask_sum = _mm512_add_pd(ask_sum, _mm512_maskz_loadu_pd(m, ask + i));
+    }
+    const double total_bid = _mm512_reduce_add_pd(bid_sum);
+    const double total_ask = _mm512_reduce_add_pd(ask_sum);
+    const double total = total_bid + total_ask;
+    return (total > 0.0) ? (total_bid - total_ask) / total : 0.0;
+}
+
+HFT_SIMD_TARGET("avx512f") inline void normalize(double* x, const double* mean, const double* stddev, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m512d centered = _mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(mean + i));
+        _mm512_storeu_pd(x + i, _mm512_div_pd(centered, _mm512_loadu_pd(stddev + i)));
+    }
+    if (i < n) {
+        const __mmask8 m = tail_mask(n - i);
+        const __m512d centered = _mm512_sub_pd(_mm512_maskz_loadu_pd(m, x + i), _mm512_maskz_loadu_pd(m, mean + i));
+        // Masked-off lanes divide by 1 rather than 0
+        const __m512d scale = _mm512_mask_loadu_pd(_mm512_set1_pd(1.0), m, stddev + i);
+        _mm512_mask_storeu_pd(x + i, m, _mm512_div_pd(centered, scale));
+    }
+}
+
+HFT_SIMD_TARGET("avx512f") inline void dense(const double* w, const double* x, const double* bias,
+                                            double* out, size_t rows, size_t cols) {
+    for (size_t r = 0; r < rows; ++r) {
+        const double* row = w + r * cols;
+        __m512d sum = _mm512_setzero_pd();
+        size_t c = 0;
+        for (; c + 8 <= cols; c += 8) {
+            sum = _mm512_fmadd_pd(_mm512_loadu_pd(row + c), _mm512_loadu_pd(x + c), sum);
+        }
+        if (c < cols) {
+            const __mmask8 m = tail_mask(cols - c);
+            sum = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m, row + c), _mm512_maskz_loadu_pd(m, x + c), sum);
+        }
+        out[r] = _mm512_reduce_add_pd(sum) + bias[r];
+    }
+}
+
+HFT_SIMD_TARGET("avx512f") inline void tanh(double* x, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm512_storeu_pd(x + i, fast_math::tanh8(_mm512_loadu_pd(x + i)));
+    if (i < n) {
+        const __mmask8 m = tail_mask(n - i);
+        _mm512_mask_storeu_pd(x + i, m, fast_math::tanh8(_mm512_maskz_loadu_pd(m, x + i)));
+    }
+}
+
+} // namespace avx512
+
+#elif defined(HFT_SIMD_NEON)
+
+namespace neon {
+
+inline double hsum(float64x2_t v) { return vgetq_lane_f64(v, 0) + vgetq_lane_f64(v, 1); }
+
+inline void subtract(const double* a, const double* b, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) vst1q_f64(out + i, vsubq_f64(vld1q_f64(a + i), vld1q_f64(b + i)));
+    for (; i < n; ++i) out[i] = a[i] - b[i];
+}
+
+inline double sum_difference(const double* a, const double* b, size_t n) {
+    float64x2_t sum = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) sum = vaddq_f64(sum, vsubq_f64(vld1q_f64(a + i), vld1q_f64(b + i)));
+    double total = hsum(sum);
+    for (; i < n; ++i) total += a[i] - b[i];
+    return total;
+}
+
+inline double volume_imbalance(const double* bid, const double* ask, size_t n) {
+    float64x2_t bid_sum = vdupq_n_f64(0.0);
+    float64x2_t ask_sum = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        bid_sum = vaddq_f64(bid_sum, vld1q_f64(bid + i));
+        ask_sum = vaddq_f64(ask_sum, vld1q_f64(ask + i));
+    }
+    double total_bid = hsum(bid_sum), total_ask = hsum(ask_sum);
+    for (; i < n; ++i) {
+        total_bid += bid[i];
+        total_ask += ask[i];
+    }
+    const double total = total_bid + total_ask;
+    return (total > 0.0) ? (total_bid - total_ask) / total : 0.0;
+}
+
+inline void normalize(double* x, const double* mean, const double* stddev, size_t n) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        vst1q_f64(x + i, vdivq_f64(vsubq_f64(vld1q_f64(x + i), vld1q_f64(mean + i)), vld1q_f64(stddev + i)));
+    }
+    for (; i < n; ++i) x[i] = (x[i] - mean[i]) / stddev[i];
+}
+
+inline void dense(const double* w, const double* x, const double* bias, double* out, size_t rows, size_t cols) {
+    for (size_t r = 0; r < rows; ++r) {
+        const double* row = w + r * cols;
+        float64x2_t sum = vdupq_n_f64(0.0);
+        size_t c = 0;
+        for (; c + 2 <= cols; c += 2) sum = vfmaq_f64(sum, vld1q_f64(row + c), vld1q_f64(x + c));
+        double result = hsum(sum);
+        for (; c < cols; ++c) result += row[c] * x[c];
+        out[r] = result + bias[r];
+    }
+}
+
+inline void tanh(double* x, size_t n) { scalar::tanh(x, n); }
+
+} // namespace neon
+
+#endif
+
+// ====
+// Dispatch Table
+// ====
+
+struct KernelTable {
+    IsaLevel isa;
+    void (*subtract)(const double* a, const double* b, double* out, size_t n);
+    double (*sum_difference)(const double* a, const double* b, size_t n);
+    double (*volume_imbalance)(const double* bid, const double* ask, size_t n);
+    void (*normalize)(double* x, const double* mean, const double* stddev, size_t n);
+    void (*dense)(const double* w, const double* x, const double* bias, double* out, size_t rows, size_t cols);
+    void (*tanh)(double* x, size_t n);
+};
+
+#define HFT_SIMD_KERNELS(level, ns) \
+    KernelTable{level, ns::subtract, ns::sum_difference, ns::volume_imbalance, ns::normalize, ns::dense, ns::tanh}
+
+// Variant for `level` (throws std::invalid_argument when this CPU cannot run it)
+inline const KernelTable& kernels_for(IsaLevel level) {
+    static const KernelTable scalar_table = HFT_SIMD_KERNELS(IsaLevel::SCALAR, scalar);
+#if defined(HFT_SIMD_X86)
+    static const KernelTable sse2_table = HFT_SIMD_KERNELS(IsaLevel::SSE2, sse2);
+    static const KernelTable avx2_table = HFT_SIMD_KERNELS(IsaLevel::AVX2, avx2);
+    static const KernelTable avx512_table = HFT_SIMD_KERNELS(IsaLevel::AVX512, avx512);
+#elif defined(HFT_SIMD_NEON)
+    static const KernelTable neon_table = HFT_SIMD_KERNELS(IsaLevel::NEON, neon);
+#endif
+
+    if (!isa_supported(level)) {
+        throw std::invalid_argument(std::string("ISA not supported on this CPU: ") + isa_name(level));
+    }
+    switch (level) {
+#if defined(HFT_SIMD_X86)
+        case IsaLevel::SSE2:   return sse2_table;
+        case IsaLevel::AVX2:   return avx2_table;
+        case IsaLevel::AVX512: return avx512_table;
+#elif defined(HFT_SIMD_NEON)
+        case IsaLevel::NEON:   return neon_table;
+#endif
+        default:               return scalar_table;
+    }
+}
+
+#undef HFT_SIMD_KERNELS
+
+// Widest supported variant, or HFT_ISA when this CPU supports it
+inline IsaLevel select_isa() {
+    const char* forced = std::getenv("HFT_ISA");
+    IsaLevel level;
+    if (forced && isa_from_name(forced, level) && isa_supported(level)) return level;
+    return supported_isas().front();
+}
+
+// Process-wide variant, chosen once; callers cache the reference
+inline const KernelTable& kernels() {
+    static const KernelTable& table = kernels_for(select_isa());
+    return table;
+}
+
+inline IsaLevel active_isa() { return kernels().isa; }
+
+} // namespace simd
+} // namespace hft
@@ -1,29 +1,12 @@
 #pragma once
 
 #include "common_types.hpp"
+#include "engine_checkpoint.hpp"
+#include "simd_dispatch.hpp"
+#include <algorithm>
 #include <array>
 #include <cmath>
 
-// x86 simd support
-#if defined(__x86_64__) || defined(_M_X64)
-    #include <immintrin.h>
-    #if defined(__AVX512F__)
-        #define USE_AVX512 1
-        #define VWIDTH 8
-    #elif defined(__AVX2__)
-        #define USE_AVX2 1  
-        #define VWIDTH 4
-    #endif
-#elif defined(__aarch64__)
-    #include <arm_neon.h>
-    #define USE_NEON 1
-    #define VWIDTH 2
-#endif
-
-#ifndef VWIDTH
-#define VWIDTH 1
-#endif
-
 namespace hft {
 namespace simd_features {
 
@@ -33,11 +16,13 @@ struct alignas(64) Features {
     Features() { vals.fill(0.0); }
 };
 
-// vectorized ofi calc - processes 10 levels at once
+// Every class below runs its loops through one simd::KernelTable, by
+// default the variant dispatched for this CPU at first use
+
 // vectorized ofi calc - processes 10 levels at once
 class SIMDOFICalculator {
 public:
-    SIMDOFICalculator() {
+    explicit SIMDOFICalculator(const simd::KernelTable& kernels = simd::kernels()) : kernels_(&kernels) {
         previous_bid_quantities_.fill(0.0);
         previous_ask_quantities_.fill(0.0);
         current_bid_quantities_.fill(0.0);
@@ -71,91 +56,32 @@ public:
     
     // Calculate OFI deltas using SIMD
     inline void calculate_ofi_simd(std::array<double, 10>& bid_ofi, std::array<double, 10>& ask_ofi) {
-#if defined(__AVX2__) || defined(__AVX512F__)
-        // x86 AVX2 path: Process 4 levels at a time
-        for (size_t i = 0; i < 8; i += 4) { // Process first 8
-            __m256d curr_bid = _mm256_loadu_pd(&current_bid_quantities_[i]);
-            __m256d prev_bid = _mm256_loadu_pd(&previous_bid_quantities_[i]);
-            __m256d curr_ask = _mm256_loadu_pd(&current_ask_quantities_[i]);
-            __m256d prev_ask = _mm256_loadu_pd(&previous_ask_quantities_[i]);
-            
-            __m256d delta_bid = _mm256_sub_pd(curr_bid, prev_bid);
-            __m256d delta_ask = _mm256_sub_pd(curr_ask, prev_ask);
-            
-            _mm256_storeu_pd(&bid_ofi[i], delta_bid);
-            _mm256_storeu_pd(&ask_ofi[i], delta_ask);
-        }
-        // Handle remaining 2 levels
-        for (size_t i = 8; i < 10; ++i) {
-             bid_ofi[i] = current_bid_quantities_[i] - previous_bid_quantities_[i];
-             ask_ofi[i] = current_ask_quantities_[i] - previous_ask_quantities_[i];
-        }
-#elif defined(HAS_NEON)
-        // ARM NEON path: Process 2 levels at a time
-        for (size_t i = 0; i < 10; i += 2) {
-            float64x2_t curr_bid = vld1q_f64(&current_bid_quantities_[i]);
-            float64x2_t prev_bid = vld1q_f64(&previous_bid_quantities_[i]);
-            float64x2_t curr_ask = vld1q_f64(&current_ask_quantities_[i]);
-            float64x2_t prev_ask = vld1q_f64(&previous_ask_quantities_[i]);
-            
-            float64x2_t delta_bid = vsubq_f64(curr_bid, prev_bid);
-            float64x2_t delta_ask = vsubq_f64(curr_ask, prev_ask);
-            
-            vst1q_f64(&bid_ofi[i], delta_bid);
-            vst1q_f64(&ask_ofi[i], delta_ask);
-        }
-#else
-        // Scalar fallback
-        for (size_t i = 0; i < 10; ++i) {
-            bid_ofi[i] = current_bid_quantities_[i] - previous_bid_quantities_[i];
-            ask_ofi[i] = current_ask_quantities_[i] - previous_ask_quantities_[i];
-        }
-#endif
+        kernels_->subtract(current_bid_quantities_.data(), previous_bid_quantities_.data(), bid_ofi.data(), 10);
+        kernels_->subtract(current_ask_quantities_.data(), previous_ask_quantities_.data(), ask_ofi.data(), 10);
     }
     
     // Calculate aggregated OFI metrics using SIMD
     inline double calculate_total_ofi_simd(const std::array<double, 10>& bid_ofi, 
                                            const std::array<double, 10>& ask_ofi) {
-#if defined(__AVX2__) || defined(__AVX512F__)
-        __m256d sum = _mm256_setzero_pd();
-        
-        for (size_t i = 0; i < 8; i += 4) {
-            __m256d bid = _mm256_loadu_pd(&bid_ofi[i]);
-            __m256d ask = _mm256_loadu_pd(&ask_ofi[i]);
-            __m256d diff = _mm256_sub_pd(bid, ask);
-            sum = _mm256_add_pd(sum, diff);
-        }
-        
-        double result[4];
-        _mm256_storeu_pd(result, sum);
-        double total = result[0] + result[1] + result[2] + result[3];
-        
-        // Remaining 2
-        for (size_t i = 8; i < 10; ++i) {
-            total += (bid_ofi[i] - ask_ofi[i]);
-        }
-        return total;
-#elif defined(HAS_NEON)
-        float64x2_t sum = vdupq_n_f64(0.0);
-        
-        for (size_t i = 0; i < 10; i += 2) {
-            float64x2_t bid = vld1q_f64(&bid_ofi[i]);
-            float64x2_t ask = vld1q_f64(&ask_ofi[i]);
-            float64x2_t diff = vsubq_f64(bid, ask);
-            sum = vaddq_f64(sum, diff);
-        }
-        
-        return vgetq_lane_f64(sum, 0) + vgetq_lane_f64(sum, 1);
-#else
-        double total = 0.0;
-        for (size_t i = 0; i < 10; ++i) {
-            total += (bid_ofi[i] - ask_ofi[i]);
-        }
-        return total;
-#endif
+        return kernels_->sum_difference(bid_ofi.data(), ask_ofi.data(), 10);
     }
     
+    void save_state(checkpoint::StateWriter& out) const {
+        out.put(previous_bid_quantities_);
+        out.put(previous_ask_quantities_);
+        out.put(current_bid_quantities_);
+        out.put(current_ask_quantities_);
+    }
+
+    void restore_state(checkpoint::StateReader& in) {
+        in.get(previous_bid_quantities_);
+        in.get(previous_ask_quantities_);
+        in.get(current_bid_quantities_);
+        in.get(current_ask_quantities_);
+    }
+
 private:
+    const simd::KernelTable* kernels_;
     alignas(32) std::array<double, 10> previous_bid_quantities_;
     alignas(32) std::array<double, 10> previous_ask_quantities_;
     alignas(32) std::array<double, 10> current_bid_quantities_;
@@ -167,7 +93,7 @@ private:
 // ====
 class SIMDFeatureNormalizer {
 public:
-    SIMDFeatureNormalizer() {
+    explicit SIMDFeatureNormalizer(const simd::KernelTable& kernels = simd::kernels()) : kernels_(&kernels) {
         means_.fill(0.0);
         stddevs_.fill(1.0);
     }
@@ -182,54 +108,21 @@ public:
     
     // Normalize features using SIMD
     inline void normalize_simd(double* features, size_t num_features) {
-#if defined(__AVX2__) || defined(__AVX512F__)
-        // x86 AVX2: Process 4 features at a time
-        for (size_t i = 0; i < num_features; i += 4) {
-            if (i + 4 > num_features) break;
-            
-            __m256d x = _mm256_loadu_pd(&features[i]);
-            __m256d mean = _mm256_loadu_pd(&means_[i]);
-            __m256d stddev = _mm256_loadu_pd(&stddevs_[i]);
-            
-            __m256d centered = _mm256_sub_pd(x, mean);
-            __m256d normalized = _mm256_div_pd(centered, stddev);
-            
-            _mm256_storeu_pd(&features[i], normalized);
-        }
-        
-        // Handle remaining features
-        for (size_t i = (num_features / 4) * 4; i < num_features; ++i) {
-            features[i] = (features[i] - means_[i]) / stddevs_[i];
-        }
-#elif defined(HAS_NEON)
-        // ARM NEON: Process 2 features at a time
-        for (size_t i = 0; i < num_features; i += 2) {
-            if (i + 2 > num_features) break;
-            
-            float64x2_t x = vld1q_f64(&features[i]);
-            float64x2_t mean = vld1q_f64(&means_[i]);
-            float64x2_t stddev = vld1q_f64(&stddevs_[i]);
-            
-            float64x2_t centered = vsubq_f64(x, mean);
-            float64x2_t normalized = vdivq_f64(centered, stddev);
-            
-            vst1q_f64(&features[i], normalized);
-        }
-        
-        // Handle remaining feature
-        if (num_features % 2 == 1) {
-            size_t i = num_features - 1;
-            features[i] = (features[i] - means_[i]) / stddevs_[i];
-        }
-#else
-        // Scalar fallback
-        for (size_t i = 0; i < num_features; ++i) {
-            features[i] = (features[i] - means_[i]) / stddevs_[i];
-        }
-#endif
+        kernels_->normalize(features, means_.data(), stddevs_.data(), std::min<size_t>(num_features, 16));
     }
     
+    void save_state(checkpoint::StateWriter& out) const {
+        out.put(means_);
+        out.put(stddevs_);
+    }
+
+    void restore_state(checkpoint::StateReader& in) {
+        in.get(means_);
+        in.get(stddevs_);
+    }
+
 private:
+    const simd::KernelTable* kernels_;
     alignas(32) std::array<double, 16> means_;
     alignas(32) std::array<double, 16> stddevs_;
 };
@@ -239,64 +132,17 @@ private:
 // ====
 class SIMDImbalanceCalculator {
 public:
+    explicit SIMDImbalanceCalculator(const simd::KernelTable& kernels = simd::kernels()) : kernels_(&kernels) {}
+
     // Calculate volume imbalance with SIMD reduction
     inline double calculate_volume_imbalance_simd(const double* bid_volumes, 
                                                    const double* ask_volumes,
                                                    size_t num_levels) {
-#if defined(__AVX2__) || defined(__AVX512F__)
-        __m256d bid_sum = _mm256_setzero_pd();
-        __m256d ask_sum = _mm256_setzero_pd();
-        
-        size_t i = 0;
-        for (; i + 4 <= num_levels; i += 4) {
-            bid_sum = _mm256_add_pd(bid_sum, _mm256_loadu_pd(&bid_volumes[i]));
-            ask_sum = _mm256_add_pd(ask_sum, _mm256_loadu_pd(&ask_volumes[i]));
-        }
-        
-        double bid_total[4], ask_total[4];
-        _mm256_storeu_pd(bid_total, bid_sum);
-        _mm256_storeu_pd(ask_total, ask_sum);
-        
-        double total_bid = bid_total[0] + bid_total[1] + bid_total[2] + bid_total[3];
-        double total_ask = ask_total[0] + ask_total[1] + ask_total[2] + ask_total[3];
-        
-        for (; i < num_levels; ++i) {
-            total_bid += bid_volumes[i];
-            total_ask += ask_volumes[i];
-        }
-        
-        double total = total_bid + total_ask;
-        return (total > 0.0) ? (total_bid - total_ask) / total : 0.0;
-#elif defined(HAS_NEON)
-        float64x2_t bid_sum = vdupq_n_f64(0.0);
-        float64x2_t ask_sum = vdupq_n_f64(0.0);
-        
-        size_t i = 0;
-        for (; i + 2 <= num_levels; i += 2) {
-            bid_sum = vaddq_f64(bid_sum, vld1q_f64(&bid_volumes[i]));
-            ask_sum = vaddq_f64(ask_sum, vld1q_f64(&ask_volumes[i]));
-        }
-        
-        double total_bid = vgetq_lane_f64(bid_sum, 0) + vgetq_lane_f64(bid_sum, 1);
-        double total_ask = vgetq_lane_f64(ask_sum, 0) + vgetq_lane_f64(ask_sum, 1);
-        
-        for (; i < num_levels; ++i) {
-            total_bid += bid_volumes[i];
-            total_ask += ask_volumes[i];
-        }
-        
-        double total = total_bid + total_ask;
-        return (total > 0.0) ? (total_bid - total_ask) / total : 0.0;
-#else
-        double total_bid = 0.0, total_ask = 0.0;
-        for (size_t i = 0; i < num_levels; ++i) {
-            total_bid += bid_volumes[i];
-            total_ask += ask_volumes[i];
-        }
-        double total = total_bid + total_ask;
-        return (total > 0.0) ? (total_bid - total_ask) / total : 0.0;
-#endif
+        return kernels_->volume_imbalance(bid_volumes, ask_volumes, num_levels);
     }
+
+private:
+    const simd::KernelTable* kernels_;
 };
 
 // ====
@@ -304,7 +150,8 @@ public:
 // ====
 class FastFeatureEngine {
 public:
-    FastFeatureEngine() {
+    explicit FastFeatureEngine(const simd::KernelTable& kernels = simd::kernels())
+        : ofi_calc_(kernels), normalizer_(kernels), imbalance_calc_(kernels) {
         // Initialize with default normalization (mean=0, std=1)
         double default_means[16] = {0};
         double default_stddevs[16];
@@ -374,6 +221,17 @@ public:
         finalize_features(output_features, total_ofi, bid_ofi, ask_ofi, volume_imbalance, best_bid, best_ask, num_levels);
     }
 
+    // Previous book quantities (the OFI baseline) and normalizer parameters
+    void save_state(checkpoint::StateWriter& out) const {
+        ofi_calc_.save_state(out);
+        normalizer_.save_state(out);
+    }
+
+    void restore_state(checkpoint::StateReader& in) {
+        ofi_calc_.restore_state(in);
+        normalizer_.restore_state(in);
+    }
+
 private:
     inline void finalize_features(double* output_features, double total_ofi, 
                                 const std::array<double, 10>& bid_ofi, const std::array<double, 10>& ask_ofi,
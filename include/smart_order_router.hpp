@@ -2,14 +2,24 @@
 
 #include "common_types.hpp"
 #include "avellaneda_stoikov.hpp"
+#include "instrument_directory.hpp"
+#include "seqlock.hpp"
+#include <array>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <atomic>
 #include <chrono>
 #include <optional>
 #include <algorithm>
 #include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
 
 using hft::Timestamp;
 using hft::Duration;
@@ -18,6 +28,7 @@ using hft::now;
 using hft::to_nanos;
 
 using hft::DynamicMMStrategy;
+using hft::PerfectHashIndex;
 
 struct VenueInfo {
     std::string venue_id;
@@ -58,6 +69,7 @@ struct VenueState {
 
 struct RoutingDecision {
     std::string selected_venue;
+    uint32_t selected_venue_index;
     double expected_latency_us;
     double latency_budget_us;
     double price_quality;
@@ -84,6 +96,42 @@ struct RoutingConfig {
     double rtt_ema_alpha;
 };
 
+// Per-venue routing inputs, recomputed by the control plane (heartbeats,
+// timeouts, fills, venue changes) and read by route_order through a
+// Seqlock. Everything that does not depend on the order itself (active,
+// connected, latency spike, fill rate) is folded into ema_rtt_us: a venue
+// that fails any of them carries INELIGIBLE_RTT and can never fit a budget.
+struct VenueScoreTable {
+    static constexpr size_t MAX_VENUES = 16;
+    static constexpr float INELIGIBLE_RTT = 1.0e30f;   // Finite: -ffast-math
+
+    alignas(32) float ema_rtt_us[MAX_VENUES];
+    alignas(32) float min_order_size[MAX_VENUES];
+    alignas(32) float max_order_size[MAX_VENUES];
+    alignas(32) float bid_depth[MAX_VENUES];
+    alignas(32) float ask_depth[MAX_VENUES];
+    uint32_t venue_count;
+
+    VenueScoreTable() : venue_count(0) {
+        for (size_t i = 0; i < MAX_VENUES; ++i) {
+            ema_rtt_us[i] = INELIGIBLE_RTT;
+            min_order_size[i] = 0.0f;
+            max_order_size[i] = 0.0f;
+            bid_depth[i] = 0.0f;
+            ask_depth[i] = 0.0f;
+        }
+    }
+
+    bool eligible(uint32_t venue) const {
+        return venue < MAX_VENUES && ema_rtt_us[venue] < INELIGIBLE_RTT;
+    }
+};
+
+// Threading: one routing thread (or several) calls route_order; the
+// heartbeat/fill side calls the heartbeat, timeout and order-result methods
+// from any thread. Those serialize on state_mutex_ and republish the score
+// table; route_order never takes the lock. add_venue is setup time;
+// remove_venue may run at any time (presence flags are atomic).
 class SmartOrderRouter {
 public:
 
@@ -105,8 +153,33 @@ public:
         return true;
     }
 
+    static constexpr uint32_t INVALID_VENUE = PerfectHashIndex::NOT_FOUND;
+    static constexpr double NO_QUOTE = 0.0;
+    static constexpr size_t MAX_VENUES = VenueScoreTable::MAX_VENUES;
+
+    // Control plane: venues get a dense index on first add; removing a venue
+    // keeps its index reserved so handles held by other components stay valid
     void add_venue(const VenueInfo& venue) {
-        venues_[venue.venue_id] = venue;
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        uint32_t idx = venue_index_.find(venue.venue_id);
+        if (idx == INVALID_VENUE) {
+            if (venues_.size() >= MAX_VENUES) {
+                throw std::length_error("SmartOrderRouter: too many venues");
+            }
+            idx = static_cast<uint32_t>(venues_.size());
+            venues_.push_back(venue);
+            venue_states_.emplace_back();
+
+            std::vector<std::string> ids;
+            ids.reserve(venues_.size());
+            for (const auto& v : venues_) {
+                ids.push_back(v.venue_id);
+            }
+            venue_index_.build(std::move(ids));
+        }
+
+        venues_[idx] = venue;
+        venue_present_[idx].store(1, std::memory_order_relaxed);
 
         VenueState state;
         state.last_heartbeat_sent = Timestamp{};
@@ -123,43 +196,67 @@ public:
         state.orders_rejected = 0;
         state.orders_timeout = 0;
 
-        venue_states_[venue.venue_id] = state;
+        venue_states_[idx] = state;
+        publish_scores();
     }
 
     void remove_venue(const std::string& venue_id) {
-        venues_.erase(venue_id);
-        venue_states_.erase(venue_id);
+        const uint32_t idx = venue_index(venue_id);
+        if (idx != INVALID_VENUE) {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            venue_present_[idx].store(0, std::memory_order_relaxed);
+            publish_scores();
+        }
+    }
+
+    // Dense index for hot-path calls, or INVALID_VENUE
+    uint32_t venue_index(std::string_view venue_id) const {
+        const uint32_t idx = venue_index_.find(venue_id);
+        return (idx != INVALID_VENUE && is_present(idx)) ? idx : INVALID_VENUE;
+    }
+
+    // Number of index slots (including removed venues)
+    size_t venue_slot_count() const {
+        return venues_.size();
     }
 
     std::vector<std::string> get_active_venues() const {
+        std::lock_guard<std::mutex> lock(state_mutex_);
         std::vector<std::string> active;
-        for (const auto& [venue_id, venue] : venues_) {
-            if (venue.is_active && venue_states_.at(venue_id).is_connected) {
-                active.push_back(venue_id);
+        for (uint32_t i = 0; i < venues_.size(); ++i) {
+            if (is_present(i) && venues_[i].is_active && venue_states_[i].is_connected) {
+                active.push_back(venues_[i].venue_id);
             }
         }
         return active;
     }
 
     void send_heartbeat(const std::string& venue_id, Timestamp now) {
-        auto it = venue_states_.find(venue_id);
-        if (it == venue_states_.end()) {
+        send_heartbeat(venue_index(venue_id), now);
+    }
+
+    void send_heartbeat(uint32_t venue, Timestamp now) {
+        if (!is_present(venue)) {
             return;
         }
 
-        VenueState& state = it->second;
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        VenueState& state = venue_states_[venue];
         state.last_heartbeat_sent = now;
         state.total_heartbeats_sent++;
-
     }
 
     void receive_heartbeat(const std::string& venue_id, Timestamp sent_time, Timestamp received_time) {
-        auto it = venue_states_.find(venue_id);
-        if (it == venue_states_.end()) {
+        receive_heartbeat(venue_index(venue_id), sent_time, received_time);
+    }
+
+    void receive_heartbeat(uint32_t venue, Timestamp sent_time, Timestamp received_time) {
+        if (!is_present(venue)) {
             return;
         }
 
-        VenueState& state = it->second;
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        VenueState& state = venue_states_[venue];
         state.last_heartbeat_received = received_time;
         state.total_heartbeats_received++;
         state.consecutive_timeouts = 0;
@@ -176,13 +273,17 @@ public:
         state.std_dev_rtt_us = std::sqrt(
             alpha * delta * delta + (1.0 - alpha) * state.std_dev_rtt_us * state.std_dev_rtt_us
         );
+        publish_scores();
     }
 
     void check_heartbeat_timeouts(Timestamp now) {
         const int64_t timeout_ns = config_.heartbeat_timeout_ms * 1'000'000;
+        bool changed = false;
 
-        for (auto& [venue_id, state] : venue_states_) {
-            if (state.last_heartbeat_sent == Timestamp{}) {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        for (uint32_t i = 0; i < venue_states_.size(); ++i) {
+            VenueState& state = venue_states_[i];
+            if (!is_present(i) || state.last_heartbeat_sent == Timestamp{}) {
                 continue;
             }
 
@@ -194,11 +295,14 @@ public:
                 state.consecutive_timeouts++;
 
                 if (state.consecutive_timeouts >= 3) {
-
                     state.is_connected = false;
+                    changed = true;
                 }
             }
         }
+        if (changed) {
+            publish_scores();
+        }
     }
 
     double calculate_latency_budget(
@@ -276,10 +380,52 @@ public:
         int32_t order_size,
         MarketRegime regime,
         const std::unordered_map<std::string, double>& venue_prices
-    ) {
+    ) const {
+        std::array<double, MAX_VENUES> dense_prices;
+        dense_prices.fill(NO_QUOTE);
+        for (const auto& [venue_id, price] : venue_prices) {
+            const uint32_t idx = venue_index(venue_id);
+            if (idx != INVALID_VENUE) {
+                dense_prices[idx] = price;
+            }
+        }
+        return route_order(mid_price, current_volatility, current_position,
+                           order_size, regime, dense_prices.data(), dense_prices.size());
+    }
+
+    // venue_prices is indexed by venue_index(), NO_QUOTE (or any
+    // non-positive price) = no quote. Not NaN: release builds use -ffast-math.
+    RoutingDecision route_order(
+        double mid_price,
+        double current_volatility,
+        int32_t current_position,
+        int32_t order_size,
+        MarketRegime regime,
+        const std::vector<double>& venue_prices
+    ) const {
+        return route_order(mid_price, current_volatility, current_position,
+                           order_size, regime, venue_prices.data(), venue_prices.size());
+    }
+
+    // Hot path: one Seqlock read of the score table, then every venue is
+    // scored at once (8 lanes on AVX2) and the best is picked with a
+    // first-wins scan. No locks, no allocation on the accept path.
+    RoutingDecision route_order(
+        double mid_price,
+        double current_volatility,
+        int32_t current_position,
+        int32_t order_size,
+        MarketRegime regime,
+        const double* venue_prices,
+        size_t num_prices
+    ) const {
         RoutingDecision decision;
-        decision.selected_venue = "";
-        decision.rejection_reason = "";
+        decision.selected_venue_index = INVALID_VENUE;
+        decision.expected_latency_us = 0.0;
+        decision.price_quality = 0.0;
+        decision.latency_quality = 0.0;
+        decision.liquidity_quality = 0.0;
+        decision.composite_score = 0.0;
 
         decision.latency_budget_us = calculate_latency_budget(
             mid_price,
@@ -289,151 +435,89 @@ public:
             regime
         );
 
-        std::vector<std::string> candidate_venues;
-
-        for (const auto& [venue_id, venue] : venues_) {
-            if (!venue.is_active) {
-                continue;
-            }
-
-            const auto& state = venue_states_.at(venue_id);
-
-            if (!state.is_connected) {
-                continue;
-            }
+        const VenueScoreTable table = scores_.load();
+        num_prices = std::min<size_t>(num_prices, table.venue_count);
 
-            const double venue_latency = state.ema_rtt_us;
-            if (venue_latency > decision.latency_budget_us) {
+        // Best quoted price across venues (same for every candidate)
+        alignas(32) float prices[MAX_VENUES] = {};
+        float best_price = 0.0f;
+        for (size_t i = 0; i < num_prices; ++i) {
+            if (venue_prices[i] <= NO_QUOTE) {
                 continue;
             }
-
-            const double spike_threshold = state.ema_rtt_us +
-                                          (config_.latency_spike_threshold * state.std_dev_rtt_us);
-            if (state.current_rtt_us > spike_threshold) {
-                continue;
+            const float price = static_cast<float>(venue_prices[i]);
+            prices[i] = price;
+            if (best_price == 0.0f) {
+                best_price = price;
+            } else if (order_size > 0) {
+                best_price = std::min(best_price, price);
+            } else {
+                best_price = std::max(best_price, price);
             }
+        }
 
-            const double fill_rate = (state.orders_sent > 0) ?
-                static_cast<double>(state.orders_filled) / state.orders_sent :
-                venue.fill_rate;
+        const OrderTerms terms = order_terms(decision.latency_budget_us, order_size, best_price);
+        const float* depth = (order_size > 0) ? table.ask_depth : table.bid_depth;
 
-            if (fill_rate < config_.min_fill_rate) {
-                continue;
-            }
+        alignas(32) float scores[MAX_VENUES];
+        score_venues(table, prices, depth, terms, scores);
 
-            const double abs_order_size = std::abs(static_cast<double>(order_size));
-            if (abs_order_size < venue.min_order_size ||
-                abs_order_size > venue.max_order_size) {
-                continue;
+        uint32_t best_venue = INVALID_VENUE;
+        float best_score = 0.0f;
+        for (uint32_t i = 0; i < table.venue_count; ++i) {
+            if (scores[i] >= 0.0f && (best_venue == INVALID_VENUE || scores[i] > best_score)) {
+                best_venue = i;
+                best_score = scores[i];
             }
-
-            candidate_venues.push_back(venue_id);
         }
 
-        if (candidate_venues.empty()) {
+        if (best_venue == INVALID_VENUE) {
             decision.rejection_reason = "No venues meet latency budget (" +
                                        std::to_string(decision.latency_budget_us) +
                                        " us) and connectivity requirements";
             return decision;
         }
 
-        std::vector<std::pair<std::string, double >>scored_venues;
-
-        for (const auto& venue_id : candidate_venues) {
-            const auto& venue = venues_.at(venue_id);
-            const auto& state = venue_states_.at(venue_id);
-
-            double price_quality = 0.0;
-            if (venue_prices.count(venue_id) > 0) {
-                const double venue_price = venue_prices.at(venue_id);
-
-                double best_price = venue_price;
-                for (const auto& [vid, price] : venue_prices) {
-                    if (order_size > 0) {
-                        best_price = std::min(best_price, price);
-                    } else {
-                        best_price = std::max(best_price, price);
-                    }
-                }
-
-                const double price_diff = (order_size > 0) ?
-                    (venue_price - best_price) / best_price :
-                    (best_price - venue_price) / best_price;
-
-                price_quality = std::max(0.0, 1.0 - (price_diff * 100.0));
-            } else {
-                price_quality = 0.5;
-            }
-
-            const double latency_ratio = state.ema_rtt_us / decision.latency_budget_us;
-            const double latency_quality = std::max(0.0, 1.0 - latency_ratio);
-
-            const double required_liquidity = std::abs(static_cast<double>(order_size));
-            const double available_liquidity = (order_size > 0) ?
-                venue.typical_ask_depth : venue.typical_bid_depth;
-            const double liquidity_ratio = std::min(1.0, available_liquidity / required_liquidity);
-            const double liquidity_quality = liquidity_ratio;
-
-            const double composite_score =
-                config_.price_weight * price_quality +
-                config_.latency_weight * latency_quality +
-                config_.liquidity_weight * liquidity_quality;
-
-            scored_venues.push_back({venue_id, composite_score});
-        }
-
-        auto best_venue = std::max_element(
-            scored_venues.begin(),
-            scored_venues.end(),
-            [](const auto& a, const auto& b) { return a.second < b.second; }
-        );
-
-        if (best_venue == scored_venues.end() || best_venue->second < config_.min_composite_score) {
+        if (best_score < config_.min_composite_score) {
             decision.rejection_reason = "No venues meet minimum composite score (" +
                                        std::to_string(config_.min_composite_score) + ")";
             return decision;
         }
 
-        decision.selected_venue = best_venue->first;
-        decision.composite_score = best_venue->second;
-        decision.expected_latency_us = venue_states_.at(best_venue->first).ema_rtt_us;
-
-        const auto& venue = venues_.at(best_venue->first);
-        const auto& state = venue_states_.at(best_venue->first);
-
-        if (venue_prices.count(best_venue->first) > 0) {
-            const double venue_price = venue_prices.at(best_venue->first);
-            double best_price = venue_price;
-            for (const auto& [vid, price] : venue_prices) {
-                if (order_size > 0) {
-                    best_price = std::min(best_price, price);
-                } else {
-                    best_price = std::max(best_price, price);
-                }
-            }
-            const double price_diff = (order_size > 0) ?
-                (venue_price - best_price) / best_price :
-                (best_price - venue_price) / best_price;
-            decision.price_quality = std::max(0.0, 1.0 - (price_diff * 100.0));
-        }
+        const float rtt = table.ema_rtt_us[best_venue];
+        decision.selected_venue = venues_[best_venue].venue_id;
+        decision.selected_venue_index = best_venue;
+        decision.composite_score = best_score;
+        decision.expected_latency_us = rtt;
+        decision.price_quality = (prices[best_venue] > 0.0f) ?
+            price_quality(prices[best_venue], terms) : 0.0f;
+        decision.latency_quality = std::max(0.0f, 1.0f - rtt * terms.inv_budget);
+        decision.liquidity_quality = std::min(1.0f, depth[best_venue] * terms.inv_size);
 
-        decision.latency_quality = std::max(0.0, 1.0 - (state.ema_rtt_us / decision.latency_budget_us));
+        return decision;
+    }
 
-        const double required_liquidity = std::abs(static_cast<double>(order_size));
-        const double available_liquidity = (order_size > 0) ?
-            venue.typical_ask_depth : venue.typical_bid_depth;
-        decision.liquidity_quality = std::min(1.0, available_liquidity / required_liquidity);
+    // Copy of the table route_order currently sees
+    VenueScoreTable score_table() const {
+        return scores_.load();
+    }
 
-        return decision;
+    // Number of score-table publications so far
+    uint64_t score_version() const {
+        return scores_.version();
     }
 
     void record_order_result(const std::string& venue_id, bool filled, bool timeout) {
-        auto it = venue_states_.find(venue_id);
-        if (it == venue_states_.end()) {
+        record_order_result(venue_index(venue_id), filled, timeout);
+    }
+
+    void record_order_result(uint32_t venue, bool filled, bool timeout) {
+        if (!is_present(venue)) {
             return;
         }
 
-        VenueState& state = it->second;
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        VenueState& state = venue_states_[venue];
         state.orders_sent++;
 
         if (filled) {
@@ -443,22 +527,160 @@ public:
         } else {
             state.orders_rejected++;
         }
+        publish_scores();
     }
 
     std::optional<VenueState> get_venue_state(const std::string& venue_id) const {
-        auto it = venue_states_.find(venue_id);
-        if (it != venue_states_.end()) {
-            return it->second;
+        const uint32_t idx = venue_index(venue_id);
+        if (idx != INVALID_VENUE) {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            return venue_states_[idx];
         }
         return std::nullopt;
     }
 
-    const std::unordered_map<std::string, VenueState>& get_all_venue_states() const {
-        return venue_states_;
+    // Snapshot keyed by name (control plane / reporting)
+    std::unordered_map<std::string, VenueState> get_all_venue_states() const {
+        std::unordered_map<std::string, VenueState> states;
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        for (uint32_t i = 0; i < venues_.size(); ++i) {
+            if (is_present(i)) {
+                states[venues_[i].venue_id] = venue_states_[i];
+            }
+        }
+        return states;
     }
 
 private:
 
+    // Lock-free: the flags are atomic and sized for MAX_VENUES up front, so
+    // an unlocked caller never races add_venue. State behind a true flag is
+    // still read under state_mutex_.
+    bool is_present(uint32_t venue) const {
+        return venue < MAX_VENUES && venue_present_[venue].load(std::memory_order_relaxed) != 0;
+    }
+
+    // Per-order constants broadcast across the venue lanes
+    struct OrderTerms {
+        float budget_us;
+        float inv_budget;
+        float abs_size;
+        float inv_size;
+        float best_price;
+        float inv_best_price;
+        float side_sign;       // +1 buy (lower is better), -1 sell
+        float price_weight;
+        float latency_weight;
+        float liquidity_weight;
+    };
+
+    OrderTerms order_terms(double budget_us, int32_t order_size, float best_price) const {
+        OrderTerms t;
+        t.budget_us = static_cast<float>(budget_us);
+        t.inv_budget = 1.0f / t.budget_us;
+        t.abs_size = std::abs(static_cast<float>(order_size));
+        t.inv_size = (t.abs_size > 0.0f) ? 1.0f / t.abs_size : 0.0f;
+        t.best_price = best_price;
+        t.inv_best_price = (best_price > 0.0f) ? 1.0f / best_price : 0.0f;
+        t.side_sign = (order_size > 0) ? 1.0f : -1.0f;
+        t.price_weight = static_cast<float>(config_.price_weight);
+        t.latency_weight = static_cast<float>(config_.latency_weight);
+        t.liquidity_weight = static_cast<float>(config_.liquidity_weight);
+        return t;
+    }
+
+    static float price_quality(float price, const OrderTerms& t) {
+        const float diff = t.side_sign * (price - t.best_price) * t.inv_best_price;
+        return std::max(0.0f, 1.0f - diff * 100.0f);
+    }
+
+    // scores[i] = composite score of venue i, or -1 if it cannot take the order
+    static void score_venues(const VenueScoreTable& table, const float* prices, const float* depth,
+                             const OrderTerms& t, float* scores) {
+#if defined(__AVX2__)
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256 rejected = _mm256_set1_ps(-1.0f);
+        const __m256 hundred = _mm256_set1_ps(100.0f);
+        const __m256 budget = _mm256_set1_ps(t.budget_us);
+        const __m256 inv_budget = _mm256_set1_ps(t.inv_budget);
+        const __m256 size = _mm256_set1_ps(t.abs_size);
+        const __m256 inv_size = _mm256_set1_ps(t.inv_size);
+        const __m256 best = _mm256_set1_ps(t.best_price);
+        const __m256 inv_best = _mm256_set1_ps(t.inv_best_price * t.side_sign);
+        const __m256 w_price = _mm256_set1_ps(t.price_weight);
+        const __m256 w_latency = _mm256_set1_ps(t.latency_weight);
+        const __m256 w_liquidity = _mm256_set1_ps(t.liquidity_weight);
+
+        for (size_t i = 0; i < VenueScoreTable::MAX_VENUES; i += 8) {
+            const __m256 rtt = _mm256_load_ps(&table.ema_rtt_us[i]);
+            const __m256 px = _mm256_load_ps(&prices[i]);
+
+            __m256 ok = _mm256_cmp_ps(rtt, budget, _CMP_LE_OQ);
+            ok = _mm256_and_ps(ok, _mm256_cmp_ps(size, _mm256_load_ps(&table.min_order_size[i]), _CMP_GE_OQ));
+            ok = _mm256_and_ps(ok, _mm256_cmp_ps(size, _mm256_load_ps(&table.max_order_size[i]), _CMP_LE_OQ));
+
+            const __m256 diff = _mm256_mul_ps(_mm256_sub_ps(px, best), inv_best);
+            const __m256 quoted = _mm256_max_ps(zero, _mm256_sub_ps(one, _mm256_mul_ps(diff, hundred)));
+            const __m256 price_q = _mm256_blendv_ps(half, quoted, _mm256_cmp_ps(px, zero, _CMP_GT_OQ));
+            const __m256 latency_q = _mm256_max_ps(zero, _mm256_sub_ps(one, _mm256_mul_ps(rtt, inv_budget)));
+            const __m256 liquidity_q = _mm256_min_ps(one, _mm256_mul_ps(_mm256_loadu_ps(&depth[i]), inv_size));
+
+            __m256 score = _mm256_mul_ps(w_price, price_q);
+            score = _mm256_add_ps(score, _mm256_mul_ps(w_latency, latency_q));
+            score = _mm256_add_ps(score, _mm256_mul_ps(w_liquidity, liquidity_q));
+
+            _mm256_store_ps(&scores[i], _mm256_blendv_ps(rejected, score, ok));
+        }
+#else
+        for (size_t i = 0; i < VenueScoreTable::MAX_VENUES; ++i) {
+            const float rtt = table.ema_rtt_us[i];
+            const bool ok = rtt <= t.budget_us &&
+                            t.abs_size >= table.min_order_size[i] &&
+                            t.abs_size <= table.max_order_size[i];
+
+            const float price_q = (prices[i] > 0.0f) ? price_quality(prices[i], t) : 0.5f;
+            const float latency_q = std::max(0.0f, 1.0f - rtt * t.inv_budget);
+            const float liquidity_q = std::min(1.0f, depth[i] * t.inv_size);
+            const float score = t.price_weight * price_q +
+                                t.latency_weight * latency_q +
+                                t.liquidity_weight * liquidity_q;
+            scores[i] = ok ? score : -1.0f;
+        }
+#endif
+    }
+
+    // Caller holds state_mutex_ (the Seqlock has one writer at a time)
+    void publish_scores() {
+        VenueScoreTable table;
+        table.venue_count = static_cast<uint32_t>(venues_.size());
+
+        for (uint32_t i = 0; i < venues_.size(); ++i) {
+            const auto& venue = venues_[i];
+            const auto& state = venue_states_[i];
+
+            const double spike_threshold = state.ema_rtt_us +
+                                          (config_.latency_spike_threshold * state.std_dev_rtt_us);
+            const double fill_rate = (state.orders_sent > 0) ?
+                static_cast<double>(state.orders_filled) / state.orders_sent :
+                venue.fill_rate;
+
+            const bool eligible = is_present(i) && venue.is_active && state.is_connected &&
+                                  state.current_rtt_us <= spike_threshold &&
+                                  fill_rate >= config_.min_fill_rate;
+
+            table.ema_rtt_us[i] = eligible ? static_cast<float>(state.ema_rtt_us)
+                                           : VenueScoreTable::INELIGIBLE_RTT;
+            table.min_order_size[i] = static_cast<float>(venue.min_order_size);
+            table.max_order_size[i] = static_cast<float>(venue.max_order_size);
+            table.bid_depth[i] = static_cast<float>(venue.typical_bid_depth);
+            table.ask_depth[i] = static_cast<float>(venue.typical_ask_depth);
+        }
+
+        scores_.store(table);
+    }
+
     static RoutingConfig default_config() {
         RoutingConfig config;
 
@@ -530,6 +752,12 @@ private:
     RoutingConfig config_;
     DynamicMMStrategy* as_model_;
 
-    std::unordered_map<std::string, VenueInfo> venues_;
-    std::unordered_map<std::string, VenueState> venue_states_;
+    // Dense per-venue storage, indexed by venue_index()
+    std::vector<VenueInfo> venues_;
+    std::vector<VenueState> venue_states_;
+    std::array<std::atomic<uint8_t>, MAX_VENUES> venue_present_{};   // Written under state_mutex_
+    PerfectHashIndex venue_index_;
+
+    mutable std::mutex state_mutex_;           // Control-plane writers
+    hft::Seqlock<VenueScoreTable> scores_;     // What route_order reads
 };
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "memory_arena.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace hft {
+
+// Single-writer / multi-reader history ring.
+//
+// The writer publishes into a preallocated power-of-two array and never
+// waits or allocates; once full it overwrites the oldest entry. Each slot
+// carries its own sequence (odd while being written, 2*index+2 once
+// entry `index` is complete), so a reader copies an entry optimistically
+// and drops it if the writer lapped it mid-copy, as in Seqlock.
+template<typename T>
+class SnapshotRing {
+    static_assert(std::is_trivially_copyable_v<T>, "SnapshotRing payload must be trivially copyable");
+
+public:
+    explicit SnapshotRing(size_t capacity)
+        : mask_(round_up_pow2(std::max<size_t>(capacity, 2)) - 1),
+          slots_(mask_ + 1) {}
+
+    SnapshotRing(const SnapshotRing&) = delete;
+    SnapshotRing& operator=(const SnapshotRing&) = delete;
+
+    // Writer side (one thread only)
+    void publish(const T& value) {
+        const uint64_t index = head_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[index & mask_];
+
+        slot.seq.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(static_cast<void*>(&slot.value), &value, sizeof(T));
+        slot.seq.store(2 * index + 2, std::memory_order_release);
+
+        head_.store(index + 1, std::memory_order_release);
+    }
+
+    // Entries ever published; the next entry gets this index
+    uint64_t published() const { return head_.load(std::memory_order_acquire); }
+    size_t capacity() const { return mask_ + 1; }
+
+    // Oldest index not yet overwritten
+    uint64_t oldest() const {
+        const uint64_t head = published();
+        return head > capacity() ? head - capacity() : 0;
+    }
+
+    // False if entry `index` is not published yet or has been overwritten
+    bool read(uint64_t index, T& out) const {
+        const Slot& slot = slots_[index & mask_];
+        const uint64_t before = slot.seq.load(std::memory_order_acquire);
+        if (before != 2 * index + 2) return false;
+
+        std::memcpy(static_cast<void*>(&out), &slot.value, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.seq.load(std::memory_order_relaxed) == before;
+    }
+
+    // f(index, const T&) for each live entry in [from, published()), oldest
+    // first, without locking or allocating. Returns the index to resume from.
+    template<typename F>
+    uint64_t visit(uint64_t from, F&& f) const {
+        const uint64_t end = published();
+        T entry;
+        for (uint64_t i = std::max(from, end > capacity() ? end - capacity() : 0); i < end; ++i) {
+            if (read(i, entry)) f(i, entry);
+        }
+        return end;
+    }
+
+    // The last `count` entries
+    template<typename F>
+    uint64_t visit_recent(size_t count, F&& f) const {
+        const uint64_t end = published();
+        return visit(end > count ? end - count : 0, std::forward<F>(f));
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> seq{0};
+        T value{};
+    };
+
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    const size_t mask_;
+    HotVector<Slot> slots_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+};
+
+} // namespace hft
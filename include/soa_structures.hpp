@@ -163,6 +163,89 @@ struct alignas(64) SOA_OrderBook {
             }
         }
     }
+    
+    /**
+     * Incremental top-N maintenance
+     * 
+     * Levels [0, num) stay sorted best first (bids descending, asks
+     * ascending), all active, at most `limit` of them; slots past num are
+     * zero, so kernels can run over a fixed width.
+     * 
+     * set_level() sets the level at `price`; quantity <= 0 removes it.
+     * Prices behind the last level of a full side are not mirrored. Returns
+     * true when a mirrored level went away: the caller append_level()s the
+     * next one from the full book, if any.
+     * 
+     * Performance: one short scan + a shift of at most `limit` entries
+     */
+    inline bool set_level(bool is_bid, double price, double quantity, uint32_t count, size_t limit) {
+        return is_bid
+            ? set_level_on(bid_prices, bid_quantities, bid_order_counts, bid_active, num_bid_levels,
+                           true, price, quantity, count, limit)
+            : set_level_on(ask_prices, ask_quantities, ask_order_counts, ask_active, num_ask_levels,
+                           false, price, quantity, count, limit);
+    }
+    
+    // Adds a level behind the current last one (refill, rebuild)
+    inline void append_level(bool is_bid, double price, double quantity, uint32_t count) {
+        size_t& n = is_bid ? num_bid_levels : num_ask_levels;
+        if (n >= MaxLevels) return;
+        (is_bid ? bid_prices : ask_prices)[n] = price;
+        (is_bid ? bid_quantities : ask_quantities)[n] = quantity;
+        (is_bid ? bid_order_counts : ask_order_counts)[n] = count;
+        (is_bid ? bid_active : ask_active)[n] = true;
+        ++n;
+    }
+    
+    inline void clear_levels() {
+        *this = SOA_OrderBook();
+    }
+    
+private:
+    template<typename Counts, typename Active>
+    static bool set_level_on(std::array<double, MaxLevels>& prices, std::array<double, MaxLevels>& quantities,
+                             Counts& counts, Active& active, size_t& n, bool is_bid,
+                             double price, double quantity, uint32_t count, size_t limit) {
+        // First level not better than `price`
+        size_t i = 0;
+        while (i < n && (is_bid ? prices[i] > price : prices[i] < price)) ++i;
+        const bool found = i < n && prices[i] == price;
+        
+        if (quantity <= 0.0) {
+            if (!found) return false;
+            for (size_t j = i; j + 1 < n; ++j) {
+                prices[j] = prices[j + 1];
+                quantities[j] = quantities[j + 1];
+                counts[j] = counts[j + 1];
+            }
+            --n;
+            prices[n] = 0.0;
+            quantities[n] = 0.0;
+            counts[n] = 0;
+            active[n] = false;
+            return true;
+        }
+        
+        if (found) {
+            quantities[i] = quantity;
+            counts[i] = count;
+            return false;
+        }
+        if (i >= limit) return false;
+        
+        if (n == limit) --n;  // Last level falls out of the mirror
+        for (size_t j = n; j > i; --j) {
+            prices[j] = prices[j - 1];
+            quantities[j] = quantities[j - 1];
+            counts[j] = counts[j - 1];
+        }
+        prices[i] = price;
+        quantities[i] = quantity;
+        counts[i] = count;
+        active[n] = true;
+        ++n;
+        return false;
+    }
 };
 
 // ====
@@ -370,6 +453,82 @@ struct alignas(64) SOA_TimeSeries {
     }
 };
 
+// ====
+// Rolling Window (fixed ring, O(1) sum / mean / stddev)
+// ====
+
+/**
+ * Last `Window` samples with running sums, so a window statistic costs the
+ * same whatever the window length. Sums are kept relative to an anchor
+ * near the data (prices don't cancel in the variance) and recomputed
+ * exactly once per lap, so rounding never accumulates.
+ */
+template<size_t Window>
+struct alignas(64) RollingWindow {
+    alignas(64) std::array<double, Window> values;
+    size_t head;   // Next slot to write
+    size_t count;  // Number of valid elements
+    double anchor;
+    double sum;    // Of (value - anchor)
+    double sum_sq;
+    
+    RollingWindow() : head(0), count(0), anchor(0.0), sum(0.0), sum_sq(0.0) {
+        values.fill(0.0);
+    }
+    
+    inline void push(double value) {
+        if (count == Window) {
+            const double old = values[head] - anchor;
+            sum -= old;
+            sum_sq -= old * old;
+        } else {
+            if (count == 0) anchor = value;
+            ++count;
+        }
+        values[head] = value;
+        const double d = value - anchor;
+        sum += d;
+        sum_sq += d * d;
+        
+        head = (head + 1) % Window;
+        if (head == 0) rebase();
+    }
+    
+    inline double total() const {
+        return sum + anchor * static_cast<double>(count);
+    }
+    
+    inline double mean() const {
+        return count ? anchor + sum / static_cast<double>(count) : 0.0;
+    }
+    
+    // Population standard deviation
+    inline double stddev() const {
+        if (count < 2) return 0.0;
+        const double n = static_cast<double>(count);
+        const double var = (sum_sq - sum * sum / n) / n;
+        return var > 0.0 ? std::sqrt(var) : 0.0;
+    }
+    
+    inline void clear() {
+        head = 0;
+        count = 0;
+        anchor = sum = sum_sq = 0.0;
+    }
+    
+private:
+    inline void rebase() {
+        anchor = mean();
+        sum = 0.0;
+        sum_sq = 0.0;
+        for (size_t i = 0; i < count; i++) {
+            const double d = values[i] - anchor;
+            sum += d;
+            sum_sq += d * d;
+        }
+    }
+};
+
 // ====
 // Performance Comparison Summary
 // ====
@@ -4,6 +4,11 @@
 #include <cstdint>
 #include <cstring>
 #include <array>
+#include <memory>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>  // For __rdtsc()
+#endif
 
 /**
  * Solarflare ef_vi / TCPDirect Ultra-Low-Latency Network Interface
@@ -99,6 +104,14 @@ struct efvi_packet {
     uint64_t timestamp_ns;               // Hardware timestamp (if supported)
 };
 
+/**
+ * Frame to transmit (copied into a TX packet buffer)
+ */
+struct efvi_tx_packet {
+    const uint8_t* data;
+    size_t len;
+};
+
 // ====
 // ef_vi Interface (Simulated)
 // ====
@@ -184,31 +197,51 @@ public:
      * ```
      */
     inline bool poll_rx(efvi_packet* pkt) {
+        return rx_burst(pkt, 1) == 1;
+    }
+    
+    /**
+     * Receive up to max_packets from one event queue poll
+     * 
+     * One ef_eventq_poll() and one ef_vi_receive_push() per burst instead of
+     * per packet; the hardware timestamp clock is read once per burst.
+     * 
+     * Production:
+     * ```cpp
+     * int n_ev = ef_eventq_poll(&vi, evs, max_packets);
+     * for (int i = 0; i < n_ev; i++) { ... }   // collect RX events
+     * for (each consumed) ef_vi_receive_init(&vi, dma_addr, pkt_id);
+     * ef_vi_receive_push(&vi);                  // one doorbell
+     * ```
+     */
+    inline size_t rx_burst(efvi_packet* pkts, size_t max_packets) {
         if (!initialized_) [[unlikely]] {
-            return false;
+            return 0;
         }
         
         // HOT PATH: Check DMA ring buffer for new packets
         // Real implementation: ef_eventq_poll()
         // Simulation: Return dummy data
+        const size_t n = rx_posted_ < max_packets ? rx_posted_ : max_packets;
+        if (n == 0) [[unlikely]] {
+            return 0;
+        }
         
-        if (rx_posted_ > 0) [[likely]] {
-            // Simulated packet receive
-            pkt->len = 64;  // Minimum Ethernet frame
-            #if defined(__x86_64__) || defined(__i386__)
-                pkt->timestamp_ns = __rdtsc();  // Use TSC for timing
-            #else
-                pkt->timestamp_ns = 0;  // Placeholder for non-x86
-            #endif
-            rx_posted_--;
-            
-            // Re-post RX buffer immediately (keep ring full)
-            post_rx_buffer(rx_posted_);
-            
-            return true;
+        #if defined(__x86_64__) || defined(__i386__)
+            const uint64_t ts = __rdtsc();  // Use TSC for timing
+        #else
+            const uint64_t ts = 0;  // Placeholder for non-x86
+        #endif
+        for (size_t i = 0; i < n; ++i) {
+            pkts[i].len = 64;  // Minimum Ethernet frame
+            pkts[i].timestamp_ns = ts;
         }
+        rx_posted_ -= static_cast<uint32_t>(n);
         
-        return false;
+        // Re-post the consumed RX buffers in one push (keep ring full)
+        post_rx_buffers(static_cast<uint32_t>(n));
+        
+        return n;
     }
     
     /**
@@ -253,6 +286,59 @@ public:
         return false;
     }
     
+    /**
+     * Zero-copy TX: next free TX packet buffer to serialize into, or
+     * nullptr if the ring is full. Send it with transmit_buffer().
+     */
+    inline uint8_t* tx_buffer() {
+        if (!initialized_ || tx_posted_ >= EFVI_TX_RING_SIZE) [[unlikely]] {
+            return nullptr;
+        }
+        return static_cast<uint8_t*>(handle_.pkt_bufs[tx_posted_]);
+    }
+    
+    /**
+     * Transmit the buffer returned by tx_buffer() (no copy)
+     * 
+     * Production: ef_vi_transmit(&vi, dma_addr, len, pkt_id) + push
+     */
+    inline bool transmit_buffer(size_t len) {
+        if (!initialized_ || tx_posted_ >= EFVI_TX_RING_SIZE || len > EFVI_PKT_BUF_SIZE) [[unlikely]] {
+            return false;
+        }
+        tx_posted_++;
+        return true;
+    }
+    
+    /**
+     * Submit a burst with one TX push
+     * 
+     * Production:
+     * ```cpp
+     * for (each packet) ef_vi_transmit_init(&vi, dma_addr, len, pkt_id);
+     * ef_vi_transmit_push(&vi);                 // one doorbell
+     * ```
+     * Returns the number of packets queued (stops when the ring is full or
+     * at the first oversized packet).
+     */
+    inline size_t tx_burst(const efvi_tx_packet* pkts, size_t count) {
+        if (!initialized_) [[unlikely]] {
+            return 0;
+        }
+        
+        size_t queued = 0;
+        while (queued < count && tx_posted_ < EFVI_TX_RING_SIZE &&
+               pkts[queued].len <= EFVI_PKT_BUF_SIZE) {
+            uint8_t* tx_buf = static_cast<uint8_t*>(handle_.pkt_bufs[tx_posted_]);
+            std::memcpy(tx_buf, pkts[queued].data, pkts[queued].len);
+            tx_posted_++;
+            queued++;
+        }
+        
+        // Real implementation: ef_vi_transmit_push(&vi) once here
+        return queued;
+    }
+    
     /**
      * Poll for TX completions (reclaim buffers)
      * 
@@ -293,7 +379,8 @@ public:
     }
 
 private:
-    efvi_handle handle_;
+    efvi_handle handle_{};
+    std::unique_ptr<uint8_t[]> buffer_pool_;
     bool initialized_;
     uint32_t rx_posted_;
     uint32_t tx_posted_;
@@ -308,9 +395,10 @@ private:
      */
     void allocate_packet_buffers() {
         // Real implementation: mmap() with MAP_HUGETLB
-        // Allocate from huge page pool for DMA
+        // Simulation: one contiguous pool carved into fixed-size buffers
+        buffer_pool_.reset(new uint8_t[EFVI_NUM_BUFS * EFVI_PKT_BUF_SIZE]);
         for (size_t i = 0; i < EFVI_NUM_BUFS; i++) {
-            handle_.pkt_bufs[i] = nullptr;  // Placeholder
+            handle_.pkt_bufs[i] = buffer_pool_.get() + i * EFVI_PKT_BUF_SIZE;
         }
     }
     
@@ -327,6 +415,15 @@ private:
         rx_posted_++;
         // Real implementation: ef_vi_receive_init()
     }
+    
+    /**
+     * Post `count` RX buffers, then push them to the NIC once
+     */
+    inline void post_rx_buffers(uint32_t count) {
+        rx_posted_ += count;
+        // Real implementation: ef_vi_receive_init() per buffer, then one
+        // ef_vi_receive_push()
+    }
 };
 
 // ====
@@ -1,10 +1,21 @@
 #pragma once
 
 #include "common_types.hpp"
+#include "fast_math.hpp"
+#include "inline_function.hpp"
+#include "lockfree_queue.hpp"
+#include "tsc_clock.hpp"
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <thread>
 #include <cmath>
 
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+#endif
+
 #if defined(__linux__)
     #include <pthread.h>
     #include <sched.h>
@@ -89,265 +100,273 @@ inline bool set_realtime_priority() {
 }
 
 // ====
-// Math Look-Up Tables (LUTs)
+// Fast Math
 // ====
 
-/**
- * Pre-computed natural logarithm table
- * 
- * Range: [0.1, 10.0]
- * Precision: 0.0001 steps = 100,000 entries
- */
-class LnLookupTable {
-public:
-    static constexpr double MIN_X = 0.01;
-    static constexpr double MAX_X = 100.0;
-    static constexpr double STEP = 0.0001;
-    static constexpr size_t TABLE_SIZE = static_cast<size_t>((MAX_X - MIN_X) / STEP) + 1;
-    
-    LnLookupTable() {
-        // Pre-compute ln values at compile time (or first use)
-        for (size_t i = 0; i < TABLE_SIZE; i++) {
-            double x = MIN_X + i * STEP;
-            table_[i] = std::log(x);
-        }
-    }
-    
-    /**
-     * Fast ln lookup
-     */
-    inline double lookup(double x) const {
-        // Clamp to valid range
-        if (x < MIN_X) return std::log(MIN_X);
-        if (x > MAX_X) return std::log(MAX_X);
-        
-        // Calculate table index
-        size_t idx = static_cast<size_t>((x - MIN_X) / STEP);
-        if (idx >= TABLE_SIZE) idx = TABLE_SIZE - 1;
-        
-        return table_[idx];
-    }
-    
-    /**
-     * Interpolated ln lookup (higher accuracy, ~8-10ns)
-     */
-    inline double lookup_interp(double x) const {
-        if (x < MIN_X) return std::log(MIN_X);
-        if (x > MAX_X) return std::log(MAX_X);
-        
-        double fractional_idx = (x - MIN_X) / STEP;
-        size_t idx = static_cast<size_t>(fractional_idx);
-        if (idx >= TABLE_SIZE - 1) return table_[TABLE_SIZE - 1];
-        
-        // Linear interpolation
-        double frac = fractional_idx - idx;
-        return table_[idx] * (1.0 - frac) + table_[idx + 1] * frac;
-    }
+// Polynomial kernels (fast_math.hpp): ~1 ulp over the full range and a few
+// hundred bytes of constants, so no table lookup can miss in cache
+inline double fast_ln(double x) { return fast_math::log(x); }
+inline double fast_exp(double x) { return fast_math::exp(x); }
+inline double fast_sqrt(double x) { return fast_math::sqrt(x); }
 
-private:
-    alignas(64) std::array<double, TABLE_SIZE> table_;
-};
-
-/**
- * Pre-computed exponential table
- * 
- * Range: [-10.0, 10.0]
- * Precision: 0.001 steps = 20,000 entries
- */
-class ExpLookupTable {
-public:
-    static constexpr double MIN_X = -10.0;
-    static constexpr double MAX_X = 10.0;
-    static constexpr double STEP = 0.001;
-    static constexpr size_t TABLE_SIZE = static_cast<size_t>((MAX_X - MIN_X) / STEP) + 1;
-    
-    ExpLookupTable() {
-        for (size_t i = 0; i < TABLE_SIZE; i++) {
-            double x = MIN_X + i * STEP;
-            table_[i] = std::exp(x);
-        }
-    }
-    
-    inline double lookup(double x) const {
-        if (x < MIN_X) return std::exp(MIN_X);
-        if (x > MAX_X) return std::exp(MAX_X);
-        
-        size_t idx = static_cast<size_t>((x - MIN_X) / STEP);
-        if (idx >= TABLE_SIZE) idx = TABLE_SIZE - 1;
-        
-        return table_[idx];
-    }
-    
-    inline double lookup_interp(double x) const {
-        if (x < MIN_X) return std::exp(MIN_X);
-        if (x > MAX_X) return std::exp(MAX_X);
-        
-        double fractional_idx = (x - MIN_X) / STEP;
-        size_t idx = static_cast<size_t>(fractional_idx);
-        if (idx >= TABLE_SIZE - 1) return table_[TABLE_SIZE - 1];
-        
-        double frac = fractional_idx - idx;
-        return table_[idx] * (1.0 - frac) + table_[idx + 1] * frac;
-    }
+// ====
+// Idle Policy
+// ====
 
-private:
-    alignas(64) std::array<double, TABLE_SIZE> table_;
+enum class IdlePolicy : uint8_t {
+    SPIN,       // One pause per empty pass: lowest wake latency, 100% of the core
+    BACKOFF,    // Spin, then exponentially longer pause bursts, then optional sleep
+    UMWAIT      // umonitor/umwait on the task doorbell (WAITPKG); BACKOFF without it
 };
 
-/**
- * Pre-computed square root table
- * 
- * Range: [0.0, 1000.0]
- * Precision: 0.01 steps = 100,000 entries
- */
-class SqrtLookupTable {
-public:
-    static constexpr double MIN_X = 0.0;
-    static constexpr double MAX_X = 1000.0;
-    static constexpr double STEP = 0.01;
-    static constexpr size_t TABLE_SIZE = static_cast<size_t>((MAX_X - MIN_X) / STEP) + 1;
-    
-    SqrtLookupTable() {
-        for (size_t i = 0; i < TABLE_SIZE; i++) {
-            double x = MIN_X + i * STEP;
-            table_[i] = std::sqrt(x);
-        }
-    }
-    
-    inline double lookup(double x) const {
-        if (x < MIN_X) return 0.0;
-        if (x > MAX_X) return std::sqrt(MAX_X);
-        
-        size_t idx = static_cast<size_t>((x - MIN_X) / STEP);
-        if (idx >= TABLE_SIZE) idx = TABLE_SIZE - 1;
-        
-        return table_[idx];
-    }
-    
-    inline double lookup_interp(double x) const {
-        if (x < MIN_X) return 0.0;
-        if (x > MAX_X) return std::sqrt(MAX_X);
-        
-        double fractional_idx = (x - MIN_X) / STEP;
-        size_t idx = static_cast<size_t>(fractional_idx);
-        if (idx >= TABLE_SIZE - 1) return table_[TABLE_SIZE - 1];
-        
-        double frac = fractional_idx - idx;
-        return table_[idx] * (1.0 - frac) + table_[idx + 1] * frac;
-    }
-
-private:
-    alignas(64) std::array<double, TABLE_SIZE> table_;
+struct IdleConfig {
+    IdlePolicy policy = IdlePolicy::SPIN;
+    uint32_t spin_passes = 1024;        // Empty passes at one pause before backing off
+    uint32_t max_pause_burst = 64;      // BACKOFF: cap on pauses per empty pass
+    uint32_t sleep_ns = 0;              // BACKOFF: sleep per pass once at the cap (0: never)
+    uint32_t umwait_cycles = 20000;     // UMWAIT: TSC deadline per wait (~5-10 us)
 };
 
-/**
- * Global LUT instances (singleton pattern)
- */
-inline LnLookupTable& get_ln_lut() {
-    static LnLookupTable lut;
-    return lut;
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(_M_X64)
+    _mm_pause();  // x86 PAUSE instruction
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    __asm__ __volatile__("yield");  // ARM YIELD instruction
+#endif
 }
 
-inline ExpLookupTable& get_exp_lut() {
-    static ExpLookupTable lut;
-    return lut;
-}
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #define HFT_SPIN_UMWAIT 1
+#endif
 
-inline SqrtLookupTable& get_sqrt_lut() {
-    static SqrtLookupTable lut;
-    return lut;
+// CPU has user-mode monitor/wait (CPUID.7.0:ECX bit 5)
+inline bool umwait_supported() {
+#if defined(HFT_SPIN_UMWAIT)
+    static const bool supported = [] {
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ecx & (1u << 5)) != 0;
+    }();
+    return supported;
+#else
+    return false;
+#endif
 }
 
-// Fast math functions using LUTs
-inline double fast_ln(double x) { return get_ln_lut().lookup(x); }
-inline double fast_exp(double x) { return get_exp_lut().lookup(x); }
-inline double fast_sqrt(double x) { return get_sqrt_lut().lookup(x); }
+#if defined(HFT_SPIN_UMWAIT)
+// Arm the monitor on `address`'s line; the caller re-checks its condition
+// before umwait_until()
+__attribute__((target("waitpkg"))) inline void umonitor(const void* address) {
+    _umonitor(const_cast<void*>(address));
+}
 
-// Interpolated versions (slightly slower but more accurate)
-inline double fast_ln_interp(double x) { return get_ln_lut().lookup_interp(x); }
-inline double fast_exp_interp(double x) { return get_exp_lut().lookup_interp(x); }
-inline double fast_sqrt_interp(double x) { return get_sqrt_lut().lookup_interp(x); }
+// Light C0.2 wait until the line is written or the TSC passes `deadline`
+__attribute__((target("waitpkg"))) inline void umwait_until(uint64_t deadline) {
+    _umwait(0, deadline);
+}
+#endif
 
 // ====
 // Spin-Loop Engine
 // ====
 
 /**
- * Single-threaded busy-wait engine for critical path processing
+ * Single-threaded poll loop for critical path processing.
+ *
+ * Each pass drains up to TASK_BURST tasks from an MPSC ring (submit() is
+ * safe from any thread; a Task is any callable, by default an
+ * InlineFunction so nothing allocates), then calls every registered poller
+ * once. Pollers are poll-mode sources, e.g. NIC rx, a shm ring or a timer,
+ * returning how much work they found. A pass with no work runs the idle
+ * policy, so one pinned core can multiplex several sources while the cores
+ * that don't need nanosecond wake-up stop burning power and their
+ * hyperthread sibling's issue slots.
+ *
+ * Pollers are added before start(). cpu_id < 0 leaves the thread unpinned
+ * at normal priority. Tasks still queued at stop() run before the thread
+ * exits.
  */
-template<typename WorkFunc>
+template<typename Task = InlineFunction<void(), 64>, size_t QueueSize = 1024>
 class SpinLoopEngine {
 public:
-    SpinLoopEngine(int cpu_id = 0) 
-        : running_(false), 
-          work_available_(false),
-          cpu_id_(cpu_id) {}
-    
+    using Poller = InlineFunction<size_t(), 64>;
+    static constexpr size_t MAX_POLLERS = 8;
+    static constexpr size_t TASK_BURST = 32;    // Tasks per pass, so pollers are never starved
+
+    explicit SpinLoopEngine(int cpu_id = 0, IdleConfig idle = IdleConfig{})
+        : running_(false),
+          cpu_id_(cpu_id),
+          idle_(idle) {
+        if (idle_.policy == IdlePolicy::UMWAIT && !umwait_supported()) {
+            idle_.policy = IdlePolicy::BACKOFF;
+        }
+    }
+
+    SpinLoopEngine(const SpinLoopEngine&) = delete;
+    SpinLoopEngine& operator=(const SpinLoopEngine&) = delete;
+
     /**
-     * Start the spin loop on dedicated thread
+     * Register a polled source; false once MAX_POLLERS are taken or the
+     * loop is running
      */
-    void start(WorkFunc work_func) {
-        running_.store(true, std::memory_order_release);
-        
-        thread_ = std::thread([this, work_func]() {
-            // Pin to CPU core
-            if (!pin_to_cpu(cpu_id_)) {
-                // Warning: Could not pin to CPU
-            }
-            
-            // Set real-time priority
-            if (!set_realtime_priority()) {
-                // Warning: Could not set real-time priority
+    template<typename F>
+    bool add_poller(F&& poller) {
+        if (poller_count_ >= MAX_POLLERS || running_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        pollers_[poller_count_++] = Poller(std::forward<F>(poller));
+        return true;
+    }
+
+    /**
+     * Poller calling fn() every period_ns (steady_clock via the TSC)
+     */
+    template<typename F>
+    bool add_timer(int64_t period_ns, F&& fn) {
+        return add_poller([fn = std::forward<F>(fn), period_ns, next_ns = int64_t(0)]() mutable -> size_t {
+            const int64_t t = tsc::ClockService::instance().now_ns();
+            if (t < next_ns) return 0;
+            next_ns = (next_ns == 0 ? t : next_ns) + period_ns;
+            if (next_ns <= t) next_ns = t + period_ns;  // Fell behind: skip, don't burst
+            fn();
+            return 1;
+        });
+    }
+
+    /**
+     * Queue a task from any thread; false when the ring is full
+     */
+    bool submit(Task task) {
+        if (!tasks_.emplace(std::move(task))) {
+            return false;
+        }
+        // Pairs with the fence in wait_idle(): either the loop sees the
+        // task in its re-check, or we see it parked and ring the doorbell
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parked_.load(std::memory_order_relaxed)) {
+            doorbell_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    /**
+     * Start the loop on a dedicated thread
+     */
+    void start() {
+        if (running_.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+        thread_ = std::thread([this]() {
+            if (cpu_id_ >= 0) {
+                // Warning only: the loop still runs unpinned
+                pin_to_cpu(cpu_id_);
+                set_realtime_priority();
             }
-            
-            // Busy-wait spin loop (100% CPU usage)
+
+            uint32_t idle_passes = 0;
             while (running_.load(std::memory_order_acquire)) {
-                // Check if work is available (atomic, very fast)
-                if (work_available_.load(std::memory_order_acquire)) {
-                    // Execute work immediately
-                    work_func();
-                    
-                    // Mark work as done
-                    work_available_.store(false, std::memory_order_release);
+                if (run_pass() > 0) {
+                    idle_passes = 0;
+                } else {
+                    wait_idle(idle_passes++);
                 }
-                
-                // Optional: Add pause instruction to reduce power/heat
-                // (adds ~1-2ns but saves CPU power)
-                #if defined(__x86_64__) || defined(_M_X64)
-                    _mm_pause();  // x86 PAUSE instruction
-                #elif defined(__aarch64__) || defined(_M_ARM64)
-                    __asm__ __volatile__("yield");  // ARM YIELD instruction
-                #endif
+            }
+            Task task;
+            while (tasks_.pop(task)) {
+                task();
+                bump(tasks_run_);
             }
         });
     }
-    
-    /**
-     * Signal work is available
-     */
-    inline void signal_work() {
-        work_available_.store(true, std::memory_order_release);
-    }
-    
+
     /**
-     * Stop the spin loop
+     * Stop the loop after its current pass
      */
     void stop() {
         running_.store(false, std::memory_order_release);
+        doorbell_.fetch_add(1, std::memory_order_relaxed);  // Wake a parked loop
         if (thread_.joinable()) {
             thread_.join();
         }
     }
-    
+
     ~SpinLoopEngine() {
         stop();
     }
 
+    IdlePolicy idle_policy() const { return idle_.policy; }
+    uint64_t tasks_run() const { return tasks_run_.load(std::memory_order_relaxed); }
+    uint64_t idle_passes() const { return idle_passes_.load(std::memory_order_relaxed); }
+
 private:
+    // Loop-thread counters: plain store, no RMW on the hot path
+    static void bump(std::atomic<uint64_t>& counter, uint64_t n = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    size_t run_pass() {
+        size_t work = 0;
+        Task task;
+        while (work < TASK_BURST && tasks_.pop(task)) {
+            task();
+            ++work;
+        }
+        if (work > 0) {
+            bump(tasks_run_, work);
+        }
+        for (size_t i = 0; i < poller_count_; ++i) {
+            work += pollers_[i]();
+        }
+        return work;
+    }
+
+    void wait_idle(uint32_t pass) {
+        bump(idle_passes_);
+        if (idle_.policy == IdlePolicy::SPIN || pass < idle_.spin_passes) {
+            cpu_relax();
+            return;
+        }
+
+#if defined(HFT_SPIN_UMWAIT)
+        if (idle_.policy == IdlePolicy::UMWAIT) {
+            // Pollers' sources don't write the doorbell, so the deadline
+            // bounds how stale a poll can get
+            parked_.store(true, std::memory_order_relaxed);
+            umonitor(&doorbell_);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (tasks_.empty() && running_.load(std::memory_order_relaxed)) {
+                umwait_until(tsc::read_counter() + idle_.umwait_cycles);
+            }
+            parked_.store(false, std::memory_order_relaxed);
+            return;
+        }
+#endif
+
+        const uint32_t step = std::min<uint32_t>(pass - idle_.spin_passes, 31);
+        const uint32_t burst = std::min<uint32_t>(uint32_t(1) << std::min<uint32_t>(step, 16), idle_.max_pause_burst);
+        if (burst == idle_.max_pause_burst && idle_.sleep_ns > 0) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(idle_.sleep_ns));
+            return;
+        }
+        for (uint32_t i = 0; i < burst; ++i) {
+            cpu_relax();
+        }
+    }
+
+    MPSCQueue<Task, QueueSize> tasks_;
+    std::array<Poller, MAX_POLLERS> pollers_;
+    size_t poller_count_ = 0;
+
     std::atomic<bool> running_;
-    std::atomic<bool> work_available_;
     std::thread thread_;
     int cpu_id_;
+    IdleConfig idle_;
+
+    // Doorbell line: written by submit()/stop() only while the loop is parked
+    alignas(64) std::atomic<uint64_t> doorbell_{0};
+    std::atomic<bool> parked_{false};
+
+    alignas(64) std::atomic<uint64_t> tasks_run_{0};
+    std::atomic<uint64_t> idle_passes_{0};
 };
 
 } // namespace spin_loop
@@ -0,0 +1,250 @@
+#pragma once
+
+#include "avellaneda_stoikov.hpp"
+#include "common_types.hpp"
+#include "compile_time_dispatch.hpp"
+#include "fpga_inference.hpp"
+#include "hot_path_trace.hpp"
+#include "risk_control.hpp"
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Tick-to-Quote Pipeline
+ *
+ * One templated hot path, features -> model -> quoting -> risk, that the
+ * live loop (src/main.cpp) and BacktestingEngine both instantiate. Each
+ * stage is a policy type chosen at compile time, so the whole path is one
+ * inlinable call with no virtual or opaque member calls between stages,
+ * and the compile-time policies fold their limits from
+ * StrategyParameters<...> / RiskParameters<...> into immediates.
+ *
+ * Policy interface (duck-typed):
+ *   Features:  auto extract(const TickContext&)
+ *   Model:     std::array<double, 3> predict(const <Features result>&)
+ *   Quoting:   void quote(const TickContext&, Decision&)   quotes, latency_cost, should_quote
+ *   Risk:      void check(const TickContext&, Decision&)   bid_approved, ask_approved
+ *
+ * Runtime policies wrap the existing engines by pointer (the caller owns
+ * them); compile-time policies are empty types.
+ */
+
+namespace hft {
+namespace pipeline {
+
+// Per-tick inputs; the book, Hawkes state and position stay with the caller
+struct TickContext {
+    const MarketTick& tick;
+    const MarketTick& reference;        // Cross-asset features; the tick itself if none
+    double buy_intensity = 0.0;
+    double sell_intensity = 0.0;
+    int64_t position = 0;
+    double volatility = 0.0;            // Annualized
+    double time_remaining = 0.0;        // Seconds
+    double daily_pnl = 0.0;
+    uint64_t order_id = 0;              // Bid id for the risk check; the ask takes order_id + 1
+};
+
+struct Decision {
+    std::array<double, 3> prediction{}; // Buy, hold, sell
+    QuotePair quotes;
+    double latency_cost = 0.0;
+    bool should_quote = false;          // Quoting policy expects the spread to pay for latency
+    bool bid_approved = false;
+    bool ask_approved = false;
+};
+
+// Gate and probe used when the caller passes none
+struct AlwaysQuote {
+    bool operator()(const Decision&) const { return true; }
+};
+
+struct NoProbe {
+    void mark(TraceStage) const {}
+};
+
+// ====
+// Pipeline
+// ====
+
+template<typename Features, typename Model, typename Quoting, typename Risk>
+class StrategyPipeline {
+public:
+    StrategyPipeline(Features features, Model model, Quoting quoting, Risk risk)
+        : features_(std::move(features)), model_(std::move(model)),
+          quoting_(std::move(quoting)), risk_(std::move(risk)) {}
+
+    Decision on_tick(const TickContext& ctx) {
+        return on_tick(ctx, AlwaysQuote{}, NoProbe{});
+    }
+
+    /**
+     * Full path for one tick. `gate(decision)` runs after the model; false
+     * stops there (no quotes, nothing approved). `probe.mark(stage)` is
+     * called after each stage (FEATURES, INFERENCE, QUOTE, RISK), e.g. with
+     * a TraceThread. Risk only runs on two-sided quotes.
+     */
+    template<typename Gate, typename Probe = NoProbe>
+    Decision on_tick(const TickContext& ctx, Gate&& gate, Probe&& probe = Probe{}) {
+        Decision decision;
+        const auto features = features_.extract(ctx);
+        probe.mark(TraceStage::FEATURES);
+        decision.prediction = model_.predict(features);
+        probe.mark(TraceStage::INFERENCE);
+        if (!gate(decision)) {
+            return decision;
+        }
+
+        quoting_.quote(ctx, decision);
+        probe.mark(TraceStage::QUOTE);
+        if (decision.quotes.bid_price > 0.0 && decision.quotes.ask_price > 0.0) {
+            risk_.check(ctx, decision);
+            probe.mark(TraceStage::RISK);
+        }
+        return decision;
+    }
+
+    Features& features() { return features_; }
+    Model& model() { return model_; }
+    Quoting& quoting() { return quoting_; }
+    Risk& risk() { return risk_; }
+
+private:
+    Features features_;
+    Model model_;
+    Quoting quoting_;
+    Risk risk_;
+};
+
+// ====
+// Runtime Policies
+// ====
+
+// MicrostructureFeatures through the FPGA engine's SIMD feature path
+class FpgaFeatures {
+public:
+    explicit FpgaFeatures(FPGA_DNN_Inference& engine) : engine_(&engine) {}
+
+    MicrostructureFeatures extract(const TickContext& ctx) const {
+        return engine_->extract_features(ctx.tick, ctx.reference, ctx.buy_intensity, ctx.sell_intensity);
+    }
+
+private:
+    FPGA_DNN_Inference* engine_;
+};
+
+class FpgaModel {
+public:
+    explicit FpgaModel(FPGA_DNN_Inference& engine) : engine_(&engine) {}
+
+    std::array<double, 3> predict(const MicrostructureFeatures& features) const {
+        return engine_->predict(features);
+    }
+
+private:
+    FPGA_DNN_Inference* engine_;
+};
+
+// Avellaneda-Stoikov quotes widened by the latency cost at ctx.volatility
+class AvellanedaStoikovQuoting {
+public:
+    explicit AvellanedaStoikovQuoting(const DynamicMMStrategy& strategy) : strategy_(&strategy) {}
+
+    void quote(const TickContext& ctx, Decision& decision) const {
+        decision.latency_cost = strategy_->calculate_latency_cost(ctx.volatility, ctx.tick.mid_price);
+        decision.quotes = strategy_->calculate_quotes(ctx.tick.mid_price, ctx.position,
+                                                      ctx.time_remaining, decision.latency_cost);
+        decision.should_quote = strategy_->should_quote(decision.quotes.spread, decision.latency_cost);
+    }
+
+private:
+    const DynamicMMStrategy* strategy_;
+};
+
+// RiskControl pre-trade limits on each side of the quote
+class RiskControlCheck {
+public:
+    explicit RiskControlCheck(const RiskControl& risk) : risk_(&risk) {}
+
+    void check(const TickContext& ctx, Decision& decision) const {
+        const QuotePair& q = decision.quotes;
+        const Order bid(ctx.order_id, ctx.tick.asset_id, Side::BUY, q.bid_price, static_cast<uint64_t>(q.bid_size));
+        const Order ask(ctx.order_id + 1, ctx.tick.asset_id, Side::SELL, q.ask_price, static_cast<uint64_t>(q.ask_size));
+        decision.bid_approved = risk_->check_pre_trade_limits(bid, ctx.position);
+        decision.ask_approved = risk_->check_pre_trade_limits(ask, ctx.position);
+    }
+
+private:
+    const RiskControl* risk_;
+};
+
+// ====
+// Compile-Time Policies
+// ====
+
+// CompileTimeStrategyEngine<Strategy>; no latency cost model
+template<typename Strategy>
+struct CompileTimeQuoting {
+    using Engine = compile_time::CompileTimeStrategyEngine<Strategy>;
+
+    void quote(const TickContext& ctx, Decision& decision) const {
+        const auto q = Engine::compute_quotes(ctx.tick.mid_price, static_cast<double>(ctx.position),
+                                              ctx.volatility, ctx.time_remaining);
+        decision.quotes.mid_price = ctx.tick.mid_price;
+        decision.quotes.bid_price = q.bid_price;
+        decision.quotes.ask_price = q.ask_price;
+        decision.quotes.bid_size = q.bid_size;
+        decision.quotes.ask_size = q.ask_size;
+        decision.quotes.spread = q.ask_price - q.bid_price;
+        decision.latency_cost = 0.0;
+        decision.should_quote = decision.quotes.spread > 0.0;
+    }
+};
+
+// CompileTimeRiskChecker<RiskPolicy>; every limit is a constant
+template<typename RiskPolicy>
+struct CompileTimeRisk {
+    using Checker = compile_time::CompileTimeRiskChecker<RiskPolicy>;
+
+    void check(const TickContext& ctx, Decision& decision) const {
+        const QuotePair& q = decision.quotes;
+        const double spread_bps = q.spread / ctx.tick.mid_price * 10000.0;
+        const double position = static_cast<double>(ctx.position);
+        decision.bid_approved = Checker::check_order(position, q.bid_size, Side::BUY, ctx.daily_pnl, spread_bps);
+        decision.ask_approved = Checker::check_order(position, q.ask_size, Side::SELL, ctx.daily_pnl, spread_bps);
+    }
+};
+
+// ====
+// Configurations
+// ====
+
+// Live loop and BacktestingEngine
+using ProductionPipeline = StrategyPipeline<FpgaFeatures, FpgaModel, AvellanedaStoikovQuoting, RiskControlCheck>;
+
+inline ProductionPipeline make_production_pipeline(FPGA_DNN_Inference& inference,
+                                                   const DynamicMMStrategy& strategy,
+                                                   const RiskControl& risk) {
+    return ProductionPipeline(FpgaFeatures(inference), FpgaModel(inference),
+                              AvellanedaStoikovQuoting(strategy), RiskControlCheck(risk));
+}
+
+// Quoting and risk fully static
+template<typename Strategy, typename RiskPolicy>
+using CompileTimePipeline =
+    StrategyPipeline<FpgaFeatures, FpgaModel, CompileTimeQuoting<Strategy>, CompileTimeRisk<RiskPolicy>>;
+
+template<typename Strategy, typename RiskPolicy>
+CompileTimePipeline<Strategy, RiskPolicy> make_compile_time_pipeline(FPGA_DNN_Inference& inference) {
+    return CompileTimePipeline<Strategy, RiskPolicy>(FpgaFeatures(inference), FpgaModel(inference),
+                                                     CompileTimeQuoting<Strategy>{},
+                                                     CompileTimeRisk<RiskPolicy>{});
+}
+
+static_assert(std::is_empty<CompileTimeRisk<compile_time::ModerateRiskPolicy>>::value,
+              "compile-time policies carry no state");
+
+} // namespace pipeline
+} // namespace hft
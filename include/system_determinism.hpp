@@ -12,6 +12,16 @@
     #include <sys/mman.h>
     #include <sys/resource.h>
     #include <unistd.h>
+    // Older glibc headers only expose the page-size flags via <linux/mman.h>
+    #ifndef MAP_HUGE_SHIFT
+        #define MAP_HUGE_SHIFT 26
+    #endif
+    #ifndef MAP_HUGE_2MB
+        #define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+    #endif
+    #ifndef MAP_HUGE_1GB
+        #define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+    #endif
     // NUMA library (install with: apt-get install libnuma-dev)
     // #include <numa.h>  // Uncomment if libnuma is installed
 #endif
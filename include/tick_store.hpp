@@ -0,0 +1,351 @@
+#pragma once
+
+#include "common_types.hpp"
+#include "mapped_file.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace hft {
+namespace backtest {
+
+// ====
+// Columnar Binary Tick Store
+// One file per replay unit (e.g. symbol-day), written once, mmapped read-only.
+// Each field is a contiguous 64-byte-aligned column, so a replay streams a
+// handful of sequential arrays straight out of the page cache instead of
+// parsing text or holding ~370-byte HistoricalEvents in RAM.
+// ====
+
+namespace tick_store {
+
+constexpr char MAGIC[8] = {'H', 'F', 'T', 'T', 'I', 'C', 'K', 'S'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t DEPTH = 10;
+constexpr size_t COLUMN_ALIGN = 64;
+
+// Header flags
+constexpr uint32_t FLAG_SORTED = 1u << 0;      // Events in timestamp order
+constexpr uint32_t FLAG_HAS_DEPTH = 1u << 1;   // 10-level depth columns present
+
+enum Column : uint32_t {
+    TIMESTAMP_NS,
+    ASSET_ID,
+    EVENT_TYPE,
+    TRADE_SIDE,
+    DEPTH_LEVELS,
+    BID_PRICE,
+    ASK_PRICE,
+    BID_SIZE,
+    ASK_SIZE,
+    TRADE_PRICE,
+    TRADE_VOLUME,
+    BID_PRICES,     // DEPTH values per event (FLAG_HAS_DEPTH only)
+    ASK_PRICES,
+    BID_SIZES,
+    ASK_SIZES,
+    NUM_COLUMNS
+};
+
+// Bytes per event for each column
+constexpr size_t COLUMN_WIDTH[NUM_COLUMNS] = {
+    8, 4, 1, 1, 1, 8, 8, 8, 8, 8, 8,
+    8 * DEPTH, 8 * DEPTH, 8 * DEPTH, 8 * DEPTH
+};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t event_count;
+    int64_t min_timestamp_ns;
+    int64_t max_timestamp_ns;
+    uint64_t column_offset[NUM_COLUMNS];   // 0 = column absent
+    uint64_t file_size;
+};
+
+inline size_t align_up(size_t v) {
+    return (v + COLUMN_ALIGN - 1) & ~(COLUMN_ALIGN - 1);
+}
+
+} // namespace tick_store
+
+using hft::MappedFile;
+
+// Builds a tick store. Buffers compact columns (~60 bytes/event without
+// depth) and sorts by timestamp on write if the input was out of order.
+class TickStoreWriter {
+public:
+    explicit TickStoreWriter(bool with_depth = false) : with_depth_(with_depth) {}
+
+    void reserve(size_t n) {
+        timestamp_.reserve(n);
+        asset_id_.reserve(n);
+        event_type_.reserve(n);
+        trade_side_.reserve(n);
+        depth_levels_.reserve(n);
+        bid_price_.reserve(n);
+        ask_price_.reserve(n);
+        bid_size_.reserve(n);
+        ask_size_.reserve(n);
+        trade_price_.reserve(n);
+        trade_volume_.reserve(n);
+    }
+
+    template<typename Event>
+    void append(const Event& e) {
+        if (!timestamp_.empty() && e.timestamp_ns < timestamp_.back()) {
+            sorted_ = false;
+        }
+        timestamp_.push_back(e.timestamp_ns);
+        asset_id_.push_back(e.asset_id);
+        event_type_.push_back(e.event_type);
+        trade_side_.push_back(static_cast<uint8_t>(e.trade_side));
+        depth_levels_.push_back(e.depth_levels);
+        bid_price_.push_back(e.bid_price);
+        ask_price_.push_back(e.ask_price);
+        bid_size_.push_back(e.bid_size);
+        ask_size_.push_back(e.ask_size);
+        trade_price_.push_back(e.trade_price);
+        trade_volume_.push_back(e.trade_volume);
+        if (with_depth_) {
+            bid_prices_.insert(bid_prices_.end(), e.bid_prices, e.bid_prices + tick_store::DEPTH);
+            ask_prices_.insert(ask_prices_.end(), e.ask_prices, e.ask_prices + tick_store::DEPTH);
+            bid_sizes_.insert(bid_sizes_.end(), e.bid_sizes, e.bid_sizes + tick_store::DEPTH);
+            ask_sizes_.insert(ask_sizes_.end(), e.ask_sizes, e.ask_sizes + tick_store::DEPTH);
+        }
+    }
+
+    size_t size() const { return timestamp_.size(); }
+
+    // Writes the file; returns events written. Throws std::runtime_error on I/O failure.
+    size_t write(const std::string& path) const {
+        using namespace tick_store;
+        const size_t n = size();
+
+        // Stable order keeps same-timestamp events in arrival order
+        std::vector<uint32_t> order;
+        if (!sorted_) {
+            order.resize(n);
+            std::iota(order.begin(), order.end(), 0u);
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+                return timestamp_[a] < timestamp_[b];
+            });
+        }
+
+        FileHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.flags = FLAG_SORTED | (with_depth_ ? FLAG_HAS_DEPTH : 0u);
+        header.event_count = n;
+        if (n > 0) {
+            header.min_timestamp_ns = *std::min_element(timestamp_.begin(), timestamp_.end());
+            header.max_timestamp_ns = *std::max_element(timestamp_.begin(), timestamp_.end());
+        }
+
+        size_t offset = align_up(sizeof(FileHeader));
+        const uint32_t num_columns = with_depth_ ? NUM_COLUMNS : BID_PRICES;
+        for (uint32_t c = 0; c < num_columns; ++c) {
+            header.column_offset[c] = offset;
+            offset = align_up(offset + COLUMN_WIDTH[c] * n);
+        }
+        header.file_size = offset;
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Failed to create tick store: " + path);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        size_t written = sizeof(header);
+        auto pad_to = [&](size_t target) {
+            static const char zeros[COLUMN_ALIGN] = {};
+            while (written < target) {
+                const size_t k = std::min(target - written, COLUMN_ALIGN);
+                out.write(zeros, static_cast<std::streamsize>(k));
+                written += k;
+            }
+        };
+
+        auto write_column = [&](Column c, const auto& values, size_t per_event) {
+            pad_to(header.column_offset[c]);
+            using V = typename std::decay_t<decltype(values)>::value_type;
+            if (sorted_) {
+                out.write(reinterpret_cast<const char*>(values.data()),
+                          static_cast<std::streamsize>(values.size() * sizeof(V)));
+            } else {
+                for (uint32_t idx : order) {
+                    out.write(reinterpret_cast<const char*>(&values[idx * per_event]),
+                              static_cast<std::streamsize>(per_event * sizeof(V)));
+                }
+            }
+            written += values.size() * sizeof(V);
+        };
+
+        write_column(TIMESTAMP_NS, timestamp_, 1);
+        write_column(ASSET_ID, asset_id_, 1);
+        write_column(EVENT_TYPE, event_type_, 1);
+        write_column(TRADE_SIDE, trade_side_, 1);
+        write_column(DEPTH_LEVELS, depth_levels_, 1);
+        write_column(BID_PRICE, bid_price_, 1);
+        write_column(ASK_PRICE, ask_price_, 1);
+        write_column(BID_SIZE, bid_size_, 1);
+        write_column(ASK_SIZE, ask_size_, 1);
+        write_column(TRADE_PRICE, trade_price_, 1);
+        write_column(TRADE_VOLUME, trade_volume_, 1);
+        if (with_depth_) {
+            write_column(BID_PRICES, bid_prices_, DEPTH);
+            write_column(ASK_PRICES, ask_prices_, DEPTH);
+            write_column(BID_SIZES, bid_sizes_, DEPTH);
+            write_column(ASK_SIZES, ask_sizes_, DEPTH);
+        }
+        pad_to(header.file_size);
+
+        if (!out) {
+            throw std::runtime_error("Failed to write tick store: " + path);
+        }
+        return n;
+    }
+
+private:
+    bool with_depth_;
+    bool sorted_ = true;
+
+    std::vector<int64_t> timestamp_;
+    std::vector<uint32_t> asset_id_;
+    std::vector<uint8_t> event_type_;
+    std::vector<uint8_t> trade_side_;
+    std::vector<uint8_t> depth_levels_;
+    std::vector<double> bid_price_;
+    std::vector<double> ask_price_;
+    std::vector<uint64_t> bid_size_;
+    std::vector<uint64_t> ask_size_;
+    std::vector<double> trade_price_;
+    std::vector<uint64_t> trade_volume_;
+    std::vector<double> bid_prices_;
+    std::vector<double> ask_prices_;
+    std::vector<uint64_t> bid_sizes_;
+    std::vector<uint64_t> ask_sizes_;
+};
+
+// Zero-copy view over a tick store file. Columns are read in place from the
+// mapping; read() assembles one event on demand.
+class TickStoreReader {
+public:
+    explicit TickStoreReader(const std::string& path) : file_(path) {
+        using namespace tick_store;
+
+        if (file_.size() < sizeof(FileHeader)) {
+            throw std::runtime_error("Tick store too small: " + path);
+        }
+        std::memcpy(&header_, file_.data(), sizeof(FileHeader));
+        if (std::memcmp(header_.magic, MAGIC, sizeof(MAGIC)) != 0) {
+            throw std::runtime_error("Not a tick store: " + path);
+        }
+        if (header_.version != VERSION) {
+            throw std::runtime_error("Unsupported tick store version: " + path);
+        }
+        if (header_.file_size > file_.size()) {
+            throw std::runtime_error("Truncated tick store: " + path);
+        }
+
+        const uint32_t num_columns = has_depth() ? NUM_COLUMNS : BID_PRICES;
+        for (uint32_t c = 0; c < num_columns; ++c) {
+            const uint64_t off = header_.column_offset[c];
+            if (off == 0 || off + COLUMN_WIDTH[c] * header_.event_count > file_.size()) {
+                throw std::runtime_error("Corrupt tick store column table: " + path);
+            }
+        }
+
+        timestamp_ = column<int64_t>(TIMESTAMP_NS);
+        asset_id_ = column<uint32_t>(ASSET_ID);
+        event_type_ = column<uint8_t>(EVENT_TYPE);
+        trade_side_ = column<uint8_t>(TRADE_SIDE);
+        depth_levels_ = column<uint8_t>(DEPTH_LEVELS);
+        bid_price_ = column<double>(BID_PRICE);
+        ask_price_ = column<double>(ASK_PRICE);
+        bid_size_ = column<uint64_t>(BID_SIZE);
+        ask_size_ = column<uint64_t>(ASK_SIZE);
+        trade_price_ = column<double>(TRADE_PRICE);
+        trade_volume_ = column<uint64_t>(TRADE_VOLUME);
+        if (has_depth()) {
+            bid_prices_ = column<double>(BID_PRICES);
+            ask_prices_ = column<double>(ASK_PRICES);
+            bid_sizes_ = column<uint64_t>(BID_SIZES);
+            ask_sizes_ = column<uint64_t>(ASK_SIZES);
+        }
+    }
+
+    size_t size() const { return static_cast<size_t>(header_.event_count); }
+    bool empty() const { return size() == 0; }
+    bool is_sorted() const { return header_.flags & tick_store::FLAG_SORTED; }
+    bool has_depth() const { return header_.flags & tick_store::FLAG_HAS_DEPTH; }
+    int64_t min_timestamp_ns() const { return header_.min_timestamp_ns; }
+    int64_t max_timestamp_ns() const { return header_.max_timestamp_ns; }
+
+    int64_t timestamp_ns(size_t i) const { return timestamp_[i]; }
+    const int64_t* timestamps() const { return timestamp_; }
+
+    // Assemble event i. Depth arrays are only written when the store has them,
+    // so a reused scratch event keeps zeros from construction.
+    template<typename Event>
+    void read(size_t i, Event& e) const {
+        e.timestamp_ns = timestamp_[i];
+        e.asset_id = asset_id_[i];
+        e.event_type = event_type_[i];
+        e.trade_side = static_cast<Side>(trade_side_[i]);
+        e.depth_levels = depth_levels_[i];
+        e.bid_price = bid_price_[i];
+        e.ask_price = ask_price_[i];
+        e.bid_size = bid_size_[i];
+        e.ask_size = ask_size_[i];
+        e.trade_price = trade_price_[i];
+        e.trade_volume = trade_volume_[i];
+        if (has_depth()) {
+            const size_t base = i * tick_store::DEPTH;
+            std::memcpy(e.bid_prices, bid_prices_ + base, sizeof(e.bid_prices));
+            std::memcpy(e.ask_prices, ask_prices_ + base, sizeof(e.ask_prices));
+            std::memcpy(e.bid_sizes, bid_sizes_ + base, sizeof(e.bid_sizes));
+            std::memcpy(e.ask_sizes, ask_sizes_ + base, sizeof(e.ask_sizes));
+        }
+    }
+
+    // First index with timestamp >= ts (store must be sorted)
+    size_t lower_bound(int64_t ts) const {
+        return static_cast<size_t>(std::lower_bound(timestamp_, timestamp_ + size(), ts) - timestamp_);
+    }
+
+private:
+    MappedFile file_;
+    tick_store::FileHeader header_;
+
+    const int64_t* timestamp_ = nullptr;
+    const uint32_t* asset_id_ = nullptr;
+    const uint8_t* event_type_ = nullptr;
+    const uint8_t* trade_side_ = nullptr;
+    const uint8_t* depth_levels_ = nullptr;
+    const double* bid_price_ = nullptr;
+    const double* ask_price_ = nullptr;
+    const uint64_t* bid_size_ = nullptr;
+    const uint64_t* ask_size_ = nullptr;
+    const double* trade_price_ = nullptr;
+    const uint64_t* trade_volume_ = nullptr;
+    const double* bid_prices_ = nullptr;
+    const double* ask_prices_ = nullptr;
+    const uint64_t* bid_sizes_ = nullptr;
+    const uint64_t* ask_sizes_ = nullptr;
+
+    template<typename T>
+    const T* column(tick_store::Column c) const {
+        return reinterpret_cast<const T*>(file_.data() + header_.column_offset[c]);
+    }
+};
+
+} // namespace backtest
+} // namespace hft
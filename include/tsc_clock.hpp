@@ -0,0 +1,264 @@
+#pragma once
+
+#include "seqlock.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <cpuid.h>
+    #include <x86intrin.h>
+#endif
+
+namespace hft {
+namespace tsc {
+
+// ====
+// Process-wide TSC Clock
+// hft::now() reads the time-stamp counter and maps it to steady_clock
+// nanoseconds with a fixed-point multiply, instead of a vDSO
+// clock_gettime call. The mapping is calibrated at first use and kept current
+// by a background thread that slews it towards steady_clock, so it stays
+// continuous. It follows NTP frequency adjustments without ever stepping.
+// Without an invariant TSC (or with HFT_CLOCK=steady in the environment)
+// every call falls back to steady_clock and the TSC is never read.
+// ====
+
+// Raw counter: rdtsc on x86, the virtual counter on AArch64, else 0
+inline uint64_t read_counter() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t v;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+#else
+    return 0;
+#endif
+}
+
+// Constant-rate counter that keeps ticking in deep C-states (CPUID
+// 0x80000007 EDX bit 8). The AArch64 generic timer always is.
+inline bool cpu_has_invariant_tsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid_max(0x80000000u, nullptr) < 0x80000007u) return false;
+    __cpuid(0x80000007u, eax, ebx, ecx, edx);
+    return (edx & (1u << 8)) != 0;
+#elif defined(__aarch64__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+__extension__ typedef __int128 int128_t;        // 64x64 multiply without -Wpedantic noise
+
+// ns = base_ns + (counter - base_counter) * mult >> SHIFT
+struct Calibration {
+    static constexpr unsigned SHIFT = 32;
+
+    uint64_t base_counter = 0;
+    int64_t base_ns = 0;
+    uint64_t mult = 0;
+
+    int64_t to_ns(uint64_t counter) const {
+        const int64_t delta = static_cast<int64_t>(counter - base_counter);
+        return base_ns + static_cast<int64_t>((static_cast<int128_t>(delta) * mult) >> SHIFT);
+    }
+
+    double ns_per_cycle() const { return static_cast<double>(mult) / static_cast<double>(uint64_t(1) << SHIFT); }
+};
+
+class ClockService {
+public:
+    static constexpr std::chrono::milliseconds DEFAULT_INTERVAL{1000};
+    static constexpr double MAX_SLEW = 0.05;        // Slope correction per interval
+
+    // Created on first use, never destroyed: static destructors may still
+    // read the clock
+    static ClockService& instance() {
+        static ClockService* service = new ClockService();
+        return *service;
+    }
+
+    ClockService(const ClockService&) = delete;
+    ClockService& operator=(const ClockService&) = delete;
+
+    // Counter value, or steady_clock ns in fallback mode
+    uint64_t now_tsc() const {
+        return enabled_ ? read_counter() : static_cast<uint64_t>(steady_ns());
+    }
+
+    // now_tsc() value to steady_clock ns
+    int64_t tsc_to_ns(uint64_t value) const {
+        return enabled_ ? calibration_.load().to_ns(value) : static_cast<int64_t>(value);
+    }
+
+    int64_t now_ns() const {
+        if (!enabled_) return steady_ns();
+        return calibration_.load().to_ns(read_counter());
+    }
+
+    // True when now() reads the counter
+    bool tsc_enabled() const { return enabled_; }
+    bool invariant_tsc() const { return invariant_; }
+
+    // Current counter rate, measured whenever a counter exists (also in
+    // fallback mode, for scaling raw counter deltas); 0 without one
+    double ns_per_cycle() const { return calibration_.load().ns_per_cycle(); }
+
+    Calibration calibration() const { return calibration_.load(); }
+    uint64_t calibrations() const { return calibration_.version(); }
+
+    // One calibration step: measure the counter rate over the time since
+    // the previous step and slew the published mapping onto steady_clock.
+    // Continuous at the switch, so readers never see time jump.
+    void recalibrate() {
+        std::lock_guard<std::mutex> lock(calibrate_mutex_);
+        if (!has_counter_) return;
+
+        const Sample s = sample();
+        const Calibration current = calibration_.load();
+        if (s.counter <= last_.counter) return;
+
+        const double cycles = static_cast<double>(s.counter - last_.counter);
+        const double rate = static_cast<double>(s.ns - last_.ns) / cycles;
+        // Remove the offset over the next interval, assumed as long as the last
+        const double error_ns = static_cast<double>(s.ns - current.to_ns(s.counter));
+        double slope = rate + error_ns / cycles;
+        slope = std::min(std::max(slope, rate * (1.0 - MAX_SLEW)), rate * (1.0 + MAX_SLEW));
+        last_ = s;
+        if (!(slope > 0.0)) return;
+
+        Calibration next;
+        next.base_counter = read_counter();
+        next.base_ns = current.to_ns(next.base_counter);
+        next.mult = to_mult(slope);
+        calibration_.store(next);
+    }
+
+    // Background recalibration (idempotent). Started on first use when the
+    // TSC is enabled.
+    void start(std::chrono::milliseconds interval = DEFAULT_INTERVAL) {
+        std::lock_guard<std::mutex> lock(thread_mutex_);
+        if (thread_.joinable() || !enabled_) return;
+        interval_ = interval;
+        stop_requested_ = false;
+        thread_ = std::thread([this] { run(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(thread_mutex_);
+            if (!thread_.joinable()) return;
+            stop_requested_ = true;
+        }
+        wake_.notify_all();
+        thread_.join();
+    }
+
+    bool running() const {
+        std::lock_guard<std::mutex> lock(thread_mutex_);
+        return thread_.joinable();
+    }
+
+private:
+    struct Sample {
+        uint64_t counter = 0;
+        int64_t ns = 0;
+    };
+
+    ClockService() {
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+        has_counter_ = true;
+#endif
+        invariant_ = cpu_has_invariant_tsc();
+        const char* mode = std::getenv("HFT_CLOCK");
+        const bool forced_steady = mode && std::strcmp(mode, "steady") == 0;
+        if (!has_counter_) return;
+
+        // Short busy calibration: first use must not block for long. The
+        // background thread refines the rate over whole intervals.
+        const Sample first = sample();
+        while (steady_ns() - first.ns < INITIAL_CALIBRATION_NS) {}
+        last_ = sample();
+        if (last_.counter <= first.counter) return;
+
+        Calibration c;
+        c.base_counter = last_.counter;
+        c.base_ns = last_.ns;
+        c.mult = to_mult(static_cast<double>(last_.ns - first.ns) /
+                         static_cast<double>(last_.counter - first.counter));
+        calibration_.store(c);
+
+        enabled_ = invariant_ && !forced_steady && c.mult > 0;
+        if (enabled_) start();
+    }
+
+    static constexpr int64_t INITIAL_CALIBRATION_NS = 500000;
+
+    static uint64_t to_mult(double ns_per_cycle) {
+        return static_cast<uint64_t>(ns_per_cycle * static_cast<double>(uint64_t(1) << Calibration::SHIFT) + 0.5);
+    }
+
+    // Counter bracketing a steady_clock read; the tightest of a few tries
+    static Sample sample() {
+        Sample best;
+        uint64_t best_width = UINT64_MAX;
+        for (int i = 0; i < 5; ++i) {
+            const uint64_t c0 = read_counter();
+            const int64_t ns = steady_ns();
+            const uint64_t c1 = read_counter();
+            if (c1 - c0 < best_width) {
+                best_width = c1 - c0;
+                best.counter = c0 + (c1 - c0) / 2;
+                best.ns = ns;
+            }
+        }
+        return best;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(thread_mutex_);
+        while (!stop_requested_) {
+            if (wake_.wait_for(lock, interval_, [this] { return stop_requested_; })) break;
+            lock.unlock();
+            recalibrate();
+            lock.lock();
+        }
+    }
+
+    bool has_counter_ = false;
+    bool invariant_ = false;
+    bool enabled_ = false;
+    Seqlock<Calibration> calibration_;
+
+    std::mutex calibrate_mutex_;
+    Sample last_;
+
+    mutable std::mutex thread_mutex_;
+    std::condition_variable wake_;
+    std::thread thread_;
+    std::chrono::milliseconds interval_{DEFAULT_INTERVAL};
+    bool stop_requested_ = false;
+};
+
+} // namespace tsc
+
+// Cheap timestamp pair for hot paths: take now_tsc() where the event
+// happens, convert with tsc_to_ns() off the critical path
+inline uint64_t now_tsc() { return tsc::ClockService::instance().now_tsc(); }
+inline int64_t tsc_to_ns(uint64_t value) { return tsc::ClockService::instance().tsc_to_ns(value); }
+
+} // namespace hft
@@ -1,46 +1,71 @@
 #pragma once
 
+#include "batched_inference.hpp"
+#include "model_file.hpp"
+#include "simd_dispatch.hpp"
 #include <vector>
 #include <array>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
 
-// Platform-specific SIMD intrinsics
-#if defined(__AVX512F__)
-    #include <immintrin.h>
-    #define HAS_AVX512 1
-    #define SIMD_WIDTH 8  // 8 doubles per register
-#elif defined(__AVX2__)
-    #include <immintrin.h>
-    #define HAS_AVX2 1
-    #define SIMD_WIDTH 4  // 4 doubles per register
-#elif defined(__aarch64__) || defined(_M_ARM64)
-    #include <arm_neon.h>
-    #define HAS_NEON 1
-    #define SIMD_WIDTH 2  // 2 doubles per register
-#else
-    #define SIMD_WIDTH 1  // Scalar fallback
-#endif
-
 namespace hft {
 
-class VectorizedInferenceEngine {
+/**
+ * Two-layer network with compile-time shape (In -> Hidden -> 3)
+ * 
+ * Layer sizes are template parameters, so the batched path's loops have
+ * constant trip counts for the deployed model; predict() runs each layer
+ * through the SIMD kernel variant dispatched for this CPU (simd_dispatch.hpp).
+ * Weights come from a binary model file (model_file.hpp) whose header
+ * must match Network.
+ */
+template<size_t In = 10, size_t Hidden = 16, size_t Out = 3>
+class BasicVectorizedInferenceEngine {
 public:
-    static constexpr size_t INPUT_SIZE = 10;
-    static constexpr size_t HIDDEN_SIZE = 16;
-    static constexpr size_t OUTPUT_SIZE = 3;
+    static constexpr size_t INPUT_SIZE = In;
+    static constexpr size_t HIDDEN_SIZE = Hidden;
+    static constexpr size_t OUTPUT_SIZE = Out;
+    static_assert(Out == 3, "Outputs are buy/sell/hold signals");
 
-    VectorizedInferenceEngine() {
-        // Initialize weights and biases (normally loaded from model file)
-        // Using random initialization for demonstration
+    using Network = NetworkDef<DenseLayer<In, Hidden>, DenseLayer<Hidden, Out>>;
+
+    BasicVectorizedInferenceEngine() {
+        // Demonstration weights; deployments load a model file
         initialize_weights();
+        reload_batched();
+    }
+
+    explicit BasicVectorizedInferenceEngine(const MappedModel& model) {
+        load_model(model);
+    }
+
+    explicit BasicVectorizedInferenceEngine(const std::string& model_path) {
+        load_model(MappedModel(model_path));
+    }
+
+    // Copy weights out of a mapped model file (throws on shape mismatch)
+    void load_model(const MappedModel& model) {
+        model.template require<Network>();
+        std::memcpy(weights_input_hidden_.data(), model.weights(0), sizeof(weights_input_hidden_));
+        std::memcpy(bias_hidden_.data(), model.bias(0), sizeof(bias_hidden_));
+        std::memcpy(weights_hidden_output_.data(), model.weights(1), sizeof(weights_hidden_output_));
+        std::memcpy(bias_output_.data(), model.bias(1), sizeof(bias_output_));
+        reload_batched();
+    }
+
+    // Write the current weights as a model file
+    void save_model(const std::string& path) const {
+        ModelFileWriter::write(path, {
+            {In, Hidden, weights_input_hidden_.data(), bias_hidden_.data()},
+            {Hidden, Out, weights_hidden_output_.data(), bias_output_.data()}
+        });
     }
 
     /**
      * Forward pass inference using SIMD vectorization
      * 
-     * @param features Input feature vector (size 10)
+     * @param features Input feature vector (INPUT_SIZE)
      * @return Output signal probabilities: [buy, sell, hold]
      * 
      * Performance: ~250ns on modern CPU with AVX-512
@@ -60,17 +85,43 @@ public:
     };
 
     inline InferenceOutput predict(const double* features) {
-        // Layer 1: Input → Hidden (10 → 16)
+        // Layer 1: Input → Hidden (In → Hidden)
         // Compute: hidden = tanh(W1 × input + b1)
         compute_hidden_layer_simd(features);
 
-        // Layer 2: Hidden → Output (16 → 3)
+        // Layer 2: Hidden → Output (Hidden → 3)
         // Compute: output = softmax(W2 × hidden + b2)
         compute_output_layer_simd();
 
         return {output_buffer_[0], output_buffer_[1], output_buffer_[2]};
     }
 
+    /**
+     * Batched forward pass for many feature vectors (GEMM-style tiles)
+     * 
+     * @param features `count` contiguous rows of INPUT_SIZE features
+     * @param out      `count` outputs, same order
+     * @param precision FP32 or INT8-quantized weights
+     */
+    inline void predict_batch(const double* features, size_t count, InferenceOutput* out,
+                              InferencePrecision precision = InferencePrecision::FP32) const {
+        constexpr size_t TILE = Batched::TILE;
+        alignas(64) double probabilities[TILE * OUTPUT_SIZE];
+
+        for (size_t base = 0; base < count; base += TILE) {
+            const size_t n = std::min(TILE, count - base);
+            batched_.forward(features + base * INPUT_SIZE, n, probabilities, precision);
+            for (size_t r = 0; r < n; ++r) {
+                out[base + r] = {probabilities[r * OUTPUT_SIZE], probabilities[r * OUTPUT_SIZE + 1],
+                                 probabilities[r * OUTPUT_SIZE + 2]};
+            }
+        }
+    }
+
+    // Run predict() on a specific kernel variant (default: the dispatched one)
+    void select_kernels(const simd::KernelTable& kernels) { kernels_ = &kernels; }
+    simd::IsaLevel isa() const { return kernels_->isa; }
+
     // Pre-warm the cache by loading weights
     inline void warm_cache() {
         volatile double sum = 0.0;
@@ -83,6 +134,10 @@ public:
     }
 
 private:
+    using Batched = BatchedMLP<INPUT_SIZE, HIDDEN_SIZE, OUTPUT_SIZE>;
+
+    const simd::KernelTable* kernels_ = &simd::kernels();
+
     // Weight matrices (cache-aligned for optimal SIMD access)
     alignas(64) std::array<double, INPUT_SIZE * HIDDEN_SIZE> weights_input_hidden_;
     alignas(64) std::array<double, HIDDEN_SIZE * OUTPUT_SIZE> weights_hidden_output_;
@@ -95,6 +150,15 @@ private:
     alignas(64) std::array<double, HIDDEN_SIZE> hidden_buffer_;
     alignas(64) std::array<double, OUTPUT_SIZE> output_buffer_;
 
+    // Float32/int8 copies of the weights for predict_batch
+    Batched batched_;
+
+    void reload_batched() {
+        batched_.load(weights_input_hidden_.data(), bias_hidden_.data(),
+                      weights_hidden_output_.data(), bias_output_.data(),
+                      InferenceActivation::TANH);
+    }
+
     void initialize_weights() {
         // Initialize with small random values (normally loaded from trained model)
         for (size_t i = 0; i < weights_input_hidden_.size(); i++) {
@@ -112,91 +176,17 @@ private:
      * 
      * Computation: hidden[j] = tanh(Σ(W[j,i] × input[i]) + bias[j])
      * 
-     * SIMD Strategy:
-     * - Process SIMD_WIDTH inputs simultaneously using FMA (fused multiply-add)
-     * - AVX-512: 8 doubles per cycle
+     * One dispatched dense kernel per layer (FMA dot products):
+     * - AVX-512: 8 doubles per cycle, masked tail
      * - AVX2: 4 doubles per cycle
-     * - NEON: 2 doubles per cycle
+     * - NEON / SSE2: 2 doubles per cycle
+     * then the dispatched tanh kernel over the whole layer (fast_math
+     * polynomial, 4/8 lanes at a time)
      */
     inline void compute_hidden_layer_simd(const double* input) {
-#if defined(HAS_AVX512)
-        // AVX-512 path: Process 8 doubles at once
-        for (size_t j = 0; j < HIDDEN_SIZE; j++) {
-            __m512d sum = _mm512_setzero_pd();
-            const double* weights_row = &weights_input_hidden_[j * INPUT_SIZE];
-            
-            // Vectorized dot product: sum += weights[i] * input[i]
-            for (size_t i = 0; i < INPUT_SIZE; i += 8) {
-                __m512d w = _mm512_loadu_pd(&weights_row[i]);
-                __m512d x = _mm512_loadu_pd(&input[i]);
-                sum = _mm512_fmadd_pd(w, x, sum);  // Fused multiply-add
-            }
-            
-            // Horizontal reduction: sum all 8 elements
-            double result = _mm512_reduce_add_pd(sum);
-            result += bias_hidden_[j];
-            
-            // Fast tanh approximation
-            hidden_buffer_[j] = fast_tanh_simd(result);
-        }
-
-#elif defined(HAS_AVX2)
-        // AVX2 path: Process 4 doubles at once
-        for (size_t j = 0; j < HIDDEN_SIZE; j++) {
-            __m256d sum = _mm256_setzero_pd();
-            const double* weights_row = &weights_input_hidden_[j * INPUT_SIZE];
-            
-            // Vectorized dot product
-            for (size_t i = 0; i < INPUT_SIZE; i += 4) {
-                __m256d w = _mm256_loadu_pd(&weights_row[i]);
-                __m256d x = _mm256_loadu_pd(&input[i]);
-                sum = _mm256_fmadd_pd(w, x, sum);  // Fused multiply-add
-            }
-            
-            // Horizontal reduction
-            __m128d sum_high = _mm256_extractf128_pd(sum, 1);
-            __m128d sum_low = _mm256_castpd256_pd128(sum);
-            __m128d sum128 = _mm_add_pd(sum_low, sum_high);
-            __m128d sum_shuf = _mm_shuffle_pd(sum128, sum128, 1);
-            sum128 = _mm_add_pd(sum128, sum_shuf);
-            
-            double result = _mm_cvtsd_f64(sum128);
-            result += bias_hidden_[j];
-            
-            hidden_buffer_[j] = fast_tanh_simd(result);
-        }
-
-#elif defined(HAS_NEON)
-        // ARM NEON path: Process 2 doubles at once
-        for (size_t j = 0; j < HIDDEN_SIZE; j++) {
-            float64x2_t sum = vdupq_n_f64(0.0);
-            const double* weights_row = &weights_input_hidden_[j * INPUT_SIZE];
-            
-            // Vectorized dot product
-            for (size_t i = 0; i < INPUT_SIZE; i += 2) {
-                float64x2_t w = vld1q_f64(&weights_row[i]);
-                float64x2_t x = vld1q_f64(&input[i]);
-                sum = vfmaq_f64(sum, w, x);  // Fused multiply-add
-            }
-            
-            // Horizontal reduction
-            double result = vgetq_lane_f64(sum, 0) + vgetq_lane_f64(sum, 1);
-            result += bias_hidden_[j];
-            
-            hidden_buffer_[j] = fast_tanh_simd(result);
-        }
-
-#else
-        // Scalar fallback
-        for (size_t j = 0; j < HIDDEN_SIZE; j++) {
-            double sum = bias_hidden_[j];
-            const double* weights_row = &weights_input_hidden_[j * INPUT_SIZE];
-            for (size_t i = 0; i < INPUT_SIZE; i++) {
-                sum += weights_row[i] * input[i];
-            }
-            hidden_buffer_[j] = fast_tanh_simd(sum);
-        }
-#endif
+        kernels_->dense(weights_input_hidden_.data(), input, bias_hidden_.data(),
+                        hidden_buffer_.data(), HIDDEN_SIZE, INPUT_SIZE);
+        kernels_->tanh(hidden_buffer_.data(), HIDDEN_SIZE);
     }
 
     /**
@@ -207,98 +197,13 @@ private:
      * Since OUTPUT_SIZE=3 is small, we compute all 3 in parallel then apply softmax
      */
     inline void compute_output_layer_simd() {
-#if defined(HAS_AVX512)
-        // AVX-512: Compute all 3 outputs in parallel
-        for (size_t k = 0; k < OUTPUT_SIZE; k++) {
-            __m512d sum = _mm512_setzero_pd();
-            const double* weights_row = &weights_hidden_output_[k * HIDDEN_SIZE];
-            
-            // Vectorized dot product: 16 hidden units, process 8 at a time
-            __m512d h1 = _mm512_loadu_pd(&hidden_buffer_[0]);
-            __m512d w1 = _mm512_loadu_pd(&weights_row[0]);
-            sum = _mm512_fmadd_pd(w1, h1, sum);
-            
-            __m512d h2 = _mm512_loadu_pd(&hidden_buffer_[8]);
-            __m512d w2 = _mm512_loadu_pd(&weights_row[8]);
-            sum = _mm512_fmadd_pd(w2, h2, sum);
-            
-            double result = _mm512_reduce_add_pd(sum);
-            output_buffer_[k] = result + bias_output_[k];
-        }
-
-#elif defined(HAS_AVX2)
-        // AVX2: Compute all 3 outputs
-        for (size_t k = 0; k < OUTPUT_SIZE; k++) {
-            __m256d sum = _mm256_setzero_pd();
-            const double* weights_row = &weights_hidden_output_[k * HIDDEN_SIZE];
-            
-            // Process 16 hidden units, 4 at a time
-            for (size_t j = 0; j < HIDDEN_SIZE; j += 4) {
-                __m256d h = _mm256_loadu_pd(&hidden_buffer_[j]);
-                __m256d w = _mm256_loadu_pd(&weights_row[j]);
-                sum = _mm256_fmadd_pd(w, h, sum);
-            }
-            
-            // Horizontal reduction
-            __m128d sum_high = _mm256_extractf128_pd(sum, 1);
-            __m128d sum_low = _mm256_castpd256_pd128(sum);
-            __m128d sum128 = _mm_add_pd(sum_low, sum_high);
-            __m128d sum_shuf = _mm_shuffle_pd(sum128, sum128, 1);
-            sum128 = _mm_add_pd(sum128, sum_shuf);
-            
-            double result = _mm_cvtsd_f64(sum128);
-            output_buffer_[k] = result + bias_output_[k];
-        }
-
-#elif defined(HAS_NEON)
-        // ARM NEON: Compute all 3 outputs
-        for (size_t k = 0; k < OUTPUT_SIZE; k++) {
-            float64x2_t sum = vdupq_n_f64(0.0);
-            const double* weights_row = &weights_hidden_output_[k * HIDDEN_SIZE];
-            
-            // Process 16 hidden units, 2 at a time
-            for (size_t j = 0; j < HIDDEN_SIZE; j += 2) {
-                float64x2_t h = vld1q_f64(&hidden_buffer_[j]);
-                float64x2_t w = vld1q_f64(&weights_row[j]);
-                sum = vfmaq_f64(sum, w, h);
-            }
-            
-            double result = vgetq_lane_f64(sum, 0) + vgetq_lane_f64(sum, 1);
-            output_buffer_[k] = result + bias_output_[k];
-        }
-
-#else
-        // Scalar fallback
-        for (size_t k = 0; k < OUTPUT_SIZE; k++) {
-            double sum = bias_output_[k];
-            const double* weights_row = &weights_hidden_output_[k * HIDDEN_SIZE];
-            for (size_t j = 0; j < HIDDEN_SIZE; j++) {
-                sum += weights_row[j] * hidden_buffer_[j];
-            }
-            output_buffer_[k] = sum;
-        }
-#endif
+        kernels_->dense(weights_hidden_output_.data(), hidden_buffer_.data(), bias_output_.data(),
+                        output_buffer_.data(), OUTPUT_SIZE, HIDDEN_SIZE);
 
         // Apply softmax to output layer
         apply_softmax_simd();
     }
 
-    /**
-     * Fast tanh approximation using rational function
-     * 
-     * Approximation: tanh(x) ≈ x(27 + x²) / (27 + 9x²)
-     * Accurate to ~0.001 for x ∈ [-3, 3]
-     * Much faster than std::tanh (~5ns vs ~20ns)
-     */
-    inline double fast_tanh_simd(double x) const {
-        // Clamp to avoid numerical issues
-        if (x > 4.0) return 1.0;
-        if (x < -4.0) return -1.0;
-        
-        double x2 = x * x;
-        return x * (27.0 + x2) / (27.0 + 9.0 * x2);
-    }
-
     /**
      * Softmax activation for output layer
      * 
@@ -313,44 +218,20 @@ private:
             if (output_buffer_[i] > max_val) max_val = output_buffer_[i];
         }
 
-#if defined(HAS_AVX2)
-        // AVX2 vectorized exp (only 3 elements, but still worth it)
-        __m256d max_vec = _mm256_set1_pd(max_val);
-        __m256d vals = _mm256_setr_pd(output_buffer_[0], output_buffer_[1], 
-                                      output_buffer_[2], 0.0);
-        vals = _mm256_sub_pd(vals, max_vec);
-        
-        // Fast exp approximation (could use _mm256_exp_pd if available)
-        alignas(32) double temp[4];
-        _mm256_store_pd(temp, vals);
-        for (size_t i = 0; i < OUTPUT_SIZE; i++) {
-            temp[i] = std::exp(temp[i]);
-        }
-        
-        double sum = temp[0] + temp[1] + temp[2];
-        __m256d sum_vec = _mm256_set1_pd(sum);
-        __m256d exp_vec = _mm256_load_pd(temp);
-        __m256d result = _mm256_div_pd(exp_vec, sum_vec);
-        
-        _mm256_store_pd(temp, result);
-        output_buffer_[0] = temp[0];
-        output_buffer_[1] = temp[1];
-        output_buffer_[2] = temp[2];
-
-#else
-        // Scalar softmax
+        // Scalar softmax: three exps, nothing to vectorize
         double sum = 0.0;
         for (size_t i = 0; i < OUTPUT_SIZE; i++) {
-            output_buffer_[i] = std::exp(output_buffer_[i] - max_val);
+            output_buffer_[i] = fast_math::exp(output_buffer_[i] - max_val);
             sum += output_buffer_[i];
         }
         for (size_t i = 0; i < OUTPUT_SIZE; i++) {
             output_buffer_[i] /= sum;
         }
-#endif
     }
 };
 
+using VectorizedInferenceEngine = BasicVectorizedInferenceEngine<>;
+
 /**
  * FastInferenceStub - Drop-in replacement for fpga_inference.hpp
  * 
@@ -385,15 +266,12 @@ public:
 
     // Get latency estimate based on CPU capabilities
     static uint64_t get_latency_estimate_ns() {
-#if defined(HAS_AVX512)
-        return 250;  // 250ns with AVX-512
-#elif defined(HAS_AVX2)
-        return 280;  // 280ns with AVX2
-#elif defined(HAS_NEON)
-        return 320;  // 320ns with ARM NEON
-#else
-        return 450;  // 450ns scalar fallback
-#endif
+        switch (simd::active_isa()) {
+            case simd::IsaLevel::AVX512: return 250;  // 250ns with AVX-512
+            case simd::IsaLevel::AVX2:   return 280;  // 280ns with AVX2
+            case simd::IsaLevel::NEON:   return 320;  // 320ns with ARM NEON
+            default:                     return 450;  // 450ns SSE2 / scalar
+        }
     }
 
 private:
@@ -2,6 +2,8 @@
 #define WEBSOCKET_SERVER_HPP
 
 #include "metrics_collector.hpp"
+#include "metrics_frame.hpp"
+#include <boost/asio/post.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/websocket.hpp>
 #include <boost/asio/ip/tcp.hpp>
@@ -9,6 +11,7 @@
 #include <atomic>
 #include <chrono>
 #include <cctype>
+#include <deque>
 #include <iostream>
 #include <memory>
 #include <mutex>
@@ -16,6 +19,7 @@
 #include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace beast = boost::beast;
 namespace websocket = beast::websocket;
@@ -97,9 +101,15 @@ inline std::string extract_string_field(const std::string& msg, const char* fiel
 
 } // namespace hft_json
 
-// WebSocket session for each connected client
+// WebSocket session for each connected client. All calls happen on the
+// server's io_context thread; writes are queued and sent one at a time.
 class WebSocketSession : public std::enable_shared_from_this<WebSocketSession> {
 public:
+    using Frame = std::shared_ptr<const std::string>;
+
+    // Frames beyond this are dropped for a client that cannot keep up
+    static constexpr size_t MAX_QUEUED_FRAMES = 64;
+
     explicit WebSocketSession(tcp::socket socket, MetricsCollector& collector)
         : ws_(std::move(socket)), collector_(collector) {}
     
@@ -107,21 +117,55 @@ public:
         ws_.async_accept([self = shared_from_this()](beast::error_code ec) {
             if (!ec) {
                 self->read_message();
+            } else {
+                self->closed_ = true;
             }
         });
     }
     
     void send_metrics(const std::string& json_data) {
-        auto msg = std::make_shared<std::string>(json_data);
+        deliver(std::make_shared<const std::string>(json_data), false);
+    }
+
+    void deliver(Frame frame, bool binary) {
+        if (closed_) return;
+        if (queue_.size() >= MAX_QUEUED_FRAMES) {
+            ++dropped_frames_;
+            return;
+        }
+        queue_.push_back({std::move(frame), binary});
+        if (queue_.size() == 1) write_next();
+    }
+
+    // Streaming mode: binary delta frames (subscribe_binary) or the
+    // legacy JSON "update" message
+    bool binary() const { return binary_; }
+    bool closed() const { return closed_; }
+    uint64_t dropped_frames() const { return dropped_frames_; }
+    
+private:
+    struct Pending {
+        Frame frame;
+        bool binary;
+    };
+
+    void write_next() {
+        const Pending& next = queue_.front();
+        ws_.binary(next.binary);
         ws_.async_write(
-            net::buffer(*msg),
-            [self = shared_from_this(), msg](beast::error_code ec, std::size_t) {
-                // Message sent
+            net::buffer(*next.frame),
+            [self = shared_from_this()](beast::error_code ec, std::size_t) {
+                self->queue_.pop_front();
+                if (ec) {
+                    self->closed_ = true;
+                    self->queue_.clear();
+                } else if (!self->queue_.empty()) {
+                    self->write_next();
+                }
             }
         );
     }
-    
-private:
+
     void read_message() {
         ws_.async_read(
             buffer_,
@@ -129,6 +173,8 @@ private:
                 if (!ec) {
                     self->handle_message();
                     self->read_message();
+                } else {
+                    self->closed_ = true;
                 }
             }
         );
@@ -143,19 +189,23 @@ private:
         const std::string cmd = hft_json::extract_string_field(msg, "command");
         if (cmd == "get_history") {
             send_history();
+        } else if (cmd == "get_history_binary") {
+            send_history_binary();
+        } else if (cmd == "subscribe_binary") {
+            binary_ = true;
+        } else if (cmd == "subscribe_json") {
+            binary_ = false;
         } else if (cmd == "get_summary") {
             send_summary();
         }
     }
     
     void send_history() {
-        auto snapshots = collector_.get_recent_snapshots(1000);
-
         std::ostringstream oss;
         oss << '[';
         bool first_item = true;
 
-        for (const auto& snap : snapshots) {
+        collector_.snapshots().visit_recent(1000, [&](uint64_t, const MetricSnapshot& snap) {
             if (!first_item) oss << ',';
             first_item = false;
 
@@ -170,11 +220,31 @@ private:
             hft_json::append_kv_number(oss, first_kv, "sell_intensity", snap.sell_intensity);
             hft_json::append_kv_number(oss, first_kv, "latency", snap.cycle_latency_us);
             oss << '}';
-        }
+        });
 
         oss << ']';
         send_metrics(oss.str());
     }
+
+    // Whole ring, encoded straight from the slots into HISTORY frames
+    void send_history_binary() {
+        metrics_frame::Encoder encoder;
+        bool open = false;
+        const auto flush = [&] {
+            if (open) deliver(std::make_shared<const std::string>(encoder.finish()), true);
+            open = false;
+        };
+
+        collector_.snapshots().visit(0, [&](uint64_t index, const MetricSnapshot& snap) {
+            if (!open) {
+                encoder.reset(metrics_frame::HISTORY, index);
+                open = true;
+            }
+            encoder.add(snap);
+            if (encoder.full()) flush();
+        });
+        flush();
+    }
     
     void send_summary() {
         auto stats = collector_.get_summary();
@@ -198,13 +268,25 @@ private:
     websocket::stream<tcp::socket> ws_;
     MetricsCollector& collector_;
     beast::flat_buffer buffer_;
+    std::deque<Pending> queue_;
+    bool binary_ = false;
+    bool closed_ = false;
+    uint64_t dropped_frames_ = 0;
 };
 
-// WebSocket server for dashboard
+// WebSocket server for dashboard. The broadcast thread reads new snapshots
+// from the collector's ring every broadcast_interval and never touches
+// the trading thread's live counters. Binary subscribers get every
+// snapshot as one delta-encoded frame per interval. JSON clients get the
+// latest snapshot at the legacy 100ms cadence.
 class DashboardServer {
 public:
-    DashboardServer(MetricsCollector& collector, int port = 8080)
+    static constexpr std::chrono::milliseconds JSON_INTERVAL{100};
+
+    DashboardServer(MetricsCollector& collector, int port = 8080,
+                    std::chrono::microseconds broadcast_interval = std::chrono::milliseconds(10))
         : collector_(collector),
+          broadcast_interval_(broadcast_interval),
           ioc_(),
           acceptor_(ioc_, tcp::endpoint(tcp::v4(), port)),
           running_(false) {}
@@ -238,6 +320,8 @@ public:
     }
     
 private:
+    using Frame = WebSocketSession::Frame;
+
     void accept_connection() {
         acceptor_.async_accept([this](beast::error_code ec, tcp::socket socket) {
             if (!ec) {
@@ -245,7 +329,6 @@ private:
                     std::move(socket), collector_
                 );
                 
-                std::lock_guard<std::mutex> lock(sessions_mutex_);
                 sessions_.insert(session);
                 session->run();
             }
@@ -257,48 +340,84 @@ private:
     }
     
     void broadcast_metrics() {
+        const auto& ring = collector_.snapshots();
+        uint64_t cursor = ring.published();
+        auto last_json = std::chrono::steady_clock::now();
+        metrics_frame::Encoder encoder;
+
         while (running_.load(std::memory_order_acquire)) {
-            // Broadcast every 100ms
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            
-            // Get current metrics
-            auto& metrics = collector_.get_metrics();
+            std::this_thread::sleep_for(broadcast_interval_);
 
-            std::ostringstream oss;
-            oss << '{';
-            bool first_kv = true;
-            hft_json::append_kv_string(oss, first_kv, "type", "update");
-            hft_json::append_kv_number(oss, first_kv, "timestamp", std::chrono::steady_clock::now().time_since_epoch().count());
-            hft_json::append_kv_number(oss, first_kv, "mid_price", metrics.mid_price.load());
-            hft_json::append_kv_number(oss, first_kv, "spread", metrics.spread_bps.load());
-            hft_json::append_kv_number(oss, first_kv, "pnl", metrics.total_pnl.load());
-            hft_json::append_kv_number(oss, first_kv, "position", metrics.current_position.load());
-            hft_json::append_kv_number(oss, first_kv, "buy_intensity", metrics.buy_intensity.load());
-            hft_json::append_kv_number(oss, first_kv, "sell_intensity", metrics.sell_intensity.load());
-            hft_json::append_kv_number(oss, first_kv, "latency", metrics.avg_cycle_latency_us.load());
-            hft_json::append_kv_number(oss, first_kv, "orders_sent", metrics.orders_sent.load());
-            hft_json::append_kv_number(oss, first_kv, "orders_filled", metrics.orders_filled.load());
-            hft_json::append_kv_number(oss, first_kv, "regime", metrics.current_regime.load());
-            hft_json::append_kv_number(oss, first_kv, "position_usage", metrics.position_limit_usage.load());
-            oss << '}';
+            // Every snapshot since the last pass, one frame per 64K records
+            std::vector<Frame> binary_frames;
+            MetricSnapshot latest{};
+            bool any = false;
+            cursor = ring.visit(cursor, [&](uint64_t index, const MetricSnapshot& snap) {
+                if (!any || encoder.full()) {
+                    if (any) binary_frames.push_back(std::make_shared<const std::string>(encoder.finish()));
+                    encoder.reset(metrics_frame::UPDATE, index);
+                }
+                encoder.add(snap);
+                latest = snap;
+                any = true;
+            });
+            if (!any) continue;
+            binary_frames.push_back(std::make_shared<const std::string>(encoder.finish()));
 
-            std::string msg = oss.str();
-            
-            // Send to all connected clients
-            std::lock_guard<std::mutex> lock(sessions_mutex_);
-            for (auto& session : sessions_) {
-                session->send_metrics(msg);
+            Frame json;
+            const auto now = std::chrono::steady_clock::now();
+            if (now - last_json >= JSON_INTERVAL) {
+                json = std::make_shared<const std::string>(json_update(latest));
+                last_json = now;
             }
+
+            // Hand off to the io thread, which owns the sessions
+            net::post(ioc_, [this, binary_frames = std::move(binary_frames), json]() {
+                for (auto it = sessions_.begin(); it != sessions_.end();) {
+                    const auto& session = *it;
+                    if (session->closed()) {
+                        it = sessions_.erase(it);
+                        continue;
+                    }
+                    if (session->binary()) {
+                        for (const auto& frame : binary_frames) session->deliver(frame, true);
+                    } else if (json) {
+                        session->deliver(json, false);
+                    }
+                    ++it;
+                }
+            });
         }
     }
+
+    static std::string json_update(const MetricSnapshot& snap) {
+        std::ostringstream oss;
+        oss << '{';
+        bool first_kv = true;
+        hft_json::append_kv_string(oss, first_kv, "type", "update");
+        hft_json::append_kv_number(oss, first_kv, "timestamp", snap.timestamp_ns);
+        hft_json::append_kv_number(oss, first_kv, "mid_price", snap.mid_price);
+        hft_json::append_kv_number(oss, first_kv, "spread", snap.spread_bps);
+        hft_json::append_kv_number(oss, first_kv, "pnl", snap.pnl);
+        hft_json::append_kv_number(oss, first_kv, "position", snap.position);
+        hft_json::append_kv_number(oss, first_kv, "buy_intensity", snap.buy_intensity);
+        hft_json::append_kv_number(oss, first_kv, "sell_intensity", snap.sell_intensity);
+        hft_json::append_kv_number(oss, first_kv, "latency", snap.cycle_latency_us);
+        hft_json::append_kv_number(oss, first_kv, "orders_sent", snap.orders_sent);
+        hft_json::append_kv_number(oss, first_kv, "orders_filled", snap.orders_filled);
+        hft_json::append_kv_number(oss, first_kv, "regime", snap.regime);
+        hft_json::append_kv_number(oss, first_kv, "position_usage", snap.position_limit_usage);
+        oss << '}';
+        return oss.str();
+    }
     
     MetricsCollector& collector_;
+    std::chrono::microseconds broadcast_interval_;
     net::io_context ioc_;
     tcp::acceptor acceptor_;
     std::atomic<bool> running_;
     
-    std::set<std::shared_ptr<WebSocketSession>> sessions_;
-    std::mutex sessions_mutex_;
+    std::set<std::shared_ptr<WebSocketSession>> sessions_;     // io thread only
     
     std::thread server_thread_;
     std::thread broadcast_thread_;
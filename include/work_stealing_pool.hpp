@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hft {
+
+// ====
+// Work-Stealing Thread Pool
+// For coarse, uneven jobs (whole backtests, calibration runs): each worker
+// owns a deque, runs its own work newest-first, and steals the oldest job
+// from a sibling when it runs dry, so one long job never idles the rest.
+// Not for the hot path - jobs are std::function and deques are mutex-guarded.
+// ====
+
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    // threads = 0 uses all hardware threads
+    explicit WorkStealingPool(unsigned threads = 0) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        queues_.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i) {
+            queues_.push_back(std::make_unique<WorkerQueue>());
+        }
+        workers_.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i) {
+            workers_.emplace_back([this, i] { worker_loop(i); });
+        }
+    }
+
+    // Finishes outstanding jobs first
+    ~WorkStealingPool() {
+        {
+            std::unique_lock<std::mutex> lock(state_mutex_);
+            wait_until_idle(lock);
+            stopping_ = true;
+        }
+        work_cv_.notify_all();
+        for (auto& w : workers_) {
+            w.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Jobs submitted from inside a job go to that worker's own deque
+    void submit(Task task) {
+        const size_t target = (current_pool() == this)
+            ? current_worker()
+            : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            ++pending_;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+            queues_[target]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            ++queued_;
+        }
+        work_cv_.notify_one();
+    }
+
+    // Block until every submitted job has finished. Rethrows the first
+    // exception a job threw (the remaining jobs still run).
+    void wait() {
+        std::unique_lock<std::mutex> lock(state_mutex_);
+        wait_until_idle(lock);
+        if (error_) {
+            std::exception_ptr error = error_;
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    size_t thread_count() const { return workers_.size(); }
+
+private:
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex state_mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable idle_cv_;
+    size_t pending_ = 0;        // Submitted, not yet finished
+    long queued_ = 0;           // Sitting in some deque; briefly -1 if a job
+                                // is taken before its submit is counted
+    bool stopping_ = false;
+    std::exception_ptr error_;
+    std::atomic<size_t> next_queue_{0};
+
+    // Waits are timed so a lost wakeup can only ever delay, never hang
+    static constexpr std::chrono::milliseconds RECHECK_INTERVAL{100};
+
+    void wait_until_idle(std::unique_lock<std::mutex>& lock) {
+        while (!idle_cv_.wait_for(lock, RECHECK_INTERVAL, [this] { return pending_ == 0; })) {}
+    }
+
+    static const WorkStealingPool*& current_pool() {
+        thread_local const WorkStealingPool* pool = nullptr;
+        return pool;
+    }
+
+    static size_t& current_worker() {
+        thread_local size_t index = 0;
+        return index;
+    }
+
+    bool take_task(size_t self, Task& task) {
+        {
+            // Own deque: newest first (still warm in cache)
+            WorkerQueue& own = *queues_[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t k = 1; k < queues_.size(); ++k) {
+            // Steal the oldest job from a sibling
+            WorkerQueue& victim = *queues_[(self + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void worker_loop(size_t self) {
+        current_pool() = this;
+        current_worker() = self;
+
+        for (;;) {
+            Task task;
+            if (take_task(self, task)) {
+                {
+                    std::lock_guard<std::mutex> lock(state_mutex_);
+                    --queued_;
+                }
+
+                std::exception_ptr error;
+                try {
+                    task();
+                } catch (...) {
+                    error = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lock(state_mutex_);
+                if (error && !error_) {
+                    error_ = error;
+                }
+                if (--pending_ == 0) {
+                    idle_cv_.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(state_mutex_);
+            while (!work_cv_.wait_for(lock, RECHECK_INTERVAL, [this] { return stopping_ || queued_ > 0; })) {}
+            if (stopping_) {
+                return;
+            }
+        }
+    }
+};
+
+} // namespace hft
@@ -1,10 +1,13 @@
 #pragma once
 
 #include "common_types.hpp"
+#include "instrument_directory.hpp"
 #include <cstring>
 #include <cstdint>
 #include <type_traits>
-#include <unordered_map>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace hft {
 namespace zerocopy {
@@ -18,6 +21,13 @@ namespace zerocopy {
 // Packed binary protocol structures (aligned with exchange formats)
 // These structs overlay directly on network packet bytes
 
+// Wire message types (BinaryMessageHeader::message_type)
+enum class MessageType : uint16_t {
+    ORDER_BOOK_UPDATE = 1,  // BinaryOrderBookUpdate
+    TRADE = 2,              // BinaryTradeMessage
+    QUOTE = 3               // BinaryQuoteMessage
+};
+
 #pragma pack(push, 1)  // Force byte-alignment (no padding)
 
 // FIX-like binary protocol header
@@ -133,7 +143,7 @@ public:
 
 // ====
 // Symbol ID Mapping (for zero-copy symbol lookup)
-// Pre-computed hash map: symbol_string -> symbol_id
+// Perfect hash: symbol_string -> symbol_id, flat array: symbol_id -> string
 // ====
 class SymbolMapper {
 public:
@@ -146,24 +156,58 @@ public:
         add_symbol("XRPUSD", 5);
     }
     
+    // Wire IDs follow the directory's dense IDs (offset by one; 0 = unknown)
+    explicit SymbolMapper(const InstrumentDirectory& directory) {
+        std::vector<std::string> names;
+        names.reserve(directory.symbol_count());
+        for (uint32_t i = 0; i < directory.symbol_count(); ++i) {
+            names.push_back(directory.symbol_name(i));
+            ids_.push_back(i + 1);
+        }
+        rebuild(std::move(names));
+    }
+    
+    // Startup only: rebuilds the perfect hash
     void add_symbol(const std::string& symbol, uint32_t id) {
-        symbol_to_id_[symbol] = id;
-        id_to_symbol_[id] = symbol;
+        std::vector<std::string> names;
+        names.reserve(index_.size() + 1);
+        for (uint32_t i = 0; i < index_.size(); ++i) {
+            if (index_.key(i) == symbol) {
+                id_to_symbol_[ids_[i]].clear();
+                ids_[i] = id;
+            }
+            names.push_back(index_.key(i));
+        }
+        if (index_.find(symbol) == PerfectHashIndex::NOT_FOUND) {
+            names.push_back(symbol);
+            ids_.push_back(id);
+        }
+        rebuild(std::move(names));
     }
     
-    uint32_t get_id(const std::string& symbol) const {
-        auto it = symbol_to_id_.find(symbol);
-        return (it != symbol_to_id_.end()) ? it->second : 0;
+    uint32_t get_id(std::string_view symbol) const {
+        const uint32_t idx = index_.find(symbol);
+        return (idx != PerfectHashIndex::NOT_FOUND) ? ids_[idx] : 0;
     }
     
     std::string get_symbol(uint32_t id) const {
-        auto it = id_to_symbol_.find(id);
-        return (it != id_to_symbol_.end()) ? it->second : "";
+        return (id < id_to_symbol_.size()) ? id_to_symbol_[id] : "";
     }
     
 private:
-    std::unordered_map<std::string, uint32_t> symbol_to_id_;
-    std::unordered_map<uint32_t, std::string> id_to_symbol_;
+    PerfectHashIndex index_;
+    std::vector<uint32_t> ids_;                // Perfect hash value -> wire ID
+    std::vector<std::string> id_to_symbol_;    // Wire ID -> name (dense)
+    
+    void rebuild(std::vector<std::string> names) {
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (ids_[i] >= id_to_symbol_.size()) {
+                id_to_symbol_.resize(ids_[i] + 1);
+            }
+            id_to_symbol_[ids_[i]] = names[i];
+        }
+        index_.build(std::move(names));
+    }
 };
 
 } // namespace zerocopy
@@ -0,0 +1,21 @@
+#include "journal_decoder.hpp"
+#include <iostream>
+
+// Decodes a BinaryJournal into the text logs its sinks would have written
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " <journal> [output_dir]\n";
+        return 1;
+    }
+
+    try {
+        const auto outputs = hft::JournalDecoder::decode(argv[1], argc == 3 ? argv[2] : "");
+        for (const auto& out : outputs) {
+            std::cout << out.path << ": " << out.records << " records\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
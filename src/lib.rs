@@ -2,10 +2,14 @@
 // Provides zero-cost abstractions and memory safety guarantees
 // while maintaining sub-microsecond performance
 
-use std::sync::atomic::{AtomicU64, AtomicBool, Ordering};
-use std::time::{Duration, Instant};
+use std::ffi::c_void;
+use std::mem::{offset_of, size_of};
+use std::sync::atomic::{AtomicU32, AtomicU64, AtomicBool, Ordering};
+use std::time::Instant;
 
 // FFI-compatible types (matching C++ structs)
+// Sizes and offsets are asserted below and in include/rust_ffi.hpp, so a
+// pointer from either side can be read in place by the other
 
 #[repr(C, align(64))]
 pub struct MarketTick {
@@ -26,7 +30,8 @@ pub struct MarketTick {
     pub ask_sizes: [u64; 10],
 }
 
-#[repr(C)]
+#[repr(C, align(64))]
+#[derive(Clone, Copy)]
 pub struct Order {
     pub order_id: u64,
     pub asset_id: u32,
@@ -39,6 +44,31 @@ pub struct Order {
     _padding: [u8; 6],
 }
 
+#[repr(C)]
+#[derive(Clone, Copy, Default, Debug, PartialEq)]
+pub struct QuotePair {
+    pub bid_price: f64,
+    pub ask_price: f64,
+    pub bid_size: f64,
+    pub ask_size: f64,
+    pub spread: f64,
+    pub mid_price: f64,
+    pub generated_at_ns: i64,
+}
+
+const _: () = {
+    assert!(offset_of!(MarketTick, trade_side) == 56);
+    assert!(offset_of!(MarketTick, asset_id) == 60);
+    assert!(offset_of!(MarketTick, bid_prices) == 72);
+    assert!(offset_of!(MarketTick, ask_sizes) == 312);
+    assert!(size_of::<MarketTick>() == 448);
+    assert!(offset_of!(Order, side) == 12);
+    assert!(offset_of!(Order, quantity) == 24);
+    assert!(size_of::<Order>() == 64);
+    assert!(offset_of!(QuotePair, mid_price) == 40);
+    assert!(size_of::<QuotePair>() == 56);
+};
+
 // Lock-Free SPSC Queue (Rust implementation)
 
 pub struct LockFreeSPSC<T, const CAPACITY: usize> {
@@ -166,42 +196,243 @@ impl HiResTimer {
     }
 }
 
-// Shared Memory Queue (Rust wrapper for C++ shared memory)
+// Shared Memory Ring (same layout as C++ shm::RingHeader)
+//
+// SharedMemoryRingBuffer<T, N> in include/shared_memory.hpp maps exactly
+// this header followed by N slots of T, so a ShmRing over the same
+// segment interoperates with it: either side may be the producer and the
+// other the consumer, with no conversion on either path.
 
-pub struct SharedMemoryQueue {
-    name: String,
-    capacity: usize,
-    // Will map to C++ SharedMemoryRingBuffer via FFI
+pub const RING_MAGIC: u64 = 0x474E4952534D4854;   // "THMSRING"
+pub const RING_VERSION: u32 = 1;
+
+#[repr(C, align(64))]
+pub struct SeqLine {
+    pub seq: AtomicU64,
 }
 
-impl SharedMemoryQueue {
-    pub fn new(name: &str, capacity: usize) -> Self {
-        Self {
-            name: name.to_string(),
-            capacity,
+#[repr(C, align(64))]
+pub struct RingHeader {
+    pub magic: u64,
+    pub version: u32,
+    pub is_initialized: AtomicU32,
+    pub capacity: u64,
+    pub element_size: u64,
+    pub name: [u8; 64],
+    pub write_seq: SeqLine,  // Producer
+    pub read_seq: SeqLine,   // Consumer
+}
+
+pub const RING_DATA_OFFSET: usize = size_of::<RingHeader>();
+
+const _: () = {
+    assert!(offset_of!(RingHeader, capacity) == 16);
+    assert!(offset_of!(RingHeader, name) == 32);
+    assert!(offset_of!(RingHeader, write_seq) == 128);
+    assert!(offset_of!(RingHeader, read_seq) == 192);
+    assert!(RING_DATA_OFFSET == 256);
+};
+
+/// SPSC handle on a RingHeader + slots region. Only one handle may produce
+/// and one consume, across both languages.
+pub struct ShmRing<T: Copy> {
+    header: *const RingHeader,
+    slots: *mut T,
+    mask: u64,
+    cached_read_seq: u64,   // Producer side
+    cached_write_seq: u64,  // Consumer side
+    mapping: Option<(*mut c_void, usize)>,
+}
+
+impl<T: Copy> ShmRing<T> {
+    /// Lays out a fresh header at `region` (creator side).
+    ///
+    /// # Safety
+    /// `region` must be 64-byte aligned and hold RING_DATA_OFFSET +
+    /// capacity * size_of::<T>() bytes that nothing else is using.
+    pub unsafe fn init_region(region: *mut u8, capacity: usize, name: &str) -> Self {
+        assert!(capacity.is_power_of_two(), "Capacity must be power of 2");
+        let mut header = RingHeader {
+            magic: RING_MAGIC,
+            version: RING_VERSION,
+            is_initialized: AtomicU32::new(0),
+            capacity: capacity as u64,
+            element_size: size_of::<T>() as u64,
+            name: [0; 64],
+            write_seq: SeqLine { seq: AtomicU64::new(0) },
+            read_seq: SeqLine { seq: AtomicU64::new(0) },
+        };
+        let len = name.len().min(header.name.len() - 1);
+        header.name[..len].copy_from_slice(&name.as_bytes()[..len]);
+        let h = region as *mut RingHeader;
+        h.write(header);
+        (*h).is_initialized.store(1, Ordering::Release);
+        Self::from_region(region).expect("freshly initialized ring")
+    }
+
+    /// Attaches to a region laid out by either side; None if the header
+    /// isn't initialized or doesn't describe a ring of T.
+    ///
+    /// # Safety
+    /// `region` must point to a mapped RingHeader and its slots, and stay
+    /// mapped for the life of the handle.
+    pub unsafe fn from_region(region: *mut u8) -> Option<Self> {
+        if region.is_null() || (region as usize) % 64 != 0 {
+            return None;
+        }
+        let header = &*(region as *const RingHeader);
+        if header.is_initialized.load(Ordering::Acquire) == 0
+            || header.magic != RING_MAGIC
+            || header.version != RING_VERSION
+            || header.element_size != size_of::<T>() as u64
+            || !header.capacity.is_power_of_two()
+        {
+            return None;
         }
+        Some(Self {
+            header,
+            slots: region.add(RING_DATA_OFFSET) as *mut T,
+            mask: header.capacity - 1,
+            cached_read_seq: header.read_seq.seq.load(Ordering::Acquire),
+            cached_write_seq: header.write_seq.seq.load(Ordering::Acquire),
+            mapping: None,
+        })
     }
-    
-    // FFI functions to C++
-    pub fn write_tick(&self, tick: &MarketTick) -> bool {
-        // Calls C++ shared memory write
+
+    /// Maps /dev/shm/<name>, e.g. a C++ SharedMemoryRingBuffer segment.
+    #[cfg(target_os = "linux")]
+    pub fn attach(name: &str) -> std::io::Result<Self> {
+        use std::os::unix::io::AsRawFd;
+        let path = format!("/dev/shm/{}", name.trim_start_matches('/'));
+        let file = std::fs::OpenOptions::new().read(true).write(true).open(path)?;
+        let len = file.metadata()?.len() as usize;
+        if len < RING_DATA_OFFSET {
+            return Err(std::io::Error::new(std::io::ErrorKind::InvalidData, "segment too small"));
+        }
         unsafe {
-            shm_write_tick(self.name.as_ptr(), tick as *const MarketTick)
+            let base = sys::mmap(std::ptr::null_mut(), len, sys::PROT_READ | sys::PROT_WRITE,
+                                 sys::MAP_SHARED, file.as_raw_fd(), 0);
+            if base == sys::MAP_FAILED {
+                return Err(std::io::Error::last_os_error());
+            }
+            let capacity = (*(base as *const RingHeader)).capacity as usize;
+            let fits = capacity
+                .checked_mul(size_of::<T>())
+                .map_or(false, |bytes| RING_DATA_OFFSET + bytes <= len);
+            match Self::from_region(base as *mut u8) {
+                Some(mut ring) if fits => {
+                    ring.mapping = Some((base, len));
+                    Ok(ring)
+                }
+                _ => {
+                    sys::munmap(base, len);
+                    Err(std::io::Error::new(std::io::ErrorKind::InvalidData, "ring layout mismatch"))
+                }
+            }
         }
     }
-    
-    pub fn read_tick(&self) -> Option<MarketTick> {
-        let mut tick = MarketTick::default();
-        let success = unsafe {
-            shm_read_tick(self.name.as_ptr(), &mut tick as *mut MarketTick)
-        };
-        
-        if success {
-            Some(tick)
+
+    #[inline(always)]
+    fn header(&self) -> &RingHeader {
+        unsafe { &*self.header }
+    }
+
+    pub fn capacity(&self) -> usize {
+        (self.mask + 1) as usize
+    }
+
+    /// Producer: copies as many of `items` as fit, one publication per call.
+    #[inline(always)]
+    pub fn push_bulk(&mut self, items: &[T]) -> usize {
+        let h = unsafe { &*self.header };
+        let write = h.write_seq.seq.load(Ordering::Relaxed);
+        let capacity = self.mask + 1;
+        if write + items.len() as u64 - self.cached_read_seq > capacity {
+            self.cached_read_seq = h.read_seq.seq.load(Ordering::Acquire);
+        }
+        let free = capacity - (write - self.cached_read_seq);
+        let n = items.len().min(free as usize);
+        for (i, item) in items[..n].iter().enumerate() {
+            let idx = ((write + i as u64) & self.mask) as usize;
+            unsafe { self.slots.add(idx).write(*item) };
+        }
+        if n > 0 {
+            h.write_seq.seq.store(write + n as u64, Ordering::Release);
+        }
+        n
+    }
+
+    /// Consumer: copies up to `out.len()` items, one publication per call.
+    #[inline(always)]
+    pub fn pop_bulk(&mut self, out: &mut [T]) -> usize {
+        let h = unsafe { &*self.header };
+        let read = h.read_seq.seq.load(Ordering::Relaxed);
+        if self.cached_write_seq < read || self.cached_write_seq - read < out.len() as u64 {
+            self.cached_write_seq = h.write_seq.seq.load(Ordering::Acquire);
+        }
+        let n = out.len().min((self.cached_write_seq - read) as usize);
+        for (i, slot) in out[..n].iter_mut().enumerate() {
+            let idx = ((read + i as u64) & self.mask) as usize;
+            *slot = unsafe { self.slots.add(idx).read() };
+        }
+        if n > 0 {
+            h.read_seq.seq.store(read + n as u64, Ordering::Release);
+        }
+        n
+    }
+
+    #[inline(always)]
+    pub fn push(&mut self, item: T) -> bool {
+        self.push_bulk(std::slice::from_ref(&item)) == 1
+    }
+
+    #[inline(always)]
+    pub fn pop(&mut self) -> Option<T> {
+        let mut item = std::mem::MaybeUninit::<T>::uninit();
+        let out = unsafe { std::slice::from_raw_parts_mut(item.as_mut_ptr(), 1) };
+        if self.pop_bulk(out) == 1 {
+            Some(unsafe { item.assume_init() })
         } else {
             None
         }
     }
+
+    pub fn len(&self) -> usize {
+        let h = self.header();
+        let w = h.write_seq.seq.load(Ordering::Acquire);
+        let r = h.read_seq.seq.load(Ordering::Acquire);
+        w.wrapping_sub(r) as usize
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+}
+
+impl<T: Copy> Drop for ShmRing<T> {
+    fn drop(&mut self) {
+        #[cfg(target_os = "linux")]
+        if let Some((base, len)) = self.mapping.take() {
+            unsafe { sys::munmap(base, len) };
+        }
+    }
+}
+
+unsafe impl<T: Copy + Send> Send for ShmRing<T> {}
+
+#[cfg(target_os = "linux")]
+mod sys {
+    use std::ffi::c_void;
+
+    pub const PROT_READ: i32 = 1;
+    pub const PROT_WRITE: i32 = 2;
+    pub const MAP_SHARED: i32 = 1;
+    pub const MAP_FAILED: *mut c_void = !0usize as *mut c_void;
+
+    extern "C" {
+        pub fn mmap(addr: *mut c_void, len: usize, prot: i32, flags: i32, fd: i32, offset: i64) -> *mut c_void;
+        pub fn munmap(addr: *mut c_void, len: usize) -> i32;
+    }
 }
 
 // Risk Control (Rust implementation with memory safety)
@@ -247,6 +478,25 @@ impl RiskControl {
         true
     }
     
+    /// Independent checks at one position; the kill switch is read once
+    /// for the span. Returns the number approved.
+    pub fn check_pre_trade_batch(&self, orders: &[Order], current_pos: i64, verdicts: &mut [u8]) -> usize {
+        let verdicts = &mut verdicts[..orders.len()];
+        if self.kill_switch.load(Ordering::Acquire) {
+            verdicts.fill(0);
+            return 0;
+        }
+        let mut approved = 0;
+        for (order, verdict) in orders.iter().zip(verdicts.iter_mut()) {
+            let qty = order.quantity as i64;
+            let new_pos = current_pos + if order.side == 0 { qty } else { -qty };
+            let ok = new_pos.abs() <= self.max_position;
+            *verdict = ok as u8;
+            approved += ok as usize;
+        }
+        approved
+    }
+    
     #[inline(always)]
     pub fn trigger_kill_switch(&self) {
         self.kill_switch.store(true, Ordering::Release);
@@ -260,9 +510,8 @@ impl RiskControl {
 
 // FFI Declarations (C++ functions callable from Rust)
 
+#[allow(dead_code)]
 extern "C" {
-    fn shm_write_tick(name: *const u8, tick: *const MarketTick) -> bool;
-    fn shm_read_tick(name: *const u8, tick: *mut MarketTick) -> bool;
     fn cpp_hawkes_update(engine: *mut std::ffi::c_void, tick: *const MarketTick);
     fn cpp_fpga_predict(engine: *mut std::ffi::c_void, features: *const f64, output: *mut f64);
 }
@@ -319,11 +568,23 @@ impl MarketMaker {
         let bid_spread = half_spread * (1.0 - skew_factor);
         let ask_spread = half_spread * (1.0 + skew_factor);
         
-        let bid = (reservation_price - bid_spread / self.tick_size).round() * self.tick_size;
-        let ask = (reservation_price + ask_spread / self.tick_size).round() * self.tick_size;
+        let bid = ((reservation_price - bid_spread) / self.tick_size).round() * self.tick_size;
+        let ask = ((reservation_price + ask_spread) / self.tick_size).round() * self.tick_size;
         
         (bid, ask)
     }
+    
+    /// Writes bid/ask/spread/mid of out[i] for ticks[i] at inventories[i];
+    /// the other fields are left to the caller.
+    pub fn generate_quotes_batch(&self, ticks: &[MarketTick], inventories: &[i64], out: &mut [QuotePair]) {
+        for ((tick, &inventory), quote) in ticks.iter().zip(inventories).zip(out.iter_mut()) {
+            let (bid, ask) = self.generate_quotes(tick, inventory);
+            quote.bid_price = bid;
+            quote.ask_price = ask;
+            quote.spread = ask - bid;
+            quote.mid_price = (bid + ask) / 2.0;
+        }
+    }
 }
 
 // ====
@@ -381,6 +642,102 @@ pub fn benchmark_queue_throughput() {
     println!("Rust SPSC Queue: {} ns/op", ns_per_op);
 }
 
+// ====
+// C ABI exports (declared in include/rust_ffi.hpp)
+// ====
+
+#[no_mangle]
+pub extern "C" fn rust_market_maker_new(risk_aversion: f64, volatility: f64, tick_size: f64) -> *mut MarketMaker {
+    Box::into_raw(Box::new(MarketMaker::new(risk_aversion, volatility, tick_size)))
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rust_market_maker_free(mm: *mut MarketMaker) {
+    if !mm.is_null() {
+        drop(Box::from_raw(mm));
+    }
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rust_market_maker_generate_quotes(mm: *const MarketMaker, tick: *const MarketTick,
+                                                           inventory: i64, bid_out: *mut f64, ask_out: *mut f64) {
+    let (bid, ask) = (*mm).generate_quotes(&*tick, inventory);
+    *bid_out = bid;
+    *ask_out = ask;
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rust_market_maker_generate_quotes_batch(mm: *const MarketMaker, ticks: *const MarketTick,
+                                                                 inventories: *const i64, count: usize,
+                                                                 quotes_out: *mut QuotePair) {
+    if count == 0 {
+        return;
+    }
+    (*mm).generate_quotes_batch(std::slice::from_raw_parts(ticks, count),
+                                std::slice::from_raw_parts(inventories, count),
+                                std::slice::from_raw_parts_mut(quotes_out, count));
+}
+
+#[no_mangle]
+pub extern "C" fn rust_risk_control_new(max_position: i64) -> *mut RiskControl {
+    Box::into_raw(Box::new(RiskControl::new(max_position)))
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rust_risk_control_free(rc: *mut RiskControl) {
+    if !rc.is_null() {
+        drop(Box::from_raw(rc));
+    }
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rust_risk_control_check_pre_trade(rc: *const RiskControl, order: *const Order,
+                                                           current_position: i64) -> bool {
+    (*rc).check_pre_trade(&*order, current_position)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rust_risk_control_check_pre_trade_batch(rc: *const RiskControl, orders: *const Order,
+                                                                 count: usize, current_position: i64,
+                                                                 verdicts_out: *mut u8) -> usize {
+    if count == 0 {
+        return 0;
+    }
+    (*rc).check_pre_trade_batch(std::slice::from_raw_parts(orders, count), current_position,
+                                std::slice::from_raw_parts_mut(verdicts_out, count))
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rust_risk_control_trigger_kill_switch(rc: *const RiskControl) {
+    (*rc).trigger_kill_switch();
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rust_risk_control_is_halted(rc: *const RiskControl) -> bool {
+    (*rc).is_halted()
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rust_ring_push_ticks(region: *mut c_void, ticks: *const MarketTick, count: usize) -> usize {
+    match ShmRing::<MarketTick>::from_region(region as *mut u8) {
+        Some(mut ring) if count > 0 => ring.push_bulk(std::slice::from_raw_parts(ticks, count)),
+        _ => 0,
+    }
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rust_ring_pop_ticks(region: *mut c_void, ticks_out: *mut MarketTick, max_ticks: usize) -> usize {
+    match ShmRing::<MarketTick>::from_region(region as *mut u8) {
+        Some(mut ring) if max_ticks > 0 => ring.pop_bulk(std::slice::from_raw_parts_mut(ticks_out, max_ticks)),
+        _ => 0,
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn rust_benchmark_queue_throughput() {
+    benchmark_queue_throughput();
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -405,4 +762,103 @@ mod tests {
         assert!(bid < tick.mid_price);
         assert!(ask > tick.mid_price);
     }
+    
+    fn ring_region(capacity: usize) -> (*mut u8, std::alloc::Layout) {
+        let layout = std::alloc::Layout::from_size_align(
+            RING_DATA_OFFSET + capacity * size_of::<MarketTick>(), 64).unwrap();
+        (unsafe { std::alloc::alloc_zeroed(layout) }, layout)
+    }
+    
+    #[test]
+    fn test_ring_roundtrip_and_wrap() {
+        let (region, layout) = ring_region(16);
+        let mut producer = unsafe { ShmRing::<MarketTick>::init_region(region, 16, "/hft_test_ring") };
+        let mut consumer = unsafe { ShmRing::<MarketTick>::from_region(region) }.unwrap();
+        assert_eq!(producer.capacity(), 16);
+        
+        let ticks: Vec<MarketTick> = (0..40).map(|i| {
+            let mut t = MarketTick::default();
+            t.timestamp_ns = i;
+            t.asset_id = i as u32;
+            t
+        }).collect();
+        
+        // Fills to capacity, then wraps as the consumer drains
+        assert_eq!(producer.push_bulk(&ticks), 16);
+        assert!(!producer.push(ticks[16]));
+        let mut out = [MarketTick::default(); 10];
+        assert_eq!(consumer.pop_bulk(&mut out), 10);
+        assert_eq!(unsafe { rust_ring_push_ticks(region as *mut c_void, ticks[16..].as_ptr(), 24) }, 10);
+        
+        let mut seen = Vec::new();
+        seen.extend(out.iter().map(|t| t.timestamp_ns));
+        while let Some(t) = consumer.pop() {
+            assert_eq!(t.asset_id as i64, t.timestamp_ns);
+            seen.push(t.timestamp_ns);
+        }
+        assert_eq!(seen, (0..26).collect::<Vec<i64>>());
+        assert!(producer.is_empty());
+        unsafe { std::alloc::dealloc(region, layout) };
+    }
+    
+    #[test]
+    fn test_ring_rejects_foreign_layout() {
+        let (region, layout) = ring_region(8);
+        assert!(unsafe { ShmRing::<MarketTick>::from_region(region) }.is_none());   // Not initialized
+        let _ring = unsafe { ShmRing::<MarketTick>::init_region(region, 8, "ticks") };
+        assert!(unsafe { ShmRing::<Order>::from_region(region) }.is_none());
+        let mut out = [MarketTick::default(); 1];
+        assert_eq!(unsafe { rust_ring_pop_ticks(std::ptr::null_mut(), out.as_mut_ptr(), 1) }, 0);
+        unsafe { std::alloc::dealloc(region, layout) };
+    }
+    
+    #[test]
+    fn test_batches_match_single_calls() {
+        let mm = rust_market_maker_new(0.1, 0.2, 0.01);
+        let rc = rust_risk_control_new(100);
+        let ticks: Vec<MarketTick> = (0..8).map(|i| {
+            let mut t = MarketTick::default();
+            t.mid_price = 100.0 + i as f64 * 0.05;
+            t
+        }).collect();
+        let inventories: Vec<i64> = (0..8).map(|i| i * 50 - 200).collect();
+        let mut quotes = [QuotePair::default(); 8];
+        
+        let orders: Vec<Order> = (0..8).map(|i| Order {
+            order_id: i,
+            asset_id: 1,
+            side: (i % 2) as u8,
+            price: 100.0,
+            quantity: i * 20,
+            submit_time_ns: 0,
+            venue_id: 0,
+            is_active: true,
+            _padding: [0; 6],
+        }).collect();
+        let mut verdicts = [0u8; 8];
+        
+        unsafe {
+            rust_market_maker_generate_quotes_batch(mm, ticks.as_ptr(), inventories.as_ptr(), 8, quotes.as_mut_ptr());
+            for i in 0..8 {
+                let (mut bid, mut ask) = (0.0, 0.0);
+                rust_market_maker_generate_quotes(mm, &ticks[i], inventories[i], &mut bid, &mut ask);
+                assert_eq!((quotes[i].bid_price, quotes[i].ask_price), (bid, ask));
+                assert_eq!(quotes[i].spread, ask - bid);
+            }
+            
+            let approved = rust_risk_control_check_pre_trade_batch(rc, orders.as_ptr(), 8, 20, verdicts.as_mut_ptr());
+            for i in 0..8 {
+                assert_eq!(verdicts[i] == 1, rust_risk_control_check_pre_trade(rc, &orders[i], 20));
+            }
+            assert_eq!(approved, verdicts.iter().filter(|&&v| v == 1).count());
+            assert!(approved > 0 && approved < 8);
+            
+            rust_risk_control_trigger_kill_switch(rc);
+            assert_eq!(rust_risk_control_check_pre_trade_batch(rc, orders.as_ptr(), 8, 0, verdicts.as_mut_ptr()), 0);
+            assert!(verdicts.iter().all(|&v| v == 0));
+            
+            rust_market_maker_free(mm);
+            rust_risk_control_free(rc);
+        }
+    }
 }
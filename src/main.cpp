@@ -12,17 +12,28 @@
 #include "websocket_server.hpp"
 #include "spin_loop_engine.hpp"
 #include "jitter_profiler.hpp"
+#include "hot_path_trace.hpp"
+#include "engine_checkpoint.hpp"
+#include "memory_arena.hpp"
+#include "simd_dispatch.hpp"
+#include "strategy_pipeline.hpp"
 #include <iostream>
 #include <iomanip>
 #include <vector>
 #include <atomic>
 #include <csignal>
 #include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
 #include <sched.h>
 #include <sys/mman.h>
 
 using namespace hft;
 
+// Debug builds count heap allocations made by the armed trading loop
+HFT_DEFINE_ALLOCATION_TRACKING()
+
 std::atomic<bool> g_shutdown_requested{false};
 
 void signal_handler(int sig) {
@@ -130,6 +141,26 @@ public:
     double get_volatility_index() const {
         return get_realized_volatility() * 5.0; // / 0.20
     }
+
+    void save_state(checkpoint::StateWriter& out) const {
+        out.put(window_size_);
+        out.put(head_);
+        out.put(count_);
+        out.put(sum_ret_);
+        out.put(sum_sq_ret_);
+        out.put(last_price_);
+        out.put(returns_);
+    }
+
+    void restore_state(checkpoint::StateReader& in) {
+        in.get(window_size_);
+        in.get(head_);
+        in.get(count_);
+        in.get(sum_ret_);
+        in.get(sum_sq_ret_);
+        in.get(last_price_);
+        in.get(returns_);
+    }
     
 private:
     size_t window_size_;
@@ -141,6 +172,107 @@ private:
     std::array<double, 1024> returns_;
 };
 
+// Warm-start checkpoint: model, risk and position state, written
+// periodically and on shutdown, restored at startup after cache warming.
+// The trading loop only snapshots; BackgroundCheckpointWriter does the I/O.
+constexpr const char* CHECKPOINT_PATH = "hft_engine.ckpt";
+constexpr uint32_t CHECKPOINT_VERSION = 2;
+constexpr uint64_t CHECKPOINT_INTERVAL_CYCLES = 1000000;
+
+struct LiveComponents {
+    HawkesIntensityEngine& hawkes;
+    FPGA_DNN_Inference& inference;
+    DynamicMMStrategy& strategy;
+    RiskControl& risk;
+    VolatilityEstimator& volatility;
+    TradingState& state;
+};
+
+// Changes on every reboot; empty where the kernel doesn't provide one
+std::string current_boot_id() {
+    std::ifstream file("/proc/sys/kernel/random/boot_id");
+    std::string id;
+    std::getline(file, id);
+    return id;
+}
+
+// Position the venue holds for us, which a restart must not second-guess.
+// Quotes here never leave the process, so that is the risk engine's own
+// count; a build that sends orders asks the venue (drop copy, position
+// request) instead.
+int64_t venue_position(const RiskControl& risk) {
+    return risk.get_current_position();
+}
+
+// Copies the state into `writer`; no allocation once its sections have
+// grown (BackgroundCheckpointWriter::reserve)
+void fill_live_checkpoint(CheckpointWriter& writer, const LiveComponents& c, const std::string& boot_id) {
+    writer.section("boot", CHECKPOINT_VERSION).put_string(boot_id);
+    c.hawkes.save_state(writer.section("hawkes", CHECKPOINT_VERSION));
+    c.inference.save_state(writer.section("inference", CHECKPOINT_VERSION));
+    c.strategy.save_state(writer.section("strategy", CHECKPOINT_VERSION));
+    c.risk.save_state(writer.section("risk", CHECKPOINT_VERSION));
+    c.volatility.save_state(writer.section("volatility", CHECKPOINT_VERSION));
+    auto& state = writer.section("position", CHECKPOINT_VERSION);
+    state.put(c.state.current_position);
+    state.put(c.state.realized_pnl);
+    state.put(c.state.unrealized_pnl);
+    state.put(c.state.total_trades);
+    state.put(c.state.last_tick);
+    state.put(c.state.reference_asset_tick);
+}
+
+// False when there is no usable checkpoint; the engine then starts cold.
+// Models resume from the file, but the position is the venue's: fills while
+// the engine was down, or after the last checkpoint, are not in the file.
+// Resting quotes are not restored either.
+bool restore_live_checkpoint(LiveComponents& c) {
+    if (!std::filesystem::exists(CHECKPOINT_PATH)) {
+        return false;
+    }
+    try {
+        const CheckpointReader reader(CHECKPOINT_PATH);
+        // Monotonic timestamps do not survive a reboot, and after one the
+        // new uptime soon passes the saved time, so compare boot IDs. With
+        // no boot ID a stale file can't be told apart: start cold.
+        const std::string boot_id = reader.section("boot", CHECKPOINT_VERSION).get_string();
+        if (boot_id.empty() || boot_id != current_boot_id()) {
+            std::cerr << "Warning: " << CHECKPOINT_PATH << " predates a reboot, starting cold" << std::endl;
+            return false;
+        }
+        auto hawkes = reader.section("hawkes", CHECKPOINT_VERSION);
+        auto inference = reader.section("inference", CHECKPOINT_VERSION);
+        auto strategy = reader.section("strategy", CHECKPOINT_VERSION);
+        auto risk = reader.section("risk", CHECKPOINT_VERSION);
+        auto volatility = reader.section("volatility", CHECKPOINT_VERSION);
+        auto state = reader.section("position", CHECKPOINT_VERSION);
+        const int64_t live_position = venue_position(c.risk);
+        c.hawkes.restore_state(hawkes);
+        c.inference.restore_state(inference);
+        c.strategy.restore_state(strategy);
+        c.risk.restore_state(risk);
+        c.volatility.restore_state(volatility);
+        const int64_t saved_position = state.get<int64_t>();
+        state.get(c.state.realized_pnl);
+        state.get(c.state.unrealized_pnl);
+        state.get(c.state.total_trades);
+        state.get(c.state.last_tick);
+        state.get(c.state.reference_asset_tick);
+        c.state.previous_tick = c.state.last_tick;
+
+        if (saved_position != live_position) {
+            std::cerr << "Warning: " << CHECKPOINT_PATH << " has position " << saved_position
+                      << ", the venue reports " << live_position << "; using the venue's" << std::endl;
+        }
+        c.state.current_position = live_position;
+        c.risk.reconcile_position(live_position);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: failed to restore " << CHECKPOINT_PATH << ": " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
 // System Initialization: Configure for ultra-low latency
 void configure_system_for_low_latency() {
     // Lock all current and future pages in RAM (prevent swapping)
@@ -167,6 +299,22 @@ void configure_system_for_low_latency() {
 #endif
     
     std::cout << "[SYSTEM] Memory locked, CPU affinity set, RT priority configured" << std::endl;
+    
+    // Hot-path containers built after this point come from one prefaulted,
+    // node-local, hugepage-backed arena
+    ArenaConfig arena_config;
+    arena_config.numa_node = system_determinism::NUMAOptimization::get_current_numa_node();
+    try {
+        const HugePageArena& arena = HotPathMemory::install(arena_config);
+        std::cout << "[SYSTEM] Hot-path arena: " << (arena.capacity() >> 20) << " MB on node "
+                  << arena.numa_node() << (arena.huge_pages() ? " (hugetlbfs)" : " (THP)")
+                  << (arena.locked() ? ", locked" : "") << std::endl;
+    } catch (const std::bad_alloc&) {
+        std::cerr << "Warning: Failed to map hot-path arena, using the heap" << std::endl;
+    }
+
+    // Feature/inference kernel variant, picked once from CPUID
+    std::cout << "[SYSTEM] SIMD kernels: " << simd::isa_name(simd::active_isa()) << std::endl;
 }
 
 // Main Trading Loop
@@ -187,9 +335,12 @@ int main() {
     nic.start();
     std::cout << "[INIT] Kernel Bypass NIC (zero-copy, 16K ring buffer)" << std::endl;
     
-    // 2. Shared Memory Queue (multi-process IPC)
-    shm::SharedMarketDataQueue shared_queue("hft_market_data", true);
-    std::cout << "[INIT] Shared Memory IPC (32K capacity, /dev/shm)" << std::endl;
+    // 2. Shared Memory Bus (one tick stream for strategy/risk/recorder processes)
+    shm::MarketDataBus market_bus("hft_market_data", true, /*huge_pages=*/true);
+    constexpr size_t BUS_BATCH = 16;
+    CompactTick bus_batch[BUS_BATCH];
+    size_t bus_batch_size = 0;
+    std::cout << "[INIT] Shared Memory Bus (32K capacity, 8 subscribers, batched publish)" << std::endl;
     
     // 3. Event Scheduler (nanosecond-precision timing wheel)
     scheduler::TimingWheelScheduler timing_wheel(1024, std::chrono::microseconds(10));
@@ -244,9 +395,14 @@ int main() {
     simulator.start(1000.0);  // 1000 Hz update rate
     std::cout << "[INIT] Market data simulator started (1000 Hz)\n" << std::endl;
     
+    // Tick-to-quote path shared with BacktestingEngine (strategy_pipeline.hpp)
+    auto strategy_pipeline = pipeline::make_production_pipeline(fpga_inference, mm_strategy, risk_control);
+    
     TradingState state;
     PerformanceMetrics metrics;
     JitterProfiler jitter_profiler;
+    HotPathTracer tracer;
+    auto& trace = tracer.register_thread("trading");
     
     // Initialize reference asset tick (for cross-asset features)
     state.reference_asset_tick.mid_price = 100.0;
@@ -266,11 +422,12 @@ int main() {
         dummy_tick.trade_volume = 100;
         
         // Execute heavy compute path
-        const auto features = fpga_inference.extract_features(dummy_tick, state.reference_asset_tick, 10.0, 10.0);
-        const auto pred = fpga_inference.predict(features);
+        pipeline::TickContext ctx{dummy_tick, state.reference_asset_tick};
+        ctx.buy_intensity = 10.0;
+        ctx.sell_intensity = 10.0;
+        ctx.time_remaining = 300.0;
+        strategy_pipeline.on_tick(ctx);
         vol_estimator.update(dummy_tick.mid_price);
-        mm_strategy.calculate_quotes(dummy_tick.mid_price, 0, 300.0, 0.0);
-        risk_control.check_pre_trade_limits(Order(), 0);
         
         // Prevent optimizer from removing this loop
         std::atomic_signal_fence(std::memory_order_release);
@@ -278,6 +435,26 @@ int main() {
     std::cout << "[INIT] Warm-up complete. CPU Branch Predictors trained." << std::endl;
     // =============================
     
+    // Model state from the last session (after warm-up, which feeds dummy ticks)
+    LiveComponents live{hawkes, fpga_inference, mm_strategy, risk_control, vol_estimator, state};
+    const auto restore_start = now();
+    if (restore_live_checkpoint(live)) {
+        std::cout << "[INIT] Warm start from " << CHECKPOINT_PATH << " in "
+                  << (to_nanos(now()) - to_nanos(restore_start)) / 1000 << " µs (position "
+                  << state.current_position << ")" << std::endl;
+    } else {
+        std::cout << "[INIT] Cold start (no checkpoint)" << std::endl;
+    }
+
+    // The loop only copies state into this writer's buffer; reserve() grows
+    // it now so those copies don't allocate
+    const std::string boot_id = current_boot_id();
+    BackgroundCheckpointWriter checkpoints(CHECKPOINT_PATH, [](const std::exception& e) {
+        std::cerr << "Warning: checkpoint failed: " << e.what() << std::endl;
+    });
+    auto snapshot = [&](CheckpointWriter& writer) { fill_live_checkpoint(writer, live, boot_id); };
+    checkpoints.reserve(snapshot);
+    
     uint64_t cycle_count = 0;
     const uint64_t print_interval = 1000;  // Print stats every N cycles
     
@@ -293,6 +470,9 @@ int main() {
     std::cout << "  L1 Cache Prefetching & Warm-up" << std::endl;
     std::cout << "Target latency: < 1000 ns per decision cycle\n" << std::endl;
     
+    tracer.start();
+    SteadyStateAllocations::arm();
+    MarketTick tick;
     while (!g_shutdown_requested.load(std::memory_order_acquire) && 
            !risk_control.is_kill_switch_triggered()) {
         
@@ -306,17 +486,20 @@ int main() {
         JitterProfiler::prefetch_next_line(&state); // Prefetch adjacent lines
         
         const Timestamp cycle_start = now();
+        trace.begin_cycle();
         
-        // Get market data (zero-copy from NIC)
-        MarketTick tick;
-        bool has_data = nic.get_next_tick(tick);
-        
-        // Also try shared memory queue (for multi-process architecture)
-        if (!has_data && !shared_queue.empty()) {
-            has_data = shared_queue.read(tick);
-        }
+        // Get market data (zero-copy from NIC, one cache line per tick)
+        CompactTick wire;
+        bool has_data = nic.get_next_tick(wire);
+        trace.mark(TraceStage::RX);
         
         if (!has_data) {
+            // NIC idle: flush the partial batch so subscribers are not held back
+            if (bus_batch_size > 0) {
+                market_bus.publish_bulk(bus_batch, bus_batch_size);
+                bus_batch_size = 0;
+            }
+
             // BUSY-WAIT instead of yield for sub-microsecond response
             #if defined(__x86_64__)
                 _mm_pause();
@@ -326,8 +509,16 @@ int main() {
             continue;
         }
         
-        // Write to shared memory for other processes (optional)
-        shared_queue.write(tick);
+        // Fan out to other processes; one publication per batch
+        bus_batch[bus_batch_size++] = wire;
+        if (bus_batch_size == BUS_BATCH) {
+            market_bus.publish_bulk(bus_batch, bus_batch_size);
+            bus_batch_size = 0;
+        }
+        
+        // Expand with depth for the feature pipeline (reused, never reconstructed)
+        to_market_tick(wire, nic.depth(), tick);
+        trace.mark(TraceStage::DECODE);
         
         ++metrics.total_ticks_processed;
         state.previous_tick = state.last_tick;
@@ -341,18 +532,7 @@ int main() {
         
         const double hawkes_buy_intensity = hawkes.get_buy_intensity();
         const double hawkes_sell_intensity = hawkes.get_sell_intensity();
-        
-        // Feature extraction
-        const auto features = fpga_inference.extract_features(
-            tick,
-            state.reference_asset_tick,
-            hawkes_buy_intensity,
-            hawkes_sell_intensity
-        );
-        
-        // Prediction
-        const auto prediction = fpga_inference.predict(features);
-        // prediction = [buy_score, hold_score, sell_score]
+        trace.mark(TraceStage::HAWKES);
         
         // 
         // Step 5: Update volatility estimate and risk regime
@@ -361,54 +541,36 @@ int main() {
         const double vol_index = vol_estimator.get_volatility_index();
         risk_control.set_regime_multiplier(vol_index);
         
-        // 
-        // Step 6: Calculate latency cost
-        // 
-        const double current_vol = vol_estimator.get_realized_volatility();
-        const double latency_cost = mm_strategy.calculate_latency_cost(
-            current_vol, 
-            tick.mid_price
-        );
+        // Features -> prediction -> quotes -> pre-trade risk, one inlined path
+        pipeline::TickContext ctx{tick, state.reference_asset_tick};
+        ctx.buy_intensity = hawkes_buy_intensity;
+        ctx.sell_intensity = hawkes_sell_intensity;
+        ctx.position = state.current_position;
+        ctx.volatility = vol_estimator.get_realized_volatility();
+        ctx.time_remaining = 300.0;
+        ctx.order_id = cycle_count * 2;
+        const pipeline::Decision decision = strategy_pipeline.on_tick(ctx, pipeline::AlwaysQuote{}, trace);
+        const QuotePair& quotes = decision.quotes;
+        // decision.prediction = [buy_score, hold_score, sell_score]
         
-        // Quote generation
-        const double time_remaining = 300.0;
-        const QuotePair quotes = mm_strategy.calculate_quotes(
-            tick.mid_price,
-            state.current_position,
-            time_remaining,
-            latency_cost
-        );
-        
-        // Risk management
+        // Order submission (in production: send to exchange)
         if (quotes.bid_price > 0 && quotes.ask_price > 0) {
-            // Create potential orders
-            Order bid_order(cycle_count * 2, tick.asset_id, Side::BUY, 
-                          quotes.bid_price, static_cast<uint64_t>(quotes.bid_size));
-            Order ask_order(cycle_count * 2 + 1, tick.asset_id, Side::SELL,
-                          quotes.ask_price, static_cast<uint64_t>(quotes.ask_size));
-            
-            // Pre-trade risk checks
-            const bool bid_approved = risk_control.check_pre_trade_limits(
-                bid_order, state.current_position);
-            const bool ask_approved = risk_control.check_pre_trade_limits(
-                ask_order, state.current_position);
-            
-            // Order submission (in production: send to exchange)
-            
-            if (bid_approved && mm_strategy.should_quote(quotes.spread, latency_cost)) {
+            if (decision.bid_approved && decision.should_quote) {
                 // Submit bid order
                 // In production: nic.send_order(bid_order);
                 state.active_quotes.bid_price = quotes.bid_price;
                 state.active_quotes.bid_size = quotes.bid_size;
             }
             
-            if (ask_approved && mm_strategy.should_quote(quotes.spread, latency_cost)) {
+            if (decision.ask_approved && decision.should_quote) {
                 // Submit ask order
                 // In production: nic.send_order(ask_order);
                 state.active_quotes.ask_price = quotes.ask_price;
                 state.active_quotes.ask_size = quotes.ask_size;
             }
+            trace.mark(TraceStage::SEND);
         }
+        trace.end_cycle();
         
         // Measure cycle latency
         const Timestamp cycle_end = now();
@@ -463,6 +625,10 @@ int main() {
         // 
         // Periodic status updates
         // 
+        if (cycle_count % CHECKPOINT_INTERVAL_CYCLES == 0) {
+            checkpoints.submit(to_nanos(now()), cycle_count, snapshot);    // Skipped while the last is still writing
+        }
+        
         if (cycle_count % print_interval == 0) {
             const auto nic_stats = nic.get_stats();
             
@@ -500,11 +666,31 @@ int main() {
     // 
     // Shutdown sequence
     // 
+    SteadyStateAllocations::disarm();
     std::cout << "\n\n=== Shutting Down ===" << std::endl;
     
     simulator.stop();
     nic.stop();
     dashboard.stop();
+    tracer.stop();
+    
+    checkpoints.flush();
+    const uint64_t failures = checkpoints.failures();
+    checkpoints.submit(to_nanos(now()), cycle_count, snapshot);
+    checkpoints.flush();
+    if (checkpoints.failures() == failures) {
+        std::cout << "State checkpointed to " << CHECKPOINT_PATH << std::endl;
+    }
+    
+    if (bus_batch_size > 0) {
+        market_bus.publish_bulk(bus_batch, bus_batch_size);
+    }
+    for (const auto& sub : market_bus.subscribers()) {
+        if (sub.lost > 0) {
+            std::cout << "Bus subscriber " << sub.name << " (pid " << sub.pid << ") lost "
+                      << sub.lost << " ticks" << std::endl;
+        }
+    }
     
     // Export metrics to CSV
     metrics_collector.export_to_csv("trading_metrics.csv");
@@ -533,6 +719,11 @@ int main() {
     
     metrics.print_stats();
     jitter_profiler.print_report();
+    tracer.print_report();
+    SteadyStateAllocations::print_report();
+    if (tracer.write_chrome_trace("hot_path_trace.json")) {
+        std::cout << "Stage trace written to hot_path_trace.json (chrome://tracing)" << std::endl;
+    }
     
     const auto final_nic_stats = nic.get_stats();
     std::cout << "\n=== NIC Statistics ===" << std::endl;
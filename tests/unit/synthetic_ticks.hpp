@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// Deterministic synthetic market data shared by the backtest tests
+
+namespace test_data {
+
+constexpr int64_t START_US = 1640995200000000LL;   // 2022-01-01, in the CSV's ts_us
+
+// 64-bit LCG (Knuth's MMIX constants); the same seed gives the same stream
+// on every platform, unlike the <random> distributions
+struct Lcg {
+    uint64_t x;
+
+    explicit Lcg(uint64_t seed) : x(seed) {}
+
+    uint64_t next() {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        return x;
+    }
+};
+
+// Trade prints every 1ms from `start_us`, within +/-1.00 of `base`. Sides
+// run 40 buys then 10 sells, a persistent buy imbalance that keeps the
+// Hawkes intensities, and so the strategy, quoting.
+inline void write_trade_csv(const std::string& path, int rows, uint64_t seed = 987654321,
+                            double base = 100.0, int64_t start_us = START_US) {
+    std::ofstream file(path);
+    file << "ts_us,event_type,side,price,size\n";
+    Lcg rng(seed);
+    for (int i = 0; i < rows; ++i) {
+        const uint64_t x = rng.next();
+        const double price = base + static_cast<double>((x >> 33) % 200) * 0.01 - 1.0;
+        file << (start_us + i * 1000LL) << ",trade," << ((i % 50 < 40) ? 'B' : 'S') << ','
+             << price << ',' << (100 + (x >> 40) % 200) << "\n";
+    }
+}
+
+// Same price walk with one trade per two quotes and random sides
+inline void write_mixed_csv(const std::string& path, int rows, uint64_t seed = 12345) {
+    std::ofstream file(path);
+    file << "ts_us,event_type,side,price,size\n";
+    Lcg rng(seed);
+    for (int i = 0; i < rows; ++i) {
+        const uint64_t x = rng.next();
+        const double price = 100.0 + static_cast<double>((x >> 33) % 200) * 0.01 - 1.0;
+        file << (START_US + i * 1000LL) << ',' << ((i % 3 == 0) ? "trade" : "quote") << ','
+             << (((x >> 20) & 1) ? 'B' : 'S') << ',' << price << ',' << (100 + (x >> 40) % 200) << "\n";
+    }
+}
+
+} // namespace test_data
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <vector>
+#include "backtesting_engine.hpp"
+#include "synthetic_ticks.hpp"
+
+using namespace hft;
+using hft::backtest::PositionLedger;
+using hft::backtest::StreamingPerformance;
+
+// Test average-cost accounting through adds, partial closes and a flip
+TEST(BacktestAccountingTest, LedgerAverageCost) {
+    PositionLedger ledger;
+    EXPECT_EQ(ledger.on_fill(Side::BUY, 100, 10.0, 0.5), 0.0);
+    EXPECT_EQ(ledger.on_fill(Side::BUY, 100, 12.0, 0.5), 0.0);
+    EXPECT_EQ(ledger.position(), 200);
+    EXPECT_EQ(ledger.average_price(), 11.0);
+    EXPECT_EQ(ledger.unrealized(11.5), 100.0);
+
+    EXPECT_EQ(ledger.on_fill(Side::SELL, 150, 13.0), 300.0);       // partial close
+    EXPECT_EQ(ledger.position(), 50);
+    EXPECT_EQ(ledger.average_price(), 11.0);
+
+    EXPECT_EQ(ledger.on_fill(Side::SELL, 100, 9.0), -100.0);       // close 50, open 50 short
+    EXPECT_EQ(ledger.position(), -50);
+    EXPECT_EQ(ledger.average_price(), 9.0);
+    EXPECT_EQ(ledger.unrealized(8.0), 50.0);
+
+    EXPECT_EQ(ledger.on_fill(Side::BUY, 50, 8.0), 50.0);           // flat
+    EXPECT_EQ(ledger.position(), 0);
+    EXPECT_EQ(ledger.unrealized(100.0), 0.0);
+
+    EXPECT_EQ(ledger.realized(), 250.0);
+    EXPECT_EQ(ledger.fees(), 1.0);
+    EXPECT_EQ(ledger.fills(), 5u);
+    EXPECT_EQ(ledger.closing_fills(), 3u);
+    EXPECT_EQ(ledger.winning_fills(), 2u);
+    EXPECT_EQ(ledger.losing_fills(), 1u);
+    EXPECT_EQ(ledger.gross_profit(), 350.0);
+    EXPECT_EQ(ledger.gross_loss(), 100.0);
+}
+
+// Test the streaming statistics agree with a batch pass over the same series
+TEST(BacktestAccountingTest, StreamingMatchesBatch) {
+    std::vector<double> pnl;
+    test_data::Lcg rng(12345);
+    double level = 0.0;
+    for (int i = 0; i < 5000; ++i) {
+        level += static_cast<double>(static_cast<int>((rng.next() >> 33) % 9) - 4) * 0.25;
+        pnl.push_back(level);
+    }
+
+    StreamingPerformance perf(1000.0, 0, 8192);
+    for (size_t i = 0; i < pnl.size(); ++i) perf.add(static_cast<int64_t>(i), pnl[i], 1.0);
+
+    std::vector<double> returns;
+    for (size_t i = 1; i < pnl.size(); ++i) returns.push_back(pnl[i] - pnl[i - 1]);
+    double mean = 0.0;
+    for (double r : returns) mean += r;
+    mean /= returns.size();
+    double sq = 0.0, down_sq = 0.0;
+    size_t down = 0;
+    for (double r : returns) {
+        sq += (r - mean) * (r - mean);
+        if (r < 0.0) { down_sq += r * r; ++down; }
+    }
+    double peak = 1000.0 + pnl[0], max_dd = 0.0;
+    for (double p : pnl) {
+        peak = std::max(peak, 1000.0 + p);
+        max_dd = std::max(max_dd, (peak - 1000.0 - p) / peak);
+    }
+    std::vector<double> sorted = returns;
+    std::sort(sorted.begin(), sorted.end());
+    const size_t idx = static_cast<size_t>(sorted.size() * 0.05);
+
+    EXPECT_EQ(perf.returns(), returns.size());
+    EXPECT_NEAR(perf.mean_return(), mean, 1e-12);
+    EXPECT_NEAR(perf.volatility(), std::sqrt(sq / returns.size()), 1e-9);
+    EXPECT_NEAR(perf.downside_deviation(), std::sqrt(down_sq / down), 1e-9);
+    EXPECT_NEAR(perf.max_drawdown(), max_dd, 1e-12);
+    EXPECT_EQ(perf.mean_spread_bps(), 1.0);
+
+    double var = 0.0, cvar = 0.0;
+    perf.tail_risk(var, cvar);
+    EXPECT_EQ(var, -sorted[idx]);                                   // reservoir holds every return
+    EXPECT_GE(cvar, var);
+}
+
+// Test the equity curve stays bounded and evenly strided, and a backtest can
+// run without keeping its fill log
+TEST(BacktestAccountingTest, BoundedCurveAndFillLog) {
+    StreamingPerformance perf(1000.0, 8);
+    for (int64_t i = 0; i < 1000; ++i) perf.add(i, static_cast<double>(i), 0.0);
+    const auto ts = perf.timestamps();
+    const auto curve = perf.equity_curve();
+    ASSERT_EQ(ts.size(), curve.size());
+    EXPECT_LE(ts.size(), 9u);
+    EXPECT_EQ(ts.front(), 0);
+    EXPECT_EQ(ts.back(), 999);
+    EXPECT_EQ(curve.back(), 999.0);
+    for (size_t i = 2; i + 1 < ts.size(); ++i) EXPECT_EQ(ts[i] - ts[i - 1], ts[1] - ts[0]);
+
+    const std::string path = "/tmp/test_backtest_accounting.csv";
+    test_data::write_trade_csv(path, 400);
+
+    auto run = [&](bool record_fills) {
+        backtest::BacktestConfig config;
+        config.hawkes.beta = 1.0;
+        config.verbose = false;
+        config.enable_replay_logging = false;
+        config.equity_curve_points = 16;
+        config.record_fills = record_fills;
+        backtest::BacktestingEngine engine(config);
+        EXPECT_TRUE(engine.load_historical_data(path));
+        const auto metrics = engine.run_backtest();
+        EXPECT_LE(metrics.equity_curve.size(), 17u);
+        EXPECT_EQ(engine.get_filled_orders().size(), record_fills ? engine.get_filled_orders_count() : 0u);
+        EXPECT_EQ(engine.get_ledger(1).position(), engine.get_current_position());
+        return metrics;
+    };
+    const auto with_log = run(true);
+    const auto without_log = run(false);
+    std::filesystem::remove(path);
+
+    EXPECT_GT(with_log.total_trades, 0u);
+    EXPECT_EQ(with_log.total_trades, without_log.total_trades);
+    EXPECT_EQ(with_log.total_pnl, without_log.total_pnl);
+    EXPECT_EQ(with_log.sharpe_ratio, without_log.sharpe_ratio);
+}
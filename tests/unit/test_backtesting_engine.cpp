@@ -3,7 +3,11 @@
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <algorithm>
+#include <map>
+#include <vector>
 #include "backtesting_engine.hpp"
+#include "synthetic_ticks.hpp"
 
 namespace {
 
@@ -361,4 +365,63 @@ TEST_F(BacktestingEngineTest, RiskMetricsCalculation) {
     EXPECT_FALSE(std::isnan(metrics.sortino_ratio));
 }
 
+// Test queue-position fills land on market events after the order reached
+// the venue and never overfill an order
+TEST_F(BacktestingEngineTest, QueuePositionFills) {
+    const std::string path = "/tmp/test_backtest_queue.csv";
+    test_data::write_trade_csv(path, 400);
+    std::vector<int64_t> event_ns;
+    for (int i = 0; i < 400; ++i) event_ns.push_back((test_data::START_US + i * 1000LL) * 1000);
+
+    hft::backtest::BacktestConfig config;
+    config.hawkes.beta = 1.0;
+    config.verbose = false;
+    config.enable_replay_logging = false;
+    ASSERT_EQ(config.fill_mode, hft::backtest::FillMode::QUEUE_POSITION);
+    hft::backtest::BacktestingEngine engine(config);
+    ASSERT_TRUE(engine.load_historical_data(path));
+    const auto metrics = engine.run_backtest();
+    std::filesystem::remove(path);
+
+    ASSERT_GT(engine.get_filled_orders_count(), 0u);
+    std::map<uint64_t, uint64_t> filled_by_order;
+    std::map<uint64_t, uint64_t> order_size;
+    for (const auto& fill : engine.get_filled_orders()) {
+        EXPECT_GE(fill.fill_time_ns, fill.submit_time_ns + config.simulated_latency_ns);
+        EXPECT_TRUE(std::binary_search(event_ns.begin(), event_ns.end(), fill.fill_time_ns) ||
+                    fill.fill_time_ns == fill.submit_time_ns + config.simulated_latency_ns);
+        filled_by_order[fill.order.order_id] += fill.filled_quantity;
+        order_size[fill.order.order_id] = fill.order.quantity;
+    }
+    for (const auto& [id, qty] : filled_by_order) {
+        EXPECT_LE(qty, order_size[id]) << id;
+    }
+    EXPECT_GT(metrics.fill_rate, 0.0);
+    EXPECT_LE(metrics.fill_rate, 1.0);
+}
+
+
+// Test the backtest resolves each order exactly one configured latency
+// after submission rather than at the next market event
+TEST_F(BacktestingEngineTest, ResolvesOrdersAtLatency) {
+    const std::string path = "/tmp/test_backtest_latency.csv";
+    test_data::write_trade_csv(path, 400);
+
+    hft::backtest::BacktestConfig config;
+    config.simulated_latency_ns = 1234;  // Well inside the 1ms tick spacing
+    config.fill_mode = hft::backtest::FillMode::PROBABILISTIC;  // Resolves on arrival
+    config.hawkes.beta = 1.0;            // Excitation outlives the tick spacing
+    config.verbose = false;
+    config.enable_replay_logging = false;
+    hft::backtest::BacktestingEngine engine(config);
+    ASSERT_TRUE(engine.load_historical_data(path));
+    engine.run_backtest();
+    std::filesystem::remove(path);
+
+    ASSERT_GT(engine.get_filled_orders_count(), 0u);
+    for (const auto& order : engine.get_filled_orders()) {
+        EXPECT_EQ(order.fill_time_ns - order.submit_time_ns, 1234);
+    }
+}
+
 } // namespace
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "hardware_bridge.hpp"
+#include "vectorized_inference.hpp"
+
+namespace {
+
+using hft::InferencePrecision;
+
+std::vector<hft::MicrostructureFeatures> random_features(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    std::vector<hft::MicrostructureFeatures> rows(count);
+    for (auto& f : rows) {
+        f.ofi_level_1 = unit(rng) * 50.0;
+        f.ofi_level_5 = unit(rng) * 200.0;
+        f.ofi_level_10 = unit(rng) * 400.0;
+        f.spread_ratio = 1.0 + unit(rng) * 0.5;
+        f.volume_imbalance = unit(rng);
+        f.hawkes_buy_intensity = 10.0 + unit(rng) * 5.0;
+        f.hawkes_sell_intensity = 10.0 + unit(rng) * 5.0;
+        f.hawkes_imbalance = unit(rng) * 0.3;
+        f.bid_ask_spread_bps = 2.0 + unit(rng);
+        f.mid_price_momentum = unit(rng) * 0.05;
+    }
+    return rows;
+}
+
+}
+
+// Test batched FP32/INT8 scoring tracks the per-row path, with partial
+// tiles, and skips the latency padding
+TEST(BatchedInferenceTest, FpgaBatchMatchesPredict) {
+    std::srand(7);
+    hft::FPGA_DNN_Inference engine(false);
+    const auto rows = random_features(37, 1);
+
+    std::vector<std::array<double, 3>> fp32(rows.size()), int8(rows.size());
+    engine.predict_batch(rows.data(), rows.size(), fp32.data());
+    engine.predict_batch(rows.data(), rows.size(), int8.data(), InferencePrecision::INT8);
+
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const auto expected = engine.predict(rows[i]);
+        for (size_t k = 0; k < 3; ++k) {
+            // predict() runs in double, the batch in float
+            EXPECT_NEAR(fp32[i][k], expected[k], 2e-3) << i;
+            EXPECT_NEAR(int8[i][k], expected[k], 2e-2) << i;
+        }
+        EXPECT_NEAR(fp32[i][0] + fp32[i][1] + fp32[i][2], 1.0, 1e-6);
+    }
+
+    engine.predict_batch(rows.data(), 0, fp32.data());
+    EXPECT_FALSE(engine.latency_padding());
+    engine.set_latency_padding(true);
+
+    const auto start = std::chrono::steady_clock::now();
+    engine.predict(rows[0]);
+    EXPECT_GE(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(),
+              engine.get_fixed_latency_ns());
+}
+
+// Test the engine-level batch agrees with predict()
+TEST(BatchedInferenceTest, VectorizedEngineBatchMatchesPredict) {
+    using Engine = hft::VectorizedInferenceEngine;
+    Engine engine;
+    std::mt19937_64 rng(3);
+    std::uniform_real_distribution<double> unit(-2.0, 2.0);
+
+    constexpr size_t ROWS = 21;
+    std::vector<double> features(ROWS * Engine::INPUT_SIZE);
+    for (auto& x : features) x = unit(rng);
+
+    std::vector<Engine::InferenceOutput> fp32(ROWS), int8(ROWS);
+    engine.predict_batch(features.data(), ROWS, fp32.data());
+    engine.predict_batch(features.data(), ROWS, int8.data(), InferencePrecision::INT8);
+
+    for (size_t i = 0; i < ROWS; ++i) {
+        const auto expected = engine.predict(&features[i * Engine::INPUT_SIZE]);
+        EXPECT_NEAR(fp32[i].buy_signal, expected.buy_signal, 1e-5);
+        EXPECT_NEAR(fp32[i].sell_signal, expected.sell_signal, 1e-5);
+        EXPECT_NEAR(fp32[i].hold_signal, expected.hold_signal, 1e-5);
+        EXPECT_NEAR(int8[i].buy_signal, expected.buy_signal, 1e-2);
+        EXPECT_NEAR(int8[i].hold_signal, expected.hold_signal, 1e-2);
+    }
+}
+
+// Test the bridge's software path scores a burst in one call
+TEST(BatchedInferenceTest, BridgeSoftwareBatch) {
+    std::srand(11);
+    HardwareInTheLoopBridge bridge(AcceleratorMode::HYBRID_FALLBACK);
+    ASSERT_TRUE(bridge.initialize());
+    bridge.set_software_latency_padding(false);
+
+    const auto rows = random_features(20, 2);
+    std::vector<double> out(rows.size());
+    bridge.predict_batch(rows.data(), rows.size(), out.data());
+
+    for (size_t i = 0; i < rows.size(); ++i) {
+        EXPECT_NEAR(out[i], bridge.predict(rows[i]), 2e-3);
+    }
+    EXPECT_EQ(bridge.get_latency_stats().total_inferences, 2 * rows.size());
+}
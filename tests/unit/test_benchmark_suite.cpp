@@ -3,6 +3,7 @@
 // #include "benchmark_suite.hpp"
 #include <vector>
 #include <algorithm>
+#include <cmath>
 
 // Test fixture for Benchmark Suite tests
 class BenchmarkSuiteTest : public ::testing::Test {
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "journal_decoder.hpp"
+
+using namespace hft;
+
+namespace {
+
+std::string read_file(const std::string& path) {
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+// Drops the wall-clock "# Generated:" header line
+std::string without_generated(const std::string& text) {
+    const size_t start = text.find("# Generated:");
+    if (start == std::string::npos) return text;
+    return text.substr(0, start) + text.substr(text.find("# Format:", start));
+}
+
+template<typename Log>
+void log_events(Log& replay, OrderGatewayLog& gateway, ExchangeACKLog& exchange) {
+    replay.log_config("{\"latency_ns\":500}", 42, "abc123");
+    for (int i = 0; i < 200; ++i) {
+        const int64_t ts = 1'000'000 + i * 1000;
+        replay.log_market_tick(ts, 100.0 + i * 0.01, 100.02 + i * 0.01, 300 + i, 400 - i);
+        replay.log_signal_decision(ts, i % 2 == 0, i % 2 == 0 ? "BUY" : "SELL", 0.75, 3, -0.125);
+        replay.log_order_submit(ts, i, "BUY", 100.01, 100);
+        replay.log_order_ack(ts + 10, i, 480);
+        replay.log_order_fill(ts + 20, i, 100.015, 50, 960);
+        replay.log_order_cancel(ts + 30, i, "outside_book_window");
+        replay.log_pnl_update(ts + 40, 12.5 * i, -3.25, i);
+        gateway.log_submit(i, "SELL", 99.99, 10, 5000 + i);
+        gateway.log_cancel(i, 6000 + i);
+        exchange.log_ack(i, 7000 + i);
+        exchange.log_fill(i, 10, 99.99, 8000 + i);
+        exchange.log_reject(i, "PRICE_BAND", 9000 + i);
+    }
+    replay.log_risk_breach(2'000'000, "POSITION", "HALT", 1200.0, 1000.0);
+}
+
+}
+
+// Test journal mode then offline decode reproduces what text mode writes
+TEST(BinaryJournalTest, DecodeMatchesTextLogs) {
+    const std::string dir = "/tmp";
+    {
+        InstitutionalLogging::EventReplayLogger replay(dir + "/test_journal_text_replay.log");
+        OrderGatewayLog gateway(dir + "/test_journal_text_gateway.log");
+        ExchangeACKLog exchange(dir + "/test_journal_text_exchange.log");
+        log_events(replay, gateway, exchange);
+    }
+
+    const std::string journal_path = dir + "/test_journal.journal";
+    {
+        BinaryJournal journal(journal_path);
+        {
+            InstitutionalLogging::EventReplayLogger replay("test_journal_text_replay.log", journal);
+            OrderGatewayLog gateway("test_journal_text_gateway.log", journal);
+            ExchangeACKLog exchange("test_journal_text_exchange.log", journal);
+            EXPECT_TRUE(replay.journaled());
+            log_events(replay, gateway, exchange);
+        }
+        journal.close();
+    }
+
+    const std::string out_dir = dir + "/test_journal_decoded";
+    ::mkdir(out_dir.c_str(), 0755);
+    const auto outputs = JournalDecoder::decode(journal_path, out_dir);
+    ASSERT_EQ(outputs.size(), 3u);
+    EXPECT_EQ(outputs[0].kind, JournalSourceKind::EVENT_REPLAY);
+    EXPECT_EQ(outputs[1].kind, JournalSourceKind::ORDER_GATEWAY);
+    EXPECT_EQ(outputs[2].kind, JournalSourceKind::EXCHANGE_ACK);
+
+    const std::string text_replay = read_file(dir + "/test_journal_text_replay.log");
+    ASSERT_FALSE(text_replay.empty());
+    EXPECT_EQ(without_generated(read_file(outputs[0].path)), without_generated(text_replay));
+    EXPECT_EQ(read_file(outputs[1].path), read_file(dir + "/test_journal_text_gateway.log"));
+    EXPECT_EQ(read_file(outputs[2].path), read_file(dir + "/test_journal_text_exchange.log"));
+
+    for (const char* name : {"replay", "gateway", "exchange"}) {
+        std::remove((dir + "/test_journal_text_" + name + ".log").c_str());
+        std::remove((out_dir + "/test_journal_text_" + name + ".log").c_str());
+    }
+    ::rmdir(out_dir.c_str());
+    std::remove(journal_path.c_str());
+}
+
+// Test concurrent sources across many file windows: every record lands,
+// in order per source
+TEST(BinaryJournalTest, ConcurrentWritersGrowFile) {
+    const std::string path = "/tmp/test_journal_concurrent.journal";
+    constexpr int SOURCES = 4;
+    constexpr uint64_t PER_SOURCE = 50000;                  // > ring capacity
+
+    {
+        BinaryJournal journal(path, -1, 4096);
+        std::vector<JournalWriter*> writers;
+        for (int s = 0; s < SOURCES; ++s) {
+            writers.push_back(&journal.open_source(JournalSourceKind::STRATEGY_TRACE, "src" + std::to_string(s)));
+        }
+
+        std::vector<std::thread> threads;
+        for (int s = 0; s < SOURCES; ++s) {
+            threads.emplace_back([w = writers[s]] {
+                for (uint64_t i = 0; i < PER_SOURCE; ++i) {
+                    JournalRecord r(1, static_cast<int64_t>(i));
+                    r.set(0, i);
+                    w->write(r);
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+        journal.flush();
+        EXPECT_EQ(journal.records_written(), SOURCES * (PER_SOURCE + 2));   // open + one name chunk
+        journal.close();
+    }
+
+    JournalReader reader(path);
+    ASSERT_EQ(reader.size(), SOURCES * (PER_SOURCE + 2));
+    std::vector<uint64_t> next(SOURCES + 1, 0);
+    for (size_t i = 0; i < reader.size(); ++i) {
+        const JournalRecord r = reader[i];
+        if (r.event != 1) continue;
+        ASSERT_GE(r.source, 1);
+        ASSERT_LE(r.source, SOURCES);
+        ASSERT_EQ(r.get<uint64_t>(0), next[r.source]);
+        ++next[r.source];
+    }
+    for (int s = 1; s <= SOURCES; ++s) EXPECT_EQ(next[s], PER_SOURCE);
+    std::remove(path.c_str());
+}
+
+// Test the reader rejects files that are not journals
+TEST(BinaryJournalTest, RejectsForeignFiles) {
+    const std::string path = "/tmp/test_journal_foreign.journal";
+    {
+        std::ofstream out(path);
+        out << std::string(256, 'x');
+    }
+    EXPECT_THROW(JournalReader{path}, std::runtime_error);
+    EXPECT_THROW(JournalReader{"/tmp/test_journal_missing.journal"}, std::runtime_error);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <type_traits>
+#include "compact_tick.hpp"
+#include "kernel_bypass_nic.hpp"
+
+using namespace hft;
+
+namespace {
+
+MarketTick full_tick(uint32_t asset, int64_t ts_ns) {
+    MarketTick t;
+    t.timestamp = Timestamp(std::chrono::nanoseconds(ts_ns));
+    t.bid_price = 99.75;
+    t.ask_price = 100.25;
+    t.mid_price = 100.0;
+    t.bid_size = 300;
+    t.ask_size = 400;
+    t.trade_volume = 25;
+    t.trade_side = Side::SELL;
+    t.asset_id = asset;
+    t.depth_levels = 10;
+    for (size_t i = 0; i < 10; ++i) {
+        t.bid_prices[i] = 99.75 - 0.25 * i;
+        t.ask_prices[i] = 100.25 + 0.25 * i;
+        t.bid_sizes[i] = 100 + i;
+        t.ask_sizes[i] = 200 + i;
+    }
+    return t;
+}
+
+void expect_bbo(const MarketTick& a, const MarketTick& b) {
+    EXPECT_EQ(a.timestamp, b.timestamp);
+    EXPECT_EQ(a.bid_price, b.bid_price);
+    EXPECT_EQ(a.ask_price, b.ask_price);
+    EXPECT_EQ(a.mid_price, b.mid_price);
+    EXPECT_EQ(a.bid_size, b.bid_size);
+    EXPECT_EQ(a.ask_size, b.ask_size);
+    EXPECT_EQ(a.trade_volume, b.trade_volume);
+    EXPECT_EQ(a.trade_side, b.trade_side);
+    EXPECT_EQ(a.asset_id, b.asset_id);
+}
+
+}
+
+// Test the hot tick is one cache line, copyable with memcpy, and starts
+// zeroed rather than stamped by the clock
+TEST(CompactTickTest, OneCacheLineNoClock) {
+    static_assert(sizeof(CompactTick) == 64, "one cache line");
+    static_assert(alignof(CompactTick) == 64, "cache-line aligned");
+    static_assert(std::is_trivially_copyable_v<CompactTick>, "memcpy-able");
+    EXPECT_LT(sizeof(CompactTick) * 5, sizeof(MarketTick));
+
+    CompactTick c;
+    EXPECT_EQ(c.timestamp_ns, 0);
+    EXPECT_EQ(c.book_id, CompactTick::NO_BOOK);
+    EXPECT_FALSE(c.has_depth());
+
+    const MarketTick t = full_tick(3, 123456789);
+    const CompactTick bbo = to_compact(t);
+    EXPECT_EQ(bbo.timestamp_ns, 123456789);
+    EXPECT_EQ(bbo.mid_price(), 100.0);
+    EXPECT_FALSE(bbo.has_depth());
+}
+
+// Test depth goes through the side table and comes back intact, and that
+// BBO-only expansion leaves a tick with no depth
+TEST(CompactTickTest, RoundTripWithDepth) {
+    DepthTable depth;
+    const MarketTick original = full_tick(5, 42);
+
+    const CompactTick c = to_compact(original, depth, 5);
+    EXPECT_TRUE(c.has_depth());
+    EXPECT_EQ(c.book_id, 5u);
+    EXPECT_EQ(c.depth_version, depth.version(5));
+    EXPECT_EQ(depth.version(4), 0u);
+
+    MarketTick back;
+    to_market_tick(c, depth, back);
+    expect_bbo(back, original);
+    EXPECT_EQ(back.depth_levels, original.depth_levels);
+    EXPECT_EQ(back.bid_prices, original.bid_prices);
+    EXPECT_EQ(back.ask_prices, original.ask_prices);
+    EXPECT_EQ(back.bid_sizes, original.bid_sizes);
+    EXPECT_EQ(back.ask_sizes, original.ask_sizes);
+
+    MarketTick bbo_only;
+    to_market_tick(to_compact(original), depth, bbo_only);
+    expect_bbo(bbo_only, original);
+    EXPECT_EQ(bbo_only.depth_levels, 0u);
+
+    // Out-of-range book: BBO still carried, depth not stored
+    const CompactTick far = to_compact(original, depth, DepthTable::MAX_BOOKS);
+    EXPECT_FALSE(far.has_depth());
+}
+
+// Test the NIC ring carries compact ticks and expands them with the
+// book's depth on the consumer side
+TEST(CompactTickTest, NicQueuesCompactTicks) {
+    KernelBypassNIC nic;
+    nic.start();
+
+    std::vector<MarketTick> burst;
+    for (uint32_t i = 0; i < 100; ++i) burst.push_back(full_tick(i % 3, 1000 + i));
+    EXPECT_EQ(nic.inject_batch(burst.data(), burst.size()), burst.size());
+    EXPECT_TRUE(nic.inject_market_data(full_tick(1000, 5000)));    // beyond the depth table
+    EXPECT_EQ(nic.get_stats().bytes_received, 101 * sizeof(CompactTick));
+
+    const CompactTick* head = nic.peek_next_tick();
+    ASSERT_NE(head, nullptr);
+    EXPECT_EQ(head->timestamp_ns, 1000);
+
+    MarketTick out;
+    for (uint32_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(nic.get_next_tick(out));
+        expect_bbo(out, burst[i]);
+        EXPECT_EQ(out.depth_levels, 10u);
+        EXPECT_EQ(out.bid_prices, burst[i].bid_prices);
+    }
+
+    CompactTick wire;
+    ASSERT_TRUE(nic.get_next_tick(wire));
+    EXPECT_EQ(wire.asset_id, 1000u);
+    EXPECT_FALSE(wire.has_depth());
+    EXPECT_FALSE(nic.get_next_tick(wire));
+    nic.stop();
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "backtesting_engine.hpp"
+#include "csv_parser.hpp"
+
+namespace {
+
+using hft::backtest::HistoricalEvent;
+namespace csv = hft::backtest::csv;
+
+std::vector<HistoricalEvent> parse_text(const std::string& text) {
+    std::vector<HistoricalEvent> out;
+    csv::parse_range<HistoricalEvent>(text.data(), text.data() + text.size(),
+        [&](const HistoricalEvent& e) { out.push_back(e); });
+    return out;
+}
+
+class CsvParserTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    void write_file(const std::string& text) {
+        std::ofstream out(path_, std::ios::binary);
+        out << text;
+    }
+
+    std::string path_ = "/tmp/test_csv_parser.csv";
+};
+
+}
+
+// Test the vectorized mask matches a byte-by-byte scan
+TEST(CsvMaskTest, StructuralMask) {
+    std::string block(64, 'x');
+    block[0] = ',';
+    block[17] = '\n';
+    block[31] = ',';
+    block[32] = ',';
+    block[63] = '\n';
+    const uint64_t expected = (1ULL << 0) | (1ULL << 17) | (1ULL << 31) | (1ULL << 32) | (1ULL << 63);
+    EXPECT_EQ(csv::structural_mask(block.data()), expected);
+    EXPECT_EQ(csv::structural_mask_partial(block.data(), 64), expected);
+}
+
+// Test the fast number paths agree with the standard library
+TEST(CsvNumberTest, ParsesLikeStdlib) {
+    const char* decimals[] = {"99.96", "0.01", "100", "12345.678901", "-3.5", "1e-3",
+                              "0.30000000000000004", "7.", " 42.25"};
+    for (const char* s : decimals) {
+        double v = 0.0;
+        ASSERT_TRUE(csv::parse_double(s, s + std::strlen(s), v)) << s;
+        EXPECT_EQ(v, std::stod(s)) << s;
+    }
+
+    int64_t i = 0;
+    const std::string ts = "1765351552883016";
+    ASSERT_TRUE(csv::parse_int(ts.data(), ts.data() + ts.size(), i));
+    EXPECT_EQ(i, 1765351552883016LL);
+
+    const std::string bad = "abc";
+    EXPECT_FALSE(csv::parse_int(bad.data(), bad.data() + bad.size(), i));
+    double d;
+    EXPECT_FALSE(csv::parse_double(bad.data(), bad.data() + bad.size(), d));
+}
+
+// Test rows decode to the same events as the original field rules
+TEST(CsvRowTest, FieldSemantics) {
+    const auto events = parse_text(
+        "1000,trade,S,99.96,25,1,4\n"
+        "2000,cancel,B,,,1,1\n"          // Defaults for empty price/size
+        "bogus,add,B,1,1\n"              // Rejected
+        "\n"
+        "3000,add,,50.5,7\r\n"           // CRLF, empty side
+        "4000,trade,B,10,3");            // No trailing newline
+
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events[0].timestamp_ns, 1000000);
+    EXPECT_EQ(events[0].trade_side, hft::Side::SELL);
+    EXPECT_EQ(events[0].trade_volume, 25u);
+    EXPECT_DOUBLE_EQ(events[0].bid_price, 99.96 - 99.96 * 0.0002 / 2.0);
+    EXPECT_DOUBLE_EQ(events[0].ask_price, 99.96 + 99.96 * 0.0002 / 2.0);
+    EXPECT_EQ(events[0].depth_levels, 1);
+
+    EXPECT_DOUBLE_EQ(events[1].bid_price, 100.0 - 100.0 * 0.0002 / 2.0);
+    EXPECT_EQ(events[1].bid_size, 100u);
+    EXPECT_EQ(events[1].trade_volume, 0u);
+
+    EXPECT_EQ(events[2].trade_side, hft::Side::BUY);
+    EXPECT_EQ(events[2].ask_size, 7u);
+    EXPECT_EQ(events[3].timestamp_ns, 4000000);
+    EXPECT_EQ(events[3].trade_volume, 3u);
+
+    EXPECT_TRUE(parse_text("ts_us,event_type,side,price,size\n").empty());
+}
+
+// Test multi-threaded chunked parsing yields the single-threaded result
+TEST_F(CsvParserTest, ChunkedMatchesSingleThread) {
+    std::ostringstream text;
+    text << "ts_us,event_type,side,price,size,order_id,level\n";
+    const size_t rows = 120000;  // Several MB -> multiple chunks
+    for (size_t i = 0; i < rows; ++i) {
+        text << (1765351552883016LL + static_cast<int64_t>(i)) << ','
+             << ((i % 3) ? "add" : "trade") << ','
+             << ((i % 2) ? 'S' : 'B') << ','
+             << (99.0 + (i % 200) * 0.01) << ','
+             << (i % 50) << ",123456789,3,padding_to_cross_chunk_boundaries\n";
+    }
+    write_file(text.str());
+
+    std::vector<HistoricalEvent> single;
+    std::vector<HistoricalEvent> chunked;
+    auto stats1 = csv::parse_file<HistoricalEvent>(path_, [&](const HistoricalEvent& e) { single.push_back(e); }, 1);
+    auto stats4 = csv::parse_file<HistoricalEvent>(path_, [&](const HistoricalEvent& e) { chunked.push_back(e); }, 4);
+
+    EXPECT_EQ(stats1.events, rows);
+    EXPECT_EQ(stats4.events, rows);
+    EXPECT_EQ(stats4.lines, stats1.lines);
+    ASSERT_EQ(chunked.size(), single.size());
+    for (size_t i = 0; i < rows; ++i) {
+        ASSERT_EQ(chunked[i].timestamp_ns, single[i].timestamp_ns) << i;
+        ASSERT_EQ(chunked[i].bid_price, single[i].bid_price) << i;
+        ASSERT_EQ(chunked[i].trade_volume, single[i].trade_volume) << i;
+    }
+
+    EXPECT_THROW(csv::parse_file<HistoricalEvent>("/nonexistent/ticks.csv", [](const HistoricalEvent&) {}),
+                 std::runtime_error);
+}
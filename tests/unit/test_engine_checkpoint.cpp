@@ -0,0 +1,257 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "backtesting_engine.hpp"
+#include "engine_checkpoint.hpp"
+#include "hawkes_engine.hpp"
+#include "queue_fill_simulator.hpp"
+#include "synthetic_ticks.hpp"
+
+using namespace hft;
+using namespace hft::backtest;
+
+namespace {
+
+class EngineCheckpointTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        for (const auto& p : paths_) std::filesystem::remove(p);
+    }
+
+    std::string path(const std::string& name) {
+        paths_.push_back("/tmp/test_engine_checkpoint_" + name);
+        return paths_.back();
+    }
+
+    std::vector<std::string> paths_;
+};
+
+MarketTick book(double bid, double ask, uint64_t bid_size, uint64_t ask_size) {
+    MarketTick t;
+    t.bid_price = bid;
+    t.ask_price = ask;
+    t.mid_price = (bid + ask) / 2.0;
+    t.bid_size = bid_size;
+    t.ask_size = ask_size;
+    t.depth_levels = 1;
+    return t;
+}
+
+}
+
+// Test sections round trip, and a missing section, a layout version change
+// or a corrupted payload are rejected
+TEST_F(EngineCheckpointTest, SectionsRoundTrip) {
+    const std::string file = path("format.ckpt");
+    CheckpointWriter writer(123456789, 42);
+    auto& a = writer.section("alpha", 3);
+    a.put<int64_t>(-7);
+    a.put_vector(std::vector<double>{1.5, 2.5, 4.0});
+    a.put_string("state");
+    writer.section("beta", 1).put<uint32_t>(9);
+    EXPECT_THROW(writer.section("alpha", 1), std::invalid_argument);
+    EXPECT_EQ(writer.write(file) % checkpoint::SECTION_ALIGN, 0u);
+    EXPECT_FALSE(std::filesystem::exists(file + ".tmp"));
+
+    {
+        CheckpointReader reader(file);
+        EXPECT_EQ(reader.event_time_ns(), 123456789);
+        EXPECT_EQ(reader.sequence(), 42u);
+        EXPECT_EQ(reader.section_count(), 2u);
+        EXPECT_EQ(reader.section_version("alpha"), 3u);
+        EXPECT_FALSE(reader.has("gamma"));
+
+        auto in = reader.section("alpha", 3);
+        EXPECT_EQ(in.get<int64_t>(), -7);
+        std::vector<double> v;
+        in.get_vector(v);
+        EXPECT_EQ(v, (std::vector<double>{1.5, 2.5, 4.0}));
+        EXPECT_EQ(in.get_string(), "state");
+        EXPECT_TRUE(in.at_end());
+        EXPECT_THROW(in.get<uint8_t>(), std::runtime_error);
+
+        EXPECT_EQ(reader.section("beta", 1).get<uint32_t>(), 9u);
+        EXPECT_THROW(reader.section("alpha", 4), std::runtime_error);
+        EXPECT_THROW(reader.section("gamma", 1), std::runtime_error);
+    }
+
+    // Flip a payload byte of the first section
+    const size_t first = checkpoint::align_up(sizeof(checkpoint::FileHeader) + 2 * sizeof(checkpoint::SectionEntry));
+    {
+        std::fstream f(file, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(static_cast<std::streamoff>(first));
+        f.put('\x55');
+    }
+    CheckpointReader corrupted(file);
+    EXPECT_THROW(corrupted.section("alpha", 3), std::runtime_error);
+    EXPECT_EQ(corrupted.section("beta", 1).get<uint32_t>(), 9u);
+
+    {
+        std::ofstream f(file, std::ios::trunc);
+        f << "not a checkpoint, just some text that is long enough for a header";
+    }
+    EXPECT_THROW(CheckpointReader{file}, std::runtime_error);
+}
+
+// Test a reset writer refills the same sections in place and drops the
+// ones a new layout leaves out
+TEST_F(EngineCheckpointTest, ResetWriterReusesSections) {
+    const std::string file = path("reset.ckpt");
+    CheckpointWriter writer(1, 1);
+    writer.section("alpha", 1).put<int64_t>(1);
+    writer.section("beta", 1).put<int64_t>(2);
+    writer.section("gamma", 1).put<int64_t>(3);
+
+    writer.reset(2, 2);
+    auto& alpha = writer.section("alpha", 2);
+    EXPECT_EQ(alpha.size(), 0u);
+    alpha.put<int64_t>(10);
+    writer.section("gamma", 1).put<int64_t>(30);
+    EXPECT_THROW(writer.section("alpha", 2), std::invalid_argument);
+    writer.write(file);
+
+    CheckpointReader reader(file);
+    EXPECT_EQ(reader.sequence(), 2u);
+    EXPECT_EQ(reader.section_count(), 2u);
+    EXPECT_FALSE(reader.has("beta"));
+    EXPECT_EQ(reader.section("alpha", 2).get<int64_t>(), 10);
+    EXPECT_EQ(reader.section("gamma", 1).get<int64_t>(), 30);
+}
+
+// Test the background writer publishes each submitted snapshot from the
+// buffer reserve() sized, and reports a failed write without throwing
+TEST_F(EngineCheckpointTest, BackgroundWriterPublishesSnapshots) {
+    const std::string file = path("background.ckpt");
+    BackgroundCheckpointWriter checkpoints(file);
+    uint64_t value = 1;
+    const uint8_t* storage = nullptr;
+    auto fill = [&](CheckpointWriter& writer) {
+        auto& s = writer.section("value", 1);
+        s.put(value);
+        storage = s.bytes().data();
+    };
+    checkpoints.reserve(fill);
+    EXPECT_FALSE(std::filesystem::exists(file));
+    const uint8_t* reserved = storage;
+
+    for (value = 2; value <= 3; ++value) {
+        ASSERT_TRUE(checkpoints.submit(static_cast<int64_t>(value) * 100, value, fill));
+        checkpoints.flush();
+        EXPECT_EQ(storage, reserved);                       // Refilled in place
+        CheckpointReader reader(file);
+        EXPECT_EQ(reader.sequence(), value);
+        EXPECT_EQ(reader.section("value", 1).get<uint64_t>(), value);
+    }
+    EXPECT_EQ(checkpoints.written(), 2u);
+    EXPECT_EQ(checkpoints.failures(), 0u);
+
+    std::vector<std::string> errors;
+    BackgroundCheckpointWriter unwritable("/nonexistent/test_engine_checkpoint.ckpt",
+                                          [&](const std::exception& e) { errors.push_back(e.what()); });
+    ASSERT_TRUE(unwritable.submit(0, 1, fill));
+    unwritable.flush();
+    EXPECT_EQ(unwritable.failures(), 1u);
+    EXPECT_EQ(unwritable.written(), 0u);
+    EXPECT_EQ(errors.size(), 1u);
+}
+
+// Test restored components continue exactly as the originals do
+TEST_F(EngineCheckpointTest, ComponentsContinueIdentically) {
+    auto at = [](int64_t ns) { return Timestamp(std::chrono::nanoseconds(ns)); };
+
+    HawkesIntensityEngine hawkes(5.0, 6.0, 0.5, 0.25, 2.0);
+    for (int i = 0; i < 10; ++i) {
+        hawkes.update(TradingEvent(at(1000000000LL + i * 250000000LL), i % 3 ? Side::BUY : Side::SELL, 0));
+    }
+
+    QueueFillSimulator queue(0.01);
+    queue.on_market(book(100.00, 100.02, 500, 400), 0.0, 1, [](const QueueFillSimulator::Fill&) {});
+    ASSERT_TRUE(queue.add_order(1, Side::BUY, 100.00, 100, 2));
+    ASSERT_TRUE(queue.add_order(2, Side::SELL, 100.02, 50, 3));
+    queue.on_market(book(100.00, 100.02, 700, 400), 0.0, 4, [](const QueueFillSimulator::Fill&) {});
+
+    const std::string file = path("components.ckpt");
+    {
+        CheckpointWriter writer;
+        hawkes.save_state(writer.section("hawkes", 1));
+        queue.save_state(writer.section("queue", 1));
+        writer.write(file);
+    }
+
+    HawkesIntensityEngine hawkes2;
+    QueueFillSimulator queue2(0.01);
+    {
+        CheckpointReader reader(file);
+        auto h = reader.section("hawkes", 1);
+        hawkes2.restore_state(h);
+        auto q = reader.section("queue", 1);
+        queue2.restore_state(q);
+        EXPECT_TRUE(q.at_end());
+    }
+
+    EXPECT_EQ(hawkes2.get_buy_intensity(), hawkes.get_buy_intensity());
+    const TradingEvent next(at(4000000000LL), Side::SELL, 0);
+    hawkes.update(next);
+    hawkes2.update(next);
+    EXPECT_EQ(hawkes2.get_buy_intensity(), hawkes.get_buy_intensity());
+    EXPECT_EQ(hawkes2.get_sell_intensity(), hawkes.get_sell_intensity());
+
+    EXPECT_EQ(queue2.resting_orders(), 2u);
+    EXPECT_EQ(queue2.queue_ahead(1), queue.queue_ahead(1));
+    EXPECT_EQ(queue2.queue_ahead(2), queue.queue_ahead(2));
+    EXPECT_EQ(queue2.last_market().bid_size, 700u);
+
+    // A sell of 600 at the bid: 500 ahead of us, then 100 of ours
+    MarketTick trade = book(100.00, 100.02, 100, 400);
+    trade.trade_volume = 600;
+    trade.trade_side = Side::SELL;
+    std::vector<uint64_t> fills, fills2;
+    queue.on_market(trade, 0.0, 5, [&](const QueueFillSimulator::Fill& f) { fills.push_back(f.quantity); });
+    queue2.on_market(trade, 0.0, 5, [&](const QueueFillSimulator::Fill& f) { fills2.push_back(f.quantity); });
+    EXPECT_EQ(fills, std::vector<uint64_t>{100});
+    EXPECT_EQ(fills2, fills);
+    EXPECT_EQ(queue2.resting_orders(), queue.resting_orders());
+}
+
+// Test a backtest resumed from a mid-run checkpoint ends exactly where the
+// uninterrupted run does, and a checkpoint is refused against other data
+TEST_F(EngineCheckpointTest, ResumedBacktestMatchesFullRun) {
+    const std::string csv = path("ticks.csv");
+    test_data::write_trade_csv(csv, 600);
+    const std::string prefix = "/tmp/test_engine_checkpoint_run";
+    path("run_200.ckpt");
+    path("run_400.ckpt");
+    path("run_600.ckpt");
+
+    BacktestConfig config;
+    config.hawkes.beta = 1.0;
+    config.verbose = false;
+    config.enable_replay_logging = false;
+    config.checkpoint_interval_events = 200;
+    config.checkpoint_prefix = prefix;
+
+    BacktestingEngine full(config);
+    ASSERT_TRUE(full.load_historical_data(csv));
+    const auto expected = full.run_backtest();
+    ASSERT_TRUE(std::filesystem::exists(prefix + "_200.ckpt"));
+    ASSERT_TRUE(std::filesystem::exists(prefix + "_400.ckpt"));
+    EXPECT_GT(expected.total_trades, 0u);
+
+    config.checkpoint_interval_events = 0;
+    BacktestingEngine resumed(config);
+    ASSERT_TRUE(resumed.load_historical_data(csv));
+    const auto metrics = resumed.resume_backtest(prefix + "_200.ckpt");
+
+    EXPECT_EQ(metrics.total_trades, expected.total_trades);
+    EXPECT_EQ(metrics.total_pnl, expected.total_pnl);
+    EXPECT_EQ(metrics.sharpe_ratio, expected.sharpe_ratio);
+    EXPECT_EQ(metrics.max_drawdown, expected.max_drawdown);
+    EXPECT_EQ(metrics.equity_curve, expected.equity_curve);
+    EXPECT_EQ(resumed.get_current_position(), full.get_current_position());
+    EXPECT_EQ(resumed.get_filled_orders_count(), full.get_filled_orders_count());
+
+    BacktestingEngine other(config);
+    ASSERT_TRUE(other.add_csv_source(csv, 1));
+    EXPECT_THROW(other.resume_backtest(prefix + "_200.ckpt"), std::runtime_error);
+}
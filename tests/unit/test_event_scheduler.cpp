@@ -4,6 +4,11 @@
 #include <chrono>
 #include <atomic>
 #include <functional>
+#include <string>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <vector>
 
 #include "event_scheduler.hpp"
 #include "common_types.hpp"
@@ -265,6 +270,310 @@ TEST_F(EventSchedulerTest, EdgeCases) {
     EXPECT_EQ(executed.load(), 1);
 }
 
+// Test cancel and update_priority act on the exact entry and stale
+// handles are rejected
+TEST_F(EventSchedulerTest, PriorityEventQueueHandles) {
+    hft::scheduler::PriorityEventQueue<int, 8> queue;
+    using Queue = decltype(queue);
+
+    const auto a = queue.emplace(5, 1);
+    const auto b = queue.emplace(5, 2);
+    const auto c = queue.emplace(7, 3);
+    const auto d = queue.emplace(9, 4);
+    ASSERT_NE(a, Queue::INVALID_HANDLE);
+
+    EXPECT_TRUE(queue.cancel(b));
+    EXPECT_FALSE(queue.cancel(b));
+    EXPECT_FALSE(queue.contains(b));
+    EXPECT_EQ(queue.size(), 3u);
+
+    EXPECT_TRUE(queue.update_priority(d, 1));   // Decrease key
+    EXPECT_TRUE(queue.update_priority(a, 8));   // Increase key
+    EXPECT_EQ(queue.top_priority(), 1u);
+
+    // b's slot is reused under a new generation
+    const auto e = queue.emplace(7, 5);
+    EXPECT_NE(e, b);
+    EXPECT_FALSE(queue.cancel(b));
+
+    std::vector<int> order;
+    int value;
+    while (queue.pop(value)) order.push_back(value);
+    EXPECT_EQ(order, (std::vector<int>{4, 3, 5, 1}));  // Ties pop in push order
+    EXPECT_FALSE(queue.update_priority(c, 0));
+    EXPECT_EQ(queue.top_priority(), UINT64_MAX);
+}
+
+// Test events are built in place and destroyed on pop, cancel and clear
+TEST_F(EventSchedulerTest, PriorityEventQueueInPlace) {
+    auto tracker = std::make_shared<int>(0);
+    {
+        hft::scheduler::PriorityEventQueue<std::shared_ptr<int>, 4> queue;
+        const auto h = queue.emplace(2, tracker);
+        queue.emplace(1, tracker);
+        queue.emplace(3, tracker);
+        EXPECT_EQ(tracker.use_count(), 4);
+
+        std::shared_ptr<int> out;
+        EXPECT_TRUE(queue.pop(out));
+        out.reset();
+        EXPECT_TRUE(queue.cancel(h));
+        EXPECT_EQ(tracker.use_count(), 2);
+
+        queue.clear();
+        EXPECT_EQ(tracker.use_count(), 1);
+        queue.emplace(1, tracker);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+
+    hft::scheduler::PriorityEventQueue<std::unique_ptr<int>, 4> moves;
+    moves.emplace(1, std::make_unique<int>(42));
+    std::unique_ptr<int> p;
+    ASSERT_TRUE(moves.pop(p));
+    EXPECT_EQ(*p, 42);
+}
+
+// Test heavy cancel / reprioritise traffic against a reference ordering
+TEST_F(EventSchedulerTest, PriorityEventQueueMatchesReference) {
+    using Queue = hft::scheduler::PriorityEventQueue<uint32_t, 512>;
+    Queue queue;
+    std::map<std::pair<uint64_t, uint64_t>, uint32_t> reference;  // (priority, seq) -> id
+    std::vector<std::pair<Queue::Handle, std::pair<uint64_t, uint64_t>>> live;
+    uint64_t seq = 0;
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+
+    for (uint32_t step = 0; step < 50000; ++step) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        const uint64_t op = x % 10;
+        const uint64_t priority = (x >> 8) % 64;
+
+        if (op < 4 && queue.size() < queue.capacity()) {
+            const auto h = queue.emplace(priority, step);
+            ASSERT_NE(h, Queue::INVALID_HANDLE);
+            reference[{priority, seq}] = step;
+            live.push_back({h, {priority, seq++}});
+        } else if (op < 6 && !live.empty()) {
+            const size_t i = (x >> 20) % live.size();
+            ASSERT_TRUE(queue.cancel(live[i].first));
+            reference.erase(live[i].second);
+            live[i] = live.back();
+            live.pop_back();
+        } else if (op < 8 && !live.empty()) {
+            const size_t i = (x >> 20) % live.size();
+            ASSERT_TRUE(queue.update_priority(live[i].first, priority));
+            const uint32_t id = reference[live[i].second];
+            reference.erase(live[i].second);
+            live[i].second = {priority, seq++};
+            reference[live[i].second] = id;
+        } else if (!reference.empty()) {
+            uint32_t value = 0;
+            ASSERT_TRUE(queue.pop(value));
+            ASSERT_EQ(value, reference.begin()->second);
+            const auto key = reference.begin()->first;
+            reference.erase(reference.begin());
+            for (size_t i = 0; i < live.size(); ++i) {
+                if (live[i].second == key) {
+                    EXPECT_FALSE(queue.contains(live[i].first));
+                    live[i] = live.back();
+                    live.pop_back();
+                    break;
+                }
+            }
+        }
+        ASSERT_EQ(queue.size(), reference.size());
+    }
+}
+
+// Test loop events are cancellable by handle and reach the handler in
+// priority order
+TEST_F(EventSchedulerTest, DeterministicEventLoopEvents) {
+    hft::scheduler::SimulatedEventLoop loop;
+    std::vector<double> seen;
+    loop.set_event_handler([&](const hft::MarketTick& tick) { seen.push_back(tick.bid_price); });
+
+    hft::MarketTick tick;
+    tick.bid_price = 1.0;
+    const auto low = loop.add_event(tick, 9);
+    tick.bid_price = 2.0;
+    const auto mid = loop.add_event(tick, 5);
+    tick.bid_price = 3.0;
+    loop.add_event(tick, 7);
+
+    EXPECT_TRUE(loop.cancel_event(mid));
+    EXPECT_TRUE(loop.reprioritize_event(low, 1));
+    loop.run();
+
+    EXPECT_EQ(seen, (std::vector<double>{1.0, 3.0}));
+    EXPECT_FALSE(loop.cancel_event(low));
+}
+
+// Test timers at every distance fire on exactly their tick, including
+// delays past the top wheel level
+TEST_F(EventSchedulerTest, TimingWheelCascadesExactly) {
+    hft::scheduler::TimingWheelScheduler scheduler(4, std::chrono::nanoseconds(1000));  // 4 slots/level
+    ASSERT_EQ(scheduler.slots_per_level(), 4u);
+
+    const uint64_t delays[] = {0, 1, 3, 4, 5, 15, 16, 17, 63, 64, 255, 256, 257, 1000, 5000};
+    std::vector<uint64_t> fired_at(std::size(delays), 0);
+    for (size_t i = 0; i < std::size(delays); ++i) {
+        scheduler.schedule_after(std::chrono::microseconds(delays[i]), [&, i] {
+            fired_at[i] = scheduler.current_tick();
+        });
+    }
+
+    for (int t = 0; t <= 5001; ++t) {
+        scheduler.tick();
+    }
+
+    // Callbacks see the tick they fire on
+    for (size_t i = 0; i < std::size(delays); ++i) {
+        EXPECT_EQ(fired_at[i], delays[i]) << "delay " << delays[i];
+    }
+    EXPECT_EQ(scheduler.get_pending_count(), 0u);
+
+    // Timers armed at arbitrary points in the rotation
+    uint64_t x = 88172645463325252ULL;
+    size_t late = 0, fired = 0;
+    for (int t = 0; t < 20000; ++t) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        const uint64_t delay = x % 700;
+        const uint64_t due = scheduler.current_tick() + delay;
+        scheduler.schedule_after(std::chrono::microseconds(delay), [&, due] {
+            ++fired;
+            if (scheduler.current_tick() != due) ++late;
+        });
+        scheduler.tick();
+    }
+    for (int t = 0; t < 1000; ++t) scheduler.tick();
+    EXPECT_EQ(fired, 20000u);
+    EXPECT_EQ(late, 0u);
+}
+
+// Test cancel/reschedule through handles, including stale handles
+TEST_F(EventSchedulerTest, TimingWheelCancelAndReschedule) {
+    hft::scheduler::TimingWheelScheduler scheduler(64, std::chrono::nanoseconds(1000));
+
+    int a = 0, b = 0, c = 0;
+    auto ha = scheduler.schedule_after(std::chrono::microseconds(5), [&] { ++a; });
+    auto hb = scheduler.schedule_after(std::chrono::microseconds(5), [&] { ++b; });
+    auto hc = scheduler.schedule_after(std::chrono::microseconds(500), [&] { ++c; });
+    EXPECT_EQ(scheduler.get_pending_count(), 3u);
+
+    EXPECT_TRUE(scheduler.cancel(hb));
+    EXPECT_FALSE(scheduler.cancel(hb));                 // Already cancelled
+    EXPECT_TRUE(scheduler.reschedule(hc, std::chrono::microseconds(2)));
+    EXPECT_EQ(scheduler.get_pending_count(), 2u);
+
+    for (int t = 0; t < 10; ++t) scheduler.tick();
+    EXPECT_EQ(a, 1);
+    EXPECT_EQ(b, 0);
+    EXPECT_EQ(c, 1);
+
+    // The freed node is reused; the old handle must not touch the new timer
+    auto hd = scheduler.schedule_after(std::chrono::microseconds(1), [&] { ++b; });
+    EXPECT_FALSE(scheduler.cancel(ha));
+    EXPECT_FALSE(scheduler.reschedule(hb, std::chrono::microseconds(1)));
+    EXPECT_NE(hd, hb);
+    for (int t = 0; t < 3; ++t) scheduler.tick();
+    EXPECT_EQ(b, 1);
+}
+
+// Test callbacks can arm and cancel timers while the wheel is firing
+TEST_F(EventSchedulerTest, TimingWheelReentrantCallbacks) {
+    hft::scheduler::TimingWheelScheduler scheduler(64, std::chrono::nanoseconds(1000), 4);
+
+    int heartbeats = 0;
+    int timeouts = 0;
+    uint64_t timeout = scheduler.schedule_after(std::chrono::microseconds(3), [&] { ++timeouts; });
+
+    std::function<void()> heartbeat = [&] {
+        ++heartbeats;
+        scheduler.reschedule(timeout, std::chrono::microseconds(3));
+        if (heartbeats < 5) {
+            scheduler.schedule_after(std::chrono::microseconds(1), heartbeat);
+        }
+    };
+    scheduler.schedule_after(std::chrono::microseconds(1), heartbeat);
+
+    // Fill past the initial pool so it has to grow
+    for (int i = 0; i < 2000; ++i) {
+        scheduler.schedule_after(std::chrono::microseconds(100), [] {});
+    }
+
+    for (int t = 0; t < 20; ++t) scheduler.tick();
+    EXPECT_EQ(heartbeats, 5);
+    EXPECT_EQ(timeouts, 1);     // Only after the heartbeats stopped
+    EXPECT_GE(scheduler.capacity(), 2002u);
+}
+
+// Test the inline callable stores, moves and destroys captures in place
+TEST_F(EventSchedulerTest, InlineFunctionLifetime) {
+    auto token = std::make_shared<int>(7);
+    {
+        hft::InlineFunction<int(int), 32> f = [token](int x) { return *token + x; };
+        EXPECT_EQ(token.use_count(), 2);
+        EXPECT_EQ(f(1), 8);
+
+        hft::InlineFunction<int(int), 32> g = std::move(f);
+        EXPECT_FALSE(static_cast<bool>(f));
+        EXPECT_EQ(g(2), 9);
+        EXPECT_EQ(token.use_count(), 2);
+    }
+    EXPECT_EQ(token.use_count(), 1);
+}
+
+// Test simulated time jumps straight across idle gaps and fires each timer
+// with the clock at its exact deadline
+TEST_F(EventSchedulerTest, SimulatedWheelFiresAtDeadlines) {
+    const hft::Timestamp start(std::chrono::seconds(1000));
+    hft::scheduler::SimulatedTimingWheel wheel(
+        64, std::chrono::nanoseconds(1), 16, hft::SimulatedClock(start));
+
+    const int64_t offsets_ns[] = {3600000000000LL, 7, 250, 90000000000LL, 250};
+    std::vector<int64_t> fired;
+    for (int64_t off : offsets_ns) {
+        wheel.schedule_at(start + std::chrono::nanoseconds(off), [&] {
+            fired.push_back(hft::to_nanos(wheel.now()) - hft::to_nanos(start));
+        });
+    }
+
+    wheel.process_until(start + std::chrono::seconds(100));
+    EXPECT_EQ(fired, (std::vector<int64_t>{7, 250, 250, 90000000000LL}));
+    EXPECT_EQ(hft::to_nanos(wheel.now()) - hft::to_nanos(start), 100000000000LL);
+
+    // A zero-delay timer armed at the target fires on the next call
+    bool zero_fired = false;
+    wheel.schedule_after(std::chrono::nanoseconds(0), [&] { zero_fired = true; });
+    EXPECT_FALSE(zero_fired);
+    wheel.process_until(wheel.now());
+    EXPECT_TRUE(zero_fired);
+
+    wheel.run_until_idle();
+    ASSERT_EQ(fired.size(), 5u);
+    EXPECT_EQ(fired.back(), 3600000000000LL);
+    EXPECT_EQ(wheel.get_pending_count(), 0u);
+}
+
+// Test the simulated loop runs chained timers to completion and returns
+TEST_F(EventSchedulerTest, SimulatedEventLoopRunsUntilIdle) {
+    hft::scheduler::SimulatedEventLoop loop;
+    int remaining = 1000;
+    std::function<void()> step = [&] {
+        if (--remaining > 0) {
+            loop.schedule_after(std::chrono::milliseconds(10), [&] { step(); });
+        }
+    };
+    loop.schedule_after(std::chrono::milliseconds(10), [&] { step(); });
+
+    const auto wall_start = std::chrono::steady_clock::now();
+    loop.run();
+    const auto wall = std::chrono::steady_clock::now() - wall_start;
+
+    EXPECT_EQ(remaining, 0);
+    EXPECT_EQ(hft::to_nanos(loop.now()), 10000000000LL);  // 1000 x 10ms simulated
+    EXPECT_LT(wall, std::chrono::seconds(1));
+}
+
 int main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
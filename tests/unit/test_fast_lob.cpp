@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <limits>
+#include "fast_lob.hpp"
+
+// Test fixture for PriceIndexedOrderBook tests
+class PriceIndexedOrderBookTest : public ::testing::Test {
+protected:
+    hft::PriceIndexedOrderBook<1024> book_{100.0, 0.01};
+};
+
+// Test empty book
+TEST_F(PriceIndexedOrderBookTest, EmptyBook) {
+    EXPECT_DOUBLE_EQ(book_.get_best_bid(), 0.0);
+    EXPECT_DOUBLE_EQ(book_.get_best_ask(), 0.0);
+    EXPECT_EQ(book_.best_bid_tick(), hft::PriceIndexedOrderBook<1024>::NO_LEVEL);
+    EXPECT_EQ(book_.best_ask_tick(), hft::PriceIndexedOrderBook<1024>::NO_LEVEL);
+    EXPECT_DOUBLE_EQ(book_.calculate_ofi(10), 0.0);
+}
+
+// Test tick <-> price mapping around the reference price
+TEST_F(PriceIndexedOrderBookTest, TickMapping) {
+    const int32_t ref_tick = book_.price_to_tick(100.0);
+    EXPECT_EQ(ref_tick, 512);
+    EXPECT_EQ(book_.price_to_tick(100.01), ref_tick + 1);
+    EXPECT_EQ(book_.price_to_tick(99.99), ref_tick - 1);
+    EXPECT_NEAR(book_.tick_to_price(ref_tick + 5), 100.05, 1e-9);
+}
+
+// Test best bid/ask tracking on add
+TEST_F(PriceIndexedOrderBookTest, BestPricesOnAdd) {
+    EXPECT_TRUE(book_.update_bid(99.98, 100));
+    EXPECT_TRUE(book_.update_bid(99.99, 200));
+    EXPECT_TRUE(book_.update_bid(99.95, 300));
+    EXPECT_TRUE(book_.update_ask(100.03, 150));
+    EXPECT_TRUE(book_.update_ask(100.01, 250));
+
+    EXPECT_NEAR(book_.get_best_bid(), 99.99, 1e-9);
+    EXPECT_NEAR(book_.get_best_ask(), 100.01, 1e-9);
+    EXPECT_DOUBLE_EQ(book_.best_bid_quantity(), 200.0);
+    EXPECT_DOUBLE_EQ(book_.best_ask_quantity(), 250.0);
+    EXPECT_DOUBLE_EQ(book_.bid_quantity_at(99.95), 300.0);
+    EXPECT_DOUBLE_EQ(book_.ask_quantity_at(100.02), 0.0);
+}
+
+// Test that removing the best level falls back to the next occupied one
+TEST_F(PriceIndexedOrderBookTest, CancelBestFindsNextLevel) {
+    book_.update_bid(99.99, 100);
+    book_.update_bid(99.20, 100);   // Several 64-tick words below
+    book_.update_ask(100.01, 100);
+    book_.update_ask(100.90, 100);
+
+    book_.update_bid(99.99, 0);
+    book_.update_ask(100.01, 0);
+
+    EXPECT_NEAR(book_.get_best_bid(), 99.20, 1e-9);
+    EXPECT_NEAR(book_.get_best_ask(), 100.90, 1e-9);
+
+    book_.update_bid(99.20, 0);
+    book_.update_ask(100.90, 0);
+    EXPECT_DOUBLE_EQ(book_.get_best_bid(), 0.0);
+    EXPECT_DOUBLE_EQ(book_.get_best_ask(), 0.0);
+}
+
+// Test that removing a non-best level leaves BBO untouched
+TEST_F(PriceIndexedOrderBookTest, CancelNonBestLevel) {
+    book_.update_bid(99.99, 100);
+    book_.update_bid(99.98, 100);
+    book_.update_bid(99.98, 0);
+    book_.update_bid(99.50, 0);     // Never existed
+
+    EXPECT_NEAR(book_.get_best_bid(), 99.99, 1e-9);
+    EXPECT_EQ(book_.next_bid_tick(book_.best_bid_tick()),
+              hft::PriceIndexedOrderBook<1024>::NO_LEVEL);
+}
+
+// Test walking the book level by level
+TEST_F(PriceIndexedOrderBookTest, NextLevelIteration) {
+    book_.update_ask(100.01, 1);
+    book_.update_ask(100.64, 2);    // Crosses a word boundary
+    book_.update_ask(102.00, 3);
+
+    int32_t tick = book_.best_ask_tick();
+    EXPECT_NEAR(book_.tick_to_price(tick), 100.01, 1e-9);
+    tick = book_.next_ask_tick(tick);
+    EXPECT_NEAR(book_.tick_to_price(tick), 100.64, 1e-9);
+    tick = book_.next_ask_tick(tick);
+    EXPECT_NEAR(book_.tick_to_price(tick), 102.00, 1e-9);
+    EXPECT_EQ(book_.next_ask_tick(tick), hft::PriceIndexedOrderBook<1024>::NO_LEVEL);
+}
+
+// Test window edges and out-of-range rejection
+TEST_F(PriceIndexedOrderBookTest, WindowBounds) {
+    EXPECT_TRUE(book_.update_bid_tick(0, 10));
+    EXPECT_TRUE(book_.update_ask_tick(1023, 10));
+    EXPECT_FALSE(book_.update_bid_tick(-1, 10));
+    EXPECT_FALSE(book_.update_ask_tick(1024, 10));
+    EXPECT_FALSE(book_.update_bid(90.0, 10));
+
+    EXPECT_EQ(book_.best_bid_tick(), 0);
+    EXPECT_EQ(book_.best_ask_tick(), 1023);
+    EXPECT_EQ(book_.next_bid_tick(0), hft::PriceIndexedOrderBook<1024>::NO_LEVEL);
+    EXPECT_EQ(book_.next_ask_tick(1023), hft::PriceIndexedOrderBook<1024>::NO_LEVEL);
+}
+
+// Test prices far off the window or not numbers map to rejected ticks
+// instead of overflowing the int32 cast
+TEST_F(PriceIndexedOrderBookTest, FarAndNonFinitePrices) {
+    const double far[] = {1e12, -1e12, 1e300, std::numeric_limits<double>::infinity(),
+                          -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()};
+    for (double price : far) {
+        EXPECT_FALSE(book_.update_bid(price, 10)) << price;
+        EXPECT_FALSE(book_.update_ask(price, 10)) << price;
+        EXPECT_EQ(book_.bid_quantity_at(price), 0.0) << price;
+    }
+    EXPECT_EQ(book_.price_to_tick(1e12), 1024);
+    EXPECT_EQ(book_.price_to_tick(-1e12), -1);
+    EXPECT_EQ(book_.best_bid_tick(), hft::PriceIndexedOrderBook<1024>::NO_LEVEL);
+    EXPECT_EQ(book_.best_ask_tick(), hft::PriceIndexedOrderBook<1024>::NO_LEVEL);
+
+    // Window edges still round to their ticks
+    EXPECT_EQ(book_.price_to_tick(book_.tick_to_price(0)), 0);
+    EXPECT_EQ(book_.price_to_tick(book_.tick_to_price(1023)), 1023);
+}
+
+// Test OFI over top occupied levels
+TEST_F(PriceIndexedOrderBookTest, OrderFlowImbalance) {
+    book_.update_bid(99.99, 300);
+    book_.update_bid(99.90, 100);
+    book_.update_ask(100.01, 100);
+    book_.update_ask(100.05, 100);
+
+    EXPECT_DOUBLE_EQ(book_.calculate_ofi(1), (300.0 - 100.0) / 400.0);
+    EXPECT_DOUBLE_EQ(book_.calculate_ofi(10), (400.0 - 200.0) / 600.0);
+}
+
+// Test recentering clears the book
+TEST_F(PriceIndexedOrderBookTest, Recenter) {
+    book_.update_bid(99.99, 100);
+    book_.recenter(200.0);
+
+    EXPECT_DOUBLE_EQ(book_.get_best_bid(), 0.0);
+    EXPECT_TRUE(book_.update_bid(199.99, 100));
+    EXPECT_NEAR(book_.get_best_bid(), 199.99, 1e-9);
+}
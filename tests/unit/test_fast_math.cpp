@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "fast_math.hpp"
+#include "simd_dispatch.hpp"
+
+namespace fm = hft::fast_math;
+
+namespace {
+
+std::vector<double> random_vector(size_t n, double lo, double hi, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> dist(lo, hi);
+    std::vector<double> v(n);
+    for (auto& x : v) x = dist(rng);
+    return v;
+}
+
+double rel_error(double actual, double expected) {
+    return std::fabs(actual - expected) / std::fabs(expected);
+}
+
+enum class Fn { EXP, LOG, TANH };
+
+double scalar(Fn f, double x) {
+    switch (f) {
+        case Fn::EXP: return fm::exp(x);
+        case Fn::LOG: return fm::log(x);
+        default:      return fm::tanh(x);
+    }
+}
+
+#if defined(HFT_FAST_MATH_X86)
+HFT_MATH_TARGET("avx2,fma") void lanes4(Fn f, const double* x, double* out) {
+    const __m256d v = _mm256_loadu_pd(x);
+    _mm256_storeu_pd(out, f == Fn::EXP ? fm::exp4(v) : f == Fn::LOG ? fm::log4(v) : fm::tanh4(v));
+}
+
+HFT_MATH_TARGET("avx512f") void lanes8(Fn f, const double* x, double* out) {
+    const __m512d v = _mm512_loadu_pd(x);
+    _mm512_storeu_pd(out, f == Fn::EXP ? fm::exp8(v) : f == Fn::LOG ? fm::log8(v) : fm::tanh8(v));
+}
+#endif
+
+}
+
+// Test the scalar kernels stay within a few ulp of libm over their domains
+TEST(FastMathTest, ScalarMatchesLibm) {
+    for (double x : random_vector(20000, -708.0, 709.0, 1)) {
+        EXPECT_LT(rel_error(fm::exp(x), std::exp(x)), 1e-15) << x;
+    }
+    // Inputs drawn directly: under -ffast-math log(exp(x)) folds to x
+    for (double v : random_vector(20000, 1e-3, 1e3, 2)) {
+        EXPECT_LT(rel_error(fm::log(v), std::log(v)), 1e-15) << v;
+    }
+    for (double v : random_vector(1000, 1e-300, 1e300, 8)) {
+        EXPECT_LT(rel_error(fm::log(v), std::log(v)), 1e-15) << v;
+    }
+    for (double x : random_vector(20000, -20.0, 20.0, 3)) {
+        if (x == 0.0) continue;
+        EXPECT_LT(rel_error(fm::tanh(x), std::tanh(x)), 1e-15) << x;
+    }
+    for (double x : random_vector(1000, 0.0, 1e6, 4)) {
+        EXPECT_EQ(fm::sqrt(x), std::sqrt(x));
+    }
+}
+
+// Test edge values: exact points, saturation and the log cold path
+TEST(FastMathTest, EdgeCases) {
+    EXPECT_EQ(fm::exp(0.0), 1.0);
+    EXPECT_EQ(fm::log(1.0), 0.0);
+    EXPECT_EQ(fm::tanh(0.0), 0.0);
+    EXPECT_EQ(fm::tanh(50.0), 1.0);
+    EXPECT_EQ(fm::tanh(-50.0), -1.0);
+
+    // exp saturates at the clamp instead of returning 0 or inf
+    EXPECT_GT(fm::exp(-1e6), 0.0);
+    EXPECT_LT(fm::exp(-1e6), 1e-300);
+    EXPECT_TRUE(std::isfinite(fm::exp(1e6)));
+    EXPECT_GT(fm::exp(1e6), 1e307);
+
+    // Subnormals take the std::log path; the build's -ffast-math rules out
+    // checking the zero/negative/inf results
+    EXPECT_NEAR(fm::log(DBL_MIN / 16.0), std::log(DBL_MIN / 16.0), 1e-12);
+    EXPECT_NEAR(fm::log(DBL_MAX), std::log(DBL_MAX), 1e-12);
+}
+
+// Test the 4- and 8-lane forms agree with the scalar forms on CPUs that
+// run them
+TEST(FastMathTest, VectorFormsMatchScalar) {
+#if defined(HFT_FAST_MATH_X86)
+    using hft::simd::IsaLevel;
+    const bool avx2 = hft::simd::isa_supported(IsaLevel::AVX2);
+    const bool avx512 = hft::simd::isa_supported(IsaLevel::AVX512);
+    if (!avx2 && !avx512) GTEST_SKIP() << "no AVX2 or AVX-512 on this CPU";
+
+    const struct { Fn f; std::vector<double> x; } cases[] = {
+        {Fn::EXP, random_vector(64, -708.0, 709.0, 5)},
+        {Fn::LOG, random_vector(64, 1e-300, 1e300, 6)},
+        {Fn::TANH, random_vector(64, -20.0, 20.0, 7)},
+    };
+    for (const auto& c : cases) {
+        for (size_t i = 0; i < 64; i += 8) {
+            double out4[8], out8[8];
+            if (avx2) {
+                lanes4(c.f, c.x.data() + i, out4);
+                lanes4(c.f, c.x.data() + i + 4, out4 + 4);
+            }
+            if (avx512) lanes8(c.f, c.x.data() + i, out8);
+            for (size_t j = 0; j < 8; ++j) {
+                const double expected = scalar(c.f, c.x[i + j]);
+                const double tolerance = 1e-15 * std::fmax(std::fabs(expected), 1.0);
+                if (avx2) {
+                    EXPECT_NEAR(out4[j], expected, tolerance) << c.x[i + j];
+                }
+                if (avx512) {
+                    EXPECT_NEAR(out8[j], expected, tolerance) << c.x[i + j];
+                }
+            }
+        }
+    }
+#else
+    GTEST_SKIP() << "no vector forms on this target";
+#endif
+}
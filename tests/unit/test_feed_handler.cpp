@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+#include "feed_handler.hpp"
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using hft::zerocopy::BinaryOrderBookUpdate;
+using hft::zerocopy::BinaryTradeMessage;
+using hft::zerocopy::BinaryQuoteMessage;
+using hft::zerocopy::MessageType;
+
+// Builds multi-message UDP payloads in wire format
+class PacketBuilder {
+public:
+    PacketBuilder& book(uint32_t seq, uint64_t order_id, uint8_t update_type,
+                        bool is_bid, double price, double qty, uint32_t symbol = 1) {
+        BinaryOrderBookUpdate msg{};
+        fill_header(msg.header, seq, MessageType::ORDER_BOOK_UPDATE, sizeof(msg));
+        msg.order_id = order_id;
+        msg.symbol_id = symbol;
+        msg.side = is_bid ? 0 : 1;
+        msg.update_type = update_type;
+        msg.price = price;
+        msg.quantity = qty;
+        return append(msg);
+    }
+
+    PacketBuilder& trade(uint32_t seq, double price, double qty, uint32_t symbol = 1) {
+        BinaryTradeMessage msg{};
+        fill_header(msg.header, seq, MessageType::TRADE, sizeof(msg));
+        msg.symbol_id = symbol;
+        msg.price = price;
+        msg.quantity = qty;
+        return append(msg);
+    }
+
+    PacketBuilder& quote(uint32_t seq, double bid, double ask, uint32_t symbol = 1) {
+        BinaryQuoteMessage msg{};
+        fill_header(msg.header, seq, MessageType::QUOTE, sizeof(msg));
+        msg.symbol_id = symbol;
+        msg.bid_price = bid;
+        msg.ask_price = ask;
+        return append(msg);
+    }
+
+    PacketBuilder& raw(uint32_t seq, uint16_t type, uint16_t length) {
+        hft::zerocopy::BinaryMessageHeader header{};
+        header.sequence_number = seq;
+        header.message_type = type;
+        header.message_length = length;
+        const size_t at = bytes_.size();
+        bytes_.resize(at + std::max<size_t>(length, sizeof(header)));
+        std::memcpy(bytes_.data() + at, &header, sizeof(header));
+        return *this;
+    }
+
+    const uint8_t* data() const { return bytes_.data(); }
+    size_t size() const { return bytes_.size(); }
+
+private:
+    std::vector<uint8_t> bytes_;
+
+    static void fill_header(hft::zerocopy::BinaryMessageHeader& h, uint32_t seq,
+                            MessageType type, size_t length) {
+        h.sequence_number = seq;
+        h.message_type = static_cast<uint16_t>(type);
+        h.message_length = static_cast<uint16_t>(length);
+        h.timestamp_ns = 1000 + seq;
+    }
+
+    template<typename Msg>
+    PacketBuilder& append(const Msg& msg) {
+        const size_t at = bytes_.size();
+        bytes_.resize(at + sizeof(Msg));
+        std::memcpy(bytes_.data() + at, &msg, sizeof(Msg));
+        return *this;
+    }
+};
+
+// Test fixture: handler over a flat-backend book, payload-only framing
+class FeedHandlerTest : public ::testing::Test {
+protected:
+    using Book = hft::BasicOrderBookReconstructor<hft::FlatBookBackend<1024, 1024>>;
+
+    Book book_{"BTCUSD", 100, hft::FlatBookBackend<1024, 1024>(0.01, 100.0)};
+    hft::feed::ZeroCopyFeedHandler<Book> handler_{book_, 1, 0};
+};
+
+// Test several messages in one packet are all applied in place
+TEST_F(FeedHandlerTest, MultiMessagePacket) {
+    PacketBuilder pkt;
+    pkt.book(1, 10, 0, true, 99.99, 5)
+       .book(2, 11, 0, false, 100.01, 7)
+       .book(3, 12, 0, true, 99.98, 3);
+    handler_.on_payload(pkt.data(), pkt.size());
+
+    const auto& stats = handler_.stats();
+    EXPECT_EQ(stats.packets, 1u);
+    EXPECT_EQ(stats.messages, 3u);
+    EXPECT_EQ(stats.book_updates, 3u);
+    EXPECT_EQ(handler_.expected_sequence(), 4u);
+
+    auto [bid, ask] = book_.get_top_of_book();
+    ASSERT_TRUE(bid && ask);
+    EXPECT_NEAR(bid->price, 99.99, 1e-9);
+    EXPECT_DOUBLE_EQ(bid->quantity, 5.0);
+    EXPECT_NEAR(ask->price, 100.01, 1e-9);
+    EXPECT_EQ(book_.last_sequence_number(), 3u);
+}
+
+// Test modify/delete/execute map onto the book operations
+TEST_F(FeedHandlerTest, UpdateTypes) {
+    PacketBuilder pkt;
+    pkt.book(1, 10, 0, true, 99.99, 5)
+       .book(2, 10, 1, true, 99.99, 4)     // MODIFY
+       .book(3, 11, 0, true, 99.98, 2)
+       .book(4, 10, 3, true, 99.99, 4)     // EXECUTE (full)
+       .book(5, 11, 2, true, 99.98, 0)     // DELETE
+       .book(6, 12, 9, true, 99.97, 1);    // Unknown update type
+    handler_.on_payload(pkt.data(), pkt.size());
+
+    EXPECT_EQ(handler_.stats().book_updates, 5u);
+    EXPECT_EQ(handler_.stats().rejected_updates, 1u);
+    EXPECT_FALSE(book_.get_top_of_book().first.has_value());
+}
+
+// Test trades, quotes and unknown types go through the dispatch table
+TEST_F(FeedHandlerTest, DispatchByMessageType) {
+    double last_trade = 0.0;
+    double last_ask = 0.0;
+    handler_.set_trade_callback([&](const BinaryTradeMessage& t) { last_trade = t.price; });
+    handler_.set_quote_callback([&](const BinaryQuoteMessage& q) { last_ask = q.ask_price; });
+
+    PacketBuilder pkt;
+    pkt.trade(1, 100.5, 2)
+       .quote(2, 100.0, 100.02)
+       .raw(3, 200, 24)
+       .trade(4, 100.6, 1, /*symbol=*/2);
+    handler_.on_payload(pkt.data(), pkt.size());
+
+    const auto& stats = handler_.stats();
+    EXPECT_EQ(stats.trades, 1u);
+    EXPECT_EQ(stats.quotes, 1u);
+    EXPECT_EQ(stats.unknown_messages, 1u);
+    EXPECT_EQ(stats.filtered, 1u);
+    EXPECT_DOUBLE_EQ(last_trade, 100.5);
+    EXPECT_DOUBLE_EQ(last_ask, 100.02);
+    EXPECT_EQ(stats.sequence_gaps, 0u);
+}
+
+// Test a feed-wide gap flags the book and drops updates until recovery
+TEST_F(FeedHandlerTest, GapTriggersSnapshotRecovery) {
+    PacketBuilder first;
+    first.book(1, 10, 0, true, 99.99, 5).trade(2, 100.0, 1);
+    handler_.on_payload(first.data(), first.size());
+    EXPECT_FALSE(book_.needs_snapshot_recovery());
+
+    PacketBuilder gapped;
+    gapped.book(5, 11, 0, true, 99.98, 5);
+    handler_.on_payload(gapped.data(), gapped.size());
+
+    EXPECT_TRUE(book_.needs_snapshot_recovery());
+    EXPECT_EQ(handler_.stats().sequence_gaps, 1u);
+    EXPECT_EQ(handler_.stats().missed_messages, 2u);
+    EXPECT_EQ(handler_.stats().recovery_drops, 1u);
+    EXPECT_EQ(book_.get_statistics().missed_updates, 2u);
+
+    // Recover from a snapshot taken at sequence 6
+    hft::OrderBookSnapshot snapshot;
+    snapshot.sequence_number = 6;
+    snapshot.bids.push_back(hft::PriceLevel(99.95, 8, 1));
+    book_.initialize_from_snapshot(snapshot);
+    book_.reset_gap_detection();
+
+    PacketBuilder after;
+    after.book(6, 12, 0, true, 99.97, 1)      // Covered by the snapshot
+         .book(7, 13, 0, true, 99.96, 2);
+    handler_.on_payload(after.data(), after.size());
+
+    EXPECT_EQ(handler_.stats().recovery_drops, 2u);
+    EXPECT_EQ(handler_.stats().book_updates, 2u);
+    EXPECT_EQ(book_.last_sequence_number(), 7u);
+    EXPECT_NEAR(book_.get_top_of_book().first->price, 99.96, 1e-9);
+}
+
+// Test with background recovery the gap's updates are held and replayed
+// onto the snapshot instead of dropped
+TEST_F(FeedHandlerTest, AsyncRecoveryBuffersDuringGap) {
+    book_.enable_async_recovery();
+    PacketBuilder first;
+    first.book(1, 10, 0, true, 99.99, 5);
+    handler_.on_payload(first.data(), first.size());
+
+    PacketBuilder gapped;
+    gapped.book(4, 11, 0, true, 99.98, 5)
+          .book(5, 12, 0, false, 100.02, 3);
+    handler_.on_payload(gapped.data(), gapped.size());
+    EXPECT_TRUE(book_.needs_snapshot_recovery());
+    EXPECT_EQ(handler_.stats().recovery_buffered, 2u);
+
+    // The snapshot covers 2-4; 5 is replayed on top of it
+    hft::OrderBookSnapshot snapshot;
+    snapshot.sequence_number = 4;
+    snapshot.bids.push_back(hft::PriceLevel(99.99, 5, 1));
+    snapshot.bids.push_back(hft::PriceLevel(99.98, 5, 1));
+    std::thread recovery([&] { EXPECT_TRUE(book_.recover_from_snapshot(snapshot)); });
+    recovery.join();
+
+    PacketBuilder after;
+    after.book(6, 13, 0, true, 99.97, 1);
+    handler_.on_payload(after.data(), after.size());
+
+    EXPECT_FALSE(book_.needs_snapshot_recovery());
+    EXPECT_EQ(handler_.stats().recovery_drops, 0u);
+    EXPECT_EQ(handler_.stats().book_updates, 2u);
+    EXPECT_EQ(book_.last_sequence_number(), 6u);
+    EXPECT_EQ(book_.get_statistics().current_bid_levels, 3u);
+    EXPECT_NEAR(book_.get_top_of_book().second->price, 100.02, 1e-9);
+}
+
+// Test duplicates (e.g. from A/B line arbitration) are dropped
+TEST_F(FeedHandlerTest, StaleMessagesDropped) {
+    PacketBuilder pkt;
+    pkt.book(1, 10, 0, true, 99.99, 5).book(1, 10, 0, true, 99.99, 5);
+    handler_.on_payload(pkt.data(), pkt.size());
+
+    EXPECT_EQ(handler_.stats().stale_messages, 1u);
+    EXPECT_EQ(handler_.stats().book_updates, 1u);
+    EXPECT_DOUBLE_EQ(book_.get_top_of_book().first->quantity, 5.0);
+}
+
+// Test truncated messages stop the packet walk
+TEST_F(FeedHandlerTest, MalformedPackets) {
+    PacketBuilder overlong;
+    overlong.raw(1, 1, 200);          // Claims more bytes than present
+    handler_.on_payload(overlong.data(), overlong.size() - 100);
+
+    PacketBuilder zero;
+    zero.raw(1, 1, 0);                // Zero length would never advance
+    handler_.on_payload(zero.data(), zero.size());
+
+    PacketBuilder short_book;
+    short_book.raw(1, 1, 20);         // Valid header, too short for the body
+    handler_.on_payload(short_book.data(), short_book.size());
+
+    EXPECT_EQ(handler_.stats().malformed, 3u);
+    EXPECT_EQ(handler_.stats().book_updates, 0u);
+}
+
+// Test polling the ef_vi source strips the frame headers
+TEST(FeedHandlerPollTest, PollsEfviSource) {
+    hft::OrderBookReconstructor book("BTCUSD");
+    hft::feed::ZeroCopyFeedHandler<hft::OrderBookReconstructor> handler(book);
+    hft::network::SolarflareEFVI vi;
+    ASSERT_TRUE(vi.initialize("eth0"));
+
+    // The simulated NIC delivers 64-byte frames: headers plus an empty message
+    EXPECT_EQ(handler.poll(vi, 4), 4u);
+    EXPECT_EQ(handler.stats().packets, 4u);
+    EXPECT_EQ(handler.stats().malformed, 4u);
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+#include "hardware_bridge.hpp"
+
+namespace {
+
+std::vector<MicrostructureFeatures> random_features(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    std::vector<MicrostructureFeatures> rows(count);
+    for (auto& f : rows) {
+        f.ofi_level_1 = unit(rng) * 50.0;
+        f.ofi_level_5 = unit(rng) * 200.0;
+        f.volume_imbalance = unit(rng);
+        f.hawkes_buy_intensity = 10.0 + unit(rng) * 5.0;
+        f.hawkes_sell_intensity = 10.0 + unit(rng) * 5.0;
+        f.bid_ask_spread_bps = 2.0 + unit(rng);
+        f.mid_price_momentum = unit(rng) * 0.05;
+    }
+    return rows;
+}
+
+}
+
+// Test stub mode answers every submitted request, tagged by id, with the
+// batched software score, and drains in pieces
+TEST(HardwareBridgeTest, SubmitPollSoftwareStub) {
+    std::srand(3);
+    HardwareInTheLoopBridge bridge(AcceleratorMode::SOFTWARE_STUB);
+    ASSERT_TRUE(bridge.initialize());
+    bridge.set_software_latency_padding(false);
+
+    const auto rows = random_features(20, 1);
+    std::vector<uint64_t> ids;
+    for (const auto& f : rows) {
+        ids.push_back(bridge.submit(f));
+        ASSERT_NE(ids.back(), HardwareInTheLoopBridge::INVALID_REQUEST);
+    }
+    EXPECT_EQ(bridge.in_flight(), rows.size());
+
+    std::vector<double> expected(rows.size());
+    bridge.predict_batch(rows.data(), rows.size(), expected.data());
+
+    std::vector<InferenceCompletion> done(8);
+    size_t seen = 0;
+    while (seen < rows.size()) {
+        const size_t n = bridge.poll(done.data(), done.size());
+        ASSERT_GT(n, 0u);
+        for (size_t i = 0; i < n; ++i, ++seen) {
+            EXPECT_EQ(done[i].request_id, ids[seen]);
+            EXPECT_EQ(done[i].prediction, expected[seen]);
+            EXPECT_EQ(done[i].source, CompletionSource::SOFTWARE);
+            EXPECT_GE(done[i].latency_ns, 0.0);
+        }
+    }
+    EXPECT_EQ(bridge.in_flight(), 0u);
+    EXPECT_EQ(bridge.poll(done.data(), done.size()), 0u);
+    EXPECT_EQ(bridge.get_latency_stats().total_inferences, 2 * rows.size());
+}
+
+// Test the ring refuses work past QUEUE_DEPTH outstanding results until
+// the caller polls
+TEST(HardwareBridgeTest, BackPressureAtQueueDepth) {
+    HardwareInTheLoopBridge bridge(AcceleratorMode::SOFTWARE_STUB);
+    ASSERT_TRUE(bridge.initialize());
+    const MicrostructureFeatures features;
+    constexpr size_t DEPTH = HardwareInTheLoopBridge::QUEUE_DEPTH;
+
+    for (size_t i = 0; i < DEPTH; ++i) {
+        ASSERT_NE(bridge.submit(features), HardwareInTheLoopBridge::INVALID_REQUEST);
+    }
+    EXPECT_EQ(bridge.submit(features), HardwareInTheLoopBridge::INVALID_REQUEST);
+
+    // Half drained: half the slots come back
+    std::vector<InferenceCompletion> done(DEPTH);
+    EXPECT_EQ(bridge.poll(done.data(), DEPTH / 2), DEPTH / 2);
+    for (size_t i = 0; i < DEPTH / 2; ++i) {
+        EXPECT_EQ(bridge.submit(features), DEPTH + 1 + i);
+    }
+    EXPECT_EQ(bridge.submit(features), HardwareInTheLoopBridge::INVALID_REQUEST);
+    EXPECT_EQ(bridge.poll(done.data(), DEPTH), DEPTH);
+}
+
+// Test requests the hardware never answers fall back to software in
+// hybrid mode, and fail in hardware-only mode, once the timeout passes
+TEST(HardwareBridgeTest, TimeoutFallbackPerRequest) {
+    // Not initialized: initialize() would drop HYBRID to the stub here
+    std::srand(5);
+    HardwareInTheLoopBridge hybrid(AcceleratorMode::HYBRID_FALLBACK);
+    hybrid.set_software_latency_padding(false);
+    hybrid.set_completion_timeout_ns(1e6);
+
+    const auto rows = random_features(3, 2);
+    for (const auto& f : rows) hybrid.submit(f);
+    std::vector<InferenceCompletion> done(4);
+    EXPECT_EQ(hybrid.poll(done.data(), done.size()), 0u);
+    EXPECT_EQ(hybrid.in_flight(), 3u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    ASSERT_EQ(hybrid.poll(done.data(), done.size()), 3u);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(done[i].source, CompletionSource::SOFTWARE_FALLBACK);
+        EXPECT_NEAR(done[i].prediction, hybrid.predict(rows[i]), 2e-3);
+        EXPECT_GE(done[i].latency_ns, 1e6);
+    }
+    EXPECT_EQ(hybrid.get_status(), HardwareStatus::DEGRADED);
+    EXPECT_EQ(hybrid.get_latency_stats().software_fallbacks, 6u);
+
+    HardwareInTheLoopBridge fpga(AcceleratorMode::HARDWARE_FPGA);
+    fpga.set_completion_timeout_ns(0.0);
+    const uint64_t id = fpga.submit(rows[0]);
+    ASSERT_EQ(fpga.poll(done.data(), done.size()), 1u);
+    EXPECT_EQ(done[0].request_id, id);
+    EXPECT_EQ(done[0].source, CompletionSource::FAILED);
+    EXPECT_EQ(done[0].prediction, 0.0);
+    EXPECT_EQ(fpga.get_status(), HardwareStatus::FAILED);
+    EXPECT_EQ(fpga.get_latency_stats().hardware_failures, 1u);
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "hawkes_bank.hpp"
+
+namespace {
+
+using hft::HawkesBank;
+using hft::Side;
+using hft::TradingEvent;
+
+const std::array<double, 4> ALPHAS_SELF{0.4, 0.3, 0.2, 0.1};
+const std::array<double, 4> ALPHAS_CROSS{0.1, 0.05, 0.05, 0.02};
+const std::array<double, 4> BETAS{1000.0, 100.0, 10.0, 1.0};
+
+TradingEvent event(uint32_t symbol, Side side, int64_t ts_ns) {
+    return TradingEvent(hft::Timestamp(std::chrono::nanoseconds(ts_ns)), side, symbol);
+}
+
+// Same recursion with std::exp, one symbol at a time
+struct Reference {
+    std::vector<std::array<double, 4>> buy, sell;
+    std::vector<int64_t> last;
+
+    explicit Reference(size_t n) : buy(n), sell(n), last(n, 0) {}
+
+    void update(const TradingEvent& e) {
+        const int64_t ts = hft::to_nanos(e.arrival_time);
+        const double dt = ts > last[e.asset_id] ? (ts - last[e.asset_id]) * 1e-9 : 0.0;
+        if (ts > last[e.asset_id]) last[e.asset_id] = ts;
+        for (size_t k = 0; k < 4; ++k) {
+            const double decay = std::exp(-BETAS[k] * dt);
+            buy[e.asset_id][k] = buy[e.asset_id][k] * decay + (e.event_type == Side::BUY ? 1.0 : 0.0);
+            sell[e.asset_id][k] = sell[e.asset_id][k] * decay + (e.event_type == Side::SELL ? 1.0 : 0.0);
+        }
+    }
+};
+
+}
+
+// Test the polynomial decay against std::exp over the decay range
+TEST(HawkesBankTest, DecayExpAccuracy) {
+    for (double x = -700.0; x <= 0.0; x += 0.37) {
+        const double expected = std::exp(x);
+        EXPECT_NEAR(HawkesBank::decay_exp(x), expected, expected * 1e-13) << x;
+    }
+    EXPECT_DOUBLE_EQ(HawkesBank::decay_exp(0.0), 1.0);
+    EXPECT_LT(HawkesBank::decay_exp(-1e6), 1e-300);
+}
+
+// Test batched bursts with repeated symbols match per-event updates and
+// an exact reference
+TEST(HawkesBankTest, BatchMatchesScalarUpdates) {
+    constexpr size_t SYMBOLS = 37;
+    HawkesBank batched(SYMBOLS, 10.0, 10.0, ALPHAS_SELF, ALPHAS_CROSS, BETAS);
+    HawkesBank scalar(SYMBOLS, 10.0, 10.0, ALPHAS_SELF, ALPHAS_CROSS, BETAS);
+    Reference reference(SYMBOLS);
+
+    std::mt19937_64 rng(7);
+    int64_t ts = 1'000'000'000;
+    for (int burst = 0; burst < 200; ++burst) {
+        std::vector<TradingEvent> events;
+        const size_t n = rng() % 40;
+        for (size_t i = 0; i < n; ++i) {
+            ts += static_cast<int64_t>(rng() % 500000);
+            // Skewed so bursts often repeat a symbol
+            const uint32_t symbol = static_cast<uint32_t>((rng() % 3 == 0) ? rng() % 4 : rng() % SYMBOLS);
+            events.push_back(event(symbol, (rng() & 1) ? Side::BUY : Side::SELL, ts));
+        }
+        batched.update_batch(events);
+        for (const auto& e : events) {
+            scalar.update(e);
+            reference.update(e);
+        }
+    }
+
+    for (uint32_t s = 0; s < SYMBOLS; ++s) {
+        for (size_t k = 0; k < 4; ++k) {
+            EXPECT_NEAR(batched.buy_state(s, k), scalar.buy_state(s, k), 1e-12 * (1.0 + scalar.buy_state(s, k)));
+            EXPECT_NEAR(batched.sell_state(s, k), scalar.sell_state(s, k), 1e-12 * (1.0 + scalar.sell_state(s, k)));
+            EXPECT_NEAR(batched.buy_state(s, k), reference.buy[s][k], 1e-10 * (1.0 + reference.buy[s][k]));
+            EXPECT_NEAR(batched.sell_state(s, k), reference.sell[s][k], 1e-10 * (1.0 + reference.sell[s][k]));
+        }
+        EXPECT_NEAR(batched.get_intensity_imbalance(s), scalar.get_intensity_imbalance(s), 1e-12);
+    }
+}
+
+// Test bank-wide sweeps agree with per-symbol accessors
+TEST(HawkesBankTest, BankWideIntensities) {
+    HawkesBank bank(5, 10.0, 10.0, ALPHAS_SELF, ALPHAS_CROSS, BETAS);
+    bank.set_baseline(4, 2.0, 3.0);
+    bank.update_batch({event(0, Side::BUY, 100), event(1, Side::SELL, 200),
+                       event(0, Side::BUY, 300), event(4, Side::BUY, 400)});
+
+    std::vector<double> buy(5), sell(5), imbalance(5);
+    bank.intensities(buy.data(), sell.data());
+    bank.imbalances(imbalance.data());
+
+    for (uint32_t s = 0; s < 5; ++s) {
+        EXPECT_DOUBLE_EQ(buy[s], bank.get_buy_intensity(s));
+        EXPECT_DOUBLE_EQ(sell[s], bank.get_sell_intensity(s));
+        EXPECT_DOUBLE_EQ(imbalance[s], bank.get_intensity_imbalance(s));
+    }
+    EXPECT_GT(imbalance[0], 0.0);
+    EXPECT_LT(imbalance[1], 0.0);
+    EXPECT_DOUBLE_EQ(imbalance[2], 0.0);
+    EXPECT_DOUBLE_EQ(bank.get_sell_intensity(4), 3.0 + (0.1 * 1000 + 0.05 * 100 + 0.05 * 10 + 0.02 * 1));
+
+    EXPECT_THROW(bank.update(5, Side::BUY, 500), std::out_of_range);
+    EXPECT_THROW(HawkesBank(0, 1.0, 1.0, ALPHAS_SELF, ALPHAS_CROSS, BETAS), std::invalid_argument);
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+#include "hawkes_calibrator.hpp"
+
+namespace {
+
+using hft::HawkesCalibrationService;
+using hft::OnlineHawkesCalibrator;
+using hft::Side;
+
+struct Trade {
+    int64_t ts_ns;
+    Side side;
+};
+
+// Ogata thinning for the engine's symmetric exponential-kernel process
+std::vector<Trade> simulate(double mu, double alpha_self, double alpha_cross, double beta,
+                            double horizon_s, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<Trade> trades;
+    double t = 0.0, buy = 0.0, sell = 0.0;
+
+    while (t < horizon_s) {
+        const double bound = 2 * mu + (alpha_self + alpha_cross) * beta * (buy + sell);
+        const double wait = -std::log(1.0 - uniform(rng)) / bound;
+        const double decay = std::exp(-beta * wait);
+        buy *= decay;
+        sell *= decay;
+        t += wait;
+
+        const double lambda_buy = mu + alpha_self * beta * buy + alpha_cross * beta * sell;
+        const double lambda_sell = mu + alpha_self * beta * sell + alpha_cross * beta * buy;
+        const double u = uniform(rng) * bound;
+        if (u < lambda_buy) {
+            trades.push_back({static_cast<int64_t>(t * 1e9), Side::BUY});
+            buy += 1.0;
+        } else if (u < lambda_buy + lambda_sell) {
+            trades.push_back({static_cast<int64_t>(t * 1e9), Side::SELL});
+            sell += 1.0;
+        }
+    }
+    return trades;
+}
+
+HawkesParameters prior() {
+    HawkesParameters p{};
+    p.lambda_base = 3.0;
+    p.alpha_self = 0.3;
+    p.alpha_cross = 0.1;
+    p.beta = 25.0;
+    p.gamma = 2.0;
+    return p;
+}
+
+}
+
+// Test the streaming estimate recovers the simulated parameters
+TEST(HawkesCalibratorTest, RecoversSimulatedParameters) {
+    const auto trades = simulate(5.0, 0.4, 0.15, 50.0, 4000.0, 1);
+    hft::HawkesCalibratorConfig config;
+    config.window_seconds = 120.0;
+    OnlineHawkesCalibrator calibrator(prior(), config);
+
+    for (const auto& t : trades) calibrator.observe(t.side, t.ts_ns);
+    ASSERT_TRUE(calibrator.ready());
+
+    const auto e = calibrator.estimate();
+    EXPECT_NEAR(e.mu, 5.0, 0.75);
+    EXPECT_NEAR(e.alpha_self, 0.4, 0.05);
+    EXPECT_NEAR(e.alpha_cross, 0.15, 0.05);
+    EXPECT_NEAR(e.beta, 50.0, 10.0);
+    EXPECT_GT(e.goodness_of_fit, 0.95);
+    EXPECT_EQ(e.events, trades.size());
+
+    const HawkesParameters p = calibrator.parameters();
+    EXPECT_DOUBLE_EQ(p.lambda_base, e.mu);
+    EXPECT_DOUBLE_EQ(p.gamma, 2.0);
+    EXPECT_EQ(p.calibration_samples, trades.size());
+}
+
+// Test the rescaled residuals score a fitted model above a frozen,
+// misspecified one
+TEST(HawkesCalibratorTest, GoodnessOfFit) {
+    const auto trades = simulate(20.0, 0.0, 0.0, 50.0, 500.0, 2);
+    OnlineHawkesCalibrator calibrator(prior());
+    hft::HawkesCalibratorConfig frozen;
+    frozen.em_interval = UINT32_MAX;
+    HawkesParameters wrong = prior();
+    wrong.lambda_base = 2.0;
+    OnlineHawkesCalibrator misspecified(wrong, frozen);
+
+    for (const auto& t : trades) {
+        calibrator.observe(t.side, t.ts_ns);
+        misspecified.observe(t.side, t.ts_ns);
+    }
+    EXPECT_GT(calibrator.goodness_of_fit(), 0.95);
+    EXPECT_LT(misspecified.goodness_of_fit(), calibrator.goodness_of_fit());
+
+    calibrator.reset_fit_window();
+    EXPECT_DOUBLE_EQ(calibrator.goodness_of_fit(), 0.0);
+}
+
+// Test the background service publishes to the ModelStore without the
+// producer blocking
+TEST(HawkesCalibratorTest, ServicePublishesToModelStore) {
+    ModelStore store;
+    hft::HawkesCalibratorConfig config;
+    config.min_events = 2000;
+    HawkesCalibrationService service(store, "TEST", config, std::chrono::hours(1));
+
+    std::atomic<int> callbacks{0};
+    CalibrationQuality quality{};
+    service.set_publish_callback([&](const HawkesParameters&, const CalibrationQuality& q) {
+        quality = q;
+        callbacks.fetch_add(1);
+    });
+    service.start();
+
+    const auto trades = simulate(5.0, 0.4, 0.15, 50.0, 400.0, 3);
+    for (const auto& t : trades) {
+        while (!service.record(t.side, t.ts_ns)) std::this_thread::yield();
+    }
+    for (int i = 0; i < 2000 && service.published() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    service.stop();
+
+    // No parameters for the symbol yet, so the first ready estimate is published
+    ASSERT_GE(service.published(), 1u);
+    EXPECT_EQ(callbacks.load(), static_cast<int>(service.published()));
+    EXPECT_EQ(quality.symbol, "TEST");
+    EXPECT_EQ(service.latest_estimate().events, trades.size());
+
+    const auto stored = store.get_hawkes_parameters("TEST");
+    ASSERT_TRUE(stored.has_value());
+    EXPECT_EQ(stored->version.updated_by, "online_calibrator");
+    EXPECT_GT(stored->calibration_samples, 0u);
+    EXPECT_FALSE(store.needs_recalibration("TEST", 3600));
+
+    hft::HawkesIntensityEngine engine;
+    engine.set_parameters(stored->lambda_base, stored->lambda_base, stored->alpha_self,
+                          stored->alpha_cross, stored->beta);
+    EXPECT_DOUBLE_EQ(engine.get_buy_intensity(), stored->lambda_base);
+}
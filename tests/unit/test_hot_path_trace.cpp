@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include "hot_path_trace.hpp"
+
+using namespace hft;
+
+namespace {
+
+void spin_ns(int64_t ns) {
+    const int64_t start = to_nanos(now());
+    while (to_nanos(now()) - start < ns) {}
+}
+
+size_t count_of(const std::string& text, const std::string& needle) {
+    size_t n = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) ++n;
+    return n;
+}
+
+}
+
+// Test each marked stage gets its own histogram sized to the work done in
+// it, and stages a cycle skips record nothing
+TEST(HotPathTraceTest, StagesLandInHistograms) {
+    TraceConfig config;
+    config.sample_every = 1;
+    BasicHotPathTracer<true> tracer(config);
+    auto& thread = tracer.register_thread("main");
+
+    for (int i = 0; i < 100; ++i) {
+        thread.begin_cycle();
+        thread.mark(TraceStage::RX);
+        spin_ns(20000);
+        thread.mark(TraceStage::HAWKES);
+        thread.mark(TraceStage::QUOTE);
+        thread.end_cycle();
+    }
+    EXPECT_EQ(tracer.drain(), 100u);
+    EXPECT_EQ(tracer.sampled_cycles(), 100u);
+    EXPECT_EQ(tracer.stage_histogram(TraceStage::BOOK).count(), 0u);
+
+    const auto& hawkes = tracer.stage_histogram(TraceStage::HAWKES);
+    EXPECT_EQ(hawkes.count(), 100u);
+    EXPECT_GE(hawkes.value_at_percentile(50.0), 15000u);
+    EXPECT_LT(tracer.stage_histogram(TraceStage::QUOTE).value_at_percentile(50.0),
+              hawkes.value_at_percentile(50.0));
+    EXPECT_GE(tracer.cycle_histogram().max(), hawkes.max());
+    EXPECT_EQ(tracer.dropped(), 0u);
+}
+
+// Test one cycle in sample_every is kept, abandoned cycles are discarded,
+// and the Chrome trace holds one event per marked stage of the window
+TEST(HotPathTraceTest, SamplingAndChromeTrace) {
+    TraceConfig config;
+    config.sample_every = 4;
+    config.recent_cycles = 8;
+    config.export_interval = std::chrono::milliseconds(1);
+    BasicHotPathTracer<true> tracer(config);
+    auto& rx = tracer.register_thread("rx");
+    auto& strategy = tracer.register_thread("strategy");
+    EXPECT_THROW(BasicHotPathTracer<true>(TraceConfig{3}), std::invalid_argument);
+
+    tracer.start();
+    EXPECT_TRUE(tracer.running());
+    for (int i = 0; i < 64; ++i) {
+        rx.begin_cycle();
+        rx.mark(TraceStage::RX);
+        if (i % 8 == 0) continue;                    // Idle poll: never ended
+        rx.mark(TraceStage::DECODE);
+        rx.end_cycle();
+
+        strategy.begin_cycle();
+        strategy.mark(TraceStage::INFERENCE);
+        strategy.end_cycle();
+    }
+    tracer.stop();
+    EXPECT_FALSE(tracer.running());
+
+    // rx samples cycles 0, 4, ..., 60 of which 0, 8, ... (8) were idle;
+    // strategy runs 56 cycles and samples 14 of them
+    EXPECT_EQ(tracer.stage_histogram(TraceStage::DECODE).count(), 8u);
+    EXPECT_EQ(tracer.stage_histogram(TraceStage::INFERENCE).count(), 14u);
+
+    const std::string path = "/tmp/test_hot_path_trace.json";
+    ASSERT_TRUE(tracer.write_chrome_trace(path));
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    const std::string json = ss.str();
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0u);
+    EXPECT_EQ(count_of(json, "\"ph\":\"M\""), 2u);
+    EXPECT_EQ(count_of(json, "\"ph\":\"X\""), count_of(json, "\"dur\""));
+    // Window of 8 cycles; each rx cycle has rx + decode, each strategy one inference
+    const size_t events = count_of(json, "\"ph\":\"X\"");
+    EXPECT_GE(events, 8u);
+    EXPECT_LE(events, 16u);
+    EXPECT_FALSE(tracer.write_chrome_trace("/nonexistent/dir/trace.json"));
+}
+
+// Test the compiled-out tracer has no state and records nothing
+TEST(HotPathTraceTest, CompiledOutIsEmpty) {
+    static_assert(std::is_empty<BasicTraceThread<false>>::value, "disabled trace thread has state");
+    static_assert(std::is_empty<BasicHotPathTracer<false>>::value, "disabled tracer has state");
+    static_assert(HotPathTracer::enabled == TRACE_ENABLED, "alias follows the build switch");
+
+    BasicHotPathTracer<false> tracer;
+    auto& thread = tracer.register_thread("main");
+    tracer.start();
+    for (int i = 0; i < 10; ++i) {
+        thread.begin_cycle();
+        thread.mark(TraceStage::RX);
+        thread.end_cycle();
+    }
+    tracer.stop();
+    EXPECT_EQ(tracer.drain(), 0u);
+    EXPECT_EQ(tracer.sampled_cycles(), 0u);
+    EXPECT_FALSE(tracer.running());
+    EXPECT_FALSE(tracer.write_chrome_trace("/tmp/test_hot_path_trace_disabled.json"));
+}
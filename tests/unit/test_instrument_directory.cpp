@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "instrument_directory.hpp"
+#include "zero_copy_decoder.hpp"
+#include "preserialized_orders.hpp"
+#include "smart_order_router.hpp"
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<std::string> make_symbols(size_t n) {
+    std::vector<std::string> symbols;
+    symbols.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        symbols.push_back("SYM" + std::to_string(i) + "USD");
+    }
+    return symbols;
+}
+
+VenueInfo make_venue(const std::string& id, double latency_us) {
+    VenueInfo v;
+    v.venue_id = id;
+    v.venue_name = id;
+    v.is_active = true;
+    v.endpoint = "";
+    v.baseline_latency_us = latency_us;
+    v.maker_fee_bps = 0.0;
+    v.taker_fee_bps = 0.0;
+    v.min_order_size = 0.0;
+    v.max_order_size = 1e9;
+    v.typical_bid_depth = 1000.0;
+    v.typical_ask_depth = 1000.0;
+    v.fill_rate = 0.99;
+    return v;
+}
+
+}
+
+// Test every key of a large universe maps to its own index
+TEST(PerfectHashIndexTest, LargeUniverse) {
+    const auto symbols = make_symbols(8192);
+    hft::PerfectHashIndex index(symbols);
+
+    ASSERT_EQ(index.size(), symbols.size());
+    for (uint32_t i = 0; i < symbols.size(); ++i) {
+        ASSERT_EQ(index.find(symbols[i]), i);
+        ASSERT_EQ(index.key(i), symbols[i]);
+    }
+}
+
+// Test unknown names are rejected
+TEST(PerfectHashIndexTest, UnknownKeys) {
+    hft::PerfectHashIndex index(make_symbols(100));
+    EXPECT_EQ(index.find("NOTASYMBOL"), hft::PerfectHashIndex::NOT_FOUND);
+    EXPECT_EQ(index.find(""), hft::PerfectHashIndex::NOT_FOUND);
+    EXPECT_EQ(index.find("SYM100USD"), hft::PerfectHashIndex::NOT_FOUND);
+
+    hft::PerfectHashIndex empty;
+    EXPECT_EQ(empty.find("BTCUSD"), hft::PerfectHashIndex::NOT_FOUND);
+}
+
+// Test duplicate keys are refused at build time
+TEST(PerfectHashIndexTest, DuplicateKeysThrow) {
+    EXPECT_THROW(hft::PerfectHashIndex({"BTCUSD", "ETHUSD", "BTCUSD"}), std::invalid_argument);
+}
+
+// Test the directory hands out dense IDs in input order
+TEST(InstrumentDirectoryTest, DenseIds) {
+    hft::InstrumentDirectory dir({"BTCUSD", "ETHUSD", "SOLUSD"}, {"BINANCE", "KRAKEN"});
+
+    EXPECT_EQ(dir.symbol_id("BTCUSD"), 0u);
+    EXPECT_EQ(dir.symbol_id("SOLUSD"), 2u);
+    EXPECT_EQ(dir.venue_id("KRAKEN"), 1u);
+    EXPECT_EQ(dir.symbol_id("DOGEUSD"), hft::InstrumentDirectory::INVALID_ID);
+    EXPECT_EQ(dir.symbol_name(1), "ETHUSD");
+
+    auto positions = dir.make_symbol_table<double>();
+    ASSERT_EQ(positions.size(), 3u);
+    positions[dir.symbol_id("ETHUSD")] = 42.0;
+    EXPECT_DOUBLE_EQ(positions[1], 42.0);
+    // One entry per cache line
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&positions[1]) - reinterpret_cast<uintptr_t>(&positions[0]), 64u);
+}
+
+// Test SymbolMapper keeps its string <-> wire ID contract
+TEST(SymbolMapperTest, LookupBothWays) {
+    hft::zerocopy::SymbolMapper mapper;
+    EXPECT_EQ(mapper.get_id("ETHUSD"), 2u);
+    EXPECT_EQ(mapper.get_symbol(5), "XRPUSD");
+    EXPECT_EQ(mapper.get_id("UNKNOWN"), 0u);
+    EXPECT_EQ(mapper.get_symbol(99), "");
+
+    mapper.add_symbol("ADAUSD", 6);
+    mapper.add_symbol("ETHUSD", 7);     // Re-map
+    EXPECT_EQ(mapper.get_id("ADAUSD"), 6u);
+    EXPECT_EQ(mapper.get_id("ETHUSD"), 7u);
+    EXPECT_EQ(mapper.get_symbol(7), "ETHUSD");
+    EXPECT_EQ(mapper.get_id("BTCUSD"), 1u);
+
+    hft::InstrumentDirectory dir({"AAA", "BBB"}, {});
+    hft::zerocopy::SymbolMapper from_dir(dir);
+    EXPECT_EQ(from_dir.get_id("BBB"), 2u);
+    EXPECT_EQ(from_dir.get_symbol(1), "AAA");
+}
+
+// Test templates are looked up by dense symbol ID
+TEST(OrderTemplatePoolTest, FlatTemplates) {
+    hft::preserialized::OrderTemplatePool pool(7, 9, 4);
+    pool.initialize_symbol_templates(2, "ETHUSD");
+
+    alignas(64) uint8_t buffer[256] = {};
+    const size_t len = pool.submit_limit_order_ioc(2, hft::Side::SELL, 100.5, 3.0, buffer);
+    ASSERT_EQ(len, sizeof(hft::preserialized::BinaryNewOrderMessage));
+
+    const auto* msg = reinterpret_cast<const hft::preserialized::BinaryNewOrderMessage*>(buffer);
+    EXPECT_EQ(msg->symbol_id, 2u);
+    EXPECT_EQ(msg->time_in_force, 1);
+    EXPECT_EQ(msg->side, 1);
+    EXPECT_EQ(msg->header.client_id, 7u);
+    EXPECT_DOUBLE_EQ(msg->price, 100.5);
+
+    EXPECT_EQ(pool.submit_limit_order_fok(2, hft::Side::BUY, 100.0, 1.0, buffer), len);
+    EXPECT_EQ(msg->time_in_force, 2);
+
+    // Unknown symbols produce no message
+    EXPECT_EQ(pool.submit_limit_order_gtc(1000, hft::Side::BUY, 1.0, 1.0, buffer), 0u);
+
+    // Table grows for IDs past the presized range
+    pool.initialize_symbol_templates(10, "XRPUSD");
+    EXPECT_EQ(pool.submit_limit_order_gtc(10, hft::Side::BUY, 1.0, 1.0, buffer), len);
+}
+
+// Test venue indices are stable and route by dense price vector
+TEST(SmartOrderRouterDirectoryTest, DenseVenueIndex) {
+    SmartOrderRouter router;
+    router.add_venue(make_venue("FAST", 100.0));
+    router.add_venue(make_venue("SLOW", 600.0));
+
+    const uint32_t fast = router.venue_index("FAST");
+    const uint32_t slow = router.venue_index("SLOW");
+    ASSERT_NE(fast, SmartOrderRouter::INVALID_VENUE);
+    ASSERT_NE(slow, SmartOrderRouter::INVALID_VENUE);
+    EXPECT_NE(fast, slow);
+
+    std::vector<double> prices(router.venue_slot_count(), 100.0);
+    auto decision = router.route_order(100.0, 0.01, 0, 10, hft::MarketRegime::NORMAL, prices);
+    EXPECT_EQ(decision.selected_venue, "FAST");
+    EXPECT_EQ(decision.selected_venue_index, fast);
+
+    router.record_order_result(fast, true, false);
+    EXPECT_EQ(router.get_venue_state("FAST")->orders_filled, 1u);
+
+    // Removal keeps the other index valid; re-adding reuses the slot
+    router.remove_venue("FAST");
+    EXPECT_EQ(router.venue_index("FAST"), SmartOrderRouter::INVALID_VENUE);
+    EXPECT_EQ(router.venue_index("SLOW"), slow);
+    EXPECT_FALSE(router.get_venue_state("FAST").has_value());
+    router.add_venue(make_venue("FAST", 100.0));
+    EXPECT_EQ(router.venue_index("FAST"), fast);
+
+    // String-keyed route still works
+    std::unordered_map<std::string, double> named = {{"FAST", 100.0}, {"SLOW", 99.0}};
+    decision = router.route_order(100.0, 0.01, 0, 10, hft::MarketRegime::NORMAL, named);
+    EXPECT_FALSE(decision.selected_venue.empty());
+    EXPECT_EQ(router.get_all_venue_states().size(), 2u);
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+#include "latency_histogram.hpp"
+#include "institutional_logging.hpp"
+
+using namespace hft;
+
+// Test bucket bounds: exact below SUB_BUCKETS, contiguous, and never wider
+// than 1/HALF_BUCKETS of the values they hold
+TEST(LatencyHistogramTest, BucketPrecision) {
+    using H = LatencyHistogram;
+    for (uint64_t v = 0; v < H::SUB_BUCKETS; ++v) {
+        EXPECT_EQ(H::lowest_equivalent(H::index_of(v)), v);
+        EXPECT_EQ(H::highest_equivalent(H::index_of(v)), v);
+    }
+    for (size_t i = 1; i < H::BUCKET_COUNT; ++i) {
+        ASSERT_EQ(H::lowest_equivalent(i), H::highest_equivalent(i - 1) + 1) << i;
+    }
+    EXPECT_EQ(H::highest_equivalent(H::BUCKET_COUNT - 1), H::MAX_TRACKABLE);
+
+    std::mt19937_64 rng(7);
+    for (int i = 0; i < 100000; ++i) {
+        const uint64_t v = rng() >> (24 + rng() % 40);
+        const size_t idx = H::index_of(v);
+        ASSERT_LT(idx, H::BUCKET_COUNT);
+        const uint64_t lo = H::lowest_equivalent(idx);
+        const uint64_t hi = H::highest_equivalent(idx);
+        ASSERT_LE(lo, v);
+        ASSERT_GE(hi, v);
+        ASSERT_LE(static_cast<double>(hi - lo), static_cast<double>(lo) / H::HALF_BUCKETS);
+    }
+    EXPECT_EQ(H::index_of(uint64_t(1) << 50), H::BUCKET_COUNT - 1);   // clamped
+}
+
+// Test percentiles against a sorted copy, and that merged per-thread
+// histograms equal one histogram holding every sample
+TEST(LatencyHistogramTest, PercentilesAndMerge) {
+    std::mt19937_64 rng(42);
+    std::lognormal_distribution<double> dist(6.5, 0.6);
+
+    std::vector<int64_t> samples;
+    LatencyHistogram all;
+    LatencyHistogram parts[4];
+    for (int i = 0; i < 200000; ++i) {
+        const auto v = static_cast<int64_t>(dist(rng));
+        samples.push_back(v);
+        all.record(v);
+        parts[i % 4].record(v);
+    }
+    all.record(50'000'000);                                  // one 50ms outlier
+    samples.push_back(50'000'000);
+    parts[0].record(50'000'000);
+    std::sort(samples.begin(), samples.end());
+
+    for (double p : {1.0, 50.0, 90.0, 99.0, 99.9, 99.99}) {
+        const size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * samples.size()));
+        const double exact = static_cast<double>(samples[rank - 1]);
+        const double reported = static_cast<double>(all.value_at_percentile(p));
+        EXPECT_GE(reported, exact) << "p" << p;
+        EXPECT_LE(reported, exact * (1.0 + 1.0 / LatencyHistogram::HALF_BUCKETS) + 1.0) << "p" << p;
+    }
+    EXPECT_EQ(all.min(), static_cast<uint64_t>(samples.front()));
+    EXPECT_EQ(all.max(), 50'000'000u);
+    EXPECT_EQ(all.value_at_percentile(100.0), 50'000'000u);
+
+    double sum = 0.0;
+    for (int64_t v : samples) sum += v;
+    EXPECT_NEAR(all.mean(), sum / samples.size(), 1e-6);
+
+    LatencyHistogram merged;
+    for (const auto& part : parts) merged.merge(part);
+    EXPECT_EQ(merged.count(), all.count());
+    EXPECT_EQ(merged.min(), all.min());
+    EXPECT_EQ(merged.max(), all.max());
+    EXPECT_NEAR(merged.stddev(), all.stddev(), 1e-6 * all.stddev());
+    for (double p : {50.0, 99.0, 99.99}) {
+        EXPECT_EQ(merged.value_at_percentile(p), all.value_at_percentile(p));
+    }
+
+    LatencyHistogram copy = merged;
+    merged.reset();
+    EXPECT_TRUE(merged.empty());
+    EXPECT_EQ(copy.count(), all.count());
+
+    // LatencyDistribution reports through the same histogram
+    InstitutionalLogging::LatencyDistribution dist_log;
+    for (int64_t v : samples) dist_log.add_sample(v);
+    dist_log.calculate();
+    EXPECT_EQ(dist_log.get_sample_count(), samples.size());
+    EXPECT_EQ(dist_log.get_p99(), static_cast<int64_t>(all.value_at_percentile(99.0)));
+    EXPECT_EQ(dist_log.get_max(), 50'000'000);
+}
+
+// Test a monitoring thread can query while the owner records
+TEST(LatencyHistogramTest, ConcurrentQuery) {
+    LatencyHistogram h;
+    std::atomic<bool> done{false};
+    uint64_t last_count = 0;
+    bool monotonic = true;
+
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            const uint64_t c = h.count();
+            if (c < last_count) monotonic = false;
+            last_count = c;
+            const uint64_t p99 = h.value_at_percentile(99.0);
+            if (c > 0 && (p99 < 100 || p99 > 1100)) monotonic = false;
+            std::this_thread::yield();
+        }
+    });
+
+    for (int i = 0; i < 2'000'000; ++i) h.record(100 + i % 1000);
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_TRUE(monotonic);
+    EXPECT_EQ(h.count(), 2'000'000u);
+    EXPECT_EQ(h.max(), 1099u);
+}
@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+#include "lockfree_queue.hpp"
+#include <thread>
+#include <vector>
+#include <memory>
+#include <atomic>
+
+// Test fixture for LockFreeQueue tests
+class LockFreeQueueTest : public ::testing::Test {
+protected:
+    hft::LockFreeQueue<int, 16> queue_;
+};
+
+// Test single push/pop
+TEST_F(LockFreeQueueTest, PushPop) {
+    EXPECT_TRUE(queue_.empty());
+    EXPECT_EQ(queue_.capacity(), 15u);
+
+    EXPECT_TRUE(queue_.push(1));
+    EXPECT_TRUE(queue_.push(2));
+    EXPECT_EQ(queue_.size(), 2u);
+
+    int value = 0;
+    EXPECT_TRUE(queue_.pop(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(queue_.pop(value));
+    EXPECT_EQ(value, 2);
+    EXPECT_FALSE(queue_.pop(value));
+}
+
+// Test capacity limit
+TEST_F(LockFreeQueueTest, FullQueue) {
+    for (int i = 0; i < 15; ++i) {
+        EXPECT_TRUE(queue_.push(i));
+    }
+    EXPECT_FALSE(queue_.push(99));
+
+    int value = 0;
+    EXPECT_TRUE(queue_.pop(value));
+    EXPECT_TRUE(queue_.push(99));
+}
+
+// Test bulk push stops at capacity and preserves order
+TEST_F(LockFreeQueueTest, PushBulk) {
+    std::vector<int> items(20);
+    for (int i = 0; i < 20; ++i) items[i] = i;
+
+    EXPECT_EQ(queue_.push_bulk(items.data(), 10), 10u);
+    EXPECT_EQ(queue_.push_bulk(items.data() + 10, 10), 5u);
+    EXPECT_EQ(queue_.size(), 15u);
+
+    int value = -1;
+    for (int i = 0; i < 15; ++i) {
+        ASSERT_TRUE(queue_.pop(value));
+        EXPECT_EQ(value, i);
+    }
+}
+
+// Test bulk pop across the wrap-around point
+TEST_F(LockFreeQueueTest, PopBulkWraps) {
+    int scratch[16];
+    for (int round = 0; round < 5; ++round) {
+        for (int i = 0; i < 11; ++i) {
+            ASSERT_TRUE(queue_.push(round * 100 + i));
+        }
+        EXPECT_EQ(queue_.pop_bulk(scratch, 4), 4u);
+        EXPECT_EQ(scratch[0], round * 100);
+        EXPECT_EQ(queue_.pop_bulk(scratch, 16), 7u);
+        EXPECT_EQ(scratch[6], round * 100 + 10);
+        EXPECT_TRUE(queue_.empty());
+    }
+}
+
+// Test consume_all drains in FIFO order
+TEST_F(LockFreeQueueTest, ConsumeAll) {
+    for (int i = 0; i < 8; ++i) queue_.push(i);
+
+    std::vector<int> seen;
+    EXPECT_EQ(queue_.consume_all([&](int& v) { seen.push_back(v); }, 3), 3u);
+    EXPECT_EQ(queue_.consume_all([&](int& v) { seen.push_back(v); }), 5u);
+    EXPECT_EQ(seen, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}));
+    EXPECT_EQ(queue_.consume_all([](int&) {}), 0u);
+}
+
+// Test non-trivial element lifetime through bulk paths
+TEST(LockFreeQueueLifetimeTest, SharedPtrElements) {
+    auto tracked = std::make_shared<int>(7);
+    std::shared_ptr<int> items[4] = {tracked, tracked, tracked, tracked};
+    std::shared_ptr<int> out[2];
+    {
+        hft::LockFreeQueue<std::shared_ptr<int>, 8> queue;
+        EXPECT_EQ(queue.push_bulk(items, 4), 4u);
+        EXPECT_EQ(tracked.use_count(), 9);
+
+        EXPECT_EQ(queue.pop_bulk(out, 2), 2u);
+        EXPECT_EQ(tracked.use_count(), 9);
+    }
+    // Queue destructor releases the remaining two
+    EXPECT_EQ(tracked.use_count(), 7);
+}
+
+// Test SPSC bursts between two threads
+TEST(LockFreeQueueThreadTest, BurstProducerConsumer) {
+    static hft::LockFreeQueue<uint64_t, 1024> queue;
+    constexpr uint64_t TOTAL = 1000000;
+
+    std::thread producer([] {
+        uint64_t batch[32];
+        uint64_t next = 0;
+        while (next < TOTAL) {
+            size_t n = 0;
+            while (n < 32 && next + n < TOTAL) { batch[n] = next + n; ++n; }
+            const size_t pushed = queue.push_bulk(batch, n);
+            if (pushed == 0) std::this_thread::yield();
+            next += pushed;
+        }
+    });
+
+    uint64_t expected = 0;
+    bool in_order = true;
+    while (expected < TOTAL) {
+        const size_t n = queue.consume_all([&](uint64_t& v) {
+            in_order &= (v == expected);
+            ++expected;
+        }, 64);
+        if (n == 0) std::this_thread::yield();
+    }
+    producer.join();
+
+    EXPECT_TRUE(in_order);
+    EXPECT_TRUE(queue.empty());
+}
+
+// Test MPMC basic FIFO and capacity
+TEST(SequencedQueueTest, MPMCBasic) {
+    hft::MPMCQueue<int, 8> queue;
+    EXPECT_TRUE(queue.empty());
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(queue.push(i));
+    }
+    EXPECT_FALSE(queue.push(8));
+    EXPECT_EQ(queue.size(), 8u);
+
+    int value = -1;
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(queue.pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.pop(value));
+}
+
+// Test several producers into one consumer keep per-producer order
+TEST(SequencedQueueTest, MPSCManyProducers) {
+    static hft::MPSCQueue<uint64_t, 256> queue;
+    constexpr uint64_t PRODUCERS = 4;
+    constexpr uint64_t PER_PRODUCER = 50000;
+
+    std::vector<std::thread> producers;
+    for (uint64_t p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([p] {
+            for (uint64_t i = 0; i < PER_PRODUCER; ++i) {
+                while (!queue.push((p << 32) | i)) std::this_thread::yield();
+            }
+        });
+    }
+
+    std::vector<uint64_t> next(PRODUCERS, 0);
+    bool in_order = true;
+    uint64_t received = 0;
+    while (received < PRODUCERS * PER_PRODUCER) {
+        uint64_t v;
+        if (!queue.pop(v)) { std::this_thread::yield(); continue; }
+        const uint64_t p = v >> 32;
+        in_order &= ((v & 0xFFFFFFFF) == next[p]);
+        ++next[p];
+        ++received;
+    }
+    for (auto& t : producers) t.join();
+
+    EXPECT_TRUE(in_order);
+    EXPECT_TRUE(queue.empty());
+}
+
+// Test several consumers see each item exactly once
+TEST(SequencedQueueTest, MPMCExactlyOnce) {
+    static hft::MPMCQueue<uint32_t, 128> queue;
+    constexpr uint32_t TOTAL = 100000;
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint32_t> count{0};
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < 3; ++c) {
+        consumers.emplace_back([&] {
+            uint32_t v;
+            while (count.load(std::memory_order_relaxed) < TOTAL) {
+                if (queue.pop(v)) {
+                    sum.fetch_add(v, std::memory_order_relaxed);
+                    count.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    std::thread producer([] {
+        for (uint32_t i = 1; i <= TOTAL; ++i) {
+            while (!queue.push(i)) std::this_thread::yield();
+        }
+    });
+    producer.join();
+    for (auto& t : consumers) t.join();
+
+    EXPECT_EQ(count.load(), TOTAL);
+    EXPECT_EQ(sum.load(), static_cast<uint64_t>(TOTAL) * (TOTAL + 1) / 2);
+}
+
+// Test broadcast ring delivers every item to every reader and gates the writer
+TEST(BroadcastRingTest, ReadersGateWriter) {
+    using Ring = hft::BroadcastRing<int, 4, 2>;
+    Ring ring;
+    const int r0 = ring.add_reader();
+    const int r1 = ring.add_reader();
+    ASSERT_NE(r0, Ring::NO_READER);
+    ASSERT_NE(r1, Ring::NO_READER);
+    EXPECT_EQ(ring.add_reader(), Ring::NO_READER);
+
+    const int items[6] = {1, 2, 3, 4, 5, 6};
+    EXPECT_EQ(ring.publish_bulk(items, 6), 4u);   // Gated at capacity
+
+    int v = 0;
+    EXPECT_TRUE(ring.poll(r0, v));
+    EXPECT_EQ(v, 1);
+    // r1 has not moved, so the writer is still blocked
+    EXPECT_FALSE(ring.publish(5));
+
+    EXPECT_EQ(ring.consume(r1, [](const int&) {}, 2), 2u);
+    EXPECT_TRUE(ring.publish(5));
+    EXPECT_EQ(ring.lag(r0), 4u);
+    EXPECT_EQ(ring.lag(r1), 3u);
+
+    std::vector<int> seen;
+    ring.consume(r0, [&](const int& x) { seen.push_back(x); });
+    EXPECT_EQ(seen, (std::vector<int>{2, 3, 4, 5}));
+
+    // Removing a slow reader releases the writer
+    ring.remove_reader(r1);
+    EXPECT_TRUE(ring.publish(6));
+}
+
+// Test late joiner only sees future items
+TEST(BroadcastRingTest, LateJoiner) {
+    hft::BroadcastRing<int, 8> ring;
+    ring.publish(1);
+    const int r = ring.add_reader();
+    ring.publish(2);
+
+    int v = 0;
+    EXPECT_TRUE(ring.poll(r, v));
+    EXPECT_EQ(v, 2);
+    EXPECT_FALSE(ring.poll(r, v));
+}
@@ -0,0 +1,143 @@
+#define HFT_TRACK_ALLOCATIONS
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "engine_checkpoint.hpp"
+#include "memory_arena.hpp"
+
+using namespace hft;
+
+HFT_DEFINE_ALLOCATION_TRACKING()
+
+namespace {
+
+ArenaConfig small_arena() {
+    ArenaConfig config;
+    config.bytes = size_t(4) << 20;
+    config.lock = false;
+    return config;
+}
+
+}
+
+// Test blocks come from the arena, freed blocks are reused by size class,
+// alignment holds, and requests the arena cannot serve go to the heap
+TEST(MemoryArenaTest, ResourceReusesSizeClasses) {
+    HugePageArena arena(small_arena());
+    ArenaResource resource(&arena);
+    EXPECT_GE(arena.capacity(), size_t(4) << 20);
+
+    void* a = resource.allocate(40, 8);
+    EXPECT_TRUE(arena.contains(a));
+    const size_t used = arena.used();
+    resource.deallocate(a, 40, 8);
+    EXPECT_EQ(resource.allocate(64, 8), a);            // Same 64-byte class
+    EXPECT_EQ(arena.used(), used);
+
+    void* line = resource.allocate(100, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(line) % 64, 0u);
+
+    void* big = resource.allocate(size_t(8) << 20);     // Larger than the arena
+    EXPECT_FALSE(arena.contains(big));
+    EXPECT_EQ(resource.overflow_allocations(), 1u);
+    resource.deallocate(big, size_t(8) << 20);
+
+    ArenaResource heap;
+    void* h = heap.allocate(32);
+    EXPECT_FALSE(arena.contains(h));
+    heap.deallocate(h, 32);
+}
+
+// Test STL containers and object pools run on an arena and, once warm,
+// make no heap allocations
+TEST(MemoryArenaTest, ContainersAllocateFromArena) {
+    HugePageArena arena(small_arena());
+    ArenaResource resource(&arena);
+    ArenaAllocator<int> alloc(resource);
+
+    HotVector<int> v(alloc);
+    v.reserve(1024);
+    std::map<int, double, std::less<int>, ArenaAllocator<std::pair<const int, double>>> m(alloc);
+    std::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+                       ArenaAllocator<std::pair<const int, int>>> u(alloc);
+    u.reserve(256);
+    for (int i = 0; i < 128; ++i) m[i] = i;              // Warm the node class
+
+    ObjectPool<std::pair<int, double>, 64> pool(64, resource);
+    EXPECT_EQ(pool.capacity(), 64u);
+
+    ASSERT_TRUE(SteadyStateAllocations::tracking());
+    SteadyStateAllocations::reset();
+    SteadyStateAllocations::arm();
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 1000; ++i) v.push_back(i);
+        v.clear();
+        for (int i = 0; i < 128; ++i) m.erase(i);
+        for (int i = 0; i < 128; ++i) m[i] = i;
+        u[round] = round;
+        auto* p = pool.create(round, 1.5);
+        pool.destroy(p);
+    }
+    SteadyStateAllocations::disarm();
+    EXPECT_EQ(SteadyStateAllocations::count(), 0u);
+    EXPECT_TRUE(arena.contains(v.data()));
+    EXPECT_TRUE(arena.contains(&*m.begin()));
+    EXPECT_EQ(pool.live(), 0u);
+    EXPECT_EQ(resource.overflow_allocations(), 0u);
+}
+
+// Test the tracker reports heap allocations made while armed, only on the
+// armed thread
+TEST(MemoryArenaTest, ReportsSteadyStateMalloc) {
+    SteadyStateAllocations::reset();
+    auto* before = new int(1);
+    EXPECT_EQ(SteadyStateAllocations::count(), 0u);
+
+    SteadyStateAllocations::arm();
+    EXPECT_TRUE(SteadyStateAllocations::is_armed());
+    std::vector<int> grown;
+    grown.resize(100);
+    const uint64_t armed_count = SteadyStateAllocations::count();
+    std::thread other([] {
+        for (int i = 0; i < 50; ++i) delete new int(i);
+    });
+    other.join();
+    SteadyStateAllocations::disarm();
+
+    EXPECT_GE(armed_count, 1u);
+    EXPECT_GE(SteadyStateAllocations::bytes(), 100 * sizeof(int));
+    EXPECT_LT(SteadyStateAllocations::count() - armed_count, 50u);   // Only the thread handle
+    delete before;
+}
+
+// Test periodic checkpoints stay inside the steady state: once reserved,
+// a snapshot submitted from the armed thread allocates nothing there
+TEST(MemoryArenaTest, CheckpointSnapshotDoesNotAllocate) {
+    const std::string path = "/tmp/test_memory_arena.ckpt";
+    BackgroundCheckpointWriter checkpoints(path);
+    std::array<double, 256> model{};
+    const std::string boot_id = "6f1c2a8e-4b7d-4e0f-9a35-1d2c3b4a5f60";
+    auto fill = [&](CheckpointWriter& writer) {
+        writer.section("model", 1).put(model);
+        writer.section("boot", 1).put_string(boot_id);
+    };
+    checkpoints.reserve(fill);
+
+    SteadyStateAllocations::reset();
+    SteadyStateAllocations::arm();
+    for (int i = 1; i <= 3; ++i) {
+        model[0] = i;
+        EXPECT_TRUE(checkpoints.submit(i, static_cast<uint64_t>(i), fill));
+        checkpoints.flush();
+    }
+    SteadyStateAllocations::disarm();
+
+    EXPECT_EQ(SteadyStateAllocations::count(), 0u);
+    EXPECT_EQ(checkpoints.written(), 3u);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include "backtesting_engine.hpp"
+#include "merged_replay.hpp"
+#include "synthetic_ticks.hpp"
+#include "tick_store.hpp"
+
+using namespace hft;
+using namespace hft::backtest;
+
+namespace {
+
+HistoricalEvent store_event(int64_t ts, uint32_t asset) {
+    HistoricalEvent e;
+    e.timestamp_ns = ts;
+    e.asset_id = asset;
+    e.bid_price = 50.0;
+    e.ask_price = 50.5;
+    return e;
+}
+
+class MergedReplayTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        for (const auto& p : paths_) std::filesystem::remove(p);
+    }
+
+    std::string path(const std::string& name) {
+        paths_.push_back("/tmp/test_merged_replay_" + name);
+        return paths_.back();
+    }
+
+    std::vector<std::string> paths_;
+};
+
+}
+
+// Test CSV and tick-store sources interleave by timestamp, equal timestamps
+// replay in the order sources were added, and rewind replays the same stream
+TEST_F(MergedReplayTest, MergesInTimestampOrder) {
+    const std::string csv = path("a.csv");
+    {
+        std::ofstream file(csv);
+        file << "ts_us,event_type,side,price,size\n1,trade,B,100,10\n3,trade,S,100,10\n\n5,quote,B,100,10\n";
+    }
+    const std::string store = path("b.bin");
+    TickStoreWriter writer;
+    for (int64_t ts : {2000, 3000, 6000}) writer.append(store_event(ts, 9));
+    writer.write(store);
+
+    MergedReplay<HistoricalEvent> replay;
+    replay.add(std::make_unique<CsvReplaySource<HistoricalEvent>>(csv, 4));
+    replay.add(std::make_unique<TickStoreReplaySource<HistoricalEvent>>(store));
+
+    const std::vector<std::pair<int64_t, uint32_t>> expected = {
+        {1000, 4}, {2000, 9}, {3000, 4}, {3000, 9}, {5000, 4}, {6000, 9}};
+    for (int pass = 0; pass < 2; ++pass) {
+        replay.rewind();
+        std::vector<std::pair<int64_t, uint32_t>> seen;
+        HistoricalEvent e;
+        while (replay.next(e)) seen.emplace_back(e.timestamp_ns, e.asset_id);
+        EXPECT_EQ(seen, expected);
+        EXPECT_EQ(replay.delivered(), expected.size());
+    }
+    EXPECT_EQ(replay.source(0).name(), csv);
+}
+
+// Test a source that goes back in time is rejected rather than replayed out of order
+TEST_F(MergedReplayTest, RejectsUnorderedSource) {
+    const std::string csv = path("unordered.csv");
+    {
+        std::ofstream file(csv);
+        file << "ts_us,event_type,side,price,size\n5,trade,B,100,10\n4,trade,B,100,10\n";
+    }
+    MergedReplay<HistoricalEvent> replay;
+    replay.add(std::make_unique<CsvReplaySource<HistoricalEvent>>(csv, 1));
+    HistoricalEvent e;
+    EXPECT_THROW({ while (replay.next(e)) {} }, std::runtime_error);
+
+    EXPECT_THROW(CsvReplaySource<HistoricalEvent>("/tmp/test_merged_replay_missing.csv", 1),
+                 std::runtime_error);
+}
+
+// Test a multi-asset backtest keeps one book per asset: positions and fills
+// add up to the engine totals, and each asset alone replays the same as it
+// does inside the merge
+TEST_F(MergedReplayTest, PerAssetStateInBacktest) {
+    const std::string a = path("asset_a.csv");
+    const std::string b = path("asset_b.csv");
+    test_data::write_trade_csv(a, 400, 987654321, 100.0);
+    test_data::write_trade_csv(b, 400, 123456789, 40.0, test_data::START_US + 500);
+
+    BacktestConfig config;
+    config.hawkes.beta = 1.0;
+    config.verbose = false;
+    config.enable_replay_logging = false;
+    config.reference_asset_id = 2;
+
+    BacktestingEngine merged(config);
+    ASSERT_TRUE(merged.add_csv_source(a, 1));
+    ASSERT_TRUE(merged.add_csv_source(b, 2));
+    EXPECT_FALSE(merged.add_csv_source(path("missing.csv"), 3));
+    EXPECT_EQ(merged.get_replay_source_count(), 2u);
+    const auto metrics = merged.run_backtest();
+
+    EXPECT_EQ(merged.get_asset_count(), 2u);
+    EXPECT_EQ(merged.get_historical_events_count(), 800u);
+    EXPECT_EQ(merged.get_position(1) + merged.get_position(2), merged.get_current_position());
+    EXPECT_EQ(merged.get_ledger(1).fills() + merged.get_ledger(2).fills(), metrics.total_trades);
+    EXPECT_GT(merged.get_ledger(1).fills(), 0u);
+    EXPECT_THROW(merged.get_position(3), std::out_of_range);
+
+    // Reference asset is only consulted by the other asset's features
+    BacktestingEngine alone(config);
+    ASSERT_TRUE(alone.add_csv_source(b, 2));
+    alone.run_backtest();
+    EXPECT_EQ(alone.get_ledger(2).fills(), merged.get_ledger(2).fills());
+    EXPECT_EQ(alone.get_position(2), merged.get_position(2));
+}
+
+// Test an asset's model sees only its own ticks: interleaving another
+// asset changes neither its feature history nor the orders it sends
+TEST_F(MergedReplayTest, PerAssetInferenceInBacktest) {
+    const std::string a = path("signals_a.csv");
+    const std::string b = path("signals_b.csv");
+    test_data::write_trade_csv(a, 400, 987654321, 100.0);
+    test_data::write_trade_csv(b, 400, 123456789, 40.0, test_data::START_US + 500);
+
+    BacktestConfig config;
+    config.hawkes.beta = 1.0;
+    config.verbose = false;
+    config.enable_replay_logging = false;
+    config.record_fills = true;
+
+    BacktestingEngine merged(config);
+    ASSERT_TRUE(merged.add_csv_source(a, 1));
+    ASSERT_TRUE(merged.add_csv_source(b, 2));
+    merged.run_backtest();
+    BacktestingEngine alone(config);
+    ASSERT_TRUE(alone.add_csv_source(b, 2));
+    alone.run_backtest();
+
+    checkpoint::StateWriter merged_state, alone_state;
+    merged.get_inference(2).save_state(merged_state);
+    alone.get_inference(2).save_state(alone_state);
+    EXPECT_EQ(merged_state.bytes(), alone_state.bytes());
+
+    auto orders_for = [](const BacktestingEngine& engine, uint32_t asset) {
+        std::vector<std::tuple<int64_t, Side, double, uint64_t>> out;
+        for (const SimulatedOrder& o : engine.get_filled_orders()) {
+            if (o.order.asset_id == asset) {
+                out.emplace_back(o.fill_time_ns, o.order.side, o.order.price, o.filled_quantity);
+            }
+        }
+        return out;
+    };
+    const auto expected = orders_for(alone, 2);
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(orders_for(merged, 2), expected);
+}
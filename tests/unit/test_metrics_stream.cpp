@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "metrics_frame.hpp"
+
+namespace {
+
+MetricSnapshot snapshot(int64_t i) {
+    MetricSnapshot s{};
+    s.timestamp_ns = 1'000'000'000 + i * 1'000'000;
+    s.mid_price = 100.0 + (i / 10) * 0.01;                  // changes every 10th
+    s.spread_bps = 2.0;
+    s.pnl = 0.5 * i;
+    s.position = (i % 7) - 3;
+    s.buy_intensity = 1.25;
+    s.sell_intensity = 1.5;
+    s.cycle_latency_us = 0.8;
+    s.orders_sent = static_cast<uint64_t>(i);
+    s.orders_filled = static_cast<uint64_t>(i / 2);
+    s.regime = 1;
+    s.position_limit_usage = 0.3;
+    return s;
+}
+
+bool same(const MetricSnapshot& a, const MetricSnapshot& b) {
+    return a.timestamp_ns == b.timestamp_ns && a.mid_price == b.mid_price &&
+           a.spread_bps == b.spread_bps && a.pnl == b.pnl && a.position == b.position &&
+           a.buy_intensity == b.buy_intensity && a.sell_intensity == b.sell_intensity &&
+           a.cycle_latency_us == b.cycle_latency_us && a.orders_sent == b.orders_sent &&
+           a.orders_filled == b.orders_filled && a.regime == b.regime &&
+           a.position_limit_usage == b.position_limit_usage;
+}
+
+}
+
+// Test the ring keeps the newest capacity() entries and rejects overwritten
+// or unpublished indices
+TEST(MetricsStreamTest, RingOverwritesOldest) {
+    hft::SnapshotRing<MetricSnapshot> ring(100);
+    ASSERT_EQ(ring.capacity(), 128u);
+
+    for (int64_t i = 0; i < 300; ++i) ring.publish(snapshot(i));
+    EXPECT_EQ(ring.published(), 300u);
+    EXPECT_EQ(ring.oldest(), 300u - 128u);
+
+    MetricSnapshot out;
+    EXPECT_FALSE(ring.read(100, out));                      // overwritten
+    EXPECT_FALSE(ring.read(300, out));                      // not yet published
+    ASSERT_TRUE(ring.read(299, out));
+    EXPECT_TRUE(same(out, snapshot(299)));
+
+    std::vector<uint64_t> seen;
+    const uint64_t next = ring.visit_recent(5, [&](uint64_t index, const MetricSnapshot& s) {
+        EXPECT_TRUE(same(s, snapshot(static_cast<int64_t>(index))));
+        seen.push_back(index);
+    });
+    EXPECT_EQ(next, 300u);
+    EXPECT_EQ(seen, (std::vector<uint64_t>{295, 296, 297, 298, 299}));
+
+    MetricsCollector collector(16);
+    collector.get_metrics().orders_sent.store(4);
+    collector.get_metrics().orders_filled.store(3);
+    for (int i = 0; i < 40; ++i) collector.take_snapshot();
+    EXPECT_EQ(collector.get_recent_snapshots(1000).size(), 16u);
+    EXPECT_EQ(collector.get_recent_snapshots(5).size(), 5u);
+    EXPECT_EQ(collector.get_summary().total_trades, 3u);
+    EXPECT_DOUBLE_EQ(collector.get_summary().fill_rate, 0.75);
+}
+
+// Test delta frames round-trip exactly, decode on their own, are far smaller
+// than the raw snapshots, and reject truncation
+TEST(MetricsStreamTest, DeltaFramesRoundTrip) {
+    metrics_frame::Encoder encoder;
+    std::vector<MetricSnapshot> input;
+    encoder.reset(metrics_frame::UPDATE, 500);
+    for (int64_t i = 500; i < 600; ++i) {
+        input.push_back(snapshot(i));
+        encoder.add(input.back());
+    }
+    const std::string frame = encoder.finish();
+    EXPECT_LT(frame.size(), input.size() * sizeof(MetricSnapshot) / 4);
+
+    metrics_frame::FrameHeader header;
+    std::vector<MetricSnapshot> decoded;
+    ASSERT_TRUE(metrics_frame::decode(frame.data(), frame.size(), header, decoded));
+    EXPECT_EQ(header.kind, metrics_frame::UPDATE);
+    EXPECT_EQ(header.first_index, 500u);
+    ASSERT_EQ(decoded.size(), input.size());
+    for (size_t i = 0; i < input.size(); ++i) EXPECT_TRUE(same(decoded[i], input[i])) << i;
+
+    // Encoder is reusable; the next frame does not depend on this one
+    encoder.reset(metrics_frame::HISTORY, 600);
+    encoder.add(snapshot(600));
+    const std::string second = encoder.finish();
+    decoded.clear();
+    ASSERT_TRUE(metrics_frame::decode(second.data(), second.size(), header, decoded));
+    ASSERT_EQ(decoded.size(), 1u);
+    EXPECT_TRUE(same(decoded[0], snapshot(600)));
+
+    decoded.clear();
+    EXPECT_FALSE(metrics_frame::decode(frame.data(), frame.size() - 3, header, decoded));
+    EXPECT_FALSE(metrics_frame::decode(frame.data(), 8, header, decoded));
+}
+
+// Test a reader streaming from the ring while the writer publishes sees
+// every entry it reads intact and in order
+TEST(MetricsStreamTest, ConcurrentStreaming) {
+    hft::SnapshotRing<MetricSnapshot> ring(64);
+    constexpr int64_t TOTAL = 200000;
+    std::atomic<bool> done{false};
+    uint64_t received = 0;
+    bool intact = true;
+
+    std::thread reader([&] {
+        uint64_t cursor = 0;
+        int64_t last = -1;
+        while (!done.load(std::memory_order_acquire) || cursor < ring.published()) {
+            cursor = ring.visit(cursor, [&](uint64_t index, const MetricSnapshot& s) {
+                if (!same(s, snapshot(static_cast<int64_t>(index))) || static_cast<int64_t>(index) <= last) {
+                    intact = false;
+                }
+                last = static_cast<int64_t>(index);
+                ++received;
+            });
+            std::this_thread::yield();
+        }
+    });
+
+    for (int64_t i = 0; i < TOTAL; ++i) ring.publish(snapshot(i));
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_TRUE(intact);
+    EXPECT_GT(received, 0u);
+    EXPECT_LE(received, static_cast<uint64_t>(TOTAL));
+}
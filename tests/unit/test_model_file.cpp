@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <vector>
+#include "model_file.hpp"
+#include "fpga_inference.hpp"
+#include "model_store.hpp"
+#include "vectorized_inference.hpp"
+
+namespace {
+
+std::vector<double> random_values(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> unit(-0.5, 0.5);
+    std::vector<double> values(count);
+    for (auto& v : values) v = unit(rng);
+    return values;
+}
+
+}
+
+// Test a written model maps back with aligned blobs and identical values
+TEST(ModelFileTest, WriteAndMapRoundTrip) {
+    const std::string path = "/tmp/test_model_file_roundtrip.bin";
+    const auto w1 = random_values(7 * 5, 1), b1 = random_values(5, 2);
+    const auto w2 = random_values(5 * 3, 3), b2 = random_values(3, 4);
+    hft::ModelFileWriter::write(path, {{7, 5, w1.data(), b1.data()}, {5, 3, w2.data(), b2.data()}});
+
+    hft::MappedModel model(path);
+    ASSERT_EQ(model.layer_count(), 2u);
+    EXPECT_EQ(model.inputs(0), 7u);
+    EXPECT_EQ(model.outputs(1), 3u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(model.weights(1)) % hft::model_file::BLOB_ALIGN, 0u);
+    for (size_t i = 0; i < w1.size(); ++i) EXPECT_EQ(model.weights(0)[i], w1[i]);
+    for (size_t i = 0; i < b2.size(); ++i) EXPECT_EQ(model.bias(1)[i], b2[i]);
+
+    using Match = hft::NetworkDef<hft::DenseLayer<7, 5>, hft::DenseLayer<5, 3>>;
+    using Other = hft::NetworkDef<hft::DenseLayer<10, 16>, hft::DenseLayer<16, 3>>;
+    EXPECT_TRUE(model.matches<Match>());
+    EXPECT_FALSE(model.matches<Other>());
+    EXPECT_THROW(hft::VectorizedInferenceEngine{model}, std::runtime_error);
+
+    std::remove(path.c_str());
+}
+
+// Test a templated engine loaded from file scores exactly like the reference
+// forward pass over the written weights, and the FPGA stub checks its shape
+TEST(ModelFileTest, EngineLoadsTrainedWeights) {
+    constexpr size_t IN = 6, HIDDEN = 12;
+    using Engine = hft::BasicVectorizedInferenceEngine<IN, HIDDEN>;
+    const std::string path = "/tmp/test_model_file_engine.bin";
+    const auto w1 = random_values(IN * HIDDEN, 5), b1 = random_values(HIDDEN, 6);
+    const auto w2 = random_values(HIDDEN * 3, 7), b2 = random_values(3, 8);
+    hft::ModelFileWriter::write(path, {{IN, HIDDEN, w1.data(), b1.data()}, {HIDDEN, 3, w2.data(), b2.data()}});
+
+    Engine engine(path);
+    const auto x = random_values(IN, 9);
+    const auto out = engine.predict(x.data());
+
+    double logits[3];
+    for (size_t k = 0; k < 3; ++k) {
+        logits[k] = b2[k];
+        for (size_t j = 0; j < HIDDEN; ++j) {
+            double h = b1[j];
+            for (size_t i = 0; i < IN; ++i) h += w1[j * IN + i] * x[i];
+            h = std::tanh(h);
+            logits[k] += w2[k * HIDDEN + j] * h;
+        }
+    }
+    const double m = std::max({logits[0], logits[1], logits[2]});
+    const double sum = std::exp(logits[0] - m) + std::exp(logits[1] - m) + std::exp(logits[2] - m);
+    EXPECT_NEAR(out.buy_signal, std::exp(logits[0] - m) / sum, 1e-9);
+    EXPECT_NEAR(out.sell_signal, std::exp(logits[1] - m) / sum, 1e-9);
+    EXPECT_NEAR(out.hold_signal, std::exp(logits[2] - m) / sum, 1e-9);
+
+    Engine::InferenceOutput batched;
+    engine.predict_batch(x.data(), 1, &batched);
+    EXPECT_NEAR(batched.buy_signal, out.buy_signal, 1e-5);
+
+    EXPECT_THROW(hft::FPGA_DNN_Inference{path}, std::runtime_error);
+
+    const std::string saved = "/tmp/test_model_file_saved.bin";
+    engine.save_model(saved);
+    Engine reloaded(saved);
+    EXPECT_EQ(reloaded.predict(x.data()).sell_signal, out.sell_signal);
+
+    std::remove(path.c_str());
+    std::remove(saved.c_str());
+}
+
+// Test truncated and foreign files are rejected before any weight is read
+TEST(ModelFileTest, RejectsCorruptFiles) {
+    const std::string path = "/tmp/test_model_file_corrupt.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not a model";
+    }
+    EXPECT_THROW(hft::MappedModel{path}, std::runtime_error);
+
+    std::vector<char> bytes(4096, 0);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    EXPECT_THROW(hft::MappedModel{path}, std::runtime_error);
+    EXPECT_THROW(hft::MappedModel{"/tmp/test_model_file_missing.bin"}, std::runtime_error);
+
+    const double w = 1.0, b = 0.0;
+    EXPECT_THROW(hft::ModelFileWriter::write(path, {{1, 1, &w, &b}, {2, 1, &w, &b}}), std::invalid_argument);
+
+    std::remove(path.c_str());
+}
+
+// Test pointing the store at a new weights file publishes a fresh snapshot
+TEST(ModelFileTest, StorePublishesModelPath) {
+    ModelStore store("/tmp/test_model_file_store.json");
+    ASSERT_TRUE(store.initialize());
+    const auto id = store.resolve("default");
+
+    auto params = *store.get_inference_parameters("default");
+    params.model_path = "/opt/models/mlp_v2.bin";
+    ASSERT_TRUE(store.update_inference_parameters("default", params, "trainer", "nightly retrain"));
+
+    const auto* snapshot = store.snapshot(id);
+    ASSERT_TRUE(snapshot->inference.has_value());
+    EXPECT_EQ(snapshot->inference->model_path, "/opt/models/mlp_v2.bin");
+    EXPECT_EQ(snapshot->inference->version.updated_by, "trainer");
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include "model_store.hpp"
+
+namespace {
+
+HawkesParameters hawkes(double alpha_self) {
+    HawkesParameters p{};
+    p.alpha_self = alpha_self;
+    p.alpha_cross = 0.1;
+    p.beta = 0.5;
+    p.gamma = 2.0;
+    p.lambda_base = 5.0;
+    return p;
+}
+
+}
+
+// Test IDs are stable and snapshots follow updates while old blocks stay
+// readable until reclaimed
+TEST(ModelStoreTest, SnapshotsFollowUpdates) {
+    ModelStore store;
+    store.initialize();
+
+    const ParameterId defaults = store.resolve("default");
+    const ParameterId aapl = store.resolve("AAPL");
+    EXPECT_EQ(store.resolve("default"), defaults);
+    EXPECT_NE(aapl, defaults);
+
+    const ParameterSnapshot* d = store.snapshot(defaults);
+    ASSERT_TRUE(d->hawkes.has_value());
+    ASSERT_TRUE(d->as.has_value());
+    ASSERT_TRUE(d->inference.has_value());
+    EXPECT_DOUBLE_EQ(d->hawkes->alpha_self, 0.3);
+
+    const ParameterSnapshot* before = store.snapshot(aapl);
+    EXPECT_FALSE(before->hawkes.has_value());
+
+    ASSERT_TRUE(store.update_hawkes_parameters("AAPL", hawkes(0.25), "test", "first"));
+    const ParameterSnapshot* after = store.snapshot(aapl);
+    ASSERT_TRUE(after->hawkes.has_value());
+    EXPECT_DOUBLE_EQ(after->hawkes->alpha_self, 0.25);
+    EXPECT_EQ(after->hawkes->version.updated_by, "test");
+    EXPECT_GT(after->version, before->version);
+
+    ASSERT_TRUE(store.update_hawkes_parameters("AAPL", hawkes(0.35), "test", "second"));
+    EXPECT_DOUBLE_EQ(after->hawkes->alpha_self, 0.25);     // Retired, still valid
+    EXPECT_DOUBLE_EQ(store.snapshot(aapl)->hawkes->alpha_self, 0.35);
+    EXPECT_DOUBLE_EQ(store.get_hawkes_parameters("AAPL")->alpha_self, 0.35);
+    EXPECT_FALSE(store.snapshot(aapl)->risk.has_value());
+
+    EXPECT_EQ(store.reclaim_retired(), 2u);
+}
+
+// Test a reader polling snapshots during updates always sees a complete,
+// monotonically newer block
+TEST(ModelStoreTest, ConcurrentReaderSeesConsistentBlocks) {
+    ModelStore store;
+    const ParameterId id = store.resolve("SYM");
+    std::atomic<bool> done{false};
+    std::atomic<bool> consistent{true};
+
+    std::thread reader([&] {
+        uint64_t last_version = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            const ParameterSnapshot* s = store.snapshot(id);
+            if (s->version < last_version) consistent = false;
+            if (s->hawkes && s->hawkes->alpha_cross != s->hawkes->alpha_self * 2.0) consistent = false;
+            last_version = s->version;
+        }
+    });
+
+    for (int i = 1; i <= 500; ++i) {
+        HawkesParameters p = hawkes(i * 0.001);
+        p.alpha_cross = p.alpha_self * 2.0;
+        store.update_hawkes_parameters("SYM", p, "test", "");
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_TRUE(consistent.load());
+    EXPECT_DOUBLE_EQ(store.snapshot(id)->hawkes->alpha_self, 0.5);
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "feed_handler.hpp"
+
+using namespace hft;
+using hardware::CustomNICDriver;
+using hardware::RxPacket;
+using hardware::TxPacket;
+
+namespace {
+
+// BAR0 backed by a regular file: registers are plain memory, and the
+// driver's loopback plays the NIC
+class LoopbackNIC : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = "/tmp/hft_test_bar0_" + std::to_string(::getpid());
+        const int fd = ::open(path_.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(::ftruncate(fd, 0x10000), 0);
+        ::close(fd);
+        ASSERT_TRUE(nic_.initialize(path_.c_str()));
+    }
+
+    void TearDown() override { ::unlink(path_.c_str()); }
+
+    static std::vector<uint8_t> frame(uint8_t tag, size_t len) {
+        std::vector<uint8_t> f(len, tag);
+        return f;
+    }
+
+    std::string path_;
+    CustomNICDriver nic_;
+};
+
+}
+
+// Test a burst reads every ready frame in order and rings the RX doorbell
+// once, on the next call, when the buffers are handed back
+TEST_F(LoopbackNIC, RxBurstOneDoorbellPerBurst) {
+    for (uint8_t i = 0; i < 10; ++i) {
+        const auto f = frame(i, 60 + i);
+        ASSERT_TRUE(nic_.loopback_rx(f.data(), f.size()));
+    }
+
+    const uint64_t writes = nic_.mmio_writes();
+    RxPacket burst[hardware::MAX_BURST];
+    ASSERT_EQ(nic_.rx_burst(burst, hardware::MAX_BURST), 10u);
+    EXPECT_EQ(nic_.mmio_writes(), writes);                  // still holding the buffers
+    for (size_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(burst[i].len, 60 + i);
+        EXPECT_EQ(burst[i].data[0], i);
+        EXPECT_EQ(burst[i].data[burst[i].len - 1], i);
+    }
+
+    EXPECT_EQ(nic_.rx_burst(burst, hardware::MAX_BURST), 0u);
+    EXPECT_EQ(nic_.mmio_writes(), writes + 1);               // one tail write for 10 packets
+    EXPECT_EQ(nic_.rx_burst(burst, hardware::MAX_BURST), 0u);
+    EXPECT_EQ(nic_.mmio_writes(), writes + 1);               // idle polls write nothing
+
+    // Hardware cannot overrun buffers software still holds
+    const auto f = frame(0xAB, 64);
+    size_t accepted = 0;
+    while (nic_.loopback_rx(f.data(), f.size())) ++accepted;
+    EXPECT_EQ(accepted, hardware::RX_RING_SIZE - 1);
+
+    size_t drained = 0;
+    while (size_t n = nic_.rx_burst(burst, 7)) {
+        EXPECT_LE(n, 7u);
+        drained += n;
+    }
+    EXPECT_EQ(drained, accepted);
+}
+
+// Test a TX burst queues up to the free descriptors with one doorbell
+TEST_F(LoopbackNIC, TxBurstOneDoorbellPerBurst) {
+    std::vector<uint8_t> payload(64, 0x5A);
+    std::vector<TxPacket> pkts(40, TxPacket{payload.data(), payload.size()});
+
+    uint64_t writes = nic_.mmio_writes();
+    EXPECT_EQ(nic_.tx_burst(pkts.data(), pkts.size()), 40u);
+    EXPECT_EQ(nic_.mmio_writes(), writes + 1);
+
+    // Oversized frame ends the burst before it
+    std::vector<uint8_t> jumbo(hardware::PACKET_BUFFER_SIZE + 1);
+    pkts[5] = TxPacket{jumbo.data(), jumbo.size()};
+    writes = nic_.mmio_writes();
+    EXPECT_EQ(nic_.tx_burst(pkts.data(), pkts.size()), 5u);
+    EXPECT_EQ(nic_.mmio_writes(), writes + 1);
+    EXPECT_FALSE(nic_.submit_tx(jumbo.data(), jumbo.size()));
+
+    // TX_HEAD never moves here, so the ring fills and stops accepting
+    pkts[5] = pkts[0];
+    size_t queued = 45;
+    while (size_t n = nic_.tx_burst(pkts.data(), pkts.size())) queued += n;
+    EXPECT_EQ(queued, hardware::TX_RING_SIZE - 1);
+    EXPECT_FALSE(nic_.submit_tx(payload.data(), payload.size()));
+}
+
+// Test the feed handler and busy_wait_n_packets consume in bursts
+TEST_F(LoopbackNIC, FeedHandlerPollsInBursts) {
+    OrderBookReconstructor book("BTCUSD");
+    feed::ZeroCopyFeedHandler<OrderBookReconstructor> handler(book);
+
+    zerocopy::BinaryQuoteMessage quote{};
+    quote.header.message_type = static_cast<uint16_t>(zerocopy::MessageType::QUOTE);
+    quote.header.message_length = sizeof(quote);
+    quote.symbol_id = 1;
+    quote.bid_price = 100.0;
+    quote.ask_price = 100.5;
+
+    std::vector<uint8_t> f(feed::ZeroCopyFeedHandler<OrderBookReconstructor>::UDP_PAYLOAD_OFFSET + sizeof(quote));
+    for (uint32_t seq = 1; seq <= 100; ++seq) {
+        quote.header.sequence_number = seq;
+        std::memcpy(f.data() + 42, &quote, sizeof(quote));
+        ASSERT_TRUE(nic_.loopback_rx(f.data(), f.size()));
+    }
+
+    const uint64_t writes = nic_.mmio_writes();
+    EXPECT_EQ(handler.poll(nic_, 70), 70u);
+    EXPECT_EQ(handler.poll(nic_, 70), 30u);
+    EXPECT_EQ(handler.stats().quotes, 100u);
+    EXPECT_EQ(handler.stats().sequence_gaps, 0u);
+    EXPECT_LE(nic_.mmio_writes() - writes, 4u);              // 32+32+6, 30: one per burst
+
+    for (int i = 0; i < 50; ++i) ASSERT_TRUE(nic_.loopback_rx(f.data(), f.size()));
+    size_t seen = 0;
+    EXPECT_EQ(nic_.busy_wait_n_packets([&](const uint8_t*, size_t len) {
+        EXPECT_EQ(len, f.size());
+        ++seen;
+    }, 50), 50u);
+    EXPECT_EQ(seen, 50u);
+
+    network::SolarflareEFVI vi;
+    ASSERT_TRUE(vi.initialize("eth0"));
+    network::efvi_packet pkts[8];
+    EXPECT_EQ(vi.rx_burst(pkts, 8), 8u);
+    const network::efvi_tx_packet tx{f.data(), f.size()};
+    EXPECT_EQ(vi.tx_burst(&tx, 1), 1u);
+}
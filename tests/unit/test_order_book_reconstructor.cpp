@@ -0,0 +1,540 @@
+#include <gtest/gtest.h>
+#include "order_book_reconstructor.hpp"
+#include <array>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+hft::OrderBookUpdate make_update(hft::UpdateType type, uint64_t id, double price,
+                                 double qty, bool is_bid, uint64_t seq) {
+    hft::OrderBookUpdate u;
+    u.type = type;
+    u.order_id = id;
+    u.price = price;
+    u.quantity = qty;
+    u.is_bid = is_bid;
+    u.sequence_number = seq;
+    u.timestamp_ns = static_cast<int64_t>(seq) * 1000;
+    return u;
+}
+
+using SmallFlatBackend = hft::FlatBookBackend<1024, 1024>;
+
+template<typename Backend>
+class OrderBookReconstructorTest : public ::testing::Test {
+protected:
+    hft::BasicOrderBookReconstructor<Backend> book_{"TEST", 100, make_backend()};
+    uint64_t seq_ = 0;
+
+    static Backend make_backend();
+
+    bool apply(hft::UpdateType type, uint64_t id, double price, double qty, bool is_bid) {
+        return book_.process_update(make_update(type, id, price, qty, is_bid, ++seq_));
+    }
+};
+
+template<>
+hft::MapBookBackend OrderBookReconstructorTest<hft::MapBookBackend>::make_backend() {
+    return hft::MapBookBackend();
+}
+
+template<>
+SmallFlatBackend OrderBookReconstructorTest<SmallFlatBackend>::make_backend() {
+    return SmallFlatBackend(0.01, 100.0);
+}
+
+using Backends = ::testing::Types<hft::MapBookBackend, SmallFlatBackend>;
+TYPED_TEST_SUITE(OrderBookReconstructorTest, Backends);
+
+// Test add builds aggregated levels and BBO
+TYPED_TEST(OrderBookReconstructorTest, AddOrders) {
+    using hft::UpdateType;
+    EXPECT_TRUE(this->apply(UpdateType::ADD, 1, 99.99, 100, true));
+    EXPECT_TRUE(this->apply(UpdateType::ADD, 2, 99.99, 50, true));
+    EXPECT_TRUE(this->apply(UpdateType::ADD, 3, 99.98, 70, true));
+    EXPECT_TRUE(this->apply(UpdateType::ADD, 4, 100.01, 80, false));
+
+    auto [bid, ask] = this->book_.get_top_of_book();
+    ASSERT_TRUE(bid.has_value());
+    ASSERT_TRUE(ask.has_value());
+    EXPECT_NEAR(bid->price, 99.99, 1e-9);
+    EXPECT_DOUBLE_EQ(bid->quantity, 150.0);
+    EXPECT_EQ(bid->order_count, 2u);
+    EXPECT_NEAR(ask->price, 100.01, 1e-9);
+
+    auto [bids, asks] = this->book_.get_depth(10);
+    ASSERT_EQ(bids.size(), 2u);
+    ASSERT_EQ(asks.size(), 1u);
+    EXPECT_NEAR(bids[1].price, 99.98, 1e-9);
+
+    auto stats = this->book_.get_statistics();
+    EXPECT_EQ(stats.total_updates, 4u);
+    EXPECT_EQ(stats.current_bid_levels, 2u);
+    EXPECT_NEAR(stats.last_mid_price, 100.0, 1e-9);
+}
+
+// Test delete removes quantity and empty levels
+TYPED_TEST(OrderBookReconstructorTest, DeleteOrders) {
+    using hft::UpdateType;
+    this->apply(UpdateType::ADD, 1, 99.99, 100, true);
+    this->apply(UpdateType::ADD, 2, 99.98, 50, true);
+    EXPECT_TRUE(this->apply(UpdateType::DELETE, 1, 0.0, 0.0, true));
+
+    auto [bid, ask] = this->book_.get_top_of_book();
+    ASSERT_TRUE(bid.has_value());
+    EXPECT_FALSE(ask.has_value());
+    EXPECT_NEAR(bid->price, 99.98, 1e-9);
+
+    // Unknown order is rejected
+    EXPECT_FALSE(this->apply(UpdateType::DELETE, 42, 0.0, 0.0, true));
+}
+
+// Test modify moves quantity between levels
+TYPED_TEST(OrderBookReconstructorTest, ModifyOrder) {
+    using hft::UpdateType;
+    this->apply(UpdateType::ADD, 1, 100.02, 100, false);
+    this->apply(UpdateType::ADD, 2, 100.03, 100, false);
+    EXPECT_TRUE(this->apply(UpdateType::MODIFY, 2, 100.01, 40, false));
+
+    auto [bids, asks] = this->book_.get_depth(10);
+    ASSERT_EQ(asks.size(), 2u);
+    EXPECT_NEAR(asks[0].price, 100.01, 1e-9);
+    EXPECT_DOUBLE_EQ(asks[0].quantity, 40.0);
+    EXPECT_NEAR(asks[1].price, 100.02, 1e-9);
+}
+
+// Test partial and full executions
+TYPED_TEST(OrderBookReconstructorTest, ExecuteOrder) {
+    using hft::UpdateType;
+    this->apply(UpdateType::ADD, 1, 99.99, 100, true);
+    EXPECT_TRUE(this->apply(UpdateType::EXECUTE, 1, 99.99, 30, true));
+
+    auto [bid, ask] = this->book_.get_top_of_book();
+    ASSERT_TRUE(bid.has_value());
+    EXPECT_DOUBLE_EQ(bid->quantity, 70.0);
+
+    EXPECT_TRUE(this->apply(UpdateType::EXECUTE, 1, 99.99, 70, true));
+    EXPECT_FALSE(this->book_.get_top_of_book().first.has_value());
+
+    // Untracked execution feeds pressure metrics
+    EXPECT_TRUE(this->apply(UpdateType::EXECUTE, 99, 100.0, 25, true));
+    EXPECT_DOUBLE_EQ(this->book_.get_current_ofi().buy_pressure, 25.0);
+}
+
+// Test deep OFI on top-of-book change
+TYPED_TEST(OrderBookReconstructorTest, DeepOFI) {
+    using hft::UpdateType;
+    this->apply(UpdateType::ADD, 1, 99.99, 100, true);
+    this->apply(UpdateType::ADD, 2, 100.01, 100, false);
+    this->apply(UpdateType::ADD, 3, 99.99, 50, true);
+
+    auto ofi = this->book_.get_current_ofi();
+    EXPECT_DOUBLE_EQ(ofi.bid_ofi[0], 50.0);
+    EXPECT_DOUBLE_EQ(ofi.top_1_ofi, 50.0);
+    EXPECT_DOUBLE_EQ(ofi.volume_imbalance, (150.0 - 100.0) / 250.0);
+    EXPECT_NEAR(ofi.mid_price, 100.0, 1e-9);
+    EXPECT_NEAR(ofi.bid_ask_spread, 0.02, 1e-9);
+
+    // Levels are matched by price: clearing the best bid counts only its
+    // last 50 as gone, not a shift of every level below it
+    this->apply(UpdateType::ADD, 4, 99.98, 40, true);
+    this->apply(UpdateType::ADD, 5, 99.97, 70, true);
+    this->apply(UpdateType::DELETE, 1, 0, 0, true);
+    this->apply(UpdateType::DELETE, 3, 0, 0, true);
+    ofi = this->book_.get_current_ofi();
+    EXPECT_DOUBLE_EQ(ofi.bid_ofi[0], -50.0);
+    EXPECT_DOUBLE_EQ(ofi.bid_ofi[1], 0.0);
+    EXPECT_DOUBLE_EQ(ofi.total_ofi, -50.0);
+
+    // A new best bid counts its whole size
+    this->apply(UpdateType::ADD, 6, 100.00, 30, true);
+    ofi = this->book_.get_current_ofi();
+    EXPECT_DOUBLE_EQ(ofi.top_1_ofi, 30.0);
+    EXPECT_DOUBLE_EQ(ofi.bid_ofi[1], 0.0);
+    EXPECT_DOUBLE_EQ(ofi.total_ofi, 30.0);
+}
+
+// Test snapshot load and sequence gap detection
+TYPED_TEST(OrderBookReconstructorTest, SnapshotAndGap) {
+    hft::OrderBookSnapshot snapshot;
+    snapshot.bids.emplace_back(99.99, 500, 5);
+    snapshot.bids.emplace_back(99.98, 300, 3);
+    snapshot.asks.emplace_back(100.01, 400, 4);
+    snapshot.sequence_number = 100;
+
+    EXPECT_TRUE(this->book_.initialize_from_snapshot(snapshot));
+    auto [bid, ask] = this->book_.get_top_of_book();
+    ASSERT_TRUE(bid.has_value());
+    EXPECT_DOUBLE_EQ(bid->quantity, 500.0);
+
+    EXPECT_TRUE(this->book_.process_update(
+        make_update(hft::UpdateType::ADD, 1, 99.99, 10, true, 101)));
+    EXPECT_FALSE(this->book_.process_update(
+        make_update(hft::UpdateType::ADD, 2, 99.99, 10, true, 105)));
+    EXPECT_TRUE(this->book_.needs_snapshot_recovery());
+    EXPECT_EQ(this->book_.get_statistics().missed_updates, 3u);
+}
+
+// Test seqlock depth snapshot tracks the book
+TYPED_TEST(OrderBookReconstructorTest, DepthSnapshotPublished) {
+    using hft::UpdateType;
+    const uint64_t v0 = this->book_.snapshot_version();
+    this->apply(UpdateType::ADD, 1, 99.99, 100, true);
+    this->apply(UpdateType::ADD, 2, 99.97, 60, true);
+    this->apply(UpdateType::ADD, 3, 100.02, 80, false);
+
+    hft::DepthSnapshot snap = this->book_.get_depth_snapshot();
+    EXPECT_EQ(this->book_.snapshot_version(), v0 + 3);
+    EXPECT_EQ(snap.sequence_number, 3u);
+    ASSERT_EQ(snap.bid_levels, 2u);
+    ASSERT_EQ(snap.ask_levels, 1u);
+    EXPECT_NEAR(snap.bid_prices[1], 99.97, 1e-9);
+    EXPECT_DOUBLE_EQ(snap.bid_quantities[1], 60.0);
+    EXPECT_NEAR(snap.ask_prices[0], 100.02, 1e-9);
+    EXPECT_NEAR(snap.ofi.mid_price, 100.005, 1e-9);
+
+    int calls = 0;
+    EXPECT_TRUE(this->book_.register_deep_state_callback(
+        [&](const hft::DeepOFIFeatures&) { ++calls; }));
+    this->apply(UpdateType::DELETE, 3, 0.0, 0.0, false);
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(this->book_.get_depth_snapshot().ask_levels, 0u);
+}
+
+// Test a gap buffers updates, the snapshot is staged on another thread and
+// the feed thread swaps it in with the buffered updates replayed
+TYPED_TEST(OrderBookReconstructorTest, AsyncSnapshotRecovery) {
+    using hft::UpdateType;
+    using hft::BookRecoveryState;
+    auto& book = this->book_;
+    book.enable_async_recovery();
+    hft::OrderBookSnapshot initial;
+    initial.bids.emplace_back(99.99, 100, 1);
+    initial.asks.emplace_back(100.01, 80, 1);
+    initial.sequence_number = 2;
+    book.initialize_from_snapshot(initial);
+
+    // 3-4 lost; 5-7 arrive while the snapshot is fetched
+    EXPECT_FALSE(book.process_update(make_update(UpdateType::ADD, 3, 99.98, 40, true, 5)));
+    EXPECT_TRUE(book.needs_snapshot_recovery());
+    EXPECT_EQ(book.recovery_state(), BookRecoveryState::BUFFERING);
+    EXPECT_FALSE(book.process_update(make_update(UpdateType::ADD, 4, 99.97, 30, true, 6)));
+    EXPECT_FALSE(book.process_update(make_update(UpdateType::MODIFY, 4, 99.97, 10, true, 7)));
+
+    hft::OrderBookSnapshot stale;
+    stale.sequence_number = 3;
+    EXPECT_FALSE(book.recover_from_snapshot(stale));
+    EXPECT_EQ(book.recovery_state(), BookRecoveryState::BUFFERING);
+
+    hft::OrderBookSnapshot snapshot;
+    snapshot.bids.emplace_back(99.99, 100, 1);
+    snapshot.bids.emplace_back(99.98, 40, 1);
+    snapshot.asks.emplace_back(100.02, 60, 2);
+    snapshot.sequence_number = 5;
+    bool staged = false;
+    std::thread recovery([&] { staged = book.recover_from_snapshot(snapshot); });
+    recovery.join();
+    EXPECT_TRUE(staged);
+    EXPECT_EQ(book.recovery_state(), BookRecoveryState::STAGED);
+    EXPECT_NEAR(book.get_top_of_book().second->price, 100.01, 1e-9);  // Old book until the swap
+
+    EXPECT_TRUE(book.process_update(make_update(UpdateType::ADD, 5, 100.03, 20, false, 8)));
+    EXPECT_FALSE(book.needs_snapshot_recovery());
+    EXPECT_EQ(book.recovery_state(), BookRecoveryState::IDLE);
+    EXPECT_EQ(book.recoveries(), 1u);
+    EXPECT_EQ(book.last_sequence_number(), 8u);
+
+    auto [bids, asks] = book.get_depth(5);
+    ASSERT_EQ(bids.size(), 3u);
+    ASSERT_EQ(asks.size(), 2u);
+    EXPECT_DOUBLE_EQ(bids[1].quantity, 40.0);
+    EXPECT_DOUBLE_EQ(bids[2].quantity, 10.0);
+    EXPECT_NEAR(asks[0].price, 100.02, 1e-9);
+    EXPECT_EQ(book.get_depth_snapshot().sequence_number, 8u);
+}
+
+// Test a ring overflow drops the staged book and asks for a snapshot that
+// also covers everything discarded
+TYPED_TEST(OrderBookReconstructorTest, AsyncRecoveryRestartsOnOverflow) {
+    using hft::UpdateType;
+    using Book = hft::BasicOrderBookReconstructor<TypeParam>;
+    auto& book = this->book_;
+    book.enable_async_recovery();
+    hft::OrderBookSnapshot snapshot;
+    snapshot.bids.emplace_back(99.99, 100, 1);
+    snapshot.sequence_number = 1;
+    book.initialize_from_snapshot(snapshot);
+
+    // Gap at 2, then more updates than the ring holds
+    const uint64_t last = 2 + Book::RECOVERY_BUFFER_SIZE;
+    for (uint64_t seq = 3; seq <= last; ++seq) {
+        book.process_update(make_update(UpdateType::ADD, seq, 99.98, 1, true, seq));
+    }
+
+    snapshot.sequence_number = 2;
+    EXPECT_FALSE(book.recover_from_snapshot(snapshot));
+    EXPECT_FALSE(book.poll_recovery());
+    EXPECT_EQ(book.recovery_restarts(), 1u);
+    EXPECT_EQ(book.recovery_state(), hft::BookRecoveryState::BUFFERING);
+
+    EXPECT_FALSE(book.recover_from_snapshot(snapshot));
+    snapshot.sequence_number = last;
+    EXPECT_TRUE(book.recover_from_snapshot(snapshot));
+    EXPECT_TRUE(book.poll_recovery());
+    EXPECT_EQ(book.last_sequence_number(), last);
+    EXPECT_EQ(book.get_depth(5).first.size(), 1u);
+}
+
+// Test the SoA top-50 mirror follows a random L3 stream exactly, and the
+// OFI computed from it matches a price lookup over the backend's levels
+TYPED_TEST(OrderBookReconstructorTest, DeepMirrorMatchesBackend) {
+    using hft::UpdateType;
+    using Book = hft::BasicOrderBookReconstructor<TypeParam>;
+    constexpr size_t N = Book::MAX_OFI_LEVELS;
+    auto& book = this->book_;
+    book.set_ofi_depth(N);
+    ASSERT_EQ(book.ofi_depth(), N);
+
+    // Backend top N, zero-padded, like the mirror
+    struct SideLevels { std::array<double, N> price{}, qty{}; };
+    auto levels = [&](SideLevels& bids, SideLevels& asks) {
+        bids = SideLevels{};
+        asks = SideLevels{};
+        book.backend().for_each_bid(N, [&](size_t i, const hft::PriceLevel& l) {
+            bids.price[i] = l.price;
+            bids.qty[i] = l.quantity;
+        });
+        book.backend().for_each_ask(N, [&](size_t i, const hft::PriceLevel& l) {
+            asks.price[i] = l.price;
+            asks.qty[i] = l.quantity;
+        });
+    };
+    // Reference OFI by price lookup: change at each current level, less
+    // previous levels no longer in the top N
+    auto level_ofi = [](const SideLevels& prev, const SideLevels& cur, std::array<double, N>& ofi,
+                        std::array<double, N>& change) {
+        auto find = [](const SideLevels& side, double price) {
+            for (size_t i = 0; i < N; ++i) {
+                if (side.qty[i] > 0.0 && side.price[i] == price) return side.qty[i];
+            }
+            return 0.0;
+        };
+        for (size_t i = 0; i < N; ++i) {
+            change[i] = cur.qty[i] > 0.0 ? cur.qty[i] - find(prev, cur.price[i]) : 0.0;
+            const bool gone = prev.qty[i] > 0.0 && find(cur, prev.price[i]) == 0.0;
+            ofi[i] = change[i] - (gone ? prev.qty[i] : 0.0);
+        }
+    };
+
+    struct Live { uint64_t id; bool is_bid; double qty; };
+    std::vector<Live> live;
+    std::mt19937 rng(11);
+    uint64_t next_id = 1;
+    SideLevels prev_bids, prev_asks, bids, asks;
+
+    for (int step = 0; step < 3000; ++step) {
+        const int pick = static_cast<int>(rng() % 10);
+        const bool is_bid = rng() & 1;
+        const int tick = static_cast<int>(rng() % 70);          // 70 levels a side, 50 mirrored
+        const double price = is_bid ? 99.99 - 0.01 * tick : 100.01 + 0.01 * tick;
+        const double qty = static_cast<double>(1 + rng() % 100);
+        bool ok;
+        if (live.empty() || (pick < 5 && live.size() < 600)) {
+            ok = this->apply(UpdateType::ADD, next_id, price, qty, is_bid);
+            live.push_back({next_id++, is_bid, qty});
+        } else {
+            const size_t k = rng() % live.size();
+            const Live order = live[k];
+            const double order_price = order.is_bid ? 99.99 - 0.01 * tick : 100.01 + 0.01 * tick;
+            if (pick < 7) {
+                ok = this->apply(UpdateType::MODIFY, order.id, order_price, qty, order.is_bid);
+                live[k].qty = qty;
+            } else if (pick < 9) {
+                ok = this->apply(UpdateType::DELETE, order.id, 0.0, 0.0, order.is_bid);
+                live.erase(live.begin() + static_cast<long>(k));
+            } else {
+                // A full fill drops the order
+                ok = this->apply(UpdateType::EXECUTE, order.id, 0.0, std::min(5.0, order.qty), order.is_bid);
+                live[k].qty -= 5.0;
+                if (live[k].qty <= 0.0) live.erase(live.begin() + static_cast<long>(k));
+            }
+        }
+        ASSERT_TRUE(ok) << step;
+
+        levels(bids, asks);
+        const auto& mirror = book.top_levels();
+        ASSERT_EQ(mirror.num_bid_levels, std::min(N, book.backend().bid_level_count())) << step;
+        ASSERT_EQ(mirror.num_ask_levels, std::min(N, book.backend().ask_level_count())) << step;
+        book.backend().for_each_bid(N, [&](size_t i, const hft::PriceLevel& l) {
+            ASSERT_EQ(mirror.bid_prices[i], l.price);
+            ASSERT_EQ(mirror.bid_order_counts[i], l.order_count);
+        });
+        book.backend().for_each_ask(N, [&](size_t i, const hft::PriceLevel& l) {
+            ASSERT_EQ(mirror.ask_prices[i], l.price);
+        });
+        ASSERT_EQ(mirror.bid_quantities, bids.qty) << step;
+        ASSERT_EQ(mirror.ask_quantities, asks.qty) << step;
+
+        std::array<double, N> bid_ofi, ask_ofi, bid_change, ask_change;
+        level_ofi(prev_bids, bids, bid_ofi, bid_change);
+        level_ofi(prev_asks, asks, ask_ofi, ask_change);
+        double total = 0.0, weighted = 0.0, volume = 0.0;
+        for (size_t i = 0; i < N; ++i) {
+            total += bid_ofi[i] - ask_ofi[i];
+            weighted += bid_change[i] * bids.qty[i] - ask_change[i] * asks.qty[i];
+            volume += bids.qty[i] + asks.qty[i];
+        }
+        const hft::DeepOFIFeatures ofi = book.get_current_ofi();
+        EXPECT_NEAR(ofi.total_ofi, total, 1e-9) << step;
+        EXPECT_NEAR(ofi.weighted_ofi, volume > 0.0 ? weighted / volume : 0.0, 1e-9) << step;
+        for (size_t i = 0; i < hft::DeepOFIFeatures::DETAIL_LEVELS; ++i) {
+            EXPECT_DOUBLE_EQ(ofi.bid_ofi[i], bid_ofi[i]) << step << " " << i;
+            EXPECT_DOUBLE_EQ(ofi.ask_ofi[i], ask_ofi[i]) << step << " " << i;
+        }
+        EXPECT_DOUBLE_EQ(ofi.top_1_ofi, bid_ofi[0] - ask_ofi[0]);
+        prev_bids = bids;
+        prev_asks = asks;
+    }
+
+    // The published top 10 comes from the mirror too
+    const hft::DepthSnapshot snap = book.get_depth_snapshot();
+    for (size_t i = 0; i < hft::DepthSnapshot::MAX_LEVELS; ++i) {
+        EXPECT_EQ(snap.bid_quantities[i], bids.qty[i]);
+        EXPECT_EQ(snap.ask_quantities[i], asks.qty[i]);
+    }
+}
+
+// Test pressure keeps only the last 1000 aggressive trades, and the
+// microprice/spread volatilities come from the rolling BBO windows
+TYPED_TEST(OrderBookReconstructorTest, PressureAndVolatilityWindows) {
+    using hft::UpdateType;
+    for (int i = 1; i <= 1200; ++i) {
+        this->apply(UpdateType::EXECUTE, 100000 + i, 100.0, i, true);
+    }
+    auto ofi = this->book_.get_current_ofi();
+    EXPECT_DOUBLE_EQ(ofi.buy_pressure, 1200.0 * 1201.0 / 2.0 - 200.0 * 201.0 / 2.0);
+    EXPECT_DOUBLE_EQ(ofi.sell_pressure, 0.0);
+    EXPECT_DOUBLE_EQ(ofi.microprice_volatility, 0.0);     // One-sided book: no samples
+
+    // Weighted mid alternates 100.0 / 100.005, the spread stays 0.02
+    this->apply(UpdateType::ADD, 1, 99.99, 100, true);
+    this->apply(UpdateType::ADD, 2, 100.01, 100, false);
+    for (int i = 0; i < 300; ++i) {
+        this->apply(UpdateType::MODIFY, 2, 100.01, i % 2 ? 100 : 300, false);
+        this->apply(UpdateType::MODIFY, 2, 100.01, i % 2 ? 300 : 100, false);
+    }
+    ofi = this->book_.get_current_ofi();
+    EXPECT_NEAR(ofi.microprice_volatility, 0.0025, 1e-9);
+    EXPECT_NEAR(ofi.spread_volatility, 0.0, 1e-9);
+    EXPECT_NEAR(ofi.bid_ask_spread, 0.02, 1e-9);
+}
+
+// Test readers never observe a torn seqlock payload
+TEST(SeqlockTest, ConcurrentReadersSeeConsistentPayload) {
+    struct Payload {
+        uint64_t a;
+        uint64_t b;
+        double pad[14];
+    };
+    hft::Seqlock<Payload> lock;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0};
+
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            const Payload p = lock.load();
+            if (p.a != p.b) torn.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    for (uint64_t i = 1; i <= 200000; ++i) {
+        Payload p{};
+        p.a = i;
+        p.b = i;
+        lock.store(p);
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_EQ(lock.version(), 200000u);
+    EXPECT_EQ(lock.load().a, 200000u);
+}
+
+// Test FIFO order and queue position rules of the flat backend
+TEST(FlatBookBackendTest, LevelFifoOrder) {
+    SmallFlatBackend book(0.01, 100.0);
+    book.add(make_update(hft::UpdateType::ADD, 1, 99.99, 10, true, 1));
+    book.add(make_update(hft::UpdateType::ADD, 2, 99.99, 20, true, 2));
+    book.add(make_update(hft::UpdateType::ADD, 3, 99.99, 30, true, 3));
+
+    // Size down keeps position, size up requeues at the tail
+    book.modify(make_update(hft::UpdateType::MODIFY, 1, 99.99, 5, true, 4));
+    book.modify(make_update(hft::UpdateType::MODIFY, 2, 99.99, 25, true, 5));
+
+    std::vector<uint64_t> ids;
+    book.for_each_order_at(true, 99.99, [&](uint64_t id, double) { ids.push_back(id); });
+    EXPECT_EQ(ids, (std::vector<uint64_t>{1, 3, 2}));
+
+    hft::PriceLevel level;
+    ASSERT_TRUE(book.best_bid(level));
+    EXPECT_DOUBLE_EQ(level.quantity, 60.0);
+    EXPECT_DOUBLE_EQ(book.total_bid_volume(), 60.0);
+}
+
+// Test a size-down to zero frees the order, so the level's FIFO and count
+// stay right for orders added after it
+TEST(FlatBookBackendTest, ModifyToZeroFreesOrder) {
+    SmallFlatBackend book(0.01, 100.0);
+    ASSERT_TRUE(book.add(make_update(hft::UpdateType::ADD, 1, 99.99, 10, true, 1)));
+    ASSERT_TRUE(book.modify(make_update(hft::UpdateType::MODIFY, 1, 99.99, 0, true, 2)));
+    EXPECT_EQ(book.live_orders(), 0u);
+    EXPECT_EQ(book.bid_level_count(), 0u);
+
+    ASSERT_TRUE(book.add(make_update(hft::UpdateType::ADD, 2, 99.99, 20, true, 3)));
+    EXPECT_FALSE(book.remove(make_update(hft::UpdateType::DELETE, 1, 0, 0, true, 4)));
+
+    std::vector<uint64_t> ids;
+    book.for_each_order_at(true, 99.99, [&](uint64_t id, double) { ids.push_back(id); });
+    EXPECT_EQ(ids, (std::vector<uint64_t>{2}));
+    hft::PriceLevel level;
+    ASSERT_TRUE(book.best_bid(level));
+    EXPECT_DOUBLE_EQ(level.quantity, 20.0);
+    EXPECT_EQ(level.order_count, 1u);
+    EXPECT_DOUBLE_EQ(book.total_bid_volume(), 20.0);
+}
+
+// Test order pool and id table reuse under churn
+TEST(FlatBookBackendTest, PoolReuseUnderChurn) {
+    SmallFlatBackend book(0.01, 100.0);
+
+    for (uint64_t round = 0; round < 8; ++round) {
+        for (uint64_t i = 0; i < 1024; ++i) {
+            const uint64_t id = round * 1024 + i;
+            ASSERT_TRUE(book.add(make_update(hft::UpdateType::ADD, id,
+                99.00 + (i % 50) * 0.01, 1, true, id)));
+        }
+        // Pool is full
+        EXPECT_FALSE(book.add(make_update(hft::UpdateType::ADD, 1 << 30, 99.5, 1, true, 0)));
+        for (uint64_t i = 0; i < 1024; ++i) {
+            ASSERT_TRUE(book.remove(make_update(hft::UpdateType::DELETE,
+                round * 1024 + i, 0, 0, true, 0)));
+        }
+        EXPECT_EQ(book.live_orders(), 0u);
+        EXPECT_EQ(book.bid_level_count(), 0u);
+    }
+}
+
+// Test out-of-window prices are rejected
+TEST(FlatBookBackendTest, OutOfWindow) {
+    SmallFlatBackend book(0.01, 100.0);
+    EXPECT_FALSE(book.add(make_update(hft::UpdateType::ADD, 1, 150.0, 10, false, 1)));
+    EXPECT_TRUE(book.add(make_update(hft::UpdateType::ADD, 2, 100.5, 10, false, 2)));
+    EXPECT_FALSE(book.modify(make_update(hft::UpdateType::MODIFY, 2, 50.0, 10, false, 3)));
+    EXPECT_EQ(book.ask_level_count(), 1u);
+}
+
+} // namespace
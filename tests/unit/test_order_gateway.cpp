@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "order_gateway.hpp"
+
+using namespace hft;
+using namespace hft::preserialized;
+using gateway::OrderGateway;
+
+namespace {
+
+// Records every packet; can be made to refuse buffers or one send
+class CaptureTransport {
+public:
+    explicit CaptureTransport(size_t capacity = 1400) : buffer_(capacity) {}
+
+    uint8_t* acquire(size_t& capacity) {
+        if (!available) return nullptr;
+        capacity = buffer_.size();
+        return buffer_.data();
+    }
+
+    bool transmit(size_t len) {
+        if (attempts++ == fail_attempt) return false;
+        packets.emplace_back(buffer_.begin(), buffer_.begin() + len);
+        return true;
+    }
+
+    // Every message in every packet, in wire order
+    std::vector<const OrderMessageHeader*> messages() const {
+        std::vector<const OrderMessageHeader*> out;
+        for (const auto& p : packets) {
+            for (size_t at = 0; at < p.size();) {
+                const auto* h = reinterpret_cast<const OrderMessageHeader*>(p.data() + at);
+                out.push_back(h);
+                at += h->message_length;
+            }
+        }
+        return out;
+    }
+
+    bool available = true;
+    size_t attempts = 0;
+    size_t fail_attempt = SIZE_MAX;     // Zero-based transmit() call to refuse
+    std::vector<std::vector<uint8_t>> packets;
+
+private:
+    std::vector<uint8_t> buffer_;
+};
+
+// Client 7, session 9; symbols 1 and 2 have templates
+void load_symbols(OrderTemplatePool& pool) {
+    pool.initialize_symbol_templates(1, "BTCUSD");
+    pool.initialize_symbol_templates(2, "ETHUSD");
+}
+
+}
+
+// Test intents from several strategies are coalesced into one packet, each
+// message sequenced and carrying its strategy's own order-ID block
+TEST(OrderGatewayTest, CoalescesMessagesPerPacket) {
+    OrderTemplatePool pool(7, 9, 4);
+    load_symbols(pool);
+    CaptureTransport transport;
+    OrderGateway<CaptureTransport> gw(pool, transport);
+    auto alpha = gw.port(1);
+    auto beta = gw.port(2);
+    EXPECT_THROW(gw.port(1), std::invalid_argument);
+
+    const uint64_t a1 = alpha.send_limit(1, Side::BUY, 100.0, 2.0);
+    const uint64_t b1 = beta.send_limit(2, Side::SELL, 50.0, 1.0, 1);
+    const uint64_t a2 = alpha.send_limit(1, Side::BUY, 99.5, 3.0);
+    EXPECT_EQ(OrderIdBlock::strategy_of(a1), 1u);
+    EXPECT_EQ(OrderIdBlock::strategy_of(b1), 2u);
+    EXPECT_EQ(a2, a1 + 1);
+    alpha.cancel(1, a1);
+
+    EXPECT_EQ(gw.poll(), 4u);
+    ASSERT_EQ(transport.packets.size(), 1u);
+    const auto msgs = transport.messages();
+    ASSERT_EQ(msgs.size(), 4u);
+    for (size_t i = 0; i < msgs.size(); ++i) EXPECT_EQ(msgs[i]->sequence_number, i + 1);
+
+    const auto* first = reinterpret_cast<const BinaryNewOrderMessage*>(msgs[0]);
+    EXPECT_EQ(first->header.message_type, NEW_ORDER);
+    EXPECT_EQ(first->client_order_id, a1);
+    EXPECT_EQ(first->symbol_id, 1u);
+    EXPECT_DOUBLE_EQ(first->price, 100.0);
+    EXPECT_EQ(reinterpret_cast<const BinaryNewOrderMessage*>(msgs[1])->time_in_force, 1);
+
+    const auto* cancel = reinterpret_cast<const BinaryCancelOrderMessage*>(msgs[3]);
+    EXPECT_EQ(cancel->header.message_type, CANCEL_ORDER);
+    EXPECT_EQ(cancel->original_order_id, a1);
+    EXPECT_EQ(OrderIdBlock::strategy_of(cancel->client_order_id), 1u);
+    EXPECT_EQ(gw.poll(), 0u);
+}
+
+// Test cancel/replace is one message, unknown symbols are rejected, packets
+// split at the transport's size, and a busy transport leaves intents queued
+TEST(OrderGatewayTest, CancelReplaceAndBackpressure) {
+    OrderTemplatePool pool(7, 9, 4);
+    load_symbols(pool);
+    CaptureTransport transport(3 * sizeof(BinaryNewOrderMessage));
+    OrderGateway<CaptureTransport> gw(pool, transport);
+    auto port = gw.port(5);
+
+    const uint64_t original = port.send_limit(2, Side::BUY, 10.0, 4.0);
+    const uint64_t replacement = port.replace(2, original, Side::BUY, 10.25, 5.0);
+    port.send_limit(3, Side::BUY, 1.0, 1.0);                 // no templates
+    for (int i = 0; i < 4; ++i) port.send_limit(1, Side::SELL, 20.0 + i, 1.0);
+
+    transport.available = false;
+    EXPECT_EQ(gw.poll(), 0u);
+    EXPECT_EQ(gw.stats().intents, 0u);
+
+    transport.available = true;
+    EXPECT_EQ(gw.poll(), 6u);
+    EXPECT_EQ(gw.stats().rejected, 1u);
+    EXPECT_EQ(gw.stats().packets, transport.packets.size());
+    EXPECT_GT(transport.packets.size(), 1u);
+    for (const auto& p : transport.packets) EXPECT_LE(p.size(), 3 * sizeof(BinaryNewOrderMessage));
+
+    const auto msgs = transport.messages();
+    ASSERT_EQ(msgs.size(), 6u);
+    const auto* replace = reinterpret_cast<const BinaryCancelReplaceMessage*>(msgs[1]);
+    EXPECT_EQ(replace->header.message_type, CANCEL_REPLACE);
+    EXPECT_EQ(replace->header.message_length, sizeof(BinaryCancelReplaceMessage));
+    EXPECT_EQ(replace->client_order_id, replacement);
+    EXPECT_EQ(replace->original_order_id, original);
+    EXPECT_DOUBLE_EQ(replace->price, 10.25);
+    EXPECT_DOUBLE_EQ(replace->quantity, 5.0);
+    EXPECT_EQ(replace->header.client_id, 7u);
+    EXPECT_EQ(msgs.back()->sequence_number, 6u);
+
+    // ef_vi: serialized straight into the TX ring behind a frame header
+    network::SolarflareEFVI vi;
+    ASSERT_TRUE(vi.initialize("eth0"));
+    const uint8_t eth[42] = {0xFF};
+    gateway::EfviTransport efvi(vi, eth, sizeof(eth));
+    OrderGateway<gateway::EfviTransport> efvi_gw(pool, efvi);
+    auto efvi_port = efvi_gw.port(0);
+    uint8_t* frame = vi.tx_buffer();
+    efvi_port.send_limit(1, Side::BUY, 1.5, 2.0);
+    ASSERT_EQ(efvi_gw.poll(), 1u);
+    EXPECT_EQ(frame[0], 0xFF);
+    EXPECT_EQ(reinterpret_cast<const BinaryNewOrderMessage*>(frame + 42)->price, 1.5);
+    EXPECT_NE(vi.tx_buffer(), frame);
+}
+
+// Test a refused packet gives back its sequence numbers and its intents
+// go out first on the next poll, so the venue sees no gap and no order is lost
+TEST(OrderGatewayTest, RefusedPacketIsRetried) {
+    OrderTemplatePool pool(7, 9, 4);
+    load_symbols(pool);
+    CaptureTransport transport(3 * sizeof(BinaryNewOrderMessage));
+    OrderGateway<CaptureTransport> gw(pool, transport);
+    auto port = gw.port(3);
+
+    std::vector<uint64_t> ids;
+    for (int i = 0; i < 5; ++i) ids.push_back(port.send_limit(1, Side::BUY, 100.0 + i, 1.0));
+    ids.push_back(port.cancel(1, ids[0]));
+    ids.push_back(port.replace(1, ids[1], Side::BUY, 99.0, 2.0));
+
+    // Two messages per packet (room is kept for the largest message)
+    transport.fail_attempt = 1;             // Second packet
+    EXPECT_EQ(gw.poll(), 2u);
+    EXPECT_EQ(gw.sequence(), 2u);
+    EXPECT_EQ(gw.stats().send_failures, 2u);
+    EXPECT_EQ(gw.stats().intents, 2u);
+
+    EXPECT_EQ(gw.poll(), 5u);
+    EXPECT_EQ(gw.sequence(), 7u);
+    EXPECT_EQ(gw.stats().intents, 7u);
+    EXPECT_EQ(gw.stats().messages, 7u);
+
+    const auto msgs = transport.messages();
+    ASSERT_EQ(msgs.size(), ids.size());
+    for (size_t i = 0; i < msgs.size(); ++i) {
+        EXPECT_EQ(msgs[i]->sequence_number, i + 1);
+        EXPECT_EQ(reinterpret_cast<const BinaryNewOrderMessage*>(msgs[i])->client_order_id, ids[i]) << i;
+    }
+    EXPECT_EQ(msgs[5]->message_type, CANCEL_ORDER);
+    EXPECT_EQ(msgs[6]->message_type, CANCEL_REPLACE);
+    EXPECT_EQ(gw.poll(), 0u);
+}
+
+// Test strategies on their own threads feed a running gateway: nothing is
+// lost, sequence numbers are contiguous and each strategy's orders arrive in order
+TEST(OrderGatewayTest, ConcurrentStrategies) {
+    OrderTemplatePool pool(7, 9, 4);
+    load_symbols(pool);
+    CaptureTransport transport;
+    OrderGateway<CaptureTransport, 1024> gw(pool, transport);
+    constexpr int STRATEGIES = 4;
+    constexpr int PER_STRATEGY = 20000;
+
+    std::vector<OrderGateway<CaptureTransport, 1024>::StrategyPort> ports;
+    for (int s = 0; s < STRATEGIES; ++s) ports.push_back(gw.port(static_cast<uint16_t>(s + 1)));
+
+    gw.start();
+    std::vector<std::thread> strategies;
+    for (int s = 0; s < STRATEGIES; ++s) {
+        strategies.emplace_back([&, s] {
+            for (int i = 0; i < PER_STRATEGY; ++i) {
+                while (ports[s].send_limit(1 + (i & 1), Side::BUY, 100.0 + i, 1.0) == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : strategies) t.join();
+    gw.stop();
+
+    const auto msgs = transport.messages();
+    ASSERT_EQ(msgs.size(), static_cast<size_t>(STRATEGIES * PER_STRATEGY));
+    EXPECT_EQ(gw.stats().rejected, 0u);
+    EXPECT_LT(transport.packets.size(), msgs.size());
+
+    std::vector<uint64_t> last(STRATEGIES + 1, 0);
+    for (size_t i = 0; i < msgs.size(); ++i) {
+        ASSERT_EQ(msgs[i]->sequence_number, i + 1);
+        const auto* m = reinterpret_cast<const BinaryNewOrderMessage*>(msgs[i]);
+        const uint16_t s = OrderIdBlock::strategy_of(m->client_order_id);
+        ASSERT_GE(s, 1u);
+        ASSERT_LE(s, static_cast<uint16_t>(STRATEGIES));
+        ASSERT_GT(m->client_order_id, last[s]);
+        last[s] = m->client_order_id;
+    }
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+#include <stdexcept>
+#include "parameter_sweep.hpp"
+#include "synthetic_ticks.hpp"
+#include "work_stealing_pool.hpp"
+
+namespace {
+
+using hft::backtest::BacktestConfig;
+using hft::backtest::BacktestingEngine;
+using hft::backtest::ParameterSweep;
+using hft::backtest::SweepGrid;
+
+class ParameterSweepTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_data::write_mixed_csv(path_, 600);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    std::string path_ = "/tmp/test_parameter_sweep.csv";
+};
+
+}
+
+// Test every job runs once, including jobs submitted from other jobs
+TEST(WorkStealingPoolTest, RunsAllJobs) {
+    hft::WorkStealingPool pool(3);
+    std::atomic<int> count{0};
+    for (int i = 0; i < 50; ++i) {
+        pool.submit([&] {
+            count.fetch_add(1);
+            pool.submit([&] { count.fetch_add(1); });
+        });
+    }
+    pool.wait();
+    EXPECT_EQ(count.load(), 100);
+}
+
+// Test a failing job surfaces from wait() without losing the others
+TEST(WorkStealingPoolTest, PropagatesException) {
+    hft::WorkStealingPool pool(2);
+    std::atomic<int> count{0};
+    pool.submit([] { throw std::runtime_error("boom"); });
+    for (int i = 0; i < 10; ++i) {
+        pool.submit([&] { count.fetch_add(1); });
+    }
+    EXPECT_THROW(pool.wait(), std::runtime_error);
+    EXPECT_EQ(count.load(), 10);
+    pool.wait();  // Error is reported once
+}
+
+// Test the grid is a full cartesian product in row-major order
+TEST(SweepGridTest, Expand) {
+    SweepGrid grid;
+    grid.latency_ns = {100, 500};
+    grid.max_position = {10, 20, 30};
+    grid.seeds = SweepGrid::derived_seeds(42, 2);
+
+    BacktestConfig base;
+    base.commission_per_share = 0.001;
+    const auto points = grid.expand(base);
+
+    ASSERT_EQ(points.size(), 12u);
+    EXPECT_EQ(points[0].simulated_latency_ns, 100);
+    EXPECT_EQ(points[0].max_position, 10);
+    EXPECT_EQ(points[1].random_seed, grid.seeds[1]);
+    EXPECT_EQ(points[11].simulated_latency_ns, 500);
+    EXPECT_EQ(points[11].max_position, 30);
+    EXPECT_DOUBLE_EQ(points[5].commission_per_share, 0.001);
+    EXPECT_NE(grid.seeds[0], grid.seeds[1]);
+    EXPECT_EQ(SweepGrid::derived_seeds(42, 2), grid.seeds);
+}
+
+// Test parallel points reproduce a standalone run of the same config
+TEST_F(ParameterSweepTest, MatchesStandaloneRuns) {
+    ParameterSweep sweep(2);
+    ASSERT_TRUE(sweep.load_historical_data(path_));
+    EXPECT_EQ(sweep.event_count(), 600u);
+
+    SweepGrid grid;
+    grid.latency_ns = {250, 1000};
+    grid.seeds = {7, 8};
+    BacktestConfig base;
+    const auto results = sweep.run(base, grid);
+    ASSERT_EQ(results.size(), 4u);
+
+    for (const auto& r : results) {
+        BacktestConfig config = r.config;
+        config.verbose = false;
+        config.enable_replay_logging = false;
+        BacktestingEngine engine(config);
+        ASSERT_TRUE(engine.load_historical_data(path_));
+        const auto expected = engine.run_backtest();
+
+        EXPECT_EQ(r.metrics.total_trades, expected.total_trades) << r.index;
+        EXPECT_DOUBLE_EQ(r.metrics.total_pnl, expected.total_pnl) << r.index;
+        EXPECT_DOUBLE_EQ(r.metrics.fill_rate, expected.fill_rate) << r.index;
+    }
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+#include "pipeline_benchmark.hpp"
+
+using namespace hft;
+using namespace hft::benchmark;
+
+namespace {
+
+// Fixed amount of work per packet, marked as the first stage
+struct SpinPipeline {
+    explicit SpinPipeline(uint64_t work_ns, double ns_per_cycle)
+        : work_cycles(static_cast<uint64_t>(work_ns / ns_per_cycle)) {}
+
+    void process(size_t, int64_t, StageStamps& stamps) {
+        const uint64_t until = pipeline_cycles() + work_cycles;
+        while (pipeline_cycles() < until) {}
+        stamps.mark(STAGE_NIC_RX);
+        ++processed;
+    }
+
+    uint64_t work_cycles;
+    size_t processed = 0;
+};
+
+size_t arrivals_in(const LoadProfile& p, double from_ns, double to_ns) {
+    size_t n = 0;
+    for (double t = 0.0; t < to_ns; t = p.next_arrival_ns(t)) {
+        if (t >= from_ns) ++n;
+    }
+    return n;
+}
+
+}
+
+// Test each load shape offers the rate it describes
+TEST(PipelineBenchmarkTest, LoadShapes) {
+    const LoadProfile steady = LoadProfile::steady(1e6);
+    EXPECT_DOUBLE_EQ(steady.next_arrival_ns(5000.0), 6000.0);
+    EXPECT_EQ(arrivals_in(steady, 0.0, 1e6), 1000u);
+
+    // 200 us at 8x inside every 2 ms period
+    const LoadProfile bursty = LoadProfile::bursty(1e5, 8.0, 200.0, 2000.0);
+    const size_t in_burst = arrivals_in(bursty, 0.0, 200e3);
+    const size_t after = arrivals_in(bursty, 200e3, 400e3);
+    EXPECT_NEAR(static_cast<double>(in_burst), 160.0, 2.0);
+    EXPECT_NEAR(static_cast<double>(after), 20.0, 2.0);
+    EXPECT_GT(arrivals_in(bursty, 2000e3, 2200e3), 150u);   // next burst
+    EXPECT_STREQ(bursty.name(), "bursty");
+
+    // Surge decays towards the base rate
+    const LoadProfile open = LoadProfile::market_open(1e5, 10.0, 20.0);
+    EXPECT_NEAR(open.rate_at(0.0), 1e6, 1.0);
+    EXPECT_GT(open.rate_at(10e6), open.rate_at(40e6));
+    EXPECT_NEAR(open.rate_at(400e6), 1e5, 1.0);
+    EXPECT_EQ(open.at_rate(2e5).shape, LoadShape::MARKET_OPEN);
+}
+
+// Test response time is measured from intended arrival: under overload it
+// keeps growing while service time stays flat, under light load the two agree
+TEST(PipelineBenchmarkTest, CoordinatedOmissionCorrected) {
+    const PipelineRunner runner;
+    SpinPipeline pipeline(20000, runner.ns_per_cycle());    // 20 us per packet
+
+    // 100k pps offered, 50k pps capacity: packet i waits ~10 us * i
+    const PipelineRunResult overload = runner.run(pipeline, LoadProfile::steady(1e5), 2000);
+    EXPECT_EQ(pipeline.processed, 2000u);
+    EXPECT_EQ(overload.service_ns.count(), 2000u);
+    EXPECT_LT(overload.achieved_pps, overload.offered_pps * 0.75);
+    EXPECT_GT(overload.response_ns.value_at_percentile(99.0),
+              10 * overload.service_ns.value_at_percentile(99.0));
+    EXPECT_GT(overload.response_ns.max(), 10000000u);          // last packet ~20 ms late
+    EXPECT_EQ(overload.stage_ns[STAGE_NIC_RX].count(), 2000u);
+    EXPECT_EQ(overload.stage_ns[STAGE_ENCODE].max(), 0u);       // never marked
+
+    // 2k pps: idle between packets, nothing queues. 25x headroom over the
+    // service time, and compared against the overload backlog (~10 ms at
+    // p50), so preemption on a loaded host doesn't fail the test.
+    const PipelineRunResult light = runner.run(pipeline, LoadProfile::steady(2e3), 100);
+    EXPECT_NEAR(light.achieved_pps, 2e3, 2e2);
+    EXPECT_LT(light.response_ns.value_at_percentile(50.0),
+              overload.response_ns.value_at_percentile(50.0) / 10);
+
+    const auto curve = runner.sweep(pipeline, LoadProfile::steady(0), {1e4, 2e4}, 100);
+    ASSERT_EQ(curve.size(), 2u);
+    EXPECT_DOUBLE_EQ(curve[1].profile.rate_pps, 2e4);
+}
+
+// Test the real hot path consumes every packet through all stages, the
+// synthetic stream replays into the same book, and the report is written
+TEST(PipelineBenchmarkTest, HotPathEndToEnd) {
+    PacketStream stream = PacketStream::synthetic(2000, TickToTradeHarness::SYMBOL_ID, 50, 4);
+    const size_t frames = stream.size();
+    EXPECT_EQ(frames, 2000u + 2000u + 500u);                   // adds, deletes, trades
+
+    TickToTradeHarness harness(std::move(stream));
+    const PipelineRunner runner;
+    const auto result = runner.run(harness, LoadProfile::steady(1e9), 2 * frames);
+
+    const auto& feed = harness.feed_stats();
+    EXPECT_EQ(feed.packets, 2 * frames);
+    EXPECT_EQ(feed.book_updates, 2 * 4000u);
+    EXPECT_EQ(feed.rejected_updates, 0u);
+    EXPECT_EQ(feed.sequence_gaps, 0u);
+    EXPECT_EQ(feed.trades, 2 * 500u);
+    EXPECT_GT(harness.orders_encoded(), frames);
+
+    for (size_t s = 0; s < PIPELINE_STAGE_COUNT; ++s) {
+        EXPECT_EQ(result.stage_ns[s].count(), 2 * frames) << stage_name(s);
+    }
+    EXPECT_GT(result.stage_ns[STAGE_DECODE_BOOK].mean(), 0.0);
+    EXPECT_GE(result.response_ns.min(), result.service_ns.min());
+
+    const std::string csv = "/tmp/hft_t2t_curve_" + std::to_string(::getpid()) + ".csv";
+    export_latency_curve_csv(csv, {result});
+    std::ifstream in(csv);
+    std::string header, row;
+    ASSERT_TRUE(std::getline(in, header));
+    ASSERT_TRUE(std::getline(in, row));
+    EXPECT_EQ(row.rfind("steady,", 0), 0u);
+    ::unlink(csv.c_str());
+}
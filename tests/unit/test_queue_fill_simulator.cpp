@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "queue_fill_simulator.hpp"
+
+namespace {
+
+using hft::Side;
+using hft::backtest::QueueFillSimulator;
+
+hft::MarketTick book(double bid, uint64_t bid_size, double ask, uint64_t ask_size) {
+    hft::MarketTick tick;
+    tick.bid_price = bid;
+    tick.ask_price = ask;
+    tick.mid_price = (bid + ask) / 2.0;
+    tick.bid_size = bid_size;
+    tick.ask_size = ask_size;
+    tick.depth_levels = 1;
+    return tick;
+}
+
+hft::MarketTick trade(hft::MarketTick tick, Side aggressor, uint64_t volume) {
+    tick.trade_side = aggressor;
+    tick.trade_volume = volume;
+    return tick;
+}
+
+class QueueFillSimulatorTest : public ::testing::Test {
+protected:
+    QueueFillSimulator sim_{0.01, 100.0};
+    std::vector<QueueFillSimulator::Fill> fills_;
+    int64_t ts_ = 0;
+
+    void apply(const hft::MarketTick& tick) {
+        sim_.on_market(tick, 0.0, ++ts_, [this](const QueueFillSimulator::Fill& f) { fills_.push_back(f); });
+    }
+};
+
+}
+
+// Test an order fills only after the displayed volume ahead of it trades
+TEST_F(QueueFillSimulatorTest, FillsAfterQueueAheadTrades) {
+    apply(book(100.00, 500, 100.02, 400));
+    ASSERT_TRUE(sim_.add_order(1, Side::BUY, 100.00, 100, ts_));
+    EXPECT_DOUBLE_EQ(sim_.queue_ahead(1), 500.0);
+
+    apply(trade(book(100.00, 200, 100.02, 400), Side::SELL, 300));
+    EXPECT_TRUE(fills_.empty());
+    EXPECT_DOUBLE_EQ(sim_.queue_ahead(1), 200.0);
+
+    // Buy aggressors never touch our bid
+    apply(trade(book(100.00, 200, 100.02, 100), Side::BUY, 300));
+    EXPECT_TRUE(fills_.empty());
+
+    apply(trade(book(100.00, 50, 100.02, 100), Side::SELL, 250));
+    ASSERT_EQ(fills_.size(), 1u);
+    EXPECT_EQ(fills_[0].order_id, 1u);
+    EXPECT_EQ(fills_[0].quantity, 50u);
+    EXPECT_EQ(fills_[0].remaining, 50u);
+
+    apply(trade(book(99.99, 300, 100.01, 100), Side::SELL, 80));
+    ASSERT_EQ(fills_.size(), 2u);
+    EXPECT_EQ(fills_[1].quantity, 50u);
+    EXPECT_EQ(fills_[1].remaining, 0u);
+    EXPECT_FALSE(sim_.is_resting(1));
+    EXPECT_EQ(sim_.active_levels(), 0u);
+}
+
+// Test cancels come out of the market volume pro rata and size added
+// later queues behind us
+TEST_F(QueueFillSimulatorTest, CancelsAdvanceQueuePosition) {
+    apply(book(100.00, 500, 100.02, 400));
+    ASSERT_TRUE(sim_.add_order(1, Side::BUY, 100.00, 100, ts_));
+
+    apply(book(100.00, 800, 100.02, 400));   // +300 behind us
+    EXPECT_DOUBLE_EQ(sim_.queue_ahead(1), 500.0);
+
+    apply(book(100.00, 400, 100.02, 400));   // -400: 250 ahead, 150 behind
+    EXPECT_DOUBLE_EQ(sim_.queue_ahead(1), 250.0);
+
+    apply(book(100.00, 0, 100.02, 400));
+    EXPECT_DOUBLE_EQ(sim_.queue_ahead(1), 0.0);
+    EXPECT_TRUE(fills_.empty());
+}
+
+// Test orders at one level fill in time priority and a trade sweeping
+// through a level continues to the next
+TEST_F(QueueFillSimulatorTest, SweepsLevelsInPriority) {
+    apply(book(100.00, 100, 100.03, 100));
+    ASSERT_TRUE(sim_.add_order(1, Side::SELL, 100.02, 30, ts_));   // Inside the spread: first
+    ASSERT_TRUE(sim_.add_order(2, Side::SELL, 100.03, 40, ts_));
+    ASSERT_TRUE(sim_.add_order(3, Side::SELL, 100.03, 40, ts_));
+    EXPECT_DOUBLE_EQ(sim_.queue_ahead(1), 0.0);
+    EXPECT_DOUBLE_EQ(sim_.queue_ahead(3), 140.0);
+
+    hft::MarketTick t = trade(book(100.00, 100, 100.03, 100), Side::BUY, 180);
+    sim_.on_market(t, 100.03, ++ts_, [this](const QueueFillSimulator::Fill& f) { fills_.push_back(f); });
+
+    ASSERT_EQ(fills_.size(), 3u);
+    EXPECT_EQ(fills_[0].order_id, 1u);
+    EXPECT_EQ(fills_[0].quantity, 30u);
+    EXPECT_EQ(fills_[1].order_id, 2u);
+    EXPECT_EQ(fills_[1].quantity, 40u);
+    EXPECT_EQ(fills_[2].order_id, 3u);
+    EXPECT_EQ(fills_[2].quantity, 10u);     // 180 - 30 - 100 - 40
+    EXPECT_TRUE(sim_.is_resting(3));
+}
+
+// Test a touch moving through our price fills the order, and cancel
+// leaves the level
+TEST_F(QueueFillSimulatorTest, CrossAndCancel) {
+    apply(book(100.00, 500, 100.02, 400));
+    ASSERT_TRUE(sim_.add_order(1, Side::BUY, 99.98, 100, ts_));
+    ASSERT_TRUE(sim_.add_order(2, Side::BUY, 99.97, 100, ts_));
+    EXPECT_EQ(sim_.active_levels(), 2u);
+
+    EXPECT_TRUE(sim_.cancel_order(2));
+    EXPECT_FALSE(sim_.cancel_order(2));
+    EXPECT_EQ(sim_.active_levels(), 1u);
+
+    apply(book(99.96, 300, 99.98, 200));
+    ASSERT_EQ(fills_.size(), 1u);
+    EXPECT_EQ(fills_[0].quantity, 100u);
+    EXPECT_EQ(sim_.resting_orders(), 0u);
+
+    EXPECT_FALSE(sim_.add_order(3, Side::BUY, 10.0, 100, ts_));    // Outside the window
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "risk_control.hpp"
+
+using namespace hft;
+
+namespace {
+
+Order order(uint32_t symbol, Side side, double price, uint64_t quantity) {
+    return Order(1, symbol, side, price, quantity);
+}
+
+}
+
+// Test the effective limit is the tighter of the symbol and strategy tables,
+// and that regime and kill switch gate every strategy
+TEST(RiskEngineTest, PerSymbolAndPerStrategyLimits) {
+    RiskLimits firm;
+    firm.max_position = 1000;
+    RiskEngine engine(2, firm, 50);
+
+    RiskLimits tight_symbol = firm;
+    tight_symbol.max_position = 200;
+    tight_symbol.max_order_value = 5000.0;
+    engine.set_symbol_limits(1, tight_symbol);
+
+    RiskLimits strategy_limits;
+    strategy_limits.max_position = 500;
+    strategy_limits.max_daily_trades = 3;
+    auto& ctx = engine.add_strategy(strategy_limits);
+    EXPECT_THROW(engine.set_symbol_limits(0, firm), std::logic_error);
+
+    EXPECT_TRUE(ctx.check_pre_trade_limits(order(0, Side::BUY, 10.0, 500)));
+    EXPECT_FALSE(ctx.check_pre_trade_limits(order(0, Side::BUY, 10.0, 501)));   // strategy cap
+    EXPECT_TRUE(ctx.check_pre_trade_limits(order(1, Side::SELL, 10.0, 200)));
+    EXPECT_FALSE(ctx.check_pre_trade_limits(order(1, Side::SELL, 10.0, 201)));  // symbol cap
+    EXPECT_FALSE(ctx.check_pre_trade_limits(order(1, Side::BUY, 100.0, 60)));   // order value
+    EXPECT_FALSE(ctx.check_pre_trade_limits(order(2, Side::BUY, 10.0, 1)));     // unknown symbol
+
+    engine.set_regime_multiplier(1.5);                                          // 0.4x
+    EXPECT_EQ(engine.get_current_regime(), MarketRegime::HIGH_STRESS);
+    EXPECT_FALSE(ctx.check_pre_trade_limits(order(0, Side::BUY, 10.0, 201)));
+    EXPECT_TRUE(ctx.check_pre_trade_limits(order(0, Side::BUY, 10.0, 200)));
+    engine.set_regime_multiplier(3.0);
+    EXPECT_FALSE(ctx.check_pre_trade_limits(order(0, Side::BUY, 10.0, 1)));
+    engine.set_regime_multiplier(0.1);
+
+    for (int i = 0; i < 3; ++i) ctx.on_fill(0, Side::BUY, 1, 10.0);
+    EXPECT_FALSE(ctx.check_pre_trade_limits(order(0, Side::BUY, 10.0, 1)));     // trade count
+    ctx.reset_daily_counters();
+    EXPECT_TRUE(ctx.check_pre_trade_limits(order(0, Side::BUY, 10.0, 1)));
+
+    engine.trigger_kill_switch();
+    EXPECT_FALSE(ctx.check_pre_trade_limits(order(0, Side::BUY, 10.0, 1)));
+    engine.reset_kill_switch("EMERGENCY_RESET");
+    EXPECT_TRUE(ctx.check_pre_trade_limits(order(0, Side::BUY, 10.0, 1)));
+}
+
+// Test strategies share a symbol's firm limit through credit: together they
+// cannot exceed it, and credit released by one becomes available to another
+TEST(RiskEngineTest, CreditBoundsAggregatePosition) {
+    RiskLimits firm;
+    firm.max_position = 300;
+    RiskEngine engine(1, firm, 100);
+    auto& a = engine.add_strategy(RiskLimits{});
+    auto& b = engine.add_strategy(RiskLimits{});
+
+    ASSERT_TRUE(a.check_pre_trade_limits(order(0, Side::BUY, 10.0, 150)));
+    a.on_fill(0, Side::BUY, 150, 10.0);
+    EXPECT_GE(a.credit(0), 150);
+
+    ASSERT_TRUE(b.check_pre_trade_limits(order(0, Side::SELL, 10.0, 100)));
+    b.on_fill(0, Side::SELL, 100, 10.0);
+    EXPECT_EQ(a.credit(0) + b.credit(0) + engine.available_credit(0), 300);
+    EXPECT_FALSE(b.check_pre_trade_limits(order(0, Side::SELL, 10.0, 200)));   // pool dry
+
+    a.on_fill(0, Side::SELL, 150, 10.0);
+    a.release_idle_credit();
+    EXPECT_EQ(a.credit(0), 0);
+    EXPECT_TRUE(b.check_pre_trade_limits(order(0, Side::SELL, 10.0, 200)));
+
+    const FirmExposure e = engine.reconcile();
+    EXPECT_EQ(engine.net_position(0), -100);
+    EXPECT_FALSE(e.position_breach);
+    EXPECT_FALSE(e.kill_switch);
+    EXPECT_EQ(e.trade_count, 3);
+}
+
+// Test the reconciler blocks a losing strategy and trips the kill switch on
+// firm-wide loss, while strategy threads keep checking and filling
+TEST(RiskEngineTest, ReconcilerAggregatesPnl) {
+    RiskLimits firm;
+    firm.max_loss = 5000.0;
+    firm.max_daily_trades = 1'000'000;
+    RiskEngine engine(4, firm, 64);
+
+    RiskLimits strategy_limits;
+    strategy_limits.max_loss = 3000.0;
+    strategy_limits.max_daily_trades = 1'000'000;
+    for (int s = 0; s < 3; ++s) engine.add_strategy(strategy_limits);
+    for (uint32_t sym = 0; sym < 4; ++sym) engine.mark(sym, 100.0);
+
+    RiskReconciler reconciler(engine, std::chrono::microseconds(200));
+    reconciler.start();
+
+    std::vector<std::thread> threads;
+    for (uint32_t s = 0; s < 3; ++s) {
+        threads.emplace_back([&engine, s] {
+            auto& ctx = engine.strategy(s);
+            for (int i = 0; i < 20000; ++i) {
+                const uint32_t sym = (s + i) % 4;
+                const Side side = (i / 4) % 2 == 0 ? Side::BUY : Side::SELL;
+                if (ctx.check_pre_trade_limits(order(sym, side, 100.0, 5))) {
+                    ctx.on_fill(sym, side, 5, 100.0);                            // flat P&L at mark
+                }
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    while (reconciler.passes() < 2) std::this_thread::sleep_for(std::chrono::microseconds(100));
+    EXPECT_FALSE(engine.exposure().kill_switch);
+
+    // Strategy 0 buys 40 at 100, mark drops to 0.01 → loss ~4000 > 3000
+    engine.strategy(0).on_fill(0, Side::BUY, 40, 100.0);
+    engine.mark(0, 0.01);
+    FirmExposure e = engine.reconcile();
+    EXPECT_TRUE(engine.strategy(0).blocked());
+    EXPECT_FALSE(engine.strategy(1).blocked());
+    EXPECT_FALSE(e.kill_switch);
+    EXPECT_FALSE(engine.strategy(0).check_pre_trade_limits(order(1, Side::BUY, 100.0, 1)));
+
+    engine.strategy(1).on_fill(0, Side::BUY, 20, 100.0);
+    e = engine.reconcile();
+    EXPECT_LT(e.total_pnl, -5000.0);
+    EXPECT_TRUE(e.kill_switch);
+    EXPECT_FALSE(engine.strategy(2).check_pre_trade_limits(order(1, Side::BUY, 100.0, 1)));
+
+    reconciler.stop();
+    EXPECT_TRUE(engine.exposure().kill_switch);
+}
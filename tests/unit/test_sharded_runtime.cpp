@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "sharded_runtime.hpp"
+
+using namespace hft;
+using namespace hft::preserialized;
+using runtime::RuntimeConfig;
+using runtime::SymbolModel;
+
+namespace {
+
+// Counts messages by type; touched only by the gateway thread until stop()
+class CountingTransport {
+public:
+    uint8_t* acquire(size_t& capacity) {
+        capacity = sizeof(buffer_);
+        return buffer_;
+    }
+
+    bool transmit(size_t len) {
+        for (size_t at = 0; at < len;) {
+            const auto* h = reinterpret_cast<const OrderMessageHeader*>(buffer_ + at);
+            ++messages;
+            if (h->message_type == CANCEL_REPLACE) ++replaces;
+            at += h->message_length;
+        }
+        return true;
+    }
+
+    size_t messages = 0;
+    size_t replaces = 0;
+
+private:
+    alignas(64) uint8_t buffer_[1400];
+};
+
+using Runtime = runtime::ShardedRuntime<CountingTransport, 1024, 1024>;
+
+CompactTick quote(uint32_t symbol, double bid, double ask) {
+    CompactTick t;
+    t.timestamp_ns = to_nanos(now());
+    t.asset_id = symbol;
+    t.bid_price = bid;
+    t.ask_price = ask;
+    t.bid_size = 100;
+    t.ask_size = 100;
+    return t;
+}
+
+template<typename Pred>
+bool wait_for(Pred pred) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+}
+
+// Test symbols are split into contiguous blocks, overrides apply, and each
+// shard builds and updates only the models of its own symbols
+TEST(ShardedRuntimeTest, RoutesSymbolsToOwningShard) {
+    OrderTemplatePool pool(7, 9, 8);
+    CountingTransport transport;
+    Runtime rt(8, RuntimeConfig(2), pool, transport);
+
+    EXPECT_EQ(rt.shard_of(0), 0u);
+    EXPECT_EQ(rt.shard_of(3), 0u);
+    EXPECT_EQ(rt.shard_of(4), 1u);
+    rt.assign(7, 0);
+    EXPECT_EQ(rt.shard_of(7), 0u);
+    EXPECT_THROW(rt.assign(1, 2), std::out_of_range);
+
+    rt.start();
+    EXPECT_THROW(rt.assign(1, 1), std::logic_error);
+    for (uint32_t s = 0; s < 8; ++s) {
+        ASSERT_TRUE(rt.dispatch(quote(s, 100.0 + s, 100.5 + s)));
+    }
+    EXPECT_FALSE(rt.dispatch(quote(8, 100.0, 100.5)));     // unknown symbol
+    ASSERT_TRUE(wait_for([&] { return rt.shard_stats(0).ticks + rt.shard_stats(1).ticks == 8; }));
+    rt.stop();
+
+    EXPECT_EQ(rt.shard_stats(0).ticks, 5u);                  // 0-3 and 7
+    EXPECT_EQ(rt.shard_stats(1).ticks, 3u);
+    for (uint32_t s = 0; s < 8; ++s) {
+        EXPECT_EQ(rt.model(s).symbol_id, s);
+        EXPECT_EQ(rt.model(s).tick.bid_price, 100.0 + s);
+        EXPECT_EQ(rt.model(s).tick.mid_price, 100.25 + s);
+    }
+}
+
+// Test shards quote through the shared gateway, cancel/replacing a resting
+// order when the price moves and staying quiet when it does not
+TEST(ShardedRuntimeTest, QuotesThroughSharedGateway) {
+    OrderTemplatePool pool(7, 9, 4);
+    for (uint32_t s = 0; s < 4; ++s) pool.initialize_symbol_templates(s, "SYM" + std::to_string(s));
+    CountingTransport transport;
+    Runtime rt(4, RuntimeConfig(2), pool, transport);
+
+    rt.start();
+    for (uint32_t s = 0; s < 4; ++s) ASSERT_TRUE(rt.dispatch(quote(s, 100.0, 100.5)));
+    for (uint32_t s = 0; s < 4; ++s) ASSERT_TRUE(rt.dispatch(quote(s, 100.0, 100.5)));       // same quotes
+    for (uint32_t s = 0; s < 4; ++s) ASSERT_TRUE(rt.dispatch(quote(s, 101.0, 101.5)));       // moved
+    ASSERT_TRUE(wait_for([&] { return rt.shard_stats(0).ticks + rt.shard_stats(1).ticks == 12; }));
+    rt.stop();
+
+    const auto a = rt.shard_stats(0);
+    const auto b = rt.shard_stats(1);
+    EXPECT_EQ(a.risk_rejects + b.risk_rejects, 0u);
+    EXPECT_EQ(a.gateway_full + b.gateway_full, 0u);
+    EXPECT_EQ(a.quotes, 8u);                                 // 2 symbols x 2 sides x (new + replace)
+    EXPECT_EQ(b.quotes, 8u);
+    EXPECT_EQ(transport.messages, 16u);
+    EXPECT_EQ(transport.replaces, 8u);
+    EXPECT_EQ(rt.gateway().stats().messages, 16u);
+    EXPECT_NE(rt.model(0).bid_order_id, 0u);
+    EXPECT_EQ(rt.model(0).bid_price, rt.model(3).bid_price);
+}
+
+// Test two symbols on one shard each keep their own feature history: the
+// model state and signal after interleaved ticks match running each alone
+TEST(ShardedRuntimeTest, SymbolsOnOneShardKeepOwnFeatures) {
+    OrderTemplatePool pool(7, 9, 2);
+    CountingTransport transport;
+    auto tick = [](uint32_t symbol, int i) {
+        CompactTick t = quote(symbol, 100.0 + 10.0 * symbol + 0.01 * (i % 7), 100.5 + 10.0 * symbol + 0.01 * (i % 5));
+        t.timestamp_ns = 1000000 + i * 1000;
+        t.bid_size = 100 + 37 * ((i + symbol) % 4);
+        t.ask_size = 100 + 23 * (i % 3);
+        return t;
+    };
+    auto state = [](const SymbolModel& m) {
+        checkpoint::StateWriter out;
+        m.inference.save_state(out);
+        return out.bytes();
+    };
+
+    std::srand(7);
+    Runtime both(2, RuntimeConfig(1), pool, transport);
+    both.start();
+    for (int i = 0; i < 40; ++i) {
+        ASSERT_TRUE(both.dispatch(tick(0, i)));
+        ASSERT_TRUE(both.dispatch(tick(1, i)));
+    }
+    ASSERT_TRUE(wait_for([&] { return both.shard_stats(0).ticks == 80; }));
+    both.stop();
+
+    for (uint32_t s = 0; s < 2; ++s) {
+        std::srand(7);
+        Runtime alone(2, RuntimeConfig(1), pool, transport);
+        alone.start();
+        for (int i = 0; i < 40; ++i) ASSERT_TRUE(alone.dispatch(tick(s, i)));
+        ASSERT_TRUE(wait_for([&] { return alone.shard_stats(0).ticks == 40; }));
+        alone.stop();
+
+        EXPECT_EQ(state(both.model(s)), state(alone.model(s))) << "symbol " << s;
+        EXPECT_EQ(both.model(s).signal, alone.model(s).signal) << "symbol " << s;
+    }
+}
+
+// Test fills land on the owning shard's risk context and the shared
+// reconciler trips the firm kill switch, after which every shard stops quoting
+TEST(ShardedRuntimeTest, FirmRiskSpansShards) {
+    OrderTemplatePool pool(7, 9, 4);
+    for (uint32_t s = 0; s < 4; ++s) pool.initialize_symbol_templates(s, "SYM" + std::to_string(s));
+    CountingTransport transport;
+    RuntimeConfig config(2);
+    config.firm_limits.max_daily_trades = 3;
+    config.reconcile_interval = std::chrono::microseconds(100);
+    Runtime rt(4, config, pool, transport);
+
+    rt.start();
+    ASSERT_TRUE(rt.dispatch_fill(0, Side::BUY, 10, 100.0));
+    ASSERT_TRUE(rt.dispatch_fill(1, Side::BUY, 5, 100.0));
+    ASSERT_TRUE(rt.dispatch_fill(2, Side::SELL, 10, 100.0));
+    ASSERT_TRUE(rt.dispatch_fill(3, Side::SELL, 5, 100.0));
+    ASSERT_TRUE(wait_for([&] { return rt.risk().exposure().kill_switch; }));
+    EXPECT_EQ(rt.risk().exposure().trade_count, 4);
+
+    for (uint32_t s = 0; s < 4; ++s) ASSERT_TRUE(rt.dispatch(quote(s, 100.0, 100.5)));
+    ASSERT_TRUE(wait_for([&] { return rt.shard_stats(0).ticks + rt.shard_stats(1).ticks == 4; }));
+    rt.stop();
+
+    EXPECT_EQ(rt.shard_stats(0).fills, 2u);
+    EXPECT_EQ(rt.shard_stats(1).fills, 2u);
+    EXPECT_EQ(rt.shard_risk(0).position(0), 10);
+    EXPECT_EQ(rt.shard_risk(1).position(2), -10);
+    EXPECT_EQ(rt.shard_risk(1).position(0), 0);
+    EXPECT_EQ(rt.shard_stats(0).quotes + rt.shard_stats(1).quotes, 0u);
+    EXPECT_EQ(rt.shard_stats(0).risk_rejects + rt.shard_stats(1).risk_rejects, 8u);
+    EXPECT_EQ(transport.messages, 0u);
+}
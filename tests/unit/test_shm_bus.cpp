@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "shared_memory.hpp"
+
+using namespace hft;
+
+namespace {
+
+using TestBus = shm::ShmBus<MarketTick, 1024, 4>;
+
+MarketTick tick(uint64_t i) {
+    MarketTick t{};
+    t.timestamp = Timestamp(std::chrono::nanoseconds(static_cast<int64_t>(i)));
+    t.bid_price = 100.0 + static_cast<double>(i % 1024) * 0.25;    // exact in binary
+    t.ask_price = t.bid_price + 0.25;
+    t.bid_size = i;
+    t.ask_size = i + 1;
+    t.asset_id = static_cast<uint32_t>(i % 7);
+    return t;
+}
+
+size_t open_fds() {
+    size_t n = 0;
+    for (const auto& entry : std::filesystem::directory_iterator("/proc/self/fd")) {
+        (void)entry;
+        ++n;
+    }
+    return n;
+}
+
+// Lines of /proc/self/maps that map the segment
+size_t mappings_of(const std::string& segment_name) {
+    std::ifstream maps("/proc/self/maps");
+    size_t n = 0;
+    for (std::string line; std::getline(maps, line);) {
+        if (line.find(segment_name.substr(1)) != std::string::npos) ++n;
+    }
+    return n;
+}
+
+bool same(const MarketTick& t, uint64_t i) {
+    const MarketTick e = tick(i);
+    return t.timestamp == e.timestamp && t.bid_price == e.bid_price && t.ask_price == e.ask_price &&
+           t.bid_size == e.bid_size && t.ask_size == e.ask_size && t.asset_id == e.asset_id;
+}
+
+std::string segment(const char* tag) {
+    return "/hft_test_bus_" + std::string(tag) + "_" + std::to_string(::getpid());
+}
+
+}
+
+// Test every subscriber, each on its own mapping, sees the same stream and
+// the publisher sees each one's cursor
+TEST(ShmBusTest, SubscribersShareOneStream) {
+    const std::string name = segment("fanout");
+    TestBus publisher(name, true);
+    TestBus strategy_map(name, false);
+    TestBus risk_map(name, false);
+    auto strategy = strategy_map.subscribe("strategy");
+    auto risk = risk_map.subscribe("risk");
+    EXPECT_EQ(publisher.subscribers().size(), 2u);
+
+    std::vector<MarketTick> batch;
+    for (uint64_t i = 0; i < 600; ++i) batch.push_back(tick(i));
+    publisher.publish_bulk(batch.data(), batch.size());
+    EXPECT_EQ(publisher.published(), 600u);
+
+    MarketTick out[256];
+    uint64_t seen = 0;
+    while (size_t n = strategy.consume(out, 256)) {
+        for (size_t k = 0; k < n; ++k) ASSERT_TRUE(same(out[k], seen + k));
+        seen += n;
+    }
+    EXPECT_EQ(seen, 600u);
+
+    for (uint64_t i = 0; i < 600; ++i) {
+        ASSERT_TRUE(risk.consume_one(out[0]));
+        ASSERT_TRUE(same(out[0], i));
+    }
+    EXPECT_FALSE(risk.consume_one(out[0]));
+
+    for (const auto& sub : publisher.subscribers()) {
+        EXPECT_EQ(sub.lag, 0u) << sub.name;
+        EXPECT_EQ(sub.lost, 0u) << sub.name;
+        EXPECT_EQ(sub.pid, ::getpid());
+    }
+    TestBus::unlink(name);
+}
+
+// Test the publisher never waits on a stalled subscriber: the subscriber is
+// skipped forward, counts what it missed, and the lag is visible to the publisher
+TEST(ShmBusTest, SlowSubscriberIsDetectedNotBlocking) {
+    const std::string name = segment("slow");
+    TestBus publisher(name, true);
+    auto slow = publisher.subscribe("recorder");
+
+    for (uint64_t i = 0; i < 5000; ++i) publisher.publish(tick(i));
+    ASSERT_EQ(publisher.subscribers().size(), 1u);
+    EXPECT_EQ(publisher.subscribers()[0].lag, 5000u);
+    EXPECT_EQ(slow.lag(), 5000u);
+
+    MarketTick out[64];
+    const size_t n = slow.consume(out, 64);
+    ASSERT_EQ(n, 64u);
+    EXPECT_EQ(slow.lost(), 5000u - TestBus::capacity());
+    EXPECT_TRUE(same(out[0], 5000 - TestBus::capacity()));
+    EXPECT_EQ(publisher.subscribers()[0].lost, slow.lost());
+
+    {
+        auto a = publisher.subscribe("a");
+        auto b = publisher.subscribe("b");
+        auto c = publisher.subscribe("c");
+        EXPECT_THROW(publisher.subscribe("d"), std::runtime_error);
+    }
+    EXPECT_EQ(publisher.subscribers().size(), 1u);          // slots released
+    EXPECT_EQ(publisher.reap_dead_subscribers(), 0u);
+    using WrongCapacity = shm::ShmBus<MarketTick, 2048, 4>;
+    using SmallerCapacity = shm::ShmBus<MarketTick, 512, 4>;   // fits the segment, header disagrees
+    const size_t fds = open_fds();
+    const size_t maps = mappings_of(name);
+    EXPECT_THROW(WrongCapacity(name, false), std::runtime_error);
+    EXPECT_THROW(SmallerCapacity(name, false), std::runtime_error);
+    EXPECT_EQ(open_fds(), fds);                             // a rejected attach releases what it opened
+    EXPECT_EQ(mappings_of(name), maps);
+    TestBus::unlink(name);
+}
+
+// Test a consumer in another process reads every entry it returns intact
+// and in order while the publisher laps it
+TEST(ShmBusTest, CrossProcessConsumer) {
+    const std::string name = segment("fork");
+    TestBus publisher(name, true);
+    constexpr uint64_t TOTAL = 200000;
+
+    const pid_t child = ::fork();
+    ASSERT_NE(child, -1);
+    if (child == 0) {
+        int status = 0;
+        {
+            TestBus bus(name, false);
+            auto sub = bus.subscribe("child");
+            MarketTick out[32];
+            uint64_t expected = 0;
+            uint64_t received = 0;
+            while (expected < TOTAL) {
+                const size_t n = sub.consume(out, 32);
+                if (n == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (size_t k = 0; k < n; ++k) {
+                    const uint64_t index = static_cast<uint64_t>(out[k].timestamp.time_since_epoch().count());
+                    if (index < expected || !same(out[k], index)) status = 1;
+                    expected = index + 1;
+                }
+                received += n;
+            }
+            if (received + sub.lost() != TOTAL) status = 2;
+        }
+        ::_exit(status);
+    }
+
+    while (publisher.subscribers().empty()) std::this_thread::yield();
+    MarketTick batch[8];
+    for (uint64_t i = 0; i < TOTAL; i += 8) {
+        for (uint64_t k = 0; k < 8; ++k) batch[k] = tick(i + k);
+        publisher.publish_bulk(batch, 8);
+        if (i % 4096 == 0) std::this_thread::yield();
+    }
+
+    int status = -1;
+    ASSERT_EQ(::waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    EXPECT_TRUE(publisher.subscribers().empty());
+    TestBus::unlink(name);
+}
+
+// Test the point-to-point ring maps the fixed RingHeader layout src/lib.rs
+// mirrors, and refuses to attach with a different slot type or capacity
+TEST(ShmBusTest, SharedRingLayoutIsChecked) {
+    const std::string name = segment("ring");
+    shm::SharedMemoryRingBuffer<MarketTick, 64> producer(name, true);
+    for (uint64_t i = 0; i < 3; ++i) ASSERT_TRUE(producer.write(tick(i)));
+
+    const auto* header = static_cast<const shm::RingHeader*>(producer.region());
+    EXPECT_EQ(header->magic, shm::RING_MAGIC);
+    EXPECT_EQ(header->capacity, 64u);
+    EXPECT_EQ(header->element_size, sizeof(MarketTick));
+    EXPECT_EQ(header->write_seq.load(), 3u);
+    MarketTick first;
+    std::memcpy(static_cast<void*>(&first), static_cast<const char*>(producer.region()) + shm::RING_DATA_OFFSET,
+                sizeof(first));
+    EXPECT_TRUE(same(first, 0));
+
+    EXPECT_THROW((shm::SharedMemoryRingBuffer<MarketTick, 128>(name, false)), std::runtime_error);
+    EXPECT_THROW((shm::SharedMemoryRingBuffer<CompactTick, 64>(name, false)), std::runtime_error);
+
+    shm::SharedMemoryRingBuffer<MarketTick, 64> consumer(name, false);
+    MarketTick out[4];
+    ASSERT_EQ(consumer.read_bulk(out, 4), 3u);
+    for (uint64_t i = 0; i < 3; ++i) EXPECT_TRUE(same(out[i], i));
+    EXPECT_TRUE(producer.empty());
+    shm_unlink(name.c_str());
+}
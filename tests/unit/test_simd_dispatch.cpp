@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "simd_dispatch.hpp"
+#include "simd_features.hpp"
+#include "vectorized_inference.hpp"
+
+using namespace hft;
+using namespace hft::simd;
+
+namespace {
+
+std::vector<double> random_vector(std::mt19937_64& rng, size_t n, double lo, double hi) {
+    std::uniform_real_distribution<double> dist(lo, hi);
+    std::vector<double> v(n);
+    for (auto& x : v) x = dist(rng);
+    return v;
+}
+
+}
+
+// Test every variant this CPU runs matches the scalar kernels, at lengths
+// that exercise full vectors and every tail size
+TEST(SimdDispatchTest, VariantsMatchScalar) {
+    const KernelTable& reference = kernels_for(IsaLevel::SCALAR);
+    std::mt19937_64 rng(7);
+
+    for (IsaLevel level : supported_isas()) {
+        SCOPED_TRACE(isa_name(level));
+        const KernelTable& k = kernels_for(level);
+        EXPECT_EQ(k.isa, level);
+
+        for (size_t n = 0; n <= 19; ++n) {
+            const auto a = random_vector(rng, n, 0.0, 1000.0);
+            const auto b = random_vector(rng, n, 0.0, 1000.0);
+            std::vector<double> expected(n), actual(n);
+            reference.subtract(a.data(), b.data(), expected.data(), n);
+            k.subtract(a.data(), b.data(), actual.data(), n);
+            for (size_t i = 0; i < n; ++i) EXPECT_DOUBLE_EQ(actual[i], expected[i]);
+
+            EXPECT_NEAR(k.sum_difference(a.data(), b.data(), n),
+                        reference.sum_difference(a.data(), b.data(), n), 1e-9);
+            EXPECT_NEAR(k.volume_imbalance(a.data(), b.data(), n),
+                        reference.volume_imbalance(a.data(), b.data(), n), 1e-12);
+
+            const auto mean = random_vector(rng, n, -1.0, 1.0);
+            const auto stddev = random_vector(rng, n, 0.5, 2.0);
+            std::vector<double> x_expected = a, x_actual = a;
+            reference.normalize(x_expected.data(), mean.data(), stddev.data(), n);
+            k.normalize(x_actual.data(), mean.data(), stddev.data(), n);
+            for (size_t i = 0; i < n; ++i) EXPECT_NEAR(x_actual[i], x_expected[i], 1e-9);
+
+            const size_t rows = 3;
+            const auto w = random_vector(rng, rows * n, -1.0, 1.0);
+            const auto bias = random_vector(rng, rows, -1.0, 1.0);
+            double out_expected[rows], out_actual[rows];
+            reference.dense(w.data(), a.data(), bias.data(), out_expected, rows, n);
+            k.dense(w.data(), a.data(), bias.data(), out_actual, rows, n);
+            for (size_t r = 0; r < rows; ++r) EXPECT_NEAR(out_actual[r], out_expected[r], 1e-9);
+
+            auto t_expected = random_vector(rng, n, -20.0, 20.0);
+            auto t_actual = t_expected;
+            reference.tanh(t_expected.data(), n);
+            k.tanh(t_actual.data(), n);
+            for (size_t i = 0; i < n; ++i) EXPECT_NEAR(t_actual[i], t_expected[i], 1e-15);
+        }
+    }
+    EXPECT_EQ(reference.volume_imbalance(nullptr, nullptr, 0), 0.0);
+}
+
+// Test the dispatched variant is the widest supported one unless HFT_ISA
+// names another, and unsupported variants are refused
+TEST(SimdDispatchTest, DispatchPicksSupportedVariant) {
+    const auto levels = supported_isas();
+    ASSERT_FALSE(levels.empty());
+    EXPECT_EQ(levels.back(), IsaLevel::SCALAR);
+    EXPECT_TRUE(isa_supported(active_isa()));
+
+    IsaLevel forced;
+    const char* env = std::getenv("HFT_ISA");
+    if (env && isa_from_name(env, forced) && isa_supported(forced)) {
+        EXPECT_EQ(active_isa(), forced);
+    } else {
+        EXPECT_EQ(active_isa(), levels.front());
+    }
+    EXPECT_EQ(&kernels(), &kernels());
+
+    IsaLevel parsed;
+    EXPECT_TRUE(isa_from_name("avx2", parsed));
+    EXPECT_EQ(parsed, IsaLevel::AVX2);
+    EXPECT_FALSE(isa_from_name("avx10", parsed));
+#if defined(HFT_SIMD_X86)
+    EXPECT_FALSE(isa_supported(IsaLevel::NEON));
+    EXPECT_THROW(kernels_for(IsaLevel::NEON), std::invalid_argument);
+#else
+    EXPECT_FALSE(isa_supported(IsaLevel::AVX2));
+    EXPECT_THROW(kernels_for(IsaLevel::AVX2), std::invalid_argument);
+#endif
+}
+
+// Test the feature engine and inference engine give the same answers on
+// every variant
+TEST(SimdDispatchTest, EnginesAgreeAcrossVariants) {
+    std::mt19937_64 rng(11);
+    std::vector<std::vector<double>> books;
+    for (int i = 0; i < 20; ++i) books.push_back(random_vector(rng, 20, 1.0, 500.0));
+
+    simd_features::FastFeatureEngine reference_features(kernels_for(IsaLevel::SCALAR));
+    VectorizedInferenceEngine reference_model;
+    reference_model.select_kernels(kernels_for(IsaLevel::SCALAR));
+    EXPECT_EQ(reference_model.isa(), IsaLevel::SCALAR);
+
+    for (IsaLevel level : supported_isas()) {
+        SCOPED_TRACE(isa_name(level));
+        simd_features::FastFeatureEngine reference_run(kernels_for(IsaLevel::SCALAR));
+        simd_features::FastFeatureEngine features(kernels_for(level));
+        VectorizedInferenceEngine model;
+        model.select_kernels(kernels_for(level));
+
+        for (const auto& book : books) {
+            double expected[16] = {0}, actual[16] = {0};
+            reference_run.calculate_features_fast(book.data(), book.data() + 10, 10, expected);
+            features.calculate_features_fast(book.data(), book.data() + 10, 10, actual);
+            for (size_t i = 0; i < 15; ++i) EXPECT_NEAR(actual[i], expected[i], 1e-9);
+
+            const auto p = model.predict(book.data());
+            const auto q = reference_model.predict(book.data());
+            EXPECT_NEAR(p.buy_signal, q.buy_signal, 1e-12);
+            EXPECT_NEAR(p.sell_signal, q.sell_signal, 1e-12);
+            EXPECT_NEAR(p.hold_signal, q.hold_signal, 1e-12);
+        }
+    }
+}
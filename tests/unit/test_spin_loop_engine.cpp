@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "spin_loop_engine.hpp"
+
+using namespace hft::spin_loop;
+
+namespace {
+
+template<typename Pred>
+bool wait_for(Pred&& pred, std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+}
+
+// Test every task from several producers runs once, in each producer's
+// order, including those still queued at stop()
+TEST(SpinLoopEngineTest, TasksFromManyProducers) {
+    constexpr int PER_PRODUCER = 2000;
+    SpinLoopEngine<> engine(-1);
+    std::vector<int> last_seen(2, -1);
+    std::atomic<int> out_of_order{0};
+    engine.start();
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 2; ++p) {
+        producers.emplace_back([&, p] {
+            for (int i = 0; i < PER_PRODUCER; ++i) {
+                // Only the loop thread touches last_seen
+                while (!engine.submit([&, p, i] {
+                    if (i != last_seen[p] + 1) out_of_order.fetch_add(1);
+                    last_seen[p] = i;
+                })) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : producers) t.join();
+    engine.stop();
+
+    EXPECT_EQ(engine.tasks_run(), 2u * PER_PRODUCER);
+    EXPECT_EQ(out_of_order.load(), 0);
+    EXPECT_EQ(last_seen[0], PER_PRODUCER - 1);
+    EXPECT_EQ(last_seen[1], PER_PRODUCER - 1);
+}
+
+// Test one loop multiplexes pollers and a timer, and pollers can't be
+// added once running
+TEST(SpinLoopEngineTest, PollersAndTimer) {
+    SpinLoopEngine<> engine(-1);
+    std::atomic<uint64_t> nic_polls{0};
+    std::atomic<uint64_t> shm_polls{0};
+    std::atomic<int> ticks{0};
+    ASSERT_TRUE(engine.add_poller([&]() -> size_t { nic_polls.fetch_add(1); return 0; }));
+    ASSERT_TRUE(engine.add_poller([&]() -> size_t { shm_polls.fetch_add(1); return 0; }));
+    ASSERT_TRUE(engine.add_timer(2000000, [&] { ticks.fetch_add(1); }));   // 2 ms
+
+    engine.start();
+    EXPECT_FALSE(engine.add_poller([]() -> size_t { return 0; }));
+    ASSERT_TRUE(wait_for([&] { return ticks.load() >= 3; }));
+    engine.stop();
+
+    EXPECT_GT(nic_polls.load(), 0u);
+    EXPECT_GT(shm_polls.load(), 0u);
+    // Timer work isn't idle, pollers finding nothing is
+    EXPECT_GT(engine.idle_passes(), 0u);
+}
+
+// Test each idle policy still wakes for new work after backing off
+TEST(SpinLoopEngineTest, IdlePoliciesWake) {
+    IdleConfig spin;
+    IdleConfig backoff;
+    backoff.policy = IdlePolicy::BACKOFF;
+    backoff.spin_passes = 16;
+    backoff.sleep_ns = 50000;
+    IdleConfig umwait;
+    umwait.policy = IdlePolicy::UMWAIT;
+    umwait.spin_passes = 16;
+
+    for (const IdleConfig& idle : {spin, backoff, umwait}) {
+        SpinLoopEngine<> engine(-1, idle);
+        if (idle.policy == IdlePolicy::UMWAIT && !umwait_supported()) {
+            EXPECT_EQ(engine.idle_policy(), IdlePolicy::BACKOFF);
+        }
+        engine.start();
+        ASSERT_TRUE(wait_for([&] { return engine.idle_passes() > 100; }));
+
+        std::atomic<bool> ran{false};
+        ASSERT_TRUE(engine.submit([&] { ran.store(true); }));
+        EXPECT_TRUE(wait_for([&] { return ran.load(); })) << static_cast<int>(idle.policy);
+        engine.stop();
+    }
+}
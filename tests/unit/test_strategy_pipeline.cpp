@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <vector>
+#include "strategy_pipeline.hpp"
+
+using namespace hft;
+using namespace hft::pipeline;
+
+namespace {
+
+MarketTick make_tick(double mid, double size) {
+    MarketTick tick;
+    tick.mid_price = mid;
+    tick.bid_price = mid - 0.01;
+    tick.ask_price = mid + 0.01;
+    tick.depth_levels = 5;
+    for (size_t i = 0; i < 5; ++i) {
+        tick.bid_prices[i] = tick.bid_price - 0.01 * i;
+        tick.ask_prices[i] = tick.ask_price + 0.01 * i;
+        tick.bid_sizes[i] = size + 10.0 * i;
+        tick.ask_sizes[i] = 200.0 - size + 5.0 * i;
+    }
+    return tick;
+}
+
+struct RecordingProbe {
+    std::vector<TraceStage> stages;
+    void mark(TraceStage stage) { stages.push_back(stage); }
+};
+
+}
+
+// Test the production pipeline gives exactly what calling the engines in
+// turn gives, tick after tick (the feature engine carries state)
+TEST(StrategyPipelineTest, ProductionMatchesComponents) {
+    // Same random weights in both engines
+    std::srand(7);
+    FPGA_DNN_Inference pipeline_engine(false);
+    std::srand(7);
+    FPGA_DNN_Inference reference_engine(false);
+    DynamicMMStrategy strategy(0.1, 0.20, 300.0, 10.0, 0.01, 800);
+    RiskControl risk(1000, 10000.0, 100000.0);
+    auto p = make_production_pipeline(pipeline_engine, strategy, risk);
+
+    for (int i = 0; i < 20; ++i) {
+        const MarketTick tick = make_tick(100.0 + 0.01 * i, 50.0 + 5.0 * i);
+        TickContext ctx{tick, tick};
+        ctx.buy_intensity = 10.0 + i;
+        ctx.sell_intensity = 8.0;
+        ctx.position = 10 * i;
+        ctx.volatility = 0.3;
+        ctx.time_remaining = 300.0;
+        const Decision d = p.on_tick(ctx);
+
+        const auto features = reference_engine.extract_features(tick, tick, ctx.buy_intensity, ctx.sell_intensity);
+        const auto prediction = reference_engine.predict(features);
+        const double latency_cost = strategy.calculate_latency_cost(0.3, tick.mid_price);
+        const QuotePair q = strategy.calculate_quotes(tick.mid_price, ctx.position, 300.0, latency_cost);
+
+        for (size_t k = 0; k < 3; ++k) EXPECT_EQ(d.prediction[k], prediction[k]);
+        EXPECT_EQ(d.latency_cost, latency_cost);
+        EXPECT_EQ(d.quotes.bid_price, q.bid_price);
+        EXPECT_EQ(d.quotes.ask_price, q.ask_price);
+        EXPECT_EQ(d.should_quote, strategy.should_quote(q.spread, latency_cost));
+        EXPECT_EQ(d.bid_approved, risk.check_pre_trade_limits(
+            Order(0, 0, Side::BUY, q.bid_price, static_cast<uint64_t>(q.bid_size)), ctx.position));
+        EXPECT_TRUE(d.ask_approved);
+    }
+
+    // Past the position limit only the side that reduces it passes
+    const MarketTick tick = make_tick(100.0, 100.0);
+    TickContext ctx{tick, tick};
+    ctx.position = 1000;
+    ctx.time_remaining = 300.0;
+    const Decision d = p.on_tick(ctx);
+    EXPECT_FALSE(d.bid_approved);
+    EXPECT_TRUE(d.ask_approved);
+}
+
+// Test the gate stops after the model and the probe sees each stage once
+TEST(StrategyPipelineTest, GateAndProbe) {
+    FPGA_DNN_Inference engine(false);
+    DynamicMMStrategy strategy(0.1, 0.20, 300.0, 10.0, 0.01, 800);
+    RiskControl risk;
+    auto p = make_production_pipeline(engine, strategy, risk);
+    const MarketTick tick = make_tick(100.0, 80.0);
+    TickContext ctx{tick, tick};
+    ctx.time_remaining = 300.0;
+
+    RecordingProbe gated;
+    const Decision skipped = p.on_tick(ctx, [](const Decision&) { return false; }, gated);
+    EXPECT_EQ(gated.stages, (std::vector<TraceStage>{TraceStage::FEATURES, TraceStage::INFERENCE}));
+    EXPECT_NEAR(skipped.prediction[0] + skipped.prediction[1] + skipped.prediction[2], 1.0, 1e-9);
+    EXPECT_EQ(skipped.quotes.bid_price, 0.0);
+    EXPECT_FALSE(skipped.bid_approved || skipped.ask_approved || skipped.should_quote);
+
+    RecordingProbe full;
+    const Decision quoted = p.on_tick(ctx, AlwaysQuote{}, full);
+    EXPECT_EQ(full.stages, (std::vector<TraceStage>{TraceStage::FEATURES, TraceStage::INFERENCE,
+                                                    TraceStage::QUOTE, TraceStage::RISK}));
+    EXPECT_GT(quoted.quotes.ask_price, quoted.quotes.bid_price);
+    EXPECT_TRUE(quoted.bid_approved && quoted.ask_approved);
+}
+
+// Test the compile-time policies apply StrategyParameters/RiskParameters
+TEST(StrategyPipelineTest, CompileTimePolicies) {
+    using Strategy = compile_time::SimpleMarketMakingStrategy;
+    using Risk = compile_time::ModerateRiskPolicy;
+    FPGA_DNN_Inference engine(false);
+    auto p = make_compile_time_pipeline<Strategy, Risk>(engine);
+    static_assert(std::is_empty<CompileTimeQuoting<Strategy>>::value, "no state");
+
+    const MarketTick tick = make_tick(100.0, 80.0);
+    TickContext ctx{tick, tick};
+    ctx.position = 50;
+    ctx.volatility = 0.02;
+    const Decision d = p.on_tick(ctx);
+
+    const auto q = compile_time::CompileTimeStrategyEngine<Strategy>::compute_quotes(100.0, 50.0, 0.02, 0.0);
+    EXPECT_EQ(d.quotes.bid_price, q.bid_price);
+    EXPECT_EQ(d.quotes.ask_price, q.ask_price);
+    EXPECT_NEAR(d.quotes.spread, q.ask_price - q.bid_price, 1e-12);
+    EXPECT_TRUE(d.should_quote);
+    // 50 + 10 stays under MAX_POSITION_SIZE = 500; selling from a long is allowed
+    EXPECT_TRUE(d.bid_approved);
+    EXPECT_TRUE(d.ask_approved);
+
+    ctx.position = 495;
+    EXPECT_FALSE(p.on_tick(ctx).bid_approved);
+    ctx.position = 0;
+    EXPECT_FALSE(p.on_tick(ctx).ask_approved);      // No naked shorts under the moderate policy
+    ctx.position = 50;
+    ctx.daily_pnl = -60000.0;
+    EXPECT_FALSE(p.on_tick(ctx).ask_approved);
+}
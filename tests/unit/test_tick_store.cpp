@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include "backtesting_engine.hpp"
+#include "tick_store.hpp"
+
+namespace {
+
+using hft::backtest::HistoricalEvent;
+using hft::backtest::TickStoreReader;
+using hft::backtest::TickStoreWriter;
+
+HistoricalEvent make_event(int64_t ts, double bid, uint64_t volume) {
+    HistoricalEvent e;
+    e.timestamp_ns = ts;
+    e.asset_id = 3;
+    e.event_type = 1;
+    e.bid_price = bid;
+    e.ask_price = bid + 0.02;
+    e.bid_size = 100;
+    e.ask_size = 200;
+    e.trade_price = bid + 0.01;
+    e.trade_volume = volume;
+    e.trade_side = (volume % 2) ? hft::Side::SELL : hft::Side::BUY;
+    e.depth_levels = 2;
+    e.bid_prices[1] = bid - 0.01;
+    e.ask_sizes[1] = 7;
+    return e;
+}
+
+class TickStoreTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    std::string path_ = "/tmp/test_tick_store.bin";
+};
+
+}
+
+// Test a round trip preserves every column
+TEST_F(TickStoreTest, RoundTrip) {
+    TickStoreWriter writer;
+    for (int i = 0; i < 100; ++i) {
+        writer.append(make_event(1000 + i, 100.0 + i * 0.01, i));
+    }
+    EXPECT_EQ(writer.write(path_), 100u);
+
+    TickStoreReader reader(path_);
+    ASSERT_EQ(reader.size(), 100u);
+    EXPECT_TRUE(reader.is_sorted());
+    EXPECT_FALSE(reader.has_depth());
+    EXPECT_EQ(reader.min_timestamp_ns(), 1000);
+    EXPECT_EQ(reader.max_timestamp_ns(), 1099);
+
+    HistoricalEvent e;
+    reader.read(42, e);
+    EXPECT_EQ(e.timestamp_ns, 1042);
+    EXPECT_EQ(e.asset_id, 3u);
+    EXPECT_EQ(e.event_type, 1);
+    EXPECT_DOUBLE_EQ(e.bid_price, 100.42);
+    EXPECT_DOUBLE_EQ(e.ask_price, 100.44);
+    EXPECT_EQ(e.bid_size, 100u);
+    EXPECT_EQ(e.ask_size, 200u);
+    EXPECT_DOUBLE_EQ(e.trade_price, 100.43);
+    EXPECT_EQ(e.trade_volume, 42u);
+    EXPECT_EQ(e.trade_side, hft::Side::BUY);
+    EXPECT_EQ(e.depth_levels, 2);
+    EXPECT_DOUBLE_EQ(e.bid_prices[1], 0.0);   // Depth not stored
+}
+
+// Test depth columns are stored when requested
+TEST_F(TickStoreTest, DepthColumns) {
+    TickStoreWriter writer(true);
+    writer.append(make_event(1, 50.0, 1));
+    writer.write(path_);
+
+    TickStoreReader reader(path_);
+    EXPECT_TRUE(reader.has_depth());
+    HistoricalEvent e;
+    reader.read(0, e);
+    EXPECT_DOUBLE_EQ(e.bid_prices[1], 49.99);
+    EXPECT_EQ(e.ask_sizes[1], 7u);
+    EXPECT_EQ(e.trade_side, hft::Side::SELL);
+}
+
+// Test out-of-order input is written in stable timestamp order
+TEST_F(TickStoreTest, SortsOnWrite) {
+    TickStoreWriter writer;
+    writer.append(make_event(30, 1.0, 0));
+    writer.append(make_event(10, 2.0, 0));
+    writer.append(make_event(20, 3.0, 0));
+    writer.append(make_event(10, 4.0, 0));
+    writer.write(path_);
+
+    TickStoreReader reader(path_);
+    const double expected_bids[] = {2.0, 4.0, 3.0, 1.0};
+    HistoricalEvent e;
+    for (size_t i = 0; i < reader.size(); ++i) {
+        reader.read(i, e);
+        EXPECT_DOUBLE_EQ(e.bid_price, expected_bids[i]);
+    }
+    EXPECT_EQ(reader.lower_bound(15), 2u);
+    EXPECT_EQ(reader.lower_bound(31), 4u);
+}
+
+// Test foreign and truncated files are rejected
+TEST_F(TickStoreTest, RejectsBadFiles) {
+    {
+        std::ofstream out(path_, std::ios::binary);
+        out << "ts_us,event_type,side,price,size\n1,trade,B,100,1\n";
+        for (int i = 0; i < 300; ++i) out << ' ';
+    }
+    EXPECT_THROW(TickStoreReader{path_}, std::runtime_error);
+
+    TickStoreWriter writer;
+    for (int i = 0; i < 1000; ++i) writer.append(make_event(i, 1.0, 0));
+    writer.write(path_);
+    std::filesystem::resize_file(path_, 4096);
+    EXPECT_THROW(TickStoreReader{path_}, std::runtime_error);
+
+    EXPECT_THROW(TickStoreReader{"/nonexistent/store.bin"}, std::runtime_error);
+}
+
+// Test the engine replays a converted CSV without materializing it
+TEST_F(TickStoreTest, EngineReplaysConvertedCsv) {
+    const std::string csv_path = "/tmp/test_tick_store.csv";
+    {
+        std::ofstream csv(csv_path);
+        csv << "ts_us,event_type,side,price,size\n";
+        for (int i = 0; i < 500; ++i) {
+            // Out of order in pairs to exercise the converter sort
+            const int64_t ts = 1640995200000000LL + ((i ^ 1) * 1000);
+            csv << ts << "," << ((i % 3 == 0) ? "trade" : "quote") << ","
+                << ((i % 2) ? 'S' : 'B') << "," << (100.0 + (i % 7) * 0.01) << "," << (100 + i) << "\n";
+        }
+    }
+
+    size_t written = 0;
+    ASSERT_TRUE(hft::backtest::BacktestingEngine::convert_csv_to_binary(csv_path, path_, &written));
+    EXPECT_EQ(written, 500u);
+
+    TickStoreReader reader(path_);
+    for (size_t i = 1; i < reader.size(); ++i) {
+        ASSERT_LE(reader.timestamp_ns(i - 1), reader.timestamp_ns(i));
+    }
+
+    hft::backtest::BacktestingEngine engine;
+    ASSERT_TRUE(engine.load_binary_data(path_));
+    EXPECT_EQ(engine.get_historical_events_count(), 500u);
+    auto metrics = engine.run_backtest();
+    EXPECT_GE(metrics.fill_rate, 0.0);
+    EXPECT_LE(metrics.fill_rate, 1.0);
+
+    // Loading CSV afterwards switches back to the in-memory source
+    ASSERT_TRUE(engine.load_historical_data(csv_path));
+    EXPECT_EQ(engine.get_historical_events_count(), 500u);
+
+    EXPECT_FALSE(engine.load_binary_data("/nonexistent/store.bin"));
+    EXPECT_FALSE(hft::backtest::BacktestingEngine::convert_csv_to_binary("/nonexistent.csv", path_));
+    std::filesystem::remove(csv_path);
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include "clock.hpp"
+#include "common_types.hpp"
+#include "tsc_clock.hpp"
+
+using namespace hft;
+
+namespace {
+
+int64_t steady_now_ns() {
+    return tsc::steady_ns();
+}
+
+}
+
+// Test hft::now() stays close to steady_clock over a few milliseconds
+TEST(TscClockTest, TracksSteadyClock) {
+    auto& service = tsc::ClockService::instance();
+    if (std::getenv("HFT_CLOCK") == nullptr && tsc::cpu_has_invariant_tsc()) {
+        EXPECT_TRUE(service.tsc_enabled());
+        EXPECT_TRUE(service.running());
+        EXPECT_GT(service.ns_per_cycle(), 0.0);
+    }
+
+    for (int i = 0; i < 5; ++i) {
+        const int64_t before = steady_now_ns();
+        const int64_t ours = to_nanos(now());
+        const int64_t after = steady_now_ns();
+        // Initial calibration covers only 0.5ms; allow 200us of drift
+        EXPECT_GT(ours, before - 200000);
+        EXPECT_LT(ours, after + 200000);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    EXPECT_GE(TscClock().ns_per_cycle(), 0.0);
+}
+
+// Test readings never go backwards across recalibration, and counter
+// deltas taken with now_tsc() convert to the elapsed interval
+TEST(TscClockTest, MonotonicAcrossRecalibration) {
+    auto& service = tsc::ClockService::instance();
+    int64_t last = service.now_ns();
+    const uint64_t calibrations = service.calibrations();
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 1000; ++i) {
+            const int64_t t = service.now_ns();
+            ASSERT_GE(t, last);
+            last = t;
+        }
+        service.recalibrate();
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    if (service.tsc_enabled()) {
+        EXPECT_GT(service.calibrations(), calibrations);
+    }
+
+    const uint64_t t0 = now_tsc();
+    const int64_t s0 = steady_now_ns();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    const uint64_t t1 = now_tsc();
+    const int64_t s1 = steady_now_ns();
+    const int64_t elapsed = tsc_to_ns(t1) - tsc_to_ns(t0);
+    EXPECT_NEAR(static_cast<double>(elapsed), static_cast<double>(s1 - s0), 200000.0);
+}
+
+// Test the mapping is continuous at a calibration switch and starting /
+// stopping the background thread is idempotent
+TEST(TscClockTest, ContinuousMappingAndThreadControl) {
+    tsc::Calibration c;
+    c.base_counter = 1000;
+    c.base_ns = 5000;
+    c.mult = uint64_t(1) << (tsc::Calibration::SHIFT - 1);    // 0.5 ns per cycle
+    EXPECT_EQ(c.to_ns(1000), 5000);
+    EXPECT_EQ(c.to_ns(3000), 6000);
+    EXPECT_EQ(c.to_ns(0), 4500);                                // Before the base
+    EXPECT_DOUBLE_EQ(c.ns_per_cycle(), 0.5);
+
+    auto& service = tsc::ClockService::instance();
+    if (!service.tsc_enabled()) {
+        EXPECT_FALSE(service.running());
+        EXPECT_EQ(tsc_to_ns(12345), 12345);
+        return;
+    }
+    service.stop();
+    service.stop();
+    EXPECT_FALSE(service.running());
+    service.start(std::chrono::milliseconds(1));
+    service.start(std::chrono::milliseconds(1));
+    EXPECT_TRUE(service.running());
+    const uint64_t calibrations = service.calibrations();
+    for (int i = 0; i < 200 && service.calibrations() == calibrations; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_GT(service.calibrations(), calibrations);
+    service.stop();
+    service.start();
+    EXPECT_TRUE(service.running());
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "smart_order_router.hpp"
+
+namespace {
+
+VenueInfo make_venue(const std::string& id, double latency_us, double depth = 1000.0) {
+    VenueInfo v;
+    v.venue_id = id;
+    v.venue_name = id;
+    v.is_active = true;
+    v.endpoint = "";
+    v.baseline_latency_us = latency_us;
+    v.maker_fee_bps = 0.0;
+    v.taker_fee_bps = 0.0;
+    v.min_order_size = 0.0;
+    v.max_order_size = 1e9;
+    v.typical_bid_depth = depth;
+    v.typical_ask_depth = depth;
+    v.fill_rate = 0.99;
+    return v;
+}
+
+Timestamp at_us(int64_t us) {
+    return Timestamp(std::chrono::microseconds(us));
+}
+
+}
+
+// Test the vector scan reproduces the composite score (price 0.5, latency
+// 0.3, liquidity 0.2 against the 1000 us default budget) on both sides
+TEST(VenueScoreTest, ScanMatchesCompositeScore) {
+    SmartOrderRouter router;
+    router.add_venue(make_venue("FAST", 100.0));
+    router.add_venue(make_venue("DEEP", 300.0, 20.0));
+    const uint32_t fast = router.venue_index("FAST");
+    const uint32_t deep = router.venue_index("DEEP");
+
+    std::vector<double> prices(router.venue_slot_count());
+    prices[fast] = 100.5;
+    prices[deep] = 100.0;
+
+    // Buy 10: DEEP has the best price and enough depth
+    auto d = router.route_order(100.0, 0.01, 0, 10, hft::MarketRegime::NORMAL, prices);
+    EXPECT_TRUE(d.rejection_reason.empty());
+    EXPECT_EQ(d.selected_venue, "DEEP");
+    EXPECT_EQ(d.selected_venue_index, deep);
+    EXPECT_NEAR(d.composite_score, 0.5 * 1.0 + 0.3 * 0.7 + 0.2 * 1.0, 1e-5);
+    EXPECT_NEAR(d.latency_quality, 0.7, 1e-5);
+    EXPECT_DOUBLE_EQ(d.expected_latency_us, 300.0);
+
+    // Sell 10: FAST now quotes the better price
+    d = router.route_order(100.0, 0.01, 0, -10, hft::MarketRegime::NORMAL, prices);
+    EXPECT_EQ(d.selected_venue_index, fast);
+    EXPECT_NEAR(d.composite_score, 0.5 * 1.0 + 0.3 * 0.9 + 0.2 * 1.0, 1e-5);
+
+    // Buy 100: DEEP's liquidity falls to 0.2, unquoted prices score 0.5
+    prices[fast] = SmartOrderRouter::NO_QUOTE;
+    d = router.route_order(100.0, 0.01, 0, 100, hft::MarketRegime::NORMAL, prices);
+    EXPECT_EQ(d.selected_venue_index, deep);
+    EXPECT_NEAR(d.liquidity_quality, 0.2, 1e-5);
+    EXPECT_NEAR(d.composite_score, 0.5 + 0.21 + 0.04, 1e-5);
+
+    // Order outside every venue's size limits
+    VenueInfo small = make_venue("FAST", 100.0);
+    small.max_order_size = 5.0;
+    router.add_venue(small);
+    router.remove_venue("DEEP");
+    d = router.route_order(100.0, 0.01, 0, 10, hft::MarketRegime::NORMAL, prices);
+    EXPECT_EQ(d.selected_venue_index, SmartOrderRouter::INVALID_VENUE);
+    EXPECT_TRUE(d.selected_venue.empty());
+    EXPECT_FALSE(d.rejection_reason.empty());
+}
+
+// Test heartbeats, timeouts and fills republish the table and fold
+// spike, connectivity and fill-rate checks into venue eligibility
+TEST(VenueScoreTest, ControlPlaneRepublishes) {
+    SmartOrderRouter router;
+    router.add_venue(make_venue("A", 100.0));
+    router.add_venue(make_venue("B", 200.0));
+    router.add_venue(make_venue("C", 300.0));
+    const uint32_t a = router.venue_index("A");
+    const uint32_t b = router.venue_index("B");
+    const uint32_t c = router.venue_index("C");
+
+    VenueScoreTable table = router.score_table();
+    EXPECT_EQ(table.venue_count, 3u);
+    EXPECT_FLOAT_EQ(table.ema_rtt_us[b], 200.0f);
+    EXPECT_FALSE(table.eligible(3));
+
+    // Latency spike on A: 500 us against a 100 us baseline
+    uint64_t version = router.score_version();
+    router.receive_heartbeat(a, at_us(0), at_us(500));
+    EXPECT_GT(router.score_version(), version);
+    EXPECT_FALSE(router.score_table().eligible(a));
+
+    // B misses three heartbeats
+    router.send_heartbeat(b, at_us(1000));
+    for (int i = 0; i < 3; ++i) router.check_heartbeat_timeouts(at_us(1000 + 2'000'000));
+    EXPECT_FALSE(router.get_venue_state("B")->is_connected);
+    EXPECT_FALSE(router.score_table().eligible(b));
+
+    std::vector<double> prices(router.venue_slot_count(), 100.0);
+    auto d = router.route_order(100.0, 0.01, 0, 10, hft::MarketRegime::NORMAL, prices);
+    EXPECT_EQ(d.selected_venue_index, c);
+
+    // C stops filling, B comes back
+    for (int i = 0; i < 10; ++i) router.record_order_result(c, false, false);
+    EXPECT_FALSE(router.score_table().eligible(c));
+    router.receive_heartbeat(b, at_us(0), at_us(200));
+    d = router.route_order(100.0, 0.01, 0, 10, hft::MarketRegime::NORMAL, prices);
+    EXPECT_EQ(d.selected_venue_index, b);
+    EXPECT_EQ(router.get_active_venues().size(), 3u);      // connected, if not routable
+}
+
+// Test routing keeps returning consistent decisions while a heartbeat
+// thread republishes scores underneath it
+TEST(VenueScoreTest, RoutesWhileHeartbeatsUpdate) {
+    SmartOrderRouter router;
+    router.add_venue(make_venue("A", 100.0));
+    router.add_venue(make_venue("B", 400.0));
+    const uint32_t a = router.venue_index("A");
+    const uint32_t b = router.venue_index("B");
+
+    std::atomic<bool> done{false};
+    std::thread heartbeats([&] {
+        for (int64_t i = 0; i < 20000; ++i) {
+            router.receive_heartbeat(a, at_us(i), at_us(i + 100));
+            router.receive_heartbeat(b, at_us(i), at_us(i + 400));
+            router.record_order_result(i & 1 ? a : b, true, false);
+            if ((i & 63) == 0) std::this_thread::yield();
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    const std::vector<double> prices(router.venue_slot_count(), 100.0);
+    size_t routed = 0;
+    while (!done.load(std::memory_order_acquire) || routed == 0) {
+        const auto d = router.route_order(100.0, 0.01, 0, 10, hft::MarketRegime::NORMAL, prices);
+        ASSERT_EQ(d.selected_venue_index, a);
+        ASSERT_EQ(d.selected_venue, "A");
+        ASSERT_NEAR(d.expected_latency_us, 100.0, 1e-3);
+        ++routed;
+        if ((routed & 255) == 0) std::this_thread::yield();
+    }
+    heartbeats.join();
+    EXPECT_GE(router.score_version(), 2u * 20000u);
+}
+
+// Test removing a venue while heartbeats and lookups race it: the removed
+// venue drops out and the others keep their state
+TEST(VenueScoreTest, RemoveWhileHeartbeating) {
+    SmartOrderRouter router;
+    router.add_venue(make_venue("A", 100.0));
+    router.add_venue(make_venue("B", 200.0));
+    const uint32_t a = router.venue_index("A");
+    const uint32_t b = router.venue_index("B");
+
+    std::atomic<bool> removed{false};
+    std::thread heartbeats([&] {
+        for (int64_t i = 0; i < 20000; ++i) {
+            router.send_heartbeat(a, at_us(i));
+            router.receive_heartbeat(b, at_us(i), at_us(i + 200));
+            router.receive_heartbeat("A", at_us(i), at_us(i + 100));
+            if (i == 10000) router.remove_venue("A");
+            if ((i & 63) == 0) std::this_thread::yield();
+        }
+        removed.store(true, std::memory_order_release);
+    });
+    while (!removed.load(std::memory_order_acquire)) {
+        const uint32_t idx = router.venue_index("A");
+        ASSERT_TRUE(idx == a || idx == SmartOrderRouter::INVALID_VENUE);
+    }
+    heartbeats.join();
+
+    EXPECT_EQ(router.venue_index("A"), SmartOrderRouter::INVALID_VENUE);
+    EXPECT_FALSE(router.get_venue_state("A").has_value());
+    EXPECT_FALSE(router.score_table().eligible(a));
+    EXPECT_EQ(router.get_venue_state("B")->total_heartbeats_received, 20000u);
+
+    // Writes by index to the removed slot are dropped
+    const uint64_t version = router.score_version();
+    router.receive_heartbeat(a, at_us(0), at_us(100));
+    router.record_order_result(a, true, false);
+    EXPECT_EQ(router.score_version(), version);
+}